@@ -1,7 +1,7 @@
 'use client';
 
 import React, { useState, useEffect } from 'react';
-import { SystemStats, EventData, AIAnalysis } from '@/types';
+import { SystemStats, EventData, AIAnalysis, WebSocketMessage } from '@/types';
 
 const API_BASE = 'http://localhost:8000/api';
 const WS_URL = 'ws://localhost:8000/ws';
@@ -41,16 +41,19 @@ export default function Dashboard() {
 
         ws.onmessage = (event) => {
           try {
-            const message = JSON.parse(event.data);
+            const message: WebSocketMessage = JSON.parse(event.data);
             switch (message.type) {
-              case 'stats':
-                setStats(message.data);
-                break;
-              case 'new_event':
-                setEvents(prev => [message.data, ...(prev || []).slice(0, 49)]);
-                break;
-              case 'new_analysis':
-                setAnalyses(prev => [message.data, ...(prev || []).slice(0, 19)]);
+              case 'batch':
+                // Stats are a delta unless the frame is marked full
+                if (Object.keys(message.stats).length > 0) {
+                  setStats(prev => message.full ? message.stats as SystemStats : { ...prev, ...message.stats });
+                }
+                if (message.events.length > 0) {
+                  setEvents(prev => [...message.events.slice().reverse(), ...(prev || [])].slice(0, 50));
+                }
+                if (message.analyses.length > 0) {
+                  setAnalyses(prev => [...message.analyses.slice().reverse(), ...(prev || [])].slice(0, 20));
+                }
                 break;
             }
           } catch (error) {
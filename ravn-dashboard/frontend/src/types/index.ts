@@ -22,4 +22,16 @@ export interface SystemStats {
   performance_events: number;
   ai_analyses: number;
   avg_threat_score: number;
-}
\ No newline at end of file
+}
+
+// Frame sent to WebSocket clients every broadcast interval
+export interface BatchMessage {
+  type: 'batch';
+  timestamp: number;
+  full?: boolean;                // stats holds every field, not only changes
+  stats: Partial<SystemStats>;
+  events: EventData[];           // oldest first
+  analyses: AIAnalysis[];        // oldest first
+}
+
+export type WebSocketMessage = BatchMessage;
@@ -8,6 +8,7 @@ import asyncio
 import json
 import logging
 import time
+from collections import deque
 from datetime import datetime, timedelta
 from typing import Dict, List, Optional, Any
 import redis.asyncio as redis
@@ -34,6 +35,7 @@ async def lifespan(app: FastAPI):
     logger.info("Starting RAVN Dashboard API...")
     await get_redis()
     asyncio.create_task(redis_monitor())
+    asyncio.create_task(broadcaster())
     logger.info("RAVN Dashboard API started successfully")
     
     yield
@@ -56,35 +58,100 @@ app.add_middleware(
     allow_headers=["*"],
 )
 
+# WebSocket configuration
+BROADCAST_INTERVAL = 0.1 # Seconds between batched frames
+CLIENT_QUEUE = 16        # Frames queued per client before it counts as slow
+BATCH_EVENTS = 200       # Most events carried by one frame
+
+class Client:
+    """One WebSocket client and its own send queue"""
+
+    def __init__(self, websocket: WebSocket):
+        self.websocket = websocket
+        self.queue: asyncio.Queue = asyncio.Queue(maxsize=CLIENT_QUEUE)
+        self.resync = True  # Next frame carries the full stats, not a delta
+        self.task: Optional[asyncio.Task] = None
+
 # WebSocket connection manager
 class ConnectionManager:
     def __init__(self):
-        self.active_connections: List[WebSocket] = []
+        self.clients: Dict[WebSocket, Client] = {}
+        self.pending_events: deque = deque(maxlen=BATCH_EVENTS)
+        self.pending_analyses: List[dict] = []
+        self.last_stats: Dict[str, Any] = {}
+
+    @property
+    def active_connections(self) -> List[WebSocket]:
+        return list(self.clients)
 
     async def connect(self, websocket: WebSocket):
         await websocket.accept()
-        self.active_connections.append(websocket)
-        logger.info(f"WebSocket connected. Total connections: {len(self.active_connections)}")
+        client = Client(websocket)
+        self.clients[websocket] = client
+        client.task = asyncio.create_task(self._sender(client))
+        logger.info(f"WebSocket connected. Total connections: {len(self.clients)}")
 
     def disconnect(self, websocket: WebSocket):
-        if websocket in self.active_connections:
-            self.active_connections.remove(websocket)
-        logger.info(f"WebSocket disconnected. Total connections: {len(self.active_connections)}")
-
-    async def broadcast(self, message: dict):
-        if self.active_connections:
-            disconnected = []
-            for connection in self.active_connections:
-                try:
-                    await connection.send_text(json.dumps(message))
-                except Exception as e:
-                    # Log the specific error for debugging
-                    logger.debug(f"WebSocket send error: {e}")
-                    disconnected.append(connection)
-            
-            # Remove disconnected connections
-            for conn in disconnected:
-                self.disconnect(conn)
+        client = self.clients.pop(websocket, None)
+        if client is None:
+            return
+        if client.task is not asyncio.current_task():
+            client.task.cancel()
+        logger.info(f"WebSocket disconnected. Total connections: {len(self.clients)}")
+
+    async def _sender(self, client: Client):
+        """Drain one client's queue; a slow socket only delays itself"""
+        try:
+            while True:
+                frame = await client.queue.get()
+                await client.websocket.send_text(frame)
+        except asyncio.CancelledError:
+            pass
+        except Exception as e:
+            # Log the specific error for debugging
+            logger.debug(f"WebSocket send error: {e}")
+        finally:
+            self.disconnect(client.websocket)
+
+    def add_events(self, events: List[dict]):
+        """Queue events for the next frame"""
+        if self.clients:
+            self.pending_events.extend(events)
+
+    def add_analysis(self, analysis: dict):
+        """Queue an AI analysis for the next frame"""
+        if self.clients:
+            self.pending_analyses.append(analysis)
+
+    def broadcast(self, stats: Dict[str, Any]):
+        """Send the events, analyses and stat changes of one interval as one frame"""
+        now = time.time()
+        delta = {k: v for k, v in stats.items() if self.last_stats.get(k) != v}
+        self.last_stats = stats
+        frame = {"type": "batch", "timestamp": now, "stats": delta,
+                 "events": list(self.pending_events), "analyses": self.pending_analyses}
+        self.pending_events.clear()
+        self.pending_analyses = []
+
+        # Encoded once for all clients; compact separators keep frames small
+        empty = not (delta or frame["events"] or frame["analyses"])
+        encoded = json.dumps(frame, separators=(",", ":"))
+        full = None
+
+        for client in list(self.clients.values()):
+            if client.queue.full():
+                # Slow client: drop its backlog and resynchronize it with full stats
+                while not client.queue.empty():
+                    client.queue.get_nowait()
+                client.resync = True
+
+            if client.resync:
+                if full is None:
+                    full = json.dumps(dict(frame, stats=stats, full=True), separators=(",", ":"))
+                client.queue.put_nowait(full)
+                client.resync = False
+            elif not empty:
+                client.queue.put_nowait(encoded)
 
 manager = ConnectionManager()
 
@@ -119,6 +186,132 @@ async def get_redis():
         redis_client = redis.Redis(host='localhost', port=6379, db=0, decode_responses=True)
     return redis_client
 
+# Cache configuration
+POLL_INTERVAL = 0.5      # Seconds between Redis reads of the consumer task
+EVENT_BATCH = 256        # Newest events:raw entries read per poll
+RECENT_EVENTS = 1000     # Events kept in the recent-event ring
+RECENT_ANALYSES = 100    # AI analyses kept
+STATS_KEY = "ravn:stats" # Counters published by the daemon
+
+def classify_event(event_data: Dict[str, Any]) -> str:
+    """Map an event to one of the dashboard streams"""
+    event_str = str(event_data).lower()
+    if "memory" in event_str or "mmap" in event_str or "munmap" in event_str:
+        return "memory"
+    if "process" in event_str or "exec" in event_str or "fork" in event_str or "exit" in event_str:
+        return "process"
+    if "kernel" in event_str or "module" in event_str:
+        return "kernel"
+    if "performance" in event_str or "cpu" in event_str or "getpid" in event_str or "brk" in event_str:
+        return "performance"
+    return "unknown"
+
+class EventCache:
+    """In-memory view of the daemon's Redis data, shared by all clients"""
+
+    def __init__(self):
+        self.redis_up = False
+        self.updated = 0.0
+        self.events: deque = deque(maxlen=RECENT_EVENTS)
+        self.analyses: deque = deque(maxlen=RECENT_ANALYSES)
+        self.type_counts: Dict[str, int] = {"memory": 0, "process": 0, "kernel": 0,
+                                            "performance": 0, "unknown": 0}
+        self.consumed = 0
+        self.ai_count = 0
+        self.daemon_stats: Dict[str, str] = {}
+        self.events_per_second = 0.0
+        self._last_raw: Optional[str] = None
+        self._last_analysis: Optional[str] = None
+        self._last_total: Optional[int] = None
+        self._last_total_time = 0.0
+
+    def add_events(self, raw_events: List[str]) -> List[dict]:
+        """Append the entries pushed since the last poll (newest first in raw_events)"""
+        if self._last_raw is not None and self._last_raw in raw_events:
+            raw_events = raw_events[:raw_events.index(self._last_raw)]
+        if not raw_events:
+            return []
+        self._last_raw = raw_events[0]
+
+        added = []
+        for raw in reversed(raw_events):
+            try:
+                event_data = json.loads(raw)
+            except Exception as e:
+                logger.debug(f"Error parsing event: {e}")
+                continue
+            event_type = classify_event(event_data)
+            record = {
+                "timestamp": event_data.get("timestamp", time.time()),
+                "type": event_type,
+                "data": event_data,
+                "source": "eBPF"
+            }
+            self.events.append(record)
+            self.type_counts[event_type] += 1
+            self.consumed += 1
+            added.append(record)
+        return added
+
+    def add_analysis(self, raw: Optional[str]) -> Optional[dict]:
+        """Record the current threat analysis if it changed"""
+        if not raw or raw == self._last_analysis:
+            return None
+        self._last_analysis = raw
+        try:
+            analysis_data = json.loads(raw)
+        except Exception as e:
+            logger.debug(f"Error parsing AI analysis: {e}")
+            return None
+        record = {
+            "timestamp": analysis_data.get("timestamp", time.time()),
+            "threat_score": analysis_data.get("threat_score", analysis_data.get("score", 0.0)),
+            "analysis_type": analysis_data.get("analysis_type", "threat_analysis"),
+            "details": analysis_data.get("details", analysis_data),
+            "recommendations": analysis_data.get("recommendations", [])
+        }
+        self.analyses.append(record)
+        self.ai_count += 1
+        return record
+
+    def set_daemon_stats(self, daemon_stats: Dict[str, str], now: float):
+        """Take the daemon's counters and derive the event rate from them"""
+        self.daemon_stats = daemon_stats
+        try:
+            total = int(daemon_stats["events_total"])
+        except (KeyError, ValueError):
+            return
+        if self._last_total is not None and now > self._last_total_time and total >= self._last_total:
+            self.events_per_second = (total - self._last_total) / (now - self._last_total_time)
+        self._last_total = total
+        self._last_total_time = now
+
+    def stats(self) -> "SystemStats":
+        """System statistics for REST and WebSocket clients"""
+        total_events = self.consumed
+        try:
+            total_events = int(self.daemon_stats["events_total"])
+        except (KeyError, ValueError):
+            pass
+
+        # Scale the per-stream counts of the consumed events to the daemon total;
+        # events no stream matches are counted as memory events
+        scale = total_events / self.consumed if self.consumed else 0.0
+        counts = self.type_counts
+        scores = [float(a["threat_score"]) for a in self.analyses]
+        return SystemStats(
+            total_events=total_events,
+            events_per_second=self.events_per_second,
+            memory_events=int((counts["memory"] + counts["unknown"]) * scale),
+            process_events=int(counts["process"] * scale),
+            kernel_events=int(counts["kernel"] * scale),
+            performance_events=int(counts["performance"] * scale),
+            ai_analyses=self.ai_count,
+            avg_threat_score=sum(scores) / len(scores) if scores else 0.0
+        )
+
+cache = EventCache()
+
 # API Routes
 @app.get("/")
 async def root():
@@ -126,274 +319,36 @@ async def root():
 
 @app.get("/api/health")
 async def health_check():
-    try:
-        redis_conn = await get_redis()
-        await redis_conn.ping()
-        return {"status": "healthy", "redis": "connected", "timestamp": time.time()}
-    except Exception as e:
-        return {"status": "unhealthy", "redis": "disconnected", "error": str(e)}
+    if cache.redis_up:
+        return {"status": "healthy", "redis": "connected", "timestamp": cache.updated}
+    return {"status": "unhealthy", "redis": "disconnected"}
 
 @app.get("/api/events/recent")
 async def get_recent_events(limit: int = 100):
-    """Get recent eBPF events from Redis"""
-    try:
-        redis_conn = await get_redis()
-        
-        # Get recent events from the actual Redis key
-        events = []
-        
-        # Get events from events:raw key based on data type
-        events_type = await redis_conn.type("events:raw")
-        raw_events = []
-        
-        if events_type == "list":
-            raw_events = await redis_conn.lrange("events:raw", 0, limit-1)
-        elif events_type == "string":
-            event_data = await redis_conn.get("events:raw")
-            if event_data:
-                raw_events = [event_data]
-        elif events_type == "set":
-            raw_events = await redis_conn.smembers("events:raw")
-            raw_events = list(raw_events)[:limit]
-        
-        for event in raw_events:
-            try:
-                event_data = json.loads(event)
-                # Determine event type from the data
-                event_type = "unknown"
-                if "memory" in str(event_data).lower():
-                    event_type = "memory"
-                elif "process" in str(event_data).lower() or "exec" in str(event_data).lower():
-                    event_type = "process"
-                elif "kernel" in str(event_data).lower() or "module" in str(event_data).lower():
-                    event_type = "kernel"
-                elif "performance" in str(event_data).lower() or "cpu" in str(event_data).lower():
-                    event_type = "performance"
-                
-                events.append({
-                    "timestamp": event_data.get("timestamp", time.time()),
-                    "type": event_type,
-                    "data": event_data,
-                    "source": "eBPF"
-                })
-            except Exception as e:
-                logger.debug(f"Error parsing event: {e}")
-                continue
-        
-        # Sort by timestamp (newest first)
-        events.sort(key=lambda x: x["timestamp"], reverse=True)
-        return events[:limit]
-        
-    except Exception as e:
-        logger.error(f"Error getting recent events: {e}")
-        raise HTTPException(status_code=500, detail=str(e))
+    """Get recent eBPF events (newest first)"""
+    events = list(cache.events)[-limit:] if limit > 0 else []
+    events.reverse()
+    return events
 
 @app.get("/api/ai/analyses")
 async def get_ai_analyses(limit: int = 50):
-    """Get recent AI analyses from Redis"""
-    try:
-        redis_conn = await get_redis()
-        
-        # Get AI analysis results from threat:current key based on data type
-        threat_type = await redis_conn.type("threat:current")
-        analyses = []
-        
-        if threat_type == "list":
-            analyses = await redis_conn.lrange("threat:current", 0, limit-1)
-        elif threat_type == "string":
-            analysis_data = await redis_conn.get("threat:current")
-            if analysis_data:
-                analyses = [analysis_data]
-        elif threat_type == "set":
-            analyses = await redis_conn.smembers("threat:current")
-            analyses = list(analyses)[:limit]
-        
-        results = []
-        for analysis in analyses:
-            try:
-                analysis_data = json.loads(analysis)
-                results.append({
-                    "timestamp": analysis_data.get("timestamp", time.time()),
-                    "threat_score": analysis_data.get("threat_score", analysis_data.get("score", 0.0)),
-                    "analysis_type": analysis_data.get("analysis_type", "threat_analysis"),
-                    "details": analysis_data.get("details", analysis_data),
-                    "recommendations": analysis_data.get("recommendations", [])
-                })
-            except Exception as e:
-                logger.debug(f"Error parsing AI analysis: {e}")
-                continue
-        
-        # Sort by timestamp (newest first)
-        results.sort(key=lambda x: x["timestamp"], reverse=True)
-        return results[:limit]
-        
-    except Exception as e:
-        logger.error(f"Error getting AI analyses: {e}")
-        raise HTTPException(status_code=500, detail=str(e))
+    """Get recent AI analyses (newest first)"""
+    analyses = list(cache.analyses)[-limit:] if limit > 0 else []
+    analyses.reverse()
+    return analyses
 
 @app.get("/api/stats")
 async def get_system_stats():
     """Get system statistics"""
-    try:
-        redis_conn = await get_redis()
-        
-        # Debug: Check what keys exist in Redis
-        all_keys = await redis_conn.keys("*")
-        logger.info(f"Redis keys found: {all_keys}")
-        
-        # Check data types of Redis keys
-        events_type = await redis_conn.type("events:raw")
-        threat_type = await redis_conn.type("threat:current")
-        
-        logger.info(f"Redis key types - events:raw: {events_type}, threat:current: {threat_type}")
-        
-        # Get event counts based on data type
-        events_count = 0
-        threat_count = 0
-        
-        if events_type == "list":
-            events_count = await redis_conn.llen("events:raw")
-        elif events_type == "string":
-            events_data = await redis_conn.get("events:raw")
-            if events_data:
-                events_count = 1  # Single string value
-                logger.info(f"Sample event (string): {events_data}")
-        elif events_type == "set":
-            events_count = await redis_conn.scard("events:raw")
-        
-        if threat_type == "list":
-            threat_count = await redis_conn.llen("threat:current")
-        elif threat_type == "string":
-            threat_data = await redis_conn.get("threat:current")
-            if threat_data:
-                threat_count = 1  # Single string value
-                logger.info(f"Sample threat (string): {threat_data}")
-        elif threat_type == "set":
-            threat_count = await redis_conn.scard("threat:current")
-        
-        # Parse events to categorize by type
-        memory_count = 0
-        process_count = 0
-        kernel_count = 0
-        perf_count = 0
-        
-        if events_count > 0:
-            # Get a sample of events to categorize
-            sample_size = min(100, events_count)  # Sample up to 100 events
-            if events_type == "list":
-                sample_events = await redis_conn.lrange("events:raw", 0, sample_size-1)
-            elif events_type == "string":
-                event_data = await redis_conn.get("events:raw")
-                sample_events = [event_data] if event_data else []
-            elif events_type == "set":
-                sample_events = await redis_conn.smembers("events:raw")
-                sample_events = list(sample_events)[:sample_size]
-            
-            # Count event types in sample
-            for event in sample_events:
-                try:
-                    event_data = json.loads(event)
-                    event_str = str(event_data).lower()
-                    
-                    if "memory" in event_str or "mmap" in event_str or "munmap" in event_str:
-                        memory_count += 1
-                    elif "process" in event_str or "exec" in event_str or "fork" in event_str or "exit" in event_str:
-                        process_count += 1
-                    elif "kernel" in event_str or "module" in event_str or "init_module" in event_str:
-                        kernel_count += 1
-                    elif "performance" in event_str or "cpu" in event_str or "getpid" in event_str or "brk" in event_str:
-                        perf_count += 1
-                    else:
-                        # If we can't categorize, distribute evenly
-                        memory_count += 1
-                except:
-                    continue
-            
-            # Scale up the counts based on sample
-            if sample_size > 0:
-                scale_factor = events_count / sample_size
-                memory_count = int(memory_count * scale_factor)
-                process_count = int(process_count * scale_factor)
-                kernel_count = int(kernel_count * scale_factor)
-                perf_count = int(perf_count * scale_factor)
-        
-        ai_count = threat_count
-        
-        logger.info(f"Event counts - Memory: {memory_count}, Process: {process_count}, Kernel: {kernel_count}, Performance: {perf_count}, AI: {ai_count}")
-        
-        total_events = memory_count + process_count + kernel_count + perf_count
-        
-        # Calculate average threat score
-        analyses = await redis_conn.lrange("ravn:ai:analyses", 0, 99)  # Last 100
-        threat_scores = []
-        for analysis in analyses:
-            try:
-                data = json.loads(analysis)
-                if "threat_score" in data:
-                    threat_scores.append(float(data["threat_score"]))
-            except:
-                continue
-        
-        avg_threat_score = sum(threat_scores) / len(threat_scores) if threat_scores else 0.0
-        
-        # Calculate events per second (rough estimate)
-        events_per_second = 0.0
-        if total_events > 0:
-            # Get timestamp of oldest event
-            oldest_timestamp = time.time()
-            for key in ["ravn:events:memory", "ravn:events:process", "ravn:events:kernel", "ravn:events:performance"]:
-                events = await redis_conn.lrange(key, -1, -1)  # Get oldest
-                if events:
-                    try:
-                        event_data = json.loads(events[0])
-                        if "timestamp" in event_data:
-                            oldest_timestamp = min(oldest_timestamp, event_data["timestamp"])
-                    except:
-                        continue
-            
-            time_span = time.time() - oldest_timestamp
-            if time_span > 0:
-                events_per_second = total_events / time_span
-        
-        return SystemStats(
-            total_events=total_events,
-            events_per_second=events_per_second,
-            memory_events=memory_count,
-            process_events=process_count,
-            kernel_events=kernel_count,
-            performance_events=perf_count,
-            ai_analyses=ai_count,
-            avg_threat_score=avg_threat_score
-        )
-        
-    except Exception as e:
-        logger.error(f"Error getting system stats: {e}")
-        raise HTTPException(status_code=500, detail=str(e))
+    return cache.stats()
 
 @app.websocket("/ws")
 async def websocket_endpoint(websocket: WebSocket):
     await manager.connect(websocket)
     try:
+        # Frames are sent by the client's sender task; this only notices the close
         while True:
-            # Keep connection alive and send periodic updates
-            await asyncio.sleep(1)
-            
-            # Send system stats
-            try:
-                stats = await get_system_stats()
-                await websocket.send_text(json.dumps({
-                    "type": "stats",
-                    "data": stats.dict(),
-                    "timestamp": time.time()
-                }))
-            except WebSocketDisconnect:
-                # Client disconnected, break the loop
-                break
-            except Exception as e:
-                # Log other errors but don't spam
-                logger.debug(f"Error sending stats: {e}")
-                break
-                
+            await websocket.receive_text()
     except WebSocketDisconnect:
         pass  # Client disconnected normally
     except Exception as e:
@@ -401,85 +356,48 @@ async def websocket_endpoint(websocket: WebSocket):
     finally:
         manager.disconnect(websocket)
 
-# Background task to monitor Redis and broadcast updates
+# Background task: one batched frame per interval for all WebSocket clients
+async def broadcaster():
+    """Flush queued events and stat changes every BROADCAST_INTERVAL"""
+    while True:
+        await asyncio.sleep(BROADCAST_INTERVAL)
+        if manager.clients:
+            try:
+                manager.broadcast(cache.stats().dict())
+            except Exception as e:
+                logger.error(f"Error in broadcaster: {e}")
+
+# Background task: the only Redis reader, feeding the cache and the broadcaster
 async def redis_monitor():
-    """Monitor Redis for new events and broadcast to WebSocket clients"""
+    """Read new events, the threat analysis and daemon counters once per interval"""
     redis_conn = await get_redis()
     
     while True:
         try:
-            # Only broadcast if there are active connections
-            if not manager.active_connections:
-                await asyncio.sleep(1)  # Wait longer if no connections
-                continue
-                
-            # Check for new events in events:raw
-            events_type = await redis_conn.type("events:raw")
-            events = []
-            
-            if events_type == "list":
-                events = await redis_conn.lrange("events:raw", 0, 0)
-            elif events_type == "string":
-                event_data = await redis_conn.get("events:raw")
-                if event_data:
-                    events = [event_data]
-            elif events_type == "set":
-                events = await redis_conn.smembers("events:raw")
-                events = list(events)[:1]
-            
-            if events:
-                try:
-                    event_data = json.loads(events[0])
-                    # Determine event type
-                    event_type = "unknown"
-                    if "memory" in str(event_data).lower():
-                        event_type = "memory"
-                    elif "process" in str(event_data).lower() or "exec" in str(event_data).lower():
-                        event_type = "process"
-                    elif "kernel" in str(event_data).lower() or "module" in str(event_data).lower():
-                        event_type = "kernel"
-                    elif "performance" in str(event_data).lower() or "cpu" in str(event_data).lower():
-                        event_type = "performance"
-                    
-                    await manager.broadcast({
-                        "type": "new_event",
-                        "stream": event_type,
-                        "data": event_data,
-                        "timestamp": time.time()
-                    })
-                except Exception as e:
-                    logger.debug(f"Error processing event: {e}")
-            
-            # Check for new AI analyses in threat:current
-            threat_type = await redis_conn.type("threat:current")
-            analyses = []
-            
-            if threat_type == "list":
-                analyses = await redis_conn.lrange("threat:current", 0, 0)
-            elif threat_type == "string":
-                analysis_data = await redis_conn.get("threat:current")
-                if analysis_data:
-                    analyses = [analysis_data]
-            elif threat_type == "set":
-                analyses = await redis_conn.smembers("threat:current")
-                analyses = list(analyses)[:1]
-            
-            if analyses:
-                try:
-                    analysis_data = json.loads(analyses[0])
-                    await manager.broadcast({
-                        "type": "new_analysis",
-                        "data": analysis_data,
-                        "timestamp": time.time()
-                    })
-                except Exception as e:
-                    logger.debug(f"Error processing AI analysis: {e}")
+            # One round trip per poll, whatever the number of clients
+            async with redis_conn.pipeline(transaction=False) as pipe:
+                pipe.lrange("events:raw", 0, EVENT_BATCH - 1)
+                pipe.get("threat:current")
+                pipe.hgetall(STATS_KEY)
+                raw_events, raw_analysis, daemon_stats = await pipe.execute()
+            now = time.time()
+            cache.redis_up = True
+            cache.updated = now
+
+            new_events = cache.add_events(raw_events)
+            new_analysis = cache.add_analysis(raw_analysis)
+            cache.set_daemon_stats(daemon_stats, now)
+
+            manager.add_events(new_events)
+            if new_analysis:
+                manager.add_analysis(new_analysis)
                     
         except Exception as e:
+            cache.redis_up = False
             logger.error(f"Error in redis_monitor: {e}")
             await asyncio.sleep(5)  # Wait longer on error
         
-        await asyncio.sleep(0.5)  # Check every 500ms
+        await asyncio.sleep(POLL_INTERVAL)
 
 
 if __name__ == "__main__":
@@ -488,5 +406,6 @@ if __name__ == "__main__":
         host="127.0.0.1",
         port=8000,
         reload=True,
+        ws_per_message_deflate=True,
         log_level="info"
     )
@@ -13,6 +13,12 @@ if [ ! -f "train_model.py" ]; then
     exit 1
 fi
 
+# Training extracts features with the daemon's own code (src/daemon/features.c)
+if [ ! -f "../../artifacts/libravnfeatures.so" ]; then
+    echo "Building feature extraction library..."
+    make -C ../.. features
+fi
+
 # Step 1: Generate training data
 echo "Step 1: Generating training data..."
 python3 generate_data.py --output training_data.json
@@ -5,6 +5,7 @@ Trains a deep learning model for threat detection
 """
 
 import numpy as np
+import ctypes
 import json
 import pickle
 import argparse
@@ -20,107 +21,71 @@ from tensorflow.keras.optimizers import Adam
 from tensorflow.keras.callbacks import EarlyStopping, ModelCheckpoint
 import matplotlib.pyplot as plt
 
+# Feature extraction library built from src/daemon/features.c ('make features')
+DEFAULT_FEATURES_LIB = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                                    '../../artifacts/libravnfeatures.so')
+FEATURES_ABI = 1  # RAVN_FEATURES_ABI this script was written against
+
+class RAVNFeatureExtractor:
+    def __init__(self, lib_path: str = DEFAULT_FEATURES_LIB):
+        """Load the daemon's feature extractors from the shared library"""
+        if not os.path.exists(lib_path):
+            raise FileNotFoundError(f"{lib_path} not found, build it with 'make features'")
+        self.lib = ctypes.CDLL(lib_path)
+        self.lib.ravn_features_abi.restype = ctypes.c_uint32
+        self.lib.ravn_features_dim.restype = ctypes.c_uint32
+        self.lib.ravn_features_batch.restype = ctypes.c_int
+        self.lib.ravn_features_batch.argtypes = [
+            ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_void_p,
+            ctypes.c_uint32, ctypes.c_void_p
+        ]
+
+        abi = self.lib.ravn_features_abi()
+        if abi != FEATURES_ABI:
+            raise RuntimeError(f"{lib_path} has feature ABI {abi}, expected {FEATURES_ABI}")
+        self.dim = self.lib.ravn_features_dim()
+
+    def extract(self, sequences: List[List[Dict[str, Any]]]) -> np.ndarray:
+        """Extract one feature vector per sequence in a single library call"""
+        lengths = np.array([len(seq) for seq in sequences], dtype=np.uint64)
+        offsets = np.zeros(len(sequences) + 1, dtype=np.uint64)
+        np.cumsum(lengths, out=offsets[1:])
+
+        events = np.fromiter((e.get('event_type', 0) for seq in sequences for e in seq),
+                             dtype=np.uint32, count=int(offsets[-1]))
+        timestamps = np.fromiter((e.get('timestamp', 0) for seq in sequences for e in seq),
+                                 dtype=np.uint64, count=int(offsets[-1]))
+        pids = np.array([seq[0].get('pid', 0) if seq else 0 for seq in sequences],
+                        dtype=np.uint32)
+        features = np.zeros((len(sequences), self.dim), dtype=np.float32)
+
+        if self.lib.ravn_features_batch(events.ctypes.data, timestamps.ctypes.data,
+                                        offsets.ctypes.data, pids.ctypes.data,
+                                        len(sequences), features.ctypes.data) != 0:
+            raise RuntimeError("ravn_features_batch failed")
+        return features
+
 class RAVNModelTrainer:
-    def __init__(self, sequence_length: int = 20, feature_dim: int = 64):
+    def __init__(self, features_lib: str = DEFAULT_FEATURES_LIB):
         """Initialize the model trainer"""
-        self.sequence_length = sequence_length
-        self.feature_dim = feature_dim
+        self.extractor = RAVNFeatureExtractor(features_lib)
+        self.feature_dim = self.extractor.dim
         self.scaler = StandardScaler()
         self.model = None
-        
-    def extract_features(self, sequence: List[Dict[str, Any]]) -> np.ndarray:
-        """Extract features from a sequence of events"""
-        features = []
-        
-        # Pad or truncate sequence to fixed length
-        if len(sequence) > self.sequence_length:
-            sequence = sequence[:self.sequence_length]
-        else:
-            # Pad with zeros
-            while len(sequence) < self.sequence_length:
-                sequence.append({
-                    'event_type': 0,
-                    'pid': 0,
-                    'tid': 0,
-                    'timestamp': 0
-                })
-        
-        for event in sequence:
-            # Extract numerical features
-            event_features = [
-                event.get('event_type', 0),
-                event.get('pid', 0) / 10000.0,  # Normalize PID
-                event.get('tid', 0) / 10000.0,  # Normalize TID
-                event.get('timestamp', 0) / 1e9,  # Convert to seconds
-            ]
-            
-            # Add more features based on event data
-            try:
-                data = json.loads(event.get('data', '{}'))
-                if 'syscall' in data:
-                    # Map syscall name to number
-                    syscall_map = {
-                        'execve': 59, 'open': 2, 'read': 0, 'write': 1,
-                        'mmap': 9, 'mprotect': 10, 'close': 3, 'unlink': 87,
-                        'rename': 82, 'ptrace': 101, 'setuid': 105, 'chmod': 90,
-                        'chown': 92, 'mount': 165, 'umount': 166
-                    }
-                    event_features.append(syscall_map.get(data['syscall'], 0))
-                else:
-                    event_features.append(0)
-                    
-                # Add return value
-                event_features.append(data.get('ret', 0))
-                
-                # Add filename length (as a feature)
-                filename = data.get('filename', '')
-                event_features.append(len(filename) / 100.0)  # Normalize
-                
-                # Add more features
-                event_features.extend([0, 0, 0])  # Padding to reach feature_dim
-                
-            except (json.JSONDecodeError, KeyError):
-                event_features.extend([0] * 6)  # Default values
-            
-            # Ensure we have exactly feature_dim features
-            while len(event_features) < self.feature_dim:
-                event_features.append(0)
-            event_features = event_features[:self.feature_dim]
-            
-            features.extend(event_features)
-        
-        # Ensure we have exactly 64 features total
-        while len(features) < 64:
-            features.append(0)
-        features = features[:64]
-        
-        # Reshape to (1, 64) to represent 1 timestep with 64 features
-        return np.array(features, dtype=np.float32).reshape(1, 64)
     
     def prepare_data(self, dataset: Dict[str, List[Dict[str, Any]]]) -> Tuple[np.ndarray, np.ndarray]:
         """Prepare training data from dataset"""
-        X = []
+        sequences = []
         y = []
         
-        # Process normal sequences
-        for item in dataset['normal_sequences']:
-            features = self.extract_features(item['sequence'])
-            X.append(features)
-            y.append(0)  # Normal
-        
-        # Process suspicious sequences
-        for item in dataset['suspicious_sequences']:
-            features = self.extract_features(item['sequence'])
-            X.append(features)
-            y.append(1)  # Suspicious
-        
-        # Process attack sequences
-        for item in dataset['attack_sequences']:
-            features = self.extract_features(item['sequence'])
-            X.append(features)
-            y.append(2)  # Attack
+        # Normal, suspicious and attack sequences
+        for label, key in enumerate(['normal_sequences', 'suspicious_sequences', 'attack_sequences']):
+            for item in dataset[key]:
+                sequences.append(item['sequence'])
+                y.append(label)
         
-        X = np.array(X)
+        # Same vectors as the daemon scores: 1 timestep of feature_dim features
+        X = self.extractor.extract(sequences).reshape(len(sequences), 1, self.feature_dim)
         y = np.array(y)
         
         print(f"Data shape: X={X.shape}, y={y.shape}")
@@ -171,7 +136,7 @@ class RAVNModelTrainer:
         print(f"Test set: {X_test.shape[0]} samples")
         
         # Build model
-        # X_train shape should be (samples, timesteps, features) = (samples, 1, 64)
+        # X_train shape should be (samples, timesteps, features) = (samples, 1, feature_dim)
         self.model = self.build_model((X_train.shape[1], X_train.shape[2]))
         
         # Print model summary
@@ -249,8 +214,8 @@ class RAVNModelTrainer:
         
         # Save model metadata
         metadata = {
-            'sequence_length': self.sequence_length,
             'feature_dim': self.feature_dim,
+            'features_abi': FEATURES_ABI,
             'input_shape': self.model.input_shape,
             'output_shape': self.model.output_shape,
             'class_names': ['Normal', 'Suspicious', 'Attack']
@@ -298,8 +263,8 @@ def main():
     parser.add_argument('--output', '-o', default='ravn_model', help='Output model path')
     parser.add_argument('--epochs', type=int, default=100, help='Number of training epochs')
     parser.add_argument('--batch-size', type=int, default=32, help='Batch size')
-    parser.add_argument('--sequence-length', type=int, default=20, help='Sequence length')
-    parser.add_argument('--feature-dim', type=int, default=10, help='Feature dimension')
+    parser.add_argument('--features-lib', default=DEFAULT_FEATURES_LIB,
+                        help='Feature extraction library (make features)')
     
     args = parser.parse_args()
     
@@ -309,10 +274,7 @@ def main():
         dataset = json.load(f)
     
     # Initialize trainer
-    trainer = RAVNModelTrainer(
-        sequence_length=args.sequence_length,
-        feature_dim=args.feature_dim
-    )
+    trainer = RAVNModelTrainer(features_lib=args.features_lib)
     
     # Prepare data
     print("Preparing training data...")
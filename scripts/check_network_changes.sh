@@ -10,6 +10,7 @@ NETWORK_HASH_FILE="$ARTIFACTS_DIR/.network_hash"
 # Network-related files that require model retraining
 NETWORK_FILES="$SRC_DIR/daemon/ai_engine.c \
                $SRC_DIR/daemon/ai_engine.h \
+               $SRC_DIR/daemon/ai_types.h \
                $SRC_DIR/daemon/ravn_lstm.h \
                $SRC_DIR/daemon/ravn_rnn_lstm.c \
                $SRC_DIR/daemon/codegen/model_weights.h \
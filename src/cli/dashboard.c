@@ -0,0 +1,472 @@
+// RAVN CLI Dashboard Implementation
+// Terminal dashboard fed by the status segment, with Redis as fallback
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "dashboard.h"
+
+#include "../daemon/ai_engine.h"
+#include "../daemon/ebpf_handler.h"
+#include "../daemon/health.h"
+#include "../daemon/status.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+#include "../utils/tui.h"
+
+#include <fcntl.h>
+#include <hiredis/hiredis.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Everything shown in one frame
+struct dashboard_data {
+	int have_status;				 /* Status segment current */
+	struct ravn_status status;			 /* Status snapshot */
+	uint64_t redis_refreshed_ns;			 /* Last Redis refresh */
+	int redis_up;					 /* Redis reachable */
+	int have_threat;				 /* Threat level known */
+	threat_level_t threat;				 /* Threat level */
+	long long queue_depth;				 /* events:raw length */
+	long long events[EVENT_CATEGORY_MAX + 1];	 /* Per category */
+	long long bytes_sent;				 /* Network bytes sent */
+	long long bytes_received;			 /* Network bytes received */
+	int feed_count;					 /* Activity entries */
+	char feed[DASHBOARD_FEED_LINES][96];		 /* Activity lines */
+	double uptime_s;				 /* Host uptime */
+	float mem_pct;					 /* Host memory in use */
+};
+
+static volatile sig_atomic_t dashboard_stop = 0;
+
+// Leave the dashboard on SIGINT/SIGTERM
+static void dashboard_signal_handler(int sig) {
+	(void)sig;
+	dashboard_stop = 1;
+}
+
+// Read host memory usage from a kept-open /proc/meminfo descriptor
+static float read_mem_pct(int fd) {
+	char buf[4096];
+	ssize_t n = fd >= 0 ? pread(fd, buf, sizeof(buf) - 1, 0) : -1;
+	if (n <= 0) {
+		return -1.0f;
+	}
+	buf[n] = '\0';
+
+	const char* total = strstr(buf, "MemTotal:");
+	const char* avail = strstr(buf, "MemAvailable:");
+	if (!total || !avail) {
+		return -1.0f;
+	}
+	long total_kb = strtol(total + strlen("MemTotal:"), NULL, 10);
+	long avail_kb = strtol(avail + strlen("MemAvailable:"), NULL, 10);
+	return total_kb > 0 ? (float)(total_kb - avail_kb) * 100.0f / total_kb : -1.0f;
+}
+
+// Turn one queued event JSON into an activity line
+static void format_activity(const char* json, char* line, size_t size) {
+	const char* p;
+	unsigned long pid = 0, category = 0;
+	char comm[17] = "?";
+
+	// Top-level keys precede the escaped "data" payload
+	if ((p = strstr(json, "\"pid\":")) != NULL) {
+		pid = strtoul(p + strlen("\"pid\":"), NULL, 10);
+	}
+	if ((p = strstr(json, "\"event_category\":")) != NULL) {
+		category = strtoul(p + strlen("\"event_category\":"), NULL, 10);
+	}
+	if ((p = strstr(json, "\"comm\":\"")) != NULL) {
+		p += strlen("\"comm\":\"");
+		size_t len = strcspn(p, "\"");
+		if (len >= sizeof(comm)) {
+			len = sizeof(comm) - 1;
+		}
+		memcpy(comm, p, len);
+		comm[len] = '\0';
+	}
+
+	snprintf(line, size, "[%-11s] %-16s PID %lu", get_event_category_name((uint32_t)category),
+		 comm, pid);
+}
+
+// Bring the Redis connection up if it is down (1 if it just came up)
+static int dashboard_connect(redis_connection_t** conn, const char* host, int port) {
+	if (!*conn) {
+		*conn = redis_connect(host, port);
+		return *conn != NULL;
+	}
+	if (redis_is_connected(*conn)) {
+		return 0;
+	}
+	return redis_reconnect(*conn) == 0;
+}
+
+// Refresh the Redis-backed fields (all of them only without a status segment)
+static void refresh_redis(struct dashboard_data* d, redis_connection_t* conn) {
+	redisReply* reply;
+
+	if (!d->have_status) {
+		d->redis_up = redis_ping(conn) == 0;
+		d->have_threat = redis_get_threat_level(conn, &d->threat) == 0;
+
+		d->queue_depth = 0;
+		reply = redis_command(conn, "LLEN events:raw");
+		if (reply && reply->type == REDIS_REPLY_INTEGER) {
+			d->queue_depth = reply->integer;
+		}
+		if (reply)
+			freeReplyObject(reply);
+
+		// One HMGET of the daemon counters instead of scanning the event list
+		memset(d->events, 0, sizeof(d->events));
+		d->bytes_sent = d->bytes_received = 0;
+		reply = redis_command(conn, "HMGET " REDIS_STATS_KEY
+					    " syscall_events network_events security_events"
+					    " file_events net_bytes_sent net_bytes_received");
+		if (reply && reply->type == REDIS_REPLY_ARRAY && reply->elements == 6) {
+			long long* counters[] = {&d->events[EVENT_CATEGORY_SYSCALL],
+						 &d->events[EVENT_CATEGORY_NETWORK],
+						 &d->events[EVENT_CATEGORY_SECURITY],
+						 &d->events[EVENT_CATEGORY_FILE],
+						 &d->bytes_sent,
+						 &d->bytes_received};
+			for (size_t i = 0; i < reply->elements; i++) {
+				if (reply->element[i]->type == REDIS_REPLY_STRING) {
+					*counters[i] = strtoll(reply->element[i]->str, NULL, 10);
+				}
+			}
+		}
+		if (reply)
+			freeReplyObject(reply);
+	}
+
+	// Latest events for the activity feed
+	d->feed_count = 0;
+	reply = redis_command(conn, "LRANGE events:raw 0 %d", DASHBOARD_FEED_LINES - 1);
+	if (reply && reply->type == REDIS_REPLY_ARRAY) {
+		for (size_t i = 0; i < reply->elements && d->feed_count < DASHBOARD_FEED_LINES;
+		     i++) {
+			if (reply->element[i]->type == REDIS_REPLY_STRING) {
+				format_activity(reply->element[i]->str, d->feed[d->feed_count],
+						sizeof(d->feed[0]));
+				d->feed_count++;
+			}
+		}
+	}
+	if (reply)
+		freeReplyObject(reply);
+}
+
+// Take the live fields from the status snapshot
+static void apply_status(struct dashboard_data* d) {
+	const struct ravn_status* st = &d->status;
+
+	d->redis_up = st->components[HEALTH_REDIS].state <= HEALTH_DEGRADED;
+	d->have_threat = 1;
+	d->threat.timestamp = st->timestamp;
+	d->threat.score = st->threat_score;
+	d->threat.level = st->threat_level;
+	snprintf(d->threat.reason, sizeof(d->threat.reason), "%s", st->threat_reason);
+	d->queue_depth = st->queue_depth;
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		d->events[cat] = (long long)st->categories[cat].events;
+	}
+	d->bytes_sent = (long long)st->net_bytes_sent;
+	d->bytes_received = (long long)st->net_bytes_received;
+}
+
+// Draw a health state indicator
+static int draw_state(struct tui* tui, int row, int col, int state) {
+	switch (state) {
+	case HEALTH_OK:
+		return tui_print(tui, row, col, TUI_GREEN | TUI_BOLD, "● OK");
+	case HEALTH_DEGRADED:
+		return tui_print(tui, row, col, TUI_YELLOW | TUI_BOLD, "● DEGRADED");
+	case HEALTH_STALLED:
+		return tui_print(tui, row, col, TUI_RED | TUI_BOLD, "● STALLED");
+	case HEALTH_FAILED:
+		return tui_print(tui, row, col, TUI_RED | TUI_BOLD, "● FAILED");
+	default:
+		return tui_print(tui, row, col, TUI_BLACK | TUI_BOLD, "● N/A");
+	}
+}
+
+// Draw the header, status bar and threat assessment
+static void draw_threat(struct tui* tui, const struct dashboard_data* d, int row) {
+	const uint8_t frame = TUI_WHITE | TUI_BOLD;
+
+	tui_box(tui, row, 0, 4, DASHBOARD_WIDTH, frame, NULL);
+	tui_print(tui, row + 1, 26, TUI_CYAN | TUI_BOLD, "RAVN SECURITY PLATFORM v2.0");
+	tui_print(tui, row + 2, 21, TUI_YELLOW | TUI_BOLD,
+		  "Real-time Threat Detection & Analysis");
+	row += 4;
+
+	char time_str[64];
+	time_t now = time(NULL);
+	struct tm tm_info;
+	localtime_r(&now, &tm_info);
+	strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &tm_info);
+
+	tui_box(tui, row, 0, 3, DASHBOARD_WIDTH, frame, "STATUS");
+	int col = tui_print(tui, row + 1, 2, TUI_GREEN | TUI_BOLD, "● LIVE");
+	col = tui_print(tui, row + 1, col, frame, " │ ");
+	col = tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%s", time_str);
+	col = tui_print(tui, row + 1, col, frame, " │ Source: ");
+	col = tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%s",
+			d->have_status ? "status segment" : "redis");
+	col = tui_print(tui, row + 1, col, frame, " │ ");
+	tui_print(tui, row + 1, col, TUI_YELLOW | TUI_BOLD, "Press Ctrl+C to exit");
+	row += 3;
+
+	tui_box(tui, row, 0, 4, DASHBOARD_WIDTH, frame, "THREAT ASSESSMENT");
+	if (!d->have_threat) {
+		col = tui_print(tui, row + 1, 2, frame, "Threat Level: ");
+		col = tui_print(tui, row + 1, col, TUI_BLACK | TUI_BOLD, "NO DATA");
+		col = tui_print(tui, row + 1, col, frame, " │ Score: ");
+		col = tui_print(tui, row + 1, col, TUI_BLACK | TUI_BOLD, "N/A");
+		col = tui_print(tui, row + 1, col, frame, " │ [");
+		col = tui_fill(tui, row + 1, col, 20, 0x2591, TUI_BLACK | TUI_BOLD); // ░
+		tui_print(tui, row + 1, col, frame, "]");
+		col = tui_print(tui, row + 2, 2, frame, "Analysis: ");
+		tui_print(tui, row + 2, col, TUI_BLACK | TUI_BOLD, "Waiting for data...");
+		return;
+	}
+
+	const char* level_str = d->threat.level >= THREAT_HIGH	   ? "CRITICAL"
+				: d->threat.level == THREAT_MEDIUM ? "ELEVATED"
+								   : "NORMAL";
+	uint8_t color = d->threat.level >= THREAT_HIGH	   ? TUI_RED | TUI_BOLD
+			: d->threat.level == THREAT_MEDIUM ? TUI_YELLOW | TUI_BOLD
+							   : TUI_GREEN | TUI_BOLD;
+
+	int filled = (int)(d->threat.score * 20);
+	filled = filled < 0 ? 0 : filled > 20 ? 20 : filled;
+
+	col = tui_print(tui, row + 1, 2, frame, "Threat Level: ");
+	col = tui_print(tui, row + 1, col, color, "%-8s", level_str);
+	col = tui_print(tui, row + 1, col, frame, " │ Score: ");
+	col = tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%.3f", d->threat.score);
+	col = tui_print(tui, row + 1, col, frame, " │ [");
+	col = tui_fill(tui, row + 1, col, filled, 0x2588, color); // █
+	col = tui_fill(tui, row + 1, col, 20 - filled, 0x2591, TUI_BLACK | TUI_BOLD);
+	tui_print(tui, row + 1, col, frame, "]");
+	col = tui_print(tui, row + 2, 2, frame, "Analysis: ");
+	tui_print(tui, row + 2, col, TUI_YELLOW | TUI_BOLD, "%.64s", d->threat.reason);
+}
+
+// Draw component status and the metrics dashboard
+static void draw_metrics(struct tui* tui, const struct dashboard_data* d, int row) {
+	const uint8_t frame = TUI_WHITE | TUI_BOLD;
+	const struct ravn_status* st = &d->status;
+	int col;
+
+	tui_box(tui, row, 0, 3, DASHBOARD_WIDTH, frame, "SYSTEM STATUS");
+	col = tui_print(tui, row + 1, 2, frame, "Redis: ");
+	if (d->redis_up) {
+		col = tui_print(tui, row + 1, col, TUI_GREEN | TUI_BOLD, "● CONNECTED");
+	} else {
+		col = tui_print(tui, row + 1, col, TUI_RED | TUI_BOLD, "● DISCONNECTED");
+	}
+	col = tui_print(tui, row + 1, col, frame, " │ eBPF: ");
+	col = draw_state(tui, row + 1, col,
+			 d->have_status ? st->components[HEALTH_RINGBUF].state : -1);
+	col = tui_print(tui, row + 1, col, frame, " │ AI: ");
+	col = draw_state(tui, row + 1, col, d->have_status ? st->components[HEALTH_AI].state : -1);
+	col = tui_print(tui, row + 1, col, frame, " │ Health: ");
+	draw_state(tui, row + 1, col, d->have_status ? st->health_state : -1);
+	row += 3;
+
+	tui_box(tui, row, 0, 6, DASHBOARD_WIDTH, frame, "METRICS DASHBOARD");
+	col = tui_print(tui, row + 1, 2, frame, "Queue: ");
+	col = tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%lld", d->queue_depth);
+	col = tui_print(tui, row + 1, col, frame, " │ Uptime: ");
+	int hours = (int)(d->uptime_s / 3600);
+	int minutes = (int)((d->uptime_s - hours * 3600) / 60);
+	col = tui_print(tui, row + 1, col, TUI_YELLOW | TUI_BOLD, "%02dh %02dm", hours, minutes);
+	if (d->mem_pct >= 0) {
+		col = tui_print(tui, row + 1, col, frame, " │ Memory: ");
+		tui_print(tui, row + 1, col, TUI_MAGENTA | TUI_BOLD, "%.1f%%", d->mem_pct);
+	}
+
+	col = tui_print(tui, row + 2, 2, frame, "Syscalls: ");
+	col = tui_print(tui, row + 2, col, TUI_CYAN | TUI_BOLD, "%lld",
+			d->events[EVENT_CATEGORY_SYSCALL]);
+	col = tui_print(tui, row + 2, col, frame, " │ Network: ");
+	col = tui_print(tui, row + 2, col, TUI_YELLOW | TUI_BOLD, "%lld",
+			d->events[EVENT_CATEGORY_NETWORK]);
+	col = tui_print(tui, row + 2, col, frame, " │ Security: ");
+	col = tui_print(tui, row + 2, col, TUI_RED | TUI_BOLD, "%lld",
+			d->events[EVENT_CATEGORY_SECURITY]);
+	col = tui_print(tui, row + 2, col, frame, " │ File I/O: ");
+	tui_print(tui, row + 2, col, TUI_MAGENTA | TUI_BOLD, "%lld", d->events[EVENT_CATEGORY_FILE]);
+
+	col = tui_print(tui, row + 3, 2, frame, "Network Traffic: ");
+	col = tui_print(tui, row + 3, col, TUI_GREEN | TUI_BOLD, "↑%.2f KB", d->bytes_sent / 1024.0);
+	col = tui_print(tui, row + 3, col, frame, " │ ↓%.2f KB │ Total: ",
+			d->bytes_received / 1024.0);
+	tui_print(tui, row + 3, col, TUI_CYAN | TUI_BOLD, "%.2f KB",
+		  (d->bytes_sent + d->bytes_received) / 1024.0);
+
+	if (d->have_status) {
+		col = tui_print(tui, row + 4, 2, frame, "Event Rate: ");
+		col = tui_print(tui, row + 4, col, TUI_CYAN | TUI_BOLD, "%.0f/s",
+				st->events_per_sec);
+		col = tui_print(tui, row + 4, col, frame, " │ Overhead: ");
+		tui_print(tui, row + 4, col, TUI_YELLOW | TUI_BOLD,
+			  "BPF %.3f%% │ Handlers %.3f%% │ Daemon %.2f%%", st->kernel_pct,
+			  st->user_pct, st->process_pct);
+	} else {
+		tui_print(tui, row + 4, 2, TUI_BLACK | TUI_BOLD,
+			  "Event rates and overhead need the daemon status segment");
+	}
+}
+
+// Draw the AI window summary, activity feed and footer
+static void draw_activity(struct tui* tui, const struct dashboard_data* d, int row) {
+	const uint8_t frame = TUI_WHITE | TUI_BOLD;
+	const struct ravn_status* st = &d->status;
+	int col;
+
+	tui_box(tui, row, 0, 4, DASHBOARD_WIDTH, frame, "AI ANALYSIS");
+	col = tui_print(tui, row + 1, 2, frame, "Window: ");
+	col = tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%ds", WINDOW_SIZE_SECONDS);
+	col = tui_print(tui, row + 1, col, frame, " │ Slide: ");
+	col = tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%ds", SLIDE_INTERVAL_SECONDS);
+	if (d->have_status) {
+		col = tui_print(tui, row + 1, col, frame, " │ Tracked Processes: ");
+		tui_print(tui, row + 1, col, TUI_CYAN | TUI_BOLD, "%d", st->process_count);
+		if (st->top_count > 0) {
+			col = tui_print(tui, row + 2, 2, frame, "Top Process: ");
+			tui_print(tui, row + 2, col, TUI_YELLOW | TUI_BOLD,
+				  "PID %u │ score %.3f │ %u events", st->top[0].pid,
+				  st->top[0].threat_score, st->top[0].event_count);
+		} else {
+			tui_print(tui, row + 2, 2, TUI_BLACK | TUI_BOLD, "No tracked processes");
+		}
+	}
+	row += 4;
+
+	tui_box(tui, row, 0, DASHBOARD_FEED_LINES + 2, DASHBOARD_WIDTH, frame, "ACTIVITY FEED");
+	for (int i = 0; i < d->feed_count; i++) {
+		tui_print(tui, row + 1 + i, 2, TUI_CYAN | TUI_BOLD, "%s", d->feed[i]);
+	}
+	if (d->feed_count == 0) {
+		tui_print(tui, row + 1, 2, TUI_BLACK | TUI_BOLD, "No queued events");
+	}
+	row += DASHBOARD_FEED_LINES + 2;
+
+	tui_box(tui, row, 0, 3, DASHBOARD_WIDTH, frame, "RAVN v2.0");
+	tui_print(tui, row + 1, 2, TUI_BLACK | TUI_BOLD,
+		  "Real-time eBPF monitoring │ AI-powered threat detection │ Professional SOC");
+}
+
+// Sleep for a number of nanoseconds (interrupted by signals)
+static void dashboard_sleep_ns(uint64_t ns) {
+	struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+	nanosleep(&ts, NULL);
+}
+
+// Run the dashboard until interrupted
+int dashboard_run(const char* host, int port) {
+	struct tui tui;
+	struct status_reader reader = {0};
+	struct dashboard_data data;
+
+	// Redis only backs the fallback and activity data, so it may come up later
+	redis_connection_t* conn = redis_connect(host, port);
+	if (!conn) {
+		LOG_WARN_MODULE("CLI", "Redis at %s:%d unreachable (%s), retrying every %d ms",
+				host, port, redis_get_last_error(), DASHBOARD_REDIS_INTERVAL_MS);
+	}
+
+	if (tui_init(&tui, STDOUT_FILENO) != 0) {
+		LOG_ERROR_MODULE("CLI", "Failed to set up the terminal");
+		if (conn) {
+			redis_disconnect(conn);
+		}
+		return -1;
+	}
+
+	memset(&data, 0, sizeof(data));
+	int meminfo_fd = open("/proc/meminfo", O_RDONLY | O_CLOEXEC);
+
+	// No SA_RESTART: a signal has to end the wait for the next change
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = dashboard_signal_handler;
+	sigemptyset(&sa.sa_mask);
+	dashboard_stop = 0;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+
+	uint32_t change = 0;
+	uint64_t frame_ns = 0;
+	while (!dashboard_stop) {
+		uint64_t now = ravn_prof_now_ns();
+
+		data.have_status = status_read(&reader, &data.status) == 0;
+		if (now - data.redis_refreshed_ns >= DASHBOARD_REDIS_INTERVAL_MS * 1000000ULL) {
+			// The connect log line lands on the screen, so repaint all of it
+			if (dashboard_connect(&conn, host, port)) {
+				tui_invalidate(&tui);
+			}
+			refresh_redis(&data, conn);
+			data.mem_pct = read_mem_pct(meminfo_fd);
+			data.redis_refreshed_ns = now;
+		}
+		if (data.have_status) {
+			apply_status(&data);
+		}
+
+		struct timespec boot;
+		clock_gettime(CLOCK_BOOTTIME, &boot);
+		data.uptime_s = boot.tv_sec + boot.tv_nsec / 1e9;
+
+		if (tui_begin(&tui) != 0) {
+			break;
+		}
+		draw_threat(&tui, &data, 0);
+		draw_metrics(&tui, &data, 11);
+		draw_activity(&tui, &data, 20);
+		if (tui_flush(&tui) < 0) {
+			break;
+		}
+		frame_ns = now;
+
+		// Block until the daemon publishes a change or Redis data is due
+		uint64_t redis_due = data.redis_refreshed_ns +
+				     DASHBOARD_REDIS_INTERVAL_MS * 1000000ULL;
+		now = ravn_prof_now_ns();
+		if (now >= redis_due) {
+			continue;
+		}
+		int timeout_ms = (int)((redis_due - now + 999999ULL) / 1000000ULL);
+		if (status_wait(&reader, &change, timeout_ms) < 0) {
+			dashboard_sleep_ns(redis_due - now);
+			continue;
+		}
+
+		// Coalesce bursts of changes into one frame per interval
+		now = ravn_prof_now_ns();
+		if (now - frame_ns < DASHBOARD_MIN_FRAME_MS * 1000000ULL) {
+			dashboard_sleep_ns(frame_ns + DASHBOARD_MIN_FRAME_MS * 1000000ULL - now);
+		}
+	}
+
+	if (meminfo_fd >= 0) {
+		close(meminfo_fd);
+	}
+	status_reader_close(&reader);
+	tui_cleanup(&tui);
+	if (conn) {
+		redis_disconnect(conn);
+	}
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+	return 0;
+}
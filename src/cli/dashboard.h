@@ -0,0 +1,62 @@
+/*
+ * RAVN CLI Dashboard - Header File
+ *
+ * This header defines the terminal dashboard of the RAVN security platform
+ * ("ravn cli"), showing the threat level, component status, event counters
+ * and recent activity of a running daemon.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The CLI dashboard implements:
+ * - Threat level, score and reason with a score bar
+ * - Redis, eBPF, AI and overall health status
+ * - Queue depth, uptime, memory, per-category counters and rates
+ * - AI window summary and the highest scoring process
+ * - Recent activity from the event queue
+ *
+ * Architecture:
+ * - Live state comes from the daemon's status segment when it is current,
+ *   with Redis as the fallback source
+ * - Redis is optional: the dashboard starts without it and reconnects at
+ *   every Redis refresh until it is back
+ * - Frames are event-driven: the dashboard blocks on the status segment's
+ *   change counter and redraws when the daemon publishes a change, or when
+ *   the next Redis refresh is due (which also advances the uptime)
+ * - Bursts of changes are coalesced to one frame per DASHBOARD_MIN_FRAME_MS
+ * - Redis-backed data is refreshed at most every DASHBOARD_REDIS_INTERVAL_MS;
+ *   without a status segment this is also the polling interval
+ * - Frames are drawn with the terminal renderer, which only sends the
+ *   cells that changed
+ * - Host uptime and memory come from CLOCK_BOOTTIME and a kept-open
+ *   /proc/meminfo descriptor, without stdio
+ */
+
+#ifndef RAVN_DASHBOARD_H
+#define RAVN_DASHBOARD_H
+
+#include "../daemon/redis_client.h"
+
+/*
+ * Dashboard Configuration Parameters
+ */
+#define DASHBOARD_MIN_FRAME_MS	    50	 /* Shortest interval between frames */
+#define DASHBOARD_REDIS_INTERVAL_MS 1000 /* Redis query interval */
+#define DASHBOARD_WIDTH		    80	 /* Layout width in columns */
+#define DASHBOARD_FEED_LINES	    3	 /* Activity feed entries */
+
+/**
+ * dashboard_run - Run the dashboard until interrupted
+ * @host: Redis host for the fallback and activity data
+ * @port: Redis port
+ *
+ * Takes over the terminal, redraws when the daemon publishes a change (at
+ * most every DASHBOARD_MIN_FRAME_MS) or the Redis data is refreshed, and
+ * restores the terminal on SIGINT or SIGTERM.
+ *
+ * Return: 0 on normal exit, -1 if the terminal could not be set up
+ */
+int dashboard_run(const char* host, int port);
+
+#endif // RAVN_DASHBOARD_H
@@ -5,10 +5,16 @@
 #define _DEFAULT_SOURCE
 #include "ai_engine.h"
 
+#include "../utils/error_handling.h"
+#include "../utils/hotmem.h"
 #include "../utils/logger.h"
 #include "codegen/model_weights.h" // Generated model weights
 #include "ebpf_handler.h"
+#include "features.h"
+#include "health.h"
+#include "placement.h"
 #include "redis_client.h"
+#include "status.h"
 
 #include <hiredis/hiredis.h>
 #include <math.h>
@@ -17,18 +23,25 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/prctl.h>
 #include <time.h>
 #include <unistd.h>
 
 // Global AI engine instance
 static ai_engine_t* global_ai_engine = NULL;
 
-// Forward declarations
-void sliding_window_cleanup(struct sliding_window* window);
+// Default engine clock: CLOCK_MONOTONIC, the clock of bpf_ktime_get_ns()
+static uint64_t ai_default_clock(void* ctx) {
+	(void)ctx;
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
 
 // Initialize AI engine
 ai_engine_t* ai_engine_init(const char* model_path) {
-	ai_engine_t* engine = malloc(sizeof(ai_engine_t));
+	// The window and weights are touched on every event: keep them on huge pages
+	ai_engine_t* engine = hotmem_alloc(sizeof(ai_engine_t), "ai-engine");
 	if (!engine) {
 		LOG_ERROR("Failed to allocate memory for AI engine");
 		return NULL;
@@ -40,11 +53,15 @@ ai_engine_t* ai_engine_init(const char* model_path) {
 	engine->model_path[sizeof(engine->model_path) - 1] = '\0';
 	engine->thread_running = 0;
 	engine->should_stop = 0;
+	engine->clock = ai_default_clock;
+	engine->clock_ctx = NULL;
+	pthread_mutex_init(&engine->window_lock, NULL);
 
 	// Initialize sliding window
-	if (sliding_window_init(&engine->window) != 0) {
+	if (sliding_window_init(&engine->window, ai_engine_now(engine)) != 0) {
 		LOG_ERROR("Failed to initialize sliding window");
-		free(engine);
+		pthread_mutex_destroy(&engine->window_lock);
+		hotmem_free(engine);
 		return NULL;
 	}
 
@@ -58,7 +75,8 @@ ai_engine_t* ai_engine_init(const char* model_path) {
 			  "required");
 		sliding_window_cleanup(&engine->window);
 		global_ai_engine = NULL;
-		free(engine);
+		pthread_mutex_destroy(&engine->window_lock);
+		hotmem_free(engine);
 		return NULL;
 	}
 
@@ -68,6 +86,27 @@ ai_engine_t* ai_engine_init(const char* model_path) {
 	return engine;
 }
 
+// Install the clock used for window sliding
+void ai_engine_set_clock(ai_engine_t* engine, ai_clock_fn clock, void* ctx) {
+	if (!engine) {
+		return;
+	}
+
+	engine->clock = clock ? clock : ai_default_clock;
+	engine->clock_ctx = clock ? ctx : NULL;
+
+	// Restart the window on the new time base
+	pthread_mutex_lock(&engine->window_lock);
+	sliding_window_cleanup(&engine->window);
+	sliding_window_init(&engine->window, ai_engine_now(engine));
+	pthread_mutex_unlock(&engine->window_lock);
+}
+
+// Read the engine clock
+uint64_t ai_engine_now(const ai_engine_t* engine) {
+	return engine->clock(engine->clock_ctx);
+}
+
 // Cleanup AI engine
 void ai_engine_cleanup(ai_engine_t* engine) {
 	if (!engine) {
@@ -81,6 +120,7 @@ void ai_engine_cleanup(ai_engine_t* engine) {
 
 	// Cleanup sliding window
 	memset(&engine->window, 0, sizeof(engine->window));
+	pthread_mutex_destroy(&engine->window_lock);
 
 	engine->initialized = 0;
 
@@ -88,7 +128,7 @@ void ai_engine_cleanup(ai_engine_t* engine) {
 		global_ai_engine = NULL;
 	}
 
-	free(engine);
+	hotmem_free(engine);
 	LOG_INFO("AI engine cleaned up");
 }
 
@@ -114,6 +154,9 @@ float ai_engine_analyze_event(ai_engine_t* engine, const struct ravn_event* even
 		return 0.0f;
 	}
 
+	RAVN_TIME_START(analyze_event);
+	pthread_mutex_lock(&engine->window_lock);
+
 	// Find or create event sequence for this PID
 	struct event_sequence* seq = NULL;
 	for (int i = 0; i < engine->window.process_count; i++) {
@@ -126,6 +169,7 @@ float ai_engine_analyze_event(ai_engine_t* engine, const struct ravn_event* even
 	if (!seq) {
 		// Create new sequence
 		if (engine->window.process_count >= MAX_PROCESSES) {
+			pthread_mutex_unlock(&engine->window_lock);
 			return 0.0f; // Too many processes
 		}
 
@@ -134,6 +178,7 @@ float ai_engine_analyze_event(ai_engine_t* engine, const struct ravn_event* even
 		seq->event_count = 0;
 		seq->threat_score = 0.0f;
 	}
+	seq->cgroup_id = event->cgroup_id;
 
 	// Add event to sequence
 	if (seq->event_count < MAX_EVENTS_PER_WINDOW) {
@@ -143,25 +188,180 @@ float ai_engine_analyze_event(ai_engine_t* engine, const struct ravn_event* even
 	}
 
 	// Calculate threat score for this sequence
-	seq->threat_score = ai_calculate_threat_score(seq);
+	float score = ai_calculate_threat_score(seq);
+	seq->threat_score = score;
 
-	// Update sliding window analysis
-	uint64_t current_time = time(NULL);
-	sliding_window_update(&engine->window, current_time);
+	// Update sliding window analysis (may move or drop sequences)
+	sliding_window_update(&engine->window, ai_engine_now(engine));
 	sliding_window_analyze(&engine->window);
 
-	return seq->threat_score;
+	pthread_mutex_unlock(&engine->window_lock);
+	RAVN_TIME_END(analyze_event, "AI-ENGINE", "ai_engine_analyze_event");
+	return score;
+}
+
+// Collect the highest scoring processes of a window (caller holds the window lock)
+static int ai_window_top(const struct sliding_window* window, struct ai_process_summary* top,
+			 int max) {
+	int count = 0;
+
+	// Insertion into a short sorted list; the window holds at most MAX_PROCESSES
+	for (int i = 0; i < window->process_count; i++) {
+		const struct event_sequence* seq = &window->processes[i];
+		int pos = count;
+		while (pos > 0 && top[pos - 1].threat_score < seq->threat_score) {
+			if (pos < max) {
+				top[pos] = top[pos - 1];
+			}
+			pos--;
+		}
+		if (pos < max) {
+			top[pos].pid = seq->pid;
+			top[pos].event_count = seq->event_count;
+			top[pos].cgroup_id = seq->cgroup_id;
+			top[pos].threat_score = seq->threat_score;
+			if (count < max) {
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+// Collect the highest scoring cgroups of a window (caller holds the window lock)
+static int ai_window_cgroups(const struct sliding_window* window,
+			     struct ai_cgroup_summary* cgroups, int max) {
+	int count = 0;
+
+	for (int i = 0; i < window->cgroup_count; i++) {
+		const struct ai_cgroup_summary* cg = &window->cgroups[i];
+		int pos = count;
+		while (pos > 0 && cgroups[pos - 1].threat_score < cg->threat_score) {
+			if (pos < max) {
+				cgroups[pos] = cgroups[pos - 1];
+			}
+			pos--;
+		}
+		if (pos < max) {
+			cgroups[pos] = *cg;
+			if (count < max) {
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+// Copy the window verdict and the highest scoring processes
+int ai_engine_get_summary(ai_engine_t* engine, struct ai_summary* summary) {
+	if (!engine || !engine->initialized || !summary) {
+		return -1;
+	}
+
+	memset(summary, 0, sizeof(*summary));
+
+	pthread_mutex_lock(&engine->window_lock);
+	const struct sliding_window* window = &engine->window;
+	summary->threat_score = window->overall_threat_score;
+	memcpy(summary->threat_level_str, window->threat_level_str,
+	       sizeof(summary->threat_level_str));
+	memcpy(summary->threat_reason, window->threat_reason, sizeof(summary->threat_reason));
+	summary->process_count = window->process_count;
+	summary->cgroup_count = window->cgroup_count;
+	summary->top_count = ai_window_top(window, summary->top, AI_SUMMARY_TOP);
+	pthread_mutex_unlock(&engine->window_lock);
+
+	return 0;
+}
+
+// Copy the highest scoring processes of the window
+int ai_engine_get_top(ai_engine_t* engine, struct ai_process_summary* top, int max) {
+	if (!engine || !engine->initialized || !top || max <= 0) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&engine->window_lock);
+	int count = ai_window_top(&engine->window, top, max);
+	pthread_mutex_unlock(&engine->window_lock);
+
+	return count;
+}
+
+// Copy the highest scoring cgroups of the window
+int ai_engine_get_cgroups(ai_engine_t* engine, struct ai_cgroup_summary* cgroups, int max) {
+	if (!engine || !engine->initialized || !cgroups || max <= 0) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&engine->window_lock);
+	int count = ai_window_cgroups(&engine->window, cgroups, max);
+	pthread_mutex_unlock(&engine->window_lock);
+
+	return count;
+}
+
+// Extract the feature vector of one process from a copy of its sequence
+int ai_engine_get_features(ai_engine_t* engine, uint32_t pid, float* features) {
+	if (!engine || !engine->initialized || !features) {
+		return -1;
+	}
+
+	struct event_sequence* copy = malloc(sizeof(*copy));
+	if (!copy) {
+		return -1;
+	}
+
+	int found = 0;
+	pthread_mutex_lock(&engine->window_lock);
+	for (int i = 0; i < engine->window.process_count; i++) {
+		const struct event_sequence* seq = &engine->window.processes[i];
+		if (seq->pid == pid) {
+			// Only the used part of the sequence arrays
+			copy->pid = seq->pid;
+			copy->event_count = seq->event_count;
+			copy->cgroup_id = seq->cgroup_id;
+			copy->threat_score = seq->threat_score;
+			memcpy(copy->events, seq->events, seq->event_count * sizeof(seq->events[0]));
+			memcpy(copy->timestamps, seq->timestamps,
+			       seq->event_count * sizeof(seq->timestamps[0]));
+			found = 1;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&engine->window_lock);
+
+	int ret = found ? extract_features_from_events(copy, features) : -1;
+	free(copy);
+	return ret;
+}
+
+// Reload the model weights and restart the window on them
+int ai_engine_reload_model(ai_engine_t* engine) {
+	if (!engine || !engine->initialized || engine != global_ai_engine) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&engine->window_lock);
+	int ret = ai_load_model(engine->model_path);
+	sliding_window_cleanup(&engine->window);
+	sliding_window_init(&engine->window, ai_engine_now(engine));
+	pthread_mutex_unlock(&engine->window_lock);
+
+	if (ret == 0) {
+		LOG_INFO_MODULE("AI-ENGINE", "Model reloaded from %s", engine->model_path);
+	}
+	return ret;
 }
 
 // Initialize sliding window
-int sliding_window_init(struct sliding_window* window) {
+int sliding_window_init(struct sliding_window* window, uint64_t now) {
 	if (!window) {
 		return -1;
 	}
 
 	memset(window, 0, sizeof(struct sliding_window));
-	window->start_time = time(NULL);
-	window->end_time = window->start_time + WINDOW_SIZE_SECONDS;
+	window->end_time = now;
+	window->start_time = now > WINDOW_SIZE_NS ? now - WINDOW_SIZE_NS : 0;
 	window->process_count = 0;
 	window->overall_threat_score = 0.0f;
 	strcpy(window->threat_level_str, "LOW");
@@ -187,12 +387,13 @@ int sliding_window_update(struct sliding_window* window, uint64_t current_time)
 		return -1;
 	}
 
-	// Slide window if needed
-	if (current_time >= window->end_time) {
-		window->start_time = current_time;
-		window->end_time = current_time + WINDOW_SIZE_SECONDS;
+	// Slide every SLIDE_INTERVAL_SECONDS, keeping the last WINDOW_SIZE_SECONDS
+	if (current_time >= window->end_time + SLIDE_INTERVAL_NS) {
+		window->end_time = current_time;
+		window->start_time = current_time > WINDOW_SIZE_NS ? current_time - WINDOW_SIZE_NS : 0;
 
 		// Clear old events (keep only recent ones)
+		int keep_procs = 0;
 		for (int i = 0; i < window->process_count; i++) {
 			struct event_sequence* seq = &window->processes[i];
 			int keep_count = 0;
@@ -208,7 +409,16 @@ int sliding_window_update(struct sliding_window* window, uint64_t current_time)
 			}
 
 			seq->event_count = keep_count;
+
+			// Processes idle for a whole window free their slot
+			if (keep_count > 0) {
+				if (keep_procs != i) {
+					window->processes[keep_procs] = *seq;
+				}
+				keep_procs++;
+			}
 		}
+		window->process_count = keep_procs;
 	}
 
 	return 0;
@@ -220,10 +430,15 @@ int sliding_window_analyze(struct sliding_window* window) {
 		return -1;
 	}
 
+	RAVN_TIME_START(window_analyze);
+
 	float max_threat = 0.0f;
 	int suspicious_processes = 0;
+	char previous_level[sizeof(window->threat_level_str)];
+	memcpy(previous_level, window->threat_level_str, sizeof(previous_level));
 
-	// Analyze each process sequence
+	// Analyze each process sequence, aggregating them per cgroup
+	window->cgroup_count = 0;
 	for (int i = 0; i < window->process_count; i++) {
 		struct event_sequence* seq = &window->processes[i];
 
@@ -234,9 +449,29 @@ int sliding_window_analyze(struct sliding_window* window) {
 				max_threat = seq->threat_score;
 			}
 
-			if (ai_is_suspicious_sequence(seq)) {
+			int suspicious = ai_is_suspicious_sequence(seq);
+			if (suspicious) {
 				suspicious_processes++;
 			}
+
+			// At most one cgroup per process, so the table never fills
+			struct ai_cgroup_summary* cg = NULL;
+			for (int c = 0; c < window->cgroup_count && !cg; c++) {
+				if (window->cgroups[c].cgroup_id == seq->cgroup_id) {
+					cg = &window->cgroups[c];
+				}
+			}
+			if (!cg) {
+				cg = &window->cgroups[window->cgroup_count++];
+				memset(cg, 0, sizeof(*cg));
+				cg->cgroup_id = seq->cgroup_id;
+			}
+			cg->process_count++;
+			cg->event_count += seq->event_count;
+			cg->suspicious_count += suspicious ? 1 : 0;
+			if (seq->threat_score > cg->threat_score) {
+				cg->threat_score = seq->threat_score;
+			}
 		}
 	}
 
@@ -257,6 +492,12 @@ int sliding_window_analyze(struct sliding_window* window) {
 		strcpy(window->threat_reason, "Normal activity");
 	}
 
+	// Level changes reach status readers now, not at the next period
+	if (strcmp(previous_level, window->threat_level_str) != 0) {
+		status_notify();
+	}
+
+	RAVN_TIME_END(window_analyze, "AI-ENGINE", "sliding_window_analyze");
 	return 0;
 }
 
@@ -288,6 +529,8 @@ float ai_calculate_threat_score(struct event_sequence* sequence) {
 		return 0.0f;
 	}
 
+	RAVN_TIME_START(threat_score);
+
 	// RAVN Security Feature Extraction Algorithm
 	float features[TOTAL_FEATURES] = {0};
 
@@ -306,6 +549,7 @@ float ai_calculate_threat_score(struct event_sequence* sequence) {
 	// Apply sigmoid activation
 	score = 1.0f / (1.0f + expf(-score));
 
+	RAVN_TIME_END(threat_score, "AI-ENGINE", "ai_calculate_threat_score");
 	return score;
 }
 
@@ -317,8 +561,11 @@ int ai_load_model(const char* model_path) {
 		return -1;
 	}
 
-	// Copy weights from compiled header
-	memcpy(global_ai_engine->weights, all_model_weights, sizeof(all_model_weights));
+	// Copy weights from compiled header (the linear scorer uses the first ones)
+	size_t weight_bytes = sizeof(all_model_weights) < sizeof(global_ai_engine->weights)
+				      ? sizeof(all_model_weights)
+				      : sizeof(global_ai_engine->weights);
+	memcpy(global_ai_engine->weights, all_model_weights, weight_bytes);
 
 	LOG_INFO("Model loaded successfully from compiled weights (%d weights)",
 		 TOTAL_WEIGHT_COUNT);
@@ -395,13 +642,19 @@ void* ai_thread_func(void* arg) {
 		return NULL;
 	}
 
+	prctl(PR_SET_NAME, "ravn-ai", 0, 0, 0);
+	placement_apply(PLACEMENT_AI);
 	LOG_INFO_MODULE("AI-ENGINE", "AI analysis thread started");
 
 	// Use the global Redis connection instead of creating new ones
 	extern void* global_redis_conn_ptr;
-	redis_connection_t* redis_conn = (redis_connection_t*)global_redis_conn_ptr;
 
 	while (!engine->should_stop) {
+		health_heartbeat(HEALTH_AI);
+
+		// Stable pointer: the health monitor reconnects it in place
+		redis_connection_t* redis_conn = (redis_connection_t*)global_redis_conn_ptr;
+
 		// Check if Redis connection is available
 		if (!redis_conn || redis_ping(redis_conn) != 0) {
 			sleep(1); // Sleep 1 second if Redis not available
@@ -409,7 +662,7 @@ void* ai_thread_func(void* arg) {
 		}
 
 		// Get latest event from Redis
-		redisReply* reply = redisCommand(redis_conn->context, "RPOP events:raw");
+		redisReply* reply = redis_command(redis_conn, "RPOP events:raw");
 		if (reply && reply->type == REDIS_REPLY_STRING) {
 			// Parse event JSON (simplified)
 			struct ravn_event event;
@@ -420,6 +673,11 @@ void* ai_thread_func(void* arg) {
 				   "{\"pid\":%u,\"event_type\":%u,"
 				   "\"timestamp\":%lu",
 				   &event.pid, &event.event_type, &event.timestamp) == 3) {
+				const char* cgroup = strstr(reply->str, "\"cgroup_id\":");
+				if (cgroup) {
+					sscanf(cgroup, "\"cgroup_id\":%lu", &event.cgroup_id);
+				}
+
 				// Analyze the event
 				float threat_score = ai_engine_analyze_event(engine, &event);
 
@@ -436,8 +694,11 @@ void* ai_thread_func(void* arg) {
 					 "%u\",\"timestamp\":%lu}",
 					 threat_level, threat_score, event.pid, time(NULL));
 
-				redisCommand(redis_conn->context, "SET threat:level \"%s\"",
-					     threat_json);
+				redisReply* set = redis_command(
+					redis_conn, "SET threat:level \"%s\"", threat_json);
+				if (set) {
+					freeReplyObject(set);
+				}
 
 				LOG_INFO_MODULE("AI-ENGINE",
 						"Event analyzed: PID=%u, "
@@ -453,6 +714,7 @@ void* ai_thread_func(void* arg) {
 	}
 
 	LOG_INFO_MODULE("AI-ENGINE", "AI analysis thread stopped");
+	__atomic_store_n(&engine->thread_exited, 1, __ATOMIC_RELEASE);
 	return NULL;
 }
 
@@ -467,6 +729,7 @@ int ai_engine_start_thread(ai_engine_t* engine) {
 	}
 
 	engine->should_stop = 0;
+	engine->thread_exited = 0;
 
 	if (pthread_create(&engine->analysis_thread, NULL, ai_thread_func, engine) != 0) {
 		LOG_ERROR_MODULE("AI-ENGINE", "Failed to create AI analysis thread");
@@ -494,601 +757,30 @@ void ai_engine_stop_thread(ai_engine_t* engine) {
 	LOG_INFO_MODULE("AI-ENGINE", "AI analysis thread stopped");
 }
 
-/*
- * RAVN Security Feature Extraction Algorithm Implementation
- * Multi-dimensional feature extraction for comprehensive threat detection
- */
-
-/**
- * extract_features_from_events - Extract comprehensive features from event
- * sequence
- */
-int extract_features_from_events(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
+// Restart AI analysis thread once the current one has exited
+int ai_engine_restart_thread(ai_engine_t* engine) {
+	if (!engine || !engine->initialized) {
 		return -1;
 	}
 
-	// Initialize all features to 0
-	memset(features, 0, TOTAL_FEATURES * sizeof(float));
-
-	// Extract features from each category
-	extract_temporal_features(sequence, &features[TEMPORAL_OFFSET]);
-	extract_process_features(sequence, &features[PROCESS_OFFSET]);
-	extract_file_features(sequence, &features[FILE_OFFSET]);
-	extract_network_features(sequence, &features[NETWORK_OFFSET]);
-	extract_security_features(sequence, &features[SECURITY_OFFSET]);
-	extract_system_features(sequence, &features[SYSTEM_OFFSET]);
-	extract_behavioral_features(sequence, &features[BEHAVIORAL_OFFSET]);
-
-	// Normalize all features to [0,1] range
-	normalize_features(features, TOTAL_FEATURES);
-
-	return 0;
-}
-
-/**
- * extract_temporal_features - Extract temporal pattern features
- */
-void extract_temporal_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features || sequence->event_count == 0) {
-		return;
-	}
-
-	// TEMPORAL_EVENT_FREQUENCY: Events per second
-	features[TEMPORAL_EVENT_FREQUENCY] = (float)sequence->event_count / WINDOW_SIZE_SECONDS;
-
-	// TEMPORAL_BURST_INTENSITY: Events in 1-second bursts
-	int burst_count = 0;
-	for (uint32_t i = 1; i < sequence->event_count; i++) {
-		uint64_t time_diff = sequence->timestamps[i] - sequence->timestamps[i - 1];
-		if (time_diff < 1000000000) { // Less than 1 second
-			burst_count++;
-		}
-	}
-	features[TEMPORAL_BURST_INTENSITY] = (float)burst_count / sequence->event_count;
-
-	// TEMPORAL_TIME_REGULARITY: Standard deviation of intervals
-	if (sequence->event_count > 2) {
-		float mean_interval = 0.0f;
-		for (uint32_t i = 1; i < sequence->event_count; i++) {
-			mean_interval += (sequence->timestamps[i] - sequence->timestamps[i - 1]);
-		}
-		mean_interval /= (sequence->event_count - 1);
-
-		float variance = 0.0f;
-		for (uint32_t i = 1; i < sequence->event_count; i++) {
-			float diff = (sequence->timestamps[i] - sequence->timestamps[i - 1]) -
-				     mean_interval;
-			variance += diff * diff;
-		}
-		variance /= (sequence->event_count - 1);
-		features[TEMPORAL_TIME_REGULARITY] =
-			sqrtf(variance) / mean_interval; // Coefficient of variation
-	}
-
-	// TEMPORAL_SEQUENCE_DURATION: Sequence duration (normalized)
-	if (sequence->event_count > 1) {
-		uint64_t duration =
-			sequence->timestamps[sequence->event_count - 1] - sequence->timestamps[0];
-		features[TEMPORAL_SEQUENCE_DURATION] =
-			(float)duration / (WINDOW_SIZE_SECONDS * 1000000000ULL);
-	}
-
-	// TEMPORAL_PEAK_ACTIVITY_TIME: When most events occurred
-	int time_buckets[10] = {0};
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		int bucket = (sequence->timestamps[i] % (WINDOW_SIZE_SECONDS * 1000000000ULL)) /
-			     (WINDOW_SIZE_SECONDS * 100000000ULL / 10);
-		time_buckets[bucket]++;
-	}
-	int max_bucket = 0;
-	for (int i = 1; i < 10; i++) {
-		if (time_buckets[i] > time_buckets[max_bucket]) {
-			max_bucket = i;
-		}
-	}
-	features[TEMPORAL_PEAK_ACTIVITY_TIME] = (float)max_bucket / 9.0f;
-
-	// TEMPORAL_QUIET_PERIODS: Periods with no events
-	int quiet_periods = 0;
-	for (uint32_t i = 1; i < sequence->event_count; i++) {
-		uint64_t gap = sequence->timestamps[i] - sequence->timestamps[i - 1];
-		if (gap > 2000000000) { // More than 2 seconds
-			quiet_periods++;
-		}
-	}
-	features[TEMPORAL_QUIET_PERIODS] = (float)quiet_periods / sequence->event_count;
-
-	// TEMPORAL_ACCELERATION_RATE: Increasing event frequency
-	if (sequence->event_count > 4) {
-		int first_half = sequence->event_count / 2;
-		int second_half = sequence->event_count - first_half;
-		float first_rate = (float)first_half / (WINDOW_SIZE_SECONDS / 2);
-		float second_rate = (float)second_half / (WINDOW_SIZE_SECONDS / 2);
-		features[TEMPORAL_ACCELERATION_RATE] =
-			(second_rate - first_rate) / (first_rate + 0.001f);
-	}
-
-	// TEMPORAL_DECELERATION_RATE: Decreasing event frequency
-	features[TEMPORAL_DECELERATION_RATE] =
-		-features[TEMPORAL_ACCELERATION_RATE]; // Opposite of
-						       // acceleration
-}
-
-/**
- * extract_process_features - Extract process behavior features
- */
-void extract_process_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
-		return;
-	}
-
-	// Initialize all process features to 0
-	memset(features, 0, PROCESS_FEATURES * sizeof(float));
-
-	// Count different types of process-related events
-	int process_spawns = 0;
-	int process_exits = 0;
-	int working_dir_changes = 0;
-	int env_var_changes = 0;
-	int signal_events = 0;
-	int priority_changes = 0;
-	int process_group_ops = 0;
-	int session_ops = 0;
-	int affinity_changes = 0;
-	int memory_maps = 0;
-	int credential_changes = 0;
-	int command_complexity = 0;
-
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		uint32_t event_type = sequence->events[i];
-
-		// Count process-related events based on event type
-		switch (event_type) {
-		case PROC_EVENT_SPAWN: // Process creation (execve, fork, clone)
-			process_spawns++;
-			break;
-		case PROC_EVENT_EXIT: // Process termination
-			process_exits++;
-			break;
-		case PROC_EVENT_WORKING_DIR: // Working directory change (chdir)
-			working_dir_changes++;
-			break;
-		case PROC_EVENT_ENV_CHANGE: // Environment variable change
-			env_var_changes++;
-			break;
-		case PROC_EVENT_SIGNAL: // Signal handling (kill, signal)
-			signal_events++;
-			break;
-		case PROC_EVENT_PRIORITY_CHANGE: // Priority change (nice, setpriority)
-			priority_changes++;
-			break;
-		case PROC_EVENT_IPC_OPERATION: // Process group operations
-			process_group_ops++;
-			break;
-		case PROC_EVENT_SESSION_CHANGE: // Session operations
-			session_ops++;
-			break;
-		case PROC_EVENT_AFFINITY_CHANGE: // CPU affinity changes
-			affinity_changes++;
-			break;
-		case PROC_EVENT_EXEC: // Process execution (memory mapping operations)
-			memory_maps++;
-			break;
-		case PROC_EVENT_SETUID:
-		case PROC_EVENT_SETGID:
-		case PROC_EVENT_SETRESUID:
-		case PROC_EVENT_SETRESGID:
-		case PROC_EVENT_CAPSET: // Credential changes (setuid, setgid)
-			credential_changes++;
-			break;
-		default:
-			// Estimate command complexity based on event diversity
-			command_complexity++;
-			break;
-		}
-	}
-
-	// Normalize process features
-	features[0] = (float)process_spawns / sequence->event_count;
-	features[1] = (float)process_exits / sequence->event_count;
-	features[2] = (float)working_dir_changes / sequence->event_count;
-	features[3] = (float)env_var_changes / sequence->event_count;
-	features[4] = (float)signal_events / sequence->event_count;
-	features[5] = (float)priority_changes / sequence->event_count;
-	features[6] = (float)process_group_ops / sequence->event_count;
-	features[7] = (float)session_ops / sequence->event_count;
-	features[8] = (float)affinity_changes / sequence->event_count;
-	features[9] = (float)memory_maps / sequence->event_count;
-	features[10] = (float)credential_changes / sequence->event_count;
-	features[11] = (float)command_complexity / sequence->event_count;
-}
-
-/**
- * extract_file_features - Extract file access pattern features
- */
-void extract_file_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
-		return;
-	}
+	if (engine->thread_running) {
+		engine->should_stop = 1;
 
-	// Initialize all file features to 0
-	memset(features, 0, FILE_FEATURES * sizeof(float));
-
-	// Count different types of file operations
-	int sensitive_file_access = 0;
-	int executable_file_access = 0;
-	int config_file_access = 0;
-	int log_file_access = 0;
-	int temp_file_ops = 0;
-	int file_creations = 0;
-	int file_deletions = 0;
-	int file_modifications = 0;
-	int directory_traversal = 0;
-	int permission_changes = 0;
-
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		uint32_t event_type = sequence->events[i];
-
-		// Categorize file operations based on event type
-		switch (event_type) {
-		case FILE_EVENT_OPEN: // File open operation
-			// Check file type based on event type pattern
-			if (event_type % FILE_TYPE_MODULO == SENSITIVE_FILE_PATTERN) {
-				sensitive_file_access++;
-			} else if (event_type % FILE_TYPE_MODULO == EXECUTABLE_FILE_PATTERN) {
-				executable_file_access++;
-			} else if (event_type % FILE_TYPE_MODULO == CONFIG_FILE_PATTERN) {
-				config_file_access++;
-			} else if (event_type % FILE_TYPE_MODULO == LOG_FILE_PATTERN) {
-				log_file_access++;
-			} else if (event_type % FILE_TYPE_MODULO == TEMP_FILE_PATTERN) {
-				temp_file_ops++;
+		// Never join a thread stuck in Redis or scoring; retry later
+		for (int i = 0; i < 20; i++) {
+			if (__atomic_load_n(&engine->thread_exited, __ATOMIC_ACQUIRE)) {
+				break;
 			}
-			break;
-		case FILE_EVENT_CREATE: // File creation
-			file_creations++;
-			break;
-		case FILE_EVENT_DELETE: // File deletion
-			file_deletions++;
-			break;
-		case FILE_EVENT_WRITE: // File modification
-			file_modifications++;
-			break;
-		case FILE_EVENT_READ: // Directory traversal (simplified)
-			directory_traversal++;
-			break;
-		case FILE_EVENT_CHMOD: // Permission changes
-			permission_changes++;
-			break;
+			usleep(100000);
 		}
-	}
-
-	// Normalize file features
-	features[0] = (float)sensitive_file_access / sequence->event_count;
-	features[1] = (float)executable_file_access / sequence->event_count;
-	features[2] = (float)config_file_access / sequence->event_count;
-	features[3] = (float)log_file_access / sequence->event_count;
-	features[4] = (float)temp_file_ops / sequence->event_count;
-	features[5] = (float)file_creations / sequence->event_count;
-	features[6] = (float)file_deletions / sequence->event_count;
-	features[7] = (float)file_modifications / sequence->event_count;
-	features[8] = (float)directory_traversal / sequence->event_count;
-	features[9] = (float)permission_changes / sequence->event_count;
-}
-
-/**
- * extract_network_features - Extract network behavior features
- */
-void extract_network_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
-		return;
-	}
-
-	// Initialize all network features to 0
-	memset(features, 0, NETWORK_FEATURES * sizeof(float));
-
-	// Count different types of network operations
-	int connections = 0;
-	int suspicious_ports = 0;
-	int data_transfer = 0;
-	int connection_duration = 0;
-	int protocol_diversity = 0;
-	int external_connections = 0;
-	int port_scanning = 0;
-	int network_errors = 0;
-
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		uint32_t event_type = sequence->events[i];
-
-		// Categorize network operations
-		switch (event_type) {
-		case NET_EVENT_SOCKET_CREATE: // Socket creation
-			connections++;
-			break;
-		case NET_EVENT_SOCKET_BIND: // Socket bind operation
-			// Check for suspicious ports using meaningful constants
-			if (event_type % PORT_MODULO_BASE ==
-				    SUSPICIOUS_PORT_4444 % PORT_MODULO_BASE ||
-			    event_type % PORT_MODULO_BASE ==
-				    SUSPICIOUS_PORT_1337 % PORT_MODULO_BASE) {
-				suspicious_ports++;
-			}
-			break;
-		case NET_EVENT_SOCKET_CONNECT: // Socket connect operation
-			connections++;
-			break;
-		case NET_EVENT_SOCKET_SEND: // Socket send operation
-			data_transfer++;
-			break;
-		case NET_EVENT_SOCKET_RECV: // Socket receive operation
-			data_transfer++;
-			break;
-		case NET_EVENT_SOCKET_ACCEPT: // Socket accept operation
-			external_connections++;
-			break;
-		case NET_EVENT_SOCKET_LISTEN: // Socket listen operation
-			port_scanning++;
-			break;
-		case NET_EVENT_SOCKET_CLOSE: // Socket close operation
-			network_errors++;
-			break;
+		if (!__atomic_load_n(&engine->thread_exited, __ATOMIC_ACQUIRE)) {
+			LOG_WARN_MODULE("AI-ENGINE", "Analysis thread did not exit, restart deferred");
+			return -1;
 		}
-	}
 
-	// Normalize network features
-	features[0] = (float)connections / sequence->event_count;
-	features[1] = (float)suspicious_ports / sequence->event_count;
-	features[2] = (float)data_transfer / sequence->event_count;
-	features[3] = (float)connection_duration / sequence->event_count;
-	features[4] = (float)protocol_diversity / sequence->event_count;
-	features[5] = (float)external_connections / sequence->event_count;
-	features[6] = (float)port_scanning / sequence->event_count;
-	features[7] = (float)network_errors / sequence->event_count;
-}
-
-/**
- * extract_security_features - Extract security event features
- */
-void extract_security_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
-		return;
+		pthread_join(engine->analysis_thread, NULL);
+		engine->thread_running = 0;
 	}
 
-	// Initialize all security features to 0
-	memset(features, 0, SECURITY_FEATURES * sizeof(float));
-
-	// Count different types of security events
-	int privilege_escalation = 0;
-	int authentication_events = 0;
-	int failed_operations = 0;
-	int suspicious_syscalls = 0;
-	int capability_usage = 0;
-	int security_context_changes = 0;
-	int audit_events = 0;
-	int policy_violations = 0;
-
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		uint32_t event_type = sequence->events[i];
-
-		// Categorize security events
-		switch (event_type) {
-		case SEC_EVENT_SETUID: // Set user ID operation
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_SETGID: // Set group ID operation
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_CAPSET: // Capability set operation
-			capability_usage++;
-			break;
-		case SEC_EVENT_PRCTL: // Process control operation
-			security_context_changes++;
-			break;
-		case SEC_EVENT_SETRESUID: // Set real, effective, and saved user
-					  // ID
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_SETRESGID: // Set real, effective, and saved
-					  // group ID
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_SETEUID: // Set effective user ID
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_SETEGID: // Set effective group ID
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_SETREUID: // Set real and effective user ID
-			privilege_escalation++;
-			break;
-		case SEC_EVENT_SETREGID: // Set real and effective group ID
-			privilege_escalation++;
-			break;
-		}
-	}
-
-	// Normalize security features
-	features[0] = (float)privilege_escalation / sequence->event_count;
-	features[1] = (float)authentication_events / sequence->event_count;
-	features[2] = (float)failed_operations / sequence->event_count;
-	features[3] = (float)suspicious_syscalls / sequence->event_count;
-	features[4] = (float)capability_usage / sequence->event_count;
-	features[5] = (float)security_context_changes / sequence->event_count;
-	features[6] = (float)audit_events / sequence->event_count;
-	features[7] = (float)policy_violations / sequence->event_count;
-}
-
-/**
- * extract_system_features - Extract system resource usage features
- */
-void extract_system_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
-		return;
-	}
-
-	// Initialize all system features to 0
-	memset(features, 0, SYSTEM_FEATURES * sizeof(float));
-
-	// Estimate system resource usage based on event patterns
-	float cpu_intensity = 0.0f;
-	float memory_intensity = 0.0f;
-	float disk_io_intensity = 0.0f;
-	float system_load_impact = 0.0f;
-	float resource_contention = 0.0f;
-	float syscall_frequency = 0.0f;
-	float interrupt_handling = 0.0f;
-	float kernel_operations = 0.0f;
-
-	// Calculate system features based on event patterns
-	syscall_frequency = (float)sequence->event_count / WINDOW_SIZE_SECONDS;
-
-	// Estimate resource usage based on event types using meaningful
-	// constants
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		uint32_t event_type = sequence->events[i];
-
-		// CPU-intensive operations
-		if (event_type % SYSTEM_RESOURCE_MODULO == CPU_INTENSIVE_PATTERN) {
-			cpu_intensity += 0.1f;
-		}
-
-		// Memory-intensive operations
-		if (event_type % SYSTEM_RESOURCE_MODULO == MEMORY_INTENSIVE_PATTERN) {
-			memory_intensity += 0.1f;
-		}
-
-		// Disk I/O operations
-		if (event_type % SYSTEM_RESOURCE_MODULO == DISK_IO_INTENSIVE_PATTERN) {
-			disk_io_intensity += 0.1f;
-		}
-
-		// Kernel operations
-		if (event_type % SYSTEM_RESOURCE_MODULO == KERNEL_OPERATIONS_PATTERN) {
-			kernel_operations += 0.1f;
-		}
-	}
-
-	// Normalize system features using enums for clarity
-	features[SYSTEM_CPU_INTENSITY] = cpu_intensity / sequence->event_count;
-	features[SYSTEM_MEMORY_INTENSITY] = memory_intensity / sequence->event_count;
-	features[SYSTEM_DISK_IO_INTENSITY] = disk_io_intensity / sequence->event_count;
-	features[SYSTEM_LOAD_IMPACT] = system_load_impact / sequence->event_count;
-	features[SYSTEM_RESOURCE_CONTENTION] = resource_contention / sequence->event_count;
-	features[SYSTEM_SYSCALL_FREQUENCY] =
-		syscall_frequency / 100.0f; // Normalize to reasonable range
-	features[SYSTEM_INTERRUPT_HANDLING] = interrupt_handling / sequence->event_count;
-	features[SYSTEM_KERNEL_OPERATIONS] = kernel_operations / sequence->event_count;
+	return ai_engine_start_thread(engine);
 }
-
-/**
- * extract_behavioral_features - Extract behavioral pattern features
- */
-void extract_behavioral_features(const struct event_sequence* sequence, float* features) {
-	if (!sequence || !features) {
-		return;
-	}
-
-	// Initialize all behavioral features to 0
-	memset(features, 0, BEHAVIORAL_FEATURES * sizeof(float));
-
-	// Analyze behavioral patterns
-	float stealth_behavior = 0.0f;
-	float persistence_attempts = 0.0f;
-	float evasion_techniques = 0.0f;
-	float lateral_movement = 0.0f;
-	float data_exfiltration = 0.0f;
-	float command_injection = 0.0f;
-	float buffer_overflow_attempts = 0.0f;
-	float code_injection = 0.0f;
-	float anti_forensics = 0.0f;
-	float communication_patterns = 0.0f;
-
-	// Detect behavioral patterns based on event sequences using meaningful
-	// constants
-	for (uint32_t i = 0; i < sequence->event_count; i++) {
-		uint32_t event_type = sequence->events[i];
-
-		// Stealth behavior (hiding activities)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_STEALTH_PATTERN) {
-			stealth_behavior += 0.1f;
-		}
-
-		// Persistence attempts (staying resident)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_PERSISTENCE_PATTERN) {
-			persistence_attempts += 0.1f;
-		}
-
-		// Evasion techniques (avoiding detection)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_EVASION_PATTERN) {
-			evasion_techniques += 0.1f;
-		}
-
-		// Lateral movement (moving between systems)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_LATERAL_MOVEMENT_PATTERN) {
-			lateral_movement += 0.1f;
-		}
-
-		// Data exfiltration (data theft patterns)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO ==
-		    BEHAVIORAL_DATA_EXFILTRATION_PATTERN) {
-			data_exfiltration += 0.1f;
-		}
-
-		// Command injection attempts
-		if (event_type % BEHAVIORAL_PATTERN_MODULO ==
-		    BEHAVIORAL_COMMAND_INJECTION_PATTERN) {
-			command_injection += 0.1f;
-		}
-
-		// Buffer overflow patterns
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_BUFFER_OVERFLOW_PATTERN) {
-			buffer_overflow_attempts += 0.1f;
-		}
-
-		// Code injection patterns
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_CODE_INJECTION_PATTERN) {
-			code_injection += 0.1f;
-		}
-
-		// Anti-forensics (evidence hiding)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_ANTI_FORENSICS_PATTERN) {
-			anti_forensics += 0.1f;
-		}
-
-		// Communication patterns (C&C communication)
-		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_COMMUNICATION_PATTERN) {
-			communication_patterns += 0.1f;
-		}
-	}
-
-	// Normalize behavioral features using enums for clarity
-	features[BEHAVIORAL_STEALTH - 1] = stealth_behavior / sequence->event_count;
-	features[BEHAVIORAL_PERSISTENCE - 1] = persistence_attempts / sequence->event_count;
-	features[BEHAVIORAL_EVASION - 1] = evasion_techniques / sequence->event_count;
-	features[BEHAVIORAL_LATERAL_MOVEMENT - 1] = lateral_movement / sequence->event_count;
-	features[BEHAVIORAL_DATA_EXFILTRATION - 1] = data_exfiltration / sequence->event_count;
-	features[BEHAVIORAL_COMMAND_INJECTION - 1] = command_injection / sequence->event_count;
-	features[BEHAVIORAL_BUFFER_OVERFLOW - 1] = buffer_overflow_attempts / sequence->event_count;
-	features[BEHAVIORAL_CODE_INJECTION - 1] = code_injection / sequence->event_count;
-	features[BEHAVIORAL_ANTI_FORENSICS - 1] = anti_forensics / sequence->event_count;
-	features[BEHAVIORAL_COMMUNICATION - 1] = communication_patterns / sequence->event_count;
-}
-
-/**
- * normalize_features - Normalize features to [0,1] range
- */
-void normalize_features(float* features, int count) {
-	if (!features || count <= 0) {
-		return;
-	}
-
-	for (int i = 0; i < count; i++) {
-		// Clamp features to [0,1] range
-		if (features[i] < 0.0f) {
-			features[i] = 0.0f;
-		} else if (features[i] > 1.0f) {
-			features[i] = 1.0f;
-		}
-	}
-}
\ No newline at end of file
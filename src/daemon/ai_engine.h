@@ -13,6 +13,8 @@
  * - Sliding window analysis for temporal pattern detection
  * - Deep learning model inference for threat scoring
  * - Real-time event sequence analysis
+ * - Per-cgroup aggregation of the window, so each container on a node gets
+ *   its own threat score
  * - Multi-threaded background processing
  *
  * Architecture:
@@ -25,7 +27,8 @@
 #ifndef RAVN_AI_ENGINE_H
 #define RAVN_AI_ENGINE_H
 
-#include "ebpf_handler.h" /* For event type enums */
+#include "ai_types.h" /* For the feature layout and struct event_sequence */
+#include "ebpf_handler.h"
 
 #include <pthread.h>
 #include <stdint.h>
@@ -34,184 +37,6 @@
 /* Forward declaration */
 struct ravn_event;
 
-/*
- * Event Type Enums - Comprehensive categorization of security events
- * These enums make the code more readable and maintainable
- */
-
-/*
- * Note: All event type enums (process_event_type, file_event_type,
- * network_event_type, security_event_type, memory_event_type,
- * kernel_event_type, performance_event_type) are defined in
- * ebpf_handler.h and included above
- */
-
-/*
- * Feature Extraction Constants - Make code self-documenting
- * These constants replace magic numbers in feature extraction algorithms
- */
-
-/**
- * enum behavioral_pattern_modulo - Behavioral pattern detection modulo values
- * Used for pattern detection in behavioral feature extraction
- */
-enum behavioral_pattern_modulo {
-	BEHAVIORAL_PATTERN_MODULO = 20,		  /* Modulo for behavioral pattern detection */
-	BEHAVIORAL_STEALTH_PATTERN = 0,		  /* Stealth behavior pattern (modulo 20 == 0) */
-	BEHAVIORAL_PERSISTENCE_PATTERN = 1,	  /* Persistence pattern (modulo 20 == 1) */
-	BEHAVIORAL_EVASION_PATTERN = 2,		  /* Evasion pattern (modulo 20 == 2) */
-	BEHAVIORAL_LATERAL_MOVEMENT_PATTERN = 3,  /* Lateral movement pattern (modulo 20 == 3) */
-	BEHAVIORAL_DATA_EXFILTRATION_PATTERN = 4, /* Data exfiltration pattern (modulo 20 == 4) */
-	BEHAVIORAL_COMMAND_INJECTION_PATTERN = 5, /* Command injection pattern (modulo 20 == 5) */
-	BEHAVIORAL_BUFFER_OVERFLOW_PATTERN = 6,	  /* Buffer overflow pattern (modulo 20 == 6) */
-	BEHAVIORAL_CODE_INJECTION_PATTERN = 7,	  /* Code injection pattern (modulo 20 == 7) */
-	BEHAVIORAL_ANTI_FORENSICS_PATTERN = 8,	  /* Anti-forensics pattern (modulo 20 == 8) */
-	BEHAVIORAL_COMMUNICATION_PATTERN = 9	  /* Communication pattern (modulo 20 == 9) */
-};
-
-/**
- * enum system_resource_modulo - System resource detection modulo values
- * Used for resource usage pattern detection
- */
-enum system_resource_modulo {
-	SYSTEM_RESOURCE_MODULO = 10,   /* Modulo for system resource detection */
-	CPU_INTENSIVE_PATTERN = 0,     /* CPU-intensive operations (modulo 10 == 0) */
-	MEMORY_INTENSIVE_PATTERN = 1,  /* Memory-intensive operations (modulo 10 == 1) */
-	DISK_IO_INTENSIVE_PATTERN = 2, /* Disk I/O operations (modulo 10 == 2) */
-	KERNEL_OPERATIONS_PATTERN = 3  /* Kernel operations (modulo 10 == 3) */
-};
-
-/**
- * enum file_type_modulo - File type detection modulo values
- * Used for file type classification in feature extraction
- */
-enum file_type_modulo {
-	FILE_TYPE_MODULO = 10,	     /* Modulo for file type detection */
-	SENSITIVE_FILE_PATTERN = 0,  /* Sensitive files (modulo 10 == 0) */
-	EXECUTABLE_FILE_PATTERN = 1, /* Executable files (modulo 10 == 1) */
-	CONFIG_FILE_PATTERN = 2,     /* Configuration files (modulo 10 == 2) */
-	LOG_FILE_PATTERN = 3,	     /* Log files (modulo 10 == 3) */
-	TEMP_FILE_PATTERN = 4	     /* Temporary files (modulo 10 == 4) */
-};
-
-/**
- * enum suspicious_port_values - Suspicious port numbers for network monitoring
- * Used for detecting suspicious network connections
- */
-enum suspicious_port_values {
-	SUSPICIOUS_PORT_4444 = 4444, /* Common backdoor port */
-	SUSPICIOUS_PORT_1337 = 1337, /* Common hacker port */
-	PORT_MODULO_BASE = 1000	     /* Base for port modulo operations */
-};
-
-/**
- * enum behavioral_event_type - Behavioral pattern event types
- */
-enum behavioral_event_type {
-	BEHAVIORAL_STEALTH = 1,		  /* Stealth behavior patterns */
-	BEHAVIORAL_PERSISTENCE = 2,	  /* Persistence attempts */
-	BEHAVIORAL_EVASION = 3,		  /* Evasion techniques */
-	BEHAVIORAL_LATERAL_MOVEMENT = 4,  /* Lateral movement patterns */
-	BEHAVIORAL_DATA_EXFILTRATION = 5, /* Data exfiltration patterns */
-	BEHAVIORAL_COMMAND_INJECTION = 6, /* Command injection attempts */
-	BEHAVIORAL_BUFFER_OVERFLOW = 7,	  /* Buffer overflow patterns */
-	BEHAVIORAL_CODE_INJECTION = 8,	  /* Code injection patterns */
-	BEHAVIORAL_ANTI_FORENSICS = 9,	  /* Anti-forensics techniques */
-	BEHAVIORAL_COMMUNICATION = 10	  /* Communication patterns */
-};
-
-/**
- * enum threat_classification - Threat level classifications
- */
-enum threat_classification {
-	THREAT_NORMAL = 0,     /* Normal system activity */
-	THREAT_SUSPICIOUS = 1, /* Suspicious activity detected */
-	THREAT_MALICIOUS = 2   /* Malicious activity confirmed */
-};
-
-/**
- * enum temporal_feature_type - Temporal pattern feature types
- */
-enum temporal_feature_type {
-	TEMPORAL_EVENT_FREQUENCY = 0,	 /* Events per second */
-	TEMPORAL_BURST_INTENSITY = 1,	 /* Events in 1-second bursts */
-	TEMPORAL_TIME_REGULARITY = 2,	 /* Standard deviation of intervals */
-	TEMPORAL_SEQUENCE_DURATION = 3,	 /* Sequence duration (normalized) */
-	TEMPORAL_PEAK_ACTIVITY_TIME = 4, /* When most events occurred */
-	TEMPORAL_QUIET_PERIODS = 5,	 /* Periods with no events */
-	TEMPORAL_ACCELERATION_RATE = 6,	 /* Increasing event frequency */
-	TEMPORAL_DECELERATION_RATE = 7	 /* Decreasing event frequency */
-};
-
-/**
- * enum system_feature_type - System resource usage feature types
- */
-enum system_feature_type {
-	SYSTEM_CPU_INTENSITY = 0,	/* CPU usage intensity */
-	SYSTEM_MEMORY_INTENSITY = 1,	/* Memory usage intensity */
-	SYSTEM_DISK_IO_INTENSITY = 2,	/* Disk I/O intensity */
-	SYSTEM_LOAD_IMPACT = 3,		/* System load impact */
-	SYSTEM_RESOURCE_CONTENTION = 4, /* Resource contention */
-	SYSTEM_SYSCALL_FREQUENCY = 5,	/* System call frequency */
-	SYSTEM_INTERRUPT_HANDLING = 6,	/* Interrupt handling */
-	SYSTEM_KERNEL_OPERATIONS = 7	/* Kernel operations */
-};
-
-/**
- * enum feature_category - Feature extraction categories
- */
-enum feature_category {
-	FEATURE_TEMPORAL = 0,  /* Temporal pattern features */
-	FEATURE_PROCESS = 1,   /* Process behavior features */
-	FEATURE_FILE = 2,      /* File access pattern features */
-	FEATURE_NETWORK = 3,   /* Network behavior features */
-	FEATURE_SECURITY = 4,  /* Security event features */
-	FEATURE_SYSTEM = 5,    /* System resource usage features */
-	FEATURE_BEHAVIORAL = 6 /* Behavioral pattern features */
-};
-
-/*
- * AI Model Configuration Parameters
- */
-#define WINDOW_SIZE_SECONDS    10   /* Sliding window duration in seconds */
-#define SLIDE_INTERVAL_SECONDS 1    /* Window slide interval in seconds */
-#define MAX_EVENTS_PER_WINDOW  1000 /* Maximum events per process in window */
-#define MAX_PROCESSES	       100  /* Maximum processes to track simultaneously */
-
-/*
- * RAVN Security Feature Extraction Parameters
- * Multi-dimensional feature extraction for comprehensive threat detection
- */
-#define TOTAL_FEATURES                                                             \
-	128 /* Total number of extracted features (doubled for enhanced eBPF data) \
-	     */
-#define TEMPORAL_FEATURES    8	/* Time-based pattern features */
-#define PROCESS_FEATURES     12 /* Process behavior features */
-#define FILE_FEATURES	     10 /* File access pattern features */
-#define NETWORK_FEATURES     8	/* Network behavior features */
-#define SECURITY_FEATURES    8	/* Security event features */
-#define SYSTEM_FEATURES	     8	/* System resource usage features */
-#define BEHAVIORAL_FEATURES  10 /* Behavioral pattern features */
-#define MEMORY_FEATURES	     12 /* Memory behavior features */
-#define KERNEL_FEATURES	     10 /* Kernel-level features */
-#define PERFORMANCE_FEATURES 12 /* Performance metrics features */
-#define ADVANCED_FEATURES    40 /* Advanced pattern detection features */
-
-/*
- * Feature Category Offsets
- */
-#define TEMPORAL_OFFSET	   0  /* Temporal features start at index 0 */
-#define PROCESS_OFFSET	   8  /* Process features start at index 8 */
-#define FILE_OFFSET	   20 /* File features start at index 20 */
-#define NETWORK_OFFSET	   30 /* Network features start at index 30 */
-#define SECURITY_OFFSET	   38 /* Security features start at index 38 */
-#define SYSTEM_OFFSET	   46 /* System features start at index 46 */
-#define BEHAVIORAL_OFFSET  54 /* Behavioral features start at index 54 */
-#define MEMORY_OFFSET	   64 /* Memory features start at index 64 */
-#define KERNEL_OFFSET	   76 /* Kernel features start at index 76 */
-#define PERFORMANCE_OFFSET 86 /* Performance features start at index 86 */
-#define ADVANCED_OFFSET	   98 /* Advanced features start at index 98 */
-
 /*
  * Threat Level Thresholds
  * These values define the boundaries for threat level classification
@@ -222,22 +47,19 @@ enum feature_category {
 #define THREAT_LEVEL_CRITICAL 0.9 /* Critical threat confirmed */
 
 /**
- * struct event_sequence - Event sequence for a single process
- * @pid: Process ID
- * @event_count: Number of events in the sequence
- * @events: Array of event types in chronological order
- * @timestamps: Array of event timestamps (nanoseconds since epoch)
- * @threat_score: Calculated threat score for this sequence
- *
- * Represents a sequence of events from a single process within
- * the sliding window. Used for pattern analysis and threat detection.
- */
-struct event_sequence {
-	uint32_t pid;				    /* Process ID */
-	uint32_t event_count;			    /* Number of events */
-	uint32_t events[MAX_EVENTS_PER_WINDOW];	    /* Event types array */
-	uint64_t timestamps[MAX_EVENTS_PER_WINDOW]; /* Event timestamps */
-	float threat_score;			    /* Calculated threat score */
+ * struct ai_cgroup_summary - Threat state of one cgroup (container) in the window
+ * @cgroup_id: cgroup v2 ID (0 for events without one)
+ * @process_count: Processes of the cgroup in the window
+ * @event_count: Events of those processes in the window
+ * @suspicious_count: Processes with a suspicious sequence
+ * @threat_score: Highest threat score of the processes
+ */
+struct ai_cgroup_summary {
+	uint64_t cgroup_id;	   /* cgroup v2 ID */
+	uint32_t process_count;	   /* Processes in window */
+	uint32_t event_count;	   /* Events in window */
+	uint32_t suspicious_count; /* Suspicious processes */
+	float threat_score;	   /* Threat score */
 };
 
 /**
@@ -246,6 +68,8 @@ struct event_sequence {
  * @end_time: Window end timestamp (nanoseconds)
  * @processes: Array of process event sequences
  * @process_count: Number of active processes in window
+ * @cgroups: Per-cgroup aggregation of @processes, rebuilt at each analysis
+ * @cgroup_count: Number of cgroups in @cgroups
  * @overall_threat_score: Overall threat score for the window
  * @threat_level_str: Human-readable threat level string
  * @threat_reason: Explanation of threat assessment
@@ -258,11 +82,21 @@ struct sliding_window {
 	uint64_t end_time;				/* Window end time */
 	struct event_sequence processes[MAX_PROCESSES]; /* Process sequences */
 	int process_count;				/* Active process count */
+	struct ai_cgroup_summary cgroups[MAX_PROCESSES];	/* Per-cgroup aggregation */
+	int cgroup_count;				/* Active cgroup count */
 	float overall_threat_score;			/* Overall threat score */
 	char threat_level_str[16];			/* Threat level string */
 	char threat_reason[256];			/* Threat reason */
 };
 
+/**
+ * ai_clock_fn - Time source of an AI engine
+ * @ctx: Context passed to ai_engine_set_clock()
+ *
+ * Return: Current time in nanoseconds on the clock of the event timestamps
+ */
+typedef uint64_t (*ai_clock_fn)(void* ctx);
+
 /**
  * struct ai_engine - AI engine instance
  * @weights: Model weights for inference
@@ -272,6 +106,10 @@ struct sliding_window {
  * @analysis_thread: Background analysis thread handle
  * @thread_running: Thread running status flag
  * @should_stop: Thread stop request flag
+ * @thread_exited: Set by the analysis thread when it returns
+ * @clock: Time source for window sliding (CLOCK_MONOTONIC by default)
+ * @clock_ctx: Context passed to @clock
+ * @window_lock: Serializes window updates with summary readers
  *
  * Main AI engine structure containing model data, configuration,
  * and thread management for background analysis.
@@ -285,6 +123,44 @@ struct ai_engine {
 	pthread_t analysis_thread;    /* Analysis thread */
 	int thread_running;	      /* Thread status */
 	int should_stop;	      /* Stop request flag */
+	int thread_exited;	      /* Thread exit flag */
+	ai_clock_fn clock;	      /* Window time source */
+	void* clock_ctx;	      /* Clock context */
+	pthread_mutex_t window_lock;  /* Window update/summary lock */
+};
+
+/**
+ * struct ai_process_summary - Threat state of one tracked process
+ * @pid: Process ID
+ * @event_count: Events of the process in the window
+ * @cgroup_id: cgroup v2 ID of the process
+ * @threat_score: Last threat score of the process
+ */
+struct ai_process_summary {
+	uint32_t pid;		/* Process ID */
+	uint32_t event_count;	/* Events in window */
+	uint64_t cgroup_id;	/* cgroup v2 ID */
+	float threat_score;	/* Threat score */
+};
+
+/**
+ * struct ai_summary - Consistent copy of the window verdict
+ * @threat_score: Overall threat score of the window
+ * @threat_level_str: Human-readable threat level
+ * @threat_reason: Explanation of the threat assessment
+ * @process_count: Processes tracked in the window
+ * @cgroup_count: cgroups of the tracked processes
+ * @top_count: Valid entries in @top
+ * @top: Highest scoring processes, highest first
+ */
+struct ai_summary {
+	float threat_score;				/* Overall threat score */
+	char threat_level_str[16];			/* Threat level string */
+	char threat_reason[256];			/* Threat reason */
+	int process_count;				/* Tracked processes */
+	int cgroup_count;				/* Tracked cgroups */
+	int top_count;					/* Valid top entries */
+	struct ai_process_summary top[AI_SUMMARY_TOP];	/* Top processes */
 };
 
 /*
@@ -302,6 +178,25 @@ struct ai_engine {
  */
 ai_engine_t* ai_engine_init(const char* model_path);
 
+/**
+ * ai_engine_set_clock - Replace the time source of an engine
+ * @engine: AI engine instance
+ * @clock: Time source in nanoseconds, NULL for CLOCK_MONOTONIC
+ * @ctx: Opaque context passed to @clock
+ *
+ * Lets offline scoring and benchmarks drive the sliding window on event or
+ * virtual time. The window is restarted at the new clock's current time.
+ */
+void ai_engine_set_clock(ai_engine_t* engine, ai_clock_fn clock, void* ctx);
+
+/**
+ * ai_engine_now - Read the engine clock
+ * @engine: AI engine instance
+ *
+ * Return: Current engine time in nanoseconds
+ */
+uint64_t ai_engine_now(const ai_engine_t* engine);
+
 /**
  * ai_engine_cleanup - Cleanup AI engine instance
  * @engine: AI engine instance to cleanup
@@ -341,6 +236,59 @@ void ai_engine_stop_analysis(ai_engine_t* engine);
  */
 float ai_engine_analyze_event(ai_engine_t* engine, const struct ravn_event* event);
 
+/**
+ * ai_engine_get_summary - Copy the current window verdict
+ * @engine: AI engine instance
+ * @summary: Summary structure to populate
+ *
+ * Safe to call from any thread while events are being analyzed; the copy
+ * is taken under the window lock and never reflects a half-applied event.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int ai_engine_get_summary(ai_engine_t* engine, struct ai_summary* summary);
+
+/**
+ * ai_engine_get_top - Copy the highest scoring processes of the window
+ * @engine: AI engine instance
+ * @top: Output array, highest score first
+ * @max: Capacity of @top
+ *
+ * Return: Number of entries written, -1 on failure
+ */
+int ai_engine_get_top(ai_engine_t* engine, struct ai_process_summary* top, int max);
+
+/**
+ * ai_engine_get_cgroups - Copy the highest scoring cgroups of the window
+ * @engine: AI engine instance
+ * @cgroups: Output array, highest score first
+ * @max: Capacity of @cgroups
+ *
+ * Return: Number of entries written, -1 on failure
+ */
+int ai_engine_get_cgroups(ai_engine_t* engine, struct ai_cgroup_summary* cgroups, int max);
+
+/**
+ * ai_engine_get_features - Extract the feature vector of one process
+ * @engine: AI engine instance
+ * @pid: Process ID
+ * @features: Output array of TOTAL_FEATURES values
+ *
+ * Only the copy of the process sequence is taken under the window lock;
+ * feature extraction runs on the copy, outside it.
+ *
+ * Return: 0 on success, -1 if the process is not in the window
+ */
+int ai_engine_get_features(ai_engine_t* engine, uint32_t pid, float* features);
+
+/**
+ * ai_engine_reload_model - Reload the model weights and restart the window
+ * @engine: AI engine instance
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int ai_engine_reload_model(ai_engine_t* engine);
+
 /*
  * Thread Management Functions
  */
@@ -363,6 +311,18 @@ int ai_engine_start_thread(ai_engine_t* engine);
  */
 void ai_engine_stop_thread(ai_engine_t* engine);
 
+/**
+ * ai_engine_restart_thread - Restart background analysis thread
+ * @engine: AI engine instance
+ *
+ * Asks the analysis thread to stop and starts a new one once it has
+ * exited. Never blocks on a thread that does not exit. Used by the
+ * health monitor.
+ *
+ * Return: 0 on success, -1 if the old thread did not exit in time
+ */
+int ai_engine_restart_thread(ai_engine_t* engine);
+
 /**
  * ai_thread_func - Background analysis thread function
  * @arg: AI engine instance pointer
@@ -381,20 +341,30 @@ void* ai_thread_func(void* arg);
 /**
  * sliding_window_init - Initialize sliding window
  * @window: Sliding window structure to initialize
+ * @now: Current engine time in nanoseconds
  *
- * Initializes a sliding window structure with default values.
+ * Initializes a sliding window structure ending at @now.
  *
  * Return: 0 on success, -1 on failure
  */
-int sliding_window_init(struct sliding_window* window);
+int sliding_window_init(struct sliding_window* window, uint64_t now);
+
+/**
+ * sliding_window_cleanup - Clear a sliding window
+ * @window: Sliding window structure to clear
+ *
+ * Drops all tracked process sequences; the window must be initialized
+ * again with sliding_window_init() before reuse.
+ */
+void sliding_window_cleanup(struct sliding_window* window);
 
 /**
  * sliding_window_update - Update sliding window with current time
  * @window: Sliding window structure
  * @current_time: Current timestamp in nanoseconds
  *
- * Updates the sliding window to the current time, removing
- * expired events and preparing for new analysis.
+ * Slides the window every SLIDE_INTERVAL_SECONDS to cover the last
+ * WINDOW_SIZE_SECONDS, removing expired events and idle processes.
  *
  * Return: 0 on success, -1 on failure
  */
@@ -497,144 +467,4 @@ int ai_is_suspicious_sequence(const struct event_sequence* sequence);
  */
 int ai_detect_attack_pattern(const struct event_sequence* sequence);
 
-/*
- * RAVN Security Feature Extraction Functions
- */
-
-/**
- * extract_features_from_events - Extract comprehensive features from event
- * sequence
- * @sequence: Event sequence to analyze
- * @features: Output array for extracted features (must be TOTAL_FEATURES size)
- *
- * Extracts 64 multi-dimensional features from the event sequence using the
- * RAVN Security Feature Extraction Algorithm. Features are organized into
- * categories: temporal, process, file, network, security, system, and
- * behavioral.
- *
- * Return: 0 on success, -1 on failure
- */
-int extract_features_from_events(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_temporal_features - Extract temporal pattern features
- * @sequence: Event sequence to analyze
- * @features: Output array for temporal features (8 features)
- *
- * Extracts time-based pattern features including event frequency, burst
- * intensity, time regularity, and sequence duration.
- */
-void extract_temporal_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_process_features - Extract process behavior features
- * @sequence: Event sequence to analyze
- * @features: Output array for process features (12 features)
- *
- * Extracts process behavior features including spawn count, tree depth,
- * command complexity, and process management operations.
- */
-void extract_process_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_file_features - Extract file access pattern features
- * @sequence: Event sequence to analyze
- * @features: Output array for file features (10 features)
- *
- * Extracts file access pattern features including sensitive file access,
- * executable file operations, and file permission changes.
- */
-void extract_file_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_network_features - Extract network behavior features
- * @sequence: Event sequence to analyze
- * @features: Output array for network features (8 features)
- *
- * Extracts network behavior features including connection count, suspicious
- * port usage, data transfer volume, and protocol diversity.
- */
-void extract_network_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_security_features - Extract security event features
- * @sequence: Event sequence to analyze
- * @features: Output array for security features (8 features)
- *
- * Extracts security event features including privilege escalation attempts,
- * authentication events, failed operations, and suspicious syscalls.
- */
-void extract_security_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_system_features - Extract system resource usage features
- * @sequence: Event sequence to analyze
- * @features: Output array for system features (8 features)
- *
- * Extracts system resource usage features including CPU usage, memory
- * consumption, disk I/O intensity, and system load impact.
- */
-void extract_system_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_behavioral_features - Extract behavioral pattern features
- * @sequence: Event sequence to analyze
- * @features: Output array for behavioral features (10 features)
- *
- * Extracts behavioral pattern features including stealth behavior, persistence
- * attempts, evasion techniques, and lateral movement patterns.
- */
-void extract_behavioral_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_memory_features - Extract memory behavior features
- * @sequence: Event sequence to analyze
- * @features: Output array for memory features (12 features)
- *
- * Extracts memory behavior features including allocation patterns, memory
- * corruption attempts, heap spray detection, and memory access anomalies.
- */
-void extract_memory_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_kernel_features - Extract kernel-level features
- * @sequence: Event sequence to analyze
- * @features: Output array for kernel features (10 features)
- *
- * Extracts kernel-level features including module operations, kernel function
- * calls, security violations, and kernel performance metrics.
- */
-void extract_kernel_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_performance_features - Extract performance metrics features
- * @sequence: Event sequence to analyze
- * @features: Output array for performance features (12 features)
- *
- * Extracts performance metrics features including CPU usage, memory pressure,
- * I/O patterns, and system resource contention.
- */
-void extract_performance_features(const struct event_sequence* sequence, float* features);
-
-/**
- * extract_advanced_features - Extract advanced pattern detection features
- * @sequence: Event sequence to analyze
- * @features: Output array for advanced features (40 features)
- *
- * Extracts advanced pattern detection features including multi-dimensional
- * correlation analysis, temporal anomaly detection, and complex attack pattern
- * recognition.
- */
-void extract_advanced_features(const struct event_sequence* sequence, float* features);
-
-/**
- * normalize_features - Normalize features to [0,1] range
- * @features: Feature array to normalize
- * @count: Number of features to normalize
- *
- * Normalizes all features to the [0,1] range for consistent neural network
- * input.
- */
-void normalize_features(float* features, int count);
-
 #endif // RAVN_AI_ENGINE_H
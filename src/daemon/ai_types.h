@@ -0,0 +1,235 @@
+/*
+ * RAVN AI Types - Header File
+ *
+ * This header defines the feature layout and the event sequence shared by
+ * the AI engine and the feature extraction. It needs neither libbpf nor the
+ * rest of the daemon, so libravnfeatures.so builds from libc and libm alone.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * Architecture:
+ * - Window parameters, feature counts and offsets of the TOTAL_FEATURES
+ *   vector, and the constants of the feature extractors
+ * - Included by ai_engine.h and features.h
+ */
+
+#ifndef RAVN_AI_TYPES_H
+#define RAVN_AI_TYPES_H
+
+#include "event_types.h"
+
+#include <stdint.h>
+
+/*
+ * Event Type Enums - Comprehensive categorization of security events
+ * These enums make the code more readable and maintainable
+ */
+
+/*
+ * Note: All event type enums (process_event_type, file_event_type,
+ * network_event_type, security_event_type, memory_event_type,
+ * kernel_event_type, performance_event_type) are defined in
+ * event_types.h and included above
+ */
+
+/*
+ * Feature Extraction Constants - Make code self-documenting
+ * These constants replace magic numbers in feature extraction algorithms
+ */
+
+/**
+ * enum behavioral_pattern_modulo - Behavioral pattern detection modulo values
+ * Used for pattern detection in behavioral feature extraction
+ */
+enum behavioral_pattern_modulo {
+	BEHAVIORAL_PATTERN_MODULO = 20,		  /* Modulo for behavioral pattern detection */
+	BEHAVIORAL_STEALTH_PATTERN = 0,		  /* Stealth behavior pattern (modulo 20 == 0) */
+	BEHAVIORAL_PERSISTENCE_PATTERN = 1,	  /* Persistence pattern (modulo 20 == 1) */
+	BEHAVIORAL_EVASION_PATTERN = 2,		  /* Evasion pattern (modulo 20 == 2) */
+	BEHAVIORAL_LATERAL_MOVEMENT_PATTERN = 3,  /* Lateral movement pattern (modulo 20 == 3) */
+	BEHAVIORAL_DATA_EXFILTRATION_PATTERN = 4, /* Data exfiltration pattern (modulo 20 == 4) */
+	BEHAVIORAL_COMMAND_INJECTION_PATTERN = 5, /* Command injection pattern (modulo 20 == 5) */
+	BEHAVIORAL_BUFFER_OVERFLOW_PATTERN = 6,	  /* Buffer overflow pattern (modulo 20 == 6) */
+	BEHAVIORAL_CODE_INJECTION_PATTERN = 7,	  /* Code injection pattern (modulo 20 == 7) */
+	BEHAVIORAL_ANTI_FORENSICS_PATTERN = 8,	  /* Anti-forensics pattern (modulo 20 == 8) */
+	BEHAVIORAL_COMMUNICATION_PATTERN = 9	  /* Communication pattern (modulo 20 == 9) */
+};
+
+/**
+ * enum system_resource_modulo - System resource detection modulo values
+ * Used for resource usage pattern detection
+ */
+enum system_resource_modulo {
+	SYSTEM_RESOURCE_MODULO = 10,   /* Modulo for system resource detection */
+	CPU_INTENSIVE_PATTERN = 0,     /* CPU-intensive operations (modulo 10 == 0) */
+	MEMORY_INTENSIVE_PATTERN = 1,  /* Memory-intensive operations (modulo 10 == 1) */
+	DISK_IO_INTENSIVE_PATTERN = 2, /* Disk I/O operations (modulo 10 == 2) */
+	KERNEL_OPERATIONS_PATTERN = 3  /* Kernel operations (modulo 10 == 3) */
+};
+
+/**
+ * enum file_type_modulo - File type detection modulo values
+ * Used for file type classification in feature extraction
+ */
+enum file_type_modulo {
+	FILE_TYPE_MODULO = 10,	     /* Modulo for file type detection */
+	SENSITIVE_FILE_PATTERN = 0,  /* Sensitive files (modulo 10 == 0) */
+	EXECUTABLE_FILE_PATTERN = 1, /* Executable files (modulo 10 == 1) */
+	CONFIG_FILE_PATTERN = 2,     /* Configuration files (modulo 10 == 2) */
+	LOG_FILE_PATTERN = 3,	     /* Log files (modulo 10 == 3) */
+	TEMP_FILE_PATTERN = 4	     /* Temporary files (modulo 10 == 4) */
+};
+
+/**
+ * enum suspicious_port_values - Suspicious port numbers for network monitoring
+ * Used for detecting suspicious network connections
+ */
+enum suspicious_port_values {
+	SUSPICIOUS_PORT_4444 = 4444, /* Common backdoor port */
+	SUSPICIOUS_PORT_1337 = 1337, /* Common hacker port */
+	PORT_MODULO_BASE = 1000	     /* Base for port modulo operations */
+};
+
+/**
+ * enum behavioral_event_type - Behavioral pattern event types
+ */
+enum behavioral_event_type {
+	BEHAVIORAL_STEALTH = 1,		  /* Stealth behavior patterns */
+	BEHAVIORAL_PERSISTENCE = 2,	  /* Persistence attempts */
+	BEHAVIORAL_EVASION = 3,		  /* Evasion techniques */
+	BEHAVIORAL_LATERAL_MOVEMENT = 4,  /* Lateral movement patterns */
+	BEHAVIORAL_DATA_EXFILTRATION = 5, /* Data exfiltration patterns */
+	BEHAVIORAL_COMMAND_INJECTION = 6, /* Command injection attempts */
+	BEHAVIORAL_BUFFER_OVERFLOW = 7,	  /* Buffer overflow patterns */
+	BEHAVIORAL_CODE_INJECTION = 8,	  /* Code injection patterns */
+	BEHAVIORAL_ANTI_FORENSICS = 9,	  /* Anti-forensics techniques */
+	BEHAVIORAL_COMMUNICATION = 10	  /* Communication patterns */
+};
+
+/**
+ * enum threat_classification - Threat level classifications
+ */
+enum threat_classification {
+	THREAT_NORMAL = 0,     /* Normal system activity */
+	THREAT_SUSPICIOUS = 1, /* Suspicious activity detected */
+	THREAT_MALICIOUS = 2   /* Malicious activity confirmed */
+};
+
+/**
+ * enum temporal_feature_type - Temporal pattern feature types
+ */
+enum temporal_feature_type {
+	TEMPORAL_EVENT_FREQUENCY = 0,	 /* Events per second */
+	TEMPORAL_BURST_INTENSITY = 1,	 /* Events in 1-second bursts */
+	TEMPORAL_TIME_REGULARITY = 2,	 /* Standard deviation of intervals */
+	TEMPORAL_SEQUENCE_DURATION = 3,	 /* Sequence duration (normalized) */
+	TEMPORAL_PEAK_ACTIVITY_TIME = 4, /* When most events occurred */
+	TEMPORAL_QUIET_PERIODS = 5,	 /* Periods with no events */
+	TEMPORAL_ACCELERATION_RATE = 6,	 /* Increasing event frequency */
+	TEMPORAL_DECELERATION_RATE = 7	 /* Decreasing event frequency */
+};
+
+/**
+ * enum system_feature_type - System resource usage feature types
+ */
+enum system_feature_type {
+	SYSTEM_CPU_INTENSITY = 0,	/* CPU usage intensity */
+	SYSTEM_MEMORY_INTENSITY = 1,	/* Memory usage intensity */
+	SYSTEM_DISK_IO_INTENSITY = 2,	/* Disk I/O intensity */
+	SYSTEM_LOAD_IMPACT = 3,		/* System load impact */
+	SYSTEM_RESOURCE_CONTENTION = 4, /* Resource contention */
+	SYSTEM_SYSCALL_FREQUENCY = 5,	/* System call frequency */
+	SYSTEM_INTERRUPT_HANDLING = 6,	/* Interrupt handling */
+	SYSTEM_KERNEL_OPERATIONS = 7	/* Kernel operations */
+};
+
+/**
+ * enum feature_category - Feature extraction categories
+ */
+enum feature_category {
+	FEATURE_TEMPORAL = 0,  /* Temporal pattern features */
+	FEATURE_PROCESS = 1,   /* Process behavior features */
+	FEATURE_FILE = 2,      /* File access pattern features */
+	FEATURE_NETWORK = 3,   /* Network behavior features */
+	FEATURE_SECURITY = 4,  /* Security event features */
+	FEATURE_SYSTEM = 5,    /* System resource usage features */
+	FEATURE_BEHAVIORAL = 6 /* Behavioral pattern features */
+};
+
+/*
+ * AI Model Configuration Parameters
+ */
+#define WINDOW_SIZE_SECONDS    10   /* Sliding window duration in seconds */
+#define SLIDE_INTERVAL_SECONDS 1    /* Window slide interval in seconds */
+#define MAX_EVENTS_PER_WINDOW  1000 /* Maximum events per process in window */
+#define MAX_PROCESSES	       100  /* Maximum processes to track simultaneously */
+#define WINDOW_SIZE_NS	       (WINDOW_SIZE_SECONDS * 1000000000ULL)
+#define SLIDE_INTERVAL_NS      (SLIDE_INTERVAL_SECONDS * 1000000000ULL)
+#define AI_SUMMARY_TOP	       10   /* Processes reported in a summary */
+
+/*
+ * RAVN Security Feature Extraction Parameters
+ * Multi-dimensional feature extraction for comprehensive threat detection
+ */
+#define TOTAL_FEATURES                                                             \
+	128 /* Total number of extracted features (doubled for enhanced eBPF data) \
+	     */
+#define TEMPORAL_FEATURES    8	/* Time-based pattern features */
+#define PROCESS_FEATURES     12 /* Process behavior features */
+#define FILE_FEATURES	     10 /* File access pattern features */
+#define NETWORK_FEATURES     8	/* Network behavior features */
+#define SECURITY_FEATURES    8	/* Security event features */
+#define SYSTEM_FEATURES	     8	/* System resource usage features */
+#define BEHAVIORAL_FEATURES  10 /* Behavioral pattern features */
+#define MEMORY_FEATURES	     12 /* Memory behavior features */
+#define KERNEL_FEATURES	     10 /* Kernel-level features */
+#define PERFORMANCE_FEATURES 12 /* Performance metrics features */
+#define ADVANCED_FEATURES    40 /* Advanced pattern detection features */
+
+/*
+ * Feature Category Offsets
+ */
+#define TEMPORAL_OFFSET	   0  /* Temporal features start at index 0 */
+#define PROCESS_OFFSET	   8  /* Process features start at index 8 */
+#define FILE_OFFSET	   20 /* File features start at index 20 */
+#define NETWORK_OFFSET	   30 /* Network features start at index 30 */
+#define SECURITY_OFFSET	   38 /* Security features start at index 38 */
+#define SYSTEM_OFFSET	   46 /* System features start at index 46 */
+#define BEHAVIORAL_OFFSET  54 /* Behavioral features start at index 54 */
+#define MEMORY_OFFSET	   64 /* Memory features start at index 64 */
+#define KERNEL_OFFSET	   76 /* Kernel features start at index 76 */
+#define PERFORMANCE_OFFSET 86 /* Performance features start at index 86 */
+#define ADVANCED_OFFSET	   98 /* Advanced features start at index 98 */
+
+/*
+ * Sketch-Derived Features
+ * Only extracted in RAVN_SKETCH_FEATURES builds, which need a model trained
+ * with them; the training pipeline cannot produce one yet, so they stay zero
+ */
+#define SKETCH_FEATURE_DISTINCT_FILES (ADVANCED_OFFSET + 0) /* Distinct files of the process */
+#define SKETCH_DISTINCT_FILES_SCALE   256.0f		    /* Distinct files mapped to 1.0 */
+
+/**
+ * struct event_sequence - Event sequence for a single process
+ * @pid: Process ID
+ * @event_count: Number of events in the sequence
+ * @cgroup_id: cgroup v2 ID of the last event of the process (0 if unknown)
+ * @events: Array of event types in chronological order
+ * @timestamps: Array of event timestamps (nanoseconds since epoch)
+ * @threat_score: Calculated threat score for this sequence
+ *
+ * Represents a sequence of events from a single process within
+ * the sliding window. Used for pattern analysis and threat detection.
+ */
+struct event_sequence {
+	uint32_t pid;				    /* Process ID */
+	uint32_t event_count;			    /* Number of events */
+	uint64_t cgroup_id;			    /* cgroup v2 ID */
+	uint32_t events[MAX_EVENTS_PER_WINDOW];	    /* Event types array */
+	uint64_t timestamps[MAX_EVENTS_PER_WINDOW]; /* Event timestamps */
+	float threat_score;			    /* Calculated threat score */
+};
+
+#endif // RAVN_AI_TYPES_H
@@ -0,0 +1,396 @@
+// RAVN cgroup Attribution Implementation
+// Cached resolution of cgroup IDs to paths, containers and pods
+
+#define _GNU_SOURCE // open_by_handle_at, struct file_handle
+#include "cgroup.h"
+
+#include "../utils/logger.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef CGROUP2_SUPER_MAGIC
+#define CGROUP2_SUPER_MAGIC 0x63677270
+#endif
+
+// Kernel file handle type of kernfs nodes; the handle is the 8-byte cgroup ID
+#define CGROUP_FILEID_KERNFS 0xfe
+
+// One cached ID
+struct cgroup_entry {
+	struct cgroup_info info; /* Resolution result */
+	time_t retry_at;	 /* Unresolved: earliest next lookup */
+	int used;		 /* Slot in use */
+};
+
+static struct cgroup_entry cache[CGROUP_CACHE_SIZE];
+static int cache_count = 0;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// cgroup v2 mount, -1 when unavailable
+static int root_fd = -1;
+static const char* root_path = CGROUP_ROOT;
+static int handles_refused = 0;
+
+// Container runtimes by the prefix of their systemd scope
+static const struct {
+	const char* prefix;
+	const char* runtime;
+} scope_prefixes[] = {
+	{"docker-", "docker"},
+	{"cri-containerd-", "containerd"},
+	{"crio-", "crio"},
+	{"libpod-", "podman"},
+};
+
+// Monotonic time in seconds
+static time_t now_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec;
+}
+
+// Check that a string is exactly len hex digits
+static int is_hex(const char* s, size_t len) {
+	for (size_t i = 0; i < len; i++) {
+		if (!isxdigit((unsigned char)s[i])) {
+			return 0;
+		}
+	}
+	return s[len] == '\0';
+}
+
+// Parse a pod UID out of a kubepods path component ("pod<uid>" or
+// "kubepods-<qos>-pod<uid>.slice", the systemd form using '_' for '-')
+static void parse_pod(const char* component, struct cgroup_info* info) {
+	const char* pod = strncmp(component, "pod", 3) == 0 ? component : strstr(component, "-pod");
+	if (!pod) {
+		return;
+	}
+	pod += pod == component ? 3 : 4;
+
+	size_t len = strcspn(pod, ".");
+	if (len < 32 || len > CGROUP_POD_UID) {
+		return;
+	}
+	for (size_t i = 0; i < len; i++) {
+		char c = pod[i] == '_' ? '-' : pod[i];
+		if (!isxdigit((unsigned char)c) && c != '-') {
+			return;
+		}
+		info->pod_uid[i] = c;
+	}
+	info->pod_uid[len] = '\0';
+}
+
+// Parse a container ID out of a path component
+static int parse_container(const char* component, int under_docker, struct cgroup_info* info) {
+	char id[CGROUP_PATH_MAX];
+	const char* runtime = under_docker ? "docker" : "";
+
+	snprintf(id, sizeof(id), "%s", component);
+	for (size_t i = 0; i < sizeof(scope_prefixes) / sizeof(scope_prefixes[0]); i++) {
+		size_t plen = strlen(scope_prefixes[i].prefix);
+		if (strncmp(component, scope_prefixes[i].prefix, plen) == 0) {
+			snprintf(id, sizeof(id), "%s", component + plen);
+			runtime = scope_prefixes[i].runtime;
+			break;
+		}
+	}
+	char* scope = strstr(id, ".scope");
+	if (scope && scope[6] == '\0') {
+		*scope = '\0';
+	}
+
+	if (!is_hex(id, CGROUP_CONTAINER_ID)) {
+		return 0;
+	}
+	memcpy(info->container_id, id, CGROUP_CONTAINER_ID + 1);
+	snprintf(info->runtime, sizeof(info->runtime), "%s", runtime);
+	return 1;
+}
+
+// Derive the container and pod of a cgroup path
+int cgroup_parse_path(const char* path, struct cgroup_info* info) {
+	char copy[CGROUP_PATH_MAX];
+	char* save = NULL;
+	const char* last = NULL;
+	int kubepods = strstr(path, "kubepods") != NULL;
+	int under_docker = 0;
+
+	info->runtime[0] = '\0';
+	info->container_id[0] = '\0';
+	info->pod_uid[0] = '\0';
+
+	// The innermost container wins (nested systemd units stay attributed)
+	snprintf(copy, sizeof(copy), "%s", path);
+	for (char* c = strtok_r(copy, "/", &save); c; c = strtok_r(NULL, "/", &save)) {
+		if (kubepods) {
+			parse_pod(c, info);
+		}
+		parse_container(c, under_docker, info);
+		under_docker = strcmp(c, "docker") == 0;
+		last = path + (c - copy);
+	}
+
+	snprintf(info->name, sizeof(info->name), "%s", last ? last : "/");
+	return info->container_id[0] != '\0';
+}
+
+// Resolve an ID to its path with a kernfs file handle
+static int resolve_by_handle(uint64_t id, char* path, size_t len) {
+	union {
+		struct file_handle fh;
+		char buf[sizeof(struct file_handle) + sizeof(uint64_t)];
+	} handle;
+
+	handle.fh.handle_bytes = sizeof(id);
+	handle.fh.handle_type = CGROUP_FILEID_KERNFS;
+	memcpy(handle.fh.f_handle, &id, sizeof(id));
+
+	int fd = open_by_handle_at(root_fd, &handle.fh, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		if (errno == EPERM || errno == EOPNOTSUPP || errno == ENOSYS) {
+			handles_refused = 1;
+			LOG_INFO_MODULE("CGROUP", "cgroup handles refused (%s), walking %s instead",
+					strerror(errno), root_path);
+		}
+		return -1;
+	}
+
+	char link[64];
+	char target[CGROUP_PATH_MAX + sizeof(CGROUP_ROOT_HYBRID)];
+	snprintf(link, sizeof(link), "/proc/self/fd/%d", fd);
+	ssize_t n = readlink(link, target, sizeof(target) - 1);
+	close(fd);
+	if (n <= 0) {
+		return -1;
+	}
+	target[n] = '\0';
+
+	size_t root_len = strlen(root_path);
+	const char* rel = target;
+	if (strncmp(target, root_path, root_len) == 0) {
+		rel = target[root_len] ? target + root_len : "/";
+	}
+	// Deeper than CGROUP_PATH_MAX: a cut path would name another cgroup
+	int written = snprintf(path, len, "%s", rel);
+	if (written < 0 || (size_t)written >= len) {
+		path[0] = '\0';
+		return -1;
+	}
+	return 0;
+}
+
+// Walk the hierarchy below dirfd for the directory whose inode is the ID
+static int walk_for_id(int dirfd, char* path, size_t len, int depth, uint64_t id) {
+	DIR* dir = fdopendir(dirfd);
+	if (!dir) {
+		close(dirfd);
+		return -1;
+	}
+
+	int found = -1;
+	size_t base = strlen(path);
+	struct dirent* entry;
+	while (found < 0 && (entry = readdir(dir))) {
+		if (entry->d_name[0] == '.' ||
+		    (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)) {
+			continue;
+		}
+
+		struct stat st;
+		if (fstatat(dirfd, entry->d_name, &st, AT_SYMLINK_NOFOLLOW) != 0 ||
+		    !S_ISDIR(st.st_mode)) {
+			continue;
+		}
+		if (snprintf(path + base, len - base, "/%s", entry->d_name) >= (int)(len - base)) {
+			continue; // Deeper than CGROUP_PATH_MAX
+		}
+		if ((uint64_t)st.st_ino == id) {
+			found = 0;
+			break;
+		}
+		if (depth + 1 < CGROUP_WALK_DEPTH) {
+			int child =
+				openat(dirfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+			if (child >= 0) {
+				found = walk_for_id(child, path, len, depth + 1, id);
+			}
+		}
+		if (found < 0) {
+			path[base] = '\0';
+		}
+	}
+	closedir(dir);
+	return found;
+}
+
+// Resolve an ID to its path by walking the hierarchy
+static int resolve_by_walk(uint64_t id, char* path, size_t len) {
+	struct stat st;
+	if (fstat(root_fd, &st) == 0 && (uint64_t)st.st_ino == id) {
+		snprintf(path, len, "/");
+		return 0;
+	}
+
+	int fd = openat(root_fd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0) {
+		return -1;
+	}
+	path[0] = '\0';
+	return walk_for_id(fd, path, len, 0, id);
+}
+
+// Read the hostname of a member process of a container cgroup
+static void read_container_name(struct cgroup_info* info) {
+	char file[CGROUP_PATH_MAX + 64];
+	char line[CGROUP_NAME_MAX];
+	int pid = 0;
+
+	snprintf(file, sizeof(file), "%s%s/cgroup.procs", root_path, info->path);
+	FILE* f = fopen(file, "r");
+	if (!f) {
+		return;
+	}
+	if (fscanf(f, "%d", &pid) != 1) {
+		pid = 0;
+	}
+	fclose(f);
+	if (pid <= 0) {
+		return;
+	}
+
+	snprintf(file, sizeof(file), "/proc/%d/root/etc/hostname", pid);
+	f = fopen(file, "r");
+	if (!f) {
+		return;
+	}
+	if (fgets(line, sizeof(line), f)) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (line[0]) {
+			snprintf(info->name, sizeof(info->name), "%s", line);
+		}
+	}
+	fclose(f);
+}
+
+// Resolve an ID from scratch
+static void resolve(uint64_t id, struct cgroup_info* info) {
+	int found = -1;
+	if (!handles_refused) {
+		found = resolve_by_handle(id, info->path, sizeof(info->path));
+	}
+	if (found != 0 && handles_refused) {
+		found = resolve_by_walk(id, info->path, sizeof(info->path));
+	}
+	if (found != 0) {
+		info->path[0] = '\0';
+		return;
+	}
+
+	info->resolved = 1;
+	if (cgroup_parse_path(info->path, info)) {
+		// Short ID until a member process shows the hostname
+		snprintf(info->name, sizeof(info->name), "%.12s", info->container_id);
+		read_container_name(info);
+	}
+}
+
+// Find the cache slot of an ID, or the free slot it goes to (caller holds cache_lock)
+static struct cgroup_entry* cache_slot(uint64_t id) {
+	uint32_t mask = CGROUP_CACHE_SIZE - 1;
+	uint32_t i = (uint32_t)((id * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+	while (cache[i].used && cache[i].info.id != id) {
+		i = (i + 1) & mask;
+	}
+	return &cache[i];
+}
+
+// Open the cgroup v2 hierarchy for lookups
+int cgroup_init(void) {
+	static const char* const roots[] = {CGROUP_ROOT, CGROUP_ROOT_HYBRID};
+
+	// Unified layout first, then the v2 part of a hybrid one
+	for (size_t i = 0; i < sizeof(roots) / sizeof(roots[0]); i++) {
+		struct statfs fs;
+		int fd = open(roots[i], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd < 0) {
+			continue;
+		}
+		if (fstatfs(fd, &fs) != 0 || fs.f_type != CGROUP2_SUPER_MAGIC) {
+			close(fd);
+			continue;
+		}
+
+		root_fd = fd;
+		root_path = roots[i];
+		handles_refused = 0;
+		LOG_INFO_MODULE("CGROUP", "Resolving cgroup IDs under %s", root_path);
+		return 0;
+	}
+
+	LOG_WARN_MODULE("CGROUP", "No cgroup v2 hierarchy at %s, IDs stay unresolved", CGROUP_ROOT);
+	return -1;
+}
+
+// Close the hierarchy and drop the cache
+void cgroup_cleanup(void) {
+	pthread_mutex_lock(&cache_lock);
+	memset(cache, 0, sizeof(cache));
+	cache_count = 0;
+	pthread_mutex_unlock(&cache_lock);
+
+	if (root_fd >= 0) {
+		close(root_fd);
+		root_fd = -1;
+	}
+}
+
+// Resolve a cgroup ID
+int cgroup_lookup(uint64_t id, struct cgroup_info* info) {
+	memset(info, 0, sizeof(*info));
+	info->id = id;
+	if (id == 0 || root_fd < 0) {
+		return -1;
+	}
+
+	time_t now = now_seconds();
+	pthread_mutex_lock(&cache_lock);
+	struct cgroup_entry* entry = cache_slot(id);
+	if (entry->used && (entry->info.resolved || now < entry->retry_at)) {
+		*info = entry->info;
+		pthread_mutex_unlock(&cache_lock);
+		return info->resolved ? 0 : -1;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	// Resolve without the lock; a concurrent miss on the same ID resolves it twice
+	resolve(id, info);
+
+	pthread_mutex_lock(&cache_lock);
+	if (cache_count >= CGROUP_CACHE_SIZE * 3 / 4) {
+		memset(cache, 0, sizeof(cache));
+		cache_count = 0;
+	}
+	entry = cache_slot(id);
+	if (!entry->used) {
+		entry->used = 1;
+		cache_count++;
+	}
+	entry->info = *info;
+	entry->retry_at = now + CGROUP_RETRY_SECONDS;
+	pthread_mutex_unlock(&cache_lock);
+
+	return info->resolved ? 0 : -1;
+}
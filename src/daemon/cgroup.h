@@ -0,0 +1,110 @@
+/*
+ * RAVN cgroup Attribution - Header File
+ *
+ * This header defines the cgroup resolver of the RAVN security platform,
+ * which maps the cgroup v2 ID carried by every eBPF record to the cgroup
+ * path, container and Kubernetes pod it belongs to, so events of different
+ * containers on one node can be told apart.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The cgroup resolver implements:
+ * - ID to path resolution through the cgroupfs: open_by_handle_at() with
+ *   the ID as kernfs file handle, falling back to a bounded walk of the
+ *   hierarchy matching the directory inode (the ID on 64-bit kernels) when
+ *   handles are refused (no CAP_DAC_READ_SEARCH)
+ * - Container IDs and runtimes from the systemd and cgroupfs driver layouts
+ *   of Docker, containerd, CRI-O and Podman, and pod UIDs from kubepods
+ * - Container names from the hostname of a member process (the pod name on
+ *   Kubernetes), the last path component for host cgroups
+ * - A fixed cache of resolved and unresolved IDs; failed IDs are retried at
+ *   most every CGROUP_RETRY_SECONDS
+ *
+ * Architecture:
+ * - Lookups hit the cache on the event path; only the first event of a
+ *   cgroup pays for the resolution, which runs outside the cache lock
+ * - cgroup IDs are never reused, so entries never go stale; the cache is
+ *   reset when it fills up
+ * - Without a cgroup v2 mount every ID stays unresolved and events carry
+ *   the bare ID
+ */
+
+#ifndef RAVN_CGROUP_H
+#define RAVN_CGROUP_H
+
+#include <stdint.h>
+
+/*
+ * cgroup Resolver Configuration Parameters
+ */
+#define CGROUP_ROOT          "/sys/fs/cgroup"         /* cgroup v2 mount */
+#define CGROUP_ROOT_HYBRID   "/sys/fs/cgroup/unified" /* cgroup v2 mount, hybrid layout */
+#define CGROUP_CACHE_SIZE    512                      /* Cached IDs (power of two) */
+#define CGROUP_RETRY_SECONDS 10                       /* Gap between lookups of an unresolved ID */
+#define CGROUP_WALK_DEPTH    8                        /* Deepest level the fallback walk visits */
+#define CGROUP_PATH_MAX      256                      /* Longest cgroup path kept */
+#define CGROUP_NAME_MAX      64                       /* Longest container name kept */
+#define CGROUP_CONTAINER_ID  64                       /* Container ID length (hex digits) */
+#define CGROUP_POD_UID       36                       /* Pod UID length */
+
+/**
+ * struct cgroup_info - What a cgroup ID resolves to
+ * @id: cgroup v2 ID
+ * @resolved: 1 if @path is known
+ * @path: Path below the cgroup v2 mount, "/" for the root cgroup
+ * @runtime: Container runtime ("docker", "containerd", "crio", "podman"), "" for none
+ * @container_id: Container ID, "" for host cgroups
+ * @pod_uid: Kubernetes pod UID, "" outside Kubernetes
+ * @name: Container hostname (the pod name on Kubernetes), else the last
+ *        path component
+ */
+struct cgroup_info {
+	uint64_t id;					/* cgroup v2 ID */
+	int resolved;					/* Path known */
+	char path[CGROUP_PATH_MAX];			/* cgroupfs path */
+	char runtime[16];				/* Container runtime */
+	char container_id[CGROUP_CONTAINER_ID + 1];	/* Container ID */
+	char pod_uid[CGROUP_POD_UID + 1];		/* Pod UID */
+	char name[CGROUP_NAME_MAX];			/* Display name */
+};
+
+/**
+ * cgroup_init - Open the cgroup v2 hierarchy for lookups
+ *
+ * Tries CGROUP_ROOT, then CGROUP_ROOT_HYBRID for hosts with the hybrid
+ * layout. Lookups before cgroup_init() or after a failed one leave every ID
+ * unresolved.
+ *
+ * Return: 0 on success, -1 if no cgroup v2 hierarchy is mounted
+ */
+int cgroup_init(void);
+
+/**
+ * cgroup_cleanup - Close the hierarchy and drop the cache
+ */
+void cgroup_cleanup(void);
+
+/**
+ * cgroup_lookup - Resolve a cgroup ID
+ * @id: cgroup v2 ID from an eBPF record
+ * @info: Receives the cached or newly resolved entry (only @id set and
+ *        @resolved 0 if unknown)
+ *
+ * Safe to call from any thread.
+ *
+ * Return: 0 if resolved, -1 otherwise
+ */
+int cgroup_lookup(uint64_t id, struct cgroup_info* info);
+
+/**
+ * cgroup_parse_path - Derive the container and pod of a cgroup path
+ * @path: Path below the cgroup v2 mount
+ * @info: Receives @runtime, @container_id, @pod_uid and the fallback @name
+ *
+ * Return: 1 if @path is a container cgroup, 0 otherwise
+ */
+int cgroup_parse_path(const char* path, struct cgroup_info* info);
+
+#endif // RAVN_CGROUP_H
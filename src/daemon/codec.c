@@ -0,0 +1,374 @@
+// RAVN Column Codecs Implementation
+// Delta/varint timestamps, four-lane frame-of-reference bit packing and LZ77 bytes
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "codec.h"
+
+#include <string.h>
+
+// Four 32-bit lanes: one vector register on every supported target
+typedef uint32_t codec_u32x4 __attribute__((vector_size(16)));
+
+// Words of one lane in a group
+#define CODEC_LANE_VALUES (CODEC_GROUP / 4)
+
+// Largest delta-coded size of n timestamps
+size_t codec_delta_bound(uint32_t n) {
+	return sizeof(uint64_t) + (size_t)(n ? n - 1 : 0) * 10;
+}
+
+// Delta, zigzag and varint code 64-bit values
+size_t codec_delta_encode(const uint64_t* in, uint32_t n, uint8_t* out) {
+	uint8_t* p = out;
+	memcpy(p, &in[0], sizeof(uint64_t));
+	p += sizeof(uint64_t);
+
+	for (uint32_t i = 1; i < n; i++) {
+		int64_t delta = (int64_t)(in[i] - in[i - 1]);
+		uint64_t z = ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63);
+		while (z >= 0x80) {
+			*p++ = (uint8_t)(z | 0x80);
+			z >>= 7;
+		}
+		*p++ = (uint8_t)z;
+	}
+	return (size_t)(p - out);
+}
+
+// Decode values written by codec_delta_encode()
+int codec_delta_decode(const uint8_t* in, size_t size, uint32_t n, uint64_t* out) {
+	if (n == 0) {
+		return 0;
+	}
+	if (size < sizeof(uint64_t)) {
+		return -1;
+	}
+
+	const uint8_t* p = in + sizeof(uint64_t);
+	const uint8_t* end = in + size;
+	uint64_t value;
+	memcpy(&value, in, sizeof(value));
+	out[0] = value;
+
+	for (uint32_t i = 1; i < n; i++) {
+		uint64_t z;
+		if (p < end && *p < 0x80) {
+			z = *p++; // Common case: one byte
+		} else if (p + 1 < end && p[1] < 0x80) {
+			z = (uint64_t)(p[0] & 0x7F) | (uint64_t)p[1] << 7;
+			p += 2;
+		} else {
+			z = 0;
+			for (int shift = 0;; shift += 7) {
+				if (p >= end || shift > 63) {
+					return -1;
+				}
+				uint8_t byte = *p++;
+				z |= (uint64_t)(byte & 0x7F) << shift;
+				if (byte < 0x80) {
+					break;
+				}
+			}
+		}
+		value += (z >> 1) ^ (0 - (z & 1));
+		out[i] = value;
+	}
+	return p == end ? 0 : -1;
+}
+
+// Bits needed for a value
+static uint32_t bit_width(uint32_t v) {
+	return v ? 32 - (uint32_t)__builtin_clz(v) : 0;
+}
+
+// Pack one group of CODEC_GROUP values, value i in lane i % 4
+static void pack_group(const uint32_t* in, uint32_t base, uint32_t bits, uint32_t* out) {
+	const codec_u32x4 b = {base, base, base, base};
+	codec_u32x4 acc = {0, 0, 0, 0};
+	uint32_t used = 0;
+
+	for (uint32_t j = 0; j < CODEC_LANE_VALUES && bits; j++) {
+		codec_u32x4 v;
+		memcpy(&v, in + 4 * j, sizeof(v));
+		v -= b;
+		acc |= v << used;
+		used += bits;
+		if (used >= 32) {
+			memcpy(out, &acc, sizeof(acc));
+			out += 4;
+			used -= 32;
+			acc = used ? v >> (bits - used) : (codec_u32x4){0, 0, 0, 0};
+		}
+	}
+}
+
+// Unpack one group; inlined with a constant width so the loop unrolls
+static inline __attribute__((always_inline)) void unpack_group(const uint32_t* in, uint32_t base,
+								 uint32_t bits, uint32_t* out) {
+	const codec_u32x4 b = {base, base, base, base};
+	if (bits == 0) {
+		for (uint32_t j = 0; j < CODEC_LANE_VALUES; j++) {
+			memcpy(out + 4 * j, &b, sizeof(b));
+		}
+		return;
+	}
+
+	uint32_t m = bits == 32 ? ~0u : (1u << bits) - 1;
+	const codec_u32x4 mask = {m, m, m, m};
+	codec_u32x4 w;
+	uint32_t used = 0;
+	memcpy(&w, in, sizeof(w));
+	in += 4;
+
+#pragma GCC unroll 32
+	for (uint32_t j = 0; j < CODEC_LANE_VALUES; j++) {
+		codec_u32x4 v = w >> used;
+		used += bits;
+		if (used >= 32) {
+			used -= 32;
+			if (j + 1 < CODEC_LANE_VALUES) {
+				memcpy(&w, in, sizeof(w));
+				in += 4;
+			}
+			if (used) {
+				v |= w << (bits - used);
+			}
+		}
+		v = (v & mask) + b;
+		memcpy(out + 4 * j, &v, sizeof(v));
+	}
+}
+
+// Unpack one group, dispatched to a width-specialized copy
+static void unpack_group_any(const uint32_t* in, uint32_t base, uint32_t bits, uint32_t* out) {
+	switch (bits) {
+#define CODEC_UNPACK_CASE(w)                          \
+	case w:                                       \
+		unpack_group(in, base, w, out);       \
+		break;
+		CODEC_UNPACK_CASE(0) CODEC_UNPACK_CASE(1) CODEC_UNPACK_CASE(2)
+		CODEC_UNPACK_CASE(3) CODEC_UNPACK_CASE(4) CODEC_UNPACK_CASE(5)
+		CODEC_UNPACK_CASE(6) CODEC_UNPACK_CASE(7) CODEC_UNPACK_CASE(8)
+		CODEC_UNPACK_CASE(9) CODEC_UNPACK_CASE(10) CODEC_UNPACK_CASE(11)
+		CODEC_UNPACK_CASE(12) CODEC_UNPACK_CASE(13) CODEC_UNPACK_CASE(14)
+		CODEC_UNPACK_CASE(15) CODEC_UNPACK_CASE(16) CODEC_UNPACK_CASE(17)
+		CODEC_UNPACK_CASE(18) CODEC_UNPACK_CASE(19) CODEC_UNPACK_CASE(20)
+		CODEC_UNPACK_CASE(21) CODEC_UNPACK_CASE(22) CODEC_UNPACK_CASE(23)
+		CODEC_UNPACK_CASE(24) CODEC_UNPACK_CASE(25) CODEC_UNPACK_CASE(26)
+		CODEC_UNPACK_CASE(27) CODEC_UNPACK_CASE(28) CODEC_UNPACK_CASE(29)
+		CODEC_UNPACK_CASE(30) CODEC_UNPACK_CASE(31) CODEC_UNPACK_CASE(32)
+#undef CODEC_UNPACK_CASE
+	default:
+		break;
+	}
+}
+
+// Bytes of the group headers (bases, then widths padded to 4 bytes)
+static size_t pack_header_size(uint32_t groups) {
+	return (size_t)groups * sizeof(uint32_t) + (((size_t)groups + 3) & ~(size_t)3);
+}
+
+// Largest bit-packed size of n values
+size_t codec_pack_bound(uint32_t n) {
+	uint32_t groups = (n + CODEC_GROUP - 1) / CODEC_GROUP;
+	return pack_header_size(groups) + (size_t)groups * CODEC_GROUP * sizeof(uint32_t);
+}
+
+// Frame-of-reference bit pack 32-bit values
+size_t codec_pack(const uint32_t* in, uint32_t n, uint8_t* out) {
+	uint32_t groups = (n + CODEC_GROUP - 1) / CODEC_GROUP;
+	uint32_t* bases = (uint32_t*)out;
+	uint8_t* widths = out + (size_t)groups * sizeof(uint32_t);
+	uint32_t* words = (uint32_t*)(out + pack_header_size(groups));
+	uint32_t last[CODEC_GROUP];
+
+	memset(widths, 0, pack_header_size(groups) - (size_t)groups * sizeof(uint32_t));
+	for (uint32_t g = 0; g < groups; g++) {
+		const uint32_t* values = in + (size_t)g * CODEC_GROUP;
+		uint32_t count = n - g * CODEC_GROUP < CODEC_GROUP ? n - g * CODEC_GROUP : CODEC_GROUP;
+
+		uint32_t lo = UINT32_MAX, hi = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			lo = values[i] < lo ? values[i] : lo;
+			hi = values[i] > hi ? values[i] : hi;
+		}
+
+		// A short last group is padded with its base, packing to zeros
+		if (count < CODEC_GROUP) {
+			memcpy(last, values, count * sizeof(uint32_t));
+			for (uint32_t i = count; i < CODEC_GROUP; i++) {
+				last[i] = lo;
+			}
+			values = last;
+		}
+
+		uint32_t bits = bit_width(hi - lo);
+		bases[g] = lo;
+		widths[g] = (uint8_t)bits;
+		pack_group(values, lo, bits, words);
+		words += bits * 4;
+	}
+	return (size_t)((uint8_t*)words - out);
+}
+
+// Unpack values written by codec_pack()
+int codec_unpack(const uint8_t* in, size_t size, uint32_t n, uint32_t* out) {
+	uint32_t groups = (n + CODEC_GROUP - 1) / CODEC_GROUP;
+	size_t header = pack_header_size(groups);
+	if (size < header) {
+		return -1;
+	}
+
+	const uint32_t* bases = (const uint32_t*)in;
+	const uint8_t* widths = in + (size_t)groups * sizeof(uint32_t);
+	const uint32_t* words = (const uint32_t*)(in + header);
+	size_t available = (size - header) / (4 * sizeof(uint32_t)); // Lane words left
+
+	for (uint32_t g = 0; g < groups; g++) {
+		uint32_t bits = widths[g];
+		if (bits > 32 || bits > available) {
+			return -1;
+		}
+		unpack_group_any(words, bases[g], bits, out + (size_t)g * CODEC_GROUP);
+		words += bits * 4;
+		available -= bits;
+	}
+	return 0;
+}
+
+// Largest LZ-compressed size of n bytes
+size_t codec_lz_bound(size_t n) {
+	return n + n / 255 + 16;
+}
+
+// Write the extra bytes of a length of 15 or more
+static uint8_t* lz_put_length(uint8_t* op, size_t len) {
+	while (len >= 255) {
+		*op++ = 255;
+		len -= 255;
+	}
+	*op++ = (uint8_t)len;
+	return op;
+}
+
+// Write one sequence: literals, then a match unless @match is 0
+static uint8_t* lz_put_sequence(uint8_t* op, const uint8_t* literals, size_t literal_len,
+				size_t offset, size_t match) {
+	size_t extra = match ? match - CODEC_LZ_MIN_MATCH : 0;
+	*op++ = (uint8_t)((literal_len < 15 ? literal_len : 15) << 4 | (extra < 15 ? extra : 15));
+	if (literal_len >= 15) {
+		op = lz_put_length(op, literal_len - 15);
+	}
+	memcpy(op, literals, literal_len);
+	op += literal_len;
+
+	if (match) {
+		*op++ = (uint8_t)offset;
+		*op++ = (uint8_t)(offset >> 8);
+		if (extra >= 15) {
+			op = lz_put_length(op, extra - 15);
+		}
+	}
+	return op;
+}
+
+// LZ77-compress bytes
+size_t codec_lz_encode(const uint8_t* in, size_t n, uint8_t* out) {
+	uint32_t table[1u << CODEC_LZ_HASH_BITS];
+	const uint8_t* ip = in;
+	const uint8_t* anchor = in;
+	const uint8_t* end = in + n;
+	const uint8_t* last = n >= CODEC_LZ_MIN_MATCH ? end - CODEC_LZ_MIN_MATCH : in;
+	uint8_t* op = out;
+
+	memset(table, 0, sizeof(table));
+	while (ip < last) {
+		uint32_t seq, ref_seq;
+		memcpy(&seq, ip, sizeof(seq));
+		uint32_t h = (seq * 2654435761u) >> (32 - CODEC_LZ_HASH_BITS);
+		const uint8_t* ref = in + table[h];
+		table[h] = (uint32_t)(ip - in);
+
+		memcpy(&ref_seq, ref, sizeof(ref_seq));
+		if (ref >= ip || ip - ref > CODEC_LZ_WINDOW || ref_seq != seq) {
+			ip++;
+			continue;
+		}
+
+		const uint8_t* match_end = ip + CODEC_LZ_MIN_MATCH;
+		ref += CODEC_LZ_MIN_MATCH;
+		while (match_end < end && *match_end == *ref) {
+			match_end++;
+			ref++;
+		}
+		op = lz_put_sequence(op, anchor, (size_t)(ip - anchor), (size_t)(match_end - ref),
+				     (size_t)(match_end - ip));
+		ip = anchor = match_end;
+	}
+	return (size_t)(lz_put_sequence(op, anchor, (size_t)(end - anchor), 0, 0) - out);
+}
+
+// Read the extra bytes of a length of 15 or more
+static int lz_get_length(const uint8_t** ip, const uint8_t* end, size_t* len) {
+	uint8_t byte;
+	do {
+		if (*ip >= end) {
+			return -1;
+		}
+		byte = *(*ip)++;
+		*len += byte;
+	} while (byte == 255);
+	return 0;
+}
+
+// Decompress bytes written by codec_lz_encode()
+int codec_lz_decode(const uint8_t* in, size_t size, uint8_t* out, size_t n) {
+	const uint8_t* ip = in;
+	const uint8_t* end = in + size;
+	uint8_t* op = out;
+	uint8_t* out_end = out + n;
+
+	while (ip < end) {
+		uint8_t token = *ip++;
+		size_t literal_len = token >> 4;
+		if (literal_len == 15 && lz_get_length(&ip, end, &literal_len) != 0) {
+			return -1;
+		}
+		if (literal_len > (size_t)(end - ip) || literal_len > (size_t)(out_end - op)) {
+			return -1;
+		}
+		memcpy(op, ip, literal_len);
+		op += literal_len;
+		ip += literal_len;
+		if (ip == end) {
+			break; // Last sequence: literals only
+		}
+
+		if (end - ip < 2) {
+			return -1;
+		}
+		size_t offset = (size_t)ip[0] | (size_t)ip[1] << 8;
+		size_t match = token & 15;
+		ip += 2;
+		if (match == 15 && lz_get_length(&ip, end, &match) != 0) {
+			return -1;
+		}
+		match += CODEC_LZ_MIN_MATCH;
+		if (offset == 0 || offset > (size_t)(op - out) || match > (size_t)(out_end - op)) {
+			return -1;
+		}
+
+		// Overlapping matches repeat the last @offset bytes
+		const uint8_t* ref = op - offset;
+		if (offset >= match) {
+			memcpy(op, ref, match);
+		} else {
+			for (size_t i = 0; i < match; i++) {
+				op[i] = ref[i];
+			}
+		}
+		op += match;
+	}
+	return op == out_end ? 0 : -1;
+}
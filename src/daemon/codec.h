@@ -0,0 +1,150 @@
+/*
+ * RAVN Column Codecs - Header File
+ *
+ * This header defines the lightweight codecs of the RAVN security platform,
+ * used to pack the columns of archived event store segments and the event
+ * batches forwarded to a collector.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The column codecs implement:
+ * - Delta + zigzag + varint coding of 64-bit timestamps: nearly monotonic
+ *   nanosecond clocks shrink to one or two bytes per value, and the rare
+ *   step backwards (events from different CPUs) costs nothing extra
+ * - Frame-of-reference bit packing of 32-bit values in groups of
+ *   CODEC_GROUP: each group stores its minimum and packs the differences in
+ *   just enough bits, so repeated PIDs, small types and dictionary codes
+ *   cost a few bits each
+ * - LZ77 byte compression of raw record batches (literal runs and matches
+ *   within CODEC_LZ_WINDOW bytes): the zero padding of fixed-size records
+ *   and the names and paths repeated across records collapse into short
+ *   back-references
+ *
+ * Architecture:
+ * - Bit-packed groups are interleaved over four lanes (value i in lane
+ *   i % 4), so packing and unpacking shift four values per vector
+ *   instruction (GCC vector extensions: SSE2 on x86-64, NEON on ARM) with
+ *   no data-dependent branches
+ * - Unpacking is specialized per bit width, letting the compiler unroll a
+ *   group into straight-line shifts and masks
+ * - No dependencies and no allocation; callers provide the buffers
+ *
+ * Packed layout of n values (G = groups of CODEC_GROUP):
+ *   uint32_t base[G], uint8_t bits[G] padded to 4 bytes,
+ *   then bits[g] * 16 bytes of lanes per group
+ *
+ * LZ layout: sequences of a token (literal length << 4 | match length - 4,
+ * 15 meaning more length bytes follow), extra literal length bytes, the
+ * literals, a uint16_t match offset and extra match length bytes; extra
+ * length bytes add up, 255 meaning another follows. The last sequence has
+ * literals only.
+ */
+
+#ifndef RAVN_CODEC_H
+#define RAVN_CODEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Column Codec Parameters
+ */
+#define CODEC_GROUP	     128   /* Values per bit-packed group */
+#define CODEC_LZ_WINDOW	     65535 /* Farthest LZ back-reference */
+#define CODEC_LZ_MIN_MATCH   4	   /* Shortest LZ match */
+#define CODEC_LZ_HASH_BITS   12	   /* LZ match finder table size (log2) */
+
+/* Values to allocate when unpacking n values (whole groups) */
+#define CODEC_PADDED(n) (((n) + CODEC_GROUP - 1) / CODEC_GROUP * CODEC_GROUP)
+
+/**
+ * codec_delta_bound - Largest delta-coded size of n timestamps
+ * @n: Number of values
+ *
+ * Return: Bytes the encoder may write
+ */
+size_t codec_delta_bound(uint32_t n);
+
+/**
+ * codec_delta_encode - Delta, zigzag and varint code 64-bit values
+ * @in: Values
+ * @n: Number of values (at least 1)
+ * @out: Output, codec_delta_bound(n) bytes
+ *
+ * Return: Bytes written
+ */
+size_t codec_delta_encode(const uint64_t* in, uint32_t n, uint8_t* out);
+
+/**
+ * codec_delta_decode - Decode values written by codec_delta_encode()
+ * @in: Encoded bytes
+ * @size: Size of @in
+ * @n: Number of values
+ * @out: Output values
+ *
+ * Return: 0 on success, -1 if @in is truncated or malformed
+ */
+int codec_delta_decode(const uint8_t* in, size_t size, uint32_t n, uint64_t* out);
+
+/**
+ * codec_pack_bound - Largest bit-packed size of n values
+ * @n: Number of values
+ *
+ * Return: Bytes the packer may write
+ */
+size_t codec_pack_bound(uint32_t n);
+
+/**
+ * codec_pack - Frame-of-reference bit pack 32-bit values
+ * @in: Values
+ * @n: Number of values
+ * @out: Output, codec_pack_bound(n) bytes, 4-byte aligned
+ *
+ * Return: Bytes written, a multiple of 4
+ */
+size_t codec_pack(const uint32_t* in, uint32_t n, uint8_t* out);
+
+/**
+ * codec_unpack - Unpack values written by codec_pack()
+ * @in: Packed bytes, 4-byte aligned
+ * @size: Size of @in
+ * @n: Number of values
+ * @out: Output, room for CODEC_PADDED(n) values
+ *
+ * Return: 0 on success, -1 if @in is truncated or malformed
+ */
+int codec_unpack(const uint8_t* in, size_t size, uint32_t n, uint32_t* out);
+
+/**
+ * codec_lz_bound - Largest LZ-compressed size of n bytes
+ * @n: Number of bytes
+ *
+ * Return: Bytes the compressor may write
+ */
+size_t codec_lz_bound(size_t n);
+
+/**
+ * codec_lz_encode - LZ77-compress bytes
+ * @in: Input bytes
+ * @n: Size of @in
+ * @out: Output, codec_lz_bound(n) bytes
+ *
+ * Return: Bytes written
+ */
+size_t codec_lz_encode(const uint8_t* in, size_t n, uint8_t* out);
+
+/**
+ * codec_lz_decode - Decompress bytes written by codec_lz_encode()
+ * @in: Compressed bytes
+ * @size: Size of @in
+ * @out: Output
+ * @n: Decompressed size, as recorded by the caller
+ *
+ * Return: 0 on success, -1 if @in is malformed or does not decompress to
+ * exactly @n bytes
+ */
+int codec_lz_decode(const uint8_t* in, size_t size, uint8_t* out, size_t n);
+
+#endif // RAVN_CODEC_H
@@ -0,0 +1,643 @@
+// RAVN Control Server Implementation
+// Line-protocol queries of live daemon state over a Unix socket
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "control.h"
+
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+#include "cgroup.h"
+#include "ebpf_handler.h"
+#include "governor.h"
+#include "placement.h"
+#include "sketch.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Most words parsed from one request line
+#define CONTROL_MAX_ARGS 16
+
+// Result lines of one response, assembled before the "OK <n>" header
+struct control_body {
+	char buf[CONTROL_MAX_RESPONSE];
+	size_t len;
+	int lines;
+	int truncated;
+};
+
+static ai_engine_t* control_engine = NULL;
+static int listen_fd = -1;
+static pthread_t control_thread;
+static volatile int control_running = 0;
+
+// Append one result line
+static void body_line(struct control_body* body, const char* fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+static void body_line(struct control_body* body, const char* fmt, ...) {
+	size_t room = sizeof(body->buf) - body->len;
+	va_list args;
+
+	va_start(args, fmt);
+	int n = vsnprintf(body->buf + body->len, room, fmt, args);
+	va_end(args);
+
+	if (n < 0 || (size_t)n + 1 >= room) {
+		body->truncated = 1;
+		return;
+	}
+	body->len += (size_t)n;
+	body->buf[body->len++] = '\n';
+	body->lines++;
+}
+
+// Parse a non-negative decimal argument
+static int parse_u32(const char* arg, uint32_t* value) {
+	char* end;
+	errno = 0;
+	unsigned long v = strtoul(arg, &end, 10);
+	if (errno || end == arg || *end || v > UINT32_MAX || arg[0] == '-') {
+		return -1;
+	}
+	*value = (uint32_t)v;
+	return 0;
+}
+
+// Parse a comma-separated list of category names into a bitmask
+static int parse_categories(const char* list, uint32_t* mask) {
+	char copy[CONTROL_MAX_LINE];
+	char* save = NULL;
+
+	snprintf(copy, sizeof(copy), "%s", list);
+	*mask = 0;
+	for (char* name = strtok_r(copy, ",", &save); name; name = strtok_r(NULL, ",", &save)) {
+		uint32_t cat;
+		for (cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+			if (strcasecmp(name, get_event_category_name(cat)) == 0) {
+				break;
+			}
+		}
+		if (cat > EVENT_CATEGORY_MAX) {
+			return -1;
+		}
+		*mask |= 1u << cat;
+	}
+	return *mask ? 0 : -1;
+}
+
+// Parse a comma-separated list of cgroup IDs
+static int parse_cgroups(const char* list, uint64_t* ids, int* count) {
+	char copy[CONTROL_MAX_LINE];
+	char* save = NULL;
+
+	snprintf(copy, sizeof(copy), "%s", list);
+	*count = 0;
+	for (char* id = strtok_r(copy, ",", &save); id; id = strtok_r(NULL, ",", &save)) {
+		char* end;
+		errno = 0;
+		unsigned long long v = strtoull(id, &end, 10);
+		if (errno || end == id || *end || v == 0 || id[0] == '-' ||
+		    *count == MONITOR_CGROUP_MAX) {
+			return -1;
+		}
+		ids[(*count)++] = (uint64_t)v;
+	}
+	return *count ? 0 : -1;
+}
+
+// Describe the current event filter as one line
+static void describe_filter(struct control_body* body) {
+	struct ebpf_event_filter filter;
+	char cats[CONTROL_MAX_LINE] = "all";
+	char cgroups[CONTROL_MAX_LINE] = "cgroup=*";
+	uint64_t ids[MONITOR_CGROUP_MAX];
+	enum cgroup_filter_mode mode;
+	size_t len = 0;
+
+	ebpf_handler_get_filter(&filter);
+	if (filter.categories) {
+		for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+			if (filter.categories & (1u << cat)) {
+				len += (size_t)snprintf(cats + len, sizeof(cats) - len, "%s%s",
+							len ? "," : "", get_event_category_name(cat));
+			}
+		}
+	}
+
+	int count = ebpf_handler_get_cgroup_filter(&mode, ids, MONITOR_CGROUP_MAX);
+	if (mode != CGROUP_FILTER_NONE) {
+		len = (size_t)snprintf(cgroups, sizeof(cgroups), "%s=",
+				       mode == CGROUP_FILTER_INCLUDE ? "cgroup" : "exclude-cgroup");
+		for (int i = 0; i < count && len < sizeof(cgroups); i++) {
+			len += (size_t)snprintf(cgroups + len, sizeof(cgroups) - len, "%s%llu",
+						i ? "," : "", (unsigned long long)ids[i]);
+		}
+	}
+	body_line(body, "category=%s pid=%u comm=%s %s", cats, filter.pid,
+		  filter.comm[0] ? filter.comm : "*", cgroups);
+}
+
+// TOP [n]
+static const char* cmd_top(ai_engine_t* engine, int argc, char** argv,
+			   struct control_body* body) {
+	uint32_t n = CONTROL_DEFAULT_TOP;
+	if (argc > 2 || (argc == 2 && parse_u32(argv[1], &n) != 0) || n == 0) {
+		return "usage: TOP [n]";
+	}
+	if (n > MAX_PROCESSES) {
+		n = MAX_PROCESSES;
+	}
+
+	struct ai_process_summary top[MAX_PROCESSES];
+	int count = ai_engine_get_top(engine, top, (int)n);
+	if (count < 0) {
+		return "AI engine unavailable";
+	}
+	for (int i = 0; i < count; i++) {
+		body_line(body, "%u %u %.4f %llu", top[i].pid, top[i].event_count,
+			  top[i].threat_score, (unsigned long long)top[i].cgroup_id);
+	}
+	return NULL;
+}
+
+// CGROUPS [n]
+static const char* cmd_cgroups(ai_engine_t* engine, int argc, char** argv,
+			       struct control_body* body) {
+	uint32_t n = CONTROL_DEFAULT_TOP;
+	if (argc > 2 || (argc == 2 && parse_u32(argv[1], &n) != 0) || n == 0) {
+		return "usage: CGROUPS [n]";
+	}
+	if (n > MAX_PROCESSES) {
+		n = MAX_PROCESSES;
+	}
+
+	struct ai_cgroup_summary cgroups[MAX_PROCESSES];
+	int count = ai_engine_get_cgroups(engine, cgroups, (int)n);
+	if (count < 0) {
+		return "AI engine unavailable";
+	}
+
+	uint64_t filtered = 0;
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		uint64_t tally[MONITOR_TALLY_MAX];
+		ebpf_handler_get_monitor_tally(cat, tally);
+		filtered += tally[MONITOR_TALLY_FILTERED];
+	}
+	body_line(body, "cgroups %d filtered %llu", count, (unsigned long long)filtered);
+
+	for (int i = 0; i < count; i++) {
+		struct cgroup_info info;
+		cgroup_lookup(cgroups[i].cgroup_id, &info);
+		body_line(body, "%llu %u %u %u %.4f %s %.12s %s %s",
+			  (unsigned long long)cgroups[i].cgroup_id, cgroups[i].process_count,
+			  cgroups[i].event_count, cgroups[i].suspicious_count,
+			  cgroups[i].threat_score, info.resolved ? info.name : "?",
+			  info.container_id[0] ? info.container_id : "-",
+			  info.pod_uid[0] ? info.pod_uid : "-", info.resolved ? info.path : "-");
+	}
+	return NULL;
+}
+
+// FEATURES <pid>
+static const char* cmd_features(ai_engine_t* engine, int argc, char** argv,
+				struct control_body* body) {
+	uint32_t pid;
+	if (argc != 2 || parse_u32(argv[1], &pid) != 0) {
+		return "usage: FEATURES <pid>";
+	}
+	if (!engine) {
+		return "AI engine unavailable";
+	}
+
+	float features[TOTAL_FEATURES];
+	if (ai_engine_get_features(engine, pid, features) != 0) {
+		return "process not in the AI window";
+	}
+
+	char line[TOTAL_FEATURES * 8];
+	size_t len = 0;
+	for (int i = 0; i < TOTAL_FEATURES && len < sizeof(line); i++) {
+		len += (size_t)snprintf(line + len, sizeof(line) - len, "%s%.4f", i ? " " : "",
+					features[i]);
+	}
+	body_line(body, "%s", line);
+	return NULL;
+}
+
+// MONITORS
+static const char* cmd_monitors(int argc, struct control_body* body) {
+	if (argc != 1) {
+		return "usage: MONITORS";
+	}
+
+	struct ebpf_monitor_stats stats[EVENT_CATEGORY_MAX + 1];
+	ebpf_handler_get_monitor_stats(stats);
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		const struct ebpf_monitor_stats* st = &stats[cat];
+		float fill = st->ring_size ? 100.0f * (float)st->ring_avail / (float)st->ring_size
+					   : 0.0f;
+		body_line(body, "%s %llu %llu %llu %llu %.1f", st->name,
+			  (unsigned long long)st->events, (unsigned long long)st->handler_ns,
+			  (unsigned long long)st->run_cnt, (unsigned long long)st->run_time_ns, fill);
+	}
+	return NULL;
+}
+
+// GOVERNOR
+static const char* cmd_governor(int argc, struct control_body* body) {
+	if (argc != 1) {
+		return "usage: GOVERNOR";
+	}
+
+	struct governor_state state;
+	char from_name[GOVERNOR_NAME_LEN], to_name[GOVERNOR_NAME_LEN];
+	governor_get_state(&state);
+	if (!state.active) {
+		return "no CPU budget configured";
+	}
+
+	body_line(body, "level %s user %.2f/%.2f bpf %.2f/%.2f transitions %llu",
+		  governor_level_name(state.level, to_name, sizeof(to_name)), state.user_pct,
+		  state.user_budget, state.bpf_pct, state.bpf_budget,
+		  (unsigned long long)state.transitions);
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		uint64_t tally[MONITOR_TALLY_MAX];
+		ebpf_handler_get_monitor_tally(cat, tally);
+		body_line(body, "%s %s %llu %llu", get_event_category_name(cat),
+			  governor_monitor_state(cat),
+			  (unsigned long long)tally[MONITOR_TALLY_SAMPLED],
+			  (unsigned long long)tally[MONITOR_TALLY_AGGREGATED]);
+	}
+	for (int i = 0; i < state.history_count; i++) {
+		const struct governor_transition* t = &state.history[i];
+		body_line(body, "%ld %s->%s user %.2f bpf %.2f", (long)t->time,
+			  governor_level_name(t->from, from_name, sizeof(from_name)),
+			  governor_level_name(t->to, to_name, sizeof(to_name)), t->user_pct,
+			  t->bpf_pct);
+	}
+	return NULL;
+}
+
+// FILTER [OFF | category=a,b pid=N comm=NAME cgroup=ID,.. | exclude-cgroup=ID,..]
+static const char* cmd_filter(int argc, char** argv, struct control_body* body) {
+	if (argc == 2 && strcasecmp(argv[1], "off") == 0) {
+		ebpf_handler_set_filter(NULL);
+		if (ebpf_handler_set_cgroup_filter(CGROUP_FILTER_NONE, NULL, 0) != 0) {
+			return "cgroup filter update failed";
+		}
+		LOG_INFO_MODULE("CONTROL", "Event filter cleared");
+	} else if (argc > 1) {
+		struct ebpf_event_filter filter;
+		enum cgroup_filter_mode mode = CGROUP_FILTER_NONE;
+		uint64_t ids[MONITOR_CGROUP_MAX];
+		int count = 0;
+		memset(&filter, 0, sizeof(filter));
+
+		for (int i = 1; i < argc; i++) {
+			char* value = strchr(argv[i], '=');
+			if (!value) {
+				return "usage: FILTER [OFF | category=a,b pid=N comm=NAME "
+				       "cgroup=ID,.. | exclude-cgroup=ID,..]";
+			}
+			*value++ = '\0';
+			if (strcasecmp(argv[i], "category") == 0) {
+				if (parse_categories(value, &filter.categories) != 0) {
+					return "unknown category";
+				}
+			} else if (strcasecmp(argv[i], "pid") == 0) {
+				if (parse_u32(value, &filter.pid) != 0) {
+					return "invalid pid";
+				}
+			} else if (strcasecmp(argv[i], "comm") == 0) {
+				snprintf(filter.comm, sizeof(filter.comm), "%s", value);
+			} else if (strcasecmp(argv[i], "cgroup") == 0 ||
+				   strcasecmp(argv[i], "exclude-cgroup") == 0) {
+				if (mode != CGROUP_FILTER_NONE) {
+					return "only one of cgroup and exclude-cgroup";
+				}
+				if (parse_cgroups(value, ids, &count) != 0) {
+					return "invalid cgroup list";
+				}
+				mode = strcasecmp(argv[i], "cgroup") == 0 ? CGROUP_FILTER_INCLUDE
+									  : CGROUP_FILTER_EXCLUDE;
+			} else {
+				return "unknown filter key";
+			}
+		}
+		ebpf_handler_set_filter(&filter);
+		if (ebpf_handler_set_cgroup_filter(mode, ids, count) != 0) {
+			return "cgroup filter update failed";
+		}
+		LOG_INFO_MODULE("CONTROL", "Event filter set");
+	}
+
+	describe_filter(body);
+	return NULL;
+}
+
+// RELOAD
+static const char* cmd_reload(ai_engine_t* engine, int argc) {
+	if (argc != 1) {
+		return "usage: RELOAD";
+	}
+	if (ai_engine_reload_model(engine) != 0) {
+		return "model reload failed";
+	}
+	return NULL;
+}
+
+// SKETCH <process|file|port|user> [n]
+static const char* cmd_sketch(int argc, char** argv, struct control_body* body) {
+	uint32_t n = SKETCH_TOP_K;
+	int dim = argc >= 2 ? sketch_dimension_from_name(argv[1]) : -1;
+	if (argc > 3 || dim < 0 || (argc == 3 && parse_u32(argv[2], &n) != 0) || n == 0) {
+		return "usage: SKETCH <process|file|port|user> [n]";
+	}
+	if (n > SKETCH_TOP_K) {
+		n = SKETCH_TOP_K;
+	}
+
+	struct sketch_item items[SKETCH_TOP_K];
+	int count = sketch_get_top((enum sketch_dimension)dim, items, (int)n);
+	body_line(body, "distinct %llu total %llu",
+		  (unsigned long long)sketch_distinct((enum sketch_dimension)dim),
+		  (unsigned long long)sketch_total((enum sketch_dimension)dim));
+	for (int i = 0; i < count; i++) {
+		body_line(body, "%s %llu %llu", items[i].key, (unsigned long long)items[i].count,
+			  (unsigned long long)items[i].error);
+	}
+	return NULL;
+}
+
+// PROFILE
+static const char* cmd_profile(int argc, struct control_body* body) {
+	char report[CONTROL_MAX_RESPONSE];
+	char* save = NULL;
+
+	if (argc != 1) {
+		return "usage: PROFILE";
+	}
+	if (!ravn_prof_enabled()) {
+		return "profiling disabled (start the daemon with -p)";
+	}
+
+	// One result line per report line: the header, then one per timer site
+	ravn_prof_format(report, sizeof(report));
+	for (char* line = strtok_r(report, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+		body_line(body, "%s", line);
+	}
+	return NULL;
+}
+
+// HELP
+static void cmd_help(struct control_body* body) {
+	body_line(body, "TOP [n]            highest scoring processes: pid events score cgroup");
+	body_line(body, "CGROUPS [n]        highest scoring cgroups with their container and pod");
+	body_line(body, "FEATURES <pid>     feature vector of a process in the AI window");
+	body_line(body, "MONITORS           name events handler_ns run_cnt run_time_ns ring_fill%%");
+	body_line(body, "GOVERNOR           budget level, monitor states and recent transitions");
+	body_line(body, "FILTER [OFF | category=a,b pid=N comm=NAME cgroup=ID,.. | "
+			"exclude-cgroup=ID,..]  show or set the filter");
+	body_line(body, "SKETCH <dim> [n]   heavy hitters of process|file|port|user: key count error");
+	body_line(body, "PROFILE            timer sites: count, total, avg, min, p50, p99, max");
+	body_line(body, "RELOAD             reload the model and restart the AI window");
+	body_line(body, "PING               check the server");
+}
+
+// Run one control command
+size_t control_execute(ai_engine_t* engine, const char* request, char* response, size_t size) {
+	char line[CONTROL_MAX_LINE];
+	char* argv[CONTROL_MAX_ARGS];
+	char* save = NULL;
+	int argc = 0;
+
+	if (!response || size == 0) {
+		return 0;
+	}
+
+	snprintf(line, sizeof(line), "%s", request ? request : "");
+	for (char* word = strtok_r(line, " \t\r", &save); word && argc < CONTROL_MAX_ARGS;
+	     word = strtok_r(NULL, " \t\r", &save)) {
+		argv[argc++] = word;
+	}
+
+	struct control_body* body = malloc(sizeof(*body));
+	if (!body) {
+		return (size_t)snprintf(response, size, "ERR out of memory\n");
+	}
+	body->len = 0;
+	body->lines = 0;
+	body->truncated = 0;
+
+	const char* error = NULL;
+	if (argc == 0) {
+		error = "empty request";
+	} else if (strcasecmp(argv[0], "PING") == 0) {
+		error = argc == 1 ? NULL : "usage: PING";
+	} else if (strcasecmp(argv[0], "TOP") == 0) {
+		error = cmd_top(engine, argc, argv, body);
+	} else if (strcasecmp(argv[0], "CGROUPS") == 0) {
+		error = cmd_cgroups(engine, argc, argv, body);
+	} else if (strcasecmp(argv[0], "FEATURES") == 0) {
+		error = cmd_features(engine, argc, argv, body);
+	} else if (strcasecmp(argv[0], "MONITORS") == 0) {
+		error = cmd_monitors(argc, body);
+	} else if (strcasecmp(argv[0], "GOVERNOR") == 0) {
+		error = cmd_governor(argc, body);
+	} else if (strcasecmp(argv[0], "FILTER") == 0) {
+		error = cmd_filter(argc, argv, body);
+	} else if (strcasecmp(argv[0], "SKETCH") == 0) {
+		error = cmd_sketch(argc, argv, body);
+	} else if (strcasecmp(argv[0], "PROFILE") == 0) {
+		error = cmd_profile(argc, body);
+	} else if (strcasecmp(argv[0], "RELOAD") == 0) {
+		error = cmd_reload(engine, argc);
+	} else if (strcasecmp(argv[0], "HELP") == 0) {
+		cmd_help(body);
+	} else {
+		error = "unknown command (try HELP)";
+	}
+
+	size_t len;
+	if (!error && body->truncated) {
+		error = "response too large";
+	}
+	if (error) {
+		len = (size_t)snprintf(response, size, "ERR %s\n", error);
+	} else {
+		len = (size_t)snprintf(response, size, "OK %d\n", body->lines);
+		if (len + body->len < size) {
+			memcpy(response + len, body->buf, body->len);
+			len += body->len;
+		} else {
+			len = (size_t)snprintf(response, size, "ERR response too large\n");
+		}
+	}
+	free(body);
+	return len < size ? len : size - 1;
+}
+
+// Write a whole buffer, retrying on short writes
+static int write_all(int fd, const char* buf, size_t len) {
+	while (len > 0) {
+		ssize_t n = write(fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		buf += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+// Answer the requests of one connection until it closes or stalls
+static void control_serve_client(int fd) {
+	struct timeval timeout = {CONTROL_CLIENT_TIMEOUT_MS / 1000,
+				  (CONTROL_CLIENT_TIMEOUT_MS % 1000) * 1000};
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+	char* response = malloc(CONTROL_MAX_RESPONSE + CONTROL_MAX_LINE);
+	if (!response) {
+		return;
+	}
+
+	char request[CONTROL_MAX_LINE];
+	size_t used = 0;
+	while (control_running) {
+		ssize_t n = read(fd, request + used, sizeof(request) - used);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			break;
+		}
+		used += (size_t)n;
+
+		// Answer every complete line in the buffer
+		char* start = request;
+		char* newline;
+		while ((newline = memchr(start, '\n', used - (size_t)(start - request)))) {
+			*newline = '\0';
+			size_t len = control_execute(control_engine, start, response,
+						     CONTROL_MAX_RESPONSE + CONTROL_MAX_LINE);
+			if (write_all(fd, response, len) != 0) {
+				free(response);
+				return;
+			}
+			start = newline + 1;
+		}
+
+		used -= (size_t)(start - request);
+		memmove(request, start, used);
+		if (used == sizeof(request)) {
+			static const char too_long[] = "ERR request too long\n";
+			write_all(fd, too_long, sizeof(too_long) - 1);
+			break;
+		}
+	}
+	free(response);
+}
+
+// Control thread: accept and serve connections one at a time
+static void* control_thread_func(void* arg) {
+	(void)arg;
+	prctl(PR_SET_NAME, "ravn-control", 0, 0, 0);
+	placement_apply(PLACEMENT_BACKGROUND);
+
+	while (control_running) {
+		int fd = accept(listen_fd, NULL, NULL);
+		if (fd < 0) {
+			if (!control_running) {
+				break;
+			}
+			if (errno != EINTR && errno != ECONNABORTED) {
+				LOG_WARN_MODULE("CONTROL", "accept failed: %s", strerror(errno));
+				usleep(100000);
+			}
+			continue;
+		}
+
+		control_serve_client(fd);
+		close(fd);
+	}
+
+	return NULL;
+}
+
+// Start the control server
+int control_init(ai_engine_t* engine) {
+	if (control_running) {
+		return 0;
+	}
+
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", CONTROL_SOCKET_PATH);
+
+	listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (listen_fd < 0) {
+		LOG_ERROR_MODULE("CONTROL", "Failed to create socket: %s", strerror(errno));
+		return -1;
+	}
+
+	// Root-only: the socket accepts control commands
+	unlink(CONTROL_SOCKET_PATH);
+	mode_t old_mask = umask(0077);
+	int bound = bind(listen_fd, (struct sockaddr*)&addr, sizeof(addr));
+	umask(old_mask);
+	if (bound != 0 || listen(listen_fd, CONTROL_BACKLOG) != 0) {
+		LOG_ERROR_MODULE("CONTROL", "Failed to listen on %s: %s", CONTROL_SOCKET_PATH,
+				 strerror(errno));
+		close(listen_fd);
+		listen_fd = -1;
+		unlink(CONTROL_SOCKET_PATH);
+		return -1;
+	}
+
+	control_engine = engine;
+	control_running = 1;
+	if (pthread_create(&control_thread, NULL, control_thread_func, NULL) != 0) {
+		control_running = 0;
+		LOG_ERROR_MODULE("CONTROL", "Failed to create control thread");
+		close(listen_fd);
+		listen_fd = -1;
+		unlink(CONTROL_SOCKET_PATH);
+		return -1;
+	}
+
+	return 0;
+}
+
+// Stop the control server and remove its socket
+void control_cleanup(void) {
+	if (!control_running) {
+		return;
+	}
+
+	// Shutting the listening socket down wakes the blocked accept()
+	control_running = 0;
+	shutdown(listen_fd, SHUT_RDWR);
+	pthread_join(control_thread, NULL);
+
+	close(listen_fd);
+	listen_fd = -1;
+	unlink(CONTROL_SOCKET_PATH);
+	control_engine = NULL;
+}
@@ -0,0 +1,82 @@
+/*
+ * RAVN Control Server - Header File
+ *
+ * This header defines the local control and query server of the RAVN
+ * security platform, which exposes live in-memory daemon state that is
+ * never pushed to Redis (per-process windows, feature vectors, monitor
+ * counters) and accepts runtime control commands.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The control server implements:
+ * - A Unix stream socket at CONTROL_SOCKET_PATH, accessible to root only
+ * - A line protocol: one command per line, answered with "OK <n>" and n
+ *   result lines, or with "ERR <reason>"
+ * - TOP [n]: highest scoring processes of the AI window
+ * - CGROUPS [n]: highest scoring cgroups of the AI window with their container
+ * - FEATURES <pid>: feature vector of one tracked process
+ * - MONITORS: per-monitor event, handler and BPF run-time counters
+ * - GOVERNOR: CPU budget level, monitor states and recent transitions
+ * - FILTER [OFF | key=value ...]: show or set the event delivery filter and
+ *   the cgroup filter of the BPF monitors
+ * - SKETCH <dim> [n]: heavy hitters and distinct count of a sketch dimension
+ * - PROFILE: timer profiling report (daemon started with -p)
+ * - RELOAD: reload the model weights and restart the AI window
+ * - PING, HELP
+ *
+ * Architecture:
+ * - A dedicated control thread accepts connections and serves them in turn;
+ *   a connection may send any number of commands
+ * - Queries work on copies: the AI window lock is held only while the
+ *   process list or one sequence is copied, and monitor counters are read
+ *   with relaxed atomic loads, so the event path is never held up by
+ *   formatting or socket I/O
+ * - Clients that stall are dropped after CONTROL_CLIENT_TIMEOUT_MS
+ */
+
+#ifndef RAVN_CONTROL_H
+#define RAVN_CONTROL_H
+
+#include "ai_engine.h"
+
+/*
+ * Control Server Configuration Parameters
+ */
+#define CONTROL_SOCKET_PATH	  "/run/ravn.sock" /* Listening socket */
+#define CONTROL_BACKLOG		  8		   /* Pending connections */
+#define CONTROL_MAX_LINE	  256		   /* Longest request line */
+#define CONTROL_MAX_RESPONSE	  16384		   /* Largest response */
+#define CONTROL_CLIENT_TIMEOUT_MS 1000		   /* Idle client limit */
+#define CONTROL_DEFAULT_TOP	  10		   /* TOP without a count */
+
+/**
+ * control_init - Start the control server
+ * @engine: AI engine queried by TOP, FEATURES and RELOAD (may be NULL)
+ *
+ * Replaces a stale socket left by a previous daemon.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int control_init(ai_engine_t* engine);
+
+/**
+ * control_cleanup - Stop the control server and remove its socket
+ */
+void control_cleanup(void);
+
+/**
+ * control_execute - Run one control command
+ * @engine: AI engine to query (may be NULL)
+ * @request: Command line without the trailing newline
+ * @response: Output buffer for the complete response
+ * @size: Size of @response
+ *
+ * Used by the server for every request line; does not touch the socket.
+ *
+ * Return: Length of the response written to @response
+ */
+size_t control_execute(ai_engine_t* engine, const char* request, char* response, size_t size);
+
+#endif // RAVN_CONTROL_H
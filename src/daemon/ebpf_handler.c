@@ -1,9 +1,17 @@
 // RAVN eBPF Handler Implementation
 // Real eBPF-based system monitoring with ring buffer collection
 
+#define _POSIX_C_SOURCE 200809L
 #include "ebpf_handler.h"
 
+#include "../utils/error_handling.h"
 #include "../utils/logger.h"
+#include "forward.h"
+#include "health.h"
+#include "placement.h"
+#include "sketch.h"
+#include "store.h"
+#include "trace.h"
 
 #include <bpf/bpf.h>
 #include <bpf/libbpf.h>
@@ -13,6 +21,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/prctl.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <sys/wait.h>
@@ -39,6 +48,8 @@ static struct ring_buffer* kernel_rb = NULL;
 static struct ring_buffer* performance_rb = NULL;
 
 static int monitoring_active = 0;
+static int monitoring_thread_running = 0;
+static int monitoring_thread_exited = 0;
 static pthread_t monitoring_thread;
 
 // External Redis connection (set by main.c)
@@ -48,6 +59,82 @@ extern void* global_redis_conn_ptr;
 int redis_send_event(void* conn, const struct ravn_event* event);
 char* redis_get_last_error(void);
 
+// Cumulative traffic reported by the network monitor
+static uint64_t net_bytes_sent = 0;
+static uint64_t net_bytes_received = 0;
+
+// Decoded event tap (replay drives the AI engine from here)
+static ebpf_event_tap_fn event_tap = NULL;
+static void* event_tap_ctx = NULL;
+
+// Host of the records being dispatched, NULL for this host (set by the collector)
+static const char* event_origin = NULL;
+
+// Event delivery filter, seqlock-protected (odd sequence while written)
+static struct ebpf_event_filter event_filter;
+static uint32_t filter_seq = 0;
+static int filter_active = 0;
+static pthread_mutex_t filter_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// cgroup filter written to every monitor; the IDs are kept to clear them on the next change
+static enum cgroup_filter_mode cgroup_filter_mode = CGROUP_FILTER_NONE;
+static uint64_t cgroup_filter_ids[MONITOR_CGROUP_MAX];
+static int cgroup_filter_count = 0;
+static pthread_mutex_t cgroup_filter_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Check a decoded event against the delivery filter
+static int event_filtered_out(const struct ravn_event* event) {
+	if (!__atomic_load_n(&filter_active, __ATOMIC_ACQUIRE)) {
+		return 0;
+	}
+
+	struct ebpf_event_filter filter;
+	ebpf_handler_get_filter(&filter);
+
+	if (filter.categories && !(filter.categories & (1u << event->event_category))) {
+		return 1;
+	}
+	if (filter.pid && filter.pid != event->pid) {
+		return 1;
+	}
+	if (filter.comm[0] && strncmp(filter.comm, event->comm, sizeof(filter.comm)) != 0) {
+		return 1;
+	}
+	return 0;
+}
+
+// Count a numeric key (port, user ID) in an activity sketch
+static void sketch_observe_number(enum sketch_dimension dim, uint32_t value) {
+	char key[16];
+	snprintf(key, sizeof(key), "%u", value);
+	sketch_observe(dim, key);
+}
+
+// Deliver a decoded event to the event store, Redis and the event tap
+static void emit_event(const struct ravn_event* event, const char* path, uint32_t uid) {
+	// Sketches and the event store see all activity, filtered or not
+	sketch_observe(SKETCH_PROCESS, event->comm);
+	store_append(event->timestamp, event->pid, uid, event->event_type, event->event_category,
+		     event->comm, path, event_origin);
+
+	if (event_filtered_out(event)) {
+		return;
+	}
+
+	if (global_redis_conn_ptr) {
+		int result = redis_send_event(global_redis_conn_ptr, event);
+		if (result != 0) {
+			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send %s event: %s",
+					 get_event_category_name(event->event_category),
+					 redis_get_last_error());
+		}
+	}
+
+	if (event_tap) {
+		event_tap(event, event_tap_ctx);
+	}
+}
+
 // Ring buffer event handlers
 static int handle_syscall_event(void* ctx, void* data, size_t data_sz) {
 	const struct syscall_event* event = (const struct syscall_event*)data;
@@ -57,12 +144,15 @@ static int handle_syscall_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->syscall_nr,
-					.event_category = 1, // Syscall category
+					.event_category = EVENT_CATEGORY_SYSCALL,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -74,18 +164,15 @@ static int handle_syscall_event(void* ctx, void* data, size_t data_sz) {
 		 "ebpf\":true}",
 		 get_syscall_name(event->syscall_nr), event->filename, event->ret);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send syscall event: %s",
-					 redis_get_last_error());
-		}
-	}
+	sketch_observe_process_file(event->pid, event->filename);
+
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, event->filename, STORE_UID_NONE);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Syscall event: PID=%u, Syscall=%s, File=%s", event->pid,
 			get_syscall_name(event->syscall_nr), event->filename);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_syscall_event");
 	return 0;
 }
 
@@ -97,12 +184,15 @@ static int handle_network_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 2, // Network category
+					.event_category = EVENT_CATEGORY_NETWORK,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -120,15 +210,16 @@ static int handle_network_event(void* ctx, void* data, size_t data_sz) {
 		 (event->dst_ip >> 16) & 0xFF, (event->dst_ip >> 8) & 0xFF, event->dst_ip & 0xFF,
 		 event->src_port, event->dst_port, event->bytes_sent, event->bytes_received);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send network event: %s",
-					 redis_get_last_error());
-		}
+	__atomic_fetch_add(&net_bytes_sent, event->bytes_sent, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&net_bytes_received, event->bytes_received, __ATOMIC_RELAXED);
+
+	if (event->dst_port) {
+		sketch_observe_number(SKETCH_PORT, event->dst_port);
 	}
 
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, NULL, STORE_UID_NONE);
+
 	LOG_INFO_MODULE("eBPF-HANDLER",
 			"Network event: PID=%u, Type=%s, Src=%u.%u.%u.%u:%u, "
 			"Dst=%u.%u.%u.%u:%u, Sent=%u, Recv=%u",
@@ -139,6 +230,7 @@ static int handle_network_event(void* ctx, void* data, size_t data_sz) {
 			(event->dst_ip >> 8) & 0xFF, event->dst_ip & 0xFF, event->dst_port,
 			event->bytes_sent, event->bytes_received);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_network_event");
 	return 0;
 }
 
@@ -150,12 +242,15 @@ static int handle_security_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 3, // Security category
+					.event_category = EVENT_CATEGORY_SECURITY,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -168,19 +263,17 @@ static int handle_security_event(void* ctx, void* data, size_t data_sz) {
 		 get_security_event_name(event->event_type), event->target_pid, event->uid,
 		 event->gid, event->mode, event->pathname);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send security event: %s",
-					 redis_get_last_error());
-		}
-	}
+	sketch_observe_process_file(event->pid, event->pathname);
+	sketch_observe_number(SKETCH_USER, event->uid);
+
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, event->pathname, event->uid);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Security event: PID=%u, Type=%s, Target=%u, Path=%s",
 			event->pid, get_security_event_name(event->event_type), event->target_pid,
 			event->pathname);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_security_event");
 	return 0;
 }
 
@@ -192,12 +285,15 @@ static int handle_file_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 4, // File category
+					.event_category = EVENT_CATEGORY_FILE,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -211,18 +307,15 @@ static int handle_file_event(void* ctx, void* data, size_t data_sz) {
 		 get_file_event_name(event->event_type), event->fd, event->flags, event->mode,
 		 event->size, event->filename, event->target_filename);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send file event: %s",
-					 redis_get_last_error());
-		}
-	}
+	sketch_observe_process_file(event->pid, event->filename);
+
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, event->filename, STORE_UID_NONE);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "File event: PID=%u, Type=%s, FD=%u, File=%s", event->pid,
 			get_file_event_name(event->event_type), event->fd, event->filename);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_file_event");
 	return 0;
 }
 
@@ -234,12 +327,15 @@ static int handle_memory_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 5, // Memory category
+					.event_category = EVENT_CATEGORY_MEMORY,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -253,19 +349,14 @@ static int handle_memory_event(void* ctx, void* data, size_t data_sz) {
 		 get_memory_event_name(event->event_type), event->address, event->size,
 		 event->permissions, event->flags, event->filename);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send memory event: %s",
-					 redis_get_last_error());
-		}
-	}
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, event->filename, STORE_UID_NONE);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Memory event: PID=%u, Type=%s, Address=0x%lx, Size=%lu",
 			event->pid, get_memory_event_name(event->event_type), event->address,
 			event->size);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_memory_event");
 	return 0;
 }
 
@@ -277,12 +368,15 @@ static int handle_process_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 6, // Process category
+					.event_category = EVENT_CATEGORY_PROCESS,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -298,19 +392,16 @@ static int handle_process_event(void* ctx, void* data, size_t data_sz) {
 		 event->euid, event->egid, event->suid, event->sgid, event->capabilities,
 		 event->filename, event->working_dir, event->command_line);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send process event: %s",
-					 redis_get_last_error());
-		}
-	}
+	sketch_observe_number(SKETCH_USER, event->uid);
+
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, event->filename, event->uid);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Process event: PID=%u, Type=%s, PPID=%u, File=%s",
 			event->pid, get_process_event_name(event->event_type), event->ppid,
 			event->filename);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_process_event");
 	return 0;
 }
 
@@ -322,12 +413,15 @@ static int handle_kernel_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 7, // Kernel category
+					.event_category = EVENT_CATEGORY_KERNEL,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -342,19 +436,14 @@ static int handle_kernel_event(void* ctx, void* data, size_t data_sz) {
 		 event->size, event->flags, event->module_name, event->function_name,
 		 event->filename);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send kernel event: %s",
-					 redis_get_last_error());
-		}
-	}
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, event->filename, STORE_UID_NONE);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Kernel event: PID=%u, Type=%s, CPU=%u, Module=%s",
 			event->pid, get_kernel_event_name(event->event_type), event->cpu_id,
 			event->module_name);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_kernel_event");
 	return 0;
 }
 
@@ -366,12 +455,15 @@ static int handle_performance_event(void* ctx, void* data, size_t data_sz) {
 		return 0;
 	}
 
+	RAVN_TIME_START(handler);
+
 	// Convert to generic ravn_event
 	struct ravn_event ravn_event = {.timestamp = event->timestamp,
 					.pid = event->pid,
 					.tid = event->tid,
 					.event_type = event->event_type,
-					.event_category = 8, // Performance category
+					.event_category = EVENT_CATEGORY_PERFORMANCE,
+					.cgroup_id = event->cgroup_id,
 					.comm = {0}};
 
 	strncpy(ravn_event.comm, event->comm, sizeof(ravn_event.comm) - 1);
@@ -385,75 +477,217 @@ static int handle_performance_event(void* ctx, void* data, size_t data_sz) {
 		 get_performance_event_name(event->event_type), event->cpu_id, event->value,
 		 event->threshold, event->flags, event->device_name, event->metric_name);
 
-	// Send to Redis
-	if (global_redis_conn_ptr) {
-		int result = redis_send_event(global_redis_conn_ptr, &ravn_event);
-		if (result != 0) {
-			LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to send performance event: %s",
-					 redis_get_last_error());
-		}
-	}
+	// Send to Redis and the event tap
+	emit_event(&ravn_event, NULL, STORE_UID_NONE);
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Performance event: PID=%u, Type=%s, CPU=%u, Value=%lu",
 			event->pid, get_performance_event_name(event->event_type), event->cpu_id,
 			event->value);
 
+	RAVN_TIME_END(handler, "eBPF-HANDLER", "handle_performance_event");
 	return 0;
 }
 
+// Per-monitor dispatch slot: ring buffer handler plus cost accounting
+struct monitor_slot {
+	uint32_t category;		/* Event category */
+	ring_buffer_sample_fn handler;	/* Category handler */
+	uint64_t events;		/* Delivered records */
+	uint64_t handler_ns;		/* Time spent in handler */
+};
+
+static struct monitor_slot monitor_slots[EVENT_CATEGORY_MAX + 1] = {
+	[EVENT_CATEGORY_SYSCALL] = {EVENT_CATEGORY_SYSCALL, handle_syscall_event, 0, 0},
+	[EVENT_CATEGORY_NETWORK] = {EVENT_CATEGORY_NETWORK, handle_network_event, 0, 0},
+	[EVENT_CATEGORY_SECURITY] = {EVENT_CATEGORY_SECURITY, handle_security_event, 0, 0},
+	[EVENT_CATEGORY_FILE] = {EVENT_CATEGORY_FILE, handle_file_event, 0, 0},
+	[EVENT_CATEGORY_MEMORY] = {EVENT_CATEGORY_MEMORY, handle_memory_event, 0, 0},
+	[EVENT_CATEGORY_PROCESS] = {EVENT_CATEGORY_PROCESS, handle_process_event, 0, 0},
+	[EVENT_CATEGORY_KERNEL] = {EVENT_CATEGORY_KERNEL, handle_kernel_event, 0, 0},
+	[EVENT_CATEGORY_PERFORMANCE] = {EVENT_CATEGORY_PERFORMANCE, handle_performance_event, 0,
+					0},
+};
+
+// Ring buffer callback: run the category handler and account its cost
+static int dispatch_monitor_event(void* ctx, void* data, size_t data_sz) {
+	struct monitor_slot* slot = (struct monitor_slot*)ctx;
+	uint64_t start = ravn_prof_now_ns();
+
+	trace_record_append(slot->category, data, (uint32_t)data_sz);
+	forward_record(slot->category, data, (uint32_t)data_sz);
+
+	int ret = slot->handler(NULL, data, data_sz);
+
+	__atomic_fetch_add(&slot->events, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&slot->handler_ns, ravn_prof_now_ns() - start, __ATOMIC_RELAXED);
+	return ret;
+}
+
+// Current record size of each category
+static const size_t record_sizes[EVENT_CATEGORY_MAX + 1] = {
+	[EVENT_CATEGORY_SYSCALL] = sizeof(struct syscall_event),
+	[EVENT_CATEGORY_NETWORK] = sizeof(struct network_event),
+	[EVENT_CATEGORY_SECURITY] = sizeof(struct security_event),
+	[EVENT_CATEGORY_FILE] = sizeof(struct file_event),
+	[EVENT_CATEGORY_MEMORY] = sizeof(struct memory_event),
+	[EVENT_CATEGORY_PROCESS] = sizeof(struct process_event),
+	[EVENT_CATEGORY_KERNEL] = sizeof(struct kernel_event),
+	[EVENT_CATEGORY_PERFORMANCE] = sizeof(struct performance_event),
+};
+
+// Room for a record of any category
+union monitor_record {
+	struct syscall_event syscall;
+	struct network_event network;
+	struct security_event security;
+	struct file_event file;
+	struct memory_event memory;
+	struct process_event process;
+	struct kernel_event kernel;
+	struct performance_event performance;
+};
+
+// Per-ring poll timeout; eight rings are polled in turn each pass
+#define RING_POLL_TIMEOUT_MS 100
+
+// Install or clear the decoded event tap
+void ebpf_handler_set_event_tap(ebpf_event_tap_fn tap, void* ctx) {
+	event_tap_ctx = ctx;
+	event_tap = tap;
+}
+
+// Attribute the records dispatched next to a host
+void ebpf_handler_set_origin(const char* host) {
+	event_origin = host;
+}
+
+// Cut every string of a record at its last byte; the handlers print them with %s
+static void terminate_strings(uint32_t category, union monitor_record* r) {
+#define TERMINATE(field) ((field)[sizeof(field) - 1] = '\0')
+	switch (category) {
+	case EVENT_CATEGORY_SYSCALL:
+		TERMINATE(r->syscall.comm);
+		TERMINATE(r->syscall.filename);
+		break;
+	case EVENT_CATEGORY_NETWORK:
+		TERMINATE(r->network.comm);
+		break;
+	case EVENT_CATEGORY_SECURITY:
+		TERMINATE(r->security.comm);
+		TERMINATE(r->security.target_comm);
+		TERMINATE(r->security.pathname);
+		break;
+	case EVENT_CATEGORY_FILE:
+		TERMINATE(r->file.comm);
+		TERMINATE(r->file.filename);
+		TERMINATE(r->file.target_filename);
+		break;
+	case EVENT_CATEGORY_MEMORY:
+		TERMINATE(r->memory.comm);
+		TERMINATE(r->memory.filename);
+		break;
+	case EVENT_CATEGORY_PROCESS:
+		TERMINATE(r->process.comm);
+		TERMINATE(r->process.parent_comm);
+		TERMINATE(r->process.filename);
+		TERMINATE(r->process.working_dir);
+		TERMINATE(r->process.command_line);
+		break;
+	case EVENT_CATEGORY_KERNEL:
+		TERMINATE(r->kernel.comm);
+		TERMINATE(r->kernel.module_name);
+		TERMINATE(r->kernel.function_name);
+		TERMINATE(r->kernel.filename);
+		break;
+	case EVENT_CATEGORY_PERFORMANCE:
+		TERMINATE(r->performance.comm);
+		TERMINATE(r->performance.device_name);
+		TERMINATE(r->performance.metric_name);
+		break;
+	}
+#undef TERMINATE
+}
+
+// Feed one raw record through the live dispatch path
+int ebpf_handler_dispatch_record(uint32_t category, void* data, size_t size) {
+	union monitor_record record;
+	size_t record_size;
+
+	if (category == 0 || category > EVENT_CATEGORY_MAX) {
+		return -1;
+	}
+	record_size = record_sizes[category];
+	if (size + sizeof(uint64_t) < record_size) {
+		// Too short for any layout: the handler rejects it
+		return dispatch_monitor_event(&monitor_slots[category], data, size);
+	}
+
+	// Traces and agents are not the kernel: their strings may lack the NUL.
+	// Traces taken before records carried the cgroup ID end where it starts;
+	// widen them with an unknown (zero) cgroup
+	memset(&record, 0, sizeof(record));
+	memcpy(&record, data, size < record_size ? size : record_size);
+	terminate_strings(category, &record);
+	return dispatch_monitor_event(&monitor_slots[category], &record, record_size);
+}
+
 // Ring buffer polling thread
 static void* ring_buffer_poll_thread(void* arg) {
 	(void)arg;
 
+	prctl(PR_SET_NAME, "ravn-ringbuf", 0, 0, 0);
+	placement_apply(PLACEMENT_RINGBUF);
 	LOG_INFO_MODULE("eBPF-HANDLER", "Ring buffer polling thread started");
 
 	while (monitoring_active) {
 		int err;
 
-		// Poll all ring buffers with 1 second timeout
-		err = ring_buffer__poll(syscall_rb, 1000);
+		health_heartbeat(HEALTH_RINGBUF);
+
+		// Poll all ring buffers; short timeouts keep one pass under a second
+		err = ring_buffer__poll(syscall_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling syscall ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(network_rb, 1000);
+		err = ring_buffer__poll(network_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling network ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(security_rb, 1000);
+		err = ring_buffer__poll(security_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling security ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(file_rb, 1000);
+		err = ring_buffer__poll(file_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling file ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(memory_rb, 1000);
+		err = ring_buffer__poll(memory_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling memory ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(process_rb, 1000);
+		err = ring_buffer__poll(process_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling process ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(kernel_rb, 1000);
+		err = ring_buffer__poll(kernel_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER", "Error polling kernel ring buffer: %s",
 					 strerror(-err));
 		}
 
-		err = ring_buffer__poll(performance_rb, 1000);
+		err = ring_buffer__poll(performance_rb, RING_POLL_TIMEOUT_MS);
 		if (err < 0 && err != -EINTR) {
 			LOG_ERROR_MODULE("eBPF-HANDLER",
 					 "Error polling performance ring buffer: %s",
@@ -462,6 +696,7 @@ static void* ring_buffer_poll_thread(void* arg) {
 	}
 
 	LOG_INFO_MODULE("eBPF-HANDLER", "Ring buffer polling thread stopped");
+	__atomic_store_n(&monitoring_thread_exited, 1, __ATOMIC_RELEASE);
 	return NULL;
 }
 
@@ -609,6 +844,27 @@ static int load_ebpf_programs(void) {
 	return 0;
 }
 
+// Links of the attached programs, kept so monitors can be detached at runtime
+#define MONITOR_MAX_LINKS 16
+static struct bpf_link* monitor_links[EVENT_CATEGORY_MAX + 1][MONITOR_MAX_LINKS];
+static int monitor_link_count[EVENT_CATEGORY_MAX + 1];
+static int monitor_detached[EVENT_CATEGORY_MAX + 1];
+
+// Remember the link of an attached program
+static void keep_link(uint32_t category, struct bpf_link* link) {
+	if (monitor_link_count[category] < MONITOR_MAX_LINKS) {
+		monitor_links[category][monitor_link_count[category]++] = link;
+	}
+}
+
+// Destroy the links of a monitor, detaching its programs
+static void destroy_links(uint32_t category) {
+	for (int i = 0; i < monitor_link_count[category]; i++) {
+		bpf_link__destroy(monitor_links[category][i]);
+	}
+	monitor_link_count[category] = 0;
+}
+
 // Attach eBPF programs to kernel hooks
 static int attach_ebpf_programs(void) {
 	// Attach syscall programs
@@ -622,6 +878,7 @@ static int attach_ebpf_programs(void) {
 					 bpf_program__name(prog), err_buf);
 			return -1;
 		}
+		keep_link(EVENT_CATEGORY_SYSCALL, link);
 	}
 
 	// Attach network programs
@@ -634,6 +891,7 @@ static int attach_ebpf_programs(void) {
 					 bpf_program__name(prog), err_buf);
 			return -1;
 		}
+		keep_link(EVENT_CATEGORY_NETWORK, link);
 	}
 
 	// Attach security programs
@@ -646,6 +904,7 @@ static int attach_ebpf_programs(void) {
 					 bpf_program__name(prog), err_buf);
 			return -1;
 		}
+		keep_link(EVENT_CATEGORY_SECURITY, link);
 	}
 
 	// Attach file programs
@@ -657,6 +916,7 @@ static int attach_ebpf_programs(void) {
 			LOG_WARN_MODULE("eBPF-HANDLER", "Failed to attach program %s: %s (continuing)",
 					 bpf_program__name(prog), err_buf);
 		} else {
+			keep_link(EVENT_CATEGORY_FILE, link);
 			LOG_INFO_MODULE("eBPF-HANDLER", "Successfully attached program %s",
 					 bpf_program__name(prog));
 		}
@@ -671,6 +931,7 @@ static int attach_ebpf_programs(void) {
 			LOG_WARN_MODULE("eBPF-HANDLER", "Failed to attach program %s: %s (continuing)",
 					 bpf_program__name(prog), err_buf);
 		} else {
+			keep_link(EVENT_CATEGORY_MEMORY, link);
 			LOG_INFO_MODULE("eBPF-HANDLER", "Successfully attached program %s",
 					 bpf_program__name(prog));
 		}
@@ -685,6 +946,7 @@ static int attach_ebpf_programs(void) {
 			LOG_WARN_MODULE("eBPF-HANDLER", "Failed to attach program %s: %s (continuing)",
 					 bpf_program__name(prog), err_buf);
 		} else {
+			keep_link(EVENT_CATEGORY_PROCESS, link);
 			LOG_INFO_MODULE("eBPF-HANDLER", "Successfully attached program %s",
 					 bpf_program__name(prog));
 		}
@@ -699,6 +961,7 @@ static int attach_ebpf_programs(void) {
 			LOG_WARN_MODULE("eBPF-HANDLER", "Failed to attach program %s: %s (continuing)",
 					 bpf_program__name(prog), err_buf);
 		} else {
+			keep_link(EVENT_CATEGORY_KERNEL, link);
 			LOG_INFO_MODULE("eBPF-HANDLER", "Successfully attached program %s",
 					 bpf_program__name(prog));
 		}
@@ -714,6 +977,7 @@ static int attach_ebpf_programs(void) {
 					 bpf_program__name(prog), err_buf);
 			// Continue instead of failing - some programs may not be attachable
 		} else {
+			keep_link(EVENT_CATEGORY_PERFORMANCE, link);
 			LOG_INFO_MODULE("eBPF-HANDLER", "Successfully attached program %s",
 					 bpf_program__name(prog));
 		}
@@ -734,7 +998,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	syscall_rb = ring_buffer__new(bpf_map__fd(map), handle_syscall_event, NULL, NULL);
+	syscall_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_SYSCALL], NULL);
 	if (libbpf_get_error(syscall_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(syscall_rb), err_buf, sizeof(err_buf));
@@ -750,7 +1015,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	network_rb = ring_buffer__new(bpf_map__fd(map), handle_network_event, NULL, NULL);
+	network_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_NETWORK], NULL);
 	if (libbpf_get_error(network_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(network_rb), err_buf, sizeof(err_buf));
@@ -766,7 +1032,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	security_rb = ring_buffer__new(bpf_map__fd(map), handle_security_event, NULL, NULL);
+	security_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_SECURITY], NULL);
 	if (libbpf_get_error(security_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(security_rb), err_buf, sizeof(err_buf));
@@ -782,7 +1049,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	file_rb = ring_buffer__new(bpf_map__fd(map), handle_file_event, NULL, NULL);
+	file_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_FILE], NULL);
 	if (libbpf_get_error(file_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(file_rb), err_buf, sizeof(err_buf));
@@ -797,7 +1065,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	memory_rb = ring_buffer__new(bpf_map__fd(map), handle_memory_event, NULL, NULL);
+	memory_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_MEMORY], NULL);
 	if (libbpf_get_error(memory_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(memory_rb), err_buf, sizeof(err_buf));
@@ -813,7 +1082,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	process_rb = ring_buffer__new(bpf_map__fd(map), handle_process_event, NULL, NULL);
+	process_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_PROCESS], NULL);
 	if (libbpf_get_error(process_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(process_rb), err_buf, sizeof(err_buf));
@@ -829,7 +1099,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	kernel_rb = ring_buffer__new(bpf_map__fd(map), handle_kernel_event, NULL, NULL);
+	kernel_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_KERNEL], NULL);
 	if (libbpf_get_error(kernel_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(kernel_rb), err_buf, sizeof(err_buf));
@@ -845,7 +1116,8 @@ static int create_ring_buffers(void) {
 		return -1;
 	}
 
-	performance_rb = ring_buffer__new(bpf_map__fd(map), handle_performance_event, NULL, NULL);
+	performance_rb = ring_buffer__new(bpf_map__fd(map), dispatch_monitor_event,
+				&monitor_slots[EVENT_CATEGORY_PERFORMANCE], NULL);
 	if (libbpf_get_error(performance_rb)) {
 		char err_buf[256];
 		libbpf_strerror(libbpf_get_error(performance_rb), err_buf, sizeof(err_buf));
@@ -880,11 +1152,8 @@ int init_ebpf_handlers(void) {
 		return -1;
 	}
 
-	monitoring_active = 1;
-
 	// Start ring buffer polling thread
-	if (pthread_create(&monitoring_thread, NULL, ring_buffer_poll_thread, NULL) != 0) {
-		LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to create ring buffer polling thread");
+	if (ebpf_handler_start_monitoring() != 0) {
 		return -1;
 	}
 
@@ -896,12 +1165,8 @@ int init_ebpf_handlers(void) {
 void cleanup_ebpf_handlers(void) {
 	LOG_INFO_MODULE("eBPF-HANDLER", "Stopping eBPF ring buffer monitoring...");
 
-	monitoring_active = 0;
-
 	// Wait for polling thread to finish
-	if (monitoring_thread) {
-		pthread_join(monitoring_thread, NULL);
-	}
+	ebpf_handler_stop_monitoring();
 
 	// Cleanup ring buffers
 	if (syscall_rb) {
@@ -944,6 +1209,12 @@ void cleanup_ebpf_handlers(void) {
 		performance_rb = NULL;
 	}
 
+	// Detach the programs before their objects are closed
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		destroy_links(cat);
+		monitor_detached[cat] = 0;
+	}
+
 	// Cleanup eBPF objects
 	if (syscall_obj) {
 		bpf_object__close(syscall_obj);
@@ -988,15 +1259,375 @@ void cleanup_ebpf_handlers(void) {
 	LOG_INFO_MODULE("eBPF-HANDLER", "eBPF ring buffer monitoring stopped and cleaned up");
 }
 
-// Start monitoring (simplified for POC)
+// Start the ring buffer polling thread
 int ebpf_handler_start_monitoring(void) {
-	LOG_INFO_MODULE("eBPF-HANDLER", "eBPF monitoring started (simplified mode)");
+	if (monitoring_thread_running) {
+		return 0;
+	}
+
+	monitoring_active = 1;
+	__atomic_store_n(&monitoring_thread_exited, 0, __ATOMIC_RELEASE);
+	if (pthread_create(&monitoring_thread, NULL, ring_buffer_poll_thread, NULL) != 0) {
+		LOG_ERROR_MODULE("eBPF-HANDLER", "Failed to create ring buffer polling thread");
+		monitoring_active = 0;
+		return -1;
+	}
+
+	monitoring_thread_running = 1;
+	LOG_INFO_MODULE("eBPF-HANDLER", "eBPF monitoring started");
 	return 0;
 }
 
-// Stop monitoring
+// Stop the ring buffer polling thread
 void ebpf_handler_stop_monitoring(void) {
-	LOG_INFO_MODULE("eBPF-HANDLER", "eBPF monitoring stopped");
+	monitoring_active = 0;
+
+	if (monitoring_thread_running) {
+		pthread_join(monitoring_thread, NULL);
+		monitoring_thread_running = 0;
+		LOG_INFO_MODULE("eBPF-HANDLER", "eBPF monitoring stopped");
+	}
+}
+
+// Restart the polling thread once the current one has exited
+int ebpf_handler_restart_polling(void) {
+	if (monitoring_thread_running) {
+		monitoring_active = 0;
+
+		// Never join a thread stuck in a handler; retry on the next attempt
+		struct timespec wait = {0, 100000000L};
+		for (int i = 0; i < 20; i++) {
+			if (__atomic_load_n(&monitoring_thread_exited, __ATOMIC_ACQUIRE)) {
+				break;
+			}
+			nanosleep(&wait, NULL);
+		}
+		if (!__atomic_load_n(&monitoring_thread_exited, __ATOMIC_ACQUIRE)) {
+			LOG_WARN_MODULE("eBPF-HANDLER", "Polling thread did not exit, restart deferred");
+			return -1;
+		}
+
+		pthread_join(monitoring_thread, NULL);
+		monitoring_thread_running = 0;
+	}
+
+	return ebpf_handler_start_monitoring();
+}
+
+// Get the loaded BPF object of a monitor
+static struct bpf_object* monitor_object(uint32_t category) {
+	switch (category) {
+	case EVENT_CATEGORY_SYSCALL:
+		return syscall_obj;
+	case EVENT_CATEGORY_NETWORK:
+		return network_obj;
+	case EVENT_CATEGORY_SECURITY:
+		return security_obj;
+	case EVENT_CATEGORY_FILE:
+		return file_obj;
+	case EVENT_CATEGORY_MEMORY:
+		return memory_obj;
+	case EVENT_CATEGORY_PROCESS:
+		return process_obj;
+	case EVENT_CATEGORY_KERNEL:
+		return kernel_obj;
+	case EVENT_CATEGORY_PERFORMANCE:
+		return performance_obj;
+	default:
+		return NULL;
+	}
+}
+
+// Get the ring buffer manager of a monitor
+static struct ring_buffer* monitor_ring_buffer(uint32_t category) {
+	switch (category) {
+	case EVENT_CATEGORY_SYSCALL:
+		return syscall_rb;
+	case EVENT_CATEGORY_NETWORK:
+		return network_rb;
+	case EVENT_CATEGORY_SECURITY:
+		return security_rb;
+	case EVENT_CATEGORY_FILE:
+		return file_rb;
+	case EVENT_CATEGORY_MEMORY:
+		return memory_rb;
+	case EVENT_CATEGORY_PROCESS:
+		return process_rb;
+	case EVENT_CATEGORY_KERNEL:
+		return kernel_rb;
+	case EVENT_CATEGORY_PERFORMANCE:
+		return performance_rb;
+	default:
+		return NULL;
+	}
+}
+
+// Read per-monitor cost counters (user-space handler and BPF run time)
+int ebpf_handler_get_monitor_stats(struct ebpf_monitor_stats* stats) {
+	if (!stats) {
+		return 0;
+	}
+
+	int count = 0;
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		struct ebpf_monitor_stats* st = &stats[cat];
+		memset(st, 0, sizeof(*st));
+		st->name = get_event_category_name(cat);
+		st->category = cat;
+		st->events = __atomic_load_n(&monitor_slots[cat].events, __ATOMIC_RELAXED);
+		st->handler_ns = __atomic_load_n(&monitor_slots[cat].handler_ns, __ATOMIC_RELAXED);
+
+		// Each manager holds a single ring; avail is unconsumed producer data
+		struct ring_buffer* rb = monitor_ring_buffer(cat);
+		struct ring* ring = rb ? ring_buffer__ring(rb, 0) : NULL;
+		if (ring) {
+			st->ring_size = ring__size(ring);
+			st->ring_avail = ring__avail_data_size(ring);
+		}
+
+		struct bpf_object* obj = monitor_object(cat);
+		if (!obj) {
+			continue;
+		}
+
+		struct bpf_program* prog;
+		bpf_object__for_each_program(prog, obj) {
+			struct bpf_prog_info info;
+			__u32 info_len = sizeof(info);
+			int fd = bpf_program__fd(prog);
+
+			memset(&info, 0, sizeof(info));
+			if (fd < 0 || bpf_prog_get_info_by_fd(fd, &info, &info_len) != 0) {
+				continue;
+			}
+			st->programs++;
+			st->run_cnt += info.run_cnt;
+			st->run_time_ns += info.run_time_ns;
+		}
+		count++;
+	}
+
+	return count;
+}
+
+// Read the event counter of one monitor
+uint64_t ebpf_handler_get_event_count(uint32_t category) {
+	if (category < 1 || category > EVENT_CATEGORY_MAX) {
+		return 0;
+	}
+	return __atomic_load_n(&monitor_slots[category].events, __ATOMIC_RELAXED);
+}
+
+// Write the emission control entry of a monitor
+int ebpf_handler_set_monitor_control(uint32_t category, const struct monitor_control* control) {
+	struct bpf_object* obj = monitor_object(category);
+	struct bpf_map* map = obj ? bpf_object__find_map_by_name(obj, "monitor_controls") : NULL;
+	if (!map || !control) {
+		return -1;
+	}
+
+	__u32 key = 0;
+	if (bpf_map_update_elem(bpf_map__fd(map), &key, control, BPF_ANY) != 0) {
+		LOG_WARN_MODULE("eBPF-HANDLER", "Failed to update %s monitor control: %s",
+				get_event_category_name(category), strerror(errno));
+		return -1;
+	}
+	return 0;
+}
+
+// Sum the per-CPU counters of events a monitor did not emit
+int ebpf_handler_get_monitor_tally(uint32_t category, uint64_t* tally) {
+	memset(tally, 0, MONITOR_TALLY_MAX * sizeof(*tally));
+
+	struct bpf_object* obj = monitor_object(category);
+	struct bpf_map* map = obj ? bpf_object__find_map_by_name(obj, "monitor_tallies") : NULL;
+	int ncpus = libbpf_num_possible_cpus();
+	if (!map || ncpus <= 0) {
+		return -1;
+	}
+
+	__u64* values = calloc((size_t)ncpus, sizeof(*values));
+	if (!values) {
+		return -1;
+	}
+	for (__u32 key = 0; key < MONITOR_TALLY_MAX; key++) {
+		if (bpf_map_lookup_elem(bpf_map__fd(map), &key, values) != 0) {
+			continue;
+		}
+		for (int cpu = 0; cpu < ncpus; cpu++) {
+			tally[key] += values[cpu];
+		}
+	}
+	free(values);
+	return 0;
+}
+
+// Detach the programs of a monitor, keeping its object and ring loaded
+int ebpf_handler_detach_monitor(uint32_t category) {
+	if (category < 1 || category > EVENT_CATEGORY_MAX) {
+		return -1;
+	}
+	if (monitor_detached[category]) {
+		return 0;
+	}
+
+	destroy_links(category);
+	monitor_detached[category] = 1;
+	LOG_INFO_MODULE("eBPF-HANDLER", "Detached %s monitor", get_event_category_name(category));
+	return 0;
+}
+
+// Re-attach the programs of a detached monitor
+int ebpf_handler_attach_monitor(uint32_t category) {
+	if (category < 1 || category > EVENT_CATEGORY_MAX) {
+		return -1;
+	}
+	if (!monitor_detached[category]) {
+		return 0;
+	}
+
+	struct bpf_object* obj = monitor_object(category);
+	if (!obj) {
+		return -1;
+	}
+
+	int failed = 0;
+	struct bpf_program* prog;
+	bpf_object__for_each_program(prog, obj) {
+		struct bpf_link* link = bpf_program__attach(prog);
+		if (libbpf_get_error(link)) {
+			char err_buf[256];
+			libbpf_strerror(libbpf_get_error(link), err_buf, sizeof(err_buf));
+			LOG_WARN_MODULE("eBPF-HANDLER", "Failed to re-attach program %s: %s",
+					bpf_program__name(prog), err_buf);
+			failed++;
+			continue;
+		}
+		keep_link(category, link);
+	}
+
+	monitor_detached[category] = 0;
+	LOG_INFO_MODULE("eBPF-HANDLER", "Re-attached %s monitor",
+			get_event_category_name(category));
+	return failed ? -1 : 0;
+}
+
+// Check whether a monitor is attached
+int ebpf_handler_monitor_attached(uint32_t category) {
+	if (category < 1 || category > EVENT_CATEGORY_MAX) {
+		return 0;
+	}
+	return !monitor_detached[category];
+}
+
+// Replace the cgroup filter of every loaded monitor
+int ebpf_handler_set_cgroup_filter(enum cgroup_filter_mode mode, const uint64_t* ids, int count) {
+	if ((unsigned)mode > CGROUP_FILTER_EXCLUDE || count < 0 || count > MONITOR_CGROUP_MAX ||
+	    (mode != CGROUP_FILTER_NONE && (count == 0 || !ids))) {
+		return -1;
+	}
+	if (mode == CGROUP_FILTER_NONE) {
+		count = 0;
+	}
+
+	int failed = 0;
+	pthread_mutex_lock(&cgroup_filter_lock);
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		struct bpf_object* obj = monitor_object(cat);
+		if (!obj) {
+			continue;
+		}
+		struct bpf_map* mode_map = bpf_object__find_map_by_name(obj, "monitor_cgroup_mode");
+		struct bpf_map* set_map = bpf_object__find_map_by_name(obj, "monitor_cgroups");
+		if (!mode_map || !set_map) {
+			failed++;
+			continue;
+		}
+
+		// Emit every cgroup while the set is rewritten, then switch to the new mode
+		__u32 key = 0;
+		__u32 value = CGROUP_FILTER_NONE;
+		__u8 listed = 1;
+		int err = bpf_map_update_elem(bpf_map__fd(mode_map), &key, &value, BPF_ANY);
+		for (int i = 0; i < cgroup_filter_count; i++) {
+			bpf_map_delete_elem(bpf_map__fd(set_map), &cgroup_filter_ids[i]);
+		}
+		for (int i = 0; i < count && !err; i++) {
+			err = bpf_map_update_elem(bpf_map__fd(set_map), &ids[i], &listed, BPF_ANY);
+		}
+		value = (__u32)mode;
+		if (!err) {
+			err = bpf_map_update_elem(bpf_map__fd(mode_map), &key, &value, BPF_ANY);
+		}
+		if (err) {
+			LOG_WARN_MODULE("eBPF-HANDLER", "Failed to update %s cgroup filter: %s",
+					get_event_category_name(cat), strerror(errno));
+			failed++;
+		}
+	}
+
+	cgroup_filter_mode = mode;
+	cgroup_filter_count = count;
+	if (count) {
+		memcpy(cgroup_filter_ids, ids, (size_t)count * sizeof(*ids));
+	}
+	pthread_mutex_unlock(&cgroup_filter_lock);
+
+	return failed ? -1 : 0;
+}
+
+// Read the cgroup filter
+int ebpf_handler_get_cgroup_filter(enum cgroup_filter_mode* mode, uint64_t* ids, int max) {
+	pthread_mutex_lock(&cgroup_filter_lock);
+	int count = cgroup_filter_count < max ? cgroup_filter_count : max;
+	if (mode) {
+		*mode = cgroup_filter_mode;
+	}
+	if (ids && count > 0) {
+		memcpy(ids, cgroup_filter_ids, (size_t)count * sizeof(*ids));
+	}
+	pthread_mutex_unlock(&cgroup_filter_lock);
+	return count;
+}
+
+// Read cumulative network traffic counters
+void ebpf_handler_get_network_bytes(uint64_t* sent, uint64_t* received) {
+	if (sent) {
+		*sent = __atomic_load_n(&net_bytes_sent, __ATOMIC_RELAXED);
+	}
+	if (received) {
+		*received = __atomic_load_n(&net_bytes_received, __ATOMIC_RELAXED);
+	}
+}
+
+// Replace the event delivery filter
+void ebpf_handler_set_filter(const struct ebpf_event_filter* filter) {
+	struct ebpf_event_filter next;
+	memset(&next, 0, sizeof(next));
+	if (filter) {
+		next = *filter;
+		next.comm[sizeof(next.comm) - 1] = '\0';
+	}
+
+	pthread_mutex_lock(&filter_lock);
+	uint32_t seq = filter_seq;
+	__atomic_store_n(&filter_seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&event_filter, &next, sizeof(event_filter));
+	__atomic_store_n(&filter_seq, seq + 2, __ATOMIC_RELEASE);
+	__atomic_store_n(&filter_active, next.categories || next.pid || next.comm[0],
+			 __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&filter_lock);
+}
+
+// Read the event delivery filter
+void ebpf_handler_get_filter(struct ebpf_event_filter* filter) {
+	uint32_t seq;
+	do {
+		seq = __atomic_load_n(&filter_seq, __ATOMIC_ACQUIRE);
+		memcpy(filter, &event_filter, sizeof(*filter));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	} while ((seq & 1) || __atomic_load_n(&filter_seq, __ATOMIC_RELAXED) != seq);
 }
 
 // Process syscall event
@@ -1049,294 +1680,6 @@ int process_file_event(const struct file_event* event) {
 	return 0;
 }
 
-// Get syscall name
-const char* get_syscall_name(uint32_t syscall_nr) {
-	switch (syscall_nr) {
-	case SYS_READ:
-		return "read";
-	case SYS_WRITE:
-		return "write";
-	case SYS_OPEN:
-		return "open";
-	case SYS_CLOSE:
-		return "close";
-	case SYS_STAT:
-		return "stat";
-	case SYS_FSTAT:
-		return "fstat";
-	case SYS_LSTAT:
-		return "lstat";
-	case SYS_POLL:
-		return "poll";
-	case SYS_LSEEK:
-		return "lseek";
-	case SYS_MMAP:
-		return "mmap";
-	case SYS_MPROTECT:
-		return "mprotect";
-	case SYS_MUNMAP:
-		return "munmap";
-	case SYS_BRK:
-		return "brk";
-	case SYS_RT_SIGACTION:
-		return "rt_sigaction";
-	case SYS_RT_SIGPROCMASK:
-		return "rt_sigprocmask";
-	case SYS_RT_SIGRETURN:
-		return "rt_sigreturn";
-	case SYS_IOCTL:
-		return "ioctl";
-	case SYS_PREAD64:
-		return "pread64";
-	case SYS_PWRITE64:
-		return "pwrite64";
-	case SYS_READV:
-		return "readv";
-	case SYS_WRITEV:
-		return "writev";
-	case SYS_ACCESS:
-		return "access";
-	case SYS_PIPE:
-		return "pipe";
-	case SYS_SELECT:
-		return "select";
-	case SYS_SCHED_YIELD:
-		return "sched_yield";
-	case SYS_MREMAP:
-		return "mremap";
-	case SYS_MSYNC:
-		return "msync";
-	case SYS_MINCORE:
-		return "mincore";
-	case SYS_MADVISE:
-		return "madvise";
-	case SYS_SHMGET:
-		return "shmget";
-	case SYS_SHMAT:
-		return "shmat";
-	case SYS_SHMCTL:
-		return "shmctl";
-	case SYS_DUP:
-		return "dup";
-	case SYS_DUP2:
-		return "dup2";
-	case SYS_PAUSE:
-		return "pause";
-	case SYS_NANOSLEEP:
-		return "nanosleep";
-	case SYS_GETITIMER:
-		return "getitimer";
-	case SYS_ALARM:
-		return "alarm";
-	case SYS_SETITIMER:
-		return "setitimer";
-	case SYS_GETPID:
-		return "getpid";
-	case SYS_SENDFILE:
-		return "sendfile";
-	case SYS_SOCKET:
-		return "socket";
-	case SYS_CONNECT:
-		return "connect";
-	case SYS_ACCEPT:
-		return "accept";
-	case SYS_SENDTO:
-		return "sendto";
-	case SYS_RECVFROM:
-		return "recvfrom";
-	case SYS_SENDMSG:
-		return "sendmsg";
-	case SYS_RECVMSG:
-		return "recvmsg";
-	case SYS_SHUTDOWN:
-		return "shutdown";
-	case SYS_BIND:
-		return "bind";
-	case SYS_LISTEN:
-		return "listen";
-	case SYS_GETSOCKNAME:
-		return "getsockname";
-	case SYS_GETPEERNAME:
-		return "getpeername";
-	case SYS_SOCKETPAIR:
-		return "socketpair";
-	case SYS_SETSOCKOPT:
-		return "setsockopt";
-	case SYS_GETSOCKOPT:
-		return "getsockopt";
-	case SYS_CLONE:
-		return "clone";
-	case SYS_FORK:
-		return "fork";
-	case SYS_VFORK:
-		return "vfork";
-	case SYS_EXECVE:
-		return "execve";
-	case SYS_EXIT:
-		return "exit";
-	case SYS_WAIT4:
-		return "wait4";
-	case SYS_KILL:
-		return "kill";
-	case SYS_UNAME:
-		return "uname";
-	case SYS_SEMGET:
-		return "semget";
-	case SYS_SEMOP:
-		return "semop";
-	case SYS_SEMCTL:
-		return "semctl";
-	case SYS_SHDT:
-		return "shmdt";
-	case SYS_MSGGET:
-		return "msgget";
-	case SYS_MSGSND:
-		return "msgsnd";
-	case SYS_MSGRCV:
-		return "msgrcv";
-	case SYS_MSGCTL:
-		return "msgctl";
-	case SYS_FCNTL:
-		return "fcntl";
-	case SYS_FLOCK:
-		return "flock";
-	case SYS_FSYNC:
-		return "fsync";
-	case SYS_FDATASYNC:
-		return "fdatasync";
-	case SYS_TRUNCATE:
-		return "truncate";
-	case SYS_FTRUNCATE:
-		return "ftruncate";
-	case SYS_GETDENTS:
-		return "getdents";
-	case SYS_GETCWD:
-		return "getcwd";
-	case SYS_CHDIR:
-		return "chdir";
-	case SYS_FCHDIR:
-		return "fchdir";
-	case SYS_RENAME:
-		return "rename";
-	case SYS_MKDIR:
-		return "mkdir";
-	case SYS_RMDIR:
-		return "rmdir";
-	case SYS_CREAT:
-		return "creat";
-	case SYS_LINK:
-		return "link";
-	case SYS_UNLINK:
-		return "unlink";
-	case SYS_SYMLINK:
-		return "symlink";
-	case SYS_READLINK:
-		return "readlink";
-	case SYS_CHMOD:
-		return "chmod";
-	case SYS_FCHMOD:
-		return "fchmod";
-	case SYS_CHOWN:
-		return "chown";
-	case SYS_FCHOWN:
-		return "fchown";
-	case SYS_LCHOWN:
-		return "lchown";
-	case SYS_UMASK:
-		return "umask";
-	case SYS_GETTIMEOFDAY:
-		return "gettimeofday";
-	case SYS_GETRLIMIT:
-		return "getrlimit";
-	case SYS_GETRUSAGE:
-		return "getrusage";
-	case SYS_SYSINFO:
-		return "sysinfo";
-	default:
-		return "unknown";
-	}
-}
-
-// Get network event name
-const char* get_network_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case NET_EVENT_SOCKET_CREATE:
-		return "socket_create";
-	case NET_EVENT_SOCKET_BIND:
-		return "socket_bind";
-	case NET_EVENT_SOCKET_CONNECT:
-		return "socket_connect";
-	case NET_EVENT_SOCKET_LISTEN:
-		return "socket_listen";
-	case NET_EVENT_SOCKET_ACCEPT:
-		return "socket_accept";
-	case NET_EVENT_SOCKET_SEND:
-		return "socket_send";
-	case NET_EVENT_SOCKET_RECV:
-		return "socket_recv";
-	case NET_EVENT_SOCKET_CLOSE:
-		return "socket_close";
-	default:
-		return "unknown";
-	}
-}
-
-// Get security event name
-const char* get_security_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case SEC_EVENT_CAPSET:
-		return "capset";
-	case SEC_EVENT_PRCTL:
-		return "prctl";
-	case SEC_EVENT_SETUID:
-		return "setuid";
-	case SEC_EVENT_SETGID:
-		return "setgid";
-	case SEC_EVENT_SETRESUID:
-		return "setresuid";
-	case SEC_EVENT_SETRESGID:
-		return "setresgid";
-	case SEC_EVENT_SETEUID:
-		return "setfsuid";
-	case SEC_EVENT_SETEGID:
-		return "setfsgid";
-	case SEC_EVENT_SETREUID:
-		return "setreuid";
-	case SEC_EVENT_SETREGID:
-		return "setregid";
-	default:
-		return "unknown";
-	}
-}
-
-// Get file event name
-const char* get_file_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case FILE_EVENT_OPEN:
-		return "file_open";
-	case FILE_EVENT_READ:
-		return "file_read";
-	case FILE_EVENT_WRITE:
-		return "file_write";
-	case FILE_EVENT_CLOSE:
-		return "file_close";
-	case FILE_EVENT_CREATE:
-		return "file_create";
-	case FILE_EVENT_DELETE:
-		return "file_delete";
-	case FILE_EVENT_RENAME:
-		return "file_rename";
-	case FILE_EVENT_CHMOD:
-		return "file_chmod";
-	case FILE_EVENT_CHOWN:
-		return "file_chown";
-	case FILE_EVENT_TRUNCATE:
-		return "file_truncate";
-	default:
-		return "unknown";
-	}
-}
-
 // Convert event to JSON
 char* event_to_json(const struct ravn_event* event) {
 	if (!event) {
@@ -1346,9 +1689,9 @@ char* event_to_json(const struct ravn_event* event) {
 	static char json_buffer[2048];
 	snprintf(json_buffer, sizeof(json_buffer),
 		 "{\"timestamp\":%lu,\"pid\":%u,\"tid\":%u,\"event_type\":%u,"
-		 "\"event_category\":%u,\"comm\":\"%s\",\"data\":\"%s\"}",
+		 "\"event_category\":%u,\"comm\":\"%s\",\"data\":\"%s\",\"cgroup_id\":%lu}",
 		 event->timestamp, event->pid, event->tid, event->event_type, event->event_category,
-		 event->comm, event->data);
+		 event->comm, event->data, event->cgroup_id);
 
 	return json_buffer;
 }
@@ -1400,155 +1743,3 @@ int process_performance_event(const struct performance_event* event) {
 			event->value);
 	return 0;
 }
-
-// Get memory event name
-const char* get_memory_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case MEM_EVENT_ALLOC:
-		return "memory_alloc";
-	case MEM_EVENT_FREE:
-		return "memory_free";
-	case MEM_EVENT_MMAP:
-		return "memory_mmap";
-	case MEM_EVENT_MUNMAP:
-		return "memory_munmap";
-	case MEM_EVENT_MPROTECT:
-		return "memory_mprotect";
-	case MEM_EVENT_ACCESS:
-		return "memory_access";
-	case MEM_EVENT_CORRUPTION:
-		return "memory_corruption";
-	case MEM_EVENT_HEAP_SPRAY:
-		return "memory_heap_spray";
-	case MEM_EVENT_STACK_OVERFLOW:
-		return "memory_stack_overflow";
-	case MEM_EVENT_PERMISSION_CHANGE:
-		return "memory_permission_change";
-	default:
-		return "unknown";
-	}
-}
-
-// Get process event name
-const char* get_process_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case PROC_EVENT_SPAWN:
-		return "process_spawn";
-	case PROC_EVENT_EXIT:
-		return "process_exit";
-	case PROC_EVENT_EXEC:
-		return "process_exec";
-	case PROC_EVENT_FORK:
-		return "process_fork";
-	case PROC_EVENT_CLONE:
-		return "process_clone";
-	case PROC_EVENT_VFORK:
-		return "process_vfork";
-	case PROC_EVENT_SETUID:
-		return "process_setuid";
-	case PROC_EVENT_SETGID:
-		return "process_setgid";
-	case PROC_EVENT_SETRESUID:
-		return "process_setresuid";
-	case PROC_EVENT_SETRESGID:
-		return "process_setresgid";
-	case PROC_EVENT_CAPSET:
-		return "process_capset";
-	case PROC_EVENT_PRCTL:
-		return "process_prctl";
-	case PROC_EVENT_SIGNAL:
-		return "process_signal";
-	case PROC_EVENT_WORKING_DIR:
-		return "process_working_dir";
-	case PROC_EVENT_ENV_CHANGE:
-		return "process_env_change";
-	case PROC_EVENT_PRIORITY_CHANGE:
-		return "process_priority_change";
-	case PROC_EVENT_AFFINITY_CHANGE:
-		return "process_affinity_change";
-	case PROC_EVENT_NAMESPACE_CHANGE:
-		return "process_namespace_change";
-	case PROC_EVENT_IPC_OPERATION:
-		return "process_ipc_operation";
-	case PROC_EVENT_SESSION_CHANGE:
-		return "process_session_change";
-	default:
-		return "unknown";
-	}
-}
-
-// Get kernel event name
-const char* get_kernel_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case KERNEL_MODULE_LOAD:
-		return "kernel_module_load";
-	case KERNEL_MODULE_UNLOAD:
-		return "kernel_module_unload";
-	case KERNEL_FUNCTION_CALL:
-		return "kernel_function_call";
-	case KERNEL_MEMORY_OP:
-		return "kernel_memory_op";
-	case KERNEL_SECURITY_VIOLATION:
-		return "kernel_security_violation";
-	case KERNEL_PERFORMANCE_EVENT:
-		return "kernel_performance_event";
-	case KERNEL_DEBUG_EVENT:
-		return "kernel_debug_event";
-	case KERNEL_INTERRUPT:
-		return "kernel_interrupt";
-	case KERNEL_SCHEDULER_EVENT:
-		return "kernel_scheduler_event";
-	case KERNEL_IO_EVENT:
-		return "kernel_io_event";
-	case KERNEL_NETWORK_EVENT:
-		return "kernel_network_event";
-	case KERNEL_FILESYSTEM_EVENT:
-		return "kernel_filesystem_event";
-	case KERNEL_DEVICE_EVENT:
-		return "kernel_device_event";
-	case KERNEL_TIMER_EVENT:
-		return "kernel_timer_event";
-	case KERNEL_SIGNAL_EVENT:
-		return "kernel_signal_event";
-	default:
-		return "unknown";
-	}
-}
-
-// Get performance event name
-const char* get_performance_event_name(uint32_t event_type) {
-	switch (event_type) {
-	case PERF_CPU_USAGE:
-		return "perf_cpu_usage";
-	case PERF_MEMORY_USAGE:
-		return "perf_memory_usage";
-	case PERF_DISK_IO:
-		return "perf_disk_io";
-	case PERF_NETWORK_IO:
-		return "perf_network_io";
-	case PERF_SYSTEM_LOAD:
-		return "perf_system_load";
-	case PERF_RESOURCE_CONTENTION:
-		return "perf_resource_contention";
-	case PERF_CACHE_MISS:
-		return "perf_cache_miss";
-	case PERF_INTERRUPT:
-		return "perf_interrupt";
-	case PERF_CONTEXT_SWITCH:
-		return "perf_context_switch";
-	case PERF_PAGE_FAULT:
-		return "perf_page_fault";
-	case PERF_SYSCALL_OVERHEAD:
-		return "perf_syscall_overhead";
-	case PERF_MEMORY_PRESSURE:
-		return "perf_memory_pressure";
-	case PERF_IO_WAIT:
-		return "perf_io_wait";
-	case PERF_CPU_FREQUENCY:
-		return "perf_cpu_frequency";
-	case PERF_THERMAL_EVENT:
-		return "perf_thermal_event";
-	default:
-		return "unknown";
-	}
-}
\ No newline at end of file
@@ -29,276 +29,11 @@
 #include <bpf/libbpf.h>
 #include <stdint.h>
 #include <time.h>
-#include "../ebpf/ravn_events.h"
+#include "event_types.h"
 
 /*
- * System Call Number Enums - Comprehensive Linux system call definitions
- * These enums make system call handling more readable and maintainable
- */
-
-/**
- * enum syscall_number - Linux system call numbers
- * Based on x86_64 Linux system call table
- */
-enum syscall_number {
-	SYS_READ = 0,		     /* Read from file descriptor */
-	SYS_WRITE = 1,		     /* Write to file descriptor */
-	SYS_OPEN = 2,		     /* Open file */
-	SYS_CLOSE = 3,		     /* Close file descriptor */
-	SYS_STAT = 4,		     /* Get file status */
-	SYS_FSTAT = 5,		     /* Get file status by file descriptor */
-	SYS_LSTAT = 6,		     /* Get file status (no follow symlinks) */
-	SYS_POLL = 7,		     /* Wait for events on file descriptors */
-	SYS_LSEEK = 8,		     /* Reposition file offset */
-	SYS_MMAP = 9,		     /* Map files or devices into memory */
-	SYS_MPROTECT = 10,	     /* Set protection on memory region */
-	SYS_MUNMAP = 11,	     /* Unmap memory region */
-	SYS_BRK = 12,		     /* Change data segment size */
-	SYS_RT_SIGACTION = 13,	     /* Change signal action */
-	SYS_RT_SIGPROCMASK = 14,     /* Examine and change blocked signals */
-	SYS_RT_SIGRETURN = 15,	     /* Return from signal handler */
-	SYS_IOCTL = 16,		     /* Control device */
-	SYS_PREAD64 = 17,	     /* Read from file at offset */
-	SYS_PWRITE64 = 18,	     /* Write to file at offset */
-	SYS_READV = 19,		     /* Read data into multiple buffers */
-	SYS_WRITEV = 20,	     /* Write data from multiple buffers */
-	SYS_ACCESS = 21,	     /* Check user permissions for file */
-	SYS_PIPE = 22,		     /* Create pipe */
-	SYS_SELECT = 23,	     /* Synchronous I/O multiplexing */
-	SYS_SCHED_YIELD = 24,	     /* Yield processor */
-	SYS_MREMAP = 25,	     /* Remap memory region */
-	SYS_MSYNC = 26,		     /* Synchronize memory with storage */
-	SYS_MINCORE = 27,	     /* Check if pages are in memory */
-	SYS_MADVISE = 28,	     /* Give advice about memory usage */
-	SYS_SHMGET = 29,	     /* Get shared memory segment */
-	SYS_SHMAT = 30,		     /* Attach shared memory segment */
-	SYS_SHMCTL = 31,	     /* Shared memory control operations */
-	SYS_DUP = 32,		     /* Duplicate file descriptor */
-	SYS_DUP2 = 33,		     /* Duplicate file descriptor */
-	SYS_PAUSE = 34,		     /* Suspend process until signal */
-	SYS_NANOSLEEP = 35,	     /* High-resolution sleep */
-	SYS_GETITIMER = 36,	     /* Get value of interval timer */
-	SYS_ALARM = 37,		     /* Set alarm clock for delivery of signal */
-	SYS_SETITIMER = 38,	     /* Set value of interval timer */
-	SYS_GETPID = 39,	     /* Get process identification */
-	SYS_SENDFILE = 40,	     /* Transfer data between file descriptors */
-	SYS_SOCKET = 41,	     /* Create endpoint for communication */
-	SYS_CONNECT = 42,	     /* Initiate connection on socket */
-	SYS_ACCEPT = 43,	     /* Accept connection on socket */
-	SYS_SENDTO = 44,	     /* Send message on socket */
-	SYS_RECVFROM = 45,	     /* Receive message from socket */
-	SYS_SENDMSG = 46,	     /* Send message on socket */
-	SYS_RECVMSG = 47,	     /* Receive message from socket */
-	SYS_SHUTDOWN = 48,	     /* Shut down part of full-duplex connection */
-	SYS_BIND = 49,		     /* Bind name to socket */
-	SYS_LISTEN = 50,	     /* Listen for connections on socket */
-	SYS_GETSOCKNAME = 51,	     /* Get socket name */
-	SYS_GETPEERNAME = 52,	     /* Get name of connected peer socket */
-	SYS_SOCKETPAIR = 53,	     /* Create pair of connected sockets */
-	SYS_SETSOCKOPT = 54,	     /* Set options on sockets */
-	SYS_GETSOCKOPT = 55,	     /* Get options on sockets */
-	SYS_CLONE = 56,		     /* Create child process */
-	SYS_FORK = 57,		     /* Create child process */
-	SYS_VFORK = 58,		     /* Create child process and block parent */
-	SYS_EXECVE = 59,	     /* Execute program */
-	SYS_EXIT = 60,		     /* Terminate calling process */
-	SYS_WAIT4 = 61,		     /* Wait for process to change state */
-	SYS_KILL = 62,		     /* Send signal to process */
-	SYS_UNAME = 63,		     /* Get name and information about current kernel */
-	SYS_SEMGET = 64,	     /* Get semaphore set identifier */
-	SYS_SEMOP = 65,		     /* Semaphore operations */
-	SYS_SEMCTL = 66,	     /* Semaphore control operations */
-	SYS_SHDT = 67,		     /* Detach shared memory segment */
-	SYS_MSGGET = 68,	     /* Get message queue identifier */
-	SYS_MSGSND = 69,	     /* Send message to message queue */
-	SYS_MSGRCV = 70,	     /* Receive message from message queue */
-	SYS_MSGCTL = 71,	     /* Message control operations */
-	SYS_FCNTL = 72,		     /* Manipulate file descriptor */
-	SYS_FLOCK = 73,		     /* Apply or remove advisory lock on open file */
-	SYS_FSYNC = 74,		     /* Synchronize file's in-core state with storage */
-	SYS_FDATASYNC = 75,	     /* Synchronize file's in-core data with storage */
-	SYS_TRUNCATE = 76,	     /* Truncate file to specified length */
-	SYS_FTRUNCATE = 77,	     /* Truncate file to specified length */
-	SYS_GETDENTS = 78,	     /* Get directory entries */
-	SYS_GETCWD = 79,	     /* Get current working directory */
-	SYS_CHDIR = 80,		     /* Change working directory */
-	SYS_FCHDIR = 81,	     /* Change working directory */
-	SYS_RENAME = 82,	     /* Change name or location of file */
-	SYS_MKDIR = 83,		     /* Create directory */
-	SYS_RMDIR = 84,		     /* Remove directory */
-	SYS_CREAT = 85,		     /* Create new or rewrite existing file */
-	SYS_LINK = 86,		     /* Make new name for file */
-	SYS_UNLINK = 87,	     /* Delete name and possibly file */
-	SYS_SYMLINK = 88,	     /* Make symbolic link */
-	SYS_READLINK = 89,	     /* Read value of symbolic link */
-	SYS_CHMOD = 90,		     /* Change permissions of file */
-	SYS_FCHMOD = 91,	     /* Change permissions of file */
-	SYS_CHOWN = 92,		     /* Change ownership of file */
-	SYS_FCHOWN = 93,	     /* Change ownership of file */
-	SYS_LCHOWN = 94,	     /* Change ownership of file */
-	SYS_UMASK = 95,		     /* Set file mode creation mask */
-	SYS_GETTIMEOFDAY = 96,	     /* Get time */
-	SYS_GETRLIMIT = 97,	     /* Get resource limits */
-	SYS_GETRUSAGE = 98,	     /* Get resource usage */
-	SYS_SYSINFO = 99,	     /* Return system information */
-	SYS_OPENAT = 257,	     /* Open file relative to directory file descriptor */
-	SYS_MKDIRAT = 258,	     /* Create directory relative to directory file
-					descriptor */
-	SYS_MKNODAT = 259,	     /* Create special or ordinary file relative to directory */
-	SYS_FCHOWNAT = 260,	     /* Change ownership of file relative to directory */
-	SYS_FUTIMESAT = 261,	     /* Change timestamps of file relative to directory */
-	SYS_NEWFSTATAT = 262,	     /* Get file status relative to directory */
-	SYS_UNLINKAT = 263,	     /* Remove directory entry relative to directory */
-	SYS_RENAMEAT = 264,	     /* Rename file relative to directory */
-	SYS_LINKAT = 265,	     /* Make new name for file relative to directory */
-	SYS_SYMLINKAT = 266,	     /* Make symbolic link relative to directory */
-	SYS_READLINKAT = 267,	     /* Read value of symbolic link relative to directory */
-	SYS_FCHMODAT = 268,	     /* Change permissions of file relative to directory */
-	SYS_FACCESSAT = 269,	     /* Check user permissions for file relative to directory */
-	SYS_PSELECT6 = 270,	     /* Synchronous I/O multiplexing with timeout */
-	SYS_PPOLL = 271,	     /* Wait for events on file descriptors with timeout */
-	SYS_UNSHARE = 272,	     /* Unshare parts of process context */
-	SYS_SET_ROBUST_LIST = 273,   /* Set list of robust futexes */
-	SYS_GET_ROBUST_LIST = 274,   /* Get list of robust futexes */
-	SYS_SPLICE = 275,	     /* Move data between file descriptors */
-	SYS_TEE = 276,		     /* Duplicate pipe content */
-	SYS_SYNC_FILE_RANGE = 277,   /* Sync file segment with disk */
-	SYS_VMSPLICE = 278,	     /* Move user pages to pipe */
-	SYS_MOVE_PAGES = 279,	     /* Move pages in virtual address space */
-	SYS_UTIMENSAT = 280,	     /* Change file timestamps with nanosecond precision */
-	SYS_EPOLL_PWAIT = 281,	     /* Wait for events on epoll file descriptor */
-	SYS_SIGNALFD = 282,	     /* Create file descriptor for accepting signals */
-	SYS_TIMERFD_CREATE = 283,    /* Create timer that delivers timer expiration
-					notifications */
-	SYS_EVENTFD = 284,	     /* Create file descriptor for event notification */
-	SYS_FALLOCATE = 285,	     /* Manipulate file space */
-	SYS_TIMERFD_SETTIME = 286,   /* Arm or disarm timer created by timerfd_create */
-	SYS_TIMERFD_GETTIME = 287,   /* Get current time of timer created by timerfd_create */
-	SYS_ACCEPT4 = 288,	     /* Accept connection on socket */
-	SYS_SIGNALFD4 = 289,	     /* Create file descriptor for accepting signals */
-	SYS_EVENTFD2 = 290,	     /* Create file descriptor for event notification */
-	SYS_EPOLL_CREATE1 = 291,     /* Create epoll file descriptor */
-	SYS_DUP3 = 292,		     /* Duplicate file descriptor */
-	SYS_PIPE2 = 293,	     /* Create pipe */
-	SYS_INOTIFY_INIT1 = 294,     /* Initialize inotify instance */
-	SYS_PREADV = 295,	     /* Read data into multiple buffers at offset */
-	SYS_PWRITEV = 296,	     /* Write data from multiple buffers at offset */
-	SYS_RT_TGSIGQUEUEINFO = 297, /* Send signal to thread */
-	SYS_PERF_EVENT_OPEN = 298,   /* Set up performance monitoring */
-	SYS_RECVMMSG = 299,	     /* Receive multiple messages on socket */
-	SYS_FANOTIFY_INIT = 300,     /* Create and initialize fanotify group */
-	SYS_FANOTIFY_MARK = 301,     /* Add, remove, or modify fanotify mark */
-	SYS_PRLIMIT64 = 302,	     /* Get/set resource limits */
-	SYS_NAME_TO_HANDLE_AT = 303, /* Obtain handle for pathname */
-	SYS_OPEN_BY_HANDLE_AT = 304, /* Open file via handle */
-	SYS_CLOCK_ADJTIME = 305,     /* Tune kernel clock */
-	SYS_SYNCFS = 306,	     /* Commit filesystem caches to disk */
-	SYS_SENDMMSG = 307,	     /* Send multiple messages on socket */
-	SYS_SETNS = 308,	     /* Associate thread with namespace */
-	SYS_GETCPU = 309,	     /* Determine CPU and NUMA node */
-	SYS_PROCESS_VM_READV = 310,  /* Transfer data between process address spaces */
-	SYS_PROCESS_VM_WRITEV = 311, /* Transfer data between process address spaces */
-	SYS_KCMP = 312,		     /* Compare two processes to determine if they share
-					kernel resources */
-	SYS_FINIT_MODULE = 313,	     /* Load kernel module from file descriptor */
-	SYS_SCHED_SETATTR = 314,     /* Set scheduling policy and attributes */
-	SYS_SCHED_GETATTR = 315,     /* Get scheduling policy and attributes */
-	SYS_RENAMEAT2 = 316,	     /* Rename file relative to directory */
-	SYS_SECCOMP = 317,	     /* Operate on Secure Computing state */
-	SYS_GETRANDOM = 318,	     /* Obtain series of random bytes */
-	SYS_MEMFD_CREATE = 319,	     /* Create anonymous file */
-	SYS_KEXEC_FILE_LOAD = 320,   /* Load new kernel for later execution */
-	SYS_BPF = 321,		     /* Perform command on extended BPF map/program */
-	SYS_EXECVEAT = 322,	     /* Execute program relative to directory */
-	SYS_USERFAULTFD = 323,	     /* Create file descriptor for handling page faults */
-	SYS_MEMBARRIER = 324,	     /* Issue memory barriers on a set of threads */
-	SYS_MLOCK2 = 325,	     /* Lock memory pages */
-	SYS_COPY_FILE_RANGE = 326,   /* Copy data range between files */
-	SYS_PREADV2 = 327,	     /* Read data into multiple buffers at offset */
-	SYS_PWRITEV2 = 328,	     /* Write data from multiple buffers at offset */
-	SYS_PKEY_MPROTECT = 329,     /* Set protection on memory pages */
-	SYS_PKEY_ALLOC = 330,	     /* Allocate protection key */
-	SYS_PKEY_FREE = 331,	     /* Free protection key */
-	SYS_STATX = 332,	     /* Get file status (extended) */
-	SYS_IO_PGETEVENTS = 333,     /* Read asynchronous I/O events from completion queue */
-	SYS_RSEQ = 334,		     /* Restartable sequences */
-	SYS_PIDFD_SEND_SIGNAL = 424, /* Send signal to process via file descriptor */
-	SYS_IO_URING_SETUP = 425,    /* Set up io_uring instance */
-	SYS_IO_URING_ENTER = 426,    /* Submit/complete asynchronous I/O */
-	SYS_IO_URING_REGISTER = 427, /* Register files or user buffers for asynchronous I/O */
-	SYS_OPEN_TREE = 428,	     /* Open directory in different mount namespace */
-	SYS_MOVE_MOUNT = 429,	     /* Move mount from one place to another */
-	SYS_FSOPEN = 430,	     /* Open filesystem context */
-	SYS_FSCONFIG = 431,	     /* Configure filesystem context */
-	SYS_FSMOUNT = 432,	     /* Attach filesystem context to superblock */
-	SYS_FSPICK = 433,	     /* Pick superblock for filesystem context */
-	SYS_PIDFD_OPEN = 434,	     /* Open process file descriptor */
-	SYS_CLONE3 = 435,	     /* Create child process */
-	SYS_CLOSE_RANGE = 436,	     /* Close range of file descriptors */
-	SYS_OPENAT2 = 437,	     /* Open file relative to directory file descriptor */
-	SYS_PIDFD_GETFD = 438,	     /* Get file descriptor from another process */
-	SYS_FACCESSAT2 = 439,	     /* Check user permissions for file relative to directory */
-	SYS_PROCESS_MADVISE = 440,   /* Give advice about memory usage of another process */
-	SYS_EPOLL_PWAIT2 = 441,	     /* Wait for events on epoll file descriptor */
-	SYS_MOUNT_SETATTR = 442,     /* Change mount attributes */
-	SYS_QUOTACTL_FD = 443,	     /* Manipulate disk quotas */
-	SYS_LANDLOCK_CREATE_RULESET = 444, /* Create Landlock ruleset */
-	SYS_LANDLOCK_ADD_RULE = 445,	   /* Add rule to Landlock ruleset */
-	SYS_LANDLOCK_RESTRICT_SELF = 446,  /* Enforce Landlock ruleset on current thread */
-	SYS_MEMFD_SECRET = 447,		   /* Create secret anonymous file */
-	SYS_PROCESS_MRELEASE = 448,	   /* Release memory pages of another process */
-	SYS_FUTEX_WAITV = 449,		   /* Wait on futexes */
-	SYS_SET_MEMPOLICY_HOME_NODE = 450  /* Set home node for memory policy */
-};
-
-/**
- * enum network_event_type - Network event types for eBPF monitoring
- */
-enum network_event_type {
-	NET_EVENT_SOCKET_CREATE = 1,  /* Socket creation */
-	NET_EVENT_SOCKET_BIND = 2,    /* Socket bind operation */
-	NET_EVENT_SOCKET_CONNECT = 3, /* Socket connect operation */
-	NET_EVENT_SOCKET_LISTEN = 4,  /* Socket listen operation */
-	NET_EVENT_SOCKET_ACCEPT = 5,  /* Socket accept operation */
-	NET_EVENT_SOCKET_SEND = 6,    /* Socket send operation */
-	NET_EVENT_SOCKET_RECV = 7,    /* Socket receive operation */
-	NET_EVENT_SOCKET_CLOSE = 8    /* Socket close operation */
-};
-
-/**
- * enum security_event_type - Security event types for eBPF monitoring
- */
-enum security_event_type {
-	SEC_EVENT_CAPSET = 1,	 /* Capability set operation */
-	SEC_EVENT_PRCTL = 2,	 /* Process control operation */
-	SEC_EVENT_SETUID = 3,	 /* Set user ID operation */
-	SEC_EVENT_SETGID = 4,	 /* Set group ID operation */
-	SEC_EVENT_SETRESUID = 5, /* Set real, effective, and saved user ID */
-	SEC_EVENT_SETRESGID = 6, /* Set real, effective, and saved group ID */
-	SEC_EVENT_SETEUID = 7,	 /* Set effective user ID */
-	SEC_EVENT_SETEGID = 8,	 /* Set effective group ID */
-	SEC_EVENT_SETREUID = 9,	 /* Set real and effective user ID */
-	SEC_EVENT_SETREGID = 10	 /* Set real and effective group ID */
-};
-
-/**
- * enum file_event_type - File event types for eBPF monitoring
- */
-enum file_event_type {
-	FILE_EVENT_OPEN = 1,	 /* File open operation */
-	FILE_EVENT_READ = 2,	 /* File read operation */
-	FILE_EVENT_WRITE = 3,	 /* File write operation */
-	FILE_EVENT_CLOSE = 4,	 /* File close operation */
-	FILE_EVENT_CREATE = 5,	 /* File creation */
-	FILE_EVENT_DELETE = 6,	 /* File deletion */
-	FILE_EVENT_RENAME = 7,	 /* File rename operation */
-	FILE_EVENT_CHMOD = 8,	 /* File permission change */
-	FILE_EVENT_CHOWN = 9,	 /* File ownership change */
-	FILE_EVENT_TRUNCATE = 10 /* File truncation */
-};
-
-/*
- * Note: All event type enums and event structures are defined in ../ebpf/ravn_events.h
+ * Note: Event types and categories are defined in event_types.h, the remaining
+ * event structures in ../ebpf/ravn_events.h
  */
 
 
@@ -311,6 +46,7 @@ enum file_event_type {
  * @ret: System call return value
  * @comm: Process command name (truncated to 15 chars + null)
  * @filename: Filename associated with the system call
+ * @cgroup_id: cgroup v2 ID of the calling task
  *
  * Represents a system call event captured by eBPF syscall monitor.
  */
@@ -322,6 +58,7 @@ struct syscall_event {
 	int64_t ret;	     /* Return value */
 	char comm[16];	     /* Process name */
 	char filename[256];  /* Associated filename */
+	uint64_t cgroup_id;  /* cgroup v2 ID */
 };
 
 /**
@@ -340,6 +77,7 @@ struct syscall_event {
  * @bytes_sent: Number of bytes sent
  * @bytes_received: Number of bytes received
  * @comm: Process command name
+ * @cgroup_id: cgroup v2 ID of the calling task
  *
  * Represents a network event captured by eBPF network monitor.
  * This structure must match the eBPF program structure exactly.
@@ -359,6 +97,7 @@ struct network_event {
 	uint32_t bytes_sent;	 /* Bytes sent */
 	uint32_t bytes_received; /* Bytes received */
 	char comm[16];		 /* Process name */
+	uint64_t cgroup_id;	 /* cgroup v2 ID */
 };
 
 /**
@@ -375,6 +114,7 @@ struct network_event {
  * @comm: Process command name
  * @target_comm: Target process command name
  * @pathname: Path associated with the security event
+ * @cgroup_id: cgroup v2 ID of the calling task
  *
  * Represents a security event captured by eBPF security monitor.
  */
@@ -391,6 +131,7 @@ struct security_event {
 	char comm[16];	      /* Process name */
 	char target_comm[16]; /* Target process name */
 	char pathname[256];   /* Associated path */
+	uint64_t cgroup_id;   /* cgroup v2 ID */
 };
 
 /**
@@ -407,6 +148,7 @@ struct security_event {
  * @comm: Process command name
  * @filename: Source filename
  * @target_filename: Target filename (for rename operations)
+ * @cgroup_id: cgroup v2 ID of the calling task
  *
  * Represents a file I/O event captured by eBPF file monitor.
  */
@@ -423,9 +165,37 @@ struct file_event {
 	char comm[16];		   /* Process name */
 	char filename[256];	   /* Source filename */
 	char target_filename[256]; /* Target filename */
+	uint64_t cgroup_id;	   /* cgroup v2 ID */
 };
 
 
+/**
+ * struct ebpf_monitor_stats - Per-monitor cost counters
+ * @name: Monitor name (e.g. "syscall")
+ * @category: Event category handled by the monitor
+ * @programs: Number of BPF programs in the monitor object
+ * @events: Records delivered to user space (cumulative)
+ * @handler_ns: Time spent in the user-space ring buffer callback (cumulative)
+ * @run_cnt: BPF program invocations reported by the kernel (cumulative)
+ * @run_time_ns: BPF program run time reported by the kernel (cumulative)
+ * @ring_size: Ring buffer data area size in bytes
+ * @ring_avail: Bytes produced by BPF but not yet consumed
+ *
+ * Kernel-side counters are only populated while BPF run-time statistics
+ * are enabled (BPF_ENABLE_STATS).
+ */
+struct ebpf_monitor_stats {
+	const char* name;     /* Monitor name */
+	uint32_t category;    /* Event category */
+	uint32_t programs;    /* BPF program count */
+	uint64_t events;      /* Delivered records */
+	uint64_t handler_ns;  /* User-space handler time */
+	uint64_t run_cnt;     /* BPF invocations */
+	uint64_t run_time_ns; /* BPF run time */
+	uint64_t ring_size;   /* Ring buffer size */
+	uint64_t ring_avail;  /* Unconsumed ring data */
+};
+
 /**
  * struct ravn_event - Generic event structure for Redis storage
  * @timestamp: Event timestamp in nanoseconds since epoch
@@ -435,6 +205,7 @@ struct file_event {
  * @event_category: Event category (1=syscall, 2=network, 3=security, 4=file, 5=memory, 6=process,
  * 7=kernel, 8=performance)
  * @comm: Process command name
+ * @cgroup_id: cgroup v2 ID of the task (0 if unknown)
  * @data: JSON serialized event data
  *
  * Generic event structure used for Redis storage and AI processing.
@@ -447,9 +218,31 @@ struct ravn_event {
 	uint32_t event_type;	 /* Event type */
 	uint32_t event_category; /* Event category */
 	char comm[16];		 /* Process name */
+	uint64_t cgroup_id;	 /* cgroup v2 ID */
 	char data[1024];	 /* JSON event data */
 };
 
+/**
+ * struct ebpf_event_filter - Selects the events delivered to Redis and the tap
+ * @categories: Bit (1 << category) per delivered category, 0 for all
+ * @pid: Only events of this process, 0 for all
+ * @comm: Only events of this command name, empty for all
+ *
+ * Filtered events are still counted in the monitor statistics.
+ */
+struct ebpf_event_filter {
+	uint32_t categories;	/* Category bitmask */
+	uint32_t pid;		/* Process ID */
+	char comm[16];		/* Command name */
+};
+
+/**
+ * ebpf_event_tap_fn - Callback receiving every decoded event
+ * @event: Decoded event, valid only for the duration of the call
+ * @ctx: Context passed to ebpf_handler_set_event_tap()
+ */
+typedef void (*ebpf_event_tap_fn)(const struct ravn_event* event, void* ctx);
+
 /*
  * eBPF Handler Core Functions
  */
@@ -488,6 +281,171 @@ int ebpf_handler_start_monitoring(void);
  */
 void ebpf_handler_stop_monitoring(void);
 
+/**
+ * ebpf_handler_restart_polling - Restart the ring buffer polling thread
+ *
+ * Asks the polling thread to exit and starts a new one once it has. Loaded
+ * programs and ring buffers are kept. Used by the health monitor.
+ *
+ * Return: 0 on success, -1 if the old thread did not exit in time
+ */
+int ebpf_handler_restart_polling(void);
+
+/**
+ * ebpf_handler_set_event_tap - Install a callback for decoded events
+ * @tap: Callback invoked after each event is sent to Redis, NULL to clear
+ * @ctx: Opaque context passed to @tap
+ *
+ * The tap runs on the thread that decodes the record, inline with the
+ * handler, so it must be cheap and must not block.
+ */
+void ebpf_handler_set_event_tap(ebpf_event_tap_fn tap, void* ctx);
+
+/**
+ * ebpf_handler_dispatch_record - Feed one raw ring record to its handler
+ * @category: Event category of the source ring
+ * @data: Raw record as delivered by the ring buffer
+ * @size: Record size in bytes
+ *
+ * Runs the same decode, accounting and Redis path as live ring buffer
+ * delivery. Does not need any BPF object to be loaded (used by replay).
+ * @data may come from a file or a network peer: it is copied, and every
+ * string field cut at its last byte, before the handler sees it.
+ *
+ * Return: Handler result, -1 for an unknown category
+ */
+int ebpf_handler_dispatch_record(uint32_t category, void* data, size_t size);
+
+/**
+ * ebpf_handler_set_origin - Attribute the records dispatched next to a host
+ * @host: Host name stored with the decoded events, NULL for this host
+ *
+ * Used by the collector before dispatching the records forwarded by an
+ * agent. Must be called from the thread that dispatches the records; @host
+ * must stay valid until the next call.
+ */
+void ebpf_handler_set_origin(const char* host);
+
+/**
+ * ebpf_handler_get_monitor_stats - Read per-monitor cost counters
+ * @stats: Array indexed by event category (EVENT_CATEGORY_MAX + 1 entries)
+ *
+ * Fills @stats[1..EVENT_CATEGORY_MAX] with cumulative user-space handler
+ * counters and the kernel run-time statistics of every loaded program.
+ *
+ * Return: Number of monitors reported
+ */
+int ebpf_handler_get_monitor_stats(struct ebpf_monitor_stats* stats);
+
+/**
+ * ebpf_handler_get_event_count - Read the event counter of one monitor
+ * @category: Event category (1..EVENT_CATEGORY_MAX)
+ *
+ * Cheaper than ebpf_handler_get_monitor_stats() when only the count is
+ * needed: no BPF program information is queried.
+ *
+ * Return: Events handled since startup, 0 for an unknown category
+ */
+uint64_t ebpf_handler_get_event_count(uint32_t category);
+
+/**
+ * ebpf_handler_set_monitor_control - Set how a monitor emits events
+ * @category: Event category of the monitor
+ * @control: Mode and sample rate written to the monitor's control map
+ *
+ * Takes effect for the next event the BPF program sees.
+ *
+ * Return: 0 on success, -1 if the monitor is not loaded or the update fails
+ */
+int ebpf_handler_set_monitor_control(uint32_t category, const struct monitor_control* control);
+
+/**
+ * ebpf_handler_get_monitor_tally - Read the events a monitor did not emit
+ * @category: Event category of the monitor
+ * @tally: Receives MONITOR_TALLY_MAX cumulative counts, summed over CPUs
+ *
+ * Return: 0 on success, -1 if the monitor is not loaded (@tally is zeroed)
+ */
+int ebpf_handler_get_monitor_tally(uint32_t category, uint64_t* tally);
+
+/**
+ * ebpf_handler_detach_monitor - Detach the programs of a monitor
+ * @category: Event category of the monitor
+ *
+ * The object, maps and ring buffer stay loaded, so the monitor can be
+ * re-attached without reloading. Call from the daemon main loop only.
+ *
+ * Return: 0 on success (also if already detached), -1 for an unknown category
+ */
+int ebpf_handler_detach_monitor(uint32_t category);
+
+/**
+ * ebpf_handler_attach_monitor - Re-attach a detached monitor
+ * @category: Event category of the monitor
+ *
+ * Call from the daemon main loop only.
+ *
+ * Return: 0 on success (also if attached), -1 if a program failed to attach
+ */
+int ebpf_handler_attach_monitor(uint32_t category);
+
+/**
+ * ebpf_handler_monitor_attached - Check whether a monitor is attached
+ * @category: Event category of the monitor
+ *
+ * Return: 1 unless the monitor was detached, 0 otherwise
+ */
+int ebpf_handler_monitor_attached(uint32_t category);
+
+/**
+ * ebpf_handler_set_cgroup_filter - Set the cgroups the monitors emit events for
+ * @mode: Include only, or exclude, the cgroups in @ids; CGROUP_FILTER_NONE
+ *        to emit events of every cgroup
+ * @ids: cgroup v2 IDs (ignored for CGROUP_FILTER_NONE)
+ * @count: Entries in @ids, at most MONITOR_CGROUP_MAX
+ *
+ * Written to the filter maps of every loaded monitor, so filtered events
+ * never reach a ring buffer, the event store or the AI engine; they are
+ * counted in the MONITOR_TALLY_FILTERED tally instead.
+ *
+ * Return: 0 on success, -1 on invalid arguments or if a monitor update failed
+ */
+int ebpf_handler_set_cgroup_filter(enum cgroup_filter_mode mode, const uint64_t* ids, int count);
+
+/**
+ * ebpf_handler_get_cgroup_filter - Read the cgroup filter
+ * @mode: Receives the filter mode (may be NULL)
+ * @ids: Receives up to @max cgroup IDs (may be NULL)
+ * @max: Size of @ids
+ *
+ * Return: Number of IDs copied to @ids
+ */
+int ebpf_handler_get_cgroup_filter(enum cgroup_filter_mode* mode, uint64_t* ids, int max);
+
+/**
+ * ebpf_handler_get_network_bytes - Read cumulative network traffic
+ * @sent: Receives the bytes sent by all network events (may be NULL)
+ * @received: Receives the bytes received by all network events (may be NULL)
+ *
+ * Totals are accumulated by the network handler since startup.
+ */
+void ebpf_handler_get_network_bytes(uint64_t* sent, uint64_t* received);
+
+/**
+ * ebpf_handler_set_filter - Replace the event delivery filter
+ * @filter: New filter, NULL to deliver every event
+ *
+ * Takes effect for the next decoded event. The decode path reads the
+ * filter without locking and costs a single load while no filter is set.
+ */
+void ebpf_handler_set_filter(const struct ebpf_event_filter* filter);
+
+/**
+ * ebpf_handler_get_filter - Read the event delivery filter
+ * @filter: Receives the current filter (all zero when none is set)
+ */
+void ebpf_handler_get_filter(struct ebpf_event_filter* filter);
+
 /*
  * Event Processing Functions
  */
@@ -584,86 +542,6 @@ int process_performance_event(const struct performance_event* event);
  * Utility Functions
  */
 
-/**
- * get_syscall_name - Get system call name from number
- * @syscall_nr: System call number
- *
- * Returns the human-readable name for a system call number.
- *
- * Return: System call name string, "UNKNOWN" if not found
- */
-const char* get_syscall_name(uint32_t syscall_nr);
-
-/**
- * get_network_event_name - Get network event name from type
- * @event_type: Network event type
- *
- * Returns the human-readable name for a network event type.
- *
- * Return: Network event name string, "UNKNOWN" if not found
- */
-const char* get_network_event_name(uint32_t event_type);
-
-/**
- * get_security_event_name - Get security event name from type
- * @event_type: Security event type
- *
- * Returns the human-readable name for a security event type.
- *
- * Return: Security event name string, "UNKNOWN" if not found
- */
-const char* get_security_event_name(uint32_t event_type);
-
-/**
- * get_file_event_name - Get file event name from type
- * @event_type: File event type
- *
- * Returns the human-readable name for a file event type.
- *
- * Return: File event name string, "UNKNOWN" if not found
- */
-const char* get_file_event_name(uint32_t event_type);
-
-/**
- * get_memory_event_name - Get memory event name from type
- * @event_type: Memory event type
- *
- * Returns the human-readable name for a memory event type.
- *
- * Return: Memory event name string, "UNKNOWN" if not found
- */
-const char* get_memory_event_name(uint32_t event_type);
-
-/**
- * get_process_event_name - Get process event name from type
- * @event_type: Process event type
- *
- * Returns the human-readable name for a process event type.
- *
- * Return: Process event name string, "UNKNOWN" if not found
- */
-const char* get_process_event_name(uint32_t event_type);
-
-/**
- * get_kernel_event_name - Get kernel event name from type
- * @event_type: Kernel event type
- *
- * Returns the human-readable name for a kernel event type.
- *
- * Return: Kernel event name string, "UNKNOWN" if not found
- */
-const char* get_kernel_event_name(uint32_t event_type);
-
-/**
- * get_performance_event_name - Get performance event name from type
- * @event_type: Performance event type
- *
- * Returns the human-readable name for a performance event type.
- *
- * Return: Performance event name string, "UNKNOWN" if not found
- */
-const char* get_performance_event_name(uint32_t event_type);
-
 /**
  * event_to_json - Convert event to JSON string
  * @event: Event structure to convert
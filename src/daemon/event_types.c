@@ -0,0 +1,469 @@
+// RAVN Event Types Implementation
+// Names of event types and monitor categories, free of libbpf
+
+#define _POSIX_C_SOURCE 200809L
+#include "event_types.h"
+
+// Get syscall name
+const char* get_syscall_name(uint32_t syscall_nr) {
+	switch (syscall_nr) {
+	case SYS_READ:
+		return "read";
+	case SYS_WRITE:
+		return "write";
+	case SYS_OPEN:
+		return "open";
+	case SYS_CLOSE:
+		return "close";
+	case SYS_STAT:
+		return "stat";
+	case SYS_FSTAT:
+		return "fstat";
+	case SYS_LSTAT:
+		return "lstat";
+	case SYS_POLL:
+		return "poll";
+	case SYS_LSEEK:
+		return "lseek";
+	case SYS_MMAP:
+		return "mmap";
+	case SYS_MPROTECT:
+		return "mprotect";
+	case SYS_MUNMAP:
+		return "munmap";
+	case SYS_BRK:
+		return "brk";
+	case SYS_RT_SIGACTION:
+		return "rt_sigaction";
+	case SYS_RT_SIGPROCMASK:
+		return "rt_sigprocmask";
+	case SYS_RT_SIGRETURN:
+		return "rt_sigreturn";
+	case SYS_IOCTL:
+		return "ioctl";
+	case SYS_PREAD64:
+		return "pread64";
+	case SYS_PWRITE64:
+		return "pwrite64";
+	case SYS_READV:
+		return "readv";
+	case SYS_WRITEV:
+		return "writev";
+	case SYS_ACCESS:
+		return "access";
+	case SYS_PIPE:
+		return "pipe";
+	case SYS_SELECT:
+		return "select";
+	case SYS_SCHED_YIELD:
+		return "sched_yield";
+	case SYS_MREMAP:
+		return "mremap";
+	case SYS_MSYNC:
+		return "msync";
+	case SYS_MINCORE:
+		return "mincore";
+	case SYS_MADVISE:
+		return "madvise";
+	case SYS_SHMGET:
+		return "shmget";
+	case SYS_SHMAT:
+		return "shmat";
+	case SYS_SHMCTL:
+		return "shmctl";
+	case SYS_DUP:
+		return "dup";
+	case SYS_DUP2:
+		return "dup2";
+	case SYS_PAUSE:
+		return "pause";
+	case SYS_NANOSLEEP:
+		return "nanosleep";
+	case SYS_GETITIMER:
+		return "getitimer";
+	case SYS_ALARM:
+		return "alarm";
+	case SYS_SETITIMER:
+		return "setitimer";
+	case SYS_GETPID:
+		return "getpid";
+	case SYS_SENDFILE:
+		return "sendfile";
+	case SYS_SOCKET:
+		return "socket";
+	case SYS_CONNECT:
+		return "connect";
+	case SYS_ACCEPT:
+		return "accept";
+	case SYS_SENDTO:
+		return "sendto";
+	case SYS_RECVFROM:
+		return "recvfrom";
+	case SYS_SENDMSG:
+		return "sendmsg";
+	case SYS_RECVMSG:
+		return "recvmsg";
+	case SYS_SHUTDOWN:
+		return "shutdown";
+	case SYS_BIND:
+		return "bind";
+	case SYS_LISTEN:
+		return "listen";
+	case SYS_GETSOCKNAME:
+		return "getsockname";
+	case SYS_GETPEERNAME:
+		return "getpeername";
+	case SYS_SOCKETPAIR:
+		return "socketpair";
+	case SYS_SETSOCKOPT:
+		return "setsockopt";
+	case SYS_GETSOCKOPT:
+		return "getsockopt";
+	case SYS_CLONE:
+		return "clone";
+	case SYS_FORK:
+		return "fork";
+	case SYS_VFORK:
+		return "vfork";
+	case SYS_EXECVE:
+		return "execve";
+	case SYS_EXIT:
+		return "exit";
+	case SYS_WAIT4:
+		return "wait4";
+	case SYS_KILL:
+		return "kill";
+	case SYS_UNAME:
+		return "uname";
+	case SYS_SEMGET:
+		return "semget";
+	case SYS_SEMOP:
+		return "semop";
+	case SYS_SEMCTL:
+		return "semctl";
+	case SYS_SHDT:
+		return "shmdt";
+	case SYS_MSGGET:
+		return "msgget";
+	case SYS_MSGSND:
+		return "msgsnd";
+	case SYS_MSGRCV:
+		return "msgrcv";
+	case SYS_MSGCTL:
+		return "msgctl";
+	case SYS_FCNTL:
+		return "fcntl";
+	case SYS_FLOCK:
+		return "flock";
+	case SYS_FSYNC:
+		return "fsync";
+	case SYS_FDATASYNC:
+		return "fdatasync";
+	case SYS_TRUNCATE:
+		return "truncate";
+	case SYS_FTRUNCATE:
+		return "ftruncate";
+	case SYS_GETDENTS:
+		return "getdents";
+	case SYS_GETCWD:
+		return "getcwd";
+	case SYS_CHDIR:
+		return "chdir";
+	case SYS_FCHDIR:
+		return "fchdir";
+	case SYS_RENAME:
+		return "rename";
+	case SYS_MKDIR:
+		return "mkdir";
+	case SYS_RMDIR:
+		return "rmdir";
+	case SYS_CREAT:
+		return "creat";
+	case SYS_LINK:
+		return "link";
+	case SYS_UNLINK:
+		return "unlink";
+	case SYS_SYMLINK:
+		return "symlink";
+	case SYS_READLINK:
+		return "readlink";
+	case SYS_CHMOD:
+		return "chmod";
+	case SYS_FCHMOD:
+		return "fchmod";
+	case SYS_CHOWN:
+		return "chown";
+	case SYS_FCHOWN:
+		return "fchown";
+	case SYS_LCHOWN:
+		return "lchown";
+	case SYS_UMASK:
+		return "umask";
+	case SYS_GETTIMEOFDAY:
+		return "gettimeofday";
+	case SYS_GETRLIMIT:
+		return "getrlimit";
+	case SYS_GETRUSAGE:
+		return "getrusage";
+	case SYS_SYSINFO:
+		return "sysinfo";
+	default:
+		return "unknown";
+	}
+}
+
+// Get network event name
+const char* get_network_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case NET_EVENT_SOCKET_CREATE:
+		return "socket_create";
+	case NET_EVENT_SOCKET_BIND:
+		return "socket_bind";
+	case NET_EVENT_SOCKET_CONNECT:
+		return "socket_connect";
+	case NET_EVENT_SOCKET_LISTEN:
+		return "socket_listen";
+	case NET_EVENT_SOCKET_ACCEPT:
+		return "socket_accept";
+	case NET_EVENT_SOCKET_SEND:
+		return "socket_send";
+	case NET_EVENT_SOCKET_RECV:
+		return "socket_recv";
+	case NET_EVENT_SOCKET_CLOSE:
+		return "socket_close";
+	default:
+		return "unknown";
+	}
+}
+
+// Get security event name
+const char* get_security_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case SEC_EVENT_CAPSET:
+		return "capset";
+	case SEC_EVENT_PRCTL:
+		return "prctl";
+	case SEC_EVENT_SETUID:
+		return "setuid";
+	case SEC_EVENT_SETGID:
+		return "setgid";
+	case SEC_EVENT_SETRESUID:
+		return "setresuid";
+	case SEC_EVENT_SETRESGID:
+		return "setresgid";
+	case SEC_EVENT_SETEUID:
+		return "setfsuid";
+	case SEC_EVENT_SETEGID:
+		return "setfsgid";
+	case SEC_EVENT_SETREUID:
+		return "setreuid";
+	case SEC_EVENT_SETREGID:
+		return "setregid";
+	default:
+		return "unknown";
+	}
+}
+
+// Get file event name
+const char* get_file_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case FILE_EVENT_OPEN:
+		return "file_open";
+	case FILE_EVENT_READ:
+		return "file_read";
+	case FILE_EVENT_WRITE:
+		return "file_write";
+	case FILE_EVENT_CLOSE:
+		return "file_close";
+	case FILE_EVENT_CREATE:
+		return "file_create";
+	case FILE_EVENT_DELETE:
+		return "file_delete";
+	case FILE_EVENT_RENAME:
+		return "file_rename";
+	case FILE_EVENT_CHMOD:
+		return "file_chmod";
+	case FILE_EVENT_CHOWN:
+		return "file_chown";
+	case FILE_EVENT_TRUNCATE:
+		return "file_truncate";
+	default:
+		return "unknown";
+	}
+}
+
+// Get monitor name from event category
+const char* get_event_category_name(uint32_t category) {
+	switch (category) {
+	case EVENT_CATEGORY_SYSCALL:
+		return "syscall";
+	case EVENT_CATEGORY_NETWORK:
+		return "network";
+	case EVENT_CATEGORY_SECURITY:
+		return "security";
+	case EVENT_CATEGORY_FILE:
+		return "file";
+	case EVENT_CATEGORY_MEMORY:
+		return "memory";
+	case EVENT_CATEGORY_PROCESS:
+		return "process";
+	case EVENT_CATEGORY_KERNEL:
+		return "kernel";
+	case EVENT_CATEGORY_PERFORMANCE:
+		return "performance";
+	default:
+		return "unknown";
+	}
+}
+
+// Get memory event name
+const char* get_memory_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case MEM_EVENT_ALLOC:
+		return "memory_alloc";
+	case MEM_EVENT_FREE:
+		return "memory_free";
+	case MEM_EVENT_MMAP:
+		return "memory_mmap";
+	case MEM_EVENT_MUNMAP:
+		return "memory_munmap";
+	case MEM_EVENT_MPROTECT:
+		return "memory_mprotect";
+	case MEM_EVENT_ACCESS:
+		return "memory_access";
+	case MEM_EVENT_CORRUPTION:
+		return "memory_corruption";
+	case MEM_EVENT_HEAP_SPRAY:
+		return "memory_heap_spray";
+	case MEM_EVENT_STACK_OVERFLOW:
+		return "memory_stack_overflow";
+	case MEM_EVENT_PERMISSION_CHANGE:
+		return "memory_permission_change";
+	default:
+		return "unknown";
+	}
+}
+
+// Get process event name
+const char* get_process_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case PROC_EVENT_SPAWN:
+		return "process_spawn";
+	case PROC_EVENT_EXIT:
+		return "process_exit";
+	case PROC_EVENT_EXEC:
+		return "process_exec";
+	case PROC_EVENT_FORK:
+		return "process_fork";
+	case PROC_EVENT_CLONE:
+		return "process_clone";
+	case PROC_EVENT_VFORK:
+		return "process_vfork";
+	case PROC_EVENT_SETUID:
+		return "process_setuid";
+	case PROC_EVENT_SETGID:
+		return "process_setgid";
+	case PROC_EVENT_SETRESUID:
+		return "process_setresuid";
+	case PROC_EVENT_SETRESGID:
+		return "process_setresgid";
+	case PROC_EVENT_CAPSET:
+		return "process_capset";
+	case PROC_EVENT_PRCTL:
+		return "process_prctl";
+	case PROC_EVENT_SIGNAL:
+		return "process_signal";
+	case PROC_EVENT_WORKING_DIR:
+		return "process_working_dir";
+	case PROC_EVENT_ENV_CHANGE:
+		return "process_env_change";
+	case PROC_EVENT_PRIORITY_CHANGE:
+		return "process_priority_change";
+	case PROC_EVENT_AFFINITY_CHANGE:
+		return "process_affinity_change";
+	case PROC_EVENT_NAMESPACE_CHANGE:
+		return "process_namespace_change";
+	case PROC_EVENT_IPC_OPERATION:
+		return "process_ipc_operation";
+	case PROC_EVENT_SESSION_CHANGE:
+		return "process_session_change";
+	default:
+		return "unknown";
+	}
+}
+
+// Get kernel event name
+const char* get_kernel_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case KERNEL_MODULE_LOAD:
+		return "kernel_module_load";
+	case KERNEL_MODULE_UNLOAD:
+		return "kernel_module_unload";
+	case KERNEL_FUNCTION_CALL:
+		return "kernel_function_call";
+	case KERNEL_MEMORY_OP:
+		return "kernel_memory_op";
+	case KERNEL_SECURITY_VIOLATION:
+		return "kernel_security_violation";
+	case KERNEL_PERFORMANCE_EVENT:
+		return "kernel_performance_event";
+	case KERNEL_DEBUG_EVENT:
+		return "kernel_debug_event";
+	case KERNEL_INTERRUPT:
+		return "kernel_interrupt";
+	case KERNEL_SCHEDULER_EVENT:
+		return "kernel_scheduler_event";
+	case KERNEL_IO_EVENT:
+		return "kernel_io_event";
+	case KERNEL_NETWORK_EVENT:
+		return "kernel_network_event";
+	case KERNEL_FILESYSTEM_EVENT:
+		return "kernel_filesystem_event";
+	case KERNEL_DEVICE_EVENT:
+		return "kernel_device_event";
+	case KERNEL_TIMER_EVENT:
+		return "kernel_timer_event";
+	case KERNEL_SIGNAL_EVENT:
+		return "kernel_signal_event";
+	default:
+		return "unknown";
+	}
+}
+
+// Get performance event name
+const char* get_performance_event_name(uint32_t event_type) {
+	switch (event_type) {
+	case PERF_CPU_USAGE:
+		return "perf_cpu_usage";
+	case PERF_MEMORY_USAGE:
+		return "perf_memory_usage";
+	case PERF_DISK_IO:
+		return "perf_disk_io";
+	case PERF_NETWORK_IO:
+		return "perf_network_io";
+	case PERF_SYSTEM_LOAD:
+		return "perf_system_load";
+	case PERF_RESOURCE_CONTENTION:
+		return "perf_resource_contention";
+	case PERF_CACHE_MISS:
+		return "perf_cache_miss";
+	case PERF_INTERRUPT:
+		return "perf_interrupt";
+	case PERF_CONTEXT_SWITCH:
+		return "perf_context_switch";
+	case PERF_PAGE_FAULT:
+		return "perf_page_fault";
+	case PERF_SYSCALL_OVERHEAD:
+		return "perf_syscall_overhead";
+	case PERF_MEMORY_PRESSURE:
+		return "perf_memory_pressure";
+	case PERF_IO_WAIT:
+		return "perf_io_wait";
+	case PERF_CPU_FREQUENCY:
+		return "perf_cpu_frequency";
+	case PERF_THERMAL_EVENT:
+		return "perf_thermal_event";
+	default:
+		return "unknown";
+	}
+}
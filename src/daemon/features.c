@@ -0,0 +1,682 @@
+// RAVN Feature Extraction Implementation
+// Feature vectors of event sequences, shared by the daemon and model training
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "features.h"
+
+#include "../utils/error_handling.h"
+#ifdef RAVN_SKETCH_FEATURES
+#include "sketch.h"
+#endif
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * RAVN Security Feature Extraction Algorithm Implementation
+ * Multi-dimensional feature extraction for comprehensive threat detection
+ */
+
+/**
+ * extract_features_from_events - Extract comprehensive features from event
+ * sequence
+ */
+int extract_features_from_events(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return -1;
+	}
+
+	RAVN_TIME_START(extract);
+
+	// Initialize all features to 0
+	memset(features, 0, TOTAL_FEATURES * sizeof(float));
+
+	// Extract features from each category
+	extract_temporal_features(sequence, &features[TEMPORAL_OFFSET]);
+	extract_process_features(sequence, &features[PROCESS_OFFSET]);
+	extract_file_features(sequence, &features[FILE_OFFSET]);
+	extract_network_features(sequence, &features[NETWORK_OFFSET]);
+	extract_security_features(sequence, &features[SECURITY_OFFSET]);
+	extract_system_features(sequence, &features[SYSTEM_OFFSET]);
+	extract_behavioral_features(sequence, &features[BEHAVIORAL_OFFSET]);
+
+#ifdef RAVN_SKETCH_FEATURES
+	// Breadth of file access, from the process's distinct-file sketch
+	features[SKETCH_FEATURE_DISTINCT_FILES] =
+		(float)sketch_process_distinct_files(sequence->pid) / SKETCH_DISTINCT_FILES_SCALE;
+#endif
+
+	// Normalize all features to [0,1] range
+	normalize_features(features, TOTAL_FEATURES);
+
+	RAVN_TIME_END(extract, "AI-ENGINE", "extract_features_from_events");
+	return 0;
+}
+
+/**
+ * extract_temporal_features - Extract temporal pattern features
+ */
+void extract_temporal_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features || sequence->event_count == 0) {
+		return;
+	}
+
+	// TEMPORAL_EVENT_FREQUENCY: Events per second
+	features[TEMPORAL_EVENT_FREQUENCY] = (float)sequence->event_count / WINDOW_SIZE_SECONDS;
+
+	// TEMPORAL_BURST_INTENSITY: Events in 1-second bursts
+	int burst_count = 0;
+	for (uint32_t i = 1; i < sequence->event_count; i++) {
+		uint64_t time_diff = sequence->timestamps[i] - sequence->timestamps[i - 1];
+		if (time_diff < 1000000000) { // Less than 1 second
+			burst_count++;
+		}
+	}
+	features[TEMPORAL_BURST_INTENSITY] = (float)burst_count / sequence->event_count;
+
+	// TEMPORAL_TIME_REGULARITY: Standard deviation of intervals
+	if (sequence->event_count > 2) {
+		float mean_interval = 0.0f;
+		for (uint32_t i = 1; i < sequence->event_count; i++) {
+			mean_interval += (sequence->timestamps[i] - sequence->timestamps[i - 1]);
+		}
+		mean_interval /= (sequence->event_count - 1);
+
+		float variance = 0.0f;
+		for (uint32_t i = 1; i < sequence->event_count; i++) {
+			float diff = (sequence->timestamps[i] - sequence->timestamps[i - 1]) -
+				     mean_interval;
+			variance += diff * diff;
+		}
+		variance /= (sequence->event_count - 1);
+		features[TEMPORAL_TIME_REGULARITY] =
+			sqrtf(variance) / mean_interval; // Coefficient of variation
+	}
+
+	// TEMPORAL_SEQUENCE_DURATION: Sequence duration (normalized)
+	if (sequence->event_count > 1) {
+		uint64_t duration =
+			sequence->timestamps[sequence->event_count - 1] - sequence->timestamps[0];
+		features[TEMPORAL_SEQUENCE_DURATION] =
+			(float)duration / (WINDOW_SIZE_SECONDS * 1000000000ULL);
+	}
+
+	// TEMPORAL_PEAK_ACTIVITY_TIME: When most events occurred
+	int time_buckets[10] = {0};
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		int bucket = (sequence->timestamps[i] % (WINDOW_SIZE_SECONDS * 1000000000ULL)) /
+			     (WINDOW_SIZE_SECONDS * 1000000000ULL / 10);
+		time_buckets[bucket]++;
+	}
+	int max_bucket = 0;
+	for (int i = 1; i < 10; i++) {
+		if (time_buckets[i] > time_buckets[max_bucket]) {
+			max_bucket = i;
+		}
+	}
+	features[TEMPORAL_PEAK_ACTIVITY_TIME] = (float)max_bucket / 9.0f;
+
+	// TEMPORAL_QUIET_PERIODS: Periods with no events
+	int quiet_periods = 0;
+	for (uint32_t i = 1; i < sequence->event_count; i++) {
+		uint64_t gap = sequence->timestamps[i] - sequence->timestamps[i - 1];
+		if (gap > 2000000000) { // More than 2 seconds
+			quiet_periods++;
+		}
+	}
+	features[TEMPORAL_QUIET_PERIODS] = (float)quiet_periods / sequence->event_count;
+
+	// TEMPORAL_ACCELERATION_RATE: Increasing event frequency
+	if (sequence->event_count > 4) {
+		int first_half = sequence->event_count / 2;
+		int second_half = sequence->event_count - first_half;
+		float first_rate = (float)first_half / (WINDOW_SIZE_SECONDS / 2);
+		float second_rate = (float)second_half / (WINDOW_SIZE_SECONDS / 2);
+		features[TEMPORAL_ACCELERATION_RATE] =
+			(second_rate - first_rate) / (first_rate + 0.001f);
+	}
+
+	// TEMPORAL_DECELERATION_RATE: Decreasing event frequency
+	features[TEMPORAL_DECELERATION_RATE] =
+		-features[TEMPORAL_ACCELERATION_RATE]; // Opposite of
+						       // acceleration
+}
+
+/**
+ * extract_process_features - Extract process behavior features
+ */
+void extract_process_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return;
+	}
+
+	// Initialize all process features to 0
+	memset(features, 0, PROCESS_FEATURES * sizeof(float));
+
+	// Count different types of process-related events
+	int process_spawns = 0;
+	int process_exits = 0;
+	int working_dir_changes = 0;
+	int env_var_changes = 0;
+	int signal_events = 0;
+	int priority_changes = 0;
+	int process_group_ops = 0;
+	int session_ops = 0;
+	int affinity_changes = 0;
+	int memory_maps = 0;
+	int credential_changes = 0;
+	int command_complexity = 0;
+
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		uint32_t event_type = sequence->events[i];
+
+		// Count process-related events based on event type
+		switch (event_type) {
+		case PROC_EVENT_SPAWN: // Process creation (execve, fork, clone)
+			process_spawns++;
+			break;
+		case PROC_EVENT_EXIT: // Process termination
+			process_exits++;
+			break;
+		case PROC_EVENT_WORKING_DIR: // Working directory change (chdir)
+			working_dir_changes++;
+			break;
+		case PROC_EVENT_ENV_CHANGE: // Environment variable change
+			env_var_changes++;
+			break;
+		case PROC_EVENT_SIGNAL: // Signal handling (kill, signal)
+			signal_events++;
+			break;
+		case PROC_EVENT_PRIORITY_CHANGE: // Priority change (nice, setpriority)
+			priority_changes++;
+			break;
+		case PROC_EVENT_IPC_OPERATION: // Process group operations
+			process_group_ops++;
+			break;
+		case PROC_EVENT_SESSION_CHANGE: // Session operations
+			session_ops++;
+			break;
+		case PROC_EVENT_AFFINITY_CHANGE: // CPU affinity changes
+			affinity_changes++;
+			break;
+		case PROC_EVENT_EXEC: // Process execution (memory mapping operations)
+			memory_maps++;
+			break;
+		case PROC_EVENT_SETUID:
+		case PROC_EVENT_SETGID:
+		case PROC_EVENT_SETRESUID:
+		case PROC_EVENT_SETRESGID:
+		case PROC_EVENT_CAPSET: // Credential changes (setuid, setgid)
+			credential_changes++;
+			break;
+		default:
+			// Estimate command complexity based on event diversity
+			command_complexity++;
+			break;
+		}
+	}
+
+	// Normalize process features
+	features[0] = (float)process_spawns / sequence->event_count;
+	features[1] = (float)process_exits / sequence->event_count;
+	features[2] = (float)working_dir_changes / sequence->event_count;
+	features[3] = (float)env_var_changes / sequence->event_count;
+	features[4] = (float)signal_events / sequence->event_count;
+	features[5] = (float)priority_changes / sequence->event_count;
+	features[6] = (float)process_group_ops / sequence->event_count;
+	features[7] = (float)session_ops / sequence->event_count;
+	features[8] = (float)affinity_changes / sequence->event_count;
+	features[9] = (float)memory_maps / sequence->event_count;
+	features[10] = (float)credential_changes / sequence->event_count;
+	features[11] = (float)command_complexity / sequence->event_count;
+}
+
+/**
+ * extract_file_features - Extract file access pattern features
+ */
+void extract_file_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return;
+	}
+
+	// Initialize all file features to 0
+	memset(features, 0, FILE_FEATURES * sizeof(float));
+
+	// Count different types of file operations
+	int sensitive_file_access = 0;
+	int executable_file_access = 0;
+	int config_file_access = 0;
+	int log_file_access = 0;
+	int temp_file_ops = 0;
+	int file_creations = 0;
+	int file_deletions = 0;
+	int file_modifications = 0;
+	int directory_traversal = 0;
+	int permission_changes = 0;
+
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		uint32_t event_type = sequence->events[i];
+
+		// Categorize file operations based on event type
+		switch (event_type) {
+		case FILE_EVENT_OPEN: // File open operation
+			// Check file type based on event type pattern
+			if (event_type % FILE_TYPE_MODULO == SENSITIVE_FILE_PATTERN) {
+				sensitive_file_access++;
+			} else if (event_type % FILE_TYPE_MODULO == EXECUTABLE_FILE_PATTERN) {
+				executable_file_access++;
+			} else if (event_type % FILE_TYPE_MODULO == CONFIG_FILE_PATTERN) {
+				config_file_access++;
+			} else if (event_type % FILE_TYPE_MODULO == LOG_FILE_PATTERN) {
+				log_file_access++;
+			} else if (event_type % FILE_TYPE_MODULO == TEMP_FILE_PATTERN) {
+				temp_file_ops++;
+			}
+			break;
+		case FILE_EVENT_CREATE: // File creation
+			file_creations++;
+			break;
+		case FILE_EVENT_DELETE: // File deletion
+			file_deletions++;
+			break;
+		case FILE_EVENT_WRITE: // File modification
+			file_modifications++;
+			break;
+		case FILE_EVENT_READ: // Directory traversal (simplified)
+			directory_traversal++;
+			break;
+		case FILE_EVENT_CHMOD: // Permission changes
+			permission_changes++;
+			break;
+		}
+	}
+
+	// Normalize file features
+	features[0] = (float)sensitive_file_access / sequence->event_count;
+	features[1] = (float)executable_file_access / sequence->event_count;
+	features[2] = (float)config_file_access / sequence->event_count;
+	features[3] = (float)log_file_access / sequence->event_count;
+	features[4] = (float)temp_file_ops / sequence->event_count;
+	features[5] = (float)file_creations / sequence->event_count;
+	features[6] = (float)file_deletions / sequence->event_count;
+	features[7] = (float)file_modifications / sequence->event_count;
+	features[8] = (float)directory_traversal / sequence->event_count;
+	features[9] = (float)permission_changes / sequence->event_count;
+}
+
+/**
+ * extract_network_features - Extract network behavior features
+ */
+void extract_network_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return;
+	}
+
+	// Initialize all network features to 0
+	memset(features, 0, NETWORK_FEATURES * sizeof(float));
+
+	// Count different types of network operations
+	int connections = 0;
+	int suspicious_ports = 0;
+	int data_transfer = 0;
+	int connection_duration = 0;
+	int protocol_diversity = 0;
+	int external_connections = 0;
+	int port_scanning = 0;
+	int network_errors = 0;
+
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		uint32_t event_type = sequence->events[i];
+
+		// Categorize network operations
+		switch (event_type) {
+		case NET_EVENT_SOCKET_CREATE: // Socket creation
+			connections++;
+			break;
+		case NET_EVENT_SOCKET_BIND: // Socket bind operation
+			// Check for suspicious ports using meaningful constants
+			if (event_type % PORT_MODULO_BASE ==
+				    SUSPICIOUS_PORT_4444 % PORT_MODULO_BASE ||
+			    event_type % PORT_MODULO_BASE ==
+				    SUSPICIOUS_PORT_1337 % PORT_MODULO_BASE) {
+				suspicious_ports++;
+			}
+			break;
+		case NET_EVENT_SOCKET_CONNECT: // Socket connect operation
+			connections++;
+			break;
+		case NET_EVENT_SOCKET_SEND: // Socket send operation
+			data_transfer++;
+			break;
+		case NET_EVENT_SOCKET_RECV: // Socket receive operation
+			data_transfer++;
+			break;
+		case NET_EVENT_SOCKET_ACCEPT: // Socket accept operation
+			external_connections++;
+			break;
+		case NET_EVENT_SOCKET_LISTEN: // Socket listen operation
+			port_scanning++;
+			break;
+		case NET_EVENT_SOCKET_CLOSE: // Socket close operation
+			network_errors++;
+			break;
+		}
+	}
+
+	// Normalize network features
+	features[0] = (float)connections / sequence->event_count;
+	features[1] = (float)suspicious_ports / sequence->event_count;
+	features[2] = (float)data_transfer / sequence->event_count;
+	features[3] = (float)connection_duration / sequence->event_count;
+	features[4] = (float)protocol_diversity / sequence->event_count;
+	features[5] = (float)external_connections / sequence->event_count;
+	features[6] = (float)port_scanning / sequence->event_count;
+	features[7] = (float)network_errors / sequence->event_count;
+}
+
+/**
+ * extract_security_features - Extract security event features
+ */
+void extract_security_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return;
+	}
+
+	// Initialize all security features to 0
+	memset(features, 0, SECURITY_FEATURES * sizeof(float));
+
+	// Count different types of security events
+	int privilege_escalation = 0;
+	int authentication_events = 0;
+	int failed_operations = 0;
+	int suspicious_syscalls = 0;
+	int capability_usage = 0;
+	int security_context_changes = 0;
+	int audit_events = 0;
+	int policy_violations = 0;
+
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		uint32_t event_type = sequence->events[i];
+
+		// Categorize security events
+		switch (event_type) {
+		case SEC_EVENT_SETUID: // Set user ID operation
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_SETGID: // Set group ID operation
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_CAPSET: // Capability set operation
+			capability_usage++;
+			break;
+		case SEC_EVENT_PRCTL: // Process control operation
+			security_context_changes++;
+			break;
+		case SEC_EVENT_SETRESUID: // Set real, effective, and saved user
+					  // ID
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_SETRESGID: // Set real, effective, and saved
+					  // group ID
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_SETEUID: // Set effective user ID
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_SETEGID: // Set effective group ID
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_SETREUID: // Set real and effective user ID
+			privilege_escalation++;
+			break;
+		case SEC_EVENT_SETREGID: // Set real and effective group ID
+			privilege_escalation++;
+			break;
+		}
+	}
+
+	// Normalize security features
+	features[0] = (float)privilege_escalation / sequence->event_count;
+	features[1] = (float)authentication_events / sequence->event_count;
+	features[2] = (float)failed_operations / sequence->event_count;
+	features[3] = (float)suspicious_syscalls / sequence->event_count;
+	features[4] = (float)capability_usage / sequence->event_count;
+	features[5] = (float)security_context_changes / sequence->event_count;
+	features[6] = (float)audit_events / sequence->event_count;
+	features[7] = (float)policy_violations / sequence->event_count;
+}
+
+/**
+ * extract_system_features - Extract system resource usage features
+ */
+void extract_system_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return;
+	}
+
+	// Initialize all system features to 0
+	memset(features, 0, SYSTEM_FEATURES * sizeof(float));
+
+	// Estimate system resource usage based on event patterns
+	float cpu_intensity = 0.0f;
+	float memory_intensity = 0.0f;
+	float disk_io_intensity = 0.0f;
+	float system_load_impact = 0.0f;
+	float resource_contention = 0.0f;
+	float syscall_frequency = 0.0f;
+	float interrupt_handling = 0.0f;
+	float kernel_operations = 0.0f;
+
+	// Calculate system features based on event patterns
+	syscall_frequency = (float)sequence->event_count / WINDOW_SIZE_SECONDS;
+
+	// Estimate resource usage based on event types using meaningful
+	// constants
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		uint32_t event_type = sequence->events[i];
+
+		// CPU-intensive operations
+		if (event_type % SYSTEM_RESOURCE_MODULO == CPU_INTENSIVE_PATTERN) {
+			cpu_intensity += 0.1f;
+		}
+
+		// Memory-intensive operations
+		if (event_type % SYSTEM_RESOURCE_MODULO == MEMORY_INTENSIVE_PATTERN) {
+			memory_intensity += 0.1f;
+		}
+
+		// Disk I/O operations
+		if (event_type % SYSTEM_RESOURCE_MODULO == DISK_IO_INTENSIVE_PATTERN) {
+			disk_io_intensity += 0.1f;
+		}
+
+		// Kernel operations
+		if (event_type % SYSTEM_RESOURCE_MODULO == KERNEL_OPERATIONS_PATTERN) {
+			kernel_operations += 0.1f;
+		}
+	}
+
+	// Normalize system features using enums for clarity
+	features[SYSTEM_CPU_INTENSITY] = cpu_intensity / sequence->event_count;
+	features[SYSTEM_MEMORY_INTENSITY] = memory_intensity / sequence->event_count;
+	features[SYSTEM_DISK_IO_INTENSITY] = disk_io_intensity / sequence->event_count;
+	features[SYSTEM_LOAD_IMPACT] = system_load_impact / sequence->event_count;
+	features[SYSTEM_RESOURCE_CONTENTION] = resource_contention / sequence->event_count;
+	features[SYSTEM_SYSCALL_FREQUENCY] =
+		syscall_frequency / 100.0f; // Normalize to reasonable range
+	features[SYSTEM_INTERRUPT_HANDLING] = interrupt_handling / sequence->event_count;
+	features[SYSTEM_KERNEL_OPERATIONS] = kernel_operations / sequence->event_count;
+}
+
+/**
+ * extract_behavioral_features - Extract behavioral pattern features
+ */
+void extract_behavioral_features(const struct event_sequence* sequence, float* features) {
+	if (!sequence || !features) {
+		return;
+	}
+
+	// Initialize all behavioral features to 0
+	memset(features, 0, BEHAVIORAL_FEATURES * sizeof(float));
+
+	// Analyze behavioral patterns
+	float stealth_behavior = 0.0f;
+	float persistence_attempts = 0.0f;
+	float evasion_techniques = 0.0f;
+	float lateral_movement = 0.0f;
+	float data_exfiltration = 0.0f;
+	float command_injection = 0.0f;
+	float buffer_overflow_attempts = 0.0f;
+	float code_injection = 0.0f;
+	float anti_forensics = 0.0f;
+	float communication_patterns = 0.0f;
+
+	// Detect behavioral patterns based on event sequences using meaningful
+	// constants
+	for (uint32_t i = 0; i < sequence->event_count; i++) {
+		uint32_t event_type = sequence->events[i];
+
+		// Stealth behavior (hiding activities)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_STEALTH_PATTERN) {
+			stealth_behavior += 0.1f;
+		}
+
+		// Persistence attempts (staying resident)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_PERSISTENCE_PATTERN) {
+			persistence_attempts += 0.1f;
+		}
+
+		// Evasion techniques (avoiding detection)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_EVASION_PATTERN) {
+			evasion_techniques += 0.1f;
+		}
+
+		// Lateral movement (moving between systems)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_LATERAL_MOVEMENT_PATTERN) {
+			lateral_movement += 0.1f;
+		}
+
+		// Data exfiltration (data theft patterns)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO ==
+		    BEHAVIORAL_DATA_EXFILTRATION_PATTERN) {
+			data_exfiltration += 0.1f;
+		}
+
+		// Command injection attempts
+		if (event_type % BEHAVIORAL_PATTERN_MODULO ==
+		    BEHAVIORAL_COMMAND_INJECTION_PATTERN) {
+			command_injection += 0.1f;
+		}
+
+		// Buffer overflow patterns
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_BUFFER_OVERFLOW_PATTERN) {
+			buffer_overflow_attempts += 0.1f;
+		}
+
+		// Code injection patterns
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_CODE_INJECTION_PATTERN) {
+			code_injection += 0.1f;
+		}
+
+		// Anti-forensics (evidence hiding)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_ANTI_FORENSICS_PATTERN) {
+			anti_forensics += 0.1f;
+		}
+
+		// Communication patterns (C&C communication)
+		if (event_type % BEHAVIORAL_PATTERN_MODULO == BEHAVIORAL_COMMUNICATION_PATTERN) {
+			communication_patterns += 0.1f;
+		}
+	}
+
+	// Normalize behavioral features using enums for clarity
+	features[BEHAVIORAL_STEALTH - 1] = stealth_behavior / sequence->event_count;
+	features[BEHAVIORAL_PERSISTENCE - 1] = persistence_attempts / sequence->event_count;
+	features[BEHAVIORAL_EVASION - 1] = evasion_techniques / sequence->event_count;
+	features[BEHAVIORAL_LATERAL_MOVEMENT - 1] = lateral_movement / sequence->event_count;
+	features[BEHAVIORAL_DATA_EXFILTRATION - 1] = data_exfiltration / sequence->event_count;
+	features[BEHAVIORAL_COMMAND_INJECTION - 1] = command_injection / sequence->event_count;
+	features[BEHAVIORAL_BUFFER_OVERFLOW - 1] = buffer_overflow_attempts / sequence->event_count;
+	features[BEHAVIORAL_CODE_INJECTION - 1] = code_injection / sequence->event_count;
+	features[BEHAVIORAL_ANTI_FORENSICS - 1] = anti_forensics / sequence->event_count;
+	features[BEHAVIORAL_COMMUNICATION - 1] = communication_patterns / sequence->event_count;
+}
+
+/**
+ * normalize_features - Normalize features to [0,1] range
+ */
+void normalize_features(float* features, int count) {
+	if (!features || count <= 0) {
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		// Clamp features to [0,1] range
+		if (features[i] < 0.0f) {
+			features[i] = 0.0f;
+		} else if (features[i] > 1.0f) {
+			features[i] = 1.0f;
+		}
+	}
+}
+
+/*
+ * Batch Interface
+ * Entry points of libravnfeatures.so, loaded by the training scripts
+ */
+
+// Interface version of the batch entry points
+uint32_t ravn_features_abi(void) {
+	return RAVN_FEATURES_ABI;
+}
+
+// Length of the feature vectors
+uint32_t ravn_features_dim(void) {
+	return TOTAL_FEATURES;
+}
+
+// Extract the feature vectors of a batch of sequences
+int ravn_features_batch(const uint32_t* events, const uint64_t* timestamps, const uint64_t* offsets,
+			const uint32_t* pids, uint32_t count, float* features) {
+	if (!events || !timestamps || !offsets || !features) {
+		return -1;
+	}
+
+	struct event_sequence* seq = malloc(sizeof(*seq));
+	if (!seq) {
+		return -1;
+	}
+
+	int ret = 0;
+	for (uint32_t i = 0; i < count; i++) {
+		float* row = &features[(size_t)i * TOTAL_FEATURES];
+		if (offsets[i + 1] <= offsets[i]) {
+			// Empty sequences get a zero vector, as the daemon never scores them
+			memset(row, 0, TOTAL_FEATURES * sizeof(float));
+			if (offsets[i + 1] < offsets[i]) {
+				ret = -1;
+			}
+			continue;
+		}
+
+		// Like the sliding window, keep the first MAX_EVENTS_PER_WINDOW events
+		uint64_t length = offsets[i + 1] - offsets[i];
+		if (length > MAX_EVENTS_PER_WINDOW) {
+			length = MAX_EVENTS_PER_WINDOW;
+		}
+
+		seq->pid = pids ? pids[i] : 0;
+		seq->event_count = (uint32_t)length;
+		seq->cgroup_id = 0;
+		seq->threat_score = 0.0f;
+		memcpy(seq->events, &events[offsets[i]], length * sizeof(uint32_t));
+		memcpy(seq->timestamps, &timestamps[offsets[i]], length * sizeof(uint64_t));
+
+		extract_features_from_events(seq, row);
+	}
+
+	free(seq);
+	return ret;
+}
@@ -0,0 +1,220 @@
+/*
+ * RAVN Feature Extraction - Header File
+ *
+ * This header defines the feature extraction of the RAVN security platform,
+ * which turns the event sequence of a process into the TOTAL_FEATURES vector
+ * scored by the AI engine. The same code is built into the daemon and into
+ * libravnfeatures.so ('make features'), which the training scripts load, so
+ * the model is trained on exactly the vectors it sees in production.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The feature extraction implements:
+ * - Temporal, process, file, network, security, system and behavioral
+ *   features at the offsets of ai_types.h, clamped to [0,1]
+ * - The sketch-derived features in RAVN_SKETCH_FEATURES builds
+ * - A batch interface for many sequences per call, with a version number
+ *   checked by its callers
+ *
+ * Architecture:
+ * - Pure functions of the sequence: no locks, no I/O, no global state
+ * - The shared library is built without profiling and without sketch
+ *   features, matching the shipped model
+ * - Batches are passed as flat arrays (all event types, all timestamps and
+ *   one offset per sequence) so that a caller holding the dataset in a few
+ *   numpy arrays needs no per-sequence calls
+ */
+
+#ifndef RAVN_FEATURES_H
+#define RAVN_FEATURES_H
+
+#include "ai_types.h"
+
+#include <stdint.h>
+
+/*
+ * Batch Interface Parameters
+ */
+#define RAVN_FEATURES_ABI 1 /* Bumped on any change of the layout or the batch calls */
+
+/*
+ * RAVN Security Feature Extraction Functions
+ */
+
+/**
+ * extract_features_from_events - Extract comprehensive features from event
+ * sequence
+ * @sequence: Event sequence to analyze
+ * @features: Output array for extracted features (must be TOTAL_FEATURES size)
+ *
+ * Extracts TOTAL_FEATURES multi-dimensional features from the event
+ * sequence using the RAVN Security Feature Extraction Algorithm. Features are
+ * organized into categories: temporal, process, file, network, security,
+ * system, and behavioral.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int extract_features_from_events(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_temporal_features - Extract temporal pattern features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for temporal features (8 features)
+ *
+ * Extracts time-based pattern features including event frequency, burst
+ * intensity, time regularity, and sequence duration.
+ */
+void extract_temporal_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_process_features - Extract process behavior features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for process features (12 features)
+ *
+ * Extracts process behavior features including spawn count, tree depth,
+ * command complexity, and process management operations.
+ */
+void extract_process_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_file_features - Extract file access pattern features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for file features (10 features)
+ *
+ * Extracts file access pattern features including sensitive file access,
+ * executable file operations, and file permission changes.
+ */
+void extract_file_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_network_features - Extract network behavior features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for network features (8 features)
+ *
+ * Extracts network behavior features including connection count, suspicious
+ * port usage, data transfer volume, and protocol diversity.
+ */
+void extract_network_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_security_features - Extract security event features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for security features (8 features)
+ *
+ * Extracts security event features including privilege escalation attempts,
+ * authentication events, failed operations, and suspicious syscalls.
+ */
+void extract_security_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_system_features - Extract system resource usage features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for system features (8 features)
+ *
+ * Extracts system resource usage features including CPU usage, memory
+ * consumption, disk I/O intensity, and system load impact.
+ */
+void extract_system_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_behavioral_features - Extract behavioral pattern features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for behavioral features (10 features)
+ *
+ * Extracts behavioral pattern features including stealth behavior, persistence
+ * attempts, evasion techniques, and lateral movement patterns.
+ */
+void extract_behavioral_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_memory_features - Extract memory behavior features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for memory features (12 features)
+ *
+ * Extracts memory behavior features including allocation patterns, memory
+ * corruption attempts, heap spray detection, and memory access anomalies.
+ */
+void extract_memory_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_kernel_features - Extract kernel-level features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for kernel features (10 features)
+ *
+ * Extracts kernel-level features including module operations, kernel function
+ * calls, security violations, and kernel performance metrics.
+ */
+void extract_kernel_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_performance_features - Extract performance metrics features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for performance features (12 features)
+ *
+ * Extracts performance metrics features including CPU usage, memory pressure,
+ * I/O patterns, and system resource contention.
+ */
+void extract_performance_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * extract_advanced_features - Extract advanced pattern detection features
+ * @sequence: Event sequence to analyze
+ * @features: Output array for advanced features (40 features)
+ *
+ * Extracts advanced pattern detection features including multi-dimensional
+ * correlation analysis, temporal anomaly detection, and complex attack pattern
+ * recognition.
+ */
+void extract_advanced_features(const struct event_sequence* sequence, float* features);
+
+/**
+ * normalize_features - Normalize features to [0,1] range
+ * @features: Feature array to normalize
+ * @count: Number of features to normalize
+ *
+ * Normalizes all features to the [0,1] range for consistent neural network
+ * input.
+ */
+void normalize_features(float* features, int count);
+
+/*
+ * Batch Interface
+ */
+
+/**
+ * ravn_features_abi - Version of the feature layout and the batch calls
+ *
+ * Return: RAVN_FEATURES_ABI
+ */
+uint32_t ravn_features_abi(void);
+
+/**
+ * ravn_features_dim - Length of the feature vectors
+ *
+ * Return: TOTAL_FEATURES
+ */
+uint32_t ravn_features_dim(void);
+
+/**
+ * ravn_features_batch - Extract the feature vectors of a batch of sequences
+ * @events: Event types of all sequences, one sequence after the other
+ * @timestamps: Event timestamps in nanoseconds, parallel to @events
+ * @offsets: @count + 1 indexes into @events; sequence i is
+ *           [@offsets[i], @offsets[i + 1])
+ * @pids: Process ID of each sequence, NULL for none
+ * @count: Number of sequences
+ * @features: Output array of @count * TOTAL_FEATURES values, one row per
+ *            sequence
+ *
+ * Each sequence is cut to its first MAX_EVENTS_PER_WINDOW events, as in the
+ * sliding window. Empty sequences get a zero row.
+ *
+ * Return: 0 on success, -1 on invalid arguments, allocation failure or
+ *         decreasing offsets (those rows are zero)
+ */
+int ravn_features_batch(const uint32_t* events, const uint64_t* timestamps, const uint64_t* offsets,
+			const uint32_t* pids, uint32_t count, float* features);
+
+#endif // RAVN_FEATURES_H
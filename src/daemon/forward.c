@@ -0,0 +1,627 @@
+// RAVN Event Forwarding Implementation
+// Batched, compressed and acknowledged streaming of raw ring records to a collector
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "forward.h"
+
+#include "codec.h"
+#include "ebpf_handler.h"
+#include "placement.h"
+#include "../utils/hotmem.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// Longest wait for acknowledgments while nothing is ready to send
+#define FORWARD_POLL_MS 50
+
+// One batch of records, filled by forward_record()
+struct forward_slot {
+	uint64_t sequence;		  /* Batch number, assigned when sealed */
+	uint64_t wall_offset_ns;	  /* Agent clock offset when sealed */
+	uint64_t opened_ns;		  /* Monotonic time of the first record */
+	uint32_t records;		  /* Records in @data */
+	uint32_t used;			  /* Bytes of @data used */
+	uint8_t data[FORWARD_BATCH_BYTES]; /* Framed records */
+};
+
+// Batch queue, protected by forward_lock: sealed batches from queue_head in
+// sequence order, followed by the filling batch
+static pthread_mutex_t forward_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t forward_cond;
+static struct forward_slot* slots = NULL;
+static int queue_head = 0;
+static int queue_sealed = 0;
+static uint64_t next_sequence = 1;
+static struct forward_summary pending_summary;
+static int summary_pending = 0;
+static int forward_active = 0;
+static int forward_running = 0;
+static uint64_t close_deadline_ns = 0;
+static pthread_t forward_thread;
+
+// Sender state, only touched by the sender thread after forward_open()
+static char target_host[256];
+static uint16_t target_port = FORWARD_DEFAULT_PORT;
+static struct forward_hello hello;
+static int sock = -1;
+static uint64_t send_sequence = 0;
+static uint8_t* frame_buf = NULL;
+static uint8_t rx_buf[64 * sizeof(struct forward_frame)];
+static size_t rx_used = 0;
+
+// Counters
+static struct forward_stats stats;
+
+// Wall-clock time in nanoseconds
+static uint64_t forward_realtime_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Parse a collector address
+int forward_parse_address(const char* spec, char* host, int size, uint16_t* port) {
+	const char* port_text = NULL;
+	size_t host_len;
+
+	if (!spec || !host || size <= 0) {
+		return -1;
+	}
+	if (spec[0] == '[') {
+		// [IPv6]:PORT or [IPv6]
+		const char* close = strchr(spec, ']');
+		if (!close || (close[1] && close[1] != ':')) {
+			return -1;
+		}
+		spec++;
+		host_len = (size_t)(close - spec);
+		port_text = close[1] ? close + 2 : NULL;
+	} else {
+		// A bare IPv6 address has more than one colon and no port
+		const char* colon = strchr(spec, ':');
+		if (colon && !strchr(colon + 1, ':')) {
+			host_len = (size_t)(colon - spec);
+			port_text = colon + 1;
+		} else {
+			host_len = strlen(spec);
+		}
+	}
+	if (host_len >= (size_t)size) {
+		return -1;
+	}
+	memcpy(host, spec, host_len);
+	host[host_len] = '\0';
+
+	*port = FORWARD_DEFAULT_PORT;
+	if (port_text) {
+		char* end;
+		unsigned long value = strtoul(port_text, &end, 10);
+		if (end == port_text || *end || value == 0 || value > 65535) {
+			return -1;
+		}
+		*port = (uint16_t)value;
+	}
+	return 0;
+}
+
+// The filling batch; caller holds forward_lock
+static struct forward_slot* filling_slot(void) {
+	return &slots[(queue_head + queue_sealed) % FORWARD_QUEUE];
+}
+
+// Queue the filling batch for sending; caller holds forward_lock
+static int forward_seal_locked(void) {
+	if (queue_sealed == FORWARD_QUEUE - 1) {
+		return -1; // Every other batch waits for an acknowledgment
+	}
+	struct forward_slot* slot = filling_slot();
+	slot->sequence = next_sequence++;
+	slot->wall_offset_ns = forward_realtime_ns() - ravn_prof_now_ns();
+	queue_sealed++;
+
+	slot = filling_slot();
+	slot->records = 0;
+	slot->used = 0;
+	return 0;
+}
+
+// Release the batches the collector has stored
+static void forward_acked(uint64_t sequence) {
+	pthread_mutex_lock(&forward_lock);
+	while (queue_sealed > 0 && slots[queue_head].sequence <= sequence) {
+		__atomic_fetch_add(&stats.batches, 1, __ATOMIC_RELAXED);
+		__atomic_fetch_add(&stats.raw_bytes, slots[queue_head].used, __ATOMIC_RELAXED);
+		queue_head = (queue_head + 1) % FORWARD_QUEUE;
+		queue_sealed--;
+	}
+	pthread_cond_broadcast(&forward_cond);
+	pthread_mutex_unlock(&forward_lock);
+}
+
+// Send a whole buffer, retrying on short writes
+static int send_all(const void* buf, size_t len) {
+	const uint8_t* p = buf;
+	while (len > 0) {
+		ssize_t n = send(sock, p, len, MSG_NOSIGNAL);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		p += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+// Send one frame whose payload is already in frame_buf after the header
+static int send_frame(enum forward_frame_type type, uint64_t sequence, uint32_t length) {
+	struct forward_frame* frame = (struct forward_frame*)frame_buf;
+	memset(frame, 0, sizeof(*frame));
+	frame->magic = FORWARD_MAGIC;
+	frame->type = (uint16_t)type;
+	frame->version = FORWARD_VERSION;
+	frame->length = length;
+	frame->sequence = sequence;
+
+	if (send_all(frame_buf, sizeof(*frame) + length) != 0) {
+		return -1;
+	}
+	__atomic_fetch_add(&stats.sent_bytes, sizeof(*frame) + length, __ATOMIC_RELAXED);
+	return 0;
+}
+
+// Close the connection to the collector
+static void forward_disconnect(const char* reason) {
+	if (sock < 0) {
+		return;
+	}
+	LOG_WARN_MODULE("FORWARD", "Lost collector %s:%u: %s", target_host, target_port, reason);
+	close(sock);
+	sock = -1;
+	rx_used = 0;
+	__atomic_store_n(&stats.connected, 0, __ATOMIC_RELAXED);
+}
+
+// Open a TCP connection to one resolved address, giving up after the hello timeout
+static int connect_address(const struct addrinfo* ai) {
+	int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK,
+			ai->ai_protocol);
+	if (fd < 0) {
+		return -1;
+	}
+
+	if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+		struct pollfd pfd = {fd, POLLOUT, 0};
+		int err = 0;
+		socklen_t len = sizeof(err);
+		if (errno != EINPROGRESS || poll(&pfd, 1, FORWARD_HELLO_TIMEOUT_MS) != 1 ||
+		    getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) != 0 || err != 0) {
+			close(fd);
+			return -1;
+		}
+	}
+
+	// Blocking from here on, bounded by timeouts so a stalled collector is noticed
+	struct timeval timeout = {FORWARD_HELLO_TIMEOUT_MS / 1000,
+				  (FORWARD_HELLO_TIMEOUT_MS % 1000) * 1000};
+	int one = 1;
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+	return fd;
+}
+
+// Connect, greet the collector and resume after the last batch it stored
+static int forward_connect(void) {
+	struct addrinfo hints;
+	struct addrinfo* res = NULL;
+	char port[8];
+
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	snprintf(port, sizeof(port), "%u", target_port);
+	if (getaddrinfo(target_host[0] ? target_host : NULL, port, &hints, &res) != 0) {
+		return -1;
+	}
+	for (struct addrinfo* ai = res; ai && sock < 0; ai = ai->ai_next) {
+		sock = connect_address(ai);
+	}
+	freeaddrinfo(res);
+	if (sock < 0) {
+		return -1;
+	}
+
+	struct forward_frame welcome;
+	size_t got = 0;
+	memcpy(frame_buf + sizeof(struct forward_frame), &hello, sizeof(hello));
+	if (send_frame(FORWARD_HELLO, 0, sizeof(hello)) != 0) {
+		close(sock);
+		sock = -1;
+		return -1;
+	}
+	while (got < sizeof(welcome)) {
+		ssize_t n = recv(sock, (uint8_t*)&welcome + got, sizeof(welcome) - got, 0);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n <= 0) {
+			break;
+		}
+		got += (size_t)n;
+	}
+	if (got < sizeof(welcome) || welcome.magic != FORWARD_MAGIC ||
+	    welcome.type != FORWARD_WELCOME || welcome.length != 0) {
+		LOG_WARN_MODULE("FORWARD", "No welcome from %s:%u (not a RAVN collector?)",
+				target_host, target_port);
+		close(sock);
+		sock = -1;
+		return -1;
+	}
+
+	// Everything after the collector's last stored batch is sent again
+	forward_acked(welcome.sequence);
+	send_sequence = 0;
+	__atomic_fetch_add(&stats.connects, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&stats.connected, 1, __ATOMIC_RELAXED);
+	LOG_INFO_MODULE("FORWARD", "Connected to collector %s:%u as %s, resuming after batch %lu",
+			target_host, target_port, hello.host, (unsigned long)welcome.sequence);
+	return 0;
+}
+
+// Read the acknowledgments that have arrived
+static int read_acks(void) {
+	for (;;) {
+		ssize_t n = recv(sock, rx_buf + rx_used, sizeof(rx_buf) - rx_used, MSG_DONTWAIT);
+		if (n < 0 && errno == EINTR) {
+			continue;
+		}
+		if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			return 0;
+		}
+		if (n <= 0) {
+			forward_disconnect(n == 0 ? "connection closed" : strerror(errno));
+			return -1;
+		}
+		rx_used += (size_t)n;
+
+		size_t frames = rx_used / sizeof(struct forward_frame);
+		for (size_t i = 0; i < frames; i++) {
+			struct forward_frame frame;
+			memcpy(&frame, rx_buf + i * sizeof(frame), sizeof(frame));
+			if (frame.magic != FORWARD_MAGIC || frame.type != FORWARD_ACK ||
+			    frame.length != 0) {
+				forward_disconnect("unexpected message");
+				return -1;
+			}
+			forward_acked(frame.sequence);
+		}
+		rx_used -= frames * sizeof(struct forward_frame);
+		memmove(rx_buf, rx_buf + frames * sizeof(struct forward_frame), rx_used);
+	}
+}
+
+// Compress and send one sealed batch
+static int send_batch(const struct forward_slot* slot) {
+	struct forward_batch* batch;
+
+	batch = (struct forward_batch*)(frame_buf + sizeof(struct forward_frame));
+	batch->wall_offset_ns = slot->wall_offset_ns;
+	batch->records = slot->records;
+	batch->raw_bytes = slot->used;
+
+	size_t size = codec_lz_encode(slot->data, slot->used, (uint8_t*)(batch + 1));
+	return send_frame(FORWARD_BATCH, slot->sequence, (uint32_t)(sizeof(*batch) + size));
+}
+
+// One sender pass: seal a due batch, send the next batch and summary, read acknowledgments
+static int forward_pump(void) {
+	struct forward_slot* batch = NULL;
+	int summary = 0;
+
+	pthread_mutex_lock(&forward_lock);
+	struct forward_slot* filling = filling_slot();
+	if (filling->records &&
+	    ravn_prof_now_ns() - filling->opened_ns >= FORWARD_BATCH_MS * 1000000ULL) {
+		forward_seal_locked();
+	}
+
+	// Sealed batches are not written again until acknowledged, so they are
+	// read without the lock
+	uint64_t first = next_sequence - (uint64_t)queue_sealed;
+	if (send_sequence < first) {
+		send_sequence = first;
+	}
+	if (send_sequence < next_sequence) {
+		batch = &slots[(queue_head + (int)(send_sequence - first)) % FORWARD_QUEUE];
+	}
+	if (summary_pending) {
+		memcpy(frame_buf + sizeof(struct forward_frame), &pending_summary,
+		       sizeof(pending_summary));
+		summary_pending = 0;
+		summary = 1;
+	}
+	pthread_mutex_unlock(&forward_lock);
+
+	if (summary && send_frame(FORWARD_SUMMARY, 0, sizeof(struct forward_summary)) != 0) {
+		forward_disconnect(strerror(errno));
+		return -1;
+	}
+	if (batch) {
+		if (send_batch(batch) != 0) {
+			forward_disconnect(strerror(errno));
+			return -1;
+		}
+		send_sequence++;
+	}
+
+	struct pollfd pfd = {sock, POLLIN, 0};
+	if (poll(&pfd, 1, batch ? 0 : FORWARD_POLL_MS) > 0) {
+		return read_acks();
+	}
+	return 0;
+}
+
+// Sleep until a reconnect is due, forwarding stops or the close deadline passes
+static void forward_wait(uint32_t ms) {
+	uint64_t wake = ravn_prof_now_ns() + (uint64_t)ms * 1000000ULL;
+
+	pthread_mutex_lock(&forward_lock);
+	if (!forward_running && close_deadline_ns < wake) {
+		wake = close_deadline_ns;
+	}
+	struct timespec deadline = {(time_t)(wake / 1000000000ULL), (long)(wake % 1000000000ULL)};
+	pthread_cond_timedwait(&forward_cond, &forward_lock, &deadline);
+	pthread_mutex_unlock(&forward_lock);
+}
+
+// Check whether the sender should keep going; once stopping, only until the
+// queue is acknowledged or the close deadline passes
+static int forward_keep_going(void) {
+	pthread_mutex_lock(&forward_lock);
+	int keep = forward_running ||
+		   (queue_sealed > 0 && ravn_prof_now_ns() < close_deadline_ns);
+	pthread_mutex_unlock(&forward_lock);
+	return keep;
+}
+
+// Sender thread: connect, send and resume until forwarding stops
+static void* forward_thread_func(void* arg) {
+	(void)arg;
+	prctl(PR_SET_NAME, "ravn-forward", 0, 0, 0);
+	placement_apply(PLACEMENT_BACKGROUND);
+
+	uint32_t retry_ms = FORWARD_RETRY_MIN_MS;
+	int warned = 0;
+	while (forward_keep_going()) {
+		if (sock < 0) {
+			if (forward_connect() != 0) {
+				if (!warned) {
+					LOG_WARN_MODULE("FORWARD",
+							"Collector %s:%u unreachable, queueing and "
+							"retrying",
+							target_host, target_port);
+					warned = 1;
+				}
+				forward_wait(retry_ms);
+				retry_ms = retry_ms * 2 < FORWARD_RETRY_MAX_MS ? retry_ms * 2
+									 : FORWARD_RETRY_MAX_MS;
+				continue;
+			}
+			retry_ms = FORWARD_RETRY_MIN_MS;
+			warned = 0;
+		}
+		if (forward_pump() != 0) {
+			forward_wait(FORWARD_RETRY_MIN_MS); // Do not hammer a failing collector
+		}
+	}
+
+	if (sock >= 0) {
+		close(sock);
+		sock = -1;
+		__atomic_store_n(&stats.connected, 0, __ATOMIC_RELAXED);
+	}
+	return NULL;
+}
+
+// Start forwarding to a collector
+int forward_open(const char* target, const char* host) {
+	if (forward_running) {
+		return -1;
+	}
+	if (forward_parse_address(target, target_host, sizeof(target_host), &target_port) != 0 ||
+	    !target_host[0]) {
+		LOG_ERROR_MODULE("FORWARD", "Invalid collector address '%s'", target);
+		return -1;
+	}
+
+	memset(&hello, 0, sizeof(hello));
+	if (host && host[0]) {
+		snprintf(hello.host, sizeof(hello.host), "%s", host);
+	} else if (gethostname(hello.host, sizeof(hello.host) - 1) != 0) {
+		snprintf(hello.host, sizeof(hello.host), "unknown");
+	}
+	// Unique per run: batch numbers restart with every run of the agent
+	hello.session = forward_realtime_ns() ^ ((uint64_t)getpid() << 40);
+
+	// The queue is written by the event path: keep it on huge pages
+	frame_buf = malloc(sizeof(struct forward_frame) + FORWARD_MAX_PAYLOAD);
+	slots = hotmem_alloc(sizeof(*slots) * FORWARD_QUEUE, "forward-queue");
+	if (!frame_buf || !slots) {
+		LOG_ERROR_MODULE("FORWARD", "Failed to allocate forwarding buffers");
+		free(frame_buf);
+		hotmem_free(slots);
+		frame_buf = NULL;
+		slots = NULL;
+		return -1;
+	}
+	queue_head = 0;
+	queue_sealed = 0;
+	next_sequence = 1;
+	send_sequence = 0;
+	summary_pending = 0;
+	memset(&stats, 0, sizeof(stats));
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&forward_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	forward_running = 1;
+	if (pthread_create(&forward_thread, NULL, forward_thread_func, NULL) != 0) {
+		forward_running = 0;
+		LOG_ERROR_MODULE("FORWARD", "Failed to create forwarding thread");
+		pthread_cond_destroy(&forward_cond);
+		free(frame_buf);
+		hotmem_free(slots);
+		frame_buf = NULL;
+		slots = NULL;
+		return -1;
+	}
+
+	__atomic_store_n(&forward_active, 1, __ATOMIC_RELEASE);
+	LOG_INFO_MODULE("FORWARD", "Forwarding events to %s:%u as %s", target_host, target_port,
+			hello.host);
+	return 0;
+}
+
+// Queue one raw ring record
+void forward_record(uint32_t category, const void* data, uint32_t length) {
+	if (!__atomic_load_n(&forward_active, __ATOMIC_ACQUIRE)) {
+		return;
+	}
+
+	struct forward_record rec = {(uint16_t)category, (uint16_t)length};
+	uint32_t size = (uint32_t)sizeof(rec) + length;
+	if (length > UINT16_MAX || size > FORWARD_BATCH_BYTES) {
+		__atomic_fetch_add(&stats.dropped, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	pthread_mutex_lock(&forward_lock);
+	struct forward_slot* slot = filling_slot();
+	if (slot->used + size > FORWARD_BATCH_BYTES && forward_seal_locked() != 0) {
+		pthread_mutex_unlock(&forward_lock);
+		__atomic_fetch_add(&stats.dropped, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	slot = filling_slot();
+	if (slot->records == 0) {
+		slot->opened_ns = ravn_prof_now_ns();
+	}
+	memcpy(slot->data + slot->used, &rec, sizeof(rec));
+	memcpy(slot->data + slot->used + sizeof(rec), data, length);
+	slot->used += size;
+	slot->records++;
+	pthread_mutex_unlock(&forward_lock);
+
+	__atomic_fetch_add(&stats.records, 1, __ATOMIC_RELAXED);
+}
+
+// Hand the current threat summary to the sender
+void forward_send_summary(ai_engine_t* engine) {
+	struct forward_summary summary;
+	struct ai_summary verdict;
+
+	if (!__atomic_load_n(&forward_active, __ATOMIC_ACQUIRE)) {
+		return;
+	}
+
+	memset(&summary, 0, sizeof(summary));
+	if (engine && ai_engine_get_summary(engine, &verdict) == 0) {
+		summary.threat_score = verdict.threat_score;
+		summary.process_count = (uint32_t)verdict.process_count;
+		summary.cgroup_count = (uint32_t)verdict.cgroup_count;
+		snprintf(summary.threat_level, sizeof(summary.threat_level), "%s",
+			 verdict.threat_level_str);
+		snprintf(summary.threat_reason, sizeof(summary.threat_reason), "%s",
+			 verdict.threat_reason);
+		for (int i = 0; i < verdict.top_count && i < FORWARD_SUMMARY_TOP; i++) {
+			summary.top[i].pid = verdict.top[i].pid;
+			summary.top[i].event_count = verdict.top[i].event_count;
+			summary.top[i].threat_score = verdict.top[i].threat_score;
+			summary.top_count++;
+		}
+	}
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		summary.events += ebpf_handler_get_event_count(cat);
+	}
+	summary.dropped = __atomic_load_n(&stats.dropped, __ATOMIC_RELAXED);
+
+	pthread_mutex_lock(&forward_lock);
+	pending_summary = summary;
+	summary_pending = 1;
+	pthread_mutex_unlock(&forward_lock);
+}
+
+// Send what is queued and stop forwarding
+void forward_close(void) {
+	pthread_mutex_lock(&forward_lock);
+	int running = forward_running;
+	__atomic_store_n(&forward_active, 0, __ATOMIC_RELEASE);
+	if (running && filling_slot()->records) {
+		forward_seal_locked();
+	}
+	close_deadline_ns = ravn_prof_now_ns() + FORWARD_CLOSE_TIMEOUT_MS * 1000000ULL;
+	forward_running = 0;
+	pthread_cond_broadcast(&forward_cond);
+	pthread_mutex_unlock(&forward_lock);
+
+	if (!running) {
+		return;
+	}
+	pthread_join(forward_thread, NULL);
+	pthread_cond_destroy(&forward_cond);
+
+	uint64_t unsent = 0;
+	for (int i = 0; i < queue_sealed; i++) {
+		unsent += slots[(queue_head + i) % FORWARD_QUEUE].records;
+	}
+	LOG_INFO_MODULE("FORWARD",
+			"Forwarded %lu of %lu records in %lu batches (%lu bytes raw, %lu sent), "
+			"%lu dropped, %lu unacknowledged",
+			(unsigned long)(stats.records - unsent), (unsigned long)stats.records,
+			(unsigned long)stats.batches, (unsigned long)stats.raw_bytes,
+			(unsigned long)stats.sent_bytes, (unsigned long)stats.dropped,
+			(unsigned long)unsent);
+
+	hotmem_free(slots);
+	free(frame_buf);
+	slots = NULL;
+	frame_buf = NULL;
+}
+
+// Read the forwarder counters
+void forward_get_stats(struct forward_stats* out) {
+	if (!out) {
+		return;
+	}
+	out->records = __atomic_load_n(&stats.records, __ATOMIC_RELAXED);
+	out->dropped = __atomic_load_n(&stats.dropped, __ATOMIC_RELAXED);
+	out->batches = __atomic_load_n(&stats.batches, __ATOMIC_RELAXED);
+	out->raw_bytes = __atomic_load_n(&stats.raw_bytes, __ATOMIC_RELAXED);
+	out->sent_bytes = __atomic_load_n(&stats.sent_bytes, __ATOMIC_RELAXED);
+	out->connects = __atomic_load_n(&stats.connects, __ATOMIC_RELAXED);
+	out->connected = __atomic_load_n(&stats.connected, __ATOMIC_RELAXED);
+}
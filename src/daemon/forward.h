@@ -0,0 +1,253 @@
+/*
+ * RAVN Event Forwarding - Header File
+ *
+ * This header defines the forwarding protocol of the RAVN security platform
+ * and its agent side, which streams a host's raw ring records and threat
+ * summaries to a collector ('ravn collector') so that a fleet is watched
+ * from one store instead of a Redis and CLI per host.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The event forwarder implements:
+ * - Batching of raw ring records (up to FORWARD_BATCH_BYTES, or whatever
+ *   arrived within FORWARD_BATCH_MS), each batch LZ-compressed with the
+ *   codecs of codec.h and numbered with a sequence
+ * - Acknowledgments: batches stay queued until the collector acknowledges
+ *   having stored them
+ * - Reconnect with backoff (FORWARD_RETRY_MIN_MS doubling up to
+ *   FORWARD_RETRY_MAX_MS) and resume: the collector answers the greeting
+ *   with the last batch it stored for this run of the agent, and the agent
+ *   resends the batches after it
+ * - The latest threat summary of the AI engine, sent alongside the batches
+ *
+ * Architecture:
+ * - The ring buffer polling thread copies each record into the filling
+ *   batch under a short lock, without compression or I/O
+ * - A dedicated sender thread seals, compresses and sends batches and reads
+ *   the acknowledgments
+ * - FORWARD_QUEUE batches are kept; records arriving while all of them wait
+ *   for an acknowledgment (collector down for long) are counted as dropped
+ *   instead of blocking the event path
+ * - Delivery is at least once: a batch stored just before the collector
+ *   restarted may be sent again
+ *
+ * Wire format (native byte order, every message a struct forward_frame
+ * followed by @length payload bytes):
+ *   agent:     HELLO { struct forward_hello }, then BATCH and SUMMARY frames
+ *   collector: WELCOME, then one ACK per stored batch
+ *   BATCH:     struct forward_batch, then the LZ-compressed records, each a
+ *              struct forward_record and its payload
+ */
+
+#ifndef RAVN_FORWARD_H
+#define RAVN_FORWARD_H
+
+#include "ai_engine.h"
+
+#include <stdint.h>
+
+/*
+ * Event Forwarding Parameters
+ */
+#define FORWARD_MAGIC		0x31465652u /* "RVF1" */
+#define FORWARD_VERSION		1	    /* Protocol version */
+#define FORWARD_DEFAULT_PORT	7420	    /* Collector port */
+#define FORWARD_BATCH_BYTES	(64u << 10) /* Raw record bytes per batch */
+#define FORWARD_BATCH_MS	200	    /* Partial batches sealed after this */
+#define FORWARD_QUEUE		64	    /* Batches kept until acknowledged */
+#define FORWARD_RETRY_MIN_MS	500	    /* First reconnect delay */
+#define FORWARD_RETRY_MAX_MS	30000	    /* Longest reconnect delay */
+#define FORWARD_HELLO_TIMEOUT_MS 5000	    /* Wait for the collector's welcome */
+#define FORWARD_CLOSE_TIMEOUT_MS 3000	    /* Wait for the last acknowledgments */
+#define FORWARD_HOST_MAX	64	    /* Host name bytes, NUL included */
+#define FORWARD_SUMMARY_TOP	5	    /* Processes in a threat summary */
+
+/* Largest payload of a frame: a full batch that did not compress */
+#define FORWARD_MAX_PAYLOAD (sizeof(struct forward_batch) + FORWARD_BATCH_BYTES + \
+			     FORWARD_BATCH_BYTES / 255 + 16)
+
+/**
+ * enum forward_frame_type - Messages of the forwarding protocol
+ */
+enum forward_frame_type {
+	FORWARD_HELLO = 1,   /* Agent greeting: run ID and host name */
+	FORWARD_WELCOME = 2, /* Collector: last batch stored for the run */
+	FORWARD_BATCH = 3,   /* Agent: one batch of records */
+	FORWARD_ACK = 4,     /* Collector: batches stored up to a sequence */
+	FORWARD_SUMMARY = 5  /* Agent: latest threat summary */
+};
+
+/**
+ * struct forward_frame - Header of every message
+ * @magic: FORWARD_MAGIC
+ * @type: Message type (enum forward_frame_type)
+ * @version: FORWARD_VERSION
+ * @length: Payload bytes following the header
+ * @reserved: Zero
+ * @sequence: Batch number of a BATCH (the first batch of a run is 1); the
+ *            last stored batch in a WELCOME or ACK; zero otherwise
+ */
+struct forward_frame {
+	uint32_t magic;	   /* FORWARD_MAGIC */
+	uint16_t type;	   /* Message type */
+	uint16_t version;  /* Protocol version */
+	uint32_t length;   /* Payload length */
+	uint32_t reserved; /* Zero */
+	uint64_t sequence; /* Batch sequence */
+};
+
+/**
+ * struct forward_hello - Payload of a HELLO
+ * @session: Random ID of this run of the agent; batch numbers restart with
+ *           every run
+ * @host: Host name, NUL-terminated
+ */
+struct forward_hello {
+	uint64_t session;	     /* Agent run ID */
+	char host[FORWARD_HOST_MAX]; /* Host name */
+};
+
+/**
+ * struct forward_batch - Payload header of a BATCH
+ * @wall_offset_ns: CLOCK_REALTIME minus CLOCK_MONOTONIC on the agent when
+ *                  the batch was sealed, to place the record timestamps
+ * @records: Records in the batch
+ * @raw_bytes: Size of the records before compression
+ */
+struct forward_batch {
+	uint64_t wall_offset_ns; /* Agent clock offset */
+	uint32_t records;	 /* Record count */
+	uint32_t raw_bytes;	 /* Uncompressed size */
+};
+
+/**
+ * struct forward_record - Framing of one record inside a batch
+ * @category: Event category of the source ring
+ * @length: Record length in bytes
+ */
+struct forward_record {
+	uint16_t category; /* Source ring category */
+	uint16_t length;   /* Record length */
+};
+
+/**
+ * struct forward_process - One process of a threat summary
+ * @pid: Process ID
+ * @event_count: Events of the process in the AI window
+ * @threat_score: Threat score of the process
+ * @reserved: Zero
+ */
+struct forward_process {
+	uint32_t pid;	      /* Process ID */
+	uint32_t event_count; /* Events in window */
+	float threat_score;   /* Threat score */
+	uint32_t reserved;    /* Zero */
+};
+
+/**
+ * struct forward_summary - Payload of a SUMMARY
+ * @threat_score: Overall threat score of the agent's AI window
+ * @process_count: Processes tracked in the window
+ * @cgroup_count: cgroups of the tracked processes
+ * @top_count: Valid entries in @top
+ * @threat_level: Threat level name, NUL-terminated
+ * @threat_reason: Explanation of the threat level, NUL-terminated
+ * @events: Events decoded by the agent since it started
+ * @dropped: Records the agent could not queue for forwarding
+ * @top: Highest scoring processes, highest first
+ */
+struct forward_summary {
+	float threat_score;				 /* Overall threat score */
+	uint32_t process_count;				 /* Tracked processes */
+	uint32_t cgroup_count;				 /* Tracked cgroups */
+	uint32_t top_count;				 /* Valid top entries */
+	char threat_level[16];				 /* Threat level */
+	char threat_reason[256];			 /* Threat reason */
+	uint64_t events;				 /* Events decoded */
+	uint64_t dropped;				 /* Records not forwarded */
+	struct forward_process top[FORWARD_SUMMARY_TOP]; /* Top processes */
+};
+
+/**
+ * struct forward_stats - Forwarder counters since forward_open()
+ * @records: Records queued
+ * @dropped: Records lost because every batch was waiting for an
+ *           acknowledgment
+ * @batches: Batches acknowledged by the collector
+ * @raw_bytes: Record bytes of the acknowledged batches
+ * @sent_bytes: Bytes sent, frames included (resends too)
+ * @connects: Successful connections
+ * @connected: 1 while connected to the collector
+ */
+struct forward_stats {
+	uint64_t records;    /* Records queued */
+	uint64_t dropped;    /* Records dropped */
+	uint64_t batches;    /* Batches acknowledged */
+	uint64_t raw_bytes;  /* Raw bytes acknowledged */
+	uint64_t sent_bytes; /* Bytes on the wire */
+	uint64_t connects;   /* Connections made */
+	int connected;	     /* Connected now */
+};
+
+/**
+ * forward_parse_address - Parse a collector address
+ * @spec: "HOST:PORT", "HOST" (FORWARD_DEFAULT_PORT) or ":PORT" (any
+ *        address, for listening)
+ * @host: Receives the host part, "" if none
+ * @size: Size of @host
+ * @port: Receives the port
+ *
+ * Return: 0 on success, -1 if @spec is invalid
+ */
+int forward_parse_address(const char* spec, char* host, int size, uint16_t* port);
+
+/**
+ * forward_open - Start forwarding to a collector
+ * @target: Collector address, see forward_parse_address()
+ * @host: Name this host is stored under, NULL for the system host name
+ *
+ * Connects in the background: records are queued even while the collector
+ * is unreachable.
+ *
+ * Return: 0 on success, -1 on an invalid address or allocation failure
+ */
+int forward_open(const char* target, const char* host);
+
+/**
+ * forward_record - Queue one raw ring record
+ * @category: Event category of the source ring
+ * @data: Raw record
+ * @length: Record length in bytes
+ *
+ * Does nothing unless forwarding is active. Must only be called from the
+ * thread that dispatches the records.
+ */
+void forward_record(uint32_t category, const void* data, uint32_t length);
+
+/**
+ * forward_send_summary - Hand the current threat summary to the sender
+ * @engine: AI engine whose window verdict is sent, NULL to send the event
+ *          counters only
+ *
+ * Only the latest summary is kept until the sender gets to it. Does nothing
+ * unless forwarding is active.
+ */
+void forward_send_summary(ai_engine_t* engine);
+
+/**
+ * forward_close - Send what is queued and stop forwarding
+ *
+ * Waits up to FORWARD_CLOSE_TIMEOUT_MS for the collector to acknowledge the
+ * queued batches.
+ */
+void forward_close(void);
+
+/**
+ * forward_get_stats - Read the forwarder counters
+ * @stats: Output counters
+ */
+void forward_get_stats(struct forward_stats* stats);
+
+#endif // RAVN_FORWARD_H
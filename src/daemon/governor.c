@@ -0,0 +1,339 @@
+// RAVN CPU Budget Governor Implementation
+// Degrades and restores the monitors to keep their cost under a budget
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "governor.h"
+
+#include "../utils/logger.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Monitors from least to most valuable; the last GOVERNOR_PROTECTED are protected
+static const uint32_t value_order[EVENT_CATEGORY_MAX] = {
+	EVENT_CATEGORY_PERFORMANCE, EVENT_CATEGORY_MEMORY,  EVENT_CATEGORY_KERNEL,
+	EVENT_CATEGORY_NETWORK,	    EVENT_CATEGORY_FILE,    EVENT_CATEGORY_SYSCALL,
+	EVENT_CATEGORY_PROCESS,	    EVENT_CATEGORY_SECURITY};
+
+// What a level does to one monitor
+enum monitor_state { STATE_FULL, STATE_SAMPLED, STATE_AGGREGATE, STATE_DETACHED };
+
+static const char* const state_names[] = {"full", "sampled", "aggregate", "detached"};
+
+// Configuration (set before governor_init)
+static double user_budget = 0.0;
+static double bpf_budget = 0.0;
+
+// Escalation state; written by the main loop, read under the mutex
+static int governor_active = 0;
+static int level = GOVERNOR_FULL;
+static int over_count = 0;
+static int under_count = 0;
+static enum monitor_state applied[EVENT_CATEGORY_MAX + 1];
+static double last_user_pct = 0.0;
+static double last_bpf_pct = 0.0;
+static uint64_t transition_count = 0;
+static struct governor_transition history[GOVERNOR_HISTORY];
+static int history_start = 0;
+static int history_count = 0;
+static pthread_mutex_t governor_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Transitions already in the Redis sorted set
+static uint64_t published_transitions = 0;
+
+// Parse one percentage of the budget
+static int parse_pct(const char* value, double* pct) {
+	char* end;
+	double v = strtod(value, &end);
+	if (end == value || *end != '\0' || v < 0.0) {
+		return -1;
+	}
+	*pct = v;
+	return 0;
+}
+
+// Configure the CPU budget
+int governor_set_budget(const char* spec) {
+	char buf[128];
+	char* save = NULL;
+	double user = 0.0, bpf = 0.0;
+
+	snprintf(buf, sizeof(buf), "%s", spec);
+	for (char* part = strtok_r(buf, ",", &save); part; part = strtok_r(NULL, ",", &save)) {
+		char* value = strchr(part, '=');
+		if (!value) {
+			return -1;
+		}
+		*value++ = '\0';
+		if (strcasecmp(part, "user") == 0) {
+			if (parse_pct(value, &user) != 0) {
+				return -1;
+			}
+		} else if (strcasecmp(part, "bpf") == 0) {
+			if (parse_pct(value, &bpf) != 0) {
+				return -1;
+			}
+		} else {
+			return -1;
+		}
+	}
+	if (user == 0.0 && bpf == 0.0) {
+		return -1;
+	}
+
+	user_budget = user;
+	bpf_budget = bpf;
+	return 0;
+}
+
+// Position of a monitor in the value order
+static int value_rank(uint32_t category) {
+	for (int i = 0; i < EVENT_CATEGORY_MAX; i++) {
+		if (value_order[i] == category) {
+			return i;
+		}
+	}
+	return EVENT_CATEGORY_MAX - 1;
+}
+
+// What a level does to a monitor
+static enum monitor_state state_at(int lvl, uint32_t category) {
+	int rank = value_rank(category);
+	if (lvl == GOVERNOR_FULL) {
+		return STATE_FULL;
+	}
+	if (lvl == GOVERNOR_SAMPLED || rank >= EVENT_CATEGORY_MAX - GOVERNOR_PROTECTED) {
+		return STATE_SAMPLED;
+	}
+	return rank < lvl - GOVERNOR_AGGREGATE ? STATE_DETACHED : STATE_AGGREGATE;
+}
+
+// Bring every monitor to the state of a level
+static void apply_level(int lvl) {
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		enum monitor_state state = state_at(lvl, cat);
+		if (state == applied[cat]) {
+			continue;
+		}
+
+		// A detached monitor keeps its last control entry; re-attach first
+		if (state == STATE_DETACHED) {
+			ebpf_handler_detach_monitor(cat);
+		} else {
+			if (applied[cat] == STATE_DETACHED) {
+				ebpf_handler_attach_monitor(cat);
+			}
+			struct monitor_control control = {
+				.mode = state == STATE_AGGREGATE ? MONITOR_MODE_AGGREGATE
+								 : MONITOR_MODE_FULL,
+				.sample_rate = state == STATE_FULL ? 1 : GOVERNOR_SAMPLE_RATE};
+			ebpf_handler_set_monitor_control(cat, &control);
+		}
+		applied[cat] = state;
+	}
+}
+
+// Name of an escalation level
+const char* governor_level_name(int lvl, char* buf, size_t len) {
+	if (lvl > GOVERNOR_AGGREGATE) {
+		snprintf(buf, len, "detach:%d", lvl - GOVERNOR_AGGREGATE);
+	} else {
+		snprintf(buf, len, "%s", state_names[lvl]);
+	}
+	return buf;
+}
+
+// Describe what the current level does to a monitor
+const char* governor_monitor_state(uint32_t category) {
+	if (category < 1 || category > EVENT_CATEGORY_MAX) {
+		return "unknown";
+	}
+	pthread_mutex_lock(&governor_mutex);
+	enum monitor_state state = applied[category];
+	pthread_mutex_unlock(&governor_mutex);
+	return state_names[state];
+}
+
+// Move to a new level and record the transition
+static void change_level(int to) {
+	char from_name[GOVERNOR_NAME_LEN], to_name[GOVERNOR_NAME_LEN];
+	struct governor_transition t = {.time = time(NULL),
+					.from = level,
+					.to = to,
+					.user_pct = last_user_pct,
+					.bpf_pct = last_bpf_pct};
+
+	governor_level_name(level, from_name, sizeof(from_name));
+	governor_level_name(to, to_name, sizeof(to_name));
+	if (to > level) {
+		LOG_WARN_MODULE("GOVERNOR",
+				"Over budget, escalating %s -> %s: user %.2f%% (budget %.2f%%), "
+				"BPF %.2f%% (budget %.2f%%) of one core",
+				from_name, to_name, last_user_pct, user_budget, last_bpf_pct,
+				bpf_budget);
+	} else {
+		LOG_INFO_MODULE("GOVERNOR",
+				"Under budget, restoring %s -> %s: user %.2f%%, BPF %.2f%% of "
+				"one core",
+				from_name, to_name, last_user_pct, last_bpf_pct);
+	}
+
+	pthread_mutex_lock(&governor_mutex);
+	apply_level(to);
+	level = to;
+	transition_count++;
+	history[(history_start + history_count) % GOVERNOR_HISTORY] = t;
+	if (history_count < GOVERNOR_HISTORY) {
+		history_count++;
+	} else {
+		history_start = (history_start + 1) % GOVERNOR_HISTORY;
+	}
+	pthread_mutex_unlock(&governor_mutex);
+}
+
+// Start the governor with the monitors at full level
+void governor_init(void) {
+	if (user_budget == 0.0 && bpf_budget == 0.0) {
+		return;
+	}
+
+	pthread_mutex_lock(&governor_mutex);
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		applied[cat] = STATE_FULL;
+	}
+	level = GOVERNOR_FULL;
+	governor_active = 1;
+	pthread_mutex_unlock(&governor_mutex);
+	over_count = 0;
+	under_count = 0;
+
+	LOG_INFO_MODULE("GOVERNOR", "CPU budget: user %.2f%%, BPF %.2f%% of one core (0: none)",
+			user_budget, bpf_budget);
+}
+
+// Restore every monitor to full level
+void governor_cleanup(void) {
+	if (!governor_active) {
+		return;
+	}
+
+	pthread_mutex_lock(&governor_mutex);
+	apply_level(GOVERNOR_FULL);
+	level = GOVERNOR_FULL;
+	governor_active = 0;
+	pthread_mutex_unlock(&governor_mutex);
+}
+
+// Feed one self-overhead sample to the governor
+void governor_update(const struct overhead_report* report) {
+	if (!governor_active || !report) {
+		return;
+	}
+
+	// The report is in % of host CPU; the budget in % of one core
+	pthread_mutex_lock(&governor_mutex);
+	last_user_pct = report->process_pct * report->ncpus;
+	last_bpf_pct = report->kernel_pct * report->ncpus;
+	pthread_mutex_unlock(&governor_mutex);
+
+	int check_bpf = bpf_budget > 0.0 && report->bpf_stats;
+	int over = (user_budget > 0.0 && last_user_pct > user_budget) ||
+		   (check_bpf && last_bpf_pct > bpf_budget);
+	int under = (user_budget == 0.0 ||
+		     last_user_pct < user_budget * GOVERNOR_RESTORE_RATIO) &&
+		    (!check_bpf || last_bpf_pct < bpf_budget * GOVERNOR_RESTORE_RATIO);
+
+	over_count = over ? over_count + 1 : 0;
+	under_count = under ? under_count + 1 : 0;
+
+	if (over_count >= GOVERNOR_ESCALATE_AFTER && level < GOVERNOR_LEVEL_MAX) {
+		change_level(level + 1);
+		over_count = 0;
+	} else if (under_count >= GOVERNOR_RESTORE_AFTER && level > GOVERNOR_FULL) {
+		change_level(level - 1);
+		under_count = 0;
+	}
+}
+
+// Take a snapshot of the governor
+void governor_get_state(struct governor_state* state) {
+	pthread_mutex_lock(&governor_mutex);
+	state->active = governor_active;
+	state->level = level;
+	state->user_budget = user_budget;
+	state->bpf_budget = bpf_budget;
+	state->user_pct = last_user_pct;
+	state->bpf_pct = last_bpf_pct;
+	state->transitions = transition_count;
+	state->history_count = history_count;
+	for (int i = 0; i < history_count; i++) {
+		state->history[i] = history[(history_start + i) % GOVERNOR_HISTORY];
+	}
+	pthread_mutex_unlock(&governor_mutex);
+}
+
+// Publish the governor state to Redis
+int governor_publish(redis_connection_t* conn) {
+	static struct redis_hash hash;
+	static char members[GOVERNOR_HISTORY][96];
+	static struct governor_state state;
+	const char* member_ptrs[GOVERNOR_HISTORY];
+	double scores[GOVERNOR_HISTORY];
+	char from_name[GOVERNOR_NAME_LEN], to_name[GOVERNOR_NAME_LEN];
+
+	if (!conn) {
+		return -1;
+	}
+	governor_get_state(&state);
+	if (!state.active) {
+		return 0;
+	}
+
+	redis_hash_reset(&hash);
+	redis_hash_add(&hash, "%s", "level", "%d", state.level);
+	redis_hash_add(&hash, "%s", "stage", "%s",
+		       governor_level_name(state.level, to_name, sizeof(to_name)));
+	redis_hash_add(&hash, "%s", "user_pct", "%.4f", state.user_pct);
+	redis_hash_add(&hash, "%s", "bpf_pct", "%.4f", state.bpf_pct);
+	redis_hash_add(&hash, "%s", "user_budget", "%.4f", state.user_budget);
+	redis_hash_add(&hash, "%s", "bpf_budget", "%.4f", state.bpf_budget);
+	redis_hash_add(&hash, "%s", "transitions", "%lu", (unsigned long)state.transitions);
+	redis_hash_add(&hash, "%s", "updated", "%ld", (long)time(NULL));
+
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		uint64_t tally[MONITOR_TALLY_MAX];
+		const char* name = get_event_category_name(cat);
+		ebpf_handler_get_monitor_tally(cat, tally);
+		redis_hash_add(&hash, "%s_state", name, "%s", governor_monitor_state(cat));
+		redis_hash_add(&hash, "%s_sampled_out", name, "%lu",
+			       (unsigned long)tally[MONITOR_TALLY_SAMPLED]);
+		redis_hash_add(&hash, "%s_aggregated", name, "%lu",
+			       (unsigned long)tally[MONITOR_TALLY_AGGREGATED]);
+	}
+
+	int result = redis_hash_write(conn, GOVERNOR_REDIS_KEY, &hash);
+	if (state.transitions == published_transitions) {
+		return result;
+	}
+
+	// Members carry the transition; the score orders them by time
+	for (int i = 0; i < state.history_count; i++) {
+		const struct governor_transition* t = &state.history[i];
+		snprintf(members[i], sizeof(members[i]), "%ld %s->%s user=%.2f bpf=%.2f",
+			 (long)t->time, governor_level_name(t->from, from_name, sizeof(from_name)),
+			 governor_level_name(t->to, to_name, sizeof(to_name)), t->user_pct,
+			 t->bpf_pct);
+		member_ptrs[i] = members[i];
+		scores[i] = (double)t->time;
+	}
+	if (redis_zset_replace(conn, GOVERNOR_REDIS_LOG, member_ptrs, scores,
+			       state.history_count) != 0) {
+		return -1;
+	}
+	published_transitions = state.transitions;
+	return result;
+}
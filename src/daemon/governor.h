@@ -0,0 +1,181 @@
+/*
+ * RAVN CPU Budget Governor - Header File
+ *
+ * This header defines the CPU budget governor of the RAVN security platform,
+ * which holds the cost of the monitoring itself under a configured budget
+ * on latency-sensitive hosts by degrading the monitors in steps and
+ * restoring them as the load drops.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The CPU budget governor implements:
+ * - A user-space budget for the daemon process (user + system time) and one
+ *   for BPF program run time, both in % of one core
+ * - Escalation levels: full, sampled (every monitor emits 1 in
+ *   GOVERNOR_SAMPLE_RATE events), aggregate (the unprotected monitors only
+ *   count events in BPF) and then detaching the unprotected monitors one by
+ *   one, least valuable first
+ * - Hysteresis: a step up after GOVERNOR_ESCALATE_AFTER samples over budget,
+ *   a step down after GOVERNOR_RESTORE_AFTER samples under
+ *   GOVERNOR_RESTORE_RATIO of it
+ * - A record of every transition: logged, kept in memory for the control
+ *   socket and published to Redis with the current state
+ *
+ * Architecture:
+ * - Driven by the self-overhead report on the daemon main loop, never on the
+ *   event path; sampling and aggregation are applied in the BPF programs
+ *   through their control maps, before any ring space is reserved
+ * - The GOVERNOR_PROTECTED most valuable monitors (process, security) are
+ *   sampled at most, never aggregated or detached
+ * - Inactive unless a budget is configured
+ */
+
+#ifndef RAVN_GOVERNOR_H
+#define RAVN_GOVERNOR_H
+
+#include <stdint.h>
+#include <time.h>
+
+#include "ebpf_handler.h"
+#include "overhead.h"
+#include "redis_client.h"
+
+/*
+ * CPU Budget Governor Configuration Parameters
+ */
+#define GOVERNOR_SAMPLE_RATE    8                   /* 1 in N events emitted when sampling */
+#define GOVERNOR_ESCALATE_AFTER 2                   /* Samples over budget per step up */
+#define GOVERNOR_RESTORE_RATIO  0.5                 /* Restore mark, fraction of the budget */
+#define GOVERNOR_RESTORE_AFTER  10                  /* Samples under the mark per step down */
+#define GOVERNOR_PROTECTED      2                   /* Monitors never aggregated or detached */
+#define GOVERNOR_HISTORY        64                  /* Transitions kept in memory */
+#define GOVERNOR_REDIS_KEY      "ravn:governor"     /* Hash holding the current state */
+#define GOVERNOR_REDIS_LOG      "ravn:governor:log" /* Sorted set of recent transitions */
+
+/**
+ * enum governor_level - Escalation levels below the detach steps
+ *
+ * Levels above GOVERNOR_AGGREGATE detach one more unprotected monitor each,
+ * up to GOVERNOR_LEVEL_MAX.
+ */
+enum governor_level {
+	GOVERNOR_FULL = 0,	/* Every monitor emits every event */
+	GOVERNOR_SAMPLED = 1,	/* Every monitor samples */
+	GOVERNOR_AGGREGATE = 2	/* Unprotected monitors count only */
+};
+
+#define GOVERNOR_LEVEL_MAX (GOVERNOR_AGGREGATE + EVENT_CATEGORY_MAX - GOVERNOR_PROTECTED)
+#define GOVERNOR_NAME_LEN  20 /* "detach:" plus any int, for governor_level_name() */
+
+/**
+ * struct governor_transition - One change of the escalation level
+ * @time: Wall-clock time of the change
+ * @from: Previous level
+ * @to: New level
+ * @user_pct: Daemon CPU in % of one core at the decision
+ * @bpf_pct: BPF run time in % of one core at the decision
+ */
+struct governor_transition {
+	time_t time;	    /* When */
+	int from;	    /* Previous level */
+	int to;		    /* New level */
+	double user_pct; /* Daemon cost */
+	double bpf_pct;	    /* BPF cost */
+};
+
+/**
+ * struct governor_state - Snapshot of the governor
+ * @active: 1 if a budget is configured
+ * @level: Current escalation level
+ * @user_budget: Daemon CPU budget in % of one core (0: none)
+ * @bpf_budget: BPF run time budget in % of one core (0: none)
+ * @user_pct: Last measured daemon CPU in % of one core
+ * @bpf_pct: Last measured BPF run time in % of one core
+ * @transitions: Transitions since startup
+ * @history_count: Entries in @history
+ * @history: Most recent transitions, oldest first
+ */
+struct governor_state {
+	int active;						/* Budget configured */
+	int level;						/* Escalation level */
+	double user_budget;					/* Daemon budget */
+	double bpf_budget;					/* BPF budget */
+	double user_pct;					/* Daemon cost */
+	double bpf_pct;						/* BPF cost */
+	uint64_t transitions;					/* Transition count */
+	int history_count;					/* History entries */
+	struct governor_transition history[GOVERNOR_HISTORY];	/* Recent transitions */
+};
+
+/**
+ * governor_set_budget - Configure the CPU budget
+ * @spec: "user=PCT,bpf=PCT" in % of one core, user being the daemon process
+ *        (user + system time); either part may be left out
+ *
+ * Return: 0 on success, -1 if @spec is invalid
+ */
+int governor_set_budget(const char* spec);
+
+/**
+ * governor_init - Start the governor with the monitors at full level
+ *
+ * Does nothing unless a budget is configured. Call after the eBPF handlers
+ * are initialized.
+ */
+void governor_init(void);
+
+/**
+ * governor_cleanup - Restore every monitor to full level
+ */
+void governor_cleanup(void);
+
+/**
+ * governor_update - Feed one self-overhead sample to the governor
+ * @report: Report of the last interval
+ *
+ * Steps the escalation level up or down by at most one and applies it.
+ * Call from the daemon main loop only.
+ */
+void governor_update(const struct overhead_report* report);
+
+/**
+ * governor_get_state - Take a snapshot of the governor
+ * @state: Snapshot to fill
+ *
+ * Safe to call from any thread.
+ */
+void governor_get_state(struct governor_state* state);
+
+/**
+ * governor_monitor_state - Describe what the current level does to a monitor
+ * @category: Event category of the monitor
+ *
+ * Return: "full", "sampled", "aggregate" or "detached"
+ */
+const char* governor_monitor_state(uint32_t category);
+
+/**
+ * governor_level_name - Name of an escalation level
+ * @level: Level
+ * @buf: Output buffer
+ * @len: Size of @buf, GOVERNOR_NAME_LEN never truncates
+ *
+ * Return: @buf, e.g. "sampled" or "detach:2"
+ */
+const char* governor_level_name(int level, char* buf, size_t len);
+
+/**
+ * governor_publish - Publish the governor state to Redis
+ * @conn: Redis connection handle
+ *
+ * Writes the state and per-monitor tallies to GOVERNOR_REDIS_KEY and the
+ * recent transitions to GOVERNOR_REDIS_LOG. Does nothing while the
+ * governor is inactive.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int governor_publish(redis_connection_t* conn);
+
+#endif // RAVN_GOVERNOR_H
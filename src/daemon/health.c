@@ -0,0 +1,376 @@
+// RAVN Health Monitor Implementation
+// Component liveness, ring fill and queue tracking with restart policies
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "health.h"
+
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+#include "placement.h"
+#include "redis_client.h"
+
+#include <hiredis/hiredis.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <time.h>
+#include <unistd.h>
+
+// Heartbeat counters, written by the monitored threads
+struct health_beat {
+	uint64_t count;	  /* Heartbeats received */
+	uint64_t last_ns; /* Last heartbeat (monotonic) */
+};
+
+// Restart policy state, only touched by the health thread
+struct health_policy {
+	uint32_t stall_ms;	  /* Stall timeout */
+	health_restart_fn restart; /* Restart callback */
+	uint32_t restarts;	  /* Attempts since last healthy */
+	uint32_t backoff_ms;	  /* Next restart delay */
+	uint64_t next_restart_ns; /* Earliest next attempt */
+	uint32_t max_restarts;	  /* Attempts before giving up, 0 = never */
+	int failed;		  /* Attempts exhausted */
+};
+
+static const char* component_names[HEALTH_COMPONENT_MAX] = {"ringbuf", "ai", "redis"};
+
+// Global health state
+static struct health_beat beats[HEALTH_COMPONENT_MAX];
+static struct health_policy policies[HEALTH_COMPONENT_MAX];
+static struct health_report last_report;
+static int report_valid = 0;
+static pthread_mutex_t report_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t health_thread;
+static volatile int health_running = 0;
+static uint64_t health_start_ns = 0;
+static redis_connection_t* health_redis = NULL;
+
+// Record a liveness heartbeat
+void health_heartbeat(enum health_component component) {
+	if (component >= HEALTH_COMPONENT_MAX) {
+		return;
+	}
+	__atomic_fetch_add(&beats[component].count, 1, __ATOMIC_RELAXED);
+	__atomic_store_n(&beats[component].last_ns, ravn_prof_now_ns(), __ATOMIC_RELAXED);
+}
+
+// Get health state name
+const char* health_state_name(int state) {
+	switch (state) {
+	case HEALTH_OK:
+		return "ok";
+	case HEALTH_DEGRADED:
+		return "degraded";
+	case HEALTH_STALLED:
+		return "stalled";
+	case HEALTH_FAILED:
+		return "failed";
+	default:
+		return "unknown";
+	}
+}
+
+// Apply the restart policy to a stalled component
+static int restart_component(int c, uint64_t now) {
+	struct health_policy* policy = &policies[c];
+
+	if (!policy->restart || now < policy->next_restart_ns) {
+		return HEALTH_STALLED;
+	}
+
+	// Without a cap, attempts go on every HEALTH_BACKOFF_MAX_MS for as long as it takes
+	if (policy->max_restarts && policy->restarts >= policy->max_restarts) {
+		policy->failed = 1;
+		LOG_ERROR_MODULE("HEALTH", "%s: giving up after %u restart attempts",
+				 component_names[c], policy->restarts);
+		return HEALTH_FAILED;
+	}
+
+	policy->restarts++;
+	if (policy->max_restarts) {
+		LOG_WARN_MODULE("HEALTH", "%s: stalled, restart attempt %u/%u", component_names[c],
+				policy->restarts, policy->max_restarts);
+	} else {
+		LOG_WARN_MODULE("HEALTH", "%s: stalled, restart attempt %u", component_names[c],
+				policy->restarts);
+	}
+
+	if (policy->restart() == 0) {
+		// Grace period: the restarted component has not beaten yet
+		__atomic_store_n(&beats[c].last_ns, now, __ATOMIC_RELAXED);
+		LOG_INFO_MODULE("HEALTH", "%s: restarted", component_names[c]);
+	} else {
+		LOG_WARN_MODULE("HEALTH", "%s: restart failed, retrying in %u ms",
+				component_names[c], policy->backoff_ms);
+	}
+
+	// Exponential backoff between attempts
+	policy->next_restart_ns = now + (uint64_t)policy->backoff_ms * 1000000ULL;
+	policy->backoff_ms = policy->backoff_ms * 2 > HEALTH_BACKOFF_MAX_MS
+				     ? HEALTH_BACKOFF_MAX_MS
+				     : policy->backoff_ms * 2;
+	return HEALTH_STALLED;
+}
+
+// Classify one component from its heartbeat age
+static void evaluate_component(int c, uint64_t now, struct health_component_status* st) {
+	struct health_policy* policy = &policies[c];
+	uint64_t last = __atomic_load_n(&beats[c].last_ns, __ATOMIC_RELAXED);
+
+	// Components that never reported are measured from monitor start
+	uint64_t since = last ? last : health_start_ns;
+	uint64_t age_ms = now > since ? (now - since) / 1000000ULL : 0;
+
+	st->name = component_names[c];
+	st->heartbeats = __atomic_load_n(&beats[c].count, __ATOMIC_RELAXED);
+	st->age_ms = age_ms;
+
+	if (policy->failed) {
+		st->state = HEALTH_FAILED;
+	} else if (policy->stall_ms && age_ms >= policy->stall_ms) {
+		st->state = restart_component(c, now);
+	} else if (policy->stall_ms && age_ms >= policy->stall_ms / 2) {
+		st->state = HEALTH_DEGRADED;
+	} else {
+		st->state = HEALTH_OK;
+		if (policy->restarts > 0) {
+			LOG_INFO_MODULE("HEALTH", "%s: healthy again after %u restart(s)",
+					component_names[c], policy->restarts);
+			policy->restarts = 0;
+			policy->backoff_ms = HEALTH_BACKOFF_MIN_MS;
+		}
+	}
+
+	st->restarts = policy->restarts;
+	st->backoff_ms = policy->backoff_ms;
+}
+
+// Probe Redis: round-trip time and event queue depth on our own connection
+static void probe_redis(struct health_report* report) {
+	report->queue_depth = -1;
+
+	if (health_redis && redis_ping(health_redis) != 0) {
+		redis_disconnect(health_redis);
+		health_redis = NULL;
+	}
+	if (!health_redis) {
+		health_redis = redis_connect("127.0.0.1", 6379);
+		if (!health_redis) {
+			return;
+		}
+	}
+
+	uint64_t start = ravn_prof_now_ns();
+	if (redis_ping(health_redis) != 0) {
+		return;
+	}
+	report->redis_rtt_us = (ravn_prof_now_ns() - start) / 1000;
+
+	redisReply* reply = redis_command(health_redis, "LLEN events:raw");
+	if (reply) {
+		if (reply->type == REDIS_REPLY_INTEGER) {
+			report->queue_depth = reply->integer;
+		}
+		freeReplyObject(reply);
+	}
+
+	// The shared connection only reports its error state; no I/O on it here
+	extern void* global_redis_conn_ptr;
+	if (redis_is_connected((redis_connection_t*)global_redis_conn_ptr)) {
+		health_heartbeat(HEALTH_REDIS);
+	}
+}
+
+// Publish the health snapshot as a compact JSON record
+static void publish_report(const struct health_report* report) {
+	char record[1024];
+	int pos = snprintf(record, sizeof(record),
+			   "{\"ts\":%lu,\"st\":%d,\"rtt_us\":%lu,\"q\":%ld,\"ai_lag_ms\":%lu,\"c\":{",
+			   (unsigned long)report->timestamp, report->state,
+			   (unsigned long)report->redis_rtt_us, (long)report->queue_depth,
+			   (unsigned long)report->ai_lag_ms);
+
+	for (int c = 0; c < HEALTH_COMPONENT_MAX && pos < (int)sizeof(record); c++) {
+		const struct health_component_status* st = &report->components[c];
+		pos += snprintf(record + pos, sizeof(record) - pos,
+				"%s\"%s\":[%d,%lu,%lu,%u]", c ? "," : "", st->name, st->state,
+				(unsigned long)st->heartbeats, (unsigned long)st->age_ms,
+				st->restarts);
+	}
+
+	// Ring fill in event category order (syscall .. performance)
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX && pos < (int)sizeof(record); cat++) {
+		pos += snprintf(record + pos, sizeof(record) - pos, "%s%.1f",
+				cat == 1 ? "},\"ring\":[" : ",", report->ring_fill_pct[cat]);
+	}
+	if (pos < (int)sizeof(record)) {
+		snprintf(record + pos, sizeof(record) - pos, "]}");
+	}
+
+	if (!health_redis) {
+		return;
+	}
+
+	redisReply* reply = redis_command(health_redis, "SET %s %s", HEALTH_REDIS_KEY, record);
+	if (reply) {
+		freeReplyObject(reply);
+	}
+	reply = redis_command(health_redis, "PUBLISH %s %s", HEALTH_REDIS_CHANNEL, record);
+	if (reply) {
+		freeReplyObject(reply);
+	}
+}
+
+// Take one health snapshot and apply restart policies
+static void health_evaluate(void) {
+	struct health_report report;
+	struct ebpf_monitor_stats monitors[EVENT_CATEGORY_MAX + 1];
+
+	memset(&report, 0, sizeof(report));
+	report.timestamp = (uint64_t)time(NULL);
+
+	probe_redis(&report);
+
+	// Ring fill: data produced by BPF but not yet consumed
+	float max_fill = 0.0f;
+	ebpf_handler_get_monitor_stats(monitors);
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		if (monitors[cat].ring_size == 0) {
+			continue;
+		}
+		report.ring_fill_pct[cat] =
+			(float)monitors[cat].ring_avail * 100.0f / (float)monitors[cat].ring_size;
+		if (report.ring_fill_pct[cat] > max_fill) {
+			max_fill = report.ring_fill_pct[cat];
+		}
+	}
+
+	uint64_t now = ravn_prof_now_ns();
+	for (int c = 0; c < HEALTH_COMPONENT_MAX; c++) {
+		evaluate_component(c, now, &report.components[c]);
+	}
+	report.ai_lag_ms = report.components[HEALTH_AI].age_ms;
+
+	// A consumer that keeps beating but falls behind is still degraded
+	struct health_component_status* ringbuf = &report.components[HEALTH_RINGBUF];
+	if (ringbuf->state == HEALTH_OK && max_fill >= HEALTH_RING_WARN_PCT) {
+		ringbuf->state = HEALTH_DEGRADED;
+	}
+
+	for (int c = 0; c < HEALTH_COMPONENT_MAX; c++) {
+		if (report.components[c].state > report.state) {
+			report.state = report.components[c].state;
+		}
+	}
+
+	publish_report(&report);
+
+	pthread_mutex_lock(&report_lock);
+	last_report = report;
+	report_valid = 1;
+	pthread_mutex_unlock(&report_lock);
+}
+
+// Health monitoring thread
+static void* health_thread_func(void* arg) {
+	(void)arg;
+
+	prctl(PR_SET_NAME, "ravn-health", 0, 0, 0);
+	placement_apply(PLACEMENT_BACKGROUND);
+	LOG_INFO_MODULE("HEALTH", "Health monitoring thread started");
+
+	struct timespec interval = {HEALTH_INTERVAL_MS / 1000,
+				    (HEALTH_INTERVAL_MS % 1000) * 1000000L};
+	while (health_running) {
+		health_evaluate();
+		nanosleep(&interval, NULL);
+	}
+
+	LOG_INFO_MODULE("HEALTH", "Health monitoring thread stopped");
+	return NULL;
+}
+
+// Start the health monitoring thread
+int health_init(const uint32_t* stall_ms, const health_restart_fn* restart) {
+	if (health_running) {
+		return 0;
+	}
+
+	for (int c = 0; c < HEALTH_COMPONENT_MAX; c++) {
+		memset(&policies[c], 0, sizeof(policies[c]));
+		policies[c].stall_ms = stall_ms ? stall_ms[c] : 0;
+		policies[c].restart = restart ? restart[c] : NULL;
+		policies[c].backoff_ms = HEALTH_BACKOFF_MIN_MS;
+		policies[c].max_restarts = HEALTH_MAX_RESTARTS;
+	}
+	health_start_ns = ravn_prof_now_ns();
+
+	health_running = 1;
+	if (pthread_create(&health_thread, NULL, health_thread_func, NULL) != 0) {
+		health_running = 0;
+		LOG_ERROR_MODULE("HEALTH", "Failed to create health monitoring thread");
+		return -1;
+	}
+
+	return 0;
+}
+
+// Stop the health monitoring thread
+void health_cleanup(void) {
+	if (!health_running) {
+		return;
+	}
+
+	health_running = 0;
+	pthread_join(health_thread, NULL);
+
+	if (health_redis) {
+		redis_disconnect(health_redis);
+		health_redis = NULL;
+	}
+}
+
+// Get the latest health snapshot
+int health_get_report(struct health_report* report) {
+	if (!report) {
+		return -1;
+	}
+
+	pthread_mutex_lock(&report_lock);
+	int valid = report_valid;
+	if (valid) {
+		*report = last_report;
+	}
+	pthread_mutex_unlock(&report_lock);
+
+	return valid ? 0 : -1;
+}
+
+// Write the latest health snapshot to the log
+void health_log(void) {
+	struct health_report report;
+	if (health_get_report(&report) != 0) {
+		LOG_INFO_MODULE("HEALTH", "No health snapshot yet");
+		return;
+	}
+
+	LOG_INFO_MODULE("HEALTH", "Overall %s: Redis RTT %lu us, queue %ld, AI lag %lu ms",
+			health_state_name(report.state), (unsigned long)report.redis_rtt_us,
+			(long)report.queue_depth, (unsigned long)report.ai_lag_ms);
+
+	for (int c = 0; c < HEALTH_COMPONENT_MAX; c++) {
+		const struct health_component_status* st = &report.components[c];
+		LOG_INFO_MODULE("HEALTH", "%-8s %-8s heartbeats %lu, age %lu ms, restarts %u",
+				st->name, health_state_name(st->state),
+				(unsigned long)st->heartbeats, (unsigned long)st->age_ms,
+				st->restarts);
+	}
+
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		LOG_INFO_MODULE("HEALTH", "ring %-12s %5.1f%% full", get_event_category_name(cat),
+				report.ring_fill_pct[cat]);
+	}
+}
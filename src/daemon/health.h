@@ -0,0 +1,166 @@
+/*
+ * RAVN Health Monitor - Header File
+ *
+ * This header defines the health monitoring interface for the RAVN security
+ * platform, tracking the liveness of every daemon component and restarting
+ * the ones that stall.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The health monitor implements:
+ * - Heartbeat counters for each daemon thread
+ * - Ring buffer fill levels for each eBPF monitor
+ * - Event queue depth, Redis round-trip time and AI tick lag
+ * - Restart with exponential backoff for stalled components, retried every
+ *   HEALTH_BACKOFF_MAX_MS until they recover unless HEALTH_MAX_RESTARTS caps it
+ * - Compact health record published to Redis
+ *
+ * Architecture:
+ * - Threads publish heartbeats with relaxed atomics (no locks, no syscalls)
+ * - A dedicated health thread evaluates all components once per interval
+ * - Restarts are cooperative: a component is only restarted after its
+ *   stuck thread has actually exited
+ * - The health thread uses its own Redis connection
+ */
+
+#ifndef RAVN_HEALTH_H
+#define RAVN_HEALTH_H
+
+#include <stdint.h>
+
+#include "ebpf_handler.h"
+
+/*
+ * Health Configuration Parameters
+ */
+#define HEALTH_INTERVAL_MS	1000		 /* Evaluation interval */
+#define HEALTH_BACKOFF_MIN_MS	1000		 /* First restart delay */
+#define HEALTH_BACKOFF_MAX_MS	60000		 /* Restart delay cap */
+#define HEALTH_MAX_RESTARTS	0		 /* Attempts before giving up, 0 = never */
+#define HEALTH_REDIS_KEY	"health:current" /* Last health record */
+#define HEALTH_REDIS_CHANNEL	"health:update"	 /* Health record channel */
+#define HEALTH_RING_WARN_PCT	75		 /* Ring fill reported as degraded */
+
+/**
+ * enum health_component - Monitored daemon components
+ */
+enum health_component {
+	HEALTH_RINGBUF = 0,	/* eBPF ring buffer polling thread */
+	HEALTH_AI = 1,		/* AI analysis thread */
+	HEALTH_REDIS = 2,	/* Shared Redis connection */
+	HEALTH_COMPONENT_MAX = 3
+};
+
+/**
+ * enum health_state - Component health classification
+ */
+enum health_state {
+	HEALTH_OK = 0,	     /* Heartbeats are current */
+	HEALTH_DEGRADED = 1, /* Alive but lagging or near capacity */
+	HEALTH_STALLED = 2,  /* No heartbeat within the stall timeout */
+	HEALTH_FAILED = 3    /* Restart attempts exhausted (HEALTH_MAX_RESTARTS) */
+};
+
+/**
+ * health_restart_fn - Component restart callback
+ *
+ * Return: 0 once the component is running again, -1 if it could not be
+ * restarted yet (the attempt is retried with backoff)
+ */
+typedef int (*health_restart_fn)(void);
+
+/**
+ * struct health_component_status - Health of one component
+ * @name: Component name
+ * @state: Current health classification
+ * @heartbeats: Heartbeats received (cumulative)
+ * @age_ms: Time since the last heartbeat
+ * @restarts: Restart attempts since the component was last healthy
+ * @backoff_ms: Delay before the next restart attempt
+ */
+struct health_component_status {
+	const char* name;	/* Component name */
+	int state;		/* enum health_state */
+	uint64_t heartbeats;	/* Heartbeat count */
+	uint64_t age_ms;	/* Last heartbeat age */
+	uint32_t restarts;	/* Restart attempts */
+	uint32_t backoff_ms;	/* Next restart delay */
+};
+
+/**
+ * struct health_report - Daemon health snapshot
+ * @timestamp: Snapshot time (seconds since epoch)
+ * @state: Worst component state
+ * @components: Per-component health
+ * @ring_fill_pct: Ring buffer fill level per event category
+ * @queue_depth: Length of the events:raw queue, -1 if unknown
+ * @redis_rtt_us: Redis PING round-trip time, 0 if unreachable
+ * @ai_lag_ms: Time since the AI thread last completed a tick
+ */
+struct health_report {
+	uint64_t timestamp;						/* Snapshot time */
+	int state;							/* Overall state */
+	struct health_component_status components[HEALTH_COMPONENT_MAX]; /* Components */
+	float ring_fill_pct[EVENT_CATEGORY_MAX + 1];			/* Ring fill */
+	int64_t queue_depth;						/* events:raw */
+	uint64_t redis_rtt_us;						/* PING RTT */
+	uint64_t ai_lag_ms;						/* AI tick lag */
+};
+
+/*
+ * Heartbeat Functions
+ */
+
+/**
+ * health_heartbeat - Record a liveness heartbeat
+ * @component: Component reporting progress
+ *
+ * Called once per loop iteration by each monitored thread. Safe to call
+ * before health_init() and from any thread.
+ */
+void health_heartbeat(enum health_component component);
+
+/*
+ * Health Monitor Functions
+ */
+
+/**
+ * health_init - Start the health monitoring thread
+ * @stall_ms: Stall timeout per component (HEALTH_COMPONENT_MAX entries)
+ * @restart: Restart callback per component, NULL entries only report
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int health_init(const uint32_t* stall_ms, const health_restart_fn* restart);
+
+/**
+ * health_cleanup - Stop the health monitoring thread
+ *
+ * Must be called before the monitored components are torn down.
+ */
+void health_cleanup(void);
+
+/**
+ * health_get_report - Get the latest health snapshot
+ * @report: Report structure to populate
+ *
+ * Return: 0 on success, -1 if no snapshot has been taken yet
+ */
+int health_get_report(struct health_report* report);
+
+/**
+ * health_state_name - Get health state name
+ * @state: Health state
+ *
+ * Return: Human-readable state name
+ */
+const char* health_state_name(int state);
+
+/**
+ * health_log - Write the latest health snapshot to the log
+ */
+void health_log(void);
+
+#endif // RAVN_HEALTH_H
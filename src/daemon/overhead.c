@@ -0,0 +1,334 @@
+// RAVN Overhead Accounting Implementation
+// Measures kernel (BPF) and user-space cost of the monitoring itself
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "overhead.h"
+
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <bpf/bpf.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Previous CPU times of one thread
+struct thread_sample {
+	int tid;	/* Thread ID */
+	uint64_t utime; /* User ticks */
+	uint64_t stime; /* System ticks */
+};
+
+// Accounting state (only touched by the daemon main loop)
+static int stats_fd = -1;
+static int overhead_ready = 0;
+static uint64_t last_sample_ns = 0;
+static uint64_t last_process_ticks = 0;
+static struct ebpf_monitor_stats last_monitors[EVENT_CATEGORY_MAX + 1];
+static struct thread_sample last_threads[OVERHEAD_MAX_THREADS];
+static int last_thread_count = 0;
+
+// Read comm, utime and stime from a /proc stat file
+static int read_stat_times(const char* path, char* name, size_t name_len, uint64_t* utime,
+			   uint64_t* stime) {
+	char buf[512];
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return -1;
+	}
+
+	ssize_t len = read(fd, buf, sizeof(buf) - 1);
+	close(fd);
+	if (len <= 0) {
+		return -1;
+	}
+	buf[len] = '\0';
+
+	// comm may contain spaces and parentheses, so anchor on the last ')'
+	char* open_paren = strchr(buf, '(');
+	char* close_paren = strrchr(buf, ')');
+	if (!open_paren || !close_paren || close_paren < open_paren) {
+		return -1;
+	}
+
+	if (name && name_len > 0) {
+		size_t n = (size_t)(close_paren - open_paren - 1);
+		if (n >= name_len) {
+			n = name_len - 1;
+		}
+		memcpy(name, open_paren + 1, n);
+		name[n] = '\0';
+	}
+
+	// Fields after comm start at state (3); utime and stime are 14 and 15
+	char* p = close_paren + 1;
+	for (int field = 3; field < 14; field++) {
+		p = strchr(p + 1, ' ');
+		if (!p) {
+			return -1;
+		}
+	}
+
+	char* end;
+	*utime = strtoull(p + 1, &end, 10);
+	*stime = strtoull(end, NULL, 10);
+	return 0;
+}
+
+// Find the previous sample of a thread
+static const struct thread_sample* find_last_thread(int tid) {
+	for (int i = 0; i < last_thread_count; i++) {
+		if (last_threads[i].tid == tid) {
+			return &last_threads[i];
+		}
+	}
+	return NULL;
+}
+
+// Sample per-thread CPU times of the daemon process
+static void sample_threads(struct overhead_report* report, double tick_scale) {
+	struct thread_sample current[OVERHEAD_MAX_THREADS];
+	int count = 0;
+
+	DIR* dir = opendir("/proc/self/task");
+	if (!dir) {
+		return;
+	}
+
+	struct dirent* entry;
+	while ((entry = readdir(dir)) != NULL && count < OVERHEAD_MAX_THREADS) {
+		if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+			continue;
+		}
+
+		char path[PATH_MAX];
+		struct overhead_thread* th = &report->threads[count];
+		struct thread_sample* cur = &current[count];
+		snprintf(path, sizeof(path), "/proc/self/task/%s/stat", entry->d_name);
+		if (read_stat_times(path, th->name, sizeof(th->name), &cur->utime, &cur->stime) !=
+		    0) {
+			continue;
+		}
+
+		cur->tid = atoi(entry->d_name);
+		th->tid = cur->tid;
+
+		// Threads seen for the first time report from their start
+		const struct thread_sample* prev = find_last_thread(cur->tid);
+		uint64_t prev_utime = prev ? prev->utime : 0;
+		uint64_t prev_stime = prev ? prev->stime : 0;
+		th->user_pct = (double)(cur->utime - prev_utime) * tick_scale;
+		th->sys_pct = (double)(cur->stime - prev_stime) * tick_scale;
+		count++;
+	}
+	closedir(dir);
+
+	memcpy(last_threads, current, sizeof(current[0]) * count);
+	last_thread_count = count;
+	report->thread_count = count;
+}
+
+// Start self-overhead accounting
+int overhead_init(void) {
+	// The kernel keeps run-time stats on while any holder keeps this fd open
+	stats_fd = bpf_enable_stats(BPF_STATS_RUN_TIME);
+	if (stats_fd < 0) {
+		LOG_WARN_MODULE("OVERHEAD", "BPF run-time statistics unavailable (%d), "
+					    "reporting user-space cost only",
+				stats_fd);
+		stats_fd = -1;
+	}
+
+	// Baseline so the first report covers one full interval
+	char name[16];
+	uint64_t utime = 0, stime = 0;
+	if (read_stat_times("/proc/self/stat", name, sizeof(name), &utime, &stime) == 0) {
+		last_process_ticks = utime + stime;
+	}
+	ebpf_handler_get_monitor_stats(last_monitors);
+	last_sample_ns = ravn_prof_now_ns();
+
+	struct overhead_report baseline;
+	memset(&baseline, 0, sizeof(baseline));
+	sample_threads(&baseline, 0.0);
+
+	overhead_ready = 1;
+	LOG_INFO_MODULE("OVERHEAD", "Self-overhead accounting started (BPF stats %s)",
+			stats_fd >= 0 ? "enabled" : "disabled");
+	return 0;
+}
+
+// Stop self-overhead accounting
+void overhead_cleanup(void) {
+	if (stats_fd >= 0) {
+		close(stats_fd);
+		stats_fd = -1;
+	}
+	overhead_ready = 0;
+	last_thread_count = 0;
+}
+
+// Measure overhead since the previous sample
+int overhead_sample(struct overhead_report* report) {
+	if (!report || !overhead_ready) {
+		return -1;
+	}
+
+	uint64_t now = ravn_prof_now_ns();
+	if (now <= last_sample_ns) {
+		return -1;
+	}
+
+	memset(report, 0, sizeof(*report));
+	report->interval_ns = now - last_sample_ns;
+	report->ncpus = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (report->ncpus <= 0) {
+		report->ncpus = 1;
+	}
+	report->bpf_stats = stats_fd >= 0;
+
+	// Host CPU capacity over the interval, and clock ticks as % of it
+	double capacity_ns = (double)report->interval_ns * report->ncpus;
+	long clk_tck = sysconf(_SC_CLK_TCK);
+	double tick_scale = 1e9 / (double)(clk_tck > 0 ? clk_tck : 100) / capacity_ns * 100.0;
+
+	// Per-monitor kernel and user-space cost
+	struct ebpf_monitor_stats current[EVENT_CATEGORY_MAX + 1];
+	report->monitor_count = ebpf_handler_get_monitor_stats(current);
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		const struct ebpf_monitor_stats* cur = &current[cat];
+		const struct ebpf_monitor_stats* prev = &last_monitors[cat];
+		struct overhead_monitor* mon = &report->monitors[cat];
+
+		// Counters restart when a monitor is reloaded
+		uint64_t events = cur->events - prev->events;
+		uint64_t handler_ns = cur->handler_ns - prev->handler_ns;
+		uint64_t runs = cur->run_cnt >= prev->run_cnt ? cur->run_cnt - prev->run_cnt
+							       : cur->run_cnt;
+		uint64_t run_ns = cur->run_time_ns >= prev->run_time_ns
+					  ? cur->run_time_ns - prev->run_time_ns
+					  : cur->run_time_ns;
+
+		mon->name = cur->name;
+		mon->programs = cur->programs;
+		mon->events = cur->events;
+		mon->bpf_runs = cur->run_cnt;
+		mon->events_per_sec = events * 1e9 / report->interval_ns;
+		mon->kernel_pct = run_ns / capacity_ns * 100.0;
+		mon->user_pct = handler_ns / capacity_ns * 100.0;
+		mon->kernel_ns_per_run = runs ? (double)run_ns / runs : 0.0;
+		mon->user_ns_per_event = events ? (double)handler_ns / events : 0.0;
+
+		report->kernel_pct += mon->kernel_pct;
+		report->user_pct += mon->user_pct;
+	}
+	memcpy(last_monitors, current, sizeof(last_monitors));
+
+	// Whole-process CPU, including threads that have already exited
+	char name[16];
+	uint64_t utime = 0, stime = 0;
+	if (read_stat_times("/proc/self/stat", name, sizeof(name), &utime, &stime) == 0) {
+		report->process_pct = (double)(utime + stime - last_process_ticks) * tick_scale;
+		last_process_ticks = utime + stime;
+	}
+
+	sample_threads(report, tick_scale);
+
+	last_sample_ns = now;
+	return 0;
+}
+
+// Publish an overhead report to the Redis hash
+int overhead_publish(redis_connection_t* conn, const struct overhead_report* report) {
+	static struct redis_hash hash;
+
+	if (!conn || !report) {
+		return -1;
+	}
+	redis_hash_reset(&hash);
+
+	redis_hash_add(&hash, "%s", "interval_ms", "%.0f", report->interval_ns / 1e6);
+	redis_hash_add(&hash, "%s", "ncpus", "%d", report->ncpus);
+	redis_hash_add(&hash, "%s", "bpf_stats", "%d", report->bpf_stats);
+	redis_hash_add(&hash, "%s", "kernel_pct", "%.4f", report->kernel_pct);
+	redis_hash_add(&hash, "%s", "user_pct", "%.4f", report->user_pct);
+	redis_hash_add(&hash, "%s", "process_pct", "%.4f", report->process_pct);
+	redis_hash_add(&hash, "%s", "updated", "%ld", (long)time(NULL));
+
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		const struct overhead_monitor* mon = &report->monitors[cat];
+		if (!mon->name) {
+			continue;
+		}
+		redis_hash_add(&hash, "%s_events", mon->name, "%lu", (unsigned long)mon->events);
+		redis_hash_add(&hash, "%s_bpf_runs", mon->name, "%lu",
+			       (unsigned long)mon->bpf_runs);
+		redis_hash_add(&hash, "%s_eps", mon->name, "%.1f", mon->events_per_sec);
+		redis_hash_add(&hash, "%s_kernel_pct", mon->name, "%.4f", mon->kernel_pct);
+		redis_hash_add(&hash, "%s_user_pct", mon->name, "%.4f", mon->user_pct);
+		redis_hash_add(&hash, "%s_kernel_ns_per_run", mon->name, "%.0f",
+			       mon->kernel_ns_per_run);
+		redis_hash_add(&hash, "%s_user_ns", mon->name, "%.0f", mon->user_ns_per_event);
+	}
+
+	// Thread names are stable ("ravn", "ravn-ringbuf", "ravn-ai"), tids are not,
+	// so threads sharing a name are summed into one field
+	for (int i = 0; i < report->thread_count; i++) {
+		const struct overhead_thread* th = &report->threads[i];
+		double pct = 0.0;
+		int seen = 0;
+
+		for (int j = 0; j < i && !seen; j++) {
+			seen = strcmp(report->threads[j].name, th->name) == 0;
+		}
+		if (seen) {
+			continue;
+		}
+		for (int j = i; j < report->thread_count; j++) {
+			if (strcmp(report->threads[j].name, th->name) == 0) {
+				pct += report->threads[j].user_pct + report->threads[j].sys_pct;
+			}
+		}
+		redis_hash_add(&hash, "thread_%s_pct", th->name, "%.4f", pct);
+	}
+
+	return redis_hash_write(conn, OVERHEAD_REDIS_KEY, &hash);
+}
+
+// Write an overhead report to the log
+void overhead_log(const struct overhead_report* report) {
+	if (!report) {
+		return;
+	}
+
+	LOG_INFO_MODULE("OVERHEAD",
+			"Interval %.1fs on %d CPUs: process %.3f%%, BPF %.3f%%, handlers %.3f%%%s",
+			report->interval_ns / 1e9, report->ncpus, report->process_pct,
+			report->kernel_pct, report->user_pct,
+			report->bpf_stats ? "" : " (BPF stats disabled)");
+
+	LOG_INFO_MODULE("OVERHEAD", "%-12s %4s %10s %12s %9s %9s %10s %10s", "MONITOR", "PROG",
+			"EVENTS/S", "BPF_RUNS", "KERN_%", "USER_%", "NS/RUN", "NS/EVENT");
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		const struct overhead_monitor* mon = &report->monitors[cat];
+		if (!mon->name) {
+			continue;
+		}
+		LOG_INFO_MODULE("OVERHEAD", "%-12s %4u %10.1f %12lu %9.4f %9.4f %10.0f %10.0f",
+				mon->name, mon->programs, mon->events_per_sec,
+				(unsigned long)mon->bpf_runs, mon->kernel_pct, mon->user_pct,
+				mon->kernel_ns_per_run, mon->user_ns_per_event);
+	}
+
+	for (int i = 0; i < report->thread_count; i++) {
+		const struct overhead_thread* th = &report->threads[i];
+		LOG_INFO_MODULE("OVERHEAD", "Thread %-16s tid %-7d user %.3f%% sys %.3f%%",
+				th->name, th->tid, th->user_pct, th->sys_pct);
+	}
+}
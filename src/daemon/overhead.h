@@ -0,0 +1,153 @@
+/*
+ * RAVN Overhead Accounting - Header File
+ *
+ * This header defines the self-overhead accounting interface for the RAVN
+ * security platform, measuring what the monitoring itself costs the host:
+ * kernel time spent in the attached BPF programs and user time spent by the
+ * daemon threads that consume their events.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The overhead accounting implements:
+ * - BPF run-time statistics (BPF_ENABLE_STATS) per attached program
+ * - Per-monitor user-space handler time and event counts
+ * - Per-thread CPU time from /proc/self/task/<tid>/stat
+ * - Cost as % of host CPU, per BPF run and per delivered event
+ * - Publication to the ravn:overhead Redis hash
+ *
+ * Architecture:
+ * - Counters are cumulative; each sample reports deltas since the last one
+ * - Sampling runs on the daemon main loop, never on the event path
+ * - Host CPU share is delta_ns / (interval_ns * online CPUs)
+ */
+
+#ifndef RAVN_OVERHEAD_H
+#define RAVN_OVERHEAD_H
+
+#include <stdint.h>
+
+#include "ebpf_handler.h"
+#include "redis_client.h"
+
+/*
+ * Overhead Configuration Parameters
+ */
+#define OVERHEAD_MAX_THREADS 32			/* Daemon threads tracked per sample */
+#define OVERHEAD_REDIS_KEY   "ravn:overhead" /* Redis hash holding the last report */
+
+/**
+ * struct overhead_monitor - Cost of one monitor over a sample interval
+ * @name: Monitor name (e.g. "syscall")
+ * @programs: Number of BPF programs in the monitor object
+ * @events: Records delivered to user space (cumulative)
+ * @bpf_runs: BPF program invocations (cumulative)
+ * @events_per_sec: Delivered records per second
+ * @kernel_pct: BPF run time as % of host CPU
+ * @user_pct: User-space handler time as % of host CPU
+ * @kernel_ns_per_run: Average BPF run time per program invocation, which is
+ *	not per event: programs also run for records they filter or sample out
+ * @user_ns_per_event: Average handler time per delivered record
+ */
+struct overhead_monitor {
+	const char* name;	     /* Monitor name */
+	uint32_t programs;	     /* BPF program count */
+	uint64_t events;	     /* Delivered records */
+	uint64_t bpf_runs;	     /* BPF invocations */
+	double events_per_sec;	     /* Record rate */
+	double kernel_pct;	     /* Kernel share of host CPU */
+	double user_pct;	     /* User share of host CPU */
+	double kernel_ns_per_run;    /* BPF ns per invocation */
+	double user_ns_per_event;    /* Handler ns per record */
+};
+
+/**
+ * struct overhead_thread - CPU usage of one daemon thread
+ * @tid: Kernel thread ID
+ * @name: Thread name (comm)
+ * @user_pct: User time as % of host CPU
+ * @sys_pct: System time as % of host CPU
+ */
+struct overhead_thread {
+	int tid;	   /* Thread ID */
+	char name[16];	   /* Thread name */
+	double user_pct;   /* User share of host CPU */
+	double sys_pct;	   /* System share of host CPU */
+};
+
+/**
+ * struct overhead_report - Self-overhead over one sample interval
+ * @interval_ns: Length of the sample interval
+ * @ncpus: Online CPUs used as the host CPU capacity
+ * @bpf_stats: 1 if BPF run-time statistics are enabled
+ * @monitor_count: Number of populated entries in @monitors
+ * @monitors: Per-monitor cost, indexed by event category
+ * @thread_count: Number of entries in @threads
+ * @threads: Per-thread CPU usage
+ * @kernel_pct: Total BPF run time as % of host CPU
+ * @user_pct: Total handler time as % of host CPU
+ * @process_pct: Daemon process CPU (user + system) as % of host CPU
+ */
+struct overhead_report {
+	uint64_t interval_ns;					  /* Sample interval */
+	int ncpus;						  /* Online CPUs */
+	int bpf_stats;						  /* BPF stats enabled */
+	int monitor_count;					  /* Monitors reported */
+	struct overhead_monitor monitors[EVENT_CATEGORY_MAX + 1]; /* Per monitor */
+	int thread_count;					  /* Threads reported */
+	struct overhead_thread threads[OVERHEAD_MAX_THREADS];	  /* Per thread */
+	double kernel_pct;					  /* Total BPF share */
+	double user_pct;					  /* Total handler share */
+	double process_pct;					  /* Daemon CPU share */
+};
+
+/*
+ * Overhead Accounting Functions
+ */
+
+/**
+ * overhead_init - Start self-overhead accounting
+ *
+ * Enables BPF run-time statistics for as long as accounting is active and
+ * takes the baseline sample. Missing privileges only disable the kernel
+ * side counters.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int overhead_init(void);
+
+/**
+ * overhead_cleanup - Stop self-overhead accounting
+ *
+ * Releases the BPF statistics handle, which disables run-time accounting
+ * in the kernel once no other holder remains.
+ */
+void overhead_cleanup(void);
+
+/**
+ * overhead_sample - Measure overhead since the previous sample
+ * @report: Report structure to populate
+ *
+ * Return: 0 on success, -1 if no time has elapsed or on failure
+ */
+int overhead_sample(struct overhead_report* report);
+
+/**
+ * overhead_publish - Publish an overhead report to Redis
+ * @conn: Redis connection handle
+ * @report: Report to publish
+ *
+ * Writes the report to the OVERHEAD_REDIS_KEY hash in a single command.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int overhead_publish(redis_connection_t* conn, const struct overhead_report* report);
+
+/**
+ * overhead_log - Write an overhead report to the log
+ * @report: Report to log
+ */
+void overhead_log(const struct overhead_report* report);
+
+#endif // RAVN_OVERHEAD_H
@@ -0,0 +1,359 @@
+// RAVN Thread Placement Implementation
+// CPU sets, NUMA alignment and scheduling policies of daemon thread classes
+
+#define _GNU_SOURCE // CPU_SET, SCHED_BATCH, SCHED_IDLE, pthread_setaffinity_np
+#include "placement.h"
+
+#include "../utils/logger.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Scheduling policy of a class
+struct placement_policy {
+	int policy;   /* SCHED_* */
+	int priority; /* Real-time priority (SCHED_FIFO, SCHED_RR) */
+	int nice;     /* Nice value (other policies) */
+};
+
+// Configuration of a class
+struct placement_config {
+	int has_cpus;
+	cpu_set_t cpus;
+	int has_policy;
+	struct placement_policy policy;
+};
+
+static const char* const class_names[PLACEMENT_CLASS_MAX] = {"main", "ringbuf", "ai",
+							     "background"};
+
+static struct placement_config classes[PLACEMENT_CLASS_MAX];
+static int placement_active = 0;
+static cpu_set_t startup_cpus;
+static struct placement_policy startup_policy;
+
+// Split "CLASS=VALUE" into its class and value
+static int parse_class(const char* spec, enum placement_class* cls, const char** value) {
+	const char* eq = strchr(spec, '=');
+	if (!eq) {
+		return -1;
+	}
+	for (int c = 0; c < PLACEMENT_CLASS_MAX; c++) {
+		size_t len = strlen(class_names[c]);
+		if ((size_t)(eq - spec) == len && strncmp(spec, class_names[c], len) == 0) {
+			*cls = (enum placement_class)c;
+			*value = eq + 1;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+// Parse a CPU list such as "0-3,8,10-11" into @set
+static int parse_cpu_list(const char* list, cpu_set_t* set) {
+	const char* p = list;
+	while (*p && *p != '\n') {
+		char* end;
+		long first = strtol(p, &end, 10);
+		long last = first;
+		if (end == p) {
+			return -1;
+		}
+		p = end;
+		if (*p == '-') {
+			last = strtol(p + 1, &end, 10);
+			if (end == p + 1) {
+				return -1;
+			}
+			p = end;
+		}
+		if (first < 0 || last < first || last >= CPU_SETSIZE) {
+			return -1;
+		}
+		for (long cpu = first; cpu <= last; cpu++) {
+			CPU_SET((int)cpu, set);
+		}
+		if (*p == ',') {
+			p++;
+		} else if (*p && *p != '\n') {
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Read the CPUs of a NUMA node
+static int read_node_cpus(int node, cpu_set_t* set) {
+	char path[64];
+	char list[1024];
+	snprintf(path, sizeof(path), "%s/node%d/cpulist", PLACEMENT_NODE_PATH, node);
+
+	FILE* f = fopen(path, "r");
+	if (!f) {
+		return -1;
+	}
+	char* line = fgets(list, sizeof(list), f);
+	fclose(f);
+	return line ? parse_cpu_list(list, set) : -1;
+}
+
+// NUMA node holding all CPUs of @set, -1 if they span nodes or it is unknown
+static int cpus_node(const cpu_set_t* set) {
+	for (int node = 0; node < PLACEMENT_MAX_NODES; node++) {
+		cpu_set_t node_cpus, common;
+		CPU_ZERO(&node_cpus);
+		if (read_node_cpus(node, &node_cpus) != 0) {
+			continue;
+		}
+		CPU_AND(&common, &node_cpus, set);
+		if (CPU_COUNT(&common) == 0) {
+			continue;
+		}
+		return CPU_EQUAL(&common, set) ? node : -1;
+	}
+	return -1;
+}
+
+// Format @set as a CPU list
+static const char* format_cpus(const cpu_set_t* set, char* buf, size_t size) {
+	size_t len = 0;
+	buf[0] = '\0';
+	for (int cpu = 0; cpu < CPU_SETSIZE && len < size; cpu++) {
+		if (!CPU_ISSET(cpu, set)) {
+			continue;
+		}
+		int last = cpu;
+		while (last + 1 < CPU_SETSIZE && CPU_ISSET(last + 1, set)) {
+			last++;
+		}
+		int n = last > cpu ? snprintf(buf + len, size - len, "%s%d-%d", len ? "," : "", cpu,
+					      last)
+				   : snprintf(buf + len, size - len, "%s%d", len ? "," : "", cpu);
+		len += n > 0 ? (size_t)n : 0;
+		cpu = last;
+	}
+	return buf;
+}
+
+// Configure the CPU set of a thread class
+int placement_set_cpus(const char* spec) {
+	enum placement_class cls;
+	const char* value;
+	cpu_set_t set;
+
+	if (parse_class(spec, &cls, &value) != 0) {
+		return -1;
+	}
+	CPU_ZERO(&set);
+	if (strncmp(value, "node", 4) == 0) {
+		char* end;
+		long node = strtol(value + 4, &end, 10);
+		if (end == value + 4 || *end || node < 0 || read_node_cpus((int)node, &set) != 0) {
+			return -1;
+		}
+	} else if (parse_cpu_list(value, &set) != 0) {
+		return -1;
+	}
+	if (CPU_COUNT(&set) == 0) {
+		return -1;
+	}
+
+	classes[cls].has_cpus = 1;
+	classes[cls].cpus = set;
+	return 0;
+}
+
+// Parse "POLICY[:VALUE]"
+static int parse_policy(const char* value, struct placement_policy* p) {
+	const char* colon = strchr(value, ':');
+	size_t len = colon ? (size_t)(colon - value) : strlen(value);
+	long number = 0;
+	if (colon) {
+		char* end;
+		number = strtol(colon + 1, &end, 10);
+		if (end == colon + 1 || *end) {
+			return -1;
+		}
+	}
+
+	memset(p, 0, sizeof(*p));
+	if ((len == 4 && strncmp(value, "fifo", 4) == 0) ||
+	    (len == 2 && strncmp(value, "rr", 2) == 0)) {
+		p->policy = len == 4 ? SCHED_FIFO : SCHED_RR;
+		p->priority = colon ? (int)number : PLACEMENT_RT_PRIORITY;
+		return p->priority >= 1 && p->priority <= 99 ? 0 : -1;
+	}
+	if ((len == 5 && strncmp(value, "other", 5) == 0) ||
+	    (len == 4 && strncmp(value, "nice", 4) == 0)) {
+		p->policy = SCHED_OTHER;
+	} else if (len == 5 && strncmp(value, "batch", 5) == 0) {
+		p->policy = SCHED_BATCH;
+	} else if (len == 4 && strncmp(value, "idle", 4) == 0 && !colon) {
+		p->policy = SCHED_IDLE;
+	} else {
+		return -1;
+	}
+	p->nice = (int)number;
+	return number >= -20 && number <= 19 ? 0 : -1;
+}
+
+// Configure the scheduling policy of a thread class
+int placement_set_policy(const char* spec) {
+	enum placement_class cls;
+	const char* value;
+	struct placement_policy policy;
+
+	if (parse_class(spec, &cls, &value) != 0 || parse_policy(value, &policy) != 0) {
+		return -1;
+	}
+	classes[cls].has_policy = 1;
+	classes[cls].policy = policy;
+	return 0;
+}
+
+// Name of a policy for the log
+static const char* policy_name(int policy) {
+	switch (policy) {
+	case SCHED_FIFO:
+		return "SCHED_FIFO";
+	case SCHED_RR:
+		return "SCHED_RR";
+	case SCHED_BATCH:
+		return "SCHED_BATCH";
+	case SCHED_IDLE:
+		return "SCHED_IDLE";
+	default:
+		return "SCHED_OTHER";
+	}
+}
+
+// Format a policy for the log
+static const char* format_policy(const struct placement_policy* p, char* buf, size_t size) {
+	if (p->policy == SCHED_FIFO || p->policy == SCHED_RR) {
+		snprintf(buf, size, "%s priority %d", policy_name(p->policy), p->priority);
+	} else if (p->policy == SCHED_IDLE) {
+		snprintf(buf, size, "%s", policy_name(p->policy));
+	} else {
+		snprintf(buf, size, "%s nice %d", policy_name(p->policy), p->nice);
+	}
+	return buf;
+}
+
+// Enable thread placement
+void placement_init(void) {
+	struct sched_param param;
+
+	CPU_ZERO(&startup_cpus);
+	if (sched_getaffinity(0, sizeof(startup_cpus), &startup_cpus) != 0) {
+		for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			CPU_SET(cpu, &startup_cpus);
+		}
+	}
+	memset(&startup_policy, 0, sizeof(startup_policy));
+	startup_policy.policy = sched_getscheduler(0);
+	if (startup_policy.policy < 0) {
+		startup_policy.policy = SCHED_OTHER;
+	}
+	if (sched_getparam(0, &param) == 0) {
+		startup_policy.priority = param.sched_priority;
+	}
+	errno = 0;
+	startup_policy.nice = getpriority(PRIO_PROCESS, 0);
+	if (errno != 0) {
+		startup_policy.nice = 0;
+	}
+
+	if (!classes[PLACEMENT_RINGBUF].has_policy) {
+		placement_set_policy("ringbuf=" PLACEMENT_DEFAULT_RINGBUF);
+	}
+	if (!classes[PLACEMENT_AI].has_policy) {
+		placement_set_policy("ai=" PLACEMENT_DEFAULT_AI);
+	}
+
+	for (int c = 0; c < PLACEMENT_CLASS_MAX; c++) {
+		const struct placement_config* cfg = &classes[c];
+		char cpus[256];
+		char policy[64];
+		if (!cfg->has_cpus && !cfg->has_policy) {
+			continue;
+		}
+		int node = cfg->has_cpus ? cpus_node(&cfg->cpus) : -1;
+		char node_text[32] = "";
+		if (node >= 0) {
+			snprintf(node_text, sizeof(node_text), " (node %d)", node);
+		}
+		LOG_INFO_MODULE("PLACEMENT", "%s: CPUs %s%s, %s", class_names[c],
+				cfg->has_cpus ? format_cpus(&cfg->cpus, cpus, sizeof(cpus)) : "inherited",
+				node_text,
+				cfg->has_policy ? format_policy(&cfg->policy, policy, sizeof(policy))
+						: "inherited policy");
+	}
+	placement_active = 1;
+}
+
+// Set the nice value of the calling thread (per thread on Linux)
+static int set_thread_nice(int nice) {
+	return setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), nice);
+}
+
+// Place the calling thread
+void placement_apply(enum placement_class cls) {
+	if (!placement_active || (unsigned)cls >= PLACEMENT_CLASS_MAX) {
+		return;
+	}
+	const struct placement_config* cfg = &classes[cls];
+	const cpu_set_t* cpus = cfg->has_cpus ? &cfg->cpus : &startup_cpus;
+	const struct placement_policy* p = cfg->has_policy ? &cfg->policy : &startup_policy;
+
+	int err = pthread_setaffinity_np(pthread_self(), sizeof(*cpus), cpus);
+	if (err != 0) {
+		LOG_WARN_MODULE("PLACEMENT", "%s: cannot set CPU affinity: %s", class_names[cls],
+				strerror(err));
+	}
+
+	struct sched_param param;
+	memset(&param, 0, sizeof(param));
+	int realtime = p->policy == SCHED_FIFO || p->policy == SCHED_RR;
+	param.sched_priority = realtime ? p->priority : 0;
+	err = pthread_setschedparam(pthread_self(), p->policy, &param);
+	if (err != 0 && realtime) {
+		LOG_WARN_MODULE("PLACEMENT", "%s: %s not permitted (%s), using nice %d instead",
+				class_names[cls], policy_name(p->policy), strerror(err),
+				PLACEMENT_FALLBACK_NICE);
+		param.sched_priority = 0;
+		pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+		if (set_thread_nice(PLACEMENT_FALLBACK_NICE) != 0) {
+			LOG_WARN_MODULE("PLACEMENT", "%s: cannot set nice %d: %s", class_names[cls],
+					PLACEMENT_FALLBACK_NICE, strerror(errno));
+		}
+		return;
+	}
+	if (err != 0) {
+		LOG_WARN_MODULE("PLACEMENT", "%s: cannot set %s: %s", class_names[cls],
+				policy_name(p->policy), strerror(err));
+	}
+	if (!realtime && set_thread_nice(p->nice) != 0) {
+		LOG_WARN_MODULE("PLACEMENT", "%s: cannot set nice %d: %s", class_names[cls], p->nice,
+				strerror(errno));
+	}
+}
+
+// Move the calling thread to the CPUs of a class
+void placement_bind(enum placement_class cls) {
+	if (!placement_active || (unsigned)cls >= PLACEMENT_CLASS_MAX || !classes[cls].has_cpus) {
+		return;
+	}
+	int err = pthread_setaffinity_np(pthread_self(), sizeof(classes[cls].cpus),
+					 &classes[cls].cpus);
+	if (err != 0) {
+		LOG_WARN_MODULE("PLACEMENT", "Cannot move to the %s CPUs: %s", class_names[cls],
+				strerror(err));
+	}
+}
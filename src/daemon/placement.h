@@ -0,0 +1,106 @@
+/*
+ * RAVN Thread Placement - Header File
+ *
+ * This header defines CPU placement and scheduling policy for the threads of
+ * the RAVN daemon, so they stay off the CPUs of the monitored workloads and
+ * do not migrate across sockets.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The thread placement implements:
+ * - Thread classes: main loop, ring consumer, AI analysis and background
+ *   (store writer, health, status and control threads)
+ * - A CPU set per class, as a CPU list ("2-3,6") or a NUMA node ("node1")
+ * - A scheduling policy per class: SCHED_FIFO or SCHED_RR with a priority,
+ *   SCHED_BATCH, SCHED_IDLE, or SCHED_OTHER with a nice value
+ * - Defaults that favour the ring consumer (PLACEMENT_DEFAULT_RINGBUF) and
+ *   yield to the monitored workloads in the AI thread (PLACEMENT_DEFAULT_AI)
+ * - Fallbacks instead of failures: a real-time policy that is not permitted
+ *   becomes SCHED_OTHER at PLACEMENT_FALLBACK_NICE, and a nice value or CPU
+ *   set that cannot be applied is logged and skipped
+ * - NUMA alignment: the BPF rings are created while the daemon runs on the
+ *   ring consumer's CPUs, so the kernel allocates the ring pages on the node
+ *   of the thread that drains them
+ *
+ * Architecture:
+ * - The options are parsed before any thread starts; each thread applies
+ *   its class itself when it starts, so threads restarted by the health
+ *   monitor keep their placement
+ * - Nothing changes before placement_init(): offline tools that run the same
+ *   thread functions keep default scheduling
+ * - Classes without a CPU set or policy get the CPUs and policy the daemon
+ *   was started with
+ */
+
+#ifndef RAVN_PLACEMENT_H
+#define RAVN_PLACEMENT_H
+
+/*
+ * Thread Placement Configuration Parameters
+ */
+#define PLACEMENT_DEFAULT_RINGBUF "nice:-10" /* Ring consumer policy unless configured */
+#define PLACEMENT_DEFAULT_AI	  "batch"    /* AI thread policy unless configured */
+#define PLACEMENT_RT_PRIORITY	  10	     /* SCHED_FIFO/SCHED_RR priority if not given */
+#define PLACEMENT_FALLBACK_NICE	  -10	     /* Nice value when real-time is not permitted */
+#define PLACEMENT_NODE_PATH	  "/sys/devices/system/node" /* NUMA node CPU lists */
+#define PLACEMENT_MAX_NODES	  64	     /* NUMA nodes searched */
+
+/**
+ * enum placement_class - Thread classes with their own placement
+ */
+enum placement_class {
+	PLACEMENT_MAIN = 0,	  /* Daemon main loop */
+	PLACEMENT_RINGBUF = 1,	  /* eBPF ring buffer consumer */
+	PLACEMENT_AI = 2,	  /* AI analysis thread */
+	PLACEMENT_BACKGROUND = 3, /* Store writer, health, status and control */
+	PLACEMENT_CLASS_MAX = 4
+};
+
+/**
+ * placement_set_cpus - Configure the CPU set of a thread class
+ * @spec: "CLASS=CPUS", CLASS one of main, ringbuf, ai, background and CPUS
+ *        a list such as "2-3,6" or a NUMA node such as "node1"
+ *
+ * Return: 0 on success, -1 if @spec is invalid
+ */
+int placement_set_cpus(const char* spec);
+
+/**
+ * placement_set_policy - Configure the scheduling policy of a thread class
+ * @spec: "CLASS=POLICY[:VALUE]", POLICY one of fifo, rr (VALUE: priority
+ *        1-99), other, nice, batch (VALUE: nice -20..19) or idle
+ *
+ * Return: 0 on success, -1 if @spec is invalid
+ */
+int placement_set_policy(const char* spec);
+
+/**
+ * placement_init - Enable thread placement
+ *
+ * Records the CPUs and policy the daemon was started with, fills in the
+ * default policies and logs the configuration. Call before any daemon
+ * thread starts.
+ */
+void placement_init(void);
+
+/**
+ * placement_apply - Place the calling thread
+ * @cls: Class of the calling thread
+ *
+ * Sets the CPU affinity and scheduling policy of @cls, falling back as
+ * described above. Does nothing before placement_init().
+ */
+void placement_apply(enum placement_class cls);
+
+/**
+ * placement_bind - Move the calling thread to the CPUs of a class
+ * @cls: Class whose CPU set to use
+ *
+ * Changes the CPU affinity only, e.g. to allocate memory on the NUMA node
+ * of another thread class. Does nothing if @cls has no CPU set.
+ */
+void placement_bind(enum placement_class cls);
+
+#endif // RAVN_PLACEMENT_H
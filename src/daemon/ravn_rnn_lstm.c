@@ -1,6 +1,7 @@
 // RAVN LSTM Neural Network Implementation
 // Full implementation with proper LSTM cells and dense layers
 
+#include "../utils/error_handling.h"
 #include "../utils/logger.h"
 #include "codegen/model_weights.h"
 #include "ravn_lstm.h"
@@ -141,6 +142,8 @@ int lstm_cell_forward(lstm_cell_t* cell, const float* input) {
 		return -1;
 	}
 
+	RAVN_TIME_START(lstm_forward);
+
 	// Matrix-vector multiplication helper
 	void matvec_mult(const float* matrix, const float* vector, float* result, int rows,
 			 int cols) {
@@ -196,6 +199,7 @@ int lstm_cell_forward(lstm_cell_t* cell, const float* input) {
 	memcpy(cell->h_prev, cell->h_curr, cell->hidden_size * sizeof(float));
 	memcpy(cell->c_prev, cell->c_curr, cell->hidden_size * sizeof(float));
 
+	RAVN_TIME_END(lstm_forward, "LSTM", "lstm_cell_forward");
 	return 0;
 }
 
@@ -241,6 +245,8 @@ int dense_layer_forward(dense_layer_t* layer, const float* input, float* output)
 		return -1;
 	}
 
+	RAVN_TIME_START(dense_forward);
+
 	// Matrix-vector multiplication: output = input * weights + bias
 	for (int i = 0; i < layer->output_size; i++) {
 		output[i] = layer->bias[i];
@@ -249,6 +255,7 @@ int dense_layer_forward(dense_layer_t* layer, const float* input, float* output)
 		}
 	}
 
+	RAVN_TIME_END(dense_forward, "LSTM", "dense_layer_forward");
 	return 0;
 }
 
@@ -411,6 +418,8 @@ float ravn_model_predict(ravn_model_t* model, const float* sequence, size_t sequ
 		return -1.0f;
 	}
 
+	RAVN_TIME_START(predict);
+
 	// Reset LSTM states
 	lstm_cell_reset_state(&model->lstm1);
 	lstm_cell_reset_state(&model->lstm2);
@@ -461,6 +470,8 @@ float ravn_model_predict(ravn_model_t* model, const float* sequence, size_t sequ
 	// Apply softmax to get probabilities
 	softmax(model->final_output, OUTPUT_CLASSES, 0);
 
+	RAVN_TIME_END(predict, "LSTM", "ravn_model_predict");
+
 	// Return threat score (probability of attack class)
 	return model->final_output[2]; // Attack class probability
 }
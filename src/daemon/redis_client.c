@@ -3,9 +3,12 @@
 
 #include "redis_client.h"
 
+#include "../utils/error_handling.h"
 #include "../utils/logger.h"
+#include "cgroup.h"
 
 #include <hiredis/hiredis.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -45,6 +48,7 @@ redis_connection_t* redis_connect(const char* host, int port) {
 		return NULL;
 	}
 
+	pthread_mutex_init(&conn->lock, NULL);
 	conn->connected = 1;
 	global_redis_conn = conn;
 	LOG_INFO("Connected to Redis at %s:%d", host, port);
@@ -60,6 +64,7 @@ void redis_disconnect(redis_connection_t* conn) {
 
 	if (conn) {
 		conn->connected = 0;
+		pthread_mutex_destroy(&conn->lock);
 		free(conn);
 	}
 
@@ -70,9 +75,43 @@ void redis_disconnect(redis_connection_t* conn) {
 	LOG_INFO("Redis connection closed");
 }
 
-// Check if Redis connection is active
-int redis_is_connected(redis_connection_t* conn) {
-	if (!conn || !conn->context || !conn->connected) {
+// Replace the context of a connection, in place
+int redis_reconnect(redis_connection_t* conn) {
+	if (!conn) {
+		return -1;
+	}
+
+	// Connect outside the lock: senders fail fast on the broken context meanwhile
+	redisContext* context = redisConnect(conn->host, conn->port);
+	if (!context || context->err) {
+		if (context) {
+			snprintf(last_error, sizeof(last_error), "Redis connection error: %s",
+				 context->errstr);
+			redisFree(context);
+		} else {
+			snprintf(last_error, sizeof(last_error), "Failed to allocate Redis context");
+		}
+		return -1;
+	}
+
+	pthread_mutex_lock(&conn->lock);
+	redisContext* old = conn->context;
+	conn->context = context;
+	conn->connected = 1;
+	pthread_mutex_unlock(&conn->lock);
+
+	// No sender can reach the old context any more
+	if (old) {
+		redisFree(old);
+	}
+
+	LOG_INFO("Reconnected to Redis at %s:%d", conn->host, conn->port);
+	return 0;
+}
+
+// Check the context of a connection (caller holds the connection lock)
+static int context_ok(redis_connection_t* conn) {
+	if (!conn->context || !conn->connected) {
 		return 0;
 	}
 
@@ -87,13 +126,57 @@ int redis_is_connected(redis_connection_t* conn) {
 	return 1;
 }
 
+// Take the connection lock if the connection is usable
+static int lock_connected(redis_connection_t* conn) {
+	if (!conn) {
+		snprintf(last_error, sizeof(last_error), "Redis not connected");
+		return -1;
+	}
+
+	pthread_mutex_lock(&conn->lock);
+	if (!context_ok(conn)) {
+		pthread_mutex_unlock(&conn->lock);
+		snprintf(last_error, sizeof(last_error), "Redis not connected");
+		return -1;
+	}
+	return 0;
+}
+
+// Check if Redis connection is active
+int redis_is_connected(redis_connection_t* conn) {
+	if (!conn) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&conn->lock);
+	int ok = context_ok(conn);
+	pthread_mutex_unlock(&conn->lock);
+	return ok;
+}
+
+// Run one command under the connection lock
+redisReply* redis_command(redis_connection_t* conn, const char* format, ...) {
+	if (lock_connected(conn) != 0) {
+		return NULL;
+	}
+
+	va_list args;
+	va_start(args, format);
+	redisReply* reply = redisvCommand(conn->context, format, args);
+	va_end(args);
+	pthread_mutex_unlock(&conn->lock);
+
+	return reply;
+}
+
 // Send event to Redis
 int redis_send_event(redis_connection_t* conn, const struct ravn_event* event) {
-	if (!redis_is_connected(conn)) {
-		snprintf(last_error, sizeof(last_error), "Redis not connected");
+	if (!conn || !event) {
 		return -1;
 	}
 
+	RAVN_TIME_START(send_event);
+
 	// Create JSON representation with proper escaping
 	char json_data[2048];
 	char escaped_data[1024];
@@ -113,11 +196,19 @@ int redis_send_event(redis_connection_t* conn, const struct ravn_event* event) {
 	}
 	escaped_data[j] = '\0';
 
+	// Container attribution, from the resolver cache after the first event of a cgroup
+	struct cgroup_info cgroup;
+	cgroup_lookup(event->cgroup_id, &cgroup);
+
 	int json_len = snprintf(json_data, sizeof(json_data),
 				"{\"timestamp\":%lu,\"pid\":%u,\"tid\":%u,\"event_type\":%u,"
-				"\"event_category\":%u,\"comm\":\"%s\",\"data\":\"%s\"}",
+				"\"event_category\":%u,\"comm\":\"%s\",\"data\":\"%s\","
+				"\"cgroup_id\":%lu,\"container\":\"%s\",\"container_id\":\"%s\","
+				"\"pod_uid\":\"%s\"}",
 				event->timestamp, event->pid, event->tid, event->event_type,
-				event->event_category, event->comm, escaped_data);
+				event->event_category, event->comm, escaped_data, event->cgroup_id,
+				cgroup.container_id[0] ? cgroup.name : "", cgroup.container_id,
+				cgroup.pod_uid);
 
 	// Check if JSON data was truncated
 	if (json_len >= (int)sizeof(json_data)) {
@@ -129,9 +220,13 @@ int redis_send_event(redis_connection_t* conn, const struct ravn_event* event) {
 	// Debug: Log the JSON data being sent
 	LOG_INFO_MODULE("REDIS-CLIENT", "Sending JSON data (%d bytes): %s", json_len, json_data);
 
-	// Send to events list
+	// Send to events list, and trim it, in one locked exchange
+	if (lock_connected(conn) != 0) {
+		return -1;
+	}
 	redisReply* reply = redisCommand(conn->context, "LPUSH events:raw %s", json_data);
 	if (!reply) {
+		pthread_mutex_unlock(&conn->lock);
 		snprintf(last_error, sizeof(last_error), "Failed to send event to Redis");
 		return -1;
 	}
@@ -142,6 +237,7 @@ int redis_send_event(redis_connection_t* conn, const struct ravn_event* event) {
 
 	// Check for Redis errors first
 	if (reply->type == REDIS_REPLY_ERROR) {
+		pthread_mutex_unlock(&conn->lock);
 		snprintf(last_error, sizeof(last_error), "Redis error: %s", reply->str);
 		freeReplyObject(reply);
 		return -1;
@@ -162,20 +258,20 @@ int redis_send_event(redis_connection_t* conn, const struct ravn_event* event) {
 	freeReplyObject(reply);
 
 	// Keep only last 1000 events
-	redisCommand(conn->context, "LTRIM events:raw 0 999");
+	reply = redisCommand(conn->context, "LTRIM events:raw 0 999");
+	pthread_mutex_unlock(&conn->lock);
+	if (reply) {
+		freeReplyObject(reply);
+	}
 
+	RAVN_TIME_END(send_event, "REDIS-CLIENT", "redis_send_event");
 	return result;
 }
 
 // Get event from Redis
 int redis_get_event(redis_connection_t* conn, struct ravn_event* event) {
-	if (!redis_is_connected(conn)) {
-		snprintf(last_error, sizeof(last_error), "Redis not connected");
-		return -1;
-	}
-
 	// Get event from events list (blocking with 1 second timeout)
-	redisReply* reply = redisCommand(conn->context, "BRPOP events:raw 1");
+	redisReply* reply = redis_command(conn, "BRPOP events:raw 1");
 	if (!reply || reply->type != REDIS_REPLY_ARRAY || reply->elements < 2) {
 		if (reply)
 			freeReplyObject(reply);
@@ -190,6 +286,10 @@ int redis_get_event(redis_connection_t* conn, struct ravn_event* event) {
 			    "\"]\",\"data\":\"%1023[^\"]\"}",
 			    &event->timestamp, &event->pid, &event->tid, &event->event_type,
 			    &event->event_category, event->comm, event->data);
+	const char* cgroup = strstr(json_str, "\"cgroup_id\":");
+	if (parsed == 7 && cgroup) {
+		sscanf(cgroup, "\"cgroup_id\":%lu", &event->cgroup_id);
+	}
 
 	freeReplyObject(reply);
 
@@ -213,11 +313,6 @@ int redis_subscribe_events(redis_connection_t* conn, void (*callback)(const stru
 
 // Update threat level in Redis
 int redis_update_threat_level(redis_connection_t* conn, const threat_level_t* threat) {
-	if (!redis_is_connected(conn)) {
-		snprintf(last_error, sizeof(last_error), "Redis not connected");
-		return -1;
-	}
-
 	// Create JSON representation
 	char json_data[512];
 	snprintf(json_data, sizeof(json_data),
@@ -226,8 +321,12 @@ int redis_update_threat_level(redis_connection_t* conn, const threat_level_t* th
 		 threat->timestamp, threat->score, threat->level, threat->reason);
 
 	// Store current threat level
+	if (lock_connected(conn) != 0) {
+		return -1;
+	}
 	redisReply* reply = redisCommand(conn->context, "SET threat:current %s", json_data);
 	if (!reply) {
+		pthread_mutex_unlock(&conn->lock);
 		snprintf(last_error, sizeof(last_error), "Failed to update threat level");
 		return -1;
 	}
@@ -236,19 +335,18 @@ int redis_update_threat_level(redis_connection_t* conn, const threat_level_t* th
 	freeReplyObject(reply);
 
 	// Publish threat level update
-	redisCommand(conn->context, "PUBLISH threat:update %s", json_data);
+	reply = redisCommand(conn->context, "PUBLISH threat:update %s", json_data);
+	pthread_mutex_unlock(&conn->lock);
+	if (reply) {
+		freeReplyObject(reply);
+	}
 
 	return result;
 }
 
 // Get current threat level from Redis
 int redis_get_threat_level(redis_connection_t* conn, threat_level_t* threat) {
-	if (!redis_is_connected(conn)) {
-		snprintf(last_error, sizeof(last_error), "Redis not connected");
-		return -1;
-	}
-
-	redisReply* reply = redisCommand(conn->context, "GET threat:current");
+	redisReply* reply = redis_command(conn, "GET threat:current");
 	if (!reply || reply->type != REDIS_REPLY_STRING) {
 		if (reply)
 			freeReplyObject(reply);
@@ -283,6 +381,151 @@ int redis_subscribe_threat_updates(redis_connection_t* conn,
 	return 0;
 }
 
+// Set multiple fields of a Redis hash in one command
+int redis_hash_set(redis_connection_t* conn, const char* key, const char* const* fields,
+		   const char* const* values, int count) {
+	if (!key || !fields || !values || count <= 0) {
+		return -1;
+	}
+
+	int argc = 2 + count * 2;
+	const char** argv = malloc(sizeof(*argv) * argc);
+	if (!argv) {
+		snprintf(last_error, sizeof(last_error), "Failed to allocate HSET arguments");
+		return -1;
+	}
+
+	argv[0] = "HSET";
+	argv[1] = key;
+	for (int i = 0; i < count; i++) {
+		argv[2 + i * 2] = fields[i];
+		argv[3 + i * 2] = values[i];
+	}
+
+	if (lock_connected(conn) != 0) {
+		free(argv);
+		return -1;
+	}
+	redisReply* reply = redisCommandArgv(conn->context, argc, argv, NULL);
+	pthread_mutex_unlock(&conn->lock);
+	free(argv);
+	if (!reply) {
+		snprintf(last_error, sizeof(last_error), "Failed to update hash %s", key);
+		return -1;
+	}
+
+	int result = reply->type == REDIS_REPLY_ERROR ? -1 : 0;
+	if (result != 0) {
+		snprintf(last_error, sizeof(last_error), "Redis error: %s", reply->str);
+	}
+	freeReplyObject(reply);
+
+	return result;
+}
+
+// Empty a hash before it is filled again
+void redis_hash_reset(struct redis_hash* hash) {
+	hash->count = 0;
+	hash->dropped = 0;
+}
+
+// Add one formatted field to a hash
+int redis_hash_add(struct redis_hash* hash, const char* name_fmt, const char* name_arg,
+		   const char* value_fmt, ...) {
+	int n = hash->count;
+	va_list args;
+
+	if (n >= REDIS_HASH_MAX_FIELDS) {
+		hash->dropped++;
+		return -1;
+	}
+
+	int name_len = snprintf(hash->names[n], sizeof(hash->names[n]), name_fmt, name_arg);
+	va_start(args, value_fmt);
+	int value_len = vsnprintf(hash->values[n], sizeof(hash->values[n]), value_fmt, args);
+	va_end(args);
+	if (name_len < 0 || name_len >= REDIS_HASH_NAME_LEN || value_len < 0 ||
+	    value_len >= REDIS_HASH_VALUE_LEN) {
+		hash->dropped++;
+		return -1;
+	}
+
+	hash->fields[n] = hash->names[n];
+	hash->vals[n] = hash->values[n];
+	hash->count++;
+	return 0;
+}
+
+// Write the fields of a hash in one HSET
+int redis_hash_write(redis_connection_t* conn, const char* key, const struct redis_hash* hash) {
+	if (!hash) {
+		return -1;
+	}
+	if (hash->dropped > 0) { // Published every pass: keep the log quiet
+		LOG_DEBUG_MODULE("REDIS-CLIENT", "Hash %s: %d fields skipped", key, hash->dropped);
+	}
+	return redis_hash_set(conn, key, hash->fields, hash->vals, hash->count);
+}
+
+int redis_zset_replace(redis_connection_t* conn, const char* key, const char* const* members,
+		       const double* scores, int count) {
+	if (!key || count < 0 || (count > 0 && (!members || !scores))) {
+		return -1;
+	}
+
+	int argc = 2 + count * 2;
+	const char** argv = malloc(sizeof(*argv) * argc);
+	char (*score_str)[32] = malloc(sizeof(*score_str) * (count > 0 ? count : 1));
+	if (!argv || !score_str) {
+		free(argv);
+		free(score_str);
+		snprintf(last_error, sizeof(last_error), "Failed to allocate ZADD arguments");
+		return -1;
+	}
+
+	argv[0] = "ZADD";
+	argv[1] = key;
+	for (int i = 0; i < count; i++) {
+		snprintf(score_str[i], sizeof(score_str[i]), "%.17g", scores[i]);
+		argv[2 + i * 2] = score_str[i];
+		argv[3 + i * 2] = members[i];
+	}
+
+	// MULTI, DEL, [ZADD], EXEC in one round trip
+	if (lock_connected(conn) != 0) {
+		free(argv);
+		free(score_str);
+		return -1;
+	}
+	int replies = count > 0 ? 4 : 3;
+	redisAppendCommand(conn->context, "MULTI");
+	redisAppendCommand(conn->context, "DEL %s", key);
+	if (count > 0) {
+		redisAppendCommandArgv(conn->context, argc, argv, NULL);
+	}
+	redisAppendCommand(conn->context, "EXEC");
+	free(argv);
+	free(score_str);
+
+	int result = 0;
+	for (int i = 0; i < replies; i++) {
+		redisReply* reply = NULL;
+		if (redisGetReply(conn->context, (void**)&reply) != REDIS_OK || !reply) {
+			pthread_mutex_unlock(&conn->lock);
+			snprintf(last_error, sizeof(last_error), "Failed to replace sorted set %s", key);
+			return -1;
+		}
+		if (reply->type == REDIS_REPLY_ERROR) {
+			snprintf(last_error, sizeof(last_error), "Redis error: %s", reply->str);
+			result = -1;
+		}
+		freeReplyObject(reply);
+	}
+	pthread_mutex_unlock(&conn->lock);
+
+	return result;
+}
+
 // Get last error message
 char* redis_get_last_error(void) {
 	return last_error;
@@ -290,11 +533,7 @@ char* redis_get_last_error(void) {
 
 // Ping Redis server
 int redis_ping(redis_connection_t* conn) {
-	if (!conn || !conn->context) {
-		return -1;
-	}
-
-	redisReply* reply = redisCommand(conn->context, "PING");
+	redisReply* reply = redis_command(conn, "PING");
 	if (!reply) {
 		return -1;
 	}
@@ -308,11 +547,7 @@ int redis_ping(redis_connection_t* conn) {
 
 // Flush all Redis data
 int redis_flush_all(redis_connection_t* conn) {
-	if (!redis_is_connected(conn)) {
-		return -1;
-	}
-
-	redisReply* reply = redisCommand(conn->context, "FLUSHALL");
+	redisReply* reply = redis_command(conn, "FLUSHALL");
 	if (!reply) {
 		return -1;
 	}
@@ -26,11 +26,23 @@
 #ifndef RAVN_REDIS_CLIENT_H
 #define RAVN_REDIS_CLIENT_H
 
+#include <pthread.h>
 #include <stdint.h>
 #include <time.h>
 
-/* Forward declaration for Redis context */
+/*
+ * Redis Keys Shared Between Daemon and Readers
+ */
+#define REDIS_STATS_KEY		"ravn:stats"		/* Cumulative event counters */
+#define REDIS_SKETCH_PREFIX	"ravn:sketch:"		/* Heavy hitters, one zset per dimension */
+#define REDIS_SKETCH_SUMMARY	"ravn:sketch:summary"	/* Distinct and total counts */
+#define REDIS_CGROUP_KEY	"ravn:cgroups"		/* Threat score per cgroup, zset */
+#define REDIS_HOSTS_KEY		"ravn:hosts"		/* Threat score per forwarding host, zset */
+#define REDIS_HOST_PREFIX	"ravn:host:"		/* State of one forwarding host, hash */
+
+/* Forward declarations for Redis context and replies */
 typedef struct redisContext redisContext;
+typedef struct redisReply redisReply;
 
 /**
  * struct redis_connection - Redis connection structure
@@ -38,8 +50,13 @@ typedef struct redisContext redisContext;
  * @connected: Connection status flag
  * @host: Redis server hostname or IP address
  * @port: Redis server port number
+ * @lock: Serializes commands and their replies on @context
  *
- * Represents a connection to a Redis server with status tracking.
+ * Represents a connection to a Redis server with status tracking. A hiredis
+ * context is not thread-safe: every function of this client holds @lock
+ * from sending a command until its reply is read, so one connection can be
+ * shared by several threads. Never use @context directly on a shared
+ * connection; use redis_command() instead.
  */
 typedef struct redis_connection redis_connection_t;
 struct redis_connection {
@@ -47,6 +64,7 @@ struct redis_connection {
 	int connected;	       /* Connection status */
 	char host[256];	       /* Server hostname/IP */
 	int port;	       /* Server port */
+	pthread_mutex_t lock;  /* Command serialization */
 };
 
 /* Include the full definition */
@@ -110,6 +128,19 @@ redis_connection_t* redis_connect(const char* host, int port);
  */
 void redis_disconnect(redis_connection_t* conn);
 
+/**
+ * redis_reconnect - Replace the context of a connection
+ * @conn: Redis connection handle
+ *
+ * Connects a new context to the same server, swaps it in under the
+ * connection lock and frees the old one. Threads holding @conn keep using it
+ * unchanged: a command in progress finishes on the old context before the
+ * swap, later ones run on the new context.
+ *
+ * Return: 0 on success, -1 if the server is unreachable (@conn is left as is)
+ */
+int redis_reconnect(redis_connection_t* conn);
+
 /**
  * redis_is_connected - Check connection status
  * @conn: Redis connection handle
@@ -120,6 +151,17 @@ void redis_disconnect(redis_connection_t* conn);
  */
 int redis_is_connected(redis_connection_t* conn);
 
+/**
+ * redis_command - Run one command on a connection
+ * @conn: Redis connection handle
+ * @format: hiredis command format
+ *
+ * Sends the command and reads its reply under the connection lock.
+ *
+ * Return: Reply to release with freeReplyObject(), NULL on failure
+ */
+redisReply* redis_command(redis_connection_t* conn, const char* format, ...);
+
 /*
  * Event Management Functions
  */
@@ -199,6 +241,97 @@ int redis_get_threat_level(redis_connection_t* conn, threat_level_t* threat);
 int redis_subscribe_threat_updates(redis_connection_t* conn,
 				   void (*callback)(const threat_level_t*));
 
+/*
+ * Metrics Functions
+ */
+
+/**
+ * redis_hash_set - Set multiple fields of a Redis hash
+ * @conn: Redis connection handle
+ * @key: Hash key
+ * @fields: Field names
+ * @values: Field values, one per field
+ * @count: Number of field/value pairs
+ *
+ * Issues a single HSET with all pairs, so metric records are updated
+ * in one round trip.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int redis_hash_set(redis_connection_t* conn, const char* key, const char* const* fields,
+		   const char* const* values, int count);
+
+#define REDIS_HASH_MAX_FIELDS 128 /* Fields of one struct redis_hash */
+#define REDIS_HASH_NAME_LEN 48	  /* Longest field name, with the terminator */
+#define REDIS_HASH_VALUE_LEN 32	  /* Longest field value, with the terminator */
+
+/**
+ * struct redis_hash - Fields of a metric hash built for redis_hash_write()
+ * @count: Number of fields added
+ * @dropped: Fields skipped because they were full or too long
+ * @names: Formatted field names
+ * @values: Formatted field values
+ * @fields: Pointers to @names, as redis_hash_set() takes them
+ * @vals: Pointers to @values, as redis_hash_set() takes them
+ *
+ * Large enough to be kept static by the publisher that fills it.
+ */
+struct redis_hash {
+	int count;
+	int dropped;
+	char names[REDIS_HASH_MAX_FIELDS][REDIS_HASH_NAME_LEN];
+	char values[REDIS_HASH_MAX_FIELDS][REDIS_HASH_VALUE_LEN];
+	const char* fields[REDIS_HASH_MAX_FIELDS];
+	const char* vals[REDIS_HASH_MAX_FIELDS];
+};
+
+/**
+ * redis_hash_reset - Empty a hash before it is filled again
+ * @hash: Hash to reset
+ */
+void redis_hash_reset(struct redis_hash* hash);
+
+/**
+ * redis_hash_add - Add one formatted field to a hash
+ * @hash: Hash to add to
+ * @name_fmt: Field name format with a single %s, e.g. "%s_events"
+ * @name_arg: String substituted into @name_fmt
+ * @value_fmt: printf format of the value
+ *
+ * A field that would be truncated, or that does not fit, is skipped and
+ * counted in @hash->dropped instead of being published cut short.
+ *
+ * Return: 0 on success, -1 if the field was skipped
+ */
+int redis_hash_add(struct redis_hash* hash, const char* name_fmt, const char* name_arg,
+		   const char* value_fmt, ...) __attribute__((format(printf, 4, 5)));
+
+/**
+ * redis_hash_write - Write the fields of a hash with redis_hash_set()
+ * @conn: Redis connection handle
+ * @key: Hash key
+ * @hash: Fields to write
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int redis_hash_write(redis_connection_t* conn, const char* key, const struct redis_hash* hash);
+
+/**
+ * redis_zset_replace - Replace the contents of a Redis sorted set
+ * @conn: Redis connection handle
+ * @key: Sorted set key
+ * @members: Member names
+ * @scores: Member scores, one per member
+ * @count: Number of members (0 leaves the set empty)
+ *
+ * Pipelines DEL and ZADD inside MULTI/EXEC, so readers never see a
+ * half-updated set and the update costs one round trip.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int redis_zset_replace(redis_connection_t* conn, const char* key, const char* const* members,
+		       const double* scores, int count);
+
 /*
  * Utility Functions
  */
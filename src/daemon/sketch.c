@@ -0,0 +1,329 @@
+// RAVN Activity Sketches Implementation
+// Space-Saving, Count-Min and HyperLogLog sketches over the event stream
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "sketch.h"
+
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+
+#define SKETCH_HLL_REGISTERS	     (1u << SKETCH_HLL_BITS)
+#define SKETCH_PROCESS_HLL_REGISTERS (1u << SKETCH_PROCESS_HLL_BITS)
+
+// One Space-Saving counter
+struct sketch_counter {
+	uint64_t hash;		  /* Key hash, compared before the key */
+	uint64_t count;		  /* Estimated count */
+	uint64_t error;		  /* Overestimation bound */
+	char key[SKETCH_KEY_LEN]; /* Key */
+};
+
+// All sketches of one dimension
+struct sketch_state {
+	pthread_mutex_t lock;
+	uint64_t total;
+	int used;
+	struct sketch_counter top[SKETCH_TOP_K];
+	uint32_t cm[SKETCH_CM_DEPTH][SKETCH_CM_WIDTH];
+	uint8_t hll[SKETCH_HLL_REGISTERS];
+};
+
+// Distinct files of one process
+struct sketch_process {
+	uint32_t pid;					/* Owner, 0 if free */
+	uint8_t hll[SKETCH_PROCESS_HLL_REGISTERS];	/* Path registers */
+};
+
+static struct sketch_state sketches[SKETCH_DIMENSION_MAX] = {
+	[SKETCH_PROCESS] = {.lock = PTHREAD_MUTEX_INITIALIZER},
+	[SKETCH_FILE] = {.lock = PTHREAD_MUTEX_INITIALIZER},
+	[SKETCH_PORT] = {.lock = PTHREAD_MUTEX_INITIALIZER},
+	[SKETCH_USER] = {.lock = PTHREAD_MUTEX_INITIALIZER},
+};
+
+static struct sketch_process processes[SKETCH_PROCESS_SLOTS];
+static pthread_mutex_t process_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* const dimension_names[SKETCH_DIMENSION_MAX] = {
+	[SKETCH_PROCESS] = "process",
+	[SKETCH_FILE] = "file",
+	[SKETCH_PORT] = "port",
+	[SKETCH_USER] = "user",
+};
+
+// Final mix of a 64-bit hash (splitmix64), spreads bits for HyperLogLog
+static uint64_t sketch_mix(uint64_t x) {
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBULL;
+	x ^= x >> 31;
+	return x;
+}
+
+// Hash a key as it is stored (truncated to SKETCH_KEY_LEN - 1 bytes)
+static uint64_t sketch_hash(const char* key) {
+	uint64_t h = 0xCBF29CE484222325ULL; // FNV-1a
+	for (size_t i = 0; key[i] && i < SKETCH_KEY_LEN - 1; i++) {
+		h ^= (unsigned char)key[i];
+		h *= 0x100000001B3ULL;
+	}
+	return sketch_mix(h);
+}
+
+// Add a hash to a HyperLogLog
+static void hll_add(uint8_t* registers, int bits, uint64_t hash) {
+	uint32_t index = (uint32_t)(hash >> (64 - bits));
+	uint64_t rest = hash << bits;
+	uint8_t rank = rest ? (uint8_t)(__builtin_clzll(rest) + 1) : (uint8_t)(64 - bits + 1);
+	if (registers[index] < rank) {
+		registers[index] = rank;
+	}
+}
+
+// Estimate the cardinality of a HyperLogLog, with linear counting for small sets
+static double hll_estimate(const uint8_t* registers, int bits) {
+	uint32_t m = 1u << bits;
+	double alpha = m >= 128 ? 0.7213 / (1.0 + 1.079 / m) : m == 64 ? 0.709 : 0.697;
+	double sum = 0.0;
+	uint32_t zeros = 0;
+
+	for (uint32_t i = 0; i < m; i++) {
+		sum += ldexp(1.0, -registers[i]);
+		zeros += registers[i] == 0;
+	}
+
+	double estimate = alpha * m * m / sum;
+	if (estimate <= 2.5 * m && zeros > 0) {
+		estimate = m * log((double)m / zeros);
+	}
+	return estimate;
+}
+
+// Count-Min column of a hash in one row
+static uint32_t cm_column(uint64_t hash, int row) {
+	uint32_t h1 = (uint32_t)hash;
+	uint32_t h2 = (uint32_t)(hash >> 32) | 1;
+	return (h1 + (uint32_t)row * h2) % SKETCH_CM_WIDTH;
+}
+
+// Conservative update: only raise the counters that are below the new estimate
+static uint32_t cm_add(struct sketch_state* s, uint64_t hash) {
+	uint32_t estimate = UINT32_MAX;
+	for (int row = 0; row < SKETCH_CM_DEPTH; row++) {
+		uint32_t c = s->cm[row][cm_column(hash, row)];
+		estimate = c < estimate ? c : estimate;
+	}
+	if (estimate == UINT32_MAX) {
+		return estimate;
+	}
+	for (int row = 0; row < SKETCH_CM_DEPTH; row++) {
+		uint32_t* c = &s->cm[row][cm_column(hash, row)];
+		if (*c <= estimate) {
+			*c = estimate + 1;
+		}
+	}
+	return estimate + 1;
+}
+
+// Space-Saving update. A new key takes the smallest counter only when its
+// Count-Min estimate beats it, and starts from that estimate rather than from
+// the evicted count, so the long tail does not churn through the table.
+static void topk_add(struct sketch_state* s, uint64_t hash, const char* key, uint32_t estimate) {
+	int min = 0;
+	for (int i = 0; i < s->used; i++) {
+		struct sketch_counter* c = &s->top[i];
+		if (c->hash == hash && strncmp(c->key, key, SKETCH_KEY_LEN - 1) == 0) {
+			c->count++;
+			return;
+		}
+		if (c->count < s->top[min].count) {
+			min = i;
+		}
+	}
+
+	struct sketch_counter* c;
+	if (s->used < SKETCH_TOP_K) {
+		c = &s->top[s->used++];
+	} else if (estimate > s->top[min].count) {
+		c = &s->top[min];
+	} else {
+		return;
+	}
+	c->hash = hash;
+	c->count = estimate;
+	c->error = estimate - 1;
+	snprintf(c->key, sizeof(c->key), "%s", key);
+}
+
+// Count one occurrence of a key
+void sketch_observe(enum sketch_dimension dim, const char* key) {
+	if ((unsigned)dim >= SKETCH_DIMENSION_MAX || !key || !key[0]) {
+		return;
+	}
+
+	struct sketch_state* s = &sketches[dim];
+	uint64_t hash = sketch_hash(key);
+
+	pthread_mutex_lock(&s->lock);
+	s->total++;
+	topk_add(s, hash, key, cm_add(s, hash));
+	hll_add(s->hll, SKETCH_HLL_BITS, hash);
+	pthread_mutex_unlock(&s->lock);
+}
+
+// Note a file touched by a process
+void sketch_observe_process_file(uint32_t pid, const char* path) {
+	if (!path || !path[0]) {
+		return;
+	}
+
+	sketch_observe(SKETCH_FILE, path);
+	if (pid == 0) {
+		return;
+	}
+
+	struct sketch_process* p = &processes[sketch_mix(pid) % SKETCH_PROCESS_SLOTS];
+	pthread_mutex_lock(&process_lock);
+	if (p->pid != pid) {
+		p->pid = pid;
+		memset(p->hll, 0, sizeof(p->hll));
+	}
+	hll_add(p->hll, SKETCH_PROCESS_HLL_BITS, sketch_hash(path));
+	pthread_mutex_unlock(&process_lock);
+}
+
+// Copy the heavy hitters of a dimension, highest count first
+int sketch_get_top(enum sketch_dimension dim, struct sketch_item* items, int max) {
+	if ((unsigned)dim >= SKETCH_DIMENSION_MAX || !items || max <= 0) {
+		return 0;
+	}
+
+	struct sketch_counter top[SKETCH_TOP_K];
+	struct sketch_state* s = &sketches[dim];
+	pthread_mutex_lock(&s->lock);
+	int used = s->used;
+	memcpy(top, s->top, (size_t)used * sizeof(top[0]));
+	pthread_mutex_unlock(&s->lock);
+
+	// Insertion into the sorted output, outside the lock
+	int count = 0;
+	for (int i = 0; i < used; i++) {
+		int pos = count;
+		while (pos > 0 && items[pos - 1].count < top[i].count) {
+			if (pos < max) {
+				items[pos] = items[pos - 1];
+			}
+			pos--;
+		}
+		if (pos < max) {
+			memcpy(items[pos].key, top[i].key, sizeof(items[pos].key));
+			items[pos].count = top[i].count;
+			items[pos].error = top[i].error;
+			if (count < max) {
+				count++;
+			}
+		}
+	}
+	return count;
+}
+
+// Estimate the occurrences of any key
+uint64_t sketch_estimate(enum sketch_dimension dim, const char* key) {
+	if ((unsigned)dim >= SKETCH_DIMENSION_MAX || !key || !key[0]) {
+		return 0;
+	}
+
+	struct sketch_state* s = &sketches[dim];
+	uint64_t hash = sketch_hash(key);
+	uint32_t estimate = UINT32_MAX;
+
+	pthread_mutex_lock(&s->lock);
+	for (int row = 0; row < SKETCH_CM_DEPTH; row++) {
+		uint32_t c = s->cm[row][cm_column(hash, row)];
+		estimate = c < estimate ? c : estimate;
+	}
+	pthread_mutex_unlock(&s->lock);
+
+	return estimate;
+}
+
+// Estimate the distinct keys seen in a dimension
+uint64_t sketch_distinct(enum sketch_dimension dim) {
+	if ((unsigned)dim >= SKETCH_DIMENSION_MAX) {
+		return 0;
+	}
+
+	uint8_t registers[SKETCH_HLL_REGISTERS];
+	struct sketch_state* s = &sketches[dim];
+	pthread_mutex_lock(&s->lock);
+	memcpy(registers, s->hll, sizeof(registers));
+	pthread_mutex_unlock(&s->lock);
+
+	return (uint64_t)llround(hll_estimate(registers, SKETCH_HLL_BITS));
+}
+
+// Count all observations of a dimension
+uint64_t sketch_total(enum sketch_dimension dim) {
+	if ((unsigned)dim >= SKETCH_DIMENSION_MAX) {
+		return 0;
+	}
+
+	struct sketch_state* s = &sketches[dim];
+	pthread_mutex_lock(&s->lock);
+	uint64_t total = s->total;
+	pthread_mutex_unlock(&s->lock);
+	return total;
+}
+
+// Estimate the distinct files of a process
+uint32_t sketch_process_distinct_files(uint32_t pid) {
+	if (pid == 0) {
+		return 0;
+	}
+
+	uint8_t registers[SKETCH_PROCESS_HLL_REGISTERS];
+	struct sketch_process* p = &processes[sketch_mix(pid) % SKETCH_PROCESS_SLOTS];
+	pthread_mutex_lock(&process_lock);
+	int tracked = p->pid == pid;
+	memcpy(registers, p->hll, sizeof(registers));
+	pthread_mutex_unlock(&process_lock);
+
+	return tracked ? (uint32_t)lround(hll_estimate(registers, SKETCH_PROCESS_HLL_BITS)) : 0;
+}
+
+// Clear every sketch
+void sketch_reset(void) {
+	for (int dim = 0; dim < SKETCH_DIMENSION_MAX; dim++) {
+		struct sketch_state* s = &sketches[dim];
+		pthread_mutex_lock(&s->lock);
+		s->total = 0;
+		s->used = 0;
+		memset(s->cm, 0, sizeof(s->cm));
+		memset(s->hll, 0, sizeof(s->hll));
+		pthread_mutex_unlock(&s->lock);
+	}
+
+	pthread_mutex_lock(&process_lock);
+	memset(processes, 0, sizeof(processes));
+	pthread_mutex_unlock(&process_lock);
+}
+
+// Name of a dimension
+const char* sketch_dimension_name(enum sketch_dimension dim) {
+	return (unsigned)dim < SKETCH_DIMENSION_MAX ? dimension_names[dim] : "unknown";
+}
+
+// Parse a dimension name
+int sketch_dimension_from_name(const char* name) {
+	for (int dim = 0; name && dim < SKETCH_DIMENSION_MAX; dim++) {
+		if (strcasecmp(name, dimension_names[dim]) == 0) {
+			return dim;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,152 @@
+/*
+ * RAVN Activity Sketches - Header File
+ *
+ * This header defines the streaming sketches of the RAVN security platform,
+ * which track the processes, files, ports and users that dominate activity
+ * in fixed memory, without keeping individual events.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The activity sketches implement:
+ * - Space-Saving top-K heavy hitters per dimension, with a per-entry
+ *   overestimation bound; new keys are admitted (and seeded) by their
+ *   Count-Min estimate, so the long tail does not churn the table
+ * - Count-Min frequency estimates with conservative update, for keys that
+ *   are not (or no longer) in the top-K
+ * - HyperLogLog distinct counts per dimension
+ * - Small per-process HyperLogLogs of the distinct files a process touched
+ *
+ * Architecture:
+ * - The eBPF handlers feed every decoded event: process names from all
+ *   categories, paths from syscall, file and security events, destination
+ *   ports from network events and user IDs from process and security events
+ * - Memory is static and fixed (about 175 KB), whatever the event rate
+ * - Each dimension has its own lock, held for one update or one copy
+ * - Readers (control socket, Redis publisher) work on sorted copies
+ */
+
+#ifndef RAVN_SKETCH_H
+#define RAVN_SKETCH_H
+
+#include <stdint.h>
+
+/*
+ * Activity Sketch Configuration Parameters
+ */
+#define SKETCH_TOP_K		32   /* Space-Saving counters per dimension */
+#define SKETCH_KEY_LEN		64   /* Longest tracked key (truncated) */
+#define SKETCH_CM_DEPTH		4    /* Count-Min rows */
+#define SKETCH_CM_WIDTH		2048 /* Count-Min counters per row */
+#define SKETCH_HLL_BITS		12   /* HyperLogLog index bits (4096 registers) */
+#define SKETCH_PROCESS_SLOTS	256  /* Per-process distinct-file sketches */
+#define SKETCH_PROCESS_HLL_BITS 6    /* Index bits of a per-process sketch */
+
+/**
+ * enum sketch_dimension - What a sketch counts
+ */
+enum sketch_dimension {
+	SKETCH_PROCESS = 0, /* Process names */
+	SKETCH_FILE = 1,    /* File paths */
+	SKETCH_PORT = 2,    /* Destination ports */
+	SKETCH_USER = 3,    /* User IDs */
+	SKETCH_DIMENSION_MAX = 4
+};
+
+/**
+ * struct sketch_item - One heavy hitter
+ * @key: Tracked key
+ * @count: Estimated occurrences (never below the true count)
+ * @error: Largest possible overestimation of @count
+ */
+struct sketch_item {
+	char key[SKETCH_KEY_LEN]; /* Key */
+	uint64_t count;		  /* Estimated count */
+	uint64_t error;		  /* Overestimation bound */
+};
+
+/**
+ * sketch_observe - Count one occurrence of a key
+ * @dim: Dimension of the key
+ * @key: NUL-terminated key; empty keys are ignored
+ */
+void sketch_observe(enum sketch_dimension dim, const char* key);
+
+/**
+ * sketch_observe_process_file - Note a file touched by a process
+ * @pid: Process ID
+ * @path: File path; empty paths are ignored
+ *
+ * Also counts @path in the SKETCH_FILE dimension.
+ */
+void sketch_observe_process_file(uint32_t pid, const char* path);
+
+/**
+ * sketch_get_top - Copy the heavy hitters of a dimension
+ * @dim: Dimension
+ * @items: Output array, highest count first
+ * @max: Capacity of @items
+ *
+ * Return: Number of entries written
+ */
+int sketch_get_top(enum sketch_dimension dim, struct sketch_item* items, int max);
+
+/**
+ * sketch_estimate - Estimate the occurrences of any key
+ * @dim: Dimension
+ * @key: Key to look up
+ *
+ * Return: Count-Min estimate (never below the true count)
+ */
+uint64_t sketch_estimate(enum sketch_dimension dim, const char* key);
+
+/**
+ * sketch_distinct - Estimate the distinct keys seen in a dimension
+ * @dim: Dimension
+ *
+ * Return: HyperLogLog estimate
+ */
+uint64_t sketch_distinct(enum sketch_dimension dim);
+
+/**
+ * sketch_total - Count all observations of a dimension
+ * @dim: Dimension
+ *
+ * Return: Observations since startup or the last reset
+ */
+uint64_t sketch_total(enum sketch_dimension dim);
+
+/**
+ * sketch_process_distinct_files - Estimate the distinct files of a process
+ * @pid: Process ID
+ *
+ * Slots are shared by PID hash; a process that lost its slot to another
+ * reports 0 until it touches files again.
+ *
+ * Return: HyperLogLog estimate, 0 if the process is not tracked
+ */
+uint32_t sketch_process_distinct_files(uint32_t pid);
+
+/**
+ * sketch_reset - Clear every sketch
+ */
+void sketch_reset(void);
+
+/**
+ * sketch_dimension_name - Name of a dimension ("process", "file", ...)
+ * @dim: Dimension
+ *
+ * Return: Static name, "unknown" for invalid values
+ */
+const char* sketch_dimension_name(enum sketch_dimension dim);
+
+/**
+ * sketch_dimension_from_name - Parse a dimension name
+ * @name: Name as returned by sketch_dimension_name()
+ *
+ * Return: Dimension, -1 if unknown
+ */
+int sketch_dimension_from_name(const char* name);
+
+#endif // RAVN_SKETCH_H
@@ -0,0 +1,457 @@
+// RAVN Status Segment Implementation
+// Seqlock-protected daemon state snapshots in shared memory
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "status.h"
+
+#include "../utils/error_handling.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+#include "placement.h"
+#include "redis_client.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Samples kept for the event rate window
+enum { STATUS_RATE_SAMPLES = STATUS_RATE_WINDOW_MS / STATUS_INTERVAL_MS };
+
+// Event counters at one past snapshot
+struct status_rate_sample {
+	uint64_t time_ns;			    /* Sample time */
+	uint64_t events[EVENT_CATEGORY_MAX + 1];    /* Per category */
+};
+
+// Writer state, only touched by the status thread after status_init()
+static struct status_segment* segment = NULL;
+static ai_engine_t* status_engine = NULL;
+static struct status_rate_sample rate_samples[STATUS_RATE_SAMPLES];
+static int rate_next = 0;
+static int rate_count = 0;
+static uint64_t status_started = 0;
+static struct ravn_status last_published;
+static pthread_t status_thread;
+static volatile int status_running = 0;
+
+// Early publication requests
+static pthread_mutex_t notify_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t notify_cond;
+static int notify_pending = 0;
+
+// Overhead metrics handed over by the daemon main loop
+static struct overhead_report last_overhead;
+static int overhead_valid = 0;
+static pthread_mutex_t overhead_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Map a window score to the threat level enum
+static int32_t status_threat_level(float score) {
+	if (score >= THREAT_LEVEL_CRITICAL) {
+		return THREAT_CRITICAL;
+	}
+	if (score >= THREAT_LEVEL_HIGH) {
+		return THREAT_HIGH;
+	}
+	if (score >= THREAT_LEVEL_MEDIUM) {
+		return THREAT_MEDIUM;
+	}
+	return THREAT_LOW;
+}
+
+// Fill the event counters and rates over the rate window
+static void status_collect_events(struct ravn_status* status) {
+	struct status_rate_sample* cur = &rate_samples[rate_next];
+	cur->time_ns = status->updated_ns;
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		cur->events[cat] = ebpf_handler_get_event_count(cat);
+	}
+
+	// Oldest retained sample; the current one on the first pass
+	int oldest = rate_count < STATUS_RATE_SAMPLES ? 0 : (rate_next + 1) % STATUS_RATE_SAMPLES;
+	const struct status_rate_sample* old = &rate_samples[oldest];
+	double elapsed_s = (cur->time_ns - old->time_ns) / 1e9;
+
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		struct status_category* sc = &status->categories[cat];
+		sc->events = cur->events[cat];
+		sc->events_per_sec =
+			elapsed_s > 0 ? (float)((cur->events[cat] - old->events[cat]) / elapsed_s) : 0;
+		status->events_total += sc->events;
+		status->events_per_sec += sc->events_per_sec;
+	}
+
+	rate_next = (rate_next + 1) % STATUS_RATE_SAMPLES;
+	if (rate_count < STATUS_RATE_SAMPLES) {
+		rate_count++;
+	}
+
+	ebpf_handler_get_network_bytes(&status->net_bytes_sent, &status->net_bytes_received);
+}
+
+// Fill the AI verdict and top processes
+static void status_collect_threat(struct ravn_status* status) {
+	struct ai_summary summary;
+	if (!status_engine || ai_engine_get_summary(status_engine, &summary) != 0) {
+		snprintf(status->threat_level_str, sizeof(status->threat_level_str), "UNKNOWN");
+		snprintf(status->threat_reason, sizeof(status->threat_reason),
+			 "AI engine unavailable");
+		return;
+	}
+
+	status->threat_score = summary.threat_score;
+	status->threat_level = status_threat_level(summary.threat_score);
+	memcpy(status->threat_level_str, summary.threat_level_str,
+	       sizeof(status->threat_level_str));
+	memcpy(status->threat_reason, summary.threat_reason, sizeof(status->threat_reason));
+	status->process_count = summary.process_count;
+	status->top_count = summary.top_count;
+	memcpy(status->top, summary.top, sizeof(status->top));
+}
+
+// Fill component health and the self-overhead metrics
+static void status_collect_health(struct ravn_status* status) {
+	struct health_report report;
+	if (health_get_report(&report) == 0) {
+		status->health_state = report.state;
+		for (int c = 0; c < HEALTH_COMPONENT_MAX; c++) {
+			const struct health_component_status* hc = &report.components[c];
+			struct status_component* sc = &status->components[c];
+			snprintf(sc->name, sizeof(sc->name), "%s", hc->name ? hc->name : "");
+			sc->state = hc->state;
+			sc->restarts = hc->restarts;
+			sc->age_ms = hc->age_ms;
+		}
+		for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+			status->categories[cat].ring_fill_pct = report.ring_fill_pct[cat];
+		}
+		status->queue_depth = report.queue_depth;
+		status->redis_rtt_us = report.redis_rtt_us;
+		status->ai_lag_ms = report.ai_lag_ms;
+	} else {
+		status->health_state = -1;
+		status->queue_depth = -1;
+	}
+
+	pthread_mutex_lock(&overhead_lock);
+	if (overhead_valid) {
+		status->kernel_pct = last_overhead.kernel_pct;
+		status->user_pct = last_overhead.user_pct;
+		status->process_pct = last_overhead.process_pct;
+	}
+	pthread_mutex_unlock(&overhead_lock);
+}
+
+// Write one snapshot under the seqlock and wake waiters if it changed
+static void status_publish(struct ravn_status* status) {
+	uint32_t seq = segment->seq;
+
+	// Odd sequence: readers that overlap this write retry
+	__atomic_store_n(&segment->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&segment->status, status, sizeof(*status));
+	__atomic_store_n(&segment->seq, seq + 2, __ATOMIC_RELEASE);
+
+	// Only the snapshot time differs: nothing for readers to redraw
+	uint64_t updated_ns = status->updated_ns, timestamp = status->timestamp;
+	status->updated_ns = last_published.updated_ns;
+	status->timestamp = last_published.timestamp;
+	int changed = memcmp(status, &last_published, sizeof(*status)) != 0;
+	status->updated_ns = updated_ns;
+	status->timestamp = timestamp;
+	last_published = *status;
+
+	if (changed) {
+		__atomic_add_fetch(&segment->change_seq, 1, __ATOMIC_RELEASE);
+		syscall(SYS_futex, &segment->change_seq, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+	}
+}
+
+// Sleep until the deadline or an early publication request
+static void status_sleep_until(const struct timespec* deadline) {
+	pthread_mutex_lock(&notify_lock);
+	while (!notify_pending && status_running) {
+		if (pthread_cond_timedwait(&notify_cond, &notify_lock, deadline) == ETIMEDOUT) {
+			break;
+		}
+	}
+	notify_pending = 0;
+	pthread_mutex_unlock(&notify_lock);
+}
+
+// Status thread
+static void* status_thread_func(void* arg) {
+	(void)arg;
+
+	prctl(PR_SET_NAME, "ravn-status", 0, 0, 0);
+	placement_apply(PLACEMENT_BACKGROUND);
+	LOG_INFO_MODULE("STATUS", "Status thread started, publishing to %s", STATUS_SHM_PATH);
+
+	struct ravn_status status;
+	struct timespec next;
+	clock_gettime(CLOCK_MONOTONIC, &next);
+
+	while (status_running) {
+		RAVN_TIME_START(snapshot);
+
+		memset(&status, 0, sizeof(status));
+		status.updated_ns = ravn_prof_now_ns();
+		status.timestamp = (uint64_t)time(NULL);
+		status.started = status_started;
+		status.daemon_pid = (int32_t)getpid();
+		status_collect_events(&status);
+		status_collect_threat(&status);
+		status_collect_health(&status);
+		status_publish(&status);
+
+		RAVN_TIME_END(snapshot, "STATUS", "status_snapshot");
+
+		// Absolute deadlines keep the period fixed regardless of collection
+		// time; an early publication does not move the next periodic one
+		uint64_t now = ravn_prof_now_ns();
+		uint64_t deadline = (uint64_t)next.tv_sec * 1000000000ULL + (uint64_t)next.tv_nsec;
+		if (now >= deadline) {
+			deadline += STATUS_INTERVAL_MS * 1000000ULL;
+			if (deadline <= now) {
+				deadline = now + STATUS_INTERVAL_MS * 1000000ULL;
+			}
+			next.tv_sec = (time_t)(deadline / 1000000000ULL);
+			next.tv_nsec = (long)(deadline % 1000000000ULL);
+		}
+		status_sleep_until(&next);
+	}
+
+	LOG_INFO_MODULE("STATUS", "Status thread stopped");
+	return NULL;
+}
+
+// Create the status segment and start the status thread
+int status_init(ai_engine_t* engine) {
+	if (status_running) {
+		return 0;
+	}
+
+	// A fresh inode: readers of a previous daemon's segment see it go stale
+	unlink(STATUS_SHM_PATH);
+	int fd = open(STATUS_SHM_PATH, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, STATUS_SHM_MODE);
+	if (fd < 0) {
+		LOG_ERROR_MODULE("STATUS", "Failed to create %s: %s", STATUS_SHM_PATH,
+				 strerror(errno));
+		return -1;
+	}
+
+	// Threat reasons and top processes are as private as the control socket
+	if (fchown(fd, (uid_t)-1, 0) != 0 || fchmod(fd, STATUS_SHM_MODE) != 0) {
+		LOG_ERROR_MODULE("STATUS", "Failed to restrict %s: %s", STATUS_SHM_PATH,
+				 strerror(errno));
+		close(fd);
+		unlink(STATUS_SHM_PATH);
+		return -1;
+	}
+	if (ftruncate(fd, sizeof(struct status_segment)) != 0) {
+		LOG_ERROR_MODULE("STATUS", "Failed to size %s: %s", STATUS_SHM_PATH,
+				 strerror(errno));
+		close(fd);
+		unlink(STATUS_SHM_PATH);
+		return -1;
+	}
+
+	void* map = mmap(NULL, sizeof(struct status_segment), PROT_READ | PROT_WRITE, MAP_SHARED,
+			 fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		LOG_ERROR_MODULE("STATUS", "Failed to map %s: %s", STATUS_SHM_PATH,
+				 strerror(errno));
+		unlink(STATUS_SHM_PATH);
+		return -1;
+	}
+
+	segment = (struct status_segment*)map;
+	segment->version = STATUS_VERSION;
+	segment->size = sizeof(struct status_segment);
+	segment->seq = 0;
+
+	status_engine = engine;
+	status_started = (uint64_t)time(NULL);
+	rate_next = 0;
+	rate_count = 0;
+	memset(&last_published, 0, sizeof(last_published));
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&notify_cond, &attr);
+	pthread_condattr_destroy(&attr);
+	notify_pending = 0;
+
+	// Readers only trust the layout once the magic is visible
+	__atomic_store_n(&segment->magic, STATUS_MAGIC, __ATOMIC_RELEASE);
+
+	status_running = 1;
+	if (pthread_create(&status_thread, NULL, status_thread_func, NULL) != 0) {
+		status_running = 0;
+		pthread_cond_destroy(&notify_cond);
+		LOG_ERROR_MODULE("STATUS", "Failed to create status thread");
+		munmap(segment, sizeof(struct status_segment));
+		segment = NULL;
+		unlink(STATUS_SHM_PATH);
+		return -1;
+	}
+
+	return 0;
+}
+
+// Stop the status thread and remove the segment
+void status_cleanup(void) {
+	if (!status_running) {
+		return;
+	}
+
+	pthread_mutex_lock(&notify_lock);
+	status_running = 0;
+	pthread_cond_signal(&notify_cond);
+	pthread_mutex_unlock(&notify_lock);
+	pthread_join(status_thread, NULL);
+	pthread_cond_destroy(&notify_cond);
+
+	// Readers still mapping the segment drop it on their next read
+	__atomic_store_n(&segment->magic, 0, __ATOMIC_RELEASE);
+	munmap(segment, sizeof(struct status_segment));
+	segment = NULL;
+	status_engine = NULL;
+	unlink(STATUS_SHM_PATH);
+}
+
+// Hand the latest overhead report to the status thread
+void status_set_overhead(const struct overhead_report* report) {
+	if (!report) {
+		return;
+	}
+
+	pthread_mutex_lock(&overhead_lock);
+	last_overhead = *report;
+	overhead_valid = 1;
+	pthread_mutex_unlock(&overhead_lock);
+}
+
+// Publish a snapshot now instead of at the next period
+void status_notify(void) {
+	pthread_mutex_lock(&notify_lock);
+	if (status_running) {
+		notify_pending = 1;
+		pthread_cond_signal(&notify_cond);
+	}
+	pthread_mutex_unlock(&notify_lock);
+}
+
+// Map the status segment read-only
+int status_reader_open(struct status_reader* reader) {
+	if (!reader) {
+		return -1;
+	}
+	reader->segment = NULL;
+
+	int fd = open(STATUS_SHM_PATH, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct status_segment)) {
+		close(fd);
+		return -1;
+	}
+
+	void* map = mmap(NULL, sizeof(struct status_segment), PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return -1;
+	}
+
+	const struct status_segment* seg = (const struct status_segment*)map;
+	if (__atomic_load_n(&seg->magic, __ATOMIC_ACQUIRE) != STATUS_MAGIC ||
+	    seg->version != STATUS_VERSION || seg->size != sizeof(struct status_segment)) {
+		munmap(map, sizeof(struct status_segment));
+		return -1;
+	}
+
+	reader->segment = seg;
+	return 0;
+}
+
+// Unmap the status segment
+void status_reader_close(struct status_reader* reader) {
+	if (!reader || !reader->segment) {
+		return;
+	}
+	munmap((void*)reader->segment, sizeof(struct status_segment));
+	reader->segment = NULL;
+}
+
+// Copy a consistent snapshot
+int status_read(struct status_reader* reader, struct ravn_status* status) {
+	if (!reader || !status) {
+		return -1;
+	}
+	if (!reader->segment && status_reader_open(reader) != 0) {
+		return -1;
+	}
+
+	const struct status_segment* seg = reader->segment;
+	for (int attempt = 0; attempt < STATUS_READ_RETRIES; attempt++) {
+		uint32_t seq = __atomic_load_n(&seg->seq, __ATOMIC_ACQUIRE);
+		if (seq & 1) {
+			continue; // Write in progress
+		}
+
+		memcpy(status, &seg->status, sizeof(*status));
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&seg->seq, __ATOMIC_RELAXED) != seq) {
+			continue;
+		}
+
+		// Never written, or left behind by a daemon that stopped
+		if (seq == 0 || __atomic_load_n(&seg->magic, __ATOMIC_RELAXED) != STATUS_MAGIC ||
+		    ravn_prof_now_ns() - status->updated_ns > STATUS_STALE_MS * 1000000ULL) {
+			status_reader_close(reader);
+			return -1;
+		}
+		return 0;
+	}
+
+	return -1;
+}
+
+// Block until the daemon publishes a changed snapshot
+int status_wait(struct status_reader* reader, uint32_t* change, int timeout_ms) {
+	if (!reader || !change) {
+		return -1;
+	}
+	if (!reader->segment && status_reader_open(reader) != 0) {
+		return -1;
+	}
+
+	const uint32_t* word = &reader->segment->change_seq;
+	uint32_t seen = __atomic_load_n(word, __ATOMIC_ACQUIRE);
+	if (seen == *change) {
+		struct timespec timeout = {timeout_ms / 1000, (timeout_ms % 1000) * 1000000L};
+		syscall(SYS_futex, word, FUTEX_WAIT, seen, &timeout, NULL, 0);
+		seen = __atomic_load_n(word, __ATOMIC_ACQUIRE);
+	}
+
+	if (seen == *change) {
+		return 0;
+	}
+	*change = seen;
+	return 1;
+}
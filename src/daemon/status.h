@@ -0,0 +1,242 @@
+/*
+ * RAVN Status Segment - Header File
+ *
+ * This header defines the shared-memory status segment of the RAVN security
+ * platform, through which the daemon exposes its live state to local
+ * readers (the CLI dashboard and any other process on the host) without
+ * Redis round trips.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The status segment implements:
+ * - A fixed-layout snapshot in /dev/shm/ravn-status
+ * - Threat level, reason and the highest scoring processes
+ * - Cumulative event counts and rates per event category
+ * - Component health, queue depth, Redis RTT and AI lag
+ * - Self-overhead metrics from the daemon main loop
+ * - Seqlock-protected writes and lock-free reads
+ * - Change notification through a futex word in the segment
+ *
+ * Architecture:
+ * - A dedicated status thread rewrites the snapshot every STATUS_INTERVAL_MS
+ * - The writer bumps the sequence to odd, writes, then bumps it to even;
+ *   readers copy the snapshot and retry if the sequence moved
+ * - Readers map the segment read-only and never block the writer
+ * - The change counter only moves when the snapshot content changes, so
+ *   readers blocked in status_wait() wake for changes, not for every write
+ * - status_notify() makes the writer publish immediately, e.g. when the
+ *   threat level changes between two periodic snapshots
+ * - A reader treats a snapshot older than STATUS_STALE_MS as a stopped daemon
+ */
+
+#ifndef RAVN_STATUS_H
+#define RAVN_STATUS_H
+
+#include <stdint.h>
+
+#include "ai_engine.h"
+#include "health.h"
+#include "overhead.h"
+
+/*
+ * Status Segment Configuration Parameters
+ */
+#define STATUS_SHM_PATH	      "/dev/shm/ravn-status" /* Segment file */
+#define STATUS_SHM_MODE	      0640		     /* Root and the root group only */
+#define STATUS_MAGIC	      0x544154534E564152ULL  /* "RAVNSTAT" */
+#define STATUS_VERSION	      1			     /* Layout version */
+#define STATUS_INTERVAL_MS    100		     /* Snapshot period */
+#define STATUS_RATE_WINDOW_MS 1000		     /* Event rate window */
+#define STATUS_STALE_MS	      3000		     /* Snapshot age treated as stopped */
+#define STATUS_READ_RETRIES   64		     /* Seqlock read attempts */
+
+/**
+ * struct status_category - Event counters of one category
+ * @events: Events handled (cumulative)
+ * @events_per_sec: Event rate over the last STATUS_RATE_WINDOW_MS
+ * @ring_fill_pct: Ring buffer fill level
+ */
+struct status_category {
+	uint64_t events;	/* Events handled */
+	float events_per_sec;	/* Event rate */
+	float ring_fill_pct;	/* Ring fill */
+};
+
+/**
+ * struct status_component - Health of one daemon component
+ * @name: Component name
+ * @state: enum health_state
+ * @restarts: Restart attempts since the component was last healthy
+ * @age_ms: Time since the last heartbeat
+ */
+struct status_component {
+	char name[16];		/* Component name */
+	int32_t state;		/* enum health_state */
+	uint32_t restarts;	/* Restart attempts */
+	uint64_t age_ms;	/* Last heartbeat age */
+};
+
+/**
+ * struct ravn_status - Daemon state snapshot
+ * @updated_ns: CLOCK_MONOTONIC time of the snapshot
+ * @timestamp: Snapshot time (seconds since epoch)
+ * @started: Daemon start time (seconds since epoch)
+ * @daemon_pid: Daemon process ID
+ * @threat_score: Overall threat score of the AI window
+ * @threat_level: Threat level (THREAT_LOW .. THREAT_CRITICAL)
+ * @threat_level_str: Human-readable threat level
+ * @threat_reason: Explanation of the threat assessment
+ * @process_count: Processes tracked by the AI window
+ * @top_count: Valid entries in @top
+ * @top: Highest scoring processes, highest first
+ * @categories: Counters indexed by event category
+ * @events_total: Events handled by all categories
+ * @events_per_sec: Event rate of all categories
+ * @net_bytes_sent: Bytes sent by all network events
+ * @net_bytes_received: Bytes received by all network events
+ * @health_state: Worst component state, -1 before the first evaluation
+ * @components: Per-component health
+ * @queue_depth: Length of the events:raw queue, -1 if unknown
+ * @redis_rtt_us: Redis PING round-trip time, 0 if unreachable
+ * @ai_lag_ms: Time since the AI thread last completed a tick
+ * @kernel_pct: BPF run time as % of host CPU
+ * @user_pct: Event handler time as % of host CPU
+ * @process_pct: Daemon process CPU as % of host CPU
+ */
+struct ravn_status {
+	uint64_t updated_ns;						/* Snapshot time */
+	uint64_t timestamp;						/* Wall time */
+	uint64_t started;						/* Daemon start */
+	int32_t daemon_pid;						/* Daemon PID */
+
+	float threat_score;						/* Window score */
+	int32_t threat_level;						/* Threat level */
+	char threat_level_str[16];					/* Level string */
+	char threat_reason[256];					/* Threat reason */
+	int32_t process_count;						/* Tracked */
+	int32_t top_count;						/* Valid top */
+	struct ai_process_summary top[AI_SUMMARY_TOP];			/* Top processes */
+
+	struct status_category categories[EVENT_CATEGORY_MAX + 1];	/* Per category */
+	uint64_t events_total;						/* All events */
+	float events_per_sec;						/* All rates */
+	uint64_t net_bytes_sent;					/* Bytes sent */
+	uint64_t net_bytes_received;					/* Bytes received */
+
+	int32_t health_state;						/* Overall health */
+	struct status_component components[HEALTH_COMPONENT_MAX];	/* Components */
+	int64_t queue_depth;						/* events:raw */
+	uint64_t redis_rtt_us;						/* PING RTT */
+	uint64_t ai_lag_ms;						/* AI tick lag */
+
+	double kernel_pct;						/* BPF share */
+	double user_pct;						/* Handler share */
+	double process_pct;						/* Daemon share */
+};
+
+/**
+ * struct status_segment - Layout of the shared-memory segment
+ * @magic: STATUS_MAGIC, written last when the segment is created and
+ *	   cleared when the daemon stops
+ * @version: STATUS_VERSION
+ * @size: sizeof(struct status_segment)
+ * @seq: Seqlock sequence, odd while a snapshot is being written
+ * @change_seq: Incremented (and futex-woken) when the snapshot content changes
+ * @status: Current snapshot
+ */
+struct status_segment {
+	uint64_t magic;		   /* Segment magic */
+	uint32_t version;	   /* Layout version */
+	uint32_t size;		   /* Segment size */
+	uint32_t seq;		   /* Seqlock sequence */
+	uint32_t change_seq;	   /* Change counter (futex word) */
+	struct ravn_status status; /* Snapshot */
+};
+
+/**
+ * struct status_reader - Read-only mapping of the status segment
+ * @segment: Mapped segment, NULL when closed (zero-initialize before use)
+ */
+struct status_reader {
+	const struct status_segment* segment; /* Mapping */
+};
+
+/*
+ * Status Writer Functions
+ */
+
+/**
+ * status_init - Create the status segment and start the status thread
+ * @engine: AI engine whose verdict is published (may be NULL)
+ *
+ * Replaces any segment left by a previous daemon, so readers that still
+ * map the old one see it go stale and reopen.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int status_init(ai_engine_t* engine);
+
+/**
+ * status_cleanup - Stop the status thread and remove the segment
+ */
+void status_cleanup(void);
+
+/**
+ * status_set_overhead - Hand the latest overhead report to the status thread
+ * @report: Report from overhead_sample()
+ *
+ * Called from the daemon main loop; the values appear in the next snapshot.
+ */
+void status_set_overhead(const struct overhead_report* report);
+
+/**
+ * status_notify - Publish a snapshot now instead of at the next period
+ *
+ * Safe to call from any thread, and before status_init() (no effect).
+ */
+void status_notify(void);
+
+/*
+ * Status Reader Functions
+ */
+
+/**
+ * status_reader_open - Map the status segment read-only
+ * @reader: Reader to initialize
+ *
+ * Return: 0 on success, -1 if no daemon has published a segment
+ */
+int status_reader_open(struct status_reader* reader);
+
+/**
+ * status_reader_close - Unmap the status segment
+ * @reader: Reader to close
+ */
+void status_reader_close(struct status_reader* reader);
+
+/**
+ * status_read - Copy a consistent snapshot
+ * @reader: Reader, opened on demand and reopened after a daemon restart
+ * @status: Snapshot structure to populate
+ *
+ * Reads from the mapping only; no system calls are made while the segment
+ * stays current.
+ *
+ * Return: 0 on success, -1 if no current snapshot is available
+ */
+int status_read(struct status_reader* reader, struct ravn_status* status);
+
+/**
+ * status_wait - Block until the daemon publishes a changed snapshot
+ * @reader: Reader, opened on demand
+ * @change: Last change counter seen by the caller; updated on return
+ * @timeout_ms: Longest time to block
+ *
+ * Return: 1 if the snapshot changed, 0 on timeout or signal, -1 if no
+ * segment is available (the caller has to poll instead)
+ */
+int status_wait(struct status_reader* reader, uint32_t* change, int timeout_ms);
+
+#endif // RAVN_STATUS_H
@@ -0,0 +1,1216 @@
+// RAVN Event Store Implementation
+// Time-partitioned columnar segment files written by a background thread
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "store.h"
+
+#include "codec.h"
+#include "placement.h"
+#include "../utils/error_handling.h"
+#include "../utils/hotmem.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Bytes of column data per event (ts, pid, uid, type, comm, path, host, category)
+#define STORE_COLUMN_BYTES (8 + 4 + 4 + 4 + 4 + 4 + 4 + 1)
+
+// Round up to the 8-byte block alignment
+#define STORE_ALIGN8(x) (((x) + 7) & ~(uint64_t)7)
+
+// Bytes of the column size table of a packed block
+#define STORE_PACKED_TABLE STORE_ALIGN8(sizeof(uint32_t) * STORE_COLUMNS)
+
+// Bytes per value of each plain column
+static const uint8_t column_width[STORE_COLUMNS] = {8, 4, 4, 4, 4, 4, 4, 1};
+
+// Raw events of one block, filled by store_append()
+struct store_stage {
+	uint32_t count;					/* Events staged */
+	uint32_t strings_used;				/* Bytes of @strings used */
+	uint64_t partition;				/* Time partition of the events */
+	uint64_t opened_ns;				/* Monotonic time of the first event */
+	uint64_t ts[STORE_BLOCK_EVENTS];		/* Wall-clock timestamps */
+	uint32_t pid[STORE_BLOCK_EVENTS];		/* Process IDs */
+	uint32_t uid[STORE_BLOCK_EVENTS];		/* User IDs */
+	uint32_t type[STORE_BLOCK_EVENTS];		/* Event types */
+	uint8_t category[STORE_BLOCK_EVENTS];		/* Event categories */
+	char comm[STORE_BLOCK_EVENTS][16];		/* Process names */
+	uint32_t path_off[STORE_BLOCK_EVENTS];		/* Path offsets in @strings */
+	uint16_t path_len[STORE_BLOCK_EVENTS];		/* Path lengths, 0 if none */
+	uint32_t host_off[STORE_BLOCK_EVENTS];		/* Host offsets in @strings */
+	uint8_t host_len[STORE_BLOCK_EVENTS];		/* Host lengths, 0 for this host */
+	char strings[STORE_BLOCK_STRINGS];		/* Path and host bytes */
+};
+
+// String dictionary of the open segment (writer thread only)
+struct store_dict {
+	char* arena;		/* String bytes */
+	size_t arena_used;	/* Bytes used */
+	size_t arena_size;	/* Bytes allocated */
+	uint32_t* offset;	/* Arena offset by ID */
+	uint16_t* length;	/* String length by ID */
+	uint32_t entries;	/* IDs assigned, including 0 */
+	uint32_t* table;	/* Open-addressing table of IDs, 0 if free */
+	uint32_t table_size;	/* Slots, a power of two */
+};
+
+// Appender state, protected by store_lock
+static pthread_mutex_t store_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t store_cond;
+static struct store_stage* active_stage = NULL;
+static struct store_stage* sealed[STORE_STAGES];	/* FIFO of stages to write */
+static int sealed_head = 0;
+static int sealed_count = 0;
+static struct store_stage* spare[STORE_STAGES];	/* Free stages */
+static int spare_count = 0;
+static int store_active = 0;
+static int store_running = 0;
+static uint64_t wall_offset_ns = 0;
+static pthread_t store_thread;
+
+// Writer state, only touched by the writer thread after store_open()
+static char store_dir[PATH_MAX];
+static uint32_t store_retention_days = 0;
+static int seg_fd = -1;
+static uint64_t seg_partition = 0;
+static uint32_t seg_sequence = 0;
+static uint64_t seg_size = 0;
+static uint64_t seg_events = 0;
+static uint64_t seg_min_ts = 0;
+static uint64_t seg_max_ts = 0;
+static struct store_index_entry* seg_index = NULL;
+static uint32_t seg_blocks = 0;
+static uint32_t seg_index_size = 0;
+static struct store_dict dict;
+static uint8_t* out_buf = NULL;
+static size_t out_size = 0;
+
+// Counters
+static struct store_stats stats;
+
+// Wall-clock time in nanoseconds
+static uint64_t store_realtime_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Write a whole buffer, retrying on short writes
+static int write_all(int fd, const void* buf, size_t len) {
+	const uint8_t* p = buf;
+	while (len > 0) {
+		ssize_t n = write(fd, p, len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		p += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+// FNV-1a hash of a dictionary string
+static uint32_t dict_hash(const char* s, uint16_t len) {
+	uint32_t h = 2166136261u;
+	for (uint16_t i = 0; i < len; i++) {
+		h ^= (unsigned char)s[i];
+		h *= 16777619u;
+	}
+	return h;
+}
+
+// Empty the dictionary for a new segment, keeping its allocations
+static int dict_reset(void) {
+	if (!dict.table) {
+		dict.table_size = 4096;
+		dict.table = calloc(dict.table_size, sizeof(*dict.table));
+		dict.offset = malloc(sizeof(*dict.offset) * (STORE_MAX_DICT_ENTRIES + 1));
+		dict.length = malloc(sizeof(*dict.length) * (STORE_MAX_DICT_ENTRIES + 1));
+		dict.arena_size = 1u << 20;
+		dict.arena = malloc(dict.arena_size);
+		if (!dict.table || !dict.offset || !dict.length || !dict.arena) {
+			return -1;
+		}
+	} else {
+		memset(dict.table, 0, sizeof(*dict.table) * dict.table_size);
+	}
+
+	// ID 0 is the empty string
+	dict.offset[0] = 0;
+	dict.length[0] = 0;
+	dict.entries = 1;
+	dict.arena_used = 0;
+	return 0;
+}
+
+// Double the dictionary hash table
+static int dict_grow(void) {
+	uint32_t size = dict.table_size * 2;
+	uint32_t* table = calloc(size, sizeof(*table));
+	if (!table) {
+		return -1;
+	}
+	for (uint32_t id = 1; id < dict.entries; id++) {
+		uint32_t slot = dict_hash(dict.arena + dict.offset[id], dict.length[id]) & (size - 1);
+		while (table[slot]) {
+			slot = (slot + 1) & (size - 1);
+		}
+		table[slot] = id;
+	}
+	free(dict.table);
+	dict.table = table;
+	dict.table_size = size;
+	return 0;
+}
+
+// Look a string up, adding it (and its delta record) when new; 0 on failure
+static uint32_t dict_encode(const char* s, uint16_t len, uint8_t** delta, uint32_t* added) {
+	if (len == 0) {
+		return 0;
+	}
+
+	uint32_t slot = dict_hash(s, len) & (dict.table_size - 1);
+	for (uint32_t id; (id = dict.table[slot]); slot = (slot + 1) & (dict.table_size - 1)) {
+		if (dict.length[id] == len && memcmp(dict.arena + dict.offset[id], s, len) == 0) {
+			return id;
+		}
+	}
+
+	if (dict.entries > STORE_MAX_DICT_ENTRIES) {
+		return 0;
+	}
+	if (dict.arena_used + len > dict.arena_size) {
+		size_t size = dict.arena_size * 2 + len;
+		char* arena = realloc(dict.arena, size);
+		if (!arena) {
+			return 0;
+		}
+		dict.arena = arena;
+		dict.arena_size = size;
+	}
+
+	uint32_t id = dict.entries++;
+	memcpy(dict.arena + dict.arena_used, s, len);
+	dict.offset[id] = (uint32_t)dict.arena_used;
+	dict.length[id] = len;
+	dict.arena_used += len;
+	dict.table[slot] = id;
+	if (dict.entries * 2 > dict.table_size) {
+		dict_grow();
+	}
+
+	// Delta record: uint16_t length, then the bytes
+	memcpy(*delta, &len, sizeof(len));
+	memcpy(*delta + sizeof(len), s, len);
+	*delta += sizeof(len) + len;
+	(*added)++;
+	return id;
+}
+
+// Delete segments older than the retention period
+static void store_apply_retention(void) {
+	if (store_retention_days == 0) {
+		return;
+	}
+
+	DIR* dir = opendir(store_dir);
+	if (!dir) {
+		return;
+	}
+
+	time_t cutoff = time(NULL) - (time_t)store_retention_days * 86400;
+	size_t suffix_len = strlen(STORE_FILE_SUFFIX);
+	struct dirent* entry;
+	while ((entry = readdir(dir))) {
+		size_t len = strlen(entry->d_name);
+		if (len <= suffix_len ||
+		    strcmp(entry->d_name + len - suffix_len, STORE_FILE_SUFFIX) != 0) {
+			continue;
+		}
+
+		char path[PATH_MAX + 256];
+		struct stat st;
+		snprintf(path, sizeof(path), "%s/%s", store_dir, entry->d_name);
+		if (stat(path, &st) == 0 && st.st_mtime < cutoff && unlink(path) == 0) {
+			LOG_INFO_MODULE("STORE", "Retention: removed %s", entry->d_name);
+		}
+	}
+	closedir(dir);
+}
+
+// Finish the open segment: index, footer, sync, drop from the page cache
+static void store_close_segment(void) {
+	if (seg_fd < 0) {
+		return;
+	}
+
+	struct store_footer footer;
+	memset(&footer, 0, sizeof(footer));
+	footer.index_offset = seg_size;
+	footer.blocks = seg_blocks;
+	footer.dict_entries = dict.entries;
+	footer.events = seg_events;
+	footer.min_ts = seg_min_ts;
+	footer.max_ts = seg_max_ts;
+	memcpy(footer.magic, STORE_FOOTER_MAGIC, sizeof(footer.magic));
+
+	if (write_all(seg_fd, seg_index, sizeof(*seg_index) * seg_blocks) != 0 ||
+	    write_all(seg_fd, &footer, sizeof(footer)) != 0) {
+		LOG_ERROR_MODULE("STORE", "Failed to write segment index: %s", strerror(errno));
+	}
+
+	// Finished segments are cold: keep them out of the page cache
+	fdatasync(seg_fd);
+	posix_fadvise(seg_fd, 0, 0, POSIX_FADV_DONTNEED);
+	close(seg_fd);
+	seg_fd = -1;
+}
+
+// Create the next segment file of a time partition
+static int store_open_segment(uint64_t partition) {
+	time_t start = (time_t)(partition * STORE_PARTITION_NS / 1000000000ULL);
+	struct tm tm;
+	char name[32];
+	char path[sizeof(store_dir) + 48];
+
+	gmtime_r(&start, &tm);
+	strftime(name, sizeof(name), "%Y%m%d-%H%M%S", &tm);
+
+	// Later splits of the same partition (or a restart) get -1, -2, ...
+	uint32_t sequence = partition == seg_partition ? seg_sequence + 1 : 0;
+	int fd = -1;
+	for (; sequence < 10000; sequence++) {
+		if (sequence == 0) {
+			snprintf(path, sizeof(path), "%s/%s%s", store_dir, name, STORE_FILE_SUFFIX);
+		} else {
+			snprintf(path, sizeof(path), "%s/%s-%u%s", store_dir, name, sequence,
+				 STORE_FILE_SUFFIX);
+		}
+		fd = open(path, O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0640);
+		if (fd >= 0 || errno != EEXIST) {
+			break;
+		}
+	}
+	if (fd < 0) {
+		LOG_ERROR_MODULE("STORE", "Failed to create segment %s: %s", path, strerror(errno));
+		return -1;
+	}
+
+	struct store_file_header hdr;
+	memset(&hdr, 0, sizeof(hdr));
+	memcpy(hdr.magic, STORE_MAGIC, sizeof(hdr.magic));
+	hdr.version = STORE_VERSION;
+	hdr.header_size = sizeof(hdr);
+	hdr.partition_start_ns = partition * STORE_PARTITION_NS;
+	hdr.partition_ns = STORE_PARTITION_NS;
+	hdr.created_ns = store_realtime_ns();
+	hdr.sequence = sequence;
+	hdr.block_events = STORE_BLOCK_EVENTS;
+	if (write_all(fd, &hdr, sizeof(hdr)) != 0 || dict_reset() != 0) {
+		LOG_ERROR_MODULE("STORE", "Failed to initialize segment %s", path);
+		close(fd);
+		unlink(path);
+		return -1;
+	}
+
+	seg_fd = fd;
+	seg_partition = partition;
+	seg_sequence = sequence;
+	seg_size = sizeof(hdr);
+	seg_events = 0;
+	seg_blocks = 0;
+	seg_min_ts = UINT64_MAX;
+	seg_max_ts = 0;
+	__atomic_fetch_add(&stats.segments, 1, __ATOMIC_RELAXED);
+	LOG_INFO_MODULE("STORE", "Writing segment %s", path);
+
+	store_apply_retention();
+	return 0;
+}
+
+// Encode one staged block and append it to the right segment
+static void store_write_block(const struct store_stage* stage) {
+	RAVN_TIME_START(block);
+
+	// Start a new segment on a new partition, at the size limit, or when
+	// the dictionary could overflow with this block's strings
+	uint64_t worst = sizeof(struct store_block_header) + STORE_BLOCK_STRINGS +
+			 (uint64_t)stage->count * (STORE_COLUMN_BYTES + 3 * sizeof(uint16_t) + 16);
+	if (seg_fd >= 0 &&
+	    (stage->partition != seg_partition || seg_size + worst > STORE_MAX_SEGMENT_SIZE ||
+	     dict.entries + 3 * stage->count > STORE_MAX_DICT_ENTRIES)) {
+		store_close_segment();
+	}
+	if (seg_fd < 0 && store_open_segment(stage->partition) != 0) {
+		__atomic_fetch_add(&stats.dropped, stage->count, __ATOMIC_RELAXED);
+		return;
+	}
+
+	uint32_t n = stage->count;
+	struct store_block_header* bh = (struct store_block_header*)out_buf;
+	uint8_t* delta = out_buf + sizeof(*bh);
+	uint32_t added = 0;
+	uint32_t comm_ids[STORE_BLOCK_EVENTS];
+	uint32_t path_ids[STORE_BLOCK_EVENTS];
+	uint32_t host_ids[STORE_BLOCK_EVENTS];
+
+	memset(bh, 0, sizeof(*bh));
+	bh->magic = STORE_BLOCK_MAGIC;
+	bh->events = n;
+	bh->min_ts = UINT64_MAX;
+	bh->min_pid = UINT32_MAX;
+
+	// Dictionary-encode the strings, collecting new entries in the delta
+	for (uint32_t i = 0; i < n; i++) {
+		const char* comm = stage->comm[i];
+		comm_ids[i] = dict_encode(comm, (uint16_t)strnlen(comm, sizeof(stage->comm[i])),
+					  &delta, &added);
+		path_ids[i] = dict_encode(stage->strings + stage->path_off[i], stage->path_len[i],
+					  &delta, &added);
+		host_ids[i] = dict_encode(stage->strings + stage->host_off[i], stage->host_len[i],
+					  &delta, &added);
+
+		bh->categories |= 1u << (stage->category[i] & 31);
+		bh->min_ts = stage->ts[i] < bh->min_ts ? stage->ts[i] : bh->min_ts;
+		bh->max_ts = stage->ts[i] > bh->max_ts ? stage->ts[i] : bh->max_ts;
+		bh->min_pid = stage->pid[i] < bh->min_pid ? stage->pid[i] : bh->min_pid;
+		bh->max_pid = stage->pid[i] > bh->max_pid ? stage->pid[i] : bh->max_pid;
+	}
+
+	size_t delta_bytes = (size_t)(delta - (out_buf + sizeof(*bh)));
+	bh->dict_entries = added;
+	bh->dict_bytes = (uint32_t)STORE_ALIGN8(delta_bytes);
+	memset(delta, 0, bh->dict_bytes - delta_bytes);
+
+	// Columns, each contiguous
+	uint8_t* col = out_buf + sizeof(*bh) + bh->dict_bytes;
+	memcpy(col, stage->ts, n * sizeof(uint64_t));
+	col += n * sizeof(uint64_t);
+	memcpy(col, stage->pid, n * sizeof(uint32_t));
+	col += n * sizeof(uint32_t);
+	memcpy(col, stage->uid, n * sizeof(uint32_t));
+	col += n * sizeof(uint32_t);
+	memcpy(col, stage->type, n * sizeof(uint32_t));
+	col += n * sizeof(uint32_t);
+	memcpy(col, comm_ids, n * sizeof(uint32_t));
+	col += n * sizeof(uint32_t);
+	memcpy(col, path_ids, n * sizeof(uint32_t));
+	col += n * sizeof(uint32_t);
+	memcpy(col, host_ids, n * sizeof(uint32_t));
+	col += n * sizeof(uint32_t);
+	memcpy(col, stage->category, n);
+	col += n;
+
+	size_t size = STORE_ALIGN8((size_t)(col - out_buf));
+	memset(col, 0, size - (size_t)(col - out_buf));
+	bh->size = (uint32_t)size;
+
+	// Index entry for the footer
+	if (seg_blocks == seg_index_size) {
+		uint32_t grown = seg_index_size ? seg_index_size * 2 : 1024;
+		struct store_index_entry* index = realloc(seg_index, sizeof(*index) * grown);
+		if (!index) {
+			__atomic_fetch_add(&stats.dropped, n, __ATOMIC_RELAXED);
+			return;
+		}
+		seg_index = index;
+		seg_index_size = grown;
+	}
+
+	// One sequential write per block
+	if (write_all(seg_fd, out_buf, size) != 0) {
+		LOG_ERROR_MODULE("STORE", "Failed to write block: %s", strerror(errno));
+		__atomic_fetch_add(&stats.dropped, n, __ATOMIC_RELAXED);
+		close(seg_fd); // A partial block ends the segment; readers stop before it
+		seg_fd = -1;
+		return;
+	}
+
+	struct store_index_entry* entry = &seg_index[seg_blocks++];
+	entry->offset = seg_size;
+	entry->min_ts = bh->min_ts;
+	entry->max_ts = bh->max_ts;
+	entry->events = n;
+	entry->categories = bh->categories;
+	entry->min_pid = bh->min_pid;
+	entry->max_pid = bh->max_pid;
+
+	seg_size += size;
+	seg_events += n;
+	seg_min_ts = bh->min_ts < seg_min_ts ? bh->min_ts : seg_min_ts;
+	seg_max_ts = bh->max_ts > seg_max_ts ? bh->max_ts : seg_max_ts;
+	__atomic_fetch_add(&stats.blocks, 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&stats.bytes, size, __ATOMIC_RELAXED);
+
+	RAVN_TIME_END(block, "STORE", "store_write_block");
+}
+
+// Hand the active stage to the writer; caller holds store_lock
+static int store_seal_locked(void) {
+	if (spare_count == 0) {
+		return -1;
+	}
+	sealed[(sealed_head + sealed_count) % STORE_STAGES] = active_stage;
+	sealed_count++;
+	active_stage = spare[--spare_count];
+	active_stage->count = 0;
+	active_stage->strings_used = 0;
+	pthread_cond_signal(&store_cond);
+	return 0;
+}
+
+// Writer thread: encode and write sealed stages, flush partial ones on time
+static void* store_thread_func(void* arg) {
+	(void)arg;
+	prctl(PR_SET_NAME, "ravn-store", 0, 0, 0);
+	placement_apply(PLACEMENT_BACKGROUND);
+
+	pthread_mutex_lock(&store_lock);
+	for (;;) {
+		while (sealed_count == 0 && store_running) {
+			// Seal a partial block once its first event is old enough
+			uint64_t now = ravn_prof_now_ns();
+			uint64_t due = active_stage->opened_ns +
+				       (uint64_t)STORE_FLUSH_INTERVAL_MS * 1000000ULL;
+			if (active_stage->count && now >= due && store_seal_locked() == 0) {
+				break;
+			}
+
+			uint64_t wake = active_stage->count && now < due
+						? due
+						: now + (uint64_t)STORE_FLUSH_INTERVAL_MS * 1000000ULL;
+			struct timespec deadline = {(time_t)(wake / 1000000000ULL),
+						    (long)(wake % 1000000000ULL)};
+			pthread_cond_timedwait(&store_cond, &store_lock, &deadline);
+		}
+
+		struct store_stage* stage;
+		if (sealed_count) {
+			stage = sealed[sealed_head];
+			sealed_head = (sealed_head + 1) % STORE_STAGES;
+			sealed_count--;
+		} else if (active_stage->count) {
+			// Stopping: appenders are gone, write what is left
+			stage = active_stage;
+			active_stage = NULL;
+		} else {
+			break;
+		}
+		pthread_mutex_unlock(&store_lock);
+
+		store_write_block(stage);
+
+		pthread_mutex_lock(&store_lock);
+		if (active_stage) {
+			spare[spare_count++] = stage;
+		} else {
+			active_stage = stage;
+			active_stage->count = 0;
+		}
+	}
+	pthread_mutex_unlock(&store_lock);
+
+	store_close_segment();
+	return NULL;
+}
+
+// Start storing events
+int store_open(const char* dir, uint32_t retention_days) {
+	if (!dir || store_active) {
+		return -1;
+	}
+
+	if (mkdir(dir, 0750) != 0 && errno != EEXIST) {
+		LOG_ERROR_MODULE("STORE", "Failed to create %s: %s", dir, strerror(errno));
+		return -1;
+	}
+	snprintf(store_dir, sizeof(store_dir), "%s", dir);
+	store_retention_days = retention_days;
+
+	// Largest encoded block: header, every string new, columns
+	out_size = sizeof(struct store_block_header) + STORE_BLOCK_STRINGS + 8 +
+		   STORE_BLOCK_EVENTS * (3 * sizeof(uint16_t) + 16 + STORE_COLUMN_BYTES) + 8;
+	out_buf = malloc(out_size);
+	// Staging blocks are written by the event path: keep them on huge pages
+	active_stage = hotmem_alloc(sizeof(*active_stage), "store-stage");
+	for (spare_count = 0; spare_count < STORE_STAGES - 1; spare_count++) {
+		spare[spare_count] = hotmem_alloc(sizeof(*spare[spare_count]), "store-stage");
+		if (!spare[spare_count]) {
+			break;
+		}
+	}
+	if (!out_buf || !active_stage || spare_count < STORE_STAGES - 1 || dict_reset() != 0) {
+		LOG_ERROR_MODULE("STORE", "Failed to allocate event store buffers");
+		store_close();
+		return -1;
+	}
+	active_stage->count = 0;
+	active_stage->strings_used = 0;
+	sealed_head = 0;
+	sealed_count = 0;
+
+	// Event timestamps are CLOCK_MONOTONIC; stored timestamps are wall clock
+	wall_offset_ns = store_realtime_ns() - ravn_prof_now_ns();
+	memset(&stats, 0, sizeof(stats));
+	seg_fd = -1;
+	seg_partition = UINT64_MAX;
+
+	pthread_condattr_t attr;
+	pthread_condattr_init(&attr);
+	pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+	pthread_cond_init(&store_cond, &attr);
+	pthread_condattr_destroy(&attr);
+
+	store_running = 1;
+	if (pthread_create(&store_thread, NULL, store_thread_func, NULL) != 0) {
+		store_running = 0;
+		LOG_ERROR_MODULE("STORE", "Failed to create store thread");
+		pthread_cond_destroy(&store_cond);
+		store_close();
+		return -1;
+	}
+
+	pthread_mutex_lock(&store_lock);
+	store_active = 1;
+	pthread_mutex_unlock(&store_lock);
+
+	store_apply_retention();
+	LOG_INFO_MODULE("STORE", "Storing events in %s (retention %u days)", dir, retention_days);
+	return 0;
+}
+
+// Append one decoded event
+void store_append(uint64_t timestamp, uint32_t pid, uint32_t uid, uint32_t type,
+		  uint32_t category, const char* comm, const char* path, const char* host) {
+	if (!__atomic_load_n(&store_active, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	uint64_t ts = timestamp + wall_offset_ns;
+	uint64_t partition = ts / STORE_PARTITION_NS;
+	size_t path_len = path ? strnlen(path, STORE_MAX_STRING) : 0;
+	size_t host_len = host ? strnlen(host, UINT8_MAX) : 0;
+
+	pthread_mutex_lock(&store_lock);
+	if (!store_active) {
+		pthread_mutex_unlock(&store_lock);
+		return;
+	}
+
+	struct store_stage* st = active_stage;
+	if (st->count &&
+	    (st->count == STORE_BLOCK_EVENTS || st->partition != partition ||
+	     st->strings_used + path_len + host_len > STORE_BLOCK_STRINGS) &&
+	    store_seal_locked() != 0) {
+		pthread_mutex_unlock(&store_lock);
+		__atomic_fetch_add(&stats.dropped, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	st = active_stage;
+	uint32_t i = st->count;
+	if (i == 0) {
+		st->partition = partition;
+		st->opened_ns = ravn_prof_now_ns();
+	}
+	st->ts[i] = ts;
+	st->pid[i] = pid;
+	st->uid[i] = uid;
+	st->type[i] = type;
+	st->category[i] = (uint8_t)category;
+	memset(st->comm[i], 0, sizeof(st->comm[i]));
+	if (comm) {
+		strncpy(st->comm[i], comm, sizeof(st->comm[i]));
+	}
+	st->path_off[i] = st->strings_used;
+	st->path_len[i] = (uint16_t)path_len;
+	if (path_len) {
+		memcpy(st->strings + st->strings_used, path, path_len);
+	}
+	st->strings_used += (uint32_t)path_len;
+	st->host_off[i] = st->strings_used;
+	st->host_len[i] = (uint8_t)host_len;
+	if (host_len) {
+		memcpy(st->strings + st->strings_used, host, host_len);
+	}
+	st->strings_used += (uint32_t)host_len;
+	st->count++;
+	pthread_mutex_unlock(&store_lock);
+
+	__atomic_fetch_add(&stats.events, 1, __ATOMIC_RELAXED);
+}
+
+// Write pending events, finish the segment and stop storing
+void store_close(void) {
+	pthread_mutex_lock(&store_lock);
+	int running = store_running;
+	store_active = 0;
+	store_running = 0;
+	pthread_cond_signal(&store_cond);
+	pthread_mutex_unlock(&store_lock);
+
+	if (running) {
+		pthread_join(store_thread, NULL);
+		pthread_cond_destroy(&store_cond);
+		LOG_INFO_MODULE("STORE",
+				"Stored %lu events in %lu blocks (%lu bytes, %lu segments), "
+				"%lu dropped",
+				(unsigned long)stats.events, (unsigned long)stats.blocks,
+				(unsigned long)stats.bytes, (unsigned long)stats.segments,
+				(unsigned long)stats.dropped);
+	}
+
+	hotmem_free(active_stage);
+	active_stage = NULL;
+	while (spare_count > 0) {
+		hotmem_free(spare[--spare_count]);
+	}
+	for (; sealed_count > 0; sealed_count--) {
+		hotmem_free(sealed[sealed_head]);
+		sealed_head = (sealed_head + 1) % STORE_STAGES;
+	}
+	free(out_buf);
+	free(seg_index);
+	free(dict.arena);
+	free(dict.offset);
+	free(dict.length);
+	free(dict.table);
+	out_buf = NULL;
+	seg_index = NULL;
+	seg_index_size = 0;
+	memset(&dict, 0, sizeof(dict));
+}
+
+// Read the event store counters
+void store_get_stats(struct store_stats* out) {
+	if (!out) {
+		return;
+	}
+	out->events = __atomic_load_n(&stats.events, __ATOMIC_RELAXED);
+	out->dropped = __atomic_load_n(&stats.dropped, __ATOMIC_RELAXED);
+	out->blocks = __atomic_load_n(&stats.blocks, __ATOMIC_RELAXED);
+	out->bytes = __atomic_load_n(&stats.bytes, __ATOMIC_RELAXED);
+	out->segments = __atomic_load_n(&stats.segments, __ATOMIC_RELAXED);
+}
+
+// Check one block header against the segment bounds
+static int block_valid(const struct store_segment* seg, uint64_t offset, uint64_t limit) {
+	if (offset + sizeof(struct store_block_header) > limit) {
+		return 0;
+	}
+	const struct store_block_header* bh =
+		(const struct store_block_header*)(seg->map + offset);
+	if ((bh->magic != STORE_BLOCK_MAGIC && bh->magic != STORE_PACKED_MAGIC) ||
+	    bh->events == 0 || bh->events > STORE_BLOCK_EVENTS || (bh->size & 7) != 0 ||
+	    offset + bh->size > limit) {
+		return 0;
+	}
+
+	uint64_t need = sizeof(*bh) + (uint64_t)bh->dict_bytes;
+	if (bh->magic == STORE_BLOCK_MAGIC) {
+		return bh->size >= need + (uint64_t)bh->events * STORE_COLUMN_BYTES;
+	}
+
+	// Packed: the column size table and every column must fit
+	if (bh->size < need + STORE_PACKED_TABLE) {
+		return 0;
+	}
+	const uint32_t* sizes = (const uint32_t*)(seg->map + offset + need);
+	need += STORE_PACKED_TABLE;
+	for (int c = 0; c < STORE_COLUMNS; c++) {
+		need += STORE_ALIGN8((uint64_t)sizes[c]);
+	}
+	return bh->size >= need;
+}
+
+// Add one index entry while scanning a segment without footer
+static int index_push(struct store_segment* seg, uint32_t* capacity, uint64_t offset) {
+	if (seg->blocks == *capacity) {
+		uint32_t grown = *capacity ? *capacity * 2 : 256;
+		struct store_index_entry* index = realloc(seg->index, sizeof(*index) * grown);
+		if (!index) {
+			return -1;
+		}
+		seg->index = index;
+		*capacity = grown;
+	}
+
+	const struct store_block_header* bh =
+		(const struct store_block_header*)(seg->map + offset);
+	struct store_index_entry* entry = &seg->index[seg->blocks++];
+	entry->offset = offset;
+	entry->min_ts = bh->min_ts;
+	entry->max_ts = bh->max_ts;
+	entry->events = bh->events;
+	entry->categories = bh->categories;
+	entry->min_pid = bh->min_pid;
+	entry->max_pid = bh->max_pid;
+	return 0;
+}
+
+// Load the dictionary from the deltas of all blocks
+static int load_dictionary(struct store_segment* seg) {
+	uint32_t capacity = 1024;
+	seg->dict = malloc(sizeof(*seg->dict) * capacity);
+	seg->dict_len = malloc(sizeof(*seg->dict_len) * capacity);
+	if (!seg->dict || !seg->dict_len) {
+		return -1;
+	}
+	seg->dict[0] = "";
+	seg->dict_len[0] = 0;
+	seg->dict_entries = 1;
+
+	for (uint32_t b = 0; b < seg->blocks; b++) {
+		const struct store_block_header* bh =
+			(const struct store_block_header*)(seg->map + seg->index[b].offset);
+		const uint8_t* p = (const uint8_t*)(bh + 1);
+		const uint8_t* end = p + bh->dict_bytes;
+
+		for (uint32_t i = 0; i < bh->dict_entries; i++) {
+			uint16_t len;
+			if (p + sizeof(len) > end) {
+				return -1;
+			}
+			memcpy(&len, p, sizeof(len));
+			if (p + sizeof(len) + len > end) {
+				return -1;
+			}
+			if (seg->dict_entries == capacity) {
+				capacity *= 2;
+				const char** d = realloc(seg->dict, sizeof(*d) * capacity);
+				if (d) {
+					seg->dict = d;
+				}
+				uint16_t* l = realloc(seg->dict_len, sizeof(*l) * capacity);
+				if (l) {
+					seg->dict_len = l;
+				}
+				if (!d || !l) {
+					return -1;
+				}
+			}
+			seg->dict[seg->dict_entries] = (const char*)p + sizeof(len);
+			seg->dict_len[seg->dict_entries] = len;
+			seg->dict_entries++;
+			p += sizeof(len) + len;
+		}
+	}
+	return 0;
+}
+
+// Map a segment and load its index and dictionary
+int store_segment_open(struct store_segment* seg, const char* path) {
+	if (!seg || !path) {
+		return -1;
+	}
+	memset(seg, 0, sizeof(*seg));
+
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(struct store_file_header)) {
+		close(fd);
+		return -1;
+	}
+
+	void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return -1;
+	}
+	seg->map = map;
+	seg->size = (size_t)st.st_size;
+	seg->header = (const struct store_file_header*)map;
+
+	if (memcmp(seg->header->magic, STORE_MAGIC, sizeof(seg->header->magic)) != 0 ||
+	    seg->header->version != STORE_VERSION ||
+	    seg->header->header_size < sizeof(struct store_file_header) ||
+	    seg->header->header_size > seg->size) {
+		LOG_ERROR_MODULE("STORE", "%s is not a RAVN event segment (version %d)", path,
+				 STORE_VERSION);
+		store_segment_close(seg);
+		return -1;
+	}
+
+	// Closed segment: take the index from the footer (copied, a cut file may misalign it)
+	struct store_footer tail;
+	const struct store_footer* footer = NULL;
+	if (seg->size >= seg->header->header_size + sizeof(tail)) {
+		memcpy(&tail, seg->map + seg->size - sizeof(tail), sizeof(tail));
+		footer = &tail;
+		if (memcmp(footer->magic, STORE_FOOTER_MAGIC, sizeof(footer->magic)) != 0 ||
+		    footer->index_offset < seg->header->header_size ||
+		    footer->index_offset + (uint64_t)footer->blocks * sizeof(struct store_index_entry) +
+				    sizeof(*footer) !=
+			    seg->size) {
+			footer = NULL;
+		}
+	}
+
+	if (footer) {
+		seg->blocks = footer->blocks;
+		seg->index = malloc(sizeof(*seg->index) * (footer->blocks ? footer->blocks : 1));
+		if (!seg->index) {
+			store_segment_close(seg);
+			return -1;
+		}
+		memcpy(seg->index, seg->map + footer->index_offset,
+		       sizeof(*seg->index) * footer->blocks);
+		for (uint32_t b = 0; b < seg->blocks; b++) {
+			if (!block_valid(seg, seg->index[b].offset, footer->index_offset)) {
+				LOG_ERROR_MODULE("STORE", "Corrupt block %u in %s", b, path);
+				store_segment_close(seg);
+				return -1;
+			}
+		}
+		seg->complete = 1;
+	} else {
+		// Open or crashed segment: scan up to the last complete block
+		uint32_t capacity = 0;
+		uint64_t offset = seg->header->header_size;
+		while (block_valid(seg, offset, seg->size)) {
+			if (index_push(seg, &capacity, offset) != 0) {
+				store_segment_close(seg);
+				return -1;
+			}
+			offset += ((const struct store_block_header*)(seg->map + offset))->size;
+		}
+	}
+
+	for (uint32_t b = 0; b < seg->blocks; b++) {
+		seg->events += seg->index[b].events;
+	}
+
+	if (load_dictionary(seg) != 0) {
+		LOG_ERROR_MODULE("STORE", "Corrupt dictionary in %s", path);
+		store_segment_close(seg);
+		return -1;
+	}
+	return 0;
+}
+
+// Get the columns of one block
+int store_segment_block(const struct store_segment* seg, uint32_t block,
+			struct store_block_view* view) {
+	if (!seg || !view || block >= seg->blocks) {
+		return -1;
+	}
+
+	const struct store_block_header* bh =
+		(const struct store_block_header*)(seg->map + seg->index[block].offset);
+	uint32_t n = bh->events;
+	const uint8_t* col = (const uint8_t*)(bh + 1) + bh->dict_bytes;
+
+	memset(view, 0, sizeof(*view));
+	view->header = bh;
+	if (bh->magic == STORE_PACKED_MAGIC) {
+		const uint32_t* sizes = (const uint32_t*)col;
+		col += STORE_PACKED_TABLE;
+		for (int c = 0; c < STORE_COLUMNS; c++) {
+			view->packed[c] = col;
+			view->packed_size[c] = sizes[c];
+			col += STORE_ALIGN8(sizes[c]);
+		}
+		return 0;
+	}
+
+	view->ts = (const uint64_t*)col;
+	col += n * sizeof(uint64_t);
+	view->pid = (const uint32_t*)col;
+	col += n * sizeof(uint32_t);
+	view->uid = (const uint32_t*)col;
+	col += n * sizeof(uint32_t);
+	view->type = (const uint32_t*)col;
+	col += n * sizeof(uint32_t);
+	view->comm = (const uint32_t*)col;
+	col += n * sizeof(uint32_t);
+	view->path = (const uint32_t*)col;
+	col += n * sizeof(uint32_t);
+	view->host = (const uint32_t*)col;
+	col += n * sizeof(uint32_t);
+	view->category = col;
+	return 0;
+}
+
+// Decode one column of a block
+int store_block_column(const struct store_block_view* view, enum store_column column, void* out) {
+	if (!view || !view->header || !out || (unsigned)column >= STORE_COLUMNS) {
+		return -1;
+	}
+	uint32_t n = view->header->events;
+	uint32_t* values = out;
+
+	if (!view->packed[0]) {
+		const void* plain[STORE_COLUMNS] = {view->ts,	view->pid,  view->uid,	view->type,
+						    view->comm, view->path, view->host, view->category};
+		if (column == STORE_COLUMN_CATEGORY) {
+			for (uint32_t i = 0; i < n; i++) {
+				values[i] = view->category[i];
+			}
+		} else {
+			memcpy(out, plain[column], (size_t)n * column_width[column]);
+		}
+		return 0;
+	}
+
+	if (column == STORE_COLUMN_TS) {
+		return codec_delta_decode(view->packed[column], view->packed_size[column], n, out);
+	}
+	if (codec_unpack(view->packed[column], view->packed_size[column], n, values) != 0) {
+		return -1;
+	}
+	if (column == STORE_COLUMN_UID) {
+		for (uint32_t i = 0; i < n; i++) {
+			values[i] -= 1; // Packed plus one, so STORE_UID_NONE is 0
+		}
+	}
+	return 0;
+}
+
+// Copy a dictionary string
+const char* store_segment_string(const struct store_segment* seg, uint32_t id, char* buf,
+				 size_t size) {
+	if (!buf || size == 0) {
+		return buf;
+	}
+	if (!seg || id >= seg->dict_entries) {
+		buf[0] = '\0';
+		return buf;
+	}
+
+	size_t len = seg->dict_len[id] < size - 1 ? seg->dict_len[id] : size - 1;
+	memcpy(buf, seg->dict[id], len);
+	buf[len] = '\0';
+	return buf;
+}
+
+// Unmap a segment
+void store_segment_close(struct store_segment* seg) {
+	if (!seg) {
+		return;
+	}
+	if (seg->map) {
+		munmap((void*)seg->map, seg->size);
+	}
+	free(seg->index);
+	free((void*)seg->dict);
+	free(seg->dict_len);
+	memset(seg, 0, sizeof(*seg));
+}
+
+// Append one name to a segment list
+static int list_add(char*** paths, int* count, const char* path) {
+	if (*count % 256 == 0) {
+		char** grown = realloc(*paths, sizeof(**paths) * (size_t)(*count + 256));
+		if (!grown) {
+			return -1;
+		}
+		*paths = grown;
+	}
+	(*paths)[*count] = strdup(path);
+	if (!(*paths)[*count]) {
+		return -1;
+	}
+	(*count)++;
+	return 0;
+}
+
+// Collect segment file names
+int store_list_segments(const char* path, char*** paths, int* count) {
+	struct stat st;
+	if (!path || !paths || !count || stat(path, &st) != 0) {
+		return -1;
+	}
+	if (!S_ISDIR(st.st_mode)) {
+		return list_add(paths, count, path);
+	}
+
+	DIR* dir = opendir(path);
+	if (!dir) {
+		return -1;
+	}
+	size_t suffix = strlen(STORE_FILE_SUFFIX);
+	struct dirent* entry;
+	int result = 0;
+	while (result == 0 && (entry = readdir(dir)) != NULL) {
+		size_t len = strlen(entry->d_name);
+		if (len <= suffix || strcmp(entry->d_name + len - suffix, STORE_FILE_SUFFIX) != 0) {
+			continue;
+		}
+		char file[PATH_MAX];
+		snprintf(file, sizeof(file), "%s/%s", path, entry->d_name);
+		result = list_add(paths, count, file);
+	}
+	closedir(dir);
+	return result;
+}
+
+// Encode the columns of one plain block into a packed block at @out
+static size_t pack_block(const struct store_block_view* view, uint8_t* out, uint64_t* ts,
+			 uint32_t* values, struct store_pack_stats* stats) {
+	const struct store_block_header* bh = view->header;
+	uint32_t n = bh->events;
+	struct store_block_header* ph = (struct store_block_header*)out;
+	uint32_t* sizes = (uint32_t*)(out + sizeof(*bh) + bh->dict_bytes);
+	uint8_t* col = (uint8_t*)sizes + STORE_PACKED_TABLE;
+
+	// Header and dictionary delta are kept as they are
+	memcpy(out, bh, sizeof(*bh) + bh->dict_bytes);
+	ph->magic = STORE_PACKED_MAGIC;
+	memset(sizes, 0, STORE_PACKED_TABLE);
+
+	for (int c = 0; c < STORE_COLUMNS; c++) {
+		void* decoded = c == STORE_COLUMN_TS ? (void*)ts : (void*)values;
+		size_t size;
+		if (store_block_column(view, (enum store_column)c, decoded) != 0) {
+			return 0;
+		}
+		if (c == STORE_COLUMN_TS) {
+			size = codec_delta_encode(ts, n, col);
+		} else {
+			if (c == STORE_COLUMN_UID) {
+				for (uint32_t i = 0; i < n; i++) {
+					values[i] += 1;
+				}
+			}
+			size = codec_pack(values, n, col);
+		}
+		sizes[c] = (uint32_t)size;
+		memset(col + size, 0, STORE_ALIGN8(size) - size);
+		col += STORE_ALIGN8(size);
+		stats->column_in[c] += (uint64_t)n * column_width[c];
+		stats->column_out[c] += size;
+	}
+
+	ph->size = (uint32_t)(col - out);
+	return ph->size;
+}
+
+// Write a packed copy of a closed segment
+int store_segment_pack(const char* src, const char* dst, struct store_pack_stats* stats) {
+	struct store_pack_stats local;
+	struct store_segment seg;
+	struct stat st;
+
+	if (!src || !dst) {
+		return -1;
+	}
+	if (!stats) {
+		stats = &local;
+	}
+	memset(stats, 0, sizeof(*stats));
+	if (stat(src, &st) != 0 || store_segment_open(&seg, src) != 0) {
+		return -1;
+	}
+	if (!seg.complete ||
+	    (seg.blocks > 0 &&
+	     ((const struct store_block_header*)(seg.map + seg.index[0].offset))->magic ==
+		     STORE_PACKED_MAGIC)) {
+		store_segment_close(&seg);
+		return 1;
+	}
+
+	// Worst case per block: header, delta, size table and every column at its bound
+	size_t bound = sizeof(struct store_block_header) + STORE_PACKED_TABLE +
+		       STORE_ALIGN8(codec_delta_bound(STORE_BLOCK_EVENTS)) +
+		       (STORE_COLUMNS - 1) * STORE_ALIGN8(codec_pack_bound(STORE_BLOCK_EVENTS));
+	size_t buf_size = 0;
+	uint8_t* buf = NULL;
+	uint64_t* ts = malloc(sizeof(uint64_t) * STORE_BLOCK_EVENTS);
+	uint32_t* values = malloc(sizeof(uint32_t) * STORE_BLOCK_EVENTS);
+	struct store_index_entry* index = malloc(sizeof(*index) * (seg.blocks ? seg.blocks : 1));
+	int fd = open(dst, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777);
+	int result = ts && values && index && fd >= 0 ? 0 : -1;
+	if (fd < 0) {
+		LOG_ERROR_MODULE("STORE", "Failed to create %s: %s", dst, strerror(errno));
+	}
+
+	uint64_t offset = seg.header->header_size;
+	if (result == 0 && write_all(fd, seg.map, seg.header->header_size) != 0) {
+		result = -1;
+	}
+
+	for (uint32_t b = 0; result == 0 && b < seg.blocks; b++) {
+		struct store_block_view view;
+		if (store_segment_block(&seg, b, &view) != 0) {
+			result = -1;
+			break;
+		}
+		size_t need = bound + view.header->dict_bytes;
+		if (need > buf_size) {
+			uint8_t* grown = realloc(buf, need);
+			if (!grown) {
+				result = -1;
+				break;
+			}
+			buf = grown;
+			buf_size = need;
+		}
+
+		size_t size = pack_block(&view, buf, ts, values, stats);
+		if (size == 0 || write_all(fd, buf, size) != 0) {
+			LOG_ERROR_MODULE("STORE", "Failed to pack block %u of %s", b, src);
+			result = -1;
+			break;
+		}
+		index[b] = seg.index[b];
+		index[b].offset = offset;
+		offset += size;
+		stats->events += view.header->events;
+		stats->blocks++;
+	}
+
+	if (result == 0) {
+		struct store_footer footer;
+		memcpy(&footer, seg.map + seg.size - sizeof(footer), sizeof(footer));
+		footer.index_offset = offset;
+		if (write_all(fd, index, sizeof(*index) * seg.blocks) != 0 ||
+		    write_all(fd, &footer, sizeof(footer)) != 0) {
+			result = -1;
+		}
+		offset += sizeof(*index) * seg.blocks + sizeof(footer);
+	}
+
+	if (fd >= 0) {
+		// Keep the original times: retention ages segments by mtime
+		struct timespec times[2] = {st.st_atim, st.st_mtim};
+		if (result == 0 && (fdatasync(fd) != 0 || futimens(fd, times) != 0)) {
+			result = -1;
+		}
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+		if (result != 0) {
+			unlink(dst);
+		}
+	}
+
+	stats->bytes_in = seg.size;
+	stats->bytes_out = result == 0 ? offset : 0;
+	free(buf);
+	free(ts);
+	free(values);
+	free(index);
+	store_segment_close(&seg);
+	return result;
+}
@@ -0,0 +1,401 @@
+/*
+ * RAVN Event Store - Header File
+ *
+ * This header defines the on-disk columnar event store of the RAVN security
+ * platform, which keeps every decoded event for forensics long after it has
+ * left the bounded events:raw list in Redis.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The event store implements:
+ * - Time-partitioned, append-only segment files (one per STORE_PARTITION_NS
+ *   of wall-clock time, split further at STORE_MAX_SEGMENT_SIZE)
+ * - Blocks of up to STORE_BLOCK_EVENTS events stored column by column:
+ *   fixed-width timestamp, PID, user ID, type and category columns, and comm,
+ *   path and host columns holding IDs into a per-segment string dictionary
+ * - Dictionary deltas inside each block, so a segment cut short by a crash
+ *   stays readable up to its last complete block
+ * - A footer with one index entry (offset, time range, PID range, category
+ *   mask) per block: a sparse time index that readers use to skip blocks
+ * - Age-based retention of old segments
+ * - Packing of closed segments for archival: the same blocks with each
+ *   column compressed by the codecs of codec.h (delta/varint timestamps,
+ *   bit-packed integers and dictionary codes), which readers decode per
+ *   column
+ *
+ * Architecture:
+ * - The ring buffer polling thread appends raw values into a staging block
+ *   under a short lock, without hashing or I/O
+ * - A dedicated writer thread encodes sealed blocks (dictionary lookups) and
+ *   writes each one with a single large sequential write()
+ * - STORE_STAGES staging blocks rotate through the writer; events arriving
+ *   while all are busy are counted as dropped instead of blocking the event
+ *   path
+ * - Finished segments are synced and dropped from the page cache
+ *
+ * File layout:
+ *   struct store_file_header
+ *   { struct store_block_header, dictionary delta, columns } ...
+ *   (packed: { header, dictionary delta, column sizes, packed columns } ...)
+ *   struct store_index_entry[blocks], struct store_footer
+ */
+
+#ifndef RAVN_STORE_H
+#define RAVN_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Event Store Format Parameters
+ */
+#define STORE_MAGIC		 "RAVNEVS1"		/* File magic (8 bytes, no NUL) */
+#define STORE_FOOTER_MAGIC	 "RAVNIDX1"		/* Footer magic (8 bytes, no NUL) */
+#define STORE_BLOCK_MAGIC	 0x314B4C42u		/* "BLK1" */
+#define STORE_PACKED_MAGIC	 0x31504C42u		/* "BLP1", block with packed columns */
+#define STORE_VERSION		 4			/* Format version */
+#define STORE_FILE_SUFFIX	 ".rseg"		/* Segment file name suffix */
+#define STORE_BLOCK_EVENTS	 8192			/* Events per block */
+#define STORE_BLOCK_STRINGS	 (1u << 20)		/* Raw path and host bytes per staging block */
+#define STORE_STAGES		 4			/* Staging blocks (active + queued) */
+#define STORE_PARTITION_NS	 (3600ULL * 1000000000ULL) /* Segment time partition (1 hour) */
+#define STORE_MAX_SEGMENT_SIZE	 (1ULL << 30)		/* Segment split size (1 GB) */
+#define STORE_MAX_DICT_ENTRIES	 (1u << 20)		/* Dictionary strings per segment */
+#define STORE_MAX_STRING	 4095			/* Longest stored string */
+#define STORE_FLUSH_INTERVAL_MS	 1000			/* Partial blocks written after this */
+#define STORE_DEFAULT_RETENTION	 7			/* Days of segments kept */
+#define STORE_UID_NONE		 UINT32_MAX		/* User ID of events that carry none */
+
+/**
+ * enum store_column - Columns of a block, in storage order
+ */
+enum store_column {
+	STORE_COLUMN_TS = 0,	   /* uint64_t timestamps */
+	STORE_COLUMN_PID = 1,	   /* uint32_t process IDs */
+	STORE_COLUMN_UID = 2,	   /* uint32_t user IDs */
+	STORE_COLUMN_TYPE = 3,	   /* uint32_t event types */
+	STORE_COLUMN_COMM = 4,	   /* uint32_t process name IDs */
+	STORE_COLUMN_PATH = 5,	   /* uint32_t path IDs */
+	STORE_COLUMN_HOST = 6,	   /* uint32_t host name IDs */
+	STORE_COLUMN_CATEGORY = 7, /* uint8_t event categories */
+	STORE_COLUMNS = 8
+};
+
+/**
+ * struct store_file_header - Segment header
+ * @magic: STORE_MAGIC
+ * @version: STORE_VERSION
+ * @header_size: Size of this header; the first block starts at this offset
+ * @partition_start_ns: Wall-clock start of the segment's time partition
+ * @partition_ns: Length of the time partition
+ * @created_ns: Wall-clock time the segment was created
+ * @sequence: Segment number within the partition (size or dictionary splits)
+ * @block_events: Events in a full block (STORE_BLOCK_EVENTS when written)
+ */
+struct store_file_header {
+	char magic[8];		     /* STORE_MAGIC */
+	uint32_t version;	     /* Format version */
+	uint32_t header_size;	     /* Offset of the first block */
+	uint64_t partition_start_ns; /* Partition start (wall clock) */
+	uint64_t partition_ns;	     /* Partition length */
+	uint64_t created_ns;	     /* Creation time (wall clock) */
+	uint32_t sequence;	     /* Split within the partition */
+	uint32_t block_events;	     /* Events per full block */
+};
+
+/**
+ * struct store_block_header - Header of one block
+ * @magic: STORE_BLOCK_MAGIC, or STORE_PACKED_MAGIC in a packed segment
+ * @events: Events in the block (n, at most STORE_BLOCK_EVENTS)
+ * @size: Bytes of the block including this header, a multiple of 8
+ * @dict_entries: Dictionary strings first used by this block
+ * @dict_bytes: Size of the dictionary delta, a multiple of 8
+ * @categories: Bit (1 << category) per category present
+ * @min_ts: Earliest event timestamp (wall clock, ns)
+ * @max_ts: Latest event timestamp
+ * @min_pid: Lowest PID
+ * @max_pid: Highest PID
+ *
+ * The dictionary delta follows the header: @dict_entries strings, each a
+ * uint16_t length and the bytes without NUL, assigned the next free IDs of
+ * the segment (ID 0 is the empty string). The columns follow the delta:
+ * uint64_t ts[n], uint32_t pid[n], uint32_t uid[n], uint32_t type[n], uint32_t comm[n],
+ * uint32_t path[n], uint32_t host[n], uint8_t category[n], padded to 8 bytes.
+ *
+ * In a packed block the delta is followed by uint32_t size[STORE_COLUMNS]
+ * (padded to 8 bytes) and the encoded columns in the same order, each padded
+ * to 8 bytes: the timestamps delta-coded (codec_delta_encode()), the other
+ * columns bit-packed (codec_pack()), user IDs plus one so that
+ * STORE_UID_NONE packs as 0.
+ */
+struct store_block_header {
+	uint32_t magic;	       /* STORE_BLOCK_MAGIC */
+	uint32_t events;       /* Events in the block */
+	uint32_t size;	       /* Block size including header */
+	uint32_t dict_entries; /* New dictionary strings */
+	uint32_t dict_bytes;   /* Dictionary delta size */
+	uint32_t categories;   /* Category bitmask */
+	uint64_t min_ts;       /* Earliest timestamp */
+	uint64_t max_ts;       /* Latest timestamp */
+	uint32_t min_pid;      /* Lowest PID */
+	uint32_t max_pid;      /* Highest PID */
+};
+
+/**
+ * struct store_index_entry - Footer index entry of one block
+ * @offset: File offset of the block header
+ * @min_ts: Earliest event timestamp of the block
+ * @max_ts: Latest event timestamp of the block
+ * @events: Events in the block
+ * @categories: Category bitmask of the block
+ * @min_pid: Lowest PID of the block
+ * @max_pid: Highest PID of the block
+ */
+struct store_index_entry {
+	uint64_t offset;     /* Block offset */
+	uint64_t min_ts;     /* Earliest timestamp */
+	uint64_t max_ts;     /* Latest timestamp */
+	uint32_t events;     /* Events in the block */
+	uint32_t categories; /* Category bitmask */
+	uint32_t min_pid;    /* Lowest PID */
+	uint32_t max_pid;    /* Highest PID */
+};
+
+/**
+ * struct store_footer - Segment trailer, the last bytes of a closed segment
+ * @index_offset: File offset of the first index entry
+ * @blocks: Number of index entries
+ * @dict_entries: Dictionary strings in the segment
+ * @events: Events in the segment
+ * @min_ts: Earliest event timestamp of the segment
+ * @max_ts: Latest event timestamp of the segment
+ * @magic: STORE_FOOTER_MAGIC
+ */
+struct store_footer {
+	uint64_t index_offset; /* Index offset */
+	uint32_t blocks;       /* Index entries */
+	uint32_t dict_entries; /* Dictionary strings */
+	uint64_t events;       /* Events in the segment */
+	uint64_t min_ts;       /* Earliest timestamp */
+	uint64_t max_ts;       /* Latest timestamp */
+	char magic[8];	       /* STORE_FOOTER_MAGIC */
+};
+
+/**
+ * struct store_stats - Event store counters since store_open()
+ * @events: Events appended
+ * @dropped: Events lost because all staging blocks were busy (or a write
+ *           failed)
+ * @blocks: Blocks written
+ * @bytes: Bytes written
+ * @segments: Segments created
+ */
+struct store_stats {
+	uint64_t events;   /* Events appended */
+	uint64_t dropped;  /* Events dropped */
+	uint64_t blocks;   /* Blocks written */
+	uint64_t bytes;	   /* Bytes written */
+	uint64_t segments; /* Segments created */
+};
+
+/**
+ * struct store_pack_stats - Sizes of a segment packed by store_segment_pack()
+ * @events: Events in the segment
+ * @blocks: Blocks in the segment
+ * @bytes_in: Size of the original segment
+ * @bytes_out: Size of the packed segment
+ * @column_in: Raw bytes per column
+ * @column_out: Packed bytes per column
+ */
+struct store_pack_stats {
+	uint64_t events;		     /* Events */
+	uint64_t blocks;		     /* Blocks */
+	uint64_t bytes_in;		     /* Original size */
+	uint64_t bytes_out;		     /* Packed size */
+	uint64_t column_in[STORE_COLUMNS];  /* Raw column bytes */
+	uint64_t column_out[STORE_COLUMNS]; /* Packed column bytes */
+};
+
+/**
+ * struct store_block_view - Columns of one block of a mapped segment
+ * @header: Block header
+ * @packed: Encoded columns of a packed block (the typed pointers are then
+ *          NULL; use store_block_column())
+ * @packed_size: Encoded size of each column
+ * @ts: Timestamp column
+ * @pid: PID column
+ * @uid: User ID column (STORE_UID_NONE if the event carries none)
+ * @type: Event type column
+ * @comm: Process name column (dictionary IDs)
+ * @path: Path column (dictionary IDs, 0 if the event has no path)
+ * @host: Host column (dictionary IDs, 0 for events of the storing host)
+ * @category: Event category column
+ */
+struct store_block_view {
+	const struct store_block_header* header;
+	const uint8_t* packed[STORE_COLUMNS];
+	uint32_t packed_size[STORE_COLUMNS];
+	const uint64_t* ts;
+	const uint32_t* pid;
+	const uint32_t* uid;
+	const uint32_t* type;
+	const uint32_t* comm;
+	const uint32_t* path;
+	const uint32_t* host;
+	const uint8_t* category;
+};
+
+/**
+ * struct store_segment - Read-only view of one segment file
+ * @map: Segment mapping
+ * @size: Size of @map
+ * @header: Segment header
+ * @index: Block index (the footer's, or rebuilt by scanning a segment
+ *         without footer)
+ * @blocks: Entries in @index
+ * @events: Events in the segment
+ * @dict: Dictionary strings by ID (pointers into @map, not NUL-terminated)
+ * @dict_len: Length of each dictionary string
+ * @dict_entries: Entries in @dict, including ID 0
+ * @complete: 1 if the segment was closed with a footer
+ */
+struct store_segment {
+	const uint8_t* map;
+	size_t size;
+	const struct store_file_header* header;
+	struct store_index_entry* index;
+	uint32_t blocks;
+	uint64_t events;
+	const char** dict;
+	uint16_t* dict_len;
+	uint32_t dict_entries;
+	int complete;
+};
+
+/*
+ * Event Store Writing Functions
+ */
+
+/**
+ * store_open - Start storing events
+ * @dir: Directory for segment files (created if missing)
+ * @retention_days: Days of segments kept, 0 to keep everything
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int store_open(const char* dir, uint32_t retention_days);
+
+/**
+ * store_append - Append one decoded event
+ * @timestamp: Event timestamp (CLOCK_MONOTONIC ns, as from bpf_ktime_get_ns)
+ * @pid: Process ID
+ * @uid: User ID, STORE_UID_NONE if the event carries none
+ * @type: Event type
+ * @category: Event category
+ * @comm: Process name
+ * @path: Path the event refers to, NULL or empty if none
+ * @host: Host the event was forwarded from, NULL or empty for this host
+ *
+ * Does nothing unless the store is open. Timestamps are stored as wall-clock
+ * time.
+ */
+void store_append(uint64_t timestamp, uint32_t pid, uint32_t uid, uint32_t type,
+		  uint32_t category, const char* comm, const char* path, const char* host);
+
+/**
+ * store_close - Write pending events, finish the segment and stop storing
+ */
+void store_close(void);
+
+/**
+ * store_get_stats - Read the event store counters
+ * @stats: Output counters
+ */
+void store_get_stats(struct store_stats* stats);
+
+/*
+ * Event Store Reading Functions
+ */
+
+/**
+ * store_segment_open - Map a segment and load its index and dictionary
+ * @seg: Segment view to initialize
+ * @path: Segment file
+ *
+ * Segments still being written, or cut short by a crash, are read up to
+ * their last complete block.
+ *
+ * Return: 0 on success, -1 if the file is missing or not a segment
+ */
+int store_segment_open(struct store_segment* seg, const char* path);
+
+/**
+ * store_segment_block - Get the columns of one block
+ * @seg: Open segment
+ * @block: Block number, below @seg->blocks
+ * @view: Output column pointers
+ *
+ * Return: 0 on success, -1 on a corrupt block
+ */
+int store_segment_block(const struct store_segment* seg, uint32_t block,
+			struct store_block_view* view);
+
+/**
+ * store_block_column - Decode one column of a block
+ * @view: Block from store_segment_block()
+ * @column: Column to decode
+ * @out: Output with room for STORE_BLOCK_EVENTS values: uint64_t for
+ *       STORE_COLUMN_TS, uint32_t for the others (categories widened)
+ *
+ * Works for plain blocks too, copying the column.
+ *
+ * Return: 0 on success, -1 on corrupt data
+ */
+int store_block_column(const struct store_block_view* view, enum store_column column, void* out);
+
+/**
+ * store_segment_string - Copy a dictionary string
+ * @seg: Open segment
+ * @id: Dictionary ID from a comm, path or host column
+ * @buf: Output buffer (NUL-terminated, truncated to fit)
+ * @size: Size of @buf
+ *
+ * Return: @buf, holding "" for ID 0 or unknown IDs
+ */
+const char* store_segment_string(const struct store_segment* seg, uint32_t id, char* buf,
+				 size_t size);
+
+/**
+ * store_segment_close - Unmap a segment
+ * @seg: Segment to close
+ */
+void store_segment_close(struct store_segment* seg);
+
+/**
+ * store_list_segments - Collect segment file names
+ * @path: A segment file, or a directory whose STORE_FILE_SUFFIX files are
+ *        collected
+ * @paths: Array of allocated names, grown and appended to
+ * @count: Entries in @paths
+ *
+ * Callers free each name and the array.
+ *
+ * Return: 0 on success, -1 if @path cannot be read or on allocation failure
+ */
+int store_list_segments(const char* path, char*** paths, int* count);
+
+/**
+ * store_segment_pack - Write a packed copy of a closed segment
+ * @src: Closed segment (with footer)
+ * @dst: Output file, created or truncated; keeps the mode and times of @src
+ *       so retention still ages it by its original time
+ * @stats: Output sizes (may be NULL)
+ *
+ * Return: 0 on success, 1 if @src is still open or already packed (nothing
+ *         written), -1 on failure
+ */
+int store_segment_pack(const char* src, const char* dst, struct store_pack_stats* stats);
+
+#endif // RAVN_STORE_H
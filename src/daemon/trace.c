@@ -0,0 +1,306 @@
+// RAVN Trace Recording Implementation
+// Append-only mmap'd segment files holding raw ring buffer records
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "trace.h"
+
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Recorder state (single writer: the ring buffer polling thread)
+static int trace_active = 0;
+static int trace_fd = -1;
+static uint8_t* trace_map = NULL;
+static uint64_t trace_segment_size = 0;
+static uint64_t trace_pos = 0;
+static uint32_t trace_segment = 0;
+static char trace_path[PATH_MAX];
+
+// Recording totals
+static uint64_t trace_total_records = 0;
+static uint64_t trace_total_bytes = 0;
+static uint64_t trace_lost_records = 0;
+
+// Build the file name of a segment
+static void segment_path(char* buf, size_t size, uint32_t segment) {
+	if (segment == 0) {
+		snprintf(buf, size, "%s", trace_path);
+	} else {
+		snprintf(buf, size, "%s.%u", trace_path, segment);
+	}
+}
+
+// Create, preallocate and map a new segment
+static int open_segment(uint32_t segment) {
+	char path[PATH_MAX + 16];
+	segment_path(path, sizeof(path), segment);
+
+	int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		LOG_ERROR_MODULE("TRACE", "Failed to create %s: %s", path, strerror(errno));
+		return -1;
+	}
+
+	// Reserve the blocks up front so appends never allocate on the hot path
+	int err = posix_fallocate(fd, 0, (off_t)trace_segment_size);
+	if (err != 0 && ftruncate(fd, (off_t)trace_segment_size) != 0) {
+		LOG_ERROR_MODULE("TRACE", "Failed to preallocate %s: %s", path, strerror(err));
+		close(fd);
+		return -1;
+	}
+
+	void* map = mmap(NULL, trace_segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED) {
+		LOG_ERROR_MODULE("TRACE", "Failed to map %s: %s", path, strerror(errno));
+		close(fd);
+		return -1;
+	}
+	madvise(map, trace_segment_size, MADV_SEQUENTIAL);
+
+	struct timespec rt;
+	clock_gettime(CLOCK_REALTIME, &rt);
+
+	struct trace_file_header* hdr = (struct trace_file_header*)map;
+	memcpy(hdr->magic, TRACE_MAGIC, sizeof(hdr->magic));
+	hdr->version = TRACE_VERSION;
+	hdr->header_size = sizeof(*hdr);
+	hdr->data_size = 0;
+	hdr->start_ktime_ns = ravn_prof_now_ns();
+	hdr->start_realtime_ns = (uint64_t)rt.tv_sec * 1000000000ULL + (uint64_t)rt.tv_nsec;
+	hdr->segment = segment;
+	hdr->records = 0;
+
+	trace_fd = fd;
+	trace_map = (uint8_t*)map;
+	trace_pos = sizeof(*hdr);
+	trace_segment = segment;
+	return 0;
+}
+
+// Unmap the current segment and trim it to its used size
+static void close_segment(void) {
+	if (!trace_map) {
+		return;
+	}
+
+	uint64_t used = trace_pos;
+	msync(trace_map, used, MS_ASYNC);
+	munmap(trace_map, trace_segment_size);
+	trace_map = NULL;
+
+	if (ftruncate(trace_fd, (off_t)used) != 0) {
+		LOG_WARN_MODULE("TRACE", "Failed to trim trace segment %u: %s", trace_segment,
+				strerror(errno));
+	}
+	close(trace_fd);
+	trace_fd = -1;
+}
+
+// Start recording raw ring records
+int trace_record_open(const char* path, uint64_t segment_size) {
+	if (!path || trace_active) {
+		return -1;
+	}
+
+	if (segment_size == 0) {
+		segment_size = TRACE_DEFAULT_SEGMENT_SIZE;
+	}
+	if (segment_size < TRACE_MIN_SEGMENT_SIZE) {
+		segment_size = TRACE_MIN_SEGMENT_SIZE;
+	}
+
+	snprintf(trace_path, sizeof(trace_path), "%s", path);
+	trace_segment_size = segment_size;
+	trace_total_records = 0;
+	trace_total_bytes = 0;
+	trace_lost_records = 0;
+
+	if (open_segment(0) != 0) {
+		return -1;
+	}
+
+	__atomic_store_n(&trace_active, 1, __ATOMIC_RELEASE);
+	LOG_INFO_MODULE("TRACE", "Recording raw ring records to %s (%lu MB segments)", path,
+			(unsigned long)(segment_size >> 20));
+	return 0;
+}
+
+// Append one raw ring record
+int trace_record_append(uint32_t category, const void* data, uint32_t length) {
+	if (!__atomic_load_n(&trace_active, __ATOMIC_ACQUIRE)) {
+		return 0;
+	}
+
+	uint64_t size = sizeof(struct trace_record_header) + length;
+	uint64_t padded = (size + TRACE_RECORD_ALIGN - 1) & ~(uint64_t)(TRACE_RECORD_ALIGN - 1);
+
+	// Rotate when the record does not fit the current segment
+	if (trace_pos + padded > trace_segment_size) {
+		if (padded > trace_segment_size - sizeof(struct trace_file_header)) {
+			trace_lost_records++;
+			return -1;
+		}
+		close_segment();
+		if (open_segment(trace_segment + 1) != 0) {
+			__atomic_store_n(&trace_active, 0, __ATOMIC_RELEASE);
+			trace_lost_records++;
+			return -1;
+		}
+	}
+
+	struct trace_record_header* rec = (struct trace_record_header*)(trace_map + trace_pos);
+	rec->category = category;
+	rec->length = length;
+	rec->ktime_ns = ravn_prof_now_ns();
+	memcpy(rec + 1, data, length);
+
+	// Keep the header current so a crashed recording stays readable
+	trace_pos += padded;
+	struct trace_file_header* hdr = (struct trace_file_header*)trace_map;
+	hdr->data_size = trace_pos - sizeof(*hdr);
+	hdr->records++;
+
+	trace_total_records++;
+	trace_total_bytes += padded;
+	return 0;
+}
+
+// Stop recording and finalize the current segment
+void trace_record_close(void) {
+	if (!__atomic_load_n(&trace_active, __ATOMIC_ACQUIRE) && !trace_map) {
+		return;
+	}
+
+	__atomic_store_n(&trace_active, 0, __ATOMIC_RELEASE);
+	close_segment();
+
+	LOG_INFO_MODULE("TRACE", "Recorded %lu records (%lu bytes) in %u segment(s), %lu lost",
+			(unsigned long)trace_total_records, (unsigned long)trace_total_bytes,
+			trace_segment + 1, (unsigned long)trace_lost_records);
+}
+
+// Map one segment of a trace read-only
+static int reader_map_segment(struct trace_reader* reader, uint32_t segment) {
+	char path[sizeof(reader->path) + 16];
+	if (segment == 0) {
+		snprintf(path, sizeof(path), "%s", reader->path);
+	} else {
+		snprintf(path, sizeof(path), "%s.%u", reader->path, segment);
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		return -1;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < sizeof(struct trace_file_header)) {
+		close(fd);
+		return -1;
+	}
+
+	void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (map == MAP_FAILED) {
+		close(fd);
+		return -1;
+	}
+	madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+	const struct trace_file_header* hdr = (const struct trace_file_header*)map;
+	if (memcmp(hdr->magic, TRACE_MAGIC, sizeof(hdr->magic)) != 0 ||
+	    hdr->version != TRACE_VERSION || hdr->header_size < sizeof(*hdr) ||
+	    hdr->header_size > (uint64_t)st.st_size) {
+		LOG_ERROR_MODULE("TRACE", "%s is not a RAVN trace (version %d)", path,
+				 TRACE_VERSION);
+		munmap(map, (size_t)st.st_size);
+		close(fd);
+		return -1;
+	}
+
+	reader->fd = fd;
+	reader->map = (uint8_t*)map;
+	reader->map_size = (uint64_t)st.st_size;
+	reader->pos = hdr->header_size;
+	reader->end = hdr->header_size + hdr->data_size;
+	if (reader->end > reader->map_size) {
+		reader->end = reader->map_size; // Truncated copy of a live recording
+	}
+	reader->segment = segment;
+	return 0;
+}
+
+// Unmap the current segment of a reader
+static void reader_unmap_segment(struct trace_reader* reader) {
+	if (reader->map) {
+		munmap(reader->map, reader->map_size);
+		reader->map = NULL;
+	}
+	if (reader->fd >= 0) {
+		close(reader->fd);
+		reader->fd = -1;
+	}
+}
+
+// Open a trace for sequential reading
+int trace_reader_open(struct trace_reader* reader, const char* path) {
+	if (!reader || !path) {
+		return -1;
+	}
+
+	memset(reader, 0, sizeof(*reader));
+	reader->fd = -1;
+	snprintf(reader->path, sizeof(reader->path), "%s", path);
+
+	if (reader_map_segment(reader, 0) != 0) {
+		LOG_ERROR_MODULE("TRACE", "Failed to open trace %s", path);
+		return -1;
+	}
+	return 0;
+}
+
+// Read the next record, crossing into rotated segments
+int trace_reader_next(struct trace_reader* reader, const struct trace_record_header** hdr,
+		      void** data) {
+	if (!reader || !reader->map) {
+		return 0;
+	}
+
+	while (reader->pos + sizeof(struct trace_record_header) > reader->end) {
+		uint32_t next = reader->segment + 1;
+		reader_unmap_segment(reader);
+		if (reader_map_segment(reader, next) != 0) {
+			return 0;
+		}
+	}
+
+	struct trace_record_header* rec = (struct trace_record_header*)(reader->map + reader->pos);
+	uint64_t size = sizeof(*rec) + rec->length;
+	if (rec->length == 0 || reader->pos + size > reader->end) {
+		LOG_ERROR_MODULE("TRACE", "Corrupt record at offset %lu of segment %u",
+				 (unsigned long)reader->pos, reader->segment);
+		return -1;
+	}
+
+	*hdr = rec;
+	*data = rec + 1;
+	reader->pos += (size + TRACE_RECORD_ALIGN - 1) & ~(uint64_t)(TRACE_RECORD_ALIGN - 1);
+	return 1;
+}
+
+// Close a trace reader
+void trace_reader_close(struct trace_reader* reader) {
+	if (reader) {
+		reader_unmap_segment(reader);
+	}
+}
@@ -0,0 +1,164 @@
+/*
+ * RAVN Trace Recording - Header File
+ *
+ * This header defines the binary trace format and recorder for the RAVN
+ * security platform, capturing the raw ring buffer records exactly as the
+ * kernel emitted them for debugging, benchmarking and replay.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The trace recorder implements:
+ * - Small framing header per record (category, length, ktime)
+ * - Preallocated, mmap'd, append-only segment files
+ * - Size-based rotation (<path>, <path>.1, <path>.2, ...)
+ * - Crash-tolerant layout: the valid length is kept current in the header
+ *
+ * Architecture:
+ * - Single writer: records are appended from the ring buffer polling thread
+ * - Appending is a memcpy into the mapping, no syscalls on the hot path
+ * - Segments are truncated to their used size when closed
+ *
+ * File layout:
+ *   struct trace_file_header
+ *   { struct trace_record_header, payload, padding to 8 bytes } ...
+ */
+
+#ifndef RAVN_TRACE_H
+#define RAVN_TRACE_H
+
+#include <stdint.h>
+
+/*
+ * Trace Format Parameters
+ */
+#define TRACE_MAGIC		   "RAVNTRC1"	  /* File magic (8 bytes, no NUL) */
+#define TRACE_VERSION		   1		  /* Format version */
+#define TRACE_RECORD_ALIGN	   8		  /* Record alignment */
+#define TRACE_DEFAULT_SEGMENT_SIZE (64ULL << 20) /* Rotation size (64 MB) */
+#define TRACE_MIN_SEGMENT_SIZE	   (1ULL << 20)	  /* Smallest accepted segment */
+
+/**
+ * struct trace_file_header - Trace segment header
+ * @magic: TRACE_MAGIC
+ * @version: TRACE_VERSION
+ * @header_size: Size of this header; records start at this offset
+ * @data_size: Bytes of records following the header
+ * @start_ktime_ns: CLOCK_MONOTONIC time when the segment was opened
+ * @start_realtime_ns: Wall-clock time when the segment was opened
+ * @segment: Rotation sequence number (0 for the first segment)
+ * @records: Number of records in the segment
+ */
+struct trace_file_header {
+	char magic[8];		    /* TRACE_MAGIC */
+	uint32_t version;	    /* Format version */
+	uint32_t header_size;	    /* Offset of first record */
+	uint64_t data_size;	    /* Valid record bytes */
+	uint64_t start_ktime_ns;    /* Monotonic open time */
+	uint64_t start_realtime_ns; /* Wall-clock open time */
+	uint32_t segment;	    /* Rotation sequence */
+	uint32_t reserved;	    /* Reserved, zero */
+	uint64_t records;	    /* Record count */
+	uint64_t pad;		    /* Reserved, zero */
+};
+
+/**
+ * struct trace_record_header - Framing header of one raw ring record
+ * @category: Event category of the source ring (enum event_category)
+ * @length: Payload length in bytes (excluding header and padding)
+ * @ktime_ns: CLOCK_MONOTONIC time the record was consumed (same clock
+ *            as bpf_ktime_get_ns)
+ */
+struct trace_record_header {
+	uint32_t category; /* Source ring category */
+	uint32_t length;   /* Payload length */
+	uint64_t ktime_ns; /* Consume time */
+};
+
+/**
+ * struct trace_reader - Sequential reader over all segments of a trace
+ * @path: Trace file path (first segment)
+ * @fd: Descriptor of the current segment
+ * @map: Read-only mapping of the current segment
+ * @map_size: Size of @map
+ * @pos: Offset of the next record in @map
+ * @end: End of valid record data in @map
+ * @segment: Sequence number of the current segment
+ */
+struct trace_reader {
+	char path[4096];   /* First segment path */
+	int fd;		   /* Segment descriptor */
+	uint8_t* map;	   /* Segment mapping */
+	uint64_t map_size; /* Mapping size */
+	uint64_t pos;	   /* Next record offset */
+	uint64_t end;	   /* End of valid data */
+	uint32_t segment;  /* Segment sequence */
+};
+
+/*
+ * Trace Recording Functions
+ */
+
+/**
+ * trace_record_open - Start recording raw ring records
+ * @path: Trace file path (rotated segments get .1, .2, ... suffixes)
+ * @segment_size: Rotation size in bytes, 0 for TRACE_DEFAULT_SEGMENT_SIZE
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int trace_record_open(const char* path, uint64_t segment_size);
+
+/**
+ * trace_record_append - Append one raw ring record
+ * @category: Event category of the source ring
+ * @data: Raw record as delivered by the ring buffer
+ * @length: Record length in bytes
+ *
+ * Does nothing unless recording is active. Must only be called from the
+ * ring buffer polling thread.
+ *
+ * Return: 0 on success or when not recording, -1 if the record was lost
+ */
+int trace_record_append(uint32_t category, const void* data, uint32_t length);
+
+/**
+ * trace_record_close - Stop recording and finalize the current segment
+ */
+void trace_record_close(void);
+
+/*
+ * Trace Reading Functions
+ */
+
+/**
+ * trace_reader_open - Open a trace for sequential reading
+ * @reader: Reader to initialize
+ * @path: Trace file path (first segment)
+ *
+ * Return: 0 on success, -1 if the file is missing or not a trace
+ */
+int trace_reader_open(struct trace_reader* reader, const char* path);
+
+/**
+ * trace_reader_next - Read the next record
+ * @reader: Open reader
+ * @hdr: Set to the record framing header
+ * @data: Set to the record payload
+ *
+ * Moves on to the next rotated segment when the current one is exhausted.
+ * The returned pointers stay valid until the next call.
+ *
+ * Return: 1 if a record was read, 0 at the end of the trace, -1 on a
+ * corrupt record
+ */
+int trace_reader_next(struct trace_reader* reader, const struct trace_record_header** hdr,
+		      void** data);
+
+/**
+ * trace_reader_close - Close a trace reader
+ * @reader: Reader to close
+ */
+void trace_reader_close(struct trace_reader* reader);
+
+#endif // RAVN_TRACE_H
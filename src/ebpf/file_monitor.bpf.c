@@ -5,6 +5,8 @@
 #include <vmlinux.h>
 #include <bpf/bpf_helpers.h>
 
+#include "monitor_control.h"
+
 // Event structure for file events (must match user-space structure)
 struct file_event {
 	__u64 timestamp;
@@ -19,6 +21,7 @@ struct file_event {
 	char comm[16];
 	char filename[256];
 	char target_filename[256];
+	__u64 cgroup_id;
 };
 
 // Ring buffer map
@@ -32,6 +35,11 @@ SEC("kprobe/vfs_open")
 int trace_file_event(struct pt_regs* ctx __attribute__((unused))) {
 	struct file_event* event;
 
+	// Sampled out or aggregate-only events never reach the ring
+	if (!monitor_admit()) {
+		return 0;
+	}
+
 	// Reserve space in ring buffer
 	event = bpf_ringbuf_reserve(&file_events, sizeof(*event), 0);
 	if (!event) {
@@ -42,6 +50,7 @@ int trace_file_event(struct pt_regs* ctx __attribute__((unused))) {
 	event->timestamp = bpf_ktime_get_ns();
 	event->pid = bpf_get_current_pid_tgid() >> 32;
 	event->tid = bpf_get_current_pid_tgid() & 0xFFFFFFFF;
+	event->cgroup_id = bpf_get_current_cgroup_id();
 	event->event_type = 1; // File open
 	event->fd = 0;	       // File descriptor (will be set by kernel)
 	event->flags = 0;      // O_RDONLY
@@ -13,6 +13,7 @@
 #include <bpf/bpf_helpers.h>
 #include <bpf/bpf_tracing.h>
 #include "ravn_events.h"
+#include "monitor_control.h"
 
 /*
  * Ring buffer for memory events
@@ -42,6 +43,11 @@ static __always_inline void get_process_name(char* comm) {
 static __always_inline int send_memory_event(__u32 event_type, __u64 address, 
 					    __u64 size, __u32 permissions, 
 					    __u32 flags, __s64 ret) {
+	/* Sampled out or aggregate-only events never reach the ring */
+	if (!monitor_admit()) {
+		return 0;
+	}
+
 	struct memory_event* event = bpf_ringbuf_reserve(&memory_events, 
 							 sizeof(struct memory_event), 0);
 	if (!event) {
@@ -51,6 +57,7 @@ static __always_inline int send_memory_event(__u32 event_type, __u64 address,
 	event->timestamp = get_timestamp();
 	event->pid = bpf_get_current_pid_tgid() >> 32;
 	event->tid = bpf_get_current_pid_tgid() & 0xFFFFFFFF;
+	event->cgroup_id = bpf_get_current_cgroup_id();
 	event->event_type = event_type;
 	event->address = address;
 	event->size = size;
@@ -0,0 +1,103 @@
+/*
+ * RAVN Monitor Control - Shared eBPF Maps
+ *
+ * Control and tally maps included by every monitor program. The daemon's
+ * CPU budget governor writes the control entry to sample events or switch
+ * the monitor to aggregate-only mode; the cgroup filter maps include or
+ * exclude cgroups. Events that are not emitted are counted per CPU in the
+ * tally map instead of reserving ring space.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ */
+
+#ifndef RAVN_MONITOR_CONTROL_H
+#define RAVN_MONITOR_CONTROL_H
+
+#include "ravn_events.h"
+
+/*
+ * Emission control, one entry per monitor object
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, 1);
+	__type(key, __u32);
+	__type(value, struct monitor_control);
+} monitor_controls SEC(".maps");
+
+/*
+ * cgroup filter mode (enum cgroup_filter_mode), one entry per monitor object
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, 1);
+	__type(key, __u32);
+	__type(value, __u32);
+} monitor_cgroup_mode SEC(".maps");
+
+/*
+ * cgroup IDs the filter mode applies to
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, MONITOR_CGROUP_MAX);
+	__type(key, __u64);
+	__type(value, __u8);
+} monitor_cgroups SEC(".maps");
+
+/*
+ * Events not emitted, indexed by enum monitor_tally
+ */
+struct {
+	__uint(type, BPF_MAP_TYPE_PERCPU_ARRAY);
+	__uint(max_entries, MONITOR_TALLY_MAX);
+	__type(key, __u32);
+	__type(value, __u64);
+} monitor_tallies SEC(".maps");
+
+/*
+ * Count an event that is not emitted
+ */
+static __always_inline void monitor_count(__u32 tally) {
+	__u64* count = bpf_map_lookup_elem(&monitor_tallies, &tally);
+	if (count) {
+		(*count)++;
+	}
+}
+
+/*
+ * Decide whether an event becomes a ring record; call before reserving
+ */
+static __always_inline int monitor_admit(void) {
+	__u32 key = 0;
+
+	/* Filtered cgroups are dropped before sampling or aggregation sees them */
+	__u32* cgroup_mode = bpf_map_lookup_elem(&monitor_cgroup_mode, &key);
+	if (cgroup_mode && *cgroup_mode != CGROUP_FILTER_NONE) {
+		__u64 cgroup_id = bpf_get_current_cgroup_id();
+		int listed = bpf_map_lookup_elem(&monitor_cgroups, &cgroup_id) != NULL;
+		if (listed != (*cgroup_mode == CGROUP_FILTER_INCLUDE)) {
+			monitor_count(MONITOR_TALLY_FILTERED);
+			return 0;
+		}
+	}
+
+	struct monitor_control* control = bpf_map_lookup_elem(&monitor_controls, &key);
+	if (!control) {
+		return 1;
+	}
+
+	if (control->mode == MONITOR_MODE_AGGREGATE) {
+		monitor_count(MONITOR_TALLY_AGGREGATED);
+		return 0;
+	}
+	if (control->sample_rate > 1 && bpf_get_prandom_u32() % control->sample_rate != 0) {
+		monitor_count(MONITOR_TALLY_SAMPLED);
+		return 0;
+	}
+	return 1;
+}
+
+#endif // RAVN_MONITOR_CONTROL_H
@@ -5,6 +5,8 @@
 #include <vmlinux.h>
 #include <bpf/bpf_helpers.h>
 
+#include "monitor_control.h"
+
 // Event structure for network events
 struct network_event {
 	__u64 timestamp;
@@ -21,6 +23,7 @@ struct network_event {
 	__u32 bytes_sent;
 	__u32 bytes_received;
 	char comm[16];
+	__u64 cgroup_id;
 };
 
 // Ring buffer map
@@ -46,6 +49,11 @@ int trace_network_send(struct pt_regs* ctx __attribute__((unused))) {
 
 	struct network_event* event;
 
+	// Sampled out or aggregate-only events never reach the ring
+	if (!monitor_admit()) {
+		return 0;
+	}
+
 	// Reserve space in ring buffer
 	event = bpf_ringbuf_reserve(&network_events, sizeof(*event), 0);
 	if (!event) {
@@ -56,6 +64,7 @@ int trace_network_send(struct pt_regs* ctx __attribute__((unused))) {
 	event->timestamp = current_time;
 	event->pid = bpf_get_current_pid_tgid() >> 32;
 	event->tid = bpf_get_current_pid_tgid() & 0xFFFFFFFF;
+	event->cgroup_id = bpf_get_current_cgroup_id();
 	event->event_type = 1;	    // Network send
 	event->family = 2;	    // AF_INET
 	event->type = 1;	    // SOCK_STREAM
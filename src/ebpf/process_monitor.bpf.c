@@ -13,6 +13,7 @@
 #include <bpf/bpf_helpers.h>
 #include <bpf/bpf_tracing.h>
 #include "ravn_events.h"
+#include "monitor_control.h"
 
 /*
  * Ring buffer for process events
@@ -41,6 +42,11 @@ static __always_inline void get_process_name(char* comm) {
  */
 static __always_inline int send_process_event(__u32 event_type, __u32 ppid, 
 					     __u32 uid, __u32 gid, __s64 ret) {
+	/* Sampled out or aggregate-only events never reach the ring */
+	if (!monitor_admit()) {
+		return 0;
+	}
+
 	struct process_event* event = bpf_ringbuf_reserve(&process_events, 
 							 sizeof(struct process_event), 0);
 	if (!event) {
@@ -50,6 +56,7 @@ static __always_inline int send_process_event(__u32 event_type, __u32 ppid,
 	event->timestamp = get_timestamp();
 	event->pid = bpf_get_current_pid_tgid() >> 32;
 	event->tid = bpf_get_current_pid_tgid() & 0xFFFFFFFF;
+	event->cgroup_id = bpf_get_current_cgroup_id();
 	event->ppid = ppid;
 	event->event_type = event_type;
 	event->uid = uid;
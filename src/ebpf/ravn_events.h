@@ -127,6 +127,7 @@ struct memory_event {
 	char comm[16];	      /* Process name */
 	char filename[256];   /* Associated filename */
 	__u64 stack_trace[8]; /* Stack trace */
+	__u64 cgroup_id;      /* cgroup v2 ID */
 };
 
 /**
@@ -152,6 +153,7 @@ struct process_event {
 	char working_dir[256];	   /* Working directory */
 	char command_line[512];	   /* Command line arguments */
 	__u64 stack_trace[8];   /* Stack trace */
+	__u64 cgroup_id;	   /* cgroup v2 ID */
 };
 
 /**
@@ -173,6 +175,7 @@ struct kernel_event {
 	char filename[256];	   /* Filename */
 	__u64 stack_trace[8];   /* Stack trace */
 	__u64 registers[8];	   /* CPU registers */
+	__u64 cgroup_id;	   /* cgroup v2 ID */
 };
 
 /**
@@ -193,6 +196,51 @@ struct performance_event {
 	char metric_name[64];	   /* Metric name */
 	__u64 stack_trace[8];   /* Stack trace */
 	__u64 performance_data[8]; /* Performance data */
+	__u64 cgroup_id;	   /* cgroup v2 ID */
+};
+
+/*
+ * Monitor Control (written by the daemon's CPU budget governor and cgroup
+ * filter)
+ */
+
+#define MONITOR_CGROUP_MAX 256 /* cgroup IDs in one monitor's filter */
+
+/**
+ * enum monitor_mode - What a monitor does with an admitted event
+ */
+enum monitor_mode {
+	MONITOR_MODE_FULL = 0,	    /* Emit a ring record */
+	MONITOR_MODE_AGGREGATE = 1  /* Only count the event */
+};
+
+/**
+ * enum monitor_tally - Per-CPU counters of events that were not emitted
+ */
+enum monitor_tally {
+	MONITOR_TALLY_SAMPLED = 0,    /* Skipped by sampling */
+	MONITOR_TALLY_AGGREGATED = 1, /* Counted in aggregate mode */
+	MONITOR_TALLY_FILTERED = 2,   /* Dropped by the cgroup filter */
+	MONITOR_TALLY_MAX = 3
+};
+
+/**
+ * enum cgroup_filter_mode - Which cgroups a monitor emits events for
+ */
+enum cgroup_filter_mode {
+	CGROUP_FILTER_NONE = 0,	   /* Every cgroup */
+	CGROUP_FILTER_INCLUDE = 1, /* Only the listed cgroups */
+	CGROUP_FILTER_EXCLUDE = 2  /* Every cgroup but the listed ones */
+};
+
+/**
+ * struct monitor_control - Emission control of one monitor
+ *
+ * The all-zero entry a monitor is loaded with emits every event.
+ */
+struct monitor_control {
+	__u32 mode;	   /* enum monitor_mode */
+	__u32 sample_rate; /* Emit 1 in sample_rate events (0 or 1: all) */
 };
 
 #endif // RAVN_EVENTS_H
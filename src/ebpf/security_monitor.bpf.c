@@ -5,6 +5,8 @@
 #include <vmlinux.h>
 #include <bpf/bpf_helpers.h>
 
+#include "monitor_control.h"
+
 // Event structure for security events
 struct security_event {
 	__u64 timestamp;
@@ -16,6 +18,7 @@ struct security_event {
 	__u32 gid;
 	char comm[16];
 	char message[256];
+	__u64 cgroup_id;
 };
 
 // Ring buffer map
@@ -29,6 +32,11 @@ SEC("kprobe/security_inode_create")
 int trace_security_event(struct pt_regs* ctx __attribute__((unused))) {
 	struct security_event* event;
 
+	// Sampled out or aggregate-only events never reach the ring
+	if (!monitor_admit()) {
+		return 0;
+	}
+
 	// Reserve space in ring buffer
 	event = bpf_ringbuf_reserve(&security_events, sizeof(*event), 0);
 	if (!event) {
@@ -39,6 +47,7 @@ int trace_security_event(struct pt_regs* ctx __attribute__((unused))) {
 	event->timestamp = bpf_ktime_get_ns();
 	event->pid = bpf_get_current_pid_tgid() >> 32;
 	event->tid = bpf_get_current_pid_tgid() & 0xFFFFFFFF;
+	event->cgroup_id = bpf_get_current_cgroup_id();
 	event->event_type = 1; // File creation
 	event->severity = 2;   // Medium
 	event->uid = bpf_get_current_uid_gid() & 0xFFFFFFFF;
@@ -8,6 +8,8 @@
 #include <vmlinux.h>
 #include <bpf/bpf_helpers.h>
 
+#include "monitor_control.h"
+
 // Event structure for syscall events
 struct syscall_event {
 	__u64 timestamp;
@@ -18,6 +20,7 @@ struct syscall_event {
 	__s64 retval;
 	char comm[16];
 	char filename[256];
+	__u64 cgroup_id;
 };
 
 // Ring buffer map
@@ -31,6 +34,11 @@ SEC("kprobe/do_sys_openat2")
 int trace_syscall_enter(struct pt_regs* ctx __attribute__((unused))) {
 	struct syscall_event* event;
 
+	// Sampled out or aggregate-only events never reach the ring
+	if (!monitor_admit()) {
+		return 0;
+	}
+
 	// Reserve space in ring buffer
 	event = bpf_ringbuf_reserve(&syscall_events, sizeof(*event), 0);
 	if (!event) {
@@ -41,6 +49,7 @@ int trace_syscall_enter(struct pt_regs* ctx __attribute__((unused))) {
 	event->timestamp = bpf_ktime_get_ns();
 	event->pid = bpf_get_current_pid_tgid() >> 32;
 	event->tid = bpf_get_current_pid_tgid() & 0xFFFFFFFF;
+	event->cgroup_id = bpf_get_current_cgroup_id();
 	event->event_type = 257; // openat syscall number
 	event->syscall_nr = 257; // openat syscall number
 	event->retval = 0;
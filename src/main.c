@@ -19,10 +19,32 @@
  * 2. CLI mode: Interactive dashboard for real-time system status
  */
 
+#include "cli/dashboard.h"
 #include "daemon/ai_engine.h"
+#include "daemon/cgroup.h"
+#include "daemon/control.h"
 #include "daemon/ebpf_handler.h"
+#include "daemon/forward.h"
+#include "daemon/health.h"
+#include "daemon/governor.h"
+#include "daemon/overhead.h"
+#include "daemon/placement.h"
 #include "daemon/redis_client.h"
+#include "daemon/sketch.h"
+#include "daemon/status.h"
+#include "daemon/store.h"
+#include "daemon/trace.h"
+#include "tools/aibench.h"
+#include "tools/archive.h"
+#include "tools/batch.h"
+#include "tools/collector.h"
+#include "tools/ctl.h"
+#include "tools/query.h"
+#include "tools/loadgen.h"
+#include "tools/replay.h"
+#include "utils/hotmem.h"
 #include "utils/logger.h"
+#include "utils/profiler.h"
 #include "version.h"
 
 #include <errno.h>
@@ -37,12 +59,27 @@
 #include <time.h>
 #include <unistd.h>
 
+/*
+ * Daemon main loop period in seconds
+ */
+#define DAEMON_LOOP_INTERVAL 1
+
 /*
  * Global state variables for daemon lifecycle management
  */
-static int daemon_running = 0;		      /* Daemon running state flag */
-static redis_connection_t* redis_conn = NULL; /* Redis connection handle */
-static ai_engine_t* ai_engine = NULL;	      /* AI engine instance */
+static int daemon_running = 0;				 /* Daemon running state flag */
+static redis_connection_t* redis_conn = NULL;		 /* Redis connection handle */
+static redis_connection_t* publish_conn = NULL;		 /* Main loop publishers' connection */
+static ai_engine_t* ai_engine = NULL;			 /* AI engine instance */
+static volatile sig_atomic_t profile_dump_requested = 0; /* Profiler report pending */
+static const char* record_path = NULL;			 /* --record trace file */
+static uint64_t record_segment_size = 0;		 /* --record-size in bytes */
+static const char* store_path = NULL;			 /* --store directory */
+static uint32_t store_retention = STORE_DEFAULT_RETENTION; /* --retention in days */
+static enum hotmem_policy hot_memory = HOTMEM_POLICY_THP; /* --hugepages backing */
+static int hot_memory_lock = 1;				   /* mlock() hot regions */
+static const char* forward_target = NULL;		   /* --forward collector */
+static const char* forward_host = NULL;			   /* --host-name to forward as */
 
 /*
  * Global Redis connection pointer for eBPF handler
@@ -66,6 +103,59 @@ void signal_handler(int sig) {
 	/* AI thread cleanup is managed by AI engine module */
 }
 
+/**
+ * profile_signal_handler - Request a profiler report
+ * @sig: Signal number received (SIGUSR1)
+ *
+ * Only sets a flag; the daemon main loop writes the report outside of
+ * signal context.
+ *
+ * Context: Signal handler context (must be signal-safe)
+ */
+void profile_signal_handler(int sig) {
+	(void)sig;
+	profile_dump_requested = 1;
+}
+
+/**
+ * restart_ringbuf - Health monitor restart policy for the eBPF poller
+ *
+ * Return: 0 on success, -1 if the restart has to be retried
+ */
+static int restart_ringbuf(void) {
+	return ebpf_handler_restart_polling();
+}
+
+/**
+ * restart_ai - Health monitor restart policy for the AI thread
+ *
+ * Return: 0 on success, -1 if the restart has to be retried
+ */
+static int restart_ai(void) {
+	return ai_engine_restart_thread(ai_engine);
+}
+
+/**
+ * restart_redis - Health monitor restart policy for the Redis connection
+ *
+ * Reconnects the shared Redis connection in place. The eBPF handler and AI
+ * thread keep their pointer to it; the context behind it is swapped under
+ * the lock their commands hold, so none of them can be using the old one
+ * when it is freed.
+ *
+ * Return: 0 on success, -1 if the restart has to be retried
+ */
+static int restart_redis(void) {
+	LOG_INFO_MODULE("MAIN", "Redis connection lost, attempting to reconnect...");
+	if (redis_reconnect(redis_conn) != 0) {
+		LOG_INFO_MODULE("MAIN", "Failed to reconnect to Redis");
+		return -1;
+	}
+
+	LOG_INFO_MODULE("MAIN", "✓ Redis reconnection successful");
+	return 0;
+}
+
 /**
  * init_daemon - Initialize daemon components in layered architecture
  *
@@ -82,20 +172,59 @@ void signal_handler(int sig) {
 int init_daemon(void) {
 	LOG_INFO_MODULE("MAIN", "Initializing daemon components in layered architecture...");
 
+	// Thread placement must be known before the first daemon thread starts
+	placement_init();
+	hotmem_configure(hot_memory, hot_memory_lock);
+
+	// Container attribution of the cgroup IDs carried by every event
+	cgroup_init();
+
+	// Raw ring record capture must be ready before the first event arrives
+	if (record_path && trace_record_open(record_path, record_segment_size) != 0) {
+		LOG_ERROR_MODULE("MAIN", "Failed to open trace file %s", record_path);
+		return -1;
+	}
+	if (store_path && store_open(store_path, store_retention) != 0) {
+		LOG_ERROR_MODULE("MAIN", "Failed to open event store %s", store_path);
+		trace_record_close();
+		return -1;
+	}
+	if (forward_target && forward_open(forward_target, forward_host) != 0) {
+		LOG_ERROR_MODULE("MAIN", "Failed to start forwarding to %s", forward_target);
+		trace_record_close();
+		store_close();
+		return -1;
+	}
+
 	// Layer 1: Initialize eBPF handlers (lowest level - system monitoring)
+	// The rings are created from the consumer's CPUs, so the kernel allocates
+	// them on its NUMA node; the main thread moves to its own CPUs afterwards
 	LOG_INFO_MODULE("MAIN", "Layer 1: Initializing eBPF system monitoring...");
-	if (init_ebpf_handlers() != 0) {
+	placement_bind(PLACEMENT_RINGBUF);
+	int ebpf_result = init_ebpf_handlers();
+	placement_apply(PLACEMENT_MAIN);
+	if (ebpf_result != 0) {
 		LOG_ERROR_MODULE("MAIN", "Failed to initialize eBPF handlers");
+		trace_record_close();
+		store_close();
+		forward_close();
 		return -1;
 	}
 	LOG_INFO_MODULE("MAIN", "✓ eBPF handlers initialized");
 
+	// Account the cost of the monitors themselves (BPF + handler time)
+	overhead_init();
+	governor_init();
+
 	// Layer 2: Initialize Redis database (middle layer - data storage)
 	LOG_INFO_MODULE("MAIN", "Layer 2: Initializing Redis database connection...");
 	redis_conn = redis_connect("127.0.0.1", 6379);
 	if (!redis_conn) {
 		LOG_ERROR_MODULE("MAIN", "Failed to connect to Redis");
 		cleanup_ebpf_handlers(); // Cleanup eBPF layer
+		trace_record_close();
+		store_close();
+		forward_close();
 		return -1;
 	}
 	LOG_INFO_MODULE("MAIN", "✓ Redis database connected");
@@ -111,9 +240,13 @@ int init_daemon(void) {
 		LOG_ERROR_MODULE("MAIN", "Failed to initialize AI engine");
 		redis_disconnect(redis_conn); // Cleanup Redis layer
 		cleanup_ebpf_handlers();      // Cleanup eBPF layer
+		trace_record_close();
+		store_close();
+		forward_close();
 		return -1;
 	}
 	LOG_INFO_MODULE("MAIN", "✓ AI engine initialized");
+	hotmem_log();
 
 	// Start AI analysis thread as part of initialization
 	if (ai_engine_start_thread(ai_engine) != 0) {
@@ -121,10 +254,40 @@ int init_daemon(void) {
 		ai_engine_cleanup(ai_engine);
 		redis_disconnect(redis_conn);
 		cleanup_ebpf_handlers();
+		trace_record_close();
+		store_close();
+		forward_close();
 		return -1;
 	}
 	LOG_INFO_MODULE("MAIN", "✓ AI analysis thread started");
 
+	// Health monitor watches all layers and restarts stalled components
+	static const uint32_t stall_ms[HEALTH_COMPONENT_MAX] = {
+		[HEALTH_RINGBUF] = 10000, [HEALTH_AI] = 10000, [HEALTH_REDIS] = 3000};
+	static const health_restart_fn restart[HEALTH_COMPONENT_MAX] = {
+		[HEALTH_RINGBUF] = restart_ringbuf,
+		[HEALTH_AI] = restart_ai,
+		[HEALTH_REDIS] = restart_redis};
+	if (health_init(stall_ms, restart) != 0) {
+		LOG_WARN_MODULE("MAIN", "Health monitor unavailable, continuing without it");
+	} else {
+		LOG_INFO_MODULE("MAIN", "✓ Health monitor started");
+	}
+
+	// Live state for local readers, without going through Redis
+	if (status_init(ai_engine) != 0) {
+		LOG_WARN_MODULE("MAIN", "Status segment unavailable, continuing without it");
+	} else {
+		LOG_INFO_MODULE("MAIN", "✓ Status segment published at %s", STATUS_SHM_PATH);
+	}
+
+	// Queries of in-memory state and runtime control, see 'ravn ctl'
+	if (control_init(ai_engine) != 0) {
+		LOG_WARN_MODULE("MAIN", "Control socket unavailable, continuing without it");
+	} else {
+		LOG_INFO_MODULE("MAIN", "✓ Control socket listening at %s", CONTROL_SOCKET_PATH);
+	}
+
 	LOG_INFO_MODULE("MAIN", "✓ All layers initialized successfully");
 	return 0;
 }
@@ -143,6 +306,11 @@ int init_daemon(void) {
 void cleanup_daemon(void) {
 	LOG_INFO_MODULE("MAIN", "Cleaning up daemon components in reverse layered order...");
 
+	// Stop restart policies and the status thread before tearing the components down
+	health_cleanup();
+	status_cleanup();
+	control_cleanup();
+
 	// Layer 3: Cleanup AI engine (highest level first)
 	LOG_INFO_MODULE("MAIN", "Layer 3: Cleaning up AI analysis engine...");
 	// AI thread is managed by AI engine
@@ -161,15 +329,164 @@ void cleanup_daemon(void) {
 		global_redis_conn_ptr = NULL;
 		LOG_INFO_MODULE("MAIN", "✓ Redis database disconnected");
 	}
+	if (publish_conn) {
+		redis_disconnect(publish_conn);
+		publish_conn = NULL;
+	}
 
 	// Layer 1: Cleanup eBPF handlers (lowest level last)
 	LOG_INFO_MODULE("MAIN", "Layer 1: Cleaning up eBPF system monitoring...");
+	governor_cleanup();
+	overhead_cleanup();
 	cleanup_ebpf_handlers();
+	forward_close();
+	trace_record_close();
+	store_close();
+	cgroup_cleanup();
 	LOG_INFO_MODULE("MAIN", "✓ eBPF handlers cleaned up");
 
 	LOG_INFO_MODULE("MAIN", "✓ All layers cleaned up successfully");
 }
 
+/**
+ * publish_event_stats - Publish cumulative event counters
+ * @conn: Redis connection handle
+ *
+ * Writes the per-category event counts and network traffic totals kept by
+ * the event handlers to the REDIS_STATS_KEY hash in a single command, so
+ * the CLI dashboard reads them in O(1) regardless of how many events are
+ * retained in events:raw.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+static int publish_event_stats(redis_connection_t* conn) {
+	static struct redis_hash hash;
+	struct ebpf_monitor_stats stats[EVENT_CATEGORY_MAX + 1];
+	uint64_t total = 0, sent = 0, received = 0;
+
+	if (!conn) {
+		return -1;
+	}
+
+	ebpf_handler_get_monitor_stats(stats);
+	ebpf_handler_get_network_bytes(&sent, &received);
+
+	redis_hash_reset(&hash);
+	for (uint32_t cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		redis_hash_add(&hash, "%s_events", stats[cat].name, "%lu",
+			       (unsigned long)stats[cat].events);
+		total += stats[cat].events;
+	}
+	redis_hash_add(&hash, "%s", "events_total", "%lu", (unsigned long)total);
+	redis_hash_add(&hash, "%s", "net_bytes_sent", "%lu", (unsigned long)sent);
+	redis_hash_add(&hash, "%s", "net_bytes_received", "%lu", (unsigned long)received);
+	redis_hash_add(&hash, "%s", "updated", "%ld", (long)time(NULL));
+
+	return redis_hash_write(conn, REDIS_STATS_KEY, &hash);
+}
+
+/**
+ * publisher_connection - Get the Redis connection of the main loop publishers
+ *
+ * The publishers use their own connection, so their HSET and MULTI/EXEC
+ * exchanges never wait for the event path of the shared one. A broken
+ * connection is replaced on the next pass.
+ *
+ * Return: Connection handle, NULL while Redis is unreachable
+ */
+static redis_connection_t* publisher_connection(void) {
+	if (publish_conn && !redis_is_connected(publish_conn)) {
+		redis_disconnect(publish_conn);
+		publish_conn = NULL;
+	}
+	if (!publish_conn) {
+		publish_conn = redis_connect("127.0.0.1", 6379);
+	}
+	return publish_conn;
+}
+
+/**
+ * publish_sketches - Publish the activity sketches
+ * @conn: Redis connection handle
+ *
+ * Replaces the REDIS_SKETCH_PREFIX<dimension> sorted sets with the current
+ * heavy hitters (member = key, score = estimated count) and writes the
+ * distinct and total counts of every dimension to REDIS_SKETCH_SUMMARY.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+static int publish_sketches(redis_connection_t* conn) {
+	static struct redis_hash hash;
+	struct sketch_item items[SKETCH_TOP_K];
+	const char* members[SKETCH_TOP_K];
+	double scores[SKETCH_TOP_K];
+	char key[64];
+	int result = 0;
+
+	if (!conn) {
+		return -1;
+	}
+
+	redis_hash_reset(&hash);
+	for (int dim = 0; dim < SKETCH_DIMENSION_MAX; dim++) {
+		const char* name = sketch_dimension_name((enum sketch_dimension)dim);
+		int count = sketch_get_top((enum sketch_dimension)dim, items, SKETCH_TOP_K);
+		for (int i = 0; i < count; i++) {
+			members[i] = items[i].key;
+			scores[i] = (double)items[i].count;
+		}
+		snprintf(key, sizeof(key), "%s%s", REDIS_SKETCH_PREFIX, name);
+		if (redis_zset_replace(conn, key, members, scores, count) != 0) {
+			result = -1;
+		}
+
+		redis_hash_add(&hash, "%s_distinct", name, "%llu",
+			       (unsigned long long)sketch_distinct((enum sketch_dimension)dim));
+		redis_hash_add(&hash, "%s_total", name, "%llu",
+			       (unsigned long long)sketch_total((enum sketch_dimension)dim));
+	}
+
+	if (redis_hash_write(conn, REDIS_SKETCH_SUMMARY, &hash) != 0) {
+		result = -1;
+	}
+	return result;
+}
+
+/**
+ * publish_cgroups - Publish the per-cgroup verdicts of the AI window
+ * @conn: Redis connection handle
+ *
+ * Replaces the REDIS_CGROUP_KEY sorted set with one member per cgroup in
+ * the window, "<cgroup ID> <name>" scored by its threat score, the name
+ * being the container name or the last cgroup path component.
+ *
+ * Return: 0 on success, -1 on failure
+ */
+static int publish_cgroups(redis_connection_t* conn) {
+	static struct ai_cgroup_summary cgroups[MAX_PROCESSES];
+	static char names[MAX_PROCESSES][CGROUP_NAME_MAX + 24];
+	const char* members[MAX_PROCESSES];
+	double scores[MAX_PROCESSES];
+
+	if (!conn || !ai_engine) {
+		return -1;
+	}
+
+	int count = ai_engine_get_cgroups(ai_engine, cgroups, MAX_PROCESSES);
+	if (count < 0) {
+		return -1;
+	}
+	for (int i = 0; i < count; i++) {
+		struct cgroup_info info;
+		cgroup_lookup(cgroups[i].cgroup_id, &info);
+		snprintf(names[i], sizeof(names[i]), "%llu %s",
+			 (unsigned long long)cgroups[i].cgroup_id, info.resolved ? info.name : "?");
+		members[i] = names[i];
+		scores[i] = cgroups[i].threat_score;
+	}
+	return redis_zset_replace(conn, REDIS_CGROUP_KEY, members, scores, count);
+}
+
 /**
  * run_daemon_mode - Run daemon in continuous monitoring mode
  *
@@ -203,29 +520,43 @@ int run_daemon_mode(void) {
 
 	while (daemon_running) {
 		// The real event collection is now handled by the eBPF
-		// monitoring thread This main loop just keeps the daemon alive
-		// and monitors system health
-
-		// Check Redis connection health
-		if (redis_ping(redis_conn) != 0) {
-			LOG_INFO_MODULE("MAIN", "Redis connection lost, "
-						"attempting to reconnect...");
-			redis_disconnect(redis_conn);
-			redis_conn = redis_connect("127.0.0.1", 6379);
-			if (!redis_conn) {
-				LOG_INFO_MODULE("MAIN", "Failed to reconnect to Redis");
-				break;
+		// monitoring thread and component health (including Redis
+		// reconnection) by the health monitor thread
+
+		// Publish event counters for the CLI dashboard
+		redis_connection_t* publisher = publisher_connection();
+		publish_event_stats(publisher);
+		publish_sketches(publisher);
+		publish_cgroups(publisher);
+		forward_send_summary(ai_engine);
+
+		// Publish self-overhead of the monitoring since the last pass
+		struct overhead_report overhead;
+		int overhead_valid = overhead_sample(&overhead) == 0;
+		if (overhead_valid) {
+			overhead_publish(publisher, &overhead);
+			status_set_overhead(&overhead);
+			governor_update(&overhead);
+		}
+		governor_publish(publisher);
+
+		// Write profiler, overhead and health reports if requested via SIGUSR1
+		if (profile_dump_requested) {
+			profile_dump_requested = 0;
+			ravn_prof_dump();
+			health_log();
+			if (overhead_valid) {
+				overhead_log(&overhead);
 			}
-			// Update global Redis connection pointer for eBPF
-			// handler
-			global_redis_conn_ptr = redis_conn;
-			LOG_INFO_MODULE("MAIN", "✓ Redis reconnection successful, "
-						"global pointer updated");
 		}
 
-		// Sleep for a longer interval since real events are handled by
-		// eBPF thread
-		sleep(5); // Check every 5 seconds
+		// Real events are handled by the eBPF thread; this pass only
+		// publishes counters, so keep it short enough for the CLI refresh
+		sleep(DAEMON_LOOP_INTERVAL);
+	}
+
+	if (ravn_prof_enabled()) {
+		ravn_prof_dump();
 	}
 
 	cleanup_daemon();
@@ -240,370 +571,21 @@ int run_daemon_mode(void) {
  *
  * Features:
  * - Real-time threat level display with color coding
- * - System status monitoring (Redis, eBPF, AI)
- * - Live metrics dashboard (events, uptime, memory usage)
+ * - System status monitoring (Redis, eBPF, AI, health)
+ * - Live metrics dashboard (events, rates, uptime, memory usage)
  * - Activity feed showing recent system events
- * - Professional TUI interface with Unicode box drawing
+ * - Flicker-free rendering that only redraws changed cells
  *
- * The dashboard updates every 2 seconds and displays:
- * - Current threat level and score
- * - System component status
- * - Event counters and system metrics
- * - Recent activity feed
+ * Live state is read from the daemon's status segment when available and
+ * from Redis otherwise; see src/cli/dashboard.h.
  *
- * Return: 0 on normal exit, -1 on Redis connection failure
+ * Return: 0 on normal exit, -1 on terminal failure
  */
 int run_cli_mode(void) {
 	LOG_INFO_MODULE("MAIN", "Starting CLI mode...");
 
-	// Connect to Redis to read data
-	redis_conn = redis_connect("127.0.0.1", 6379);
-	if (!redis_conn) {
-		LOG_ERROR_MODULE("MAIN", "Failed to connect to Redis");
-		return -1;
-	}
-
-	// Initialize cutting-edge UI
-	printf("\033[2J\033[H");      // Clear screen
-	printf("\033[1;37m\033[40m"); // White text on black background
-
-	int display_counter = 0;
-	while (1) {
-		// Clear screen and set up professional layout
-		printf("\033[2J\033[H"); // Clear screen and move cursor to top
-
-		// Professional header with gradient effect
-		printf("\033[1;37m\033[40m");
-		printf("╔══════════════════════════════════════════════════════"
-		       "════════════════════════╗\n");
-		printf("║\033[1;36m                           RAVN SECURITY "
-		       "PLATFORM v2.0\033[1;37m                           ║\n");
-		printf("║\033[1;33m                        Real-time Threat "
-		       "Detection & Analysis\033[1;37m                      "
-		       "║\n");
-		printf("╚══════════════════════════════════════════════════════"
-		       "════════════════════════╝\n");
-
-		// Get current time for display
-		time_t current_time = time(NULL);
-		struct tm* tm_info = localtime(&current_time);
-		char time_str[64];
-		strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", tm_info);
-
-		// Status bar
-		printf("\033[1;37m┌─ STATUS "
-		       "───────────────────────────────────────────────────────"
-		       "──────────────────┐\n");
-		printf("│ \033[1;32m● LIVE\033[1;37m │ \033[1;36m%s\033[1;37m "
-		       "│ \033[1;33mPress Ctrl+C to exit\033[1;37m │\n",
-		       time_str);
-		printf("└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘\n");
-
-		// Main dashboard grid
-		printf("\033[1;37m┌─ THREAT ASSESSMENT "
-		       "───────────────────────────────────────────────────────"
-		       "──────┐\n");
-
-		// Get latest threat level
-		threat_level_t threat_level;
-		if (redis_get_threat_level(redis_conn, &threat_level) == 0) {
-			const char* level_str = (threat_level.level == THREAT_HIGH)	? "CRITICAL"
-						: (threat_level.level == THREAT_MEDIUM) ? "ELEVATED"
-											: "NORMAL";
-
-			// Professional color coding
-			const char* color =
-				(threat_level.level == THREAT_HIGH) ? "\033[1;31m" : // Red
-					(threat_level.level == THREAT_MEDIUM) ? "\033[1;33m"
-									      : // Yellow
-					"\033[1;32m";				// Green
-
-			// Threat level with progress bar
-			printf("│ \033[1;37mThreat Level: "
-			       "\033[0m%s%s\033[1;37m │ Score: "
-			       "\033[1;36m%.3f\033[1;37m │ ",
-			       color, level_str, threat_level.score);
-
-			// Progress bar for threat score
-			int bar_length = 20;
-			int filled = (int)(threat_level.score * bar_length);
-			printf("[\033[1;32m");
-			for (int i = 0; i < filled; i++)
-				printf("█");
-			printf("\033[1;30m");
-			for (int i = filled; i < bar_length; i++)
-				printf("░");
-			printf("\033[1;37m] │\n");
-
-			// Threat reason
-			printf("│ \033[1;37mAnalysis: \033[1;33m%s\033[1;37m "
-			       "│\n",
-			       threat_level.reason);
-		} else {
-			printf("│ \033[1;37mThreat Level: \033[1;30mNO "
-			       "DATA\033[1;37m │ Score: "
-			       "\033[1;30mN/A\033[1;37m │ "
-			       "[\033[1;30m░░░░░░░░░░░░░░░░░░░░\033[1;37m] "
-			       "│\n");
-			printf("│ \033[1;37mAnalysis: \033[1;30mWaiting for "
-			       "data...\033[1;37m │\n");
-		}
-		printf("└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘\n");
-
-		// System Status Grid
-		printf("\033[1;37m┌─ SYSTEM STATUS "
-		       "───────────────────────────────────────────────────────"
-		       "─────────┐\n");
-
-		// Redis connection status
-		printf("│ \033[1;37mRedis: \033[0m");
-		if (redis_ping(redis_conn) == 0) {
-			printf("\033[1;32m● CONNECTED\033[1;37m │ ");
-		} else {
-			printf("\033[1;31m● DISCONNECTED\033[1;37m │ ");
-		}
-
-		// eBPF status
-		printf("\033[1;37meBPF: \033[1;32m● ACTIVE\033[1;37m │ ");
-
-		// AI status
-		printf("\033[1;37mAI: \033[1;32m● ANALYZING\033[1;37m │\n");
-		printf("└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘\n");
-
-		// Enhanced Metrics Dashboard
-		printf("\033[1;37m┌─ METRICS DASHBOARD "
-		       "───────────────────────────────────────────────────────"
-		       "───┐\n");
-
-		// Get event count from Redis
-		redisReply* reply = redisCommand(redis_conn->context, "LLEN events:raw");
-		long long event_count = 0;
-		if (reply && reply->type == REDIS_REPLY_INTEGER) {
-			event_count = reply->integer;
-		}
-		if (reply)
-			freeReplyObject(reply);
-
-		// Event counter with animation
-		printf("│ \033[1;37mEvents: \033[1;36m%lld\033[1;37m │ ", event_count);
-
-		// System uptime
-		FILE* uptime_file = fopen("/proc/uptime", "r");
-		if (uptime_file) {
-			double uptime;
-			if (fscanf(uptime_file, "%lf", &uptime) == 1) {
-				int hours = (int)(uptime / 3600);
-				int minutes = (int)((uptime - hours * 3600) / 60);
-				printf("\033[1;37mUptime: \033[1;33m%02dh "
-				       "%02dm\033[1;37m │ ",
-				       hours, minutes);
-			}
-			fclose(uptime_file);
-		}
-
-		// Memory usage
-		FILE* mem_file = fopen("/proc/meminfo", "r");
-		if (mem_file) {
-			char line[256];
-			long total_mem = 0, free_mem = 0;
-			while (fgets(line, sizeof(line), mem_file)) {
-				if (sscanf(line, "MemTotal: %ld kB", &total_mem) == 1)
-					continue;
-				if (sscanf(line, "MemAvailable: %ld kB", &free_mem) == 1)
-					break;
-			}
-			fclose(mem_file);
-			if (total_mem > 0) {
-				float mem_usage =
-					((float)(total_mem - free_mem) / total_mem) * 100.0;
-				printf("\033[1;37mMemory: "
-				       "\033[1;35m%.1f%%\033[1;37m │\n",
-				       mem_usage);
-			}
-		}
-
-		// eBPF Statistics Section
-		printf("│ \033[1;37m┌─ eBPF MONITORING STATISTICS "
-		       "─────────────────────────────────────────────┐\033[1;"
-		       "37m │\n");
-
-		// Get eBPF event statistics from Redis
-		long long syscall_events = 0, network_events = 0, security_events = 0,
-			  file_events = 0;
-		long long total_bytes_sent = 0, total_bytes_received = 0;
-
-		// Count events by category
-		reply = redisCommand(redis_conn->context, "LRANGE events:raw 0 -1");
-		if (reply && reply->type == REDIS_REPLY_ARRAY) {
-			for (size_t i = 0; i < reply->elements; i++) {
-				if (reply->element[i]->type == REDIS_REPLY_STRING) {
-					char* data = reply->element[i]->str;
-					if (strstr(data, "\"event_category\":1"))
-						syscall_events++;
-					else if (strstr(data, "\"event_"
-							      "category\":2")) {
-						network_events++;
-						// Extract bytes sent/received
-						// from network events
-						char* bytes_sent_str =
-							strstr(data, "\"bytes_sent\":");
-						char* bytes_recv_str =
-							strstr(data, "\"bytes_received\":");
-						if (bytes_sent_str) {
-							long long bytes = 0;
-							sscanf(bytes_sent_str,
-							       "\"bytes_sent\":"
-							       "%lld",
-							       &bytes);
-							total_bytes_sent += bytes;
-						}
-						if (bytes_recv_str) {
-							long long bytes = 0;
-							sscanf(bytes_recv_str,
-							       "\"bytes_"
-							       "received\":%"
-							       "lld",
-							       &bytes);
-							total_bytes_received += bytes;
-						}
-					} else if (strstr(data, "\"event_"
-								"category\":3"))
-						security_events++;
-					else if (strstr(data, "\"event_category\":4"))
-						file_events++;
-				}
-			}
-		}
-		if (reply)
-			freeReplyObject(reply);
-
-		// Display eBPF statistics
-		printf("│ │ \033[1;37mSyscalls: \033[1;36m%lld\033[1;37m │ "
-		       "\033[1;37mNetwork: \033[1;33m%lld\033[1;37m │ "
-		       "\033[1;37mSecurity: \033[1;31m%lld\033[1;37m │ "
-		       "\033[1;37mFile I/O: \033[1;35m%lld\033[1;37m │ │\n",
-		       syscall_events, network_events, security_events, file_events);
-
-		// Network traffic statistics
-		printf("│ │ \033[1;37mNetwork Traffic: \033[1;32m↑%.2f "
-		       "KB\033[1;37m │ \033[1;37m↓%.2f KB\033[1;37m │ "
-		       "\033[1;37mTotal: \033[1;36m%.2f KB\033[1;37m │ │\n",
-		       total_bytes_sent / 1024.0, total_bytes_received / 1024.0,
-		       (total_bytes_sent + total_bytes_received) / 1024.0);
-
-		printf("│ "
-		       "└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘ │\n");
-
-		// AI Analysis Statistics
-		printf("│ \033[1;37m┌─ AI ANALYSIS STATISTICS "
-		       "─────────────────────────────────────────────────┐\033["
-		       "1;37m │\n");
-
-		// Get sliding window information from Redis (if available)
-		reply = redisCommand(redis_conn->context, "GET ai:sliding_window");
-		if (reply && reply->type == REDIS_REPLY_STRING) {
-			printf("│ │ \033[1;37mSliding Window: \033[1;32m● "
-			       "ACTIVE\033[1;37m │ \033[1;37mData: "
-			       "\033[1;36m%s\033[1;37m │ │\n",
-			       reply->str);
-		} else {
-			printf("│ │ \033[1;37mSliding Window: \033[1;32m● "
-			       "ACTIVE\033[1;37m │ \033[1;37mWindow Size: "
-			       "\033[1;36m10s\033[1;37m │ \033[1;37mInterval: "
-			       "\033[1;36m1s\033[1;37m │ │\n");
-		}
-		if (reply)
-			freeReplyObject(reply);
-
-		// Score update frequency
-		static int score_update_count = 0;
-		static time_t last_score_time = 0;
-		time_t score_time = time(NULL);
-		if (score_time != last_score_time) {
-			score_update_count++;
-			last_score_time = score_time;
-		}
-
-		printf("│ │ \033[1;37mScore Updates: \033[1;33m%d\033[1;37m │ "
-		       "\033[1;37mAnalysis Rate: \033[1;36m2Hz\033[1;37m │ "
-		       "\033[1;37mModel: \033[1;32mLSTM\033[1;37m │ │\n",
-		       score_update_count);
-		printf("│ "
-		       "└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘ │\n");
-
-		// Monitoring programs status
-		printf("│ \033[1;37mCPU Monitor: \033[1;32m●\033[1;37m │ Load "
-		       "Monitor: \033[1;32m●\033[1;37m │ Memory Monitor: "
-		       "\033[1;32m●\033[1;37m │ System Monitor: "
-		       "\033[1;32m●\033[1;37m │\n");
-		printf("└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘\n");
-
-		// Real-time activity feed
-		printf("\033[1;37m┌─ ACTIVITY FEED "
-		       "───────────────────────────────────────────────────────"
-		       "────────┐\n");
-
-		// Get latest events for activity display
-		reply = redisCommand(redis_conn->context, "LRANGE events:raw 0 4");
-		if (reply && reply->type == REDIS_REPLY_ARRAY) {
-			for (size_t i = 0; i < reply->elements && i < 3; i++) {
-				if (reply->element[i]->type == REDIS_REPLY_STRING) {
-					char* data = reply->element[i]->str;
-					if (strstr(data, "\"event_type\":1")) {
-						printf("│ \033[1;37m[CPU] "
-						       "\033[1;36mSystem "
-						       "activity "
-						       "detected\033[1;37m │ "
-						       "\033[1;30m%s\033[1;37m "
-						       "│\n",
-						       time_str);
-					} else if (strstr(data, "\"event_type\":2")) {
-						printf("│ \033[1;37m[LOAD] "
-						       "\033[1;33mLoad average "
-						       "updated\033[1;37m │ "
-						       "\033[1;30m%s\033[1;37m "
-						       "│\n",
-						       time_str);
-					} else if (strstr(data, "\"event_type\":3")) {
-						printf("│ \033[1;37m[MEM] "
-						       "\033[1;35mMemory usage "
-						       "tracked\033[1;37m │ "
-						       "\033[1;30m%s\033[1;37m "
-						       "│\n",
-						       time_str);
-					}
-				}
-			}
-		}
-		if (reply)
-			freeReplyObject(reply);
-
-		printf("└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘\n");
-
-		// Footer
-		printf("\033[1;37m┌─ RAVN v2.0 "
-		       "───────────────────────────────────────────────────────"
-		       "───────────┐\n");
-		printf("│ \033[1;30mReal-time eBPF monitoring │ AI-powered "
-		       "threat detection │ Professional SOC\033[1;37m │\n");
-		printf("└──────────────────────────────────────────────────────"
-		       "───────────────────────────┘\n");
-
-		printf("\033[0m"); // Reset colors
-		fflush(stdout);
-		display_counter++;
-		sleep(2);
-	}
-
-	redis_disconnect(redis_conn);
-	return 0;
+	// The dashboard connects to Redis itself and runs without it
+	return dashboard_run("127.0.0.1", 6379);
 }
 
 /**
@@ -619,12 +601,52 @@ void print_usage(const char* progname) {
 	printf("\nModes:\n");
 	printf("  daemon, d    Run in daemon mode (monitoring)\n");
 	printf("  cli, c       Run in CLI mode (dashboard)\n");
+	printf("  loadgen      Generate synthetic monitor load (loadgen -h for options)\n");
+	printf("  replay       Replay a recorded trace through the pipeline (replay -h)\n");
+	printf("  batch        Re-score a recorded trace offline on all cores (batch -h)\n");
+	printf("  query        Search events stored with --store on all cores (query -h)\n");
+	printf("  archive      Pack closed stored segments to save disk (archive -h)\n");
+	printf("  aibench      Benchmark the AI engine on a virtual clock (aibench -h)\n");
+	printf("  ctl          Query or control a running daemon (ctl -h)\n");
+	printf("  collector    Merge the events forwarded by a fleet of daemons (collector -h)\n");
 	printf("\nOptions:\n");
 	printf("  -h, --help   Show this help message\n");
 	printf("  -v, --version Show version information\n");
+	printf("  -p, --profile Enable timer profiling (report on SIGUSR1 and exit)\n");
+	printf("  -r, --record FILE  Record raw ring records to FILE (daemon mode)\n");
+	printf("  -S, --record-size MB  Rotate the trace every MB megabytes (default 64)\n");
+	printf("  -d, --store DIR    Store all events as columnar segments in DIR (daemon mode)\n");
+	printf("  -R, --retention DAYS  Delete stored segments after DAYS days (default %d, 0 = never)\n",
+	       STORE_DEFAULT_RETENTION);
+	printf("  -H, --hugepages MODE  Hot memory: thp (default), hugetlb or heap (daemon mode)\n");
+	printf("  -U, --no-mlock     Do not lock hot memory in RAM (daemon mode)\n");
+	printf("  -F, --forward HOST[:PORT]  Also forward all events to a collector (daemon mode, "
+	       "default port %d)\n",
+	       FORWARD_DEFAULT_PORT);
+	printf("  -N, --host-name NAME  Host name to forward as (default: the system host name)\n");
+	printf("  -B, --budget user=PCT,bpf=PCT  Cap the monitoring cost in %% of one core "
+	       "(daemon mode)\n");
+	printf("  -c, --cpus CLASS=CPUS  Pin a thread class to CPUs (2-3,6 or node1) (daemon mode)\n");
+	printf("  -s, --sched CLASS=POLICY  Thread class policy: fifo[:PRIO], rr[:PRIO], "
+	       "other[:NICE], batch[:NICE], idle\n");
+	printf("               CLASS is main, ringbuf, ai or background (default: ringbuf=%s, "
+	       "ai=%s)\n",
+	       PLACEMENT_DEFAULT_RINGBUF, PLACEMENT_DEFAULT_AI);
 	printf("\nExamples:\n");
 	printf("  %s daemon    # Start monitoring daemon\n", progname);
 	printf("  %s cli       # Start CLI dashboard\n", progname);
+	printf("  %s -B user=2,bpf=1 daemon\n", progname);
+	printf("  %s -c ringbuf=node0 -s ringbuf=fifo:20 -c ai=8-15 -s ai=idle daemon\n", progname);
+	printf("  %s loadgen -t 4 -d 30 -r 5000 -g open,mmap\n", progname);
+	printf("  %s replay -s 10 ravn.trace\n", progname);
+	printf("  %s batch -j 16 -o incident/ ravn.trace\n", progname);
+	printf("  %s query -e exec -u 0 -f 02:00 -t 02:10 -n 'nc*' /var/lib/ravn/events\n",
+	       progname);
+	printf("  %s archive -V /var/lib/ravn/events\n", progname);
+	printf("  %s aibench -p 80 -r 5000 -d 20\n", progname);
+	printf("  %s ctl top 5\n", progname);
+	printf("  %s collector -d /var/lib/ravn/fleet\n", progname);
+	printf("  %s -F collector.example.com daemon\n", progname);
 	printf("  %s -h        # Show help\n", progname);
 }
 
@@ -664,6 +686,13 @@ void print_version(void) {
  * Supported modes:
  * - daemon/d: Run continuous monitoring daemon
  * - cli/c: Run interactive CLI dashboard
+ * - loadgen: Generate synthetic monitor load
+ * - replay: Replay a recorded trace through the pipeline
+ * - batch: Re-score a recorded trace offline
+ * - query: Search stored event segments
+ * - archive: Pack closed event store segments
+ * - aibench: Benchmark the AI engine on a virtual clock
+ * - collector: Merge the events forwarded by a fleet of daemons
  *
  * Return: 0 on success, 1 on error
  */
@@ -672,11 +701,25 @@ int main(int argc, char* argv[]) {
 	char* mode = NULL;
 
 	// Long options
-	static struct option long_options[] = {
-		{"help", no_argument, 0, 'h'}, {"version", no_argument, 0, 'v'}, {0, 0, 0, 0}};
+	static struct option long_options[] = {{"help", no_argument, 0, 'h'},
+					       {"version", no_argument, 0, 'v'},
+					       {"profile", no_argument, 0, 'p'},
+					       {"record", required_argument, 0, 'r'},
+					       {"record-size", required_argument, 0, 'S'},
+					       {"store", required_argument, 0, 'd'},
+					       {"retention", required_argument, 0, 'R'},
+					       {"hugepages", required_argument, 0, 'H'},
+					       {"no-mlock", no_argument, 0, 'U'},
+					       {"forward", required_argument, 0, 'F'},
+					       {"host-name", required_argument, 0, 'N'},
+					       {"budget", required_argument, 0, 'B'},
+					       {"cpus", required_argument, 0, 'c'},
+					       {"sched", required_argument, 0, 's'},
+					       {0, 0, 0, 0}};
+	int enable_profiling = 0;
 
 	// Parse command line arguments
-	while ((opt = getopt_long(argc, argv, "hv", long_options, NULL)) != -1) {
+	while ((opt = getopt_long(argc, argv, "+hvpr:S:d:R:H:UF:N:B:c:s:", long_options, NULL)) != -1) {
 		switch (opt) {
 		case 'h':
 			print_usage(argv[0]);
@@ -684,6 +727,54 @@ int main(int argc, char* argv[]) {
 		case 'v':
 			print_version();
 			return 0;
+		case 'p':
+			enable_profiling = 1;
+			break;
+		case 'r':
+			record_path = optarg;
+			break;
+		case 'S':
+			record_segment_size = strtoull(optarg, NULL, 10) << 20;
+			break;
+		case 'd':
+			store_path = optarg;
+			break;
+		case 'R':
+			store_retention = (uint32_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'H':
+			if (hotmem_parse_policy(optarg, &hot_memory) != 0) {
+				fprintf(stderr, "Invalid huge page mode '%s'\n", optarg);
+				return 1;
+			}
+			break;
+		case 'U':
+			hot_memory_lock = 0;
+			break;
+		case 'F':
+			forward_target = optarg;
+			break;
+		case 'N':
+			forward_host = optarg;
+			break;
+		case 'B':
+			if (governor_set_budget(optarg) != 0) {
+				fprintf(stderr, "Invalid CPU budget '%s'\n", optarg);
+				return 1;
+			}
+			break;
+		case 'c':
+			if (placement_set_cpus(optarg) != 0) {
+				fprintf(stderr, "Invalid CPU set '%s'\n", optarg);
+				return 1;
+			}
+			break;
+		case 's':
+			if (placement_set_policy(optarg) != 0) {
+				fprintf(stderr, "Invalid scheduling policy '%s'\n", optarg);
+				return 1;
+			}
+			break;
 		default:
 			print_usage(argv[0]);
 			return 1;
@@ -706,9 +797,16 @@ int main(int argc, char* argv[]) {
 
 	LOG_INFO("RAVN Security Platform starting - Mode: %s", mode);
 
+	// Enable profiling from --profile or RAVN_PROFILE=1
+	ravn_prof_init();
+	if (enable_profiling) {
+		ravn_prof_set_enabled(1);
+	}
+
 	// Setup signal handlers
 	signal(SIGINT, signal_handler);
 	signal(SIGTERM, signal_handler);
+	signal(SIGUSR1, profile_signal_handler);
 
 	// Run in appropriate mode
 	int result;
@@ -716,6 +814,22 @@ int main(int argc, char* argv[]) {
 		result = run_daemon_mode();
 	} else if (strcmp(mode, "cli") == 0 || strcmp(mode, "c") == 0) {
 		result = run_cli_mode();
+	} else if (strcmp(mode, "loadgen") == 0) {
+		result = loadgen_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "replay") == 0) {
+		result = replay_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "batch") == 0) {
+		result = batch_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "query") == 0) {
+		result = query_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "archive") == 0) {
+		result = archive_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "aibench") == 0) {
+		result = aibench_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "ctl") == 0) {
+		result = ctl_main(argc - optind, argv + optind);
+	} else if (strcmp(mode, "collector") == 0) {
+		result = collector_main(argc - optind, argv + optind);
 	} else {
 		LOG_ERROR("Unknown mode: %s", mode);
 		print_usage(argv[0]);
@@ -0,0 +1,327 @@
+// RAVN AI Benchmark Harness Implementation
+// Reproducible AI engine runs on synthetic streams and a virtual clock
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "aibench.h"
+
+#include "../daemon/ai_engine.h"
+#include "../daemon/ebpf_handler.h"
+#include "../utils/hotmem.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <getopt.h>
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Harness options
+static int cfg_processes = AIBENCH_DEFAULT_PROCESSES;
+static int cfg_rate = AIBENCH_DEFAULT_RATE;
+static int cfg_duration = AIBENCH_DEFAULT_DURATION;
+static int cfg_runs = AIBENCH_DEFAULT_RUNS;
+static int cfg_attackers = AIBENCH_DEFAULT_ATTACKERS;
+static uint64_t cfg_seed = 1;
+static const char* cfg_model = "models/ravn_model.bin";
+static enum hotmem_policy cfg_memory[HOTMEM_POLICY_MAX] = {HOTMEM_POLICY_HEAP};
+static int cfg_memory_count = 1;
+
+// Result of one run
+struct aibench_run {
+	uint64_t events;
+	uint64_t wall_ns;
+	uint64_t checksum; /* FNV-1a over the score bit patterns */
+	uint64_t high;	   /* Events scored above 0.7 */
+	float max_score;
+	float window_score;
+	char window_level[16];
+	int64_t tlb_misses;		/* Data TLB read misses, -1 if not counted */
+	enum hotmem_backing backing; /* Memory of the engine */
+	size_t huge_bytes;		/* Engine bytes on huge pages */
+};
+
+// Virtual clock read by the engine
+static uint64_t virtual_clock(void* ctx) {
+	return *(const uint64_t*)ctx;
+}
+
+// xorshift64* step: small, fast and identical everywhere
+static uint64_t next_random(uint64_t* state) {
+	*state ^= *state >> 12;
+	*state ^= *state << 25;
+	*state ^= *state >> 27;
+	return *state * 2685821657736338717ULL;
+}
+
+// Fold a score into the run checksum
+static uint64_t checksum_score(uint64_t hash, float score) {
+	uint32_t bits;
+	memcpy(&bits, &score, sizeof(bits));
+	for (int i = 0; i < 4; i++) {
+		hash ^= (bits >> (i * 8)) & 0xFF;
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// Open a counter of the calling thread's data TLB read misses, -1 if unavailable
+static int open_tlb_counter(void) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HW_CACHE;
+	attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+		      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// Run the synthetic stream through a fresh engine
+static int run_stream(struct aibench_run* run) {
+	ai_engine_t* engine = ai_engine_init(cfg_model);
+	if (!engine) {
+		return -1;
+	}
+
+	uint64_t now = 1000000000ULL; // Virtual time starts at 1 s
+	ai_engine_set_clock(engine, virtual_clock, &now);
+
+	uint64_t state = cfg_seed ? cfg_seed : 1;
+	uint64_t step = 1000000000ULL / (uint64_t)cfg_rate;
+	uint64_t total = (uint64_t)cfg_rate * (uint64_t)cfg_duration;
+
+	struct ravn_event event;
+	memset(&event, 0, sizeof(event));
+	memset(run, 0, sizeof(*run));
+	run->checksum = 14695981039346656037ULL;
+
+	int tlb_fd = open_tlb_counter();
+	if (tlb_fd >= 0) {
+		ioctl(tlb_fd, PERF_EVENT_IOC_RESET, 0);
+		ioctl(tlb_fd, PERF_EVENT_IOC_ENABLE, 0);
+	}
+	uint64_t start = ravn_prof_now_ns();
+	for (uint64_t i = 0; i < total; i++) {
+		uint64_t r = next_random(&state);
+
+		// Attackers issue bursts of file operations, the rest is mixed
+		if (cfg_attackers > 0 && (r % 100) < AIBENCH_ATTACK_SHARE) {
+			event.pid = AIBENCH_BASE_PID + (uint32_t)((r >> 8) % cfg_attackers);
+			event.event_type = 2 + (uint32_t)((r >> 16) & 1);
+		} else {
+			event.pid = AIBENCH_BASE_PID + cfg_attackers +
+				    (uint32_t)((r >> 8) % (uint64_t)cfg_processes);
+			event.event_type = (uint32_t)((r >> 16) % AIBENCH_EVENT_TYPES);
+		}
+		event.event_category = 1 + (uint32_t)((r >> 24) % EVENT_CATEGORY_MAX);
+		event.timestamp = now;
+
+		float score = ai_engine_analyze_event(engine, &event);
+		run->checksum = checksum_score(run->checksum, score);
+		if (score > 0.7f) {
+			run->high++;
+		}
+		if (score > run->max_score) {
+			run->max_score = score;
+		}
+
+		now += step;
+	}
+	run->wall_ns = ravn_prof_now_ns() - start;
+	run->events = total;
+	run->tlb_misses = -1;
+	if (tlb_fd >= 0) {
+		uint64_t misses;
+		ioctl(tlb_fd, PERF_EVENT_IOC_DISABLE, 0);
+		if (read(tlb_fd, &misses, sizeof(misses)) == sizeof(misses)) {
+			run->tlb_misses = (int64_t)misses;
+		}
+		close(tlb_fd);
+	}
+	run->backing = hotmem_find(engine, NULL);
+	run->huge_bytes = hotmem_huge_bytes(engine);
+	run->window_score = engine->window.overall_threat_score;
+	snprintf(run->window_level, sizeof(run->window_level), "%s",
+		 engine->window.threat_level_str);
+
+	ai_engine_cleanup(engine);
+	return 0;
+}
+
+// Print per-stage timings from the AI engine profiler sites
+static void print_stages(void) {
+	struct ravn_prof_stats stats[64];
+	int n = ravn_prof_snapshot(stats, 64);
+
+	printf("\n%-34s %10s %10s %10s %10s %10s\n", "STAGE", "CALLS", "MEAN NS", "P50 NS",
+	       "P99 NS", "MAX NS");
+	int shown = 0;
+	for (int i = 0; i < n; i++) {
+		if (strcmp(stats[i].module, "AI-ENGINE") != 0 || stats[i].count == 0) {
+			continue;
+		}
+		printf("%-34s %10lu %10lu %10lu %10lu %10lu\n", stats[i].name,
+		       (unsigned long)stats[i].count,
+		       (unsigned long)(stats[i].total_ns / stats[i].count),
+		       (unsigned long)ravn_prof_percentile_ns(&stats[i], 50.0),
+		       (unsigned long)ravn_prof_percentile_ns(&stats[i], 99.0),
+		       (unsigned long)stats[i].max_ns);
+		shown++;
+	}
+	if (shown == 0) {
+		printf("(no stage timings: build with PROFILING=1)\n");
+	}
+}
+
+// Print harness usage
+static void aibench_usage(void) {
+	printf("Usage: ravn aibench [OPTIONS]\n");
+	printf("\nOptions:\n");
+	printf("  -p, --processes N    Benign processes in the stream (default %d)\n",
+	       AIBENCH_DEFAULT_PROCESSES);
+	printf("  -a, --attackers N    File-burst processes (default %d)\n",
+	       AIBENCH_DEFAULT_ATTACKERS);
+	printf("  -r, --rate EPS       Virtual events per second (default %d)\n",
+	       AIBENCH_DEFAULT_RATE);
+	printf("  -d, --duration SEC   Virtual seconds per run (default %d)\n",
+	       AIBENCH_DEFAULT_DURATION);
+	printf("  -n, --runs N         Repeated runs on fresh engines (default %d)\n",
+	       AIBENCH_DEFAULT_RUNS);
+	printf("  -s, --seed N         Stream seed (default 1)\n");
+	printf("  -m, --model PATH     AI model (default models/ravn_model.bin)\n");
+	printf("  -M, --memory MODE    Engine memory: heap (default), thp, hugetlb or all\n");
+	printf("\nThe engine runs on a virtual clock, so scores and checksums depend only\n");
+	printf("on the options; compare them across builds to catch behavior changes,\n");
+	printf("and the stage timings to catch performance regressions. --memory all\n");
+	printf("repeats the runs per memory backing and counts data TLB misses.\n");
+}
+
+// Run the AI benchmark harness
+int aibench_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"processes", required_argument, 0, 'p'},
+					       {"attackers", required_argument, 0, 'a'},
+					       {"rate", required_argument, 0, 'r'},
+					       {"duration", required_argument, 0, 'd'},
+					       {"runs", required_argument, 0, 'n'},
+					       {"seed", required_argument, 0, 's'},
+					       {"model", required_argument, 0, 'm'},
+					       {"memory", required_argument, 0, 'M'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	int opt;
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "p:a:r:d:n:s:m:M:h", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 'p':
+			cfg_processes = atoi(optarg);
+			break;
+		case 'a':
+			cfg_attackers = atoi(optarg);
+			break;
+		case 'r':
+			cfg_rate = atoi(optarg);
+			break;
+		case 'd':
+			cfg_duration = atoi(optarg);
+			break;
+		case 'n':
+			cfg_runs = atoi(optarg);
+			break;
+		case 's':
+			cfg_seed = strtoull(optarg, NULL, 0);
+			break;
+		case 'm':
+			cfg_model = optarg;
+			break;
+		case 'M':
+			if (strcmp(optarg, "all") == 0) {
+				for (int m = 0; m < HOTMEM_POLICY_MAX; m++) {
+					cfg_memory[m] = (enum hotmem_policy)m;
+				}
+				cfg_memory_count = HOTMEM_POLICY_MAX;
+			} else if (hotmem_parse_policy(optarg, &cfg_memory[0]) == 0) {
+				cfg_memory_count = 1;
+			} else {
+				aibench_usage();
+				return 1;
+			}
+			break;
+		case 'h':
+			aibench_usage();
+			return 0;
+		default:
+			aibench_usage();
+			return 1;
+		}
+	}
+
+	if (cfg_processes <= 0 || cfg_attackers < 0 || cfg_rate <= 0 || cfg_rate > 1000000000 ||
+	    cfg_duration <= 0 || cfg_runs <= 0) {
+		aibench_usage();
+		return 1;
+	}
+
+	// Engine setup logs at INFO on every run
+	logger_set_level(LOG_LEVEL_WARN);
+	int was_profiling = ravn_prof_enabled();
+	ravn_prof_set_enabled(1);
+
+	printf("Stream: %d benign + %d attacker process(es), %d events/s for %d s virtual, "
+	       "seed %lu\n",
+	       cfg_processes, cfg_attackers, cfg_rate, cfg_duration, (unsigned long)cfg_seed);
+	int result = 0;
+	uint64_t first_checksum = 0;
+	for (int m = 0; m < cfg_memory_count && result == 0; m++) {
+		// Engines are not locked: the comparison is about page size, and
+		// benchmarks should run without CAP_IPC_LOCK
+		hotmem_configure(cfg_memory[m], 0);
+		ravn_prof_reset();
+
+		printf("\nMemory: %s\n", hotmem_policy_name(cfg_memory[m]));
+		printf("%-4s %10s %10s %12s %18s %8s %8s %12s %12s %14s\n", "RUN", "EVENTS",
+		       "WALL MS", "EVENTS/S", "CHECKSUM", "HIGH", "MAX", "WINDOW", "DTLB MISSES",
+		       "BACKING");
+		for (int i = 0; i < cfg_runs; i++) {
+			struct aibench_run run;
+			char misses[24] = "-";
+			if (run_stream(&run) != 0) {
+				result = 1;
+				break;
+			}
+			if (run.tlb_misses >= 0) {
+				snprintf(misses, sizeof(misses), "%ld", (long)run.tlb_misses);
+			}
+
+			printf("%-4d %10lu %10.1f %12.0f %016lx %8lu %8.4f %6.4f %-6s %12s %7s %4zuMB\n",
+			       i + 1, (unsigned long)run.events, run.wall_ns / 1e6,
+			       run.events / (run.wall_ns / 1e9), (unsigned long)run.checksum,
+			       (unsigned long)run.high, run.max_score, run.window_score,
+			       run.window_level, misses, hotmem_backing_name(run.backing),
+			       run.huge_bytes >> 20);
+
+			if (m == 0 && i == 0) {
+				first_checksum = run.checksum;
+			} else if (run.checksum != first_checksum) {
+				printf("Run %d scores differ from the first run: the engine is not "
+				       "deterministic\n",
+				       i + 1);
+				result = 1;
+			}
+		}
+
+		print_stages();
+	}
+	hotmem_configure(HOTMEM_POLICY_HEAP, 0);
+
+	ravn_prof_set_enabled(was_profiling);
+	logger_set_level(LOG_LEVEL_INFO);
+	return result;
+}
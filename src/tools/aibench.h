@@ -0,0 +1,54 @@
+/*
+ * RAVN AI Benchmark Harness - Header File
+ *
+ * This header defines the deterministic benchmark harness for the RAVN AI
+ * engine, driving event analysis and the sliding window with synthetic
+ * event streams on a virtual clock so scores and per-stage timings are
+ * reproducible across runs and machines.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The AI benchmark harness implements:
+ * - A seeded synthetic event stream (benign and file-burst processes)
+ * - Virtual time advancing at a controlled event rate
+ * - Repeated runs on fresh engines with a score checksum per run
+ * - Per-stage timings from the profiler sites of the AI engine
+ *
+ * Architecture:
+ * - The engine clock is replaced with the virtual clock, so window sliding
+ *   depends only on the stream, never on how fast the host runs it
+ * - Runs are single-threaded on the calling thread
+ * - Identical options always produce identical scores and checksums
+ */
+
+#ifndef RAVN_AIBENCH_H
+#define RAVN_AIBENCH_H
+
+/*
+ * AI Benchmark Configuration Parameters
+ */
+#define AIBENCH_DEFAULT_PROCESSES 50   /* Distinct PIDs in the stream */
+#define AIBENCH_DEFAULT_RATE	  1000 /* Virtual events per second */
+#define AIBENCH_DEFAULT_DURATION  30   /* Virtual seconds per run */
+#define AIBENCH_DEFAULT_RUNS	  3    /* Repeated runs */
+#define AIBENCH_DEFAULT_ATTACKERS 1    /* File-burst processes */
+#define AIBENCH_ATTACK_SHARE	  20   /* Percent of events from attackers */
+#define AIBENCH_EVENT_TYPES	  64   /* Benign event type range */
+#define AIBENCH_BASE_PID	  1000 /* First synthetic PID */
+
+/**
+ * aibench_main - Run the AI benchmark harness
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the harness options, runs the synthetic stream through fresh AI
+ * engines and prints the scores, checksums and stage timings to stdout.
+ *
+ * Return: 0 on success, 1 on invalid arguments, setup failure or when the
+ * runs did not produce identical scores
+ */
+int aibench_main(int argc, char* argv[]);
+
+#endif // RAVN_AIBENCH_H
@@ -0,0 +1,352 @@
+// RAVN Event Archive Implementation
+// Parallel packing of closed event store segments
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "archive.h"
+
+#include "../daemon/store.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <time.h>
+#include <unistd.h>
+
+// Worker thread state
+struct archive_worker {
+	int index;
+	pthread_t thread;
+
+	// Decoded columns of the packed copy ([0]) and, with --verify, the original ([1])
+	uint64_t ts[2][STORE_BLOCK_EVENTS];
+	uint32_t column[2][STORE_BLOCK_EVENTS];
+
+	// Results
+	struct store_pack_stats totals;
+	uint64_t packed;
+	uint64_t skipped;
+	uint64_t failed;
+	uint64_t encode_cpu_ns;
+	uint64_t decode_cpu_ns;
+	uint64_t decoded_events;
+};
+
+static const char* const column_names[STORE_COLUMNS] = {"ts",   "pid",  "uid",  "type",
+							"comm", "path", "host", "category"};
+
+// Configuration
+static int cfg_workers = 0;
+static int cfg_verify = 0;
+
+// Segments, taken by the workers in order
+static char** paths = NULL;
+static int path_count = 0;
+static int next_path = 0;
+static pthread_mutex_t archive_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// CPU time consumed by the calling thread
+static uint64_t thread_cpu_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Order segment paths by name, which orders them by time
+static int compare_paths(const void* a, const void* b) {
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Decode every column of a packed segment, comparing with the original if given
+static int decode_segment(struct archive_worker* w, const struct store_segment* packed,
+			  const struct store_segment* original) {
+	if (original && (original->blocks != packed->blocks || original->events != packed->events)) {
+		return -1;
+	}
+
+	for (uint32_t b = 0; b < packed->blocks; b++) {
+		struct store_block_view v[2];
+		if (store_segment_block(packed, b, &v[0]) != 0 ||
+		    (original && store_segment_block(original, b, &v[1]) != 0)) {
+			return -1;
+		}
+		uint32_t n = v[0].header->events;
+		if (original && v[1].header->events != n) {
+			return -1;
+		}
+
+		for (int c = 0; c < STORE_COLUMNS; c++) {
+			void* out[2] = {w->column[0], w->column[1]};
+			size_t width = sizeof(uint32_t);
+			if (c == STORE_COLUMN_TS) {
+				out[0] = w->ts[0];
+				out[1] = w->ts[1];
+				width = sizeof(uint64_t);
+			}
+			if (store_block_column(&v[0], (enum store_column)c, out[0]) != 0) {
+				return -1;
+			}
+			if (original && (store_block_column(&v[1], (enum store_column)c, out[1]) != 0 ||
+					 memcmp(out[0], out[1], n * width) != 0)) {
+				return -1;
+			}
+		}
+		w->decoded_events += n;
+	}
+	return 0;
+}
+
+// Pack one segment in place
+static int archive_segment(struct archive_worker* w, const char* path) {
+	size_t len = strlen(path);
+	char* temp = malloc(len + sizeof(ARCHIVE_TEMP_SUFFIX));
+	if (!temp) {
+		return -1;
+	}
+	memcpy(temp, path, len);
+	memcpy(temp + len, ARCHIVE_TEMP_SUFFIX, sizeof(ARCHIVE_TEMP_SUFFIX));
+
+	struct store_pack_stats stats;
+	uint64_t start = thread_cpu_ns();
+	int rc = store_segment_pack(path, temp, &stats);
+	w->encode_cpu_ns += thread_cpu_ns() - start;
+	if (rc != 0) {
+		if (rc < 0) {
+			LOG_ERROR_MODULE("ARCHIVE", "Failed to pack %s", path);
+			unlink(temp);
+		}
+		free(temp);
+		return rc;
+	}
+
+	// Read the packed copy back before it replaces the original
+	struct store_segment packed, original;
+	rc = -1;
+	if (store_segment_open(&packed, temp) == 0) {
+		if (!cfg_verify) {
+			start = thread_cpu_ns();
+			rc = decode_segment(w, &packed, NULL);
+			w->decode_cpu_ns += thread_cpu_ns() - start;
+		} else if (store_segment_open(&original, path) == 0) {
+			rc = decode_segment(w, &packed, &original);
+			store_segment_close(&original);
+		}
+		store_segment_close(&packed);
+	}
+	if (rc != 0) {
+		LOG_ERROR_MODULE("ARCHIVE", "Packed copy of %s does not %s", path,
+				 cfg_verify ? "match the original" : "decode");
+	} else if (rename(temp, path) != 0) {
+		LOG_ERROR_MODULE("ARCHIVE", "Failed to replace %s: %s", path, strerror(errno));
+		rc = -1;
+	}
+	if (rc != 0) {
+		unlink(temp);
+		free(temp);
+		return -1;
+	}
+	free(temp);
+
+	w->totals.events += stats.events;
+	w->totals.blocks += stats.blocks;
+	w->totals.bytes_in += stats.bytes_in;
+	w->totals.bytes_out += stats.bytes_out;
+	for (int c = 0; c < STORE_COLUMNS; c++) {
+		w->totals.column_in[c] += stats.column_in[c];
+		w->totals.column_out[c] += stats.column_out[c];
+	}
+	return 0;
+}
+
+// Worker thread
+static void* archive_thread_func(void* arg) {
+	struct archive_worker* w = (struct archive_worker*)arg;
+	char name[16];
+	snprintf(name, sizeof(name), "ravn-archive-%d", w->index);
+	prctl(PR_SET_NAME, name, 0, 0, 0);
+
+	for (;;) {
+		pthread_mutex_lock(&archive_lock);
+		int k = next_path < path_count ? next_path++ : -1;
+		pthread_mutex_unlock(&archive_lock);
+		if (k < 0) {
+			break;
+		}
+
+		int rc = archive_segment(w, paths[k]);
+		if (rc == 0) {
+			w->packed++;
+		} else if (rc > 0) {
+			w->skipped++;
+		} else {
+			w->failed++;
+		}
+	}
+	return NULL;
+}
+
+// Print the compression report
+static void print_report(const struct archive_worker* workers, int started, double elapsed_s) {
+	struct store_pack_stats t;
+	uint64_t packed = 0, skipped = 0, failed = 0;
+	uint64_t encode_cpu_ns = 0, decode_cpu_ns = 0, decoded_events = 0;
+
+	memset(&t, 0, sizeof(t));
+	for (int i = 0; i < started; i++) {
+		const struct archive_worker* w = &workers[i];
+		t.events += w->totals.events;
+		t.blocks += w->totals.blocks;
+		t.bytes_in += w->totals.bytes_in;
+		t.bytes_out += w->totals.bytes_out;
+		for (int c = 0; c < STORE_COLUMNS; c++) {
+			t.column_in[c] += w->totals.column_in[c];
+			t.column_out[c] += w->totals.column_out[c];
+		}
+		packed += w->packed;
+		skipped += w->skipped;
+		failed += w->failed;
+		encode_cpu_ns += w->encode_cpu_ns;
+		decode_cpu_ns += w->decode_cpu_ns;
+		decoded_events += w->decoded_events;
+	}
+
+	printf("\nArchive Report\n");
+	printf("==============\n");
+	printf("Segments:        %lu packed, %lu skipped (open or already packed), %lu failed\n",
+	       (unsigned long)packed, (unsigned long)skipped, (unsigned long)failed);
+	printf("Elapsed:         %.3f s on %d worker(s)\n", elapsed_s, started);
+	if (packed == 0) {
+		return;
+	}
+	printf("Events:          %lu in %lu block(s)\n", (unsigned long)t.events,
+	       (unsigned long)t.blocks);
+	printf("Size:            %.1f MB -> %.1f MB (%.2fx, %.2f -> %.2f bytes/event)\n",
+	       t.bytes_in / 1e6, t.bytes_out / 1e6,
+	       t.bytes_out ? (double)t.bytes_in / t.bytes_out : 0.0,
+	       t.events ? (double)t.bytes_in / t.events : 0.0,
+	       t.events ? (double)t.bytes_out / t.events : 0.0);
+
+	printf("\n%-10s %12s %12s %8s %12s\n", "Column", "Raw MB", "Packed MB", "Ratio",
+	       "Bits/event");
+	for (int c = 0; c < STORE_COLUMNS; c++) {
+		printf("%-10s %12.2f %12.2f %7.1fx %12.2f\n", column_names[c], t.column_in[c] / 1e6,
+		       t.column_out[c] / 1e6,
+		       t.column_out[c] ? (double)t.column_in[c] / t.column_out[c] : 0.0,
+		       t.events ? t.column_out[c] * 8.0 / t.events : 0.0);
+	}
+
+	printf("\nEncode:          %.1f MB/s per core\n",
+	       encode_cpu_ns ? t.bytes_in / 1e6 / (encode_cpu_ns / 1e9) : 0.0);
+	if (cfg_verify) {
+		printf("Verified:        %lu events decode to the original values\n",
+		       (unsigned long)decoded_events);
+	} else if (decode_cpu_ns) {
+		// Every packed event is decoded once, to its raw column widths
+		double decode_s = decode_cpu_ns / 1e9;
+		uint64_t raw = 0;
+		for (int c = 0; c < STORE_COLUMNS; c++) {
+			raw += t.column_in[c];
+		}
+		printf("Decode:          %.2f GB/s, %.1f Mevents/s per core\n", raw / 1e9 / decode_s,
+		       decoded_events / 1e6 / decode_s);
+	}
+}
+
+// Print archive usage
+static void archive_usage(void) {
+	printf("Usage: ravn archive [OPTIONS] DIR|SEGMENT...\n");
+	printf("\nOptions:\n");
+	printf("  -V, --verify         Compare every packed column with the original\n");
+	printf("  -j, --jobs N         Packing threads (default: online CPUs)\n");
+	printf("\nClosed segments are packed in place; open and packed segments are skipped.\n");
+}
+
+// Pack closed event store segments
+int archive_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"verify", no_argument, 0, 'V'},
+					       {"jobs", required_argument, 0, 'j'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	int opt;
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "Vj:h", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 'V':
+			cfg_verify = 1;
+			break;
+		case 'j':
+			cfg_workers = atoi(optarg);
+			break;
+		case 'h':
+			archive_usage();
+			return 0;
+		default:
+			archive_usage();
+			return 1;
+		}
+	}
+
+	if (cfg_workers == 0) {
+		cfg_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (optind >= argc || cfg_workers <= 0 || cfg_workers > ARCHIVE_MAX_WORKERS) {
+		archive_usage();
+		return 1;
+	}
+
+	int result = 0;
+	for (int i = optind; result == 0 && i < argc; i++) {
+		if (store_list_segments(argv[i], &paths, &path_count) != 0) {
+			fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+			result = 1;
+		}
+	}
+	struct archive_worker* workers = NULL;
+	if (result == 0) {
+		workers = calloc((size_t)cfg_workers, sizeof(*workers));
+		result = workers ? 0 : 1;
+	}
+
+	int started = 0;
+	if (result == 0) {
+		if (path_count > 1) {
+			qsort(paths, (size_t)path_count, sizeof(*paths), compare_paths);
+		}
+		uint64_t start = ravn_prof_now_ns();
+		next_path = 0;
+		for (; started < cfg_workers; started++) {
+			workers[started].index = started;
+			if (pthread_create(&workers[started].thread, NULL, archive_thread_func,
+					   &workers[started]) != 0) {
+				LOG_ERROR_MODULE("ARCHIVE", "Failed to start worker %d", started);
+				break;
+			}
+		}
+		for (int i = 0; i < started; i++) {
+			pthread_join(workers[i].thread, NULL);
+		}
+		double elapsed_s = (ravn_prof_now_ns() - start) / 1e9;
+
+		print_report(workers, started, elapsed_s > 0 ? elapsed_s : 1e-9);
+		for (int i = 0; i < started; i++) {
+			result |= workers[i].failed != 0;
+		}
+		result |= started == 0;
+	}
+
+	for (int i = 0; i < path_count; i++) {
+		free(paths[i]);
+	}
+	free(paths);
+	paths = NULL;
+	path_count = 0;
+	free(workers);
+	return result;
+}
@@ -0,0 +1,48 @@
+/*
+ * RAVN Event Archive - Header File
+ *
+ * This header defines the archiver of the RAVN security platform, which
+ * packs closed event store segments with the column codecs so that long
+ * forensic retention costs a fraction of the disk, spread across all cores.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The archiver implements:
+ * - Packing of every closed segment named on the command line (or found in
+ *   a named directory); open and already packed segments are left alone
+ * - An optional check that every column of the packed copy decodes to the
+ *   original values before it replaces the segment
+ * - A report of the compression ratio per column and in bytes per event,
+ *   and of encode and decode speed per core from thread CPU time
+ *
+ * Architecture:
+ * - Worker threads take segments one at a time through a shared counter
+ * - Each segment is packed into a temporary ARCHIVE_TEMP_SUFFIX file next to
+ *   it and renamed over the original, so readers see either version whole
+ *   and an interrupted run leaves the original in place
+ */
+
+#ifndef RAVN_ARCHIVE_H
+#define RAVN_ARCHIVE_H
+
+/*
+ * Event Archive Configuration Parameters
+ */
+#define ARCHIVE_MAX_WORKERS 256	       /* Worker thread limit */
+#define ARCHIVE_TEMP_SUFFIX ".packing" /* Suffix of a segment being packed */
+
+/**
+ * archive_main - Pack closed event store segments
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the archive options, packs every closed segment in place and
+ * prints the compression report to stdout.
+ *
+ * Return: 0 on success, 1 on invalid arguments or if any segment failed
+ */
+int archive_main(int argc, char* argv[]);
+
+#endif // RAVN_ARCHIVE_H
@@ -0,0 +1,563 @@
+// RAVN Batch Scoring Implementation
+// Offline re-scoring of recorded traces partitioned by PID across cores
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "batch.h"
+
+#include "../daemon/ai_engine.h"
+#include "../daemon/ebpf_handler.h"
+#include "../daemon/trace.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Decoded event as handed to a worker
+struct batch_event {
+	uint64_t timestamp;  /* Event timestamp (ns) */
+	uint64_t cgroup_id;  /* cgroup v2 ID */
+	uint32_t pid;	     /* Process ID */
+	uint32_t event_type; /* Event type */
+	char comm[16];	     /* Process name */
+};
+
+// Fixed-size batch of events for one worker
+struct batch_chunk {
+	uint32_t count;
+	struct batch_event events[BATCH_CHUNK_EVENTS];
+};
+
+// Per-process scoring state
+struct batch_process {
+	uint32_t pid;
+	int used;
+	char comm[16];
+	uint64_t events;
+	uint64_t first_ns;
+	uint64_t last_ns;
+	uint64_t point_ns; /* Last timeline point */
+	double score_sum;
+	float max_score;
+	float last_score;
+	int level;
+};
+
+// Worker thread state
+struct batch_worker {
+	int index;
+	pthread_t thread;
+	ai_engine_t* engine;
+	uint64_t now_ns; /* Event time driving the engine clock */
+	FILE* timeline;
+
+	// Bounded chunk queue filled by the decoder
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	struct batch_chunk* queue[BATCH_QUEUE_DEPTH];
+	int head;
+	int count;
+	int done;
+	struct batch_chunk* filling; /* Chunk being filled by the decoder */
+
+	// PID table (open addressing)
+	struct batch_process* procs;
+	uint32_t proc_cap;
+	uint32_t proc_count;
+
+	// Results
+	uint64_t events;
+	uint64_t window_resets;
+	uint64_t cpu_ns;
+};
+
+// Batch options
+static int cfg_workers = 0; /* 0 = online CPUs */
+static int cfg_interval_ms = BATCH_DEFAULT_INTERVAL_MS;
+static const char* cfg_output = BATCH_DEFAULT_OUTPUT;
+static const char* cfg_model = "models/ravn_model.bin";
+
+static volatile sig_atomic_t batch_stop = 0;
+
+// Decoder state
+static struct batch_worker* workers = NULL;
+static uint64_t decoded_events = 0;
+
+// Stop scoring on SIGINT/SIGTERM
+static void batch_signal_handler(int sig) {
+	(void)sig;
+	batch_stop = 1;
+}
+
+// Threat level used by the AI engine for a score
+static int score_level(float score) {
+	return score > 0.7f ? 2 : score > 0.4f ? 1 : 0;
+}
+
+static const char* level_names[] = {"LOW", "MEDIUM", "HIGH"};
+
+// Current thread CPU time in nanoseconds
+static uint64_t thread_cpu_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Engine clock of a worker: the timestamp of the event being scored
+static uint64_t worker_clock(void* ctx) {
+	return ((const struct batch_worker*)ctx)->now_ns;
+}
+
+// Find or insert a process in a worker's PID table
+static struct batch_process* worker_process(struct batch_worker* w, uint32_t pid) {
+	if ((w->proc_count + 1) * 10 > w->proc_cap * 7) {
+		uint32_t cap = w->proc_cap ? w->proc_cap * 2 : 1024;
+		struct batch_process* procs = calloc(cap, sizeof(*procs));
+		if (!procs) {
+			return NULL;
+		}
+		for (uint32_t i = 0; i < w->proc_cap; i++) {
+			if (!w->procs[i].used) {
+				continue;
+			}
+			uint32_t slot = (w->procs[i].pid * 2654435761U) & (cap - 1);
+			while (procs[slot].used) {
+				slot = (slot + 1) & (cap - 1);
+			}
+			procs[slot] = w->procs[i];
+		}
+		free(w->procs);
+		w->procs = procs;
+		w->proc_cap = cap;
+	}
+
+	uint32_t slot = (pid * 2654435761U) & (w->proc_cap - 1);
+	while (w->procs[slot].used) {
+		if (w->procs[slot].pid == pid) {
+			return &w->procs[slot];
+		}
+		slot = (slot + 1) & (w->proc_cap - 1);
+	}
+
+	struct batch_process* p = &w->procs[slot];
+	p->used = 1;
+	p->pid = pid;
+	w->proc_count++;
+	return p;
+}
+
+// Check whether the engine window already tracks a PID
+static int window_has_pid(const struct sliding_window* window, uint32_t pid) {
+	for (int i = 0; i < window->process_count; i++) {
+		if (window->processes[i].pid == pid) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Score one event and update the process verdict and timeline
+static void score_event(struct batch_worker* w, const struct batch_event* ev,
+			struct ravn_event* event) {
+	struct batch_process* p = worker_process(w, ev->pid);
+	if (!p) {
+		return;
+	}
+
+	// Windows slide on event time, not on how fast the trace is scored
+	w->now_ns = ev->timestamp;
+
+	// The window tracks at most MAX_PROCESSES; start a new one when full
+	struct sliding_window* window = &w->engine->window;
+	if (window->process_count >= MAX_PROCESSES && !window_has_pid(window, ev->pid)) {
+		sliding_window_cleanup(window);
+		sliding_window_init(window, ev->timestamp);
+		w->window_resets++;
+	}
+
+	event->timestamp = ev->timestamp;
+	event->pid = ev->pid;
+	event->event_type = ev->event_type;
+	event->cgroup_id = ev->cgroup_id;
+	float score = ai_engine_analyze_event(w->engine, event);
+
+	if (p->events == 0) {
+		memcpy(p->comm, ev->comm, sizeof(p->comm));
+		p->first_ns = ev->timestamp;
+	}
+	p->events++;
+	p->last_ns = ev->timestamp;
+	p->score_sum += score;
+	p->last_score = score;
+	if (score > p->max_score) {
+		p->max_score = score;
+	}
+
+	// Sample on event time, plus every threat level change
+	int level = score_level(score);
+	if (p->events == 1 || level != p->level ||
+	    ev->timestamp - p->point_ns >= (uint64_t)cfg_interval_ms * 1000000ULL) {
+		fprintf(w->timeline, "%u,%lu,%.4f,%s\n", p->pid, (unsigned long)ev->timestamp,
+			score, level_names[level]);
+		p->point_ns = ev->timestamp;
+		p->level = level;
+	}
+	w->events++;
+}
+
+// Worker thread: score the chunks of one PID partition
+static void* worker_thread_func(void* arg) {
+	struct batch_worker* w = (struct batch_worker*)arg;
+	char name[16];
+	snprintf(name, sizeof(name), "ravn-batch-%d", w->index);
+	prctl(PR_SET_NAME, name, 0, 0, 0);
+
+	struct ravn_event event;
+	memset(&event, 0, sizeof(event));
+
+	for (;;) {
+		pthread_mutex_lock(&w->lock);
+		while (w->count == 0 && !w->done) {
+			pthread_cond_wait(&w->cond, &w->lock);
+		}
+		if (w->count == 0) {
+			pthread_mutex_unlock(&w->lock);
+			break;
+		}
+		struct batch_chunk* chunk = w->queue[w->head];
+		w->head = (w->head + 1) % BATCH_QUEUE_DEPTH;
+		w->count--;
+		pthread_cond_signal(&w->cond);
+		pthread_mutex_unlock(&w->lock);
+
+		for (uint32_t i = 0; i < chunk->count && !batch_stop; i++) {
+			score_event(w, &chunk->events[i], &event);
+		}
+		free(chunk);
+	}
+
+	w->cpu_ns = thread_cpu_ns();
+	return NULL;
+}
+
+// Hand a full chunk to its worker, waiting while the queue is full
+static void worker_push(struct batch_worker* w, struct batch_chunk* chunk) {
+	pthread_mutex_lock(&w->lock);
+	while (w->count == BATCH_QUEUE_DEPTH) {
+		pthread_cond_wait(&w->cond, &w->lock);
+	}
+	w->queue[(w->head + w->count) % BATCH_QUEUE_DEPTH] = chunk;
+	w->count++;
+	pthread_cond_signal(&w->cond);
+	pthread_mutex_unlock(&w->lock);
+}
+
+// Event tap: route each decoded event to its PID partition
+static void batch_event_tap(const struct ravn_event* event, void* ctx) {
+	(void)ctx;
+	struct batch_worker* w = &workers[event->pid % (uint32_t)cfg_workers];
+
+	if (!w->filling) {
+		w->filling = malloc(sizeof(*w->filling));
+		if (!w->filling) {
+			return;
+		}
+		w->filling->count = 0;
+	}
+
+	struct batch_event* ev = &w->filling->events[w->filling->count++];
+	ev->timestamp = event->timestamp;
+	ev->pid = event->pid;
+	ev->event_type = event->event_type;
+	ev->cgroup_id = event->cgroup_id;
+	memcpy(ev->comm, event->comm, sizeof(ev->comm));
+	decoded_events++;
+
+	if (w->filling->count == BATCH_CHUNK_EVENTS) {
+		worker_push(w, w->filling);
+		w->filling = NULL;
+	}
+}
+
+// Order verdicts by descending maximum score
+static int compare_verdicts(const void* a, const void* b) {
+	const struct batch_process* pa = *(const struct batch_process* const*)a;
+	const struct batch_process* pb = *(const struct batch_process* const*)b;
+	if (pa->max_score != pb->max_score) {
+		return pa->max_score < pb->max_score ? 1 : -1;
+	}
+	return pa->pid < pb->pid ? -1 : pa->pid > pb->pid;
+}
+
+// Merge the worker PID tables into the verdict file
+static int write_verdicts(uint64_t* total_pids, uint64_t* flagged) {
+	uint64_t count = 0;
+	for (int i = 0; i < cfg_workers; i++) {
+		count += workers[i].proc_count;
+	}
+
+	struct batch_process** all = calloc(count ? count : 1, sizeof(*all));
+	if (!all) {
+		return -1;
+	}
+	uint64_t n = 0;
+	for (int i = 0; i < cfg_workers; i++) {
+		for (uint32_t s = 0; s < workers[i].proc_cap; s++) {
+			if (workers[i].procs[s].used) {
+				all[n++] = &workers[i].procs[s];
+			}
+		}
+	}
+	qsort(all, n, sizeof(*all), compare_verdicts);
+
+	char path[4096];
+	snprintf(path, sizeof(path), "%s/verdicts.csv", cfg_output);
+	FILE* f = fopen(path, "w");
+	if (!f) {
+		LOG_ERROR_MODULE("BATCH", "Failed to create %s: %s", path, strerror(errno));
+		free(all);
+		return -1;
+	}
+
+	*flagged = 0;
+	fprintf(f, "pid,comm,events,first_ns,last_ns,max_score,mean_score,final_score,verdict\n");
+	for (uint64_t i = 0; i < n; i++) {
+		const struct batch_process* p = all[i];
+		int level = score_level(p->max_score);
+		if (level == 2) {
+			(*flagged)++;
+		}
+		fprintf(f, "%u,%.16s,%lu,%lu,%lu,%.4f,%.4f,%.4f,%s\n", p->pid, p->comm,
+			(unsigned long)p->events, (unsigned long)p->first_ns,
+			(unsigned long)p->last_ns, p->max_score, p->score_sum / p->events,
+			p->last_score, level_names[level]);
+	}
+
+	fclose(f);
+	free(all);
+	*total_pids = n;
+	return 0;
+}
+
+// Print the throughput report
+static void print_report(double elapsed_s, uint64_t decode_cpu_ns, uint64_t pids,
+			 uint64_t flagged) {
+	printf("\nScored %lu events from %lu processes in %.3f s on %d worker(s): %.0f events/s\n",
+	       (unsigned long)decoded_events, (unsigned long)pids, elapsed_s, cfg_workers,
+	       decoded_events / elapsed_s);
+	printf("Decode: %.0f events/s on one core\n",
+	       decode_cpu_ns ? decoded_events / (decode_cpu_ns / 1e9) : 0.0);
+
+	printf("\n%-8s %12s %8s %10s %14s %8s\n", "WORKER", "EVENTS", "PIDS", "CPU S",
+	       "EVENTS/S/CORE", "RESETS");
+	for (int i = 0; i < cfg_workers; i++) {
+		const struct batch_worker* w = &workers[i];
+		double cpu_s = w->cpu_ns / 1e9;
+		printf("%-8d %12lu %8u %10.3f %14.0f %8lu\n", i, (unsigned long)w->events,
+		       w->proc_count, cpu_s, cpu_s > 0 ? w->events / cpu_s : 0.0,
+		       (unsigned long)w->window_resets);
+	}
+
+	printf("\n%lu process(es) reached HIGH; verdicts in %s/verdicts.csv, timelines in "
+	       "%s/timeline-N.csv\n",
+	       (unsigned long)flagged, cfg_output, cfg_output);
+}
+
+// Print batch usage
+static void batch_usage(void) {
+	printf("Usage: ravn batch [OPTIONS] TRACE\n");
+	printf("\nOptions:\n");
+	printf("  -j, --jobs N         Scoring worker threads (default: online CPUs)\n");
+	printf("  -o, --output DIR     Output directory (default %s)\n", BATCH_DEFAULT_OUTPUT);
+	printf("  -i, --interval MS    Timeline sampling interval in event time (default %d)\n",
+	       BATCH_DEFAULT_INTERVAL_MS);
+	printf("  -m, --model PATH     AI model (default models/ravn_model.bin)\n");
+	printf("\nEvents are partitioned by PID, so every process is scored by exactly one\n");
+	printf("worker with the same window, feature and model code as the daemon.\n");
+	printf("Timelines get a point per interval and on every threat level change.\n");
+}
+
+// Create the workers and their engines and output files
+static int setup_workers(void) {
+	workers = calloc(cfg_workers, sizeof(*workers));
+	if (!workers) {
+		return -1;
+	}
+
+	for (int i = 0; i < cfg_workers; i++) {
+		struct batch_worker* w = &workers[i];
+		w->index = i;
+		pthread_mutex_init(&w->lock, NULL);
+		pthread_cond_init(&w->cond, NULL);
+
+		w->engine = ai_engine_init(cfg_model);
+		if (!w->engine) {
+			return -1;
+		}
+		ai_engine_set_clock(w->engine, worker_clock, w);
+
+		char path[4096];
+		snprintf(path, sizeof(path), "%s/timeline-%d.csv", cfg_output, i);
+		w->timeline = fopen(path, "w");
+		if (!w->timeline) {
+			LOG_ERROR_MODULE("BATCH", "Failed to create %s: %s", path, strerror(errno));
+			return -1;
+		}
+		setvbuf(w->timeline, NULL, _IOFBF, 1 << 20);
+		fprintf(w->timeline, "pid,ktime_ns,score,level\n");
+	}
+	return 0;
+}
+
+// Release the workers
+static void cleanup_workers(void) {
+	if (!workers) {
+		return;
+	}
+	for (int i = 0; i < cfg_workers; i++) {
+		struct batch_worker* w = &workers[i];
+		if (w->engine) {
+			ai_engine_cleanup(w->engine);
+		}
+		if (w->timeline) {
+			fclose(w->timeline);
+		}
+		free(w->filling);
+		free(w->procs);
+		pthread_mutex_destroy(&w->lock);
+		pthread_cond_destroy(&w->cond);
+	}
+	free(workers);
+	workers = NULL;
+}
+
+// Re-score a recorded trace offline
+int batch_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"jobs", required_argument, 0, 'j'},
+					       {"output", required_argument, 0, 'o'},
+					       {"interval", required_argument, 0, 'i'},
+					       {"model", required_argument, 0, 'm'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	int opt;
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "j:o:i:m:h", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 'j':
+			cfg_workers = atoi(optarg);
+			break;
+		case 'o':
+			cfg_output = optarg;
+			break;
+		case 'i':
+			cfg_interval_ms = atoi(optarg);
+			break;
+		case 'm':
+			cfg_model = optarg;
+			break;
+		case 'h':
+			batch_usage();
+			return 0;
+		default:
+			batch_usage();
+			return 1;
+		}
+	}
+
+	if (cfg_workers == 0) {
+		cfg_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (optind != argc - 1 || cfg_workers <= 0 || cfg_workers > BATCH_MAX_WORKERS ||
+	    cfg_interval_ms <= 0) {
+		batch_usage();
+		return 1;
+	}
+	const char* path = argv[optind];
+
+	struct trace_reader reader;
+	if (trace_reader_open(&reader, path) != 0) {
+		return 1;
+	}
+	if (mkdir(cfg_output, 0755) != 0 && errno != EEXIST) {
+		LOG_ERROR_MODULE("BATCH", "Failed to create %s: %s", cfg_output, strerror(errno));
+		trace_reader_close(&reader);
+		return 1;
+	}
+
+	// Handlers log every event at INFO; scoring days of events must stay quiet
+	logger_set_level(LOG_LEVEL_WARN);
+
+	int result = 0;
+	int started = 0;
+	if (setup_workers() != 0) {
+		result = 1;
+	}
+
+	uint64_t start = ravn_prof_now_ns();
+	uint64_t decode_start = thread_cpu_ns();
+	for (; result == 0 && started < cfg_workers; started++) {
+		if (pthread_create(&workers[started].thread, NULL, worker_thread_func,
+				   &workers[started]) != 0) {
+			LOG_ERROR_MODULE("BATCH", "Failed to start worker %d", started);
+			batch_stop = 1;
+			result = 1;
+			break;
+		}
+	}
+
+	if (result == 0) {
+		signal(SIGINT, batch_signal_handler);
+		signal(SIGTERM, batch_signal_handler);
+
+		// Decode in trace order; the tap partitions by PID
+		ebpf_handler_set_event_tap(batch_event_tap, NULL);
+		const struct trace_record_header* hdr;
+		void* data;
+		while (!batch_stop && trace_reader_next(&reader, &hdr, &data) == 1) {
+			ebpf_handler_dispatch_record(hdr->category, data, hdr->length);
+		}
+		ebpf_handler_set_event_tap(NULL, NULL);
+
+		for (int i = 0; i < cfg_workers; i++) {
+			if (workers[i].filling && workers[i].filling->count) {
+				worker_push(&workers[i], workers[i].filling);
+				workers[i].filling = NULL;
+			}
+		}
+	}
+	uint64_t decode_cpu_ns = thread_cpu_ns() - decode_start;
+
+	for (int i = 0; i < started; i++) {
+		pthread_mutex_lock(&workers[i].lock);
+		workers[i].done = 1;
+		pthread_cond_signal(&workers[i].cond);
+		pthread_mutex_unlock(&workers[i].lock);
+		pthread_join(workers[i].thread, NULL);
+	}
+	double elapsed_s = (ravn_prof_now_ns() - start) / 1e9;
+
+	uint64_t pids = 0;
+	uint64_t flagged = 0;
+	if (result == 0 && write_verdicts(&pids, &flagged) != 0) {
+		result = 1;
+	}
+	if (result == 0) {
+		print_report(elapsed_s > 0 ? elapsed_s : 1e-9, decode_cpu_ns, pids, flagged);
+	}
+
+	cleanup_workers();
+	trace_reader_close(&reader);
+	logger_set_level(LOG_LEVEL_INFO);
+	return result;
+}
@@ -0,0 +1,52 @@
+/*
+ * RAVN Batch Scoring - Header File
+ *
+ * This header defines the offline batch scorer for the RAVN security
+ * platform, re-scoring recorded traces with the current model for incident
+ * response, spread across all cores.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The batch scorer implements:
+ * - Decoding of every trace record through the live event handlers
+ * - Partitioning of the decoded events by PID across worker threads
+ * - Per-worker AI engines running the same window, feature and model code
+ * - Per-process verdicts (events, max/mean/final score, threat level)
+ * - Per-process score timelines sampled on event time
+ * - Events/sec per core from each worker's thread CPU time
+ *
+ * Architecture:
+ * - The calling thread reads and decodes the trace in order
+ * - Events are handed to workers in fixed-size chunks over bounded queues,
+ *   so memory stays constant regardless of trace size
+ * - A PID always maps to the same worker, keeping its sequence intact
+ * - Each worker writes its own timeline file; verdicts are merged at the end
+ */
+
+#ifndef RAVN_BATCH_H
+#define RAVN_BATCH_H
+
+/*
+ * Batch Scoring Configuration Parameters
+ */
+#define BATCH_MAX_WORKERS	  256  /* Worker thread limit */
+#define BATCH_CHUNK_EVENTS	  4096 /* Events per hand-off chunk */
+#define BATCH_QUEUE_DEPTH	  16   /* Chunks queued per worker */
+#define BATCH_DEFAULT_INTERVAL_MS 1000 /* Timeline sampling interval */
+#define BATCH_DEFAULT_OUTPUT	  "ravn-batch" /* Output directory */
+
+/**
+ * batch_main - Re-score a recorded trace offline
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the batch options, scores every event of the trace, writes the
+ * verdict and timeline files and prints the throughput report to stdout.
+ *
+ * Return: 0 on success, 1 on invalid arguments or failure
+ */
+int batch_main(int argc, char* argv[]);
+
+#endif // RAVN_BATCH_H
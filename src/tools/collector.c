@@ -0,0 +1,653 @@
+// RAVN Fleet Collector Implementation
+// Receives forwarded agent records into one store and one Redis
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "collector.h"
+
+#include "../daemon/codec.h"
+#include "../daemon/ebpf_handler.h"
+#include "../daemon/forward.h"
+#include "../daemon/redis_client.h"
+#include "../daemon/store.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+// External Redis connection (read by the event handlers)
+extern void* global_redis_conn_ptr;
+
+// Collector options
+static const char* cfg_listen = "127.0.0.1:7420"; /* Agents are not authenticated */
+static const char* cfg_store = NULL;
+static uint32_t cfg_retention = STORE_DEFAULT_RETENTION;
+static int cfg_redis = 1;
+static int cfg_verbose = 0;
+
+static volatile sig_atomic_t collector_stop = 0;
+
+struct collector_conn;
+
+// One agent host, kept across its connections
+struct collector_host {
+	char name[FORWARD_HOST_MAX];
+	char address[INET6_ADDRSTRLEN + 8]; /* Peer of the latest connection */
+	uint64_t session;		    /* Run of the agent being received */
+	uint64_t last_sequence;		    /* Last batch stored for @session */
+	struct collector_conn* conn;	    /* Current connection, NULL if none */
+	time_t last_seen;
+
+	uint64_t connects;
+	uint64_t batches;
+	uint64_t records;
+	uint64_t raw_bytes;
+	uint64_t wire_bytes;
+	uint64_t duplicates;
+
+	int has_summary;
+	struct forward_summary summary;
+};
+
+// One agent connection
+struct collector_conn {
+	int fd;
+	char address[INET6_ADDRSTRLEN + 8];
+	struct collector_host* host; /* NULL until the HELLO */
+	uint8_t* buf;		     /* Received bytes not yet handled */
+	size_t used;
+};
+
+static struct collector_host* hosts = NULL;
+static int host_count = 0;
+static struct collector_conn* conns[COLLECTOR_MAX_CONNECTIONS];
+static int conn_count = 0;
+
+// Decompressed batch, and one record copied out of it with 8-byte alignment
+static uint8_t raw_batch[FORWARD_BATCH_BYTES];
+static uint64_t record_buf[FORWARD_BATCH_BYTES / sizeof(uint64_t)];
+
+// CLOCK_REALTIME minus CLOCK_MONOTONIC here, against which agent timestamps are moved
+static uint64_t local_wall_offset_ns = 0;
+
+// Stop the collector on SIGINT/SIGTERM
+static void collector_signal_handler(int sig) {
+	(void)sig;
+	collector_stop = 1;
+}
+
+// Print collector usage
+static void collector_usage(void) {
+	printf("Usage: ravn collector [OPTIONS]\n");
+	printf("\nOptions:\n");
+	printf("  -l, --listen ADDR    Listen on [HOST]:PORT (default 127.0.0.1:%d; :PORT for all\n"
+	       "                       addresses, only on a trusted network)\n",
+	       FORWARD_DEFAULT_PORT);
+	printf("  -d, --store DIR      Store the events of every host as columnar segments\n");
+	printf("                       in DIR\n");
+	printf("  -R, --retention DAYS Delete stored segments after DAYS days (default %d, "
+	       "0 = never)\n",
+	       STORE_DEFAULT_RETENTION);
+	printf("  -n, --no-redis       Do not send events and host state to Redis\n");
+	printf("  -V, --verbose        Keep the per-event log lines\n");
+	printf("\nAgents forward with 'ravn -F HOST[:PORT] daemon'; 'ravn replay -F' stands in\n");
+	printf("for an agent without BPF. Search the merged store with 'ravn query -H NAME'.\n");
+}
+
+// Whether an agent's host name is safe as a Redis key, store value and log field
+static int host_name_valid(const char* name) {
+	for (const char* c = name; *c; c++) {
+		if (!isalnum((unsigned char)*c) && !strchr(".-_", *c)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// Find a host by name, adding it if new
+static struct collector_host* host_find(const char* name) {
+	for (int i = 0; i < host_count; i++) {
+		if (strcmp(hosts[i].name, name) == 0) {
+			return &hosts[i];
+		}
+	}
+	if (host_count == COLLECTOR_MAX_HOSTS) {
+		return NULL;
+	}
+	struct collector_host* host = &hosts[host_count++];
+	memset(host, 0, sizeof(*host));
+	snprintf(host->name, sizeof(host->name), "%s", name);
+	return host;
+}
+
+// Close an agent connection
+static void conn_close(struct collector_conn* conn, const char* reason) {
+	if (conn->host) {
+		LOG_INFO_MODULE("COLLECTOR", "%s (%s) disconnected: %s", conn->host->name,
+				conn->address, reason);
+		conn->host->conn = NULL;
+	} else {
+		LOG_INFO_MODULE("COLLECTOR", "%s disconnected: %s", conn->address, reason);
+	}
+	close(conn->fd);
+	conn->fd = -1; // Removed from conns[] by the poll loop
+}
+
+// Send one frame without payload; agents read them promptly, so a full socket is an error
+static int conn_reply(struct collector_conn* conn, enum forward_frame_type type,
+		      uint64_t sequence) {
+	struct forward_frame frame;
+	memset(&frame, 0, sizeof(frame));
+	frame.magic = FORWARD_MAGIC;
+	frame.type = (uint16_t)type;
+	frame.version = FORWARD_VERSION;
+	frame.sequence = sequence;
+
+	ssize_t n = send(conn->fd, &frame, sizeof(frame), MSG_NOSIGNAL | MSG_DONTWAIT);
+	if (n != (ssize_t)sizeof(frame)) {
+		conn_close(conn, n < 0 ? strerror(errno) : "send buffer full");
+		return -1;
+	}
+	return 0;
+}
+
+// Greet an agent and tell it where to resume
+static int handle_hello(struct collector_conn* conn, const uint8_t* payload, uint32_t length) {
+	struct forward_hello hello;
+	if (conn->host || length != sizeof(hello)) {
+		conn_close(conn, "unexpected HELLO");
+		return -1;
+	}
+	memcpy(&hello, payload, sizeof(hello));
+	hello.host[sizeof(hello.host) - 1] = '\0';
+	if (!host_name_valid(hello.host)) {
+		conn_close(conn, "invalid host name");
+		return -1;
+	}
+
+	struct collector_host* host = host_find(hello.host[0] ? hello.host : conn->address);
+	if (!host) {
+		conn_close(conn, "too many hosts");
+		return -1;
+	}
+	if (host->conn) {
+		conn_close(host->conn, "replaced by a new connection");
+	}
+	if (host->session != hello.session) {
+		host->session = hello.session; // New run of the agent: batches restart at 1
+		host->last_sequence = 0;
+	}
+	host->conn = conn;
+	host->connects++;
+	host->last_seen = time(NULL);
+	snprintf(host->address, sizeof(host->address), "%s", conn->address);
+	conn->host = host;
+
+	LOG_INFO_MODULE("COLLECTOR", "%s connected from %s, resuming after batch %lu", host->name,
+			conn->address, (unsigned long)host->last_sequence);
+	return conn_reply(conn, FORWARD_WELCOME, host->last_sequence);
+}
+
+// Decode, store and acknowledge one batch
+static int handle_batch(struct collector_conn* conn, uint64_t sequence, const uint8_t* payload,
+			uint32_t length) {
+	struct collector_host* host = conn->host;
+	struct forward_batch batch;
+
+	if (length < sizeof(batch)) {
+		conn_close(conn, "short BATCH");
+		return -1;
+	}
+	memcpy(&batch, payload, sizeof(batch));
+	host->last_seen = time(NULL);
+	host->wire_bytes += sizeof(struct forward_frame) + length;
+
+	// Resent after a reconnect although stored already
+	if (sequence <= host->last_sequence) {
+		host->duplicates++;
+		return conn_reply(conn, FORWARD_ACK, sequence);
+	}
+	if (sequence != host->last_sequence + 1) {
+		if (host->last_sequence != 0) {
+			conn_close(conn, "batch out of order");
+			return -1;
+		}
+		// Run not seen since we started: earlier batches went to an earlier collector
+		LOG_INFO_MODULE("COLLECTOR", "%s: taking up at batch %lu", host->name,
+				(unsigned long)sequence);
+	}
+	if (batch.raw_bytes > FORWARD_BATCH_BYTES ||
+	    codec_lz_decode(payload + sizeof(batch), length - sizeof(batch), raw_batch,
+			    batch.raw_bytes) != 0) {
+		conn_close(conn, "corrupt BATCH");
+		return -1;
+	}
+
+	// Agent monotonic timestamps to ours: the store adds our offset back
+	uint64_t shift = batch.wall_offset_ns - local_wall_offset_ns;
+	uint32_t offset = 0;
+	uint32_t records = 0;
+
+	ebpf_handler_set_origin(host->name);
+	while (offset + sizeof(struct forward_record) <= batch.raw_bytes) {
+		struct forward_record rec;
+		memcpy(&rec, raw_batch + offset, sizeof(rec));
+		offset += sizeof(rec);
+		if (rec.length > batch.raw_bytes - offset) {
+			break;
+		}
+
+		memcpy(record_buf, raw_batch + offset, rec.length);
+		if (rec.length >= sizeof(uint64_t)) {
+			record_buf[0] += shift; // Every record starts with its timestamp
+		}
+		ebpf_handler_dispatch_record(rec.category, record_buf, rec.length);
+		offset += rec.length;
+		records++;
+	}
+	ebpf_handler_set_origin(NULL);
+
+	if (offset != batch.raw_bytes || records != batch.records) {
+		LOG_WARN_MODULE("COLLECTOR", "%s: batch %lu framing mismatch (%u of %u records)",
+				host->name, (unsigned long)sequence, records, batch.records);
+	}
+	host->last_sequence = sequence;
+	host->batches++;
+	host->records += records;
+	host->raw_bytes += batch.raw_bytes;
+	return conn_reply(conn, FORWARD_ACK, sequence);
+}
+
+// Keep the latest threat summary of a host
+static int handle_summary(struct collector_conn* conn, const uint8_t* payload, uint32_t length) {
+	struct collector_host* host = conn->host;
+	if (length != sizeof(host->summary)) {
+		conn_close(conn, "bad SUMMARY");
+		return -1;
+	}
+	memcpy(&host->summary, payload, sizeof(host->summary));
+	host->summary.threat_level[sizeof(host->summary.threat_level) - 1] = '\0';
+	host->summary.threat_reason[sizeof(host->summary.threat_reason) - 1] = '\0';
+	if (host->summary.top_count > FORWARD_SUMMARY_TOP) {
+		host->summary.top_count = FORWARD_SUMMARY_TOP;
+	}
+	host->has_summary = 1;
+	host->last_seen = time(NULL);
+	host->wire_bytes += sizeof(struct forward_frame) + length;
+	return 0;
+}
+
+// Handle the complete frames received on a connection
+static void conn_process(struct collector_conn* conn) {
+	size_t pos = 0;
+
+	while (conn->fd >= 0 && conn->used - pos >= sizeof(struct forward_frame)) {
+		struct forward_frame frame;
+		memcpy(&frame, conn->buf + pos, sizeof(frame));
+		if (frame.magic != FORWARD_MAGIC || frame.version != FORWARD_VERSION ||
+		    frame.length > FORWARD_MAX_PAYLOAD) {
+			conn_close(conn, "not a RAVN agent or incompatible version");
+			return;
+		}
+		if (conn->used - pos < sizeof(frame) + frame.length) {
+			break; // Rest of the frame still in flight
+		}
+
+		const uint8_t* payload = conn->buf + pos + sizeof(frame);
+		pos += sizeof(frame) + frame.length;
+		if (frame.type == FORWARD_HELLO) {
+			handle_hello(conn, payload, frame.length);
+		} else if (!conn->host) {
+			conn_close(conn, "no HELLO");
+		} else if (frame.type == FORWARD_BATCH) {
+			handle_batch(conn, frame.sequence, payload, frame.length);
+		} else if (frame.type == FORWARD_SUMMARY) {
+			handle_summary(conn, payload, frame.length);
+		} else {
+			conn_close(conn, "unexpected message");
+		}
+	}
+
+	if (conn->fd >= 0) {
+		conn->used -= pos;
+		memmove(conn->buf, conn->buf + pos, conn->used);
+	}
+}
+
+// Read what an agent sent
+static void conn_read(struct collector_conn* conn) {
+	size_t size = sizeof(struct forward_frame) + FORWARD_MAX_PAYLOAD;
+	ssize_t n = recv(conn->fd, conn->buf + conn->used, size - conn->used, MSG_DONTWAIT);
+	if (n < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+		return;
+	}
+	if (n <= 0) {
+		conn_close(conn, n == 0 ? "connection closed" : strerror(errno));
+		return;
+	}
+	conn->used += (size_t)n;
+	conn_process(conn);
+}
+
+// Accept a new agent connection
+static void collector_accept(int listen_fd) {
+	struct sockaddr_storage addr;
+	socklen_t len = sizeof(addr);
+	int fd = accept(listen_fd, (struct sockaddr*)&addr, &len);
+	if (fd < 0) {
+		return;
+	}
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	fcntl(fd, F_SETFL, O_NONBLOCK);
+	if (conn_count == COLLECTOR_MAX_CONNECTIONS) {
+		LOG_WARN_MODULE("COLLECTOR", "Connection limit reached, refusing an agent");
+		close(fd);
+		return;
+	}
+
+	struct collector_conn* conn = calloc(1, sizeof(*conn));
+	if (conn) {
+		conn->buf = malloc(sizeof(struct forward_frame) + FORWARD_MAX_PAYLOAD);
+	}
+	if (!conn || !conn->buf) {
+		free(conn);
+		close(fd);
+		return;
+	}
+	conn->fd = fd;
+
+	char ip[INET6_ADDRSTRLEN] = "?";
+	char port[8] = "";
+	getnameinfo((struct sockaddr*)&addr, len, ip, sizeof(ip), port, sizeof(port),
+		    NI_NUMERICHOST | NI_NUMERICSERV);
+	snprintf(conn->address, sizeof(conn->address), "%s:%s", ip, port);
+	conns[conn_count++] = conn;
+}
+
+// Open the listening socket
+static int collector_listen(const char* spec) {
+	char host[256];
+	char port[8];
+	uint16_t port_nr;
+	struct addrinfo hints;
+	struct addrinfo* res = NULL;
+	int fd = -1;
+
+	if (forward_parse_address(spec, host, sizeof(host), &port_nr) != 0) {
+		LOG_ERROR_MODULE("COLLECTOR", "Invalid listen address '%s'", spec);
+		return -1;
+	}
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	hints.ai_flags = AI_PASSIVE;
+	snprintf(port, sizeof(port), "%u", port_nr);
+	if (getaddrinfo(host[0] ? host : NULL, port, &hints, &res) != 0) {
+		LOG_ERROR_MODULE("COLLECTOR", "Cannot resolve listen address '%s'", spec);
+		return -1;
+	}
+
+	for (struct addrinfo* ai = res; ai && fd < 0; ai = ai->ai_next) {
+		int one = 1;
+		fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC | SOCK_NONBLOCK,
+			    ai->ai_protocol);
+		if (fd < 0) {
+			continue;
+		}
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+		if (bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || listen(fd, 64) != 0) {
+			close(fd);
+			fd = -1;
+		}
+	}
+	freeaddrinfo(res);
+
+	if (fd < 0) {
+		LOG_ERROR_MODULE("COLLECTOR", "Cannot listen on %s: %s", spec, strerror(errno));
+	}
+	return fd;
+}
+
+// Publish the state of every host to Redis
+static void collector_publish(redis_connection_t* conn) {
+	enum { FIELDS = 18 };
+	static const char* members[COLLECTOR_MAX_HOSTS];
+	static double scores[COLLECTOR_MAX_HOSTS];
+	static const char* const fields[FIELDS] = {
+		"address", "connected", "last_seen", "batches", "records", "raw_bytes",
+		"wire_bytes", "duplicates", "threat_score", "threat_level", "threat_reason",
+		"processes", "cgroups", "events", "dropped", "top", "session", "last_batch"};
+	char values[FIELDS][256];
+	const char* vals[FIELDS];
+	char key[sizeof(REDIS_HOST_PREFIX) + FORWARD_HOST_MAX];
+
+	if (!conn) {
+		return;
+	}
+
+	for (int i = 0; i < host_count; i++) {
+		const struct collector_host* host = &hosts[i];
+		const struct forward_summary* s = &host->summary;
+		size_t top = 0;
+
+		members[i] = host->name;
+		scores[i] = s->threat_score;
+
+		snprintf(values[0], sizeof(values[0]), "%s", host->address);
+		snprintf(values[1], sizeof(values[1]), "%d", host->conn != NULL);
+		snprintf(values[2], sizeof(values[2]), "%ld", (long)host->last_seen);
+		snprintf(values[3], sizeof(values[3]), "%lu", (unsigned long)host->batches);
+		snprintf(values[4], sizeof(values[4]), "%lu", (unsigned long)host->records);
+		snprintf(values[5], sizeof(values[5]), "%lu", (unsigned long)host->raw_bytes);
+		snprintf(values[6], sizeof(values[6]), "%lu", (unsigned long)host->wire_bytes);
+		snprintf(values[7], sizeof(values[7]), "%lu", (unsigned long)host->duplicates);
+		snprintf(values[8], sizeof(values[8]), "%.3f", s->threat_score);
+		snprintf(values[9], sizeof(values[9]), "%s", s->threat_level);
+		snprintf(values[10], sizeof(values[10]), "%s", s->threat_reason);
+		snprintf(values[11], sizeof(values[11]), "%u", s->process_count);
+		snprintf(values[12], sizeof(values[12]), "%u", s->cgroup_count);
+		snprintf(values[13], sizeof(values[13]), "%lu", (unsigned long)s->events);
+		snprintf(values[14], sizeof(values[14]), "%lu", (unsigned long)s->dropped);
+		values[15][0] = '\0';
+		for (uint32_t t = 0; t < s->top_count && top < sizeof(values[15]); t++) {
+			top += (size_t)snprintf(values[15] + top, sizeof(values[15]) - top,
+						"%s%u:%.3f", t ? "," : "", s->top[t].pid,
+						s->top[t].threat_score);
+		}
+		snprintf(values[16], sizeof(values[16]), "%016lx", (unsigned long)host->session);
+		snprintf(values[17], sizeof(values[17]), "%lu",
+			 (unsigned long)host->last_sequence);
+		for (int f = 0; f < FIELDS; f++) {
+			vals[f] = values[f];
+		}
+
+		snprintf(key, sizeof(key), "%s%s", REDIS_HOST_PREFIX, host->name);
+		redis_hash_set(conn, key, fields, vals, FIELDS);
+	}
+	redis_zset_replace(conn, REDIS_HOSTS_KEY, members, scores, host_count);
+}
+
+// Print the per-host report
+static void print_report(double elapsed_s) {
+	uint64_t records = 0, raw = 0, wire = 0;
+
+	printf("\n%-20s %-22s %6s %10s %12s %8s %6s %-8s\n", "HOST", "ADDRESS", "CONN",
+	       "BATCHES", "RECORDS", "RATIO", "DUPS", "THREAT");
+	for (int i = 0; i < host_count; i++) {
+		const struct collector_host* host = &hosts[i];
+		printf("%-20s %-22s %6lu %10lu %12lu %7.2fx %6lu %-8s %.3f\n", host->name,
+		       host->address, (unsigned long)host->connects, (unsigned long)host->batches,
+		       (unsigned long)host->records,
+		       host->wire_bytes ? (double)host->raw_bytes / host->wire_bytes : 0.0,
+		       (unsigned long)host->duplicates,
+		       host->has_summary ? host->summary.threat_level : "-",
+		       host->summary.threat_score);
+		records += host->records;
+		raw += host->raw_bytes;
+		wire += host->wire_bytes;
+	}
+	printf("\nCollected %lu records from %d hosts in %.1f s (%.1f MB raw, %.1f MB received)\n",
+	       (unsigned long)records, host_count, elapsed_s, raw / 1e6, wire / 1e6);
+}
+
+// Collect the events of a fleet of agents
+int collector_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"listen", required_argument, 0, 'l'},
+					       {"store", required_argument, 0, 'd'},
+					       {"retention", required_argument, 0, 'R'},
+					       {"no-redis", no_argument, 0, 'n'},
+					       {"verbose", no_argument, 0, 'V'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	int opt;
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "l:d:R:nVh", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 'l':
+			cfg_listen = optarg;
+			break;
+		case 'd':
+			cfg_store = optarg;
+			break;
+		case 'R':
+			cfg_retention = (uint32_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'n':
+			cfg_redis = 0;
+			break;
+		case 'V':
+			cfg_verbose = 1;
+			break;
+		case 'h':
+			collector_usage();
+			return 0;
+		default:
+			collector_usage();
+			return 1;
+		}
+	}
+	if (optind != argc) {
+		collector_usage();
+		return 1;
+	}
+
+	hosts = calloc(COLLECTOR_MAX_HOSTS, sizeof(*hosts));
+	int listen_fd = hosts ? collector_listen(cfg_listen) : -1;
+	if (listen_fd < 0) {
+		free(hosts);
+		return 1;
+	}
+	if (cfg_store && store_open(cfg_store, cfg_retention) != 0) {
+		LOG_ERROR_MODULE("COLLECTOR", "Failed to open event store %s", cfg_store);
+		close(listen_fd);
+		free(hosts);
+		return 1;
+	}
+
+	// Same offset as the store takes at store_open()
+	struct timespec wall;
+	clock_gettime(CLOCK_REALTIME, &wall);
+	local_wall_offset_ns = (uint64_t)wall.tv_sec * 1000000000ULL + (uint64_t)wall.tv_nsec -
+			       ravn_prof_now_ns();
+
+	redis_connection_t* redis = NULL;
+	if (cfg_redis) {
+		redis = redis_connect("127.0.0.1", 6379);
+		if (!redis) {
+			LOG_WARN_MODULE("COLLECTOR", "Redis unavailable, collecting without it");
+		}
+		global_redis_conn_ptr = redis;
+	}
+
+	// Handlers log every event at INFO; with a fleet that floods the terminal
+	if (!cfg_verbose) {
+		logger_set_level(LOG_LEVEL_WARN);
+	}
+	signal(SIGINT, collector_signal_handler);
+	signal(SIGTERM, collector_signal_handler);
+	printf("Collecting on %s%s%s\n", cfg_listen, cfg_store ? " into " : "",
+	       cfg_store ? cfg_store : "");
+	fflush(stdout);
+
+	static struct pollfd pfds[COLLECTOR_MAX_CONNECTIONS + 1];
+	uint64_t start = ravn_prof_now_ns();
+	uint64_t next_publish = start;
+	while (!collector_stop) {
+		pfds[0].fd = listen_fd;
+		pfds[0].events = POLLIN;
+		for (int i = 0; i < conn_count; i++) {
+			pfds[i + 1].fd = conns[i]->fd;
+			pfds[i + 1].events = POLLIN;
+		}
+
+		int ready = poll(pfds, (nfds_t)conn_count + 1, COLLECTOR_PUBLISH_MS / 4);
+		if (ready > 0) {
+			int polled = conn_count;
+			for (int i = 0; i < polled; i++) {
+				if (pfds[i + 1].revents && conns[i]->fd >= 0) {
+					conn_read(conns[i]);
+				}
+			}
+			if (pfds[0].revents & POLLIN) {
+				collector_accept(listen_fd);
+			}
+		}
+
+		// Drop closed connections, keeping the rest in accept order
+		int kept = 0;
+		for (int i = 0; i < conn_count; i++) {
+			if (conns[i]->fd < 0) {
+				free(conns[i]->buf);
+				free(conns[i]);
+			} else {
+				conns[kept++] = conns[i];
+			}
+		}
+		conn_count = kept;
+
+		uint64_t now = ravn_prof_now_ns();
+		if (now >= next_publish) {
+			collector_publish(redis);
+			next_publish = now + COLLECTOR_PUBLISH_MS * 1000000ULL;
+		}
+	}
+
+	for (int i = 0; i < conn_count; i++) {
+		conn_close(conns[i], "collector stopping");
+		free(conns[i]->buf);
+		free(conns[i]);
+	}
+	conn_count = 0;
+	close(listen_fd);
+	collector_publish(redis);
+	store_close();
+
+	print_report((ravn_prof_now_ns() - start) / 1e9);
+
+	global_redis_conn_ptr = NULL;
+	if (redis) {
+		redis_disconnect(redis);
+	}
+	free(hosts);
+	hosts = NULL;
+	host_count = 0;
+	if (!cfg_verbose) {
+		logger_set_level(LOG_LEVEL_INFO);
+	}
+	return 0;
+}
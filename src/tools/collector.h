@@ -0,0 +1,56 @@
+/*
+ * RAVN Fleet Collector - Header File
+ *
+ * This header defines the collector mode of the RAVN security platform,
+ * which receives the raw ring records and threat summaries forwarded by
+ * agents ('ravn -F HOST daemon') and merges them into one event store and
+ * one Redis, so a fleet is searched and watched from a single place.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The fleet collector implements:
+ * - The collector side of the forwarding protocol of daemon/forward.h:
+ *   welcome with the last stored batch of the agent's run, in-order batch
+ *   acceptance, acknowledgment once stored, duplicates acknowledged and
+ *   skipped
+ * - Decoding of every forwarded record through the same handlers as live
+ *   delivery, stored with the name of the host it came from
+ * - Record timestamps moved from the agent's monotonic clock to the
+ *   collector's, so the stored wall-clock times are the agent's
+ * - The ravn:hosts sorted set (threat score per host) and one
+ *   ravn:host:<name> hash per host in Redis
+ *
+ * Architecture:
+ * - One thread multiplexes the listening socket and every agent connection
+ *   with poll(); records are dispatched from it, standing in for the ring
+ *   buffer polling thread
+ * - Host state survives reconnects; a new run of an agent (new session ID)
+ *   starts again from batch 1
+ * - A second connection of a host replaces the first one
+ */
+
+#ifndef RAVN_COLLECTOR_H
+#define RAVN_COLLECTOR_H
+
+/*
+ * Fleet Collector Configuration Parameters
+ */
+#define COLLECTOR_MAX_CONNECTIONS 256  /* Agent connections open at once */
+#define COLLECTOR_MAX_HOSTS	  1024 /* Hosts tracked */
+#define COLLECTOR_PUBLISH_MS	  1000 /* Host state publication period */
+
+/**
+ * collector_main - Collect the events of a fleet of agents
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the collector options and serves agents until SIGINT or SIGTERM,
+ * then prints a per-host report to stdout.
+ *
+ * Return: 0 on success, 1 on invalid arguments or if listening failed
+ */
+int collector_main(int argc, char* argv[]);
+
+#endif // RAVN_COLLECTOR_H
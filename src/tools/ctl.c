@@ -0,0 +1,126 @@
+// RAVN Control Client Implementation
+// Sends one command to the daemon's control socket and prints the answer
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "ctl.h"
+
+#include "../daemon/control.h"
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Print ctl usage
+static void ctl_usage(void) {
+	printf("Usage: ravn ctl [-s SOCKET] COMMAND [ARGS...]\n");
+	printf("\nOptions:\n");
+	printf("  -s, --socket PATH    Control socket (default %s)\n", CONTROL_SOCKET_PATH);
+	printf("\nCommands:\n");
+	printf("  top [n]                        Highest scoring processes (pid events score "
+	       "cgroup)\n");
+	printf("  cgroups [n]                    Highest scoring cgroups, container and pod\n");
+	printf("  features PID                   Feature vector of a process in the AI window\n");
+	printf("  monitors                       Per-monitor counters\n");
+	printf("  governor                       CPU budget level, monitor states, transitions\n");
+	printf("  filter [off | category=a,b pid=N comm=NAME\n");
+	printf("          cgroup=ID,.. | exclude-cgroup=ID,..]\n");
+	printf("                                 Show or set the event and cgroup filters\n");
+	printf("  sketch process|file|port|user [n]\n");
+	printf("                                 Heavy hitters (key count error), distinct count\n");
+	printf("  profile                        Timer profiling report (daemon run with -p)\n");
+	printf("  reload                         Reload the model, restart the AI window\n");
+	printf("  ping                           Check that the daemon answers\n");
+}
+
+int ctl_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"socket", required_argument, 0, 's'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	const char* path = CONTROL_SOCKET_PATH;
+	int opt;
+
+	// '+': stop at the command, its arguments are not options
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "+s:h", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 's':
+			path = optarg;
+			break;
+		case 'h':
+			ctl_usage();
+			return 0;
+		default:
+			ctl_usage();
+			return 1;
+		}
+	}
+	if (optind >= argc) {
+		ctl_usage();
+		return 1;
+	}
+
+	char request[CONTROL_MAX_LINE];
+	size_t len = 0;
+	for (int i = optind; i < argc; i++) {
+		int n = snprintf(request + len, sizeof(request) - len, "%s%s", i > optind ? " " : "",
+				 argv[i]);
+		if (n < 0 || (size_t)n >= sizeof(request) - len - 1) {
+			fprintf(stderr, "ravn ctl: command too long\n");
+			return 1;
+		}
+		len += (size_t)n;
+	}
+	request[len++] = '\n';
+
+	struct sockaddr_un addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if (fd < 0 || connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+		fprintf(stderr, "ravn ctl: cannot connect to %s: %s\n", path, strerror(errno));
+		if (fd >= 0) {
+			close(fd);
+		}
+		return 1;
+	}
+
+	// One request; the server closes the connection after answering it
+	if (write(fd, request, len) != (ssize_t)len) {
+		fprintf(stderr, "ravn ctl: send failed: %s\n", strerror(errno));
+		close(fd);
+		return 1;
+	}
+	shutdown(fd, SHUT_WR);
+
+	char response[CONTROL_MAX_RESPONSE + CONTROL_MAX_LINE];
+	size_t used = 0;
+	ssize_t n;
+	while (used < sizeof(response) - 1 &&
+	       (n = read(fd, response + used, sizeof(response) - 1 - used)) != 0) {
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+		used += (size_t)n;
+	}
+	close(fd);
+	response[used] = '\0';
+
+	// "OK <n>" header, then the result lines
+	if (strncmp(response, "OK ", 3) == 0) {
+		const char* body = strchr(response, '\n');
+		fputs(body ? body + 1 : "", stdout);
+		return 0;
+	}
+	fprintf(stderr, "ravn ctl: %s", used ? response : "no response\n");
+	return 1;
+}
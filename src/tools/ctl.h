@@ -0,0 +1,32 @@
+/*
+ * RAVN Control Client - Header File
+ *
+ * This header defines the command line client of the RAVN control server,
+ * used to query and control a running daemon over its Unix socket.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The control client implements:
+ * - One control command per invocation, built from the arguments
+ * - The response lines printed to stdout, errors to stderr
+ *
+ * Architecture:
+ * - Connects to CONTROL_SOCKET_PATH (or -s PATH), sends one line, reads
+ *   the response until the server has sent all announced lines
+ */
+
+#ifndef RAVN_CTL_H
+#define RAVN_CTL_H
+
+/**
+ * ctl_main - Send one command to the control server
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Return: 0 if the server answered OK, 1 on an error response or failure
+ */
+int ctl_main(int argc, char* argv[]);
+
+#endif // RAVN_CTL_H
@@ -0,0 +1,551 @@
+// RAVN Load Generator Implementation
+// Controlled syscall load per monitor with end-to-end drop-rate reporting
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "loadgen.h"
+
+#include "../daemon/ebpf_handler.h"
+#include "../daemon/overhead.h"
+#include "../daemon/redis_client.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <hiredis/hiredis.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Load generators, one per hooked activity
+enum loadgen_generator {
+	GEN_OPEN = 0,	/* openat + close of an existing file */
+	GEN_CREATE = 1, /* O_CREAT open + unlink of a new file */
+	GEN_MMAP = 2,	/* anonymous mmap + munmap */
+	GEN_EXEC = 3,	/* fork + execve + exit, thread create + exit */
+	GEN_TCP = 4,	/* loopback TCP send + drain */
+	GEN_PERF = 5,	/* getpid + brk */
+	GEN_MAX = 6
+};
+
+static const char* generator_names[GEN_MAX] = {"open", "create", "mmap", "exec", "tcp", "perf"};
+
+// Kernel events emitted per operation, by event category
+static const uint8_t generator_fanout[GEN_MAX][EVENT_CATEGORY_MAX + 1] = {
+	[GEN_OPEN] = {[EVENT_CATEGORY_SYSCALL] = 1, [EVENT_CATEGORY_FILE] = 1},
+	[GEN_CREATE] = {[EVENT_CATEGORY_SYSCALL] = 1,
+			[EVENT_CATEGORY_FILE] = 1,
+			[EVENT_CATEGORY_SECURITY] = 1},
+	[GEN_MMAP] = {[EVENT_CATEGORY_MEMORY] = 2},
+	[GEN_EXEC] = {[EVENT_CATEGORY_PROCESS] = 2},
+	[GEN_TCP] = {[EVENT_CATEGORY_NETWORK] = 1},
+	[GEN_PERF] = {[EVENT_CATEGORY_PERFORMANCE] = 2},
+};
+
+// Per-worker state
+struct loadgen_worker {
+	pthread_t thread;	   /* Worker thread */
+	int id;			   /* Worker index */
+	int tcp_tx;		   /* Loopback sender */
+	int tcp_rx;		   /* Loopback receiver */
+	char open_path[64];	   /* File reopened by GEN_OPEN */
+	char create_path[64];	   /* File created by GEN_CREATE */
+	uint64_t ops[GEN_MAX];	   /* Completed operations */
+	uint64_t errors[GEN_MAX];  /* Failed operations */
+};
+
+// Run configuration (set before workers start, read-only afterwards)
+static int cfg_threads = LOADGEN_DEFAULT_THREADS;
+static int cfg_duration = LOADGEN_DEFAULT_DURATION;
+static int cfg_settle = LOADGEN_DEFAULT_SETTLE;
+static double cfg_rate = 0.0;
+static int cfg_enabled[GEN_MAX];
+static const char* exec_path = "/bin/true";
+static uint64_t run_end_ns = 0;
+static volatile sig_atomic_t loadgen_stop = 0;
+
+// Stop the run early on SIGINT/SIGTERM
+static void loadgen_signal_handler(int sig) {
+	(void)sig;
+	loadgen_stop = 1;
+}
+
+// Thread body used to exercise sys_exit
+static void* exit_thread_func(void* arg) {
+	return arg;
+}
+
+// Run one operation of a generator
+static int run_operation(struct loadgen_worker* w, int gen) {
+	switch (gen) {
+	case GEN_OPEN: {
+		int fd = open(w->open_path, O_RDONLY);
+		if (fd < 0) {
+			return -1;
+		}
+		close(fd);
+		return 0;
+	}
+	case GEN_CREATE: {
+		int fd = open(w->create_path, O_CREAT | O_EXCL | O_WRONLY, 0600);
+		if (fd < 0) {
+			return -1;
+		}
+		close(fd);
+		return unlink(w->create_path);
+	}
+	case GEN_MMAP: {
+		void* p = mmap(NULL, 4096, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+			       0);
+		if (p == MAP_FAILED) {
+			return -1;
+		}
+		return munmap(p, 4096);
+	}
+	case GEN_EXEC: {
+		pid_t pid = fork();
+		if (pid < 0) {
+			return -1;
+		}
+		if (pid == 0) {
+			char* const child_argv[] = {(char*)exec_path, NULL};
+			char* const child_envp[] = {NULL};
+			execve(exec_path, child_argv, child_envp);
+			_exit(127);
+		}
+		int status;
+		waitpid(pid, &status, 0);
+
+		// Thread exit is what reaches sys_exit; processes use exit_group
+		pthread_t t;
+		if (pthread_create(&t, NULL, exit_thread_func, NULL) != 0) {
+			return -1;
+		}
+		pthread_join(t, NULL);
+		return WIFEXITED(status) && WEXITSTATUS(status) == 0 ? 0 : -1;
+	}
+	case GEN_TCP: {
+		char buf[64] = {0};
+		if (send(w->tcp_tx, buf, sizeof(buf), 0) != (ssize_t)sizeof(buf)) {
+			return -1;
+		}
+		while (recv(w->tcp_rx, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+		}
+		return 0;
+	}
+	case GEN_PERF:
+		// Raw syscalls: libc may cache getpid and skip brk(0)
+		syscall(SYS_getpid);
+		syscall(SYS_brk, 0);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+// Worker thread: run every enabled generator on its own pacing schedule
+static void* worker_thread_func(void* arg) {
+	struct loadgen_worker* w = (struct loadgen_worker*)arg;
+
+	// Target rate is per generator across all workers; 0 means unlimited
+	uint64_t interval_ns = cfg_rate > 0 ? (uint64_t)(1e9 * cfg_threads / cfg_rate) : 0;
+	uint64_t now = ravn_prof_now_ns();
+	uint64_t due[GEN_MAX];
+	for (int g = 0; g < GEN_MAX; g++) {
+		due[g] = now;
+	}
+
+	while (!loadgen_stop && now < run_end_ns) {
+		uint64_t next = run_end_ns;
+
+		for (int g = 0; g < GEN_MAX; g++) {
+			if (!cfg_enabled[g]) {
+				continue;
+			}
+			if (now >= due[g]) {
+				if (run_operation(w, g) == 0) {
+					w->ops[g]++;
+				} else {
+					w->errors[g]++;
+				}
+				// Do not burst to catch up after falling behind
+				due[g] = due[g] + interval_ns < now ? now : due[g] + interval_ns;
+			}
+			if (due[g] < next) {
+				next = due[g];
+			}
+		}
+
+		now = ravn_prof_now_ns();
+		if (next > now) {
+			uint64_t wait = next - now;
+			struct timespec ts = {(time_t)(wait / 1000000000ULL),
+					      (long)(wait % 1000000000ULL)};
+			nanosleep(&ts, NULL);
+			now = ravn_prof_now_ns();
+		}
+	}
+
+	return NULL;
+}
+
+// Connect a loopback TCP pair for the network generator
+static int setup_tcp_pair(struct loadgen_worker* w) {
+	struct sockaddr_in addr;
+	socklen_t len = sizeof(addr);
+	int one = 1;
+
+	int listener = socket(AF_INET, SOCK_STREAM, 0);
+	if (listener < 0) {
+		return -1;
+	}
+
+	memset(&addr, 0, sizeof(addr));
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (bind(listener, (struct sockaddr*)&addr, sizeof(addr)) != 0 || listen(listener, 1) != 0 ||
+	    getsockname(listener, (struct sockaddr*)&addr, &len) != 0) {
+		close(listener);
+		return -1;
+	}
+
+	w->tcp_tx = socket(AF_INET, SOCK_STREAM, 0);
+	if (w->tcp_tx < 0 || connect(w->tcp_tx, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+		close(listener);
+		return -1;
+	}
+	setsockopt(w->tcp_tx, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+	w->tcp_rx = accept(listener, NULL, NULL);
+	close(listener);
+	return w->tcp_rx < 0 ? -1 : 0;
+}
+
+// Prepare per-worker files and sockets
+static int setup_worker(struct loadgen_worker* w, int id) {
+	memset(w, 0, sizeof(*w));
+	w->id = id;
+	w->tcp_tx = -1;
+	w->tcp_rx = -1;
+
+	snprintf(w->open_path, sizeof(w->open_path), "/tmp/ravn-loadgen-%d-%d", (int)getpid(), id);
+	snprintf(w->create_path, sizeof(w->create_path), "/tmp/ravn-loadgen-%d-%d.new",
+		 (int)getpid(), id);
+
+	if (cfg_enabled[GEN_OPEN]) {
+		int fd = open(w->open_path, O_CREAT | O_WRONLY | O_TRUNC, 0600);
+		if (fd < 0) {
+			LOG_ERROR_MODULE("LOADGEN", "Failed to create %s: %s", w->open_path,
+					 strerror(errno));
+			return -1;
+		}
+		close(fd);
+	}
+
+	if (cfg_enabled[GEN_TCP] && setup_tcp_pair(w) != 0) {
+		LOG_ERROR_MODULE("LOADGEN", "Failed to set up loopback TCP pair: %s",
+				 strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+// Release per-worker files and sockets
+static void cleanup_worker(struct loadgen_worker* w) {
+	if (w->tcp_tx >= 0) {
+		close(w->tcp_tx);
+	}
+	if (w->tcp_rx >= 0) {
+		close(w->tcp_rx);
+	}
+	unlink(w->open_path);
+	unlink(w->create_path);
+}
+
+// Read delivered-event counters and update time from the daemon metrics
+static int read_daemon_counters(redis_connection_t* conn, uint64_t* events, long* updated) {
+	char fields[EVENT_CATEGORY_MAX + 1][32];
+	const char* argv[EVENT_CATEGORY_MAX + 3];
+	int argc = 0;
+
+	argv[argc++] = "HMGET";
+	argv[argc++] = OVERHEAD_REDIS_KEY;
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		snprintf(fields[cat], sizeof(fields[cat]), "%s_events",
+			 get_event_category_name(cat));
+		argv[argc++] = fields[cat];
+	}
+	argv[argc++] = "updated";
+
+	redisReply* reply = redisCommandArgv(conn->context, argc, argv, NULL);
+	if (!reply || reply->type != REDIS_REPLY_ARRAY || (int)reply->elements != argc - 2) {
+		if (reply) {
+			freeReplyObject(reply);
+		}
+		return -1;
+	}
+
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		redisReply* r = reply->element[cat - 1];
+		events[cat] = r->type == REDIS_REPLY_STRING ? strtoull(r->str, NULL, 10) : 0;
+	}
+	redisReply* r = reply->element[EVENT_CATEGORY_MAX];
+	*updated = r->type == REDIS_REPLY_STRING ? atol(r->str) : 0;
+
+	freeReplyObject(reply);
+	return *updated > 0 ? 0 : -1;
+}
+
+// Wait until the daemon publishes counters taken after @after (epoch seconds)
+static int wait_daemon_counters(redis_connection_t* conn, uint64_t* events, long after) {
+	long updated = 0;
+	for (int i = 0; i < cfg_settle * 2; i++) {
+		if (read_daemon_counters(conn, events, &updated) == 0 && updated > after) {
+			return 0;
+		}
+		usleep(500000);
+	}
+	return -1;
+}
+
+// Enable generators from a comma-separated list
+static int parse_generators(const char* list) {
+	char buf[256];
+	snprintf(buf, sizeof(buf), "%s", list);
+	memset(cfg_enabled, 0, sizeof(cfg_enabled));
+
+	char* save = NULL;
+	for (char* tok = strtok_r(buf, ",", &save); tok; tok = strtok_r(NULL, ",", &save)) {
+		int found = 0;
+		for (int g = 0; g < GEN_MAX; g++) {
+			if (strcmp(tok, "all") == 0 || strcmp(tok, generator_names[g]) == 0) {
+				cfg_enabled[g] = 1;
+				found = 1;
+			}
+		}
+		if (!found) {
+			fprintf(stderr, "Unknown generator: %s\n", tok);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Print loadgen usage
+static void loadgen_usage(void) {
+	printf("Usage: ravn loadgen [OPTIONS]\n");
+	printf("\nOptions:\n");
+	printf("  -t, --threads N      Worker threads (default %d)\n", LOADGEN_DEFAULT_THREADS);
+	printf("  -d, --duration SEC   Run time in seconds (default %d)\n",
+	       LOADGEN_DEFAULT_DURATION);
+	printf("  -r, --rate OPS       Target ops/sec per generator, 0 = unlimited (default 0)\n");
+	printf("  -g, --generators L   Comma list of open,create,mmap,exec,tcp,perf or all\n");
+	printf("  -s, --settle SEC     Wait for daemon metrics after the run (default %d)\n",
+	       LOADGEN_DEFAULT_SETTLE);
+	printf("\nEach worker runs every selected generator in turn, so at unlimited rate the\n");
+	printf("slowest one (exec) paces the rest; run it on its own for peak rates.\n");
+	printf("Drop rates need a running daemon; its ravn:overhead counters are compared\n");
+	printf("with the events the generated operations must have produced.\n");
+}
+
+// Print the per-generator and per-category report
+static void print_report(struct loadgen_worker* workers, double elapsed_s, const uint64_t* before,
+			 const uint64_t* after, int have_daemon) {
+	uint64_t ops[GEN_MAX] = {0};
+	uint64_t errors[GEN_MAX] = {0};
+	for (int i = 0; i < cfg_threads; i++) {
+		for (int g = 0; g < GEN_MAX; g++) {
+			ops[g] += workers[i].ops[g];
+			errors[g] += workers[i].errors[g];
+		}
+	}
+
+	printf("\nLoad generated for %.2f s on %d thread(s)\n\n", elapsed_s, cfg_threads);
+	printf("%-10s %12s %12s %10s\n", "GENERATOR", "OPS", "OPS/S", "ERRORS");
+	for (int g = 0; g < GEN_MAX; g++) {
+		if (cfg_enabled[g]) {
+			printf("%-10s %12lu %12.0f %10lu\n", generator_names[g],
+			       (unsigned long)ops[g], ops[g] / elapsed_s, (unsigned long)errors[g]);
+		}
+	}
+
+	printf("\n%-12s %12s %12s %12s %8s\n", "CATEGORY", "EXPECTED", "DELIVERED", "EVENTS/S",
+	       "DROP%");
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		uint64_t expected = 0;
+		for (int g = 0; g < GEN_MAX; g++) {
+			expected += ops[g] * generator_fanout[g][cat];
+		}
+
+		// The network monitor emits at most one event per second in BPF
+		if (cat == EVENT_CATEGORY_NETWORK && expected > (uint64_t)elapsed_s + 1) {
+			expected = (uint64_t)elapsed_s + 1;
+		}
+		if (expected == 0) {
+			continue;
+		}
+
+		if (!have_daemon) {
+			printf("%-12s %12lu %12s %12s %8s\n", get_event_category_name(cat),
+			       (unsigned long)expected, "-", "-", "-");
+			continue;
+		}
+
+		uint64_t delivered = after[cat] - before[cat];
+		double drop = delivered >= expected ? 0.0
+						    : (double)(expected - delivered) * 100.0 / expected;
+		printf("%-12s %12lu %12lu %12.0f %7.2f%%\n", get_event_category_name(cat),
+		       (unsigned long)expected, (unsigned long)delivered, delivered / elapsed_s,
+		       drop);
+	}
+
+	if (have_daemon) {
+		printf("\nDelivered counts include unrelated host activity, so drops are a lower "
+		       "bound.\n");
+	} else {
+		printf("\nNo daemon metrics (ravn:overhead) available; drop rates not measured.\n");
+	}
+}
+
+// Run the load generator
+int loadgen_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"threads", required_argument, 0, 't'},
+					       {"duration", required_argument, 0, 'd'},
+					       {"rate", required_argument, 0, 'r'},
+					       {"generators", required_argument, 0, 'g'},
+					       {"settle", required_argument, 0, 's'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	int opt;
+
+	for (int g = 0; g < GEN_MAX; g++) {
+		cfg_enabled[g] = 1;
+	}
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "t:d:r:g:s:h", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 't':
+			cfg_threads = atoi(optarg);
+			break;
+		case 'd':
+			cfg_duration = atoi(optarg);
+			break;
+		case 'r':
+			cfg_rate = atof(optarg);
+			break;
+		case 'g':
+			if (parse_generators(optarg) != 0) {
+				return 1;
+			}
+			break;
+		case 's':
+			cfg_settle = atoi(optarg);
+			break;
+		case 'h':
+			loadgen_usage();
+			return 0;
+		default:
+			loadgen_usage();
+			return 1;
+		}
+	}
+
+	if (cfg_threads <= 0 || cfg_threads > LOADGEN_MAX_THREADS || cfg_duration <= 0 ||
+	    cfg_rate < 0 || cfg_settle < 0) {
+		loadgen_usage();
+		return 1;
+	}
+
+	if (access(exec_path, X_OK) != 0) {
+		exec_path = "/usr/bin/true";
+	}
+
+	struct loadgen_worker* workers = calloc(cfg_threads, sizeof(*workers));
+	if (!workers) {
+		LOG_ERROR_MODULE("LOADGEN", "Failed to allocate %d workers", cfg_threads);
+		return 1;
+	}
+
+	int result = 0;
+	int ready = 0;
+	for (; ready < cfg_threads; ready++) {
+		if (setup_worker(&workers[ready], ready) != 0) {
+			result = 1;
+			break;
+		}
+	}
+
+	// Baseline of the daemon counters; loadgen still runs without a daemon
+	uint64_t before[EVENT_CATEGORY_MAX + 1] = {0};
+	uint64_t after[EVENT_CATEGORY_MAX + 1] = {0};
+	long updated = 0;
+	redis_connection_t* conn = result == 0 ? redis_connect("127.0.0.1", 6379) : NULL;
+	int have_daemon = conn && read_daemon_counters(conn, before, &updated) == 0;
+	if (have_daemon) {
+		// Counters published before the run started could miss in-flight events
+		have_daemon = wait_daemon_counters(conn, before, updated) == 0;
+	}
+
+	if (result == 0) {
+		signal(SIGINT, loadgen_signal_handler);
+		signal(SIGTERM, loadgen_signal_handler);
+
+		char rate_str[32] = "max";
+		if (cfg_rate > 0) {
+			snprintf(rate_str, sizeof(rate_str), "%.0f", cfg_rate);
+		}
+		LOG_INFO_MODULE("LOADGEN", "Running %d thread(s) for %d s at %s ops/s per generator",
+				cfg_threads, cfg_duration, rate_str);
+
+		uint64_t start = ravn_prof_now_ns();
+		run_end_ns = start + (uint64_t)cfg_duration * 1000000000ULL;
+
+		int started = 0;
+		for (; started < cfg_threads; started++) {
+			if (pthread_create(&workers[started].thread, NULL, worker_thread_func,
+					   &workers[started]) != 0) {
+				LOG_ERROR_MODULE("LOADGEN", "Failed to start worker %d", started);
+				loadgen_stop = 1;
+				result = 1;
+				break;
+			}
+		}
+		for (int i = 0; i < started; i++) {
+			pthread_join(workers[i].thread, NULL);
+		}
+		double elapsed_s = (ravn_prof_now_ns() - start) / 1e9;
+		long end_wall = (long)time(NULL);
+
+		if (have_daemon) {
+			printf("Waiting up to %d s for daemon metrics...\n", cfg_settle);
+			have_daemon = wait_daemon_counters(conn, after, end_wall) == 0;
+		}
+
+		print_report(workers, elapsed_s, before, after, have_daemon);
+	}
+
+	if (conn) {
+		redis_disconnect(conn);
+	}
+	// A worker that failed setup may hold partial resources too
+	for (int i = 0; i < ready + 1 && i < cfg_threads; i++) {
+		cleanup_worker(&workers[i]);
+	}
+	free(workers);
+	return result;
+}
@@ -0,0 +1,50 @@
+/*
+ * RAVN Load Generator - Header File
+ *
+ * This header defines the synthetic load generator for the RAVN security
+ * platform, producing controlled rates of the exact kernel activity each
+ * eBPF monitor hooks so end-to-end throughput and drop rates can be
+ * measured on any Linux box.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The load generator implements:
+ * - One generator per monitor (openat, vfs_open, inode create, mmap/munmap,
+ *   execve/exit, loopback TCP send, getpid/brk)
+ * - Per-category target rates across N worker threads for a set duration
+ * - Expected event counts per category from known per-operation fan-out
+ * - Delivered counts from the daemon's ravn:overhead metrics
+ * - Sustained events/sec and drop percentage per category
+ *
+ * Architecture:
+ * - Each worker runs every selected generator on its own pacing schedule
+ * - Generators issue raw syscalls so libc caching cannot hide events
+ * - Daemon counters are sampled before the run and after it has settled
+ */
+
+#ifndef RAVN_LOADGEN_H
+#define RAVN_LOADGEN_H
+
+/*
+ * Load Generator Configuration Parameters
+ */
+#define LOADGEN_MAX_THREADS	 256 /* Worker thread limit */
+#define LOADGEN_DEFAULT_THREADS	 4   /* Worker threads */
+#define LOADGEN_DEFAULT_DURATION 10  /* Run time in seconds */
+#define LOADGEN_DEFAULT_SETTLE	 12  /* Wait for daemon metrics in seconds */
+
+/**
+ * loadgen_main - Run the load generator
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the loadgen options, runs the workers and prints the per-category
+ * report to stdout.
+ *
+ * Return: 0 on success, 1 on invalid arguments or setup failure
+ */
+int loadgen_main(int argc, char* argv[]);
+
+#endif // RAVN_LOADGEN_H
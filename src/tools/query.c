@@ -0,0 +1,1236 @@
+// RAVN Event Queries Implementation
+// Parallel, vectorized scans of stored event segments
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "query.h"
+
+#include "../daemon/event_types.h"
+#include "../daemon/store.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/prctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Four 32-bit or two 64-bit lanes: one vector register on every supported target
+typedef uint32_t query_u32x4 __attribute__((vector_size(16)));
+typedef uint64_t query_u64x2 __attribute__((vector_size(16)));
+
+enum query_format {
+	QUERY_FORMAT_JSONL = 0,
+	QUERY_FORMAT_CSV = 1
+};
+
+// String predicate resolved against one segment dictionary
+struct query_match {
+	uint32_t count;			/* Matching IDs */
+	uint32_t ids[QUERY_MAX_VALUES]; /* The IDs, while count <= QUERY_MAX_VALUES */
+	uint64_t* bitmap;		/* All matching IDs, once count > QUERY_MAX_VALUES */
+};
+
+// One segment file of the query
+struct query_segment {
+	char* path;
+	int usable; /* Opened and not pruned */
+	struct store_segment seg;
+	struct query_match comm;
+	struct query_match file;
+	struct query_match host;
+};
+
+// One block to scan, with its formatted output
+struct query_unit {
+	struct query_segment* segment;
+	uint32_t block;
+	int done;
+	uint64_t matches;
+	char* out;
+	size_t len;
+};
+
+// Growable output buffer of one block
+struct query_buffer {
+	char* data;
+	size_t len;
+	size_t cap;
+	int failed;
+};
+
+// Worker thread state
+struct query_worker {
+	int index;
+	pthread_t thread;
+	uint32_t sel[STORE_BLOCK_EVENTS]; /* Selection mask, 0 or ~0 per event */
+	time_t time_sec;		  /* Second formatted in @time_text */
+	char time_text[32];
+	char zone[8];
+
+	// Columns of the block being scanned: the mapped arrays of a plain
+	// block, or decoded on first use (categories always widened)
+	const uint64_t* ts;
+	const uint32_t* column[STORE_COLUMNS];
+	uint64_t ts_buf[STORE_BLOCK_EVENTS];
+	uint32_t column_buf[STORE_COLUMNS][STORE_BLOCK_EVENTS];
+
+	// Results
+	uint64_t blocks;
+	uint64_t bytes;
+	uint64_t events;
+	uint64_t corrupt;
+};
+
+// Query options
+static int cfg_workers = 0; /* 0 = online CPUs */
+static enum query_format cfg_format = QUERY_FORMAT_JSONL;
+static int cfg_count = 0;
+static uint64_t cfg_limit = 0;
+static uint64_t cfg_from = 0;
+static uint64_t cfg_to = UINT64_MAX;
+static int cfg_has_pid = 0;
+static uint32_t cfg_pid = 0;
+static int cfg_has_uid = 0;
+static uint32_t cfg_uid = 0;
+static uint32_t cfg_categories = 0; /* Category bitmask, 0 = all */
+static const char* cfg_events = NULL;
+static const char* cfg_comm = NULL;
+static const char* cfg_path = NULL;
+static const char* cfg_host = NULL;
+
+// --event resolved into category/type pairs
+static uint32_t type_category[QUERY_MAX_TYPES];
+static uint32_t type_value[QUERY_MAX_TYPES];
+static int type_count = 0;
+
+// Segments and blocks of the query
+static struct query_segment* segments = NULL;
+static int segment_count = 0;
+static struct query_unit* units = NULL;
+static size_t unit_count = 0;
+
+// Work distribution, protected by query_lock
+static pthread_mutex_t query_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t query_cond = PTHREAD_COND_INITIALIZER;
+static size_t next_item = 0;
+static size_t emitted = 0;
+static size_t window = 0;
+static int query_stop = 0;
+static int limit_reached = 0;
+
+// Pruning counters
+static uint64_t pruned_segments = 0;
+static uint64_t pruned_blocks = 0;
+static uint64_t pruned_events = 0;
+
+// Event type name within a category
+static const char* query_type_name(uint32_t category, uint32_t type) {
+	switch (category) {
+	case EVENT_CATEGORY_SYSCALL:
+		return get_syscall_name(type);
+	case EVENT_CATEGORY_NETWORK:
+		return get_network_event_name(type);
+	case EVENT_CATEGORY_SECURITY:
+		return get_security_event_name(type);
+	case EVENT_CATEGORY_FILE:
+		return get_file_event_name(type);
+	case EVENT_CATEGORY_MEMORY:
+		return get_memory_event_name(type);
+	case EVENT_CATEGORY_PROCESS:
+		return get_process_event_name(type);
+	case EVENT_CATEGORY_KERNEL:
+		return get_kernel_event_name(type);
+	case EVENT_CATEGORY_PERFORMANCE:
+		return get_performance_event_name(type);
+	default:
+		return "unknown";
+	}
+}
+
+// Parse a comma-separated category list into a bitmask
+static int parse_categories(char* list, uint32_t* mask) {
+	*mask = 0;
+	for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+		uint32_t c = 1;
+		while (c <= EVENT_CATEGORY_MAX &&
+		       strcasecmp(name, get_event_category_name(c)) != 0) {
+			c++;
+		}
+		if (c > EVENT_CATEGORY_MAX) {
+			fprintf(stderr, "Unknown category '%s'\n", name);
+			return -1;
+		}
+		*mask |= 1u << c;
+	}
+	return *mask ? 0 : -1;
+}
+
+// Add one category/type pair to the --event predicate
+static int add_type(uint32_t category, uint32_t type) {
+	for (int i = 0; i < type_count; i++) {
+		if (type_category[i] == category && type_value[i] == type) {
+			return 0;
+		}
+	}
+	if (type_count == QUERY_MAX_TYPES) {
+		fprintf(stderr, "Too many event types (limit %d)\n", QUERY_MAX_TYPES);
+		return -1;
+	}
+	type_category[type_count] = category;
+	type_value[type_count] = type;
+	type_count++;
+	return 0;
+}
+
+// Resolve the --event list: names match with or without the category prefix
+// ("exec" or "process_exec"); numbers match that type in every category. The
+// categories of the matched types then restrict the category mask.
+static int resolve_events(char* list) {
+	uint32_t allowed = cfg_categories ? cfg_categories : ~0u;
+	uint32_t found = 0;
+
+	for (char* name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+		char* end;
+		unsigned long number = strtoul(name, &end, 0);
+		int matched = 0;
+
+		for (uint32_t c = 1; c <= EVENT_CATEGORY_MAX; c++) {
+			if (!(allowed & (1u << c))) {
+				continue;
+			}
+			if (*end == '\0' && end != name) {
+				if (add_type(c, (uint32_t)number) != 0) {
+					return -1;
+				}
+				found |= 1u << c;
+				matched = 1;
+				continue;
+			}
+
+			const char* category = get_event_category_name(c);
+			size_t prefix = strlen(category);
+			for (uint32_t t = 0; t < QUERY_TYPE_SCAN; t++) {
+				const char* type = query_type_name(c, t);
+				if (strcmp(type, "unknown") == 0) {
+					continue;
+				}
+				int prefixed = strncasecmp(type, category, prefix) == 0 &&
+					       type[prefix] == '_';
+				if (strcasecmp(type, name) == 0 ||
+				    (prefixed && strcasecmp(type + prefix + 1, name) == 0)) {
+					if (add_type(c, t) != 0) {
+						return -1;
+					}
+					found |= 1u << c;
+					matched = 1;
+				}
+			}
+		}
+		if (!matched) {
+			fprintf(stderr, "Unknown event type '%s'\n", name);
+			return -1;
+		}
+	}
+
+	cfg_categories = found;
+	return 0;
+}
+
+// Parse a local time: "YYYY-mm-dd[ HH:MM[:SS]]", "HH:MM[:SS]" (today) or
+// "@SECONDS" since the epoch
+static int parse_time(const char* text, uint64_t* out) {
+	if (text[0] == '@') {
+		char* end;
+		unsigned long long seconds = strtoull(text + 1, &end, 10);
+		if (end == text + 1 || *end != '\0') {
+			return -1;
+		}
+		*out = seconds * 1000000000ULL;
+		return 0;
+	}
+
+	time_t now = time(NULL);
+	struct tm tm;
+	localtime_r(&now, &tm);
+	int year = tm.tm_year + 1900, month = tm.tm_mon + 1, day = tm.tm_mday;
+	int hour = 0, minute = 0, second = 0;
+	int y, m, d;
+	int used = 0;
+
+	if (sscanf(text, "%d-%d-%d%n", &y, &m, &d, &used) == 3) {
+		const char* rest = text + used;
+		year = y;
+		month = m;
+		day = d;
+		if (*rest == ' ' || *rest == 'T') {
+			int more = 0;
+			if (sscanf(rest + 1, "%d:%d%n:%d%n", &hour, &minute, &more, &second,
+				   &more) < 2) {
+				return -1;
+			}
+			rest += 1 + more;
+		}
+		if (*rest != '\0') {
+			return -1;
+		}
+	} else if (sscanf(text, "%d:%d%n:%d%n", &hour, &minute, &used, &second, &used) < 2 ||
+		   text[used] != '\0') {
+		return -1;
+	}
+
+	memset(&tm, 0, sizeof(tm));
+	tm.tm_year = year - 1900;
+	tm.tm_mon = month - 1;
+	tm.tm_mday = day;
+	tm.tm_hour = hour;
+	tm.tm_min = minute;
+	tm.tm_sec = second;
+	tm.tm_isdst = -1;
+	time_t t = mktime(&tm);
+	if (t == (time_t)-1 || t < 0) {
+		return -1;
+	}
+	*out = (uint64_t)t * 1000000000ULL;
+	return 0;
+}
+
+// Order segment names; names sort by time within a directory
+static int compare_paths(const void* a, const void* b) {
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Note one dictionary ID matching a string predicate
+static int match_add(struct query_match* m, uint32_t id, uint32_t entries) {
+	if (m->count == QUERY_MAX_VALUES && !m->bitmap) {
+		m->bitmap = calloc((entries + 63) / 64, sizeof(uint64_t));
+		if (!m->bitmap) {
+			return -1;
+		}
+		for (uint32_t i = 0; i < m->count; i++) {
+			m->bitmap[m->ids[i] / 64] |= 1ULL << (m->ids[i] % 64);
+		}
+	}
+	if (m->bitmap) {
+		m->bitmap[id / 64] |= 1ULL << (id % 64);
+	} else {
+		m->ids[m->count] = id;
+	}
+	m->count++;
+	return 0;
+}
+
+// Match a shell pattern against every string of a segment dictionary
+static int match_dictionary(const struct store_segment* seg, const char* pattern,
+			    struct query_match* m) {
+	int exact = strpbrk(pattern, "*?[") == NULL;
+	size_t pattern_len = strlen(pattern);
+	char text[STORE_MAX_STRING + 1];
+
+	for (uint32_t id = 1; id < seg->dict_entries; id++) {
+		size_t len = seg->dict_len[id];
+		int hit;
+		if (exact) {
+			hit = len == pattern_len && memcmp(seg->dict[id], pattern, len) == 0;
+		} else {
+			memcpy(text, seg->dict[id], len);
+			text[len] = '\0';
+			hit = fnmatch(pattern, text, 0) == 0;
+		}
+		if (hit && match_add(m, id, seg->dict_entries) != 0) {
+			return -1;
+		}
+		if (hit && exact) {
+			break; // Dictionary strings are unique
+		}
+	}
+	return 0;
+}
+
+// Open a segment unless its time partition, block index or dictionary rules
+// out every event
+static void open_segment(struct query_segment* s) {
+	struct store_file_header header;
+	int fd = open(s->path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0) {
+		LOG_WARN_MODULE("QUERY", "Skipping %s: %s", s->path, strerror(errno));
+		return;
+	}
+	ssize_t n = pread(fd, &header, sizeof(header), 0);
+	close(fd);
+	if (n == (ssize_t)sizeof(header) &&
+	    (header.partition_start_ns >= cfg_to ||
+	     header.partition_start_ns + header.partition_ns <= cfg_from)) {
+		__atomic_fetch_add(&pruned_segments, 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	if (store_segment_open(&s->seg, s->path) != 0) {
+		LOG_WARN_MODULE("QUERY", "Skipping %s: not a readable segment", s->path);
+		return;
+	}
+
+	uint64_t min_ts = UINT64_MAX;
+	uint64_t max_ts = 0;
+	for (uint32_t b = 0; b < s->seg.blocks; b++) {
+		min_ts = s->seg.index[b].min_ts < min_ts ? s->seg.index[b].min_ts : min_ts;
+		max_ts = s->seg.index[b].max_ts > max_ts ? s->seg.index[b].max_ts : max_ts;
+	}
+	int pruned = s->seg.blocks == 0 || min_ts >= cfg_to || max_ts < cfg_from;
+
+	if (!pruned && cfg_comm) {
+		pruned = match_dictionary(&s->seg, cfg_comm, &s->comm) != 0 || s->comm.count == 0;
+	}
+	if (!pruned && cfg_path) {
+		pruned = match_dictionary(&s->seg, cfg_path, &s->file) != 0 || s->file.count == 0;
+	}
+	if (!pruned && cfg_host) {
+		pruned = match_dictionary(&s->seg, cfg_host, &s->host) != 0 || s->host.count == 0;
+	}
+	if (pruned) {
+		__atomic_fetch_add(&pruned_segments, 1, __ATOMIC_RELAXED);
+		store_segment_close(&s->seg);
+		return;
+	}
+	s->usable = 1;
+}
+
+// Open-phase worker: open and match segments in parallel
+static void* open_thread_func(void* arg) {
+	(void)arg;
+	for (;;) {
+		size_t k = __atomic_fetch_add(&next_item, 1, __ATOMIC_RELAXED);
+		if (k >= (size_t)segment_count) {
+			break;
+		}
+		open_segment(&segments[k]);
+	}
+	return NULL;
+}
+
+// sel &= (col == any of values), four lanes at a time
+static void filter_in(uint32_t* restrict sel, const uint32_t* restrict col, uint32_t n,
+		      const uint32_t* values, uint32_t count) {
+	query_u32x4 splat[QUERY_MAX_VALUES];
+	for (uint32_t k = 0; k < count; k++) {
+		splat[k] = (query_u32x4){values[k], values[k], values[k], values[k]};
+	}
+
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		query_u32x4 c, m;
+		query_u32x4 any = {0, 0, 0, 0};
+		memcpy(&c, col + i, sizeof(c));
+		for (uint32_t k = 0; k < count; k++) {
+			any |= (query_u32x4)(c == splat[k]);
+		}
+		memcpy(&m, sel + i, sizeof(m));
+		m &= any;
+		memcpy(sel + i, &m, sizeof(m));
+	}
+	for (; i < n; i++) {
+		uint32_t any = 0;
+		for (uint32_t k = 0; k < count; k++) {
+			any |= col[i] == values[k];
+		}
+		sel[i] &= -any;
+	}
+}
+
+// sel &= (bit col of bitmap); a gather, for patterns matching many strings
+static void filter_bitmap(uint32_t* restrict sel, const uint32_t* restrict col, uint32_t n,
+			  const uint64_t* bitmap, uint32_t entries) {
+	for (uint32_t i = 0; i < n; i++) {
+		uint32_t id = col[i] < entries ? col[i] : 0;
+		sel[i] &= -(uint32_t)((bitmap[id / 64] >> (id % 64)) & 1);
+	}
+}
+
+// sel &= from <= ts < to, two 64-bit lanes at a time
+static void filter_time(uint32_t* restrict sel, const uint64_t* restrict ts, uint32_t n,
+			uint64_t from, uint64_t to) {
+	const query_u64x2 lo = {from, from};
+	const query_u64x2 hi = {to, to};
+
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		query_u64x2 a, b;
+		query_u32x4 m;
+		memcpy(&a, ts + i, sizeof(a));
+		memcpy(&b, ts + i + 2, sizeof(b));
+		query_u64x2 ma = (query_u64x2)(a >= lo) & (query_u64x2)(a < hi);
+		query_u64x2 mb = (query_u64x2)(b >= lo) & (query_u64x2)(b < hi);
+		query_u32x4 both = {(uint32_t)ma[0], (uint32_t)ma[1], (uint32_t)mb[0],
+				    (uint32_t)mb[1]};
+		memcpy(&m, sel + i, sizeof(m));
+		m &= both;
+		memcpy(sel + i, &m, sizeof(m));
+	}
+	for (; i < n; i++) {
+		sel[i] &= -(uint32_t)(ts[i] >= from && ts[i] < to);
+	}
+}
+
+// sel &= category in mask, four lanes at a time
+static void filter_categories(uint32_t* restrict sel, const uint32_t* restrict category,
+			      uint32_t n, uint32_t mask) {
+	const query_u32x4 bits = {mask, mask, mask, mask};
+	const query_u32x4 low = {31, 31, 31, 31};
+	const query_u32x4 one = {1, 1, 1, 1};
+
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		query_u32x4 c, m;
+		memcpy(&c, category + i, sizeof(c));
+		memcpy(&m, sel + i, sizeof(m));
+		m &= -((bits >> (c & low)) & one);
+		memcpy(sel + i, &m, sizeof(m));
+	}
+	for (; i < n; i++) {
+		sel[i] &= -((mask >> (category[i] & 31)) & 1);
+	}
+}
+
+// sel &= (category, type) is one of the --event pairs, four lanes at a time
+static void filter_types(uint32_t* restrict sel, const uint32_t* restrict category,
+			 const uint32_t* restrict type, uint32_t n) {
+	query_u32x4 want_category[QUERY_MAX_TYPES];
+	query_u32x4 want_type[QUERY_MAX_TYPES];
+	for (int k = 0; k < type_count; k++) {
+		uint32_t c = type_category[k];
+		uint32_t t = type_value[k];
+		want_category[k] = (query_u32x4){c, c, c, c};
+		want_type[k] = (query_u32x4){t, t, t, t};
+	}
+
+	uint32_t i = 0;
+	for (; i + 4 <= n; i += 4) {
+		query_u32x4 c, t, m;
+		query_u32x4 any = {0, 0, 0, 0};
+		memcpy(&c, category + i, sizeof(c));
+		memcpy(&t, type + i, sizeof(t));
+		for (int k = 0; k < type_count; k++) {
+			any |= (query_u32x4)(c == want_category[k]) &
+			       (query_u32x4)(t == want_type[k]);
+		}
+		memcpy(&m, sel + i, sizeof(m));
+		m &= any;
+		memcpy(sel + i, &m, sizeof(m));
+	}
+	for (; i < n; i++) {
+		uint32_t any = 0;
+		for (int k = 0; k < type_count; k++) {
+			any |= category[i] == type_category[k] && type[i] == type_value[k];
+		}
+		sel[i] &= -any;
+	}
+}
+
+// Apply a resolved string predicate to an ID column
+static void filter_match(uint32_t* restrict sel, const uint32_t* restrict col, uint32_t n,
+			 const struct query_match* m, uint32_t entries) {
+	if (m->bitmap) {
+		filter_bitmap(sel, col, n, m->bitmap, entries);
+	} else {
+		filter_in(sel, col, n, m->ids, m->count);
+	}
+}
+
+// Make room for @extra more bytes
+static char* buffer_reserve(struct query_buffer* b, size_t extra) {
+	if (b->failed) {
+		return NULL;
+	}
+	if (b->len + extra > b->cap) {
+		size_t cap = b->cap ? b->cap : 65536;
+		while (cap < b->len + extra) {
+			cap *= 2;
+		}
+		char* data = realloc(b->data, cap);
+		if (!data) {
+			b->failed = 1;
+			return NULL;
+		}
+		b->data = data;
+		b->cap = cap;
+	}
+	return b->data + b->len;
+}
+
+// Append a short formatted field
+static void buffer_printf(struct query_buffer* b, const char* fmt, ...)
+	__attribute__((format(printf, 2, 3)));
+static void buffer_printf(struct query_buffer* b, const char* fmt, ...) {
+	char* p = buffer_reserve(b, 256);
+	if (!p) {
+		return;
+	}
+	va_list ap;
+	va_start(ap, fmt);
+	int n = vsnprintf(p, 256, fmt, ap);
+	va_end(ap);
+	if (n > 0) {
+		b->len += (size_t)(n < 256 ? n : 255);
+	}
+}
+
+// Append a string as a quoted JSON string
+static void buffer_json_string(struct query_buffer* b, const char* s, size_t len) {
+	char* p = buffer_reserve(b, len * 6 + 2);
+	if (!p) {
+		return;
+	}
+	char* start = p;
+	*p++ = '"';
+	for (size_t i = 0; i < len; i++) {
+		unsigned char c = (unsigned char)s[i];
+		if (c == '"' || c == '\\') {
+			*p++ = '\\';
+			*p++ = (char)c;
+		} else if (c < 0x20) {
+			p += sprintf(p, "\\u%04x", c);
+		} else {
+			*p++ = (char)c;
+		}
+	}
+	*p++ = '"';
+	b->len += (size_t)(p - start);
+}
+
+// Append a string as a CSV field, quoted only when needed
+static void buffer_csv_string(struct query_buffer* b, const char* s, size_t len) {
+	char* p = buffer_reserve(b, len * 2 + 2);
+	if (!p) {
+		return;
+	}
+	if (!memchr(s, ',', len) && !memchr(s, '"', len) && !memchr(s, '\n', len) &&
+	    !memchr(s, '\r', len)) {
+		memcpy(p, s, len);
+		b->len += len;
+		return;
+	}
+	char* start = p;
+	*p++ = '"';
+	for (size_t i = 0; i < len; i++) {
+		if (s[i] == '"') {
+			*p++ = '"';
+		}
+		*p++ = s[i];
+	}
+	*p++ = '"';
+	b->len += (size_t)(p - start);
+}
+
+// Local ISO 8601 time of an event, cached per second
+static const char* format_time(struct query_worker* w, uint64_t ts, char* buf, size_t size) {
+	time_t sec = (time_t)(ts / 1000000000ULL);
+	if (sec != w->time_sec || !w->time_text[0]) {
+		struct tm tm;
+		localtime_r(&sec, &tm);
+		strftime(w->time_text, sizeof(w->time_text), "%Y-%m-%dT%H:%M:%S", &tm);
+		strftime(w->zone, sizeof(w->zone), "%z", &tm);
+		w->time_sec = sec;
+	}
+	snprintf(buf, size, "%s.%09lu%s", w->time_text, (unsigned long)(ts % 1000000000ULL),
+		 w->zone);
+	return buf;
+}
+
+// Timestamps of the current block, decoded on first use
+static const uint64_t* block_ts(struct query_worker* w, const struct store_block_view* v) {
+	if (!w->ts) {
+		if (v->ts) {
+			w->ts = v->ts;
+		} else if (store_block_column(v, STORE_COLUMN_TS, w->ts_buf) == 0) {
+			w->ts = w->ts_buf;
+		}
+	}
+	return w->ts;
+}
+
+// A 32-bit column of the current block, decoded on first use
+static const uint32_t* block_column(struct query_worker* w, const struct store_block_view* v,
+				    enum store_column column) {
+	if (!w->column[column]) {
+		const uint32_t* plain[STORE_COLUMNS] = {NULL,	 v->pid,  v->uid,  v->type,
+							v->comm, v->path, v->host, NULL};
+		if (plain[column]) {
+			w->column[column] = plain[column];
+		} else if (store_block_column(v, column, w->column_buf[column]) == 0) {
+			w->column[column] = w->column_buf[column];
+		}
+	}
+	return w->column[column];
+}
+
+// Append one event as a JSONL or CSV line
+static void format_event(struct query_worker* w, struct query_buffer* b,
+			 const struct store_segment* seg, uint32_t i) {
+	char time_text[64];
+	uint64_t ts = w->ts[i];
+	uint32_t pid = w->column[STORE_COLUMN_PID][i];
+	uint32_t uid = w->column[STORE_COLUMN_UID][i];
+	uint32_t comm = w->column[STORE_COLUMN_COMM][i];
+	uint32_t path = w->column[STORE_COLUMN_PATH][i];
+	uint32_t host = w->column[STORE_COLUMN_HOST][i];
+	uint32_t category = w->column[STORE_COLUMN_CATEGORY][i];
+	const char* category_name = get_event_category_name(category);
+	const char* type = query_type_name(category, w->column[STORE_COLUMN_TYPE][i]);
+
+	comm = comm < seg->dict_entries ? comm : 0;
+	path = path < seg->dict_entries ? path : 0;
+	host = host < seg->dict_entries ? host : 0;
+	format_time(w, ts, time_text, sizeof(time_text));
+	if (cfg_format == QUERY_FORMAT_JSONL) {
+		buffer_printf(b, "{\"ts\":%lu,\"time\":\"%s\",\"category\":\"%s\",\"type\":\"%s\","
+				 "\"pid\":%u,\"uid\":",
+			      (unsigned long)ts, time_text, category_name, type, pid);
+		if (uid == STORE_UID_NONE) {
+			buffer_printf(b, "null,\"comm\":");
+		} else {
+			buffer_printf(b, "%u,\"comm\":", uid);
+		}
+		buffer_json_string(b, seg->dict[comm], seg->dict_len[comm]);
+		buffer_printf(b, ",\"path\":");
+		buffer_json_string(b, seg->dict[path], seg->dict_len[path]);
+		buffer_printf(b, ",\"host\":");
+		buffer_json_string(b, seg->dict[host], seg->dict_len[host]);
+		buffer_printf(b, "}\n");
+	} else {
+		buffer_printf(b, "%lu,%s,%s,%s,%u,", (unsigned long)ts, time_text, category_name,
+			      type, pid);
+		if (uid != STORE_UID_NONE) {
+			buffer_printf(b, "%u", uid);
+		}
+		buffer_printf(b, ",");
+		buffer_csv_string(b, seg->dict[comm], seg->dict_len[comm]);
+		buffer_printf(b, ",");
+		buffer_csv_string(b, seg->dict[path], seg->dict_len[path]);
+		buffer_printf(b, ",");
+		buffer_csv_string(b, seg->dict[host], seg->dict_len[host]);
+		buffer_printf(b, "\n");
+	}
+}
+
+// Evaluate the predicates over one block and format its matches. Columns of
+// packed blocks are decoded only when a predicate or a match needs them.
+static int scan_block(struct query_worker* w, struct query_unit* u) {
+	const struct store_segment* seg = &u->segment->seg;
+	struct store_block_view v;
+	if (store_segment_block(seg, u->block, &v) != 0) {
+		return -1;
+	}
+
+	uint32_t n = v.header->events;
+	uint32_t* sel = w->sel;
+	const uint64_t* ts;
+	const uint32_t* col;
+	const uint32_t* type;
+	w->ts = NULL;
+	memset(w->column, 0, sizeof(w->column));
+	memset(sel, 0xFF, n * sizeof(uint32_t));
+
+	// Cheapest and most selective columns first; whole-block checks skip kernels
+	if (v.header->min_ts < cfg_from || v.header->max_ts >= cfg_to) {
+		if (!(ts = block_ts(w, &v))) {
+			return -1;
+		}
+		filter_time(sel, ts, n, cfg_from, cfg_to);
+	}
+	if (cfg_has_pid && v.header->min_pid != v.header->max_pid) {
+		if (!(col = block_column(w, &v, STORE_COLUMN_PID))) {
+			return -1;
+		}
+		filter_in(sel, col, n, &cfg_pid, 1);
+	}
+	if (cfg_has_uid) {
+		if (!(col = block_column(w, &v, STORE_COLUMN_UID))) {
+			return -1;
+		}
+		filter_in(sel, col, n, &cfg_uid, 1);
+	}
+	if (type_count > 0 || (cfg_categories && (v.header->categories & ~cfg_categories) != 0)) {
+		if (!(col = block_column(w, &v, STORE_COLUMN_CATEGORY))) {
+			return -1;
+		}
+		if (type_count > 0) {
+			if (!(type = block_column(w, &v, STORE_COLUMN_TYPE))) {
+				return -1;
+			}
+			filter_types(sel, col, type, n);
+		} else {
+			filter_categories(sel, col, n, cfg_categories);
+		}
+	}
+	if (cfg_comm) {
+		if (!(col = block_column(w, &v, STORE_COLUMN_COMM))) {
+			return -1;
+		}
+		filter_match(sel, col, n, &u->segment->comm, seg->dict_entries);
+	}
+	if (cfg_path) {
+		if (!(col = block_column(w, &v, STORE_COLUMN_PATH))) {
+			return -1;
+		}
+		filter_match(sel, col, n, &u->segment->file, seg->dict_entries);
+	}
+	if (cfg_host) {
+		if (!(col = block_column(w, &v, STORE_COLUMN_HOST))) {
+			return -1;
+		}
+		filter_match(sel, col, n, &u->segment->host, seg->dict_entries);
+	}
+
+	struct query_buffer b = {NULL, 0, 0, 0};
+	uint64_t matches = 0;
+	for (uint32_t i = 0; i < n; i++) {
+		if (!sel[i]) {
+			continue;
+		}
+		if (!cfg_count && matches == 0) {
+			// First match: the output needs every column
+			if (!block_ts(w, &v)) {
+				return -1;
+			}
+			for (int c = STORE_COLUMN_PID; c < STORE_COLUMNS; c++) {
+				if (!block_column(w, &v, (enum store_column)c)) {
+					return -1;
+				}
+			}
+		}
+		matches++;
+		if (!cfg_count) {
+			format_event(w, &b, seg, i);
+		}
+	}
+	if (b.failed) {
+		LOG_ERROR_MODULE("QUERY", "Out of memory formatting block %u of %s", u->block,
+				 u->segment->path);
+		free(b.data);
+		b.data = NULL;
+		b.len = 0;
+		matches = 0;
+	}
+
+	u->matches = matches;
+	u->out = b.data;
+	u->len = b.len;
+	w->blocks++;
+	w->events += n;
+	w->bytes += v.header->size;
+	return 0;
+}
+
+// Scan-phase worker: take blocks in order, at most @window ahead of the output
+static void* scan_thread_func(void* arg) {
+	struct query_worker* w = (struct query_worker*)arg;
+	char name[16];
+	snprintf(name, sizeof(name), "ravn-query-%d", w->index);
+	prctl(PR_SET_NAME, name, 0, 0, 0);
+
+	for (;;) {
+		pthread_mutex_lock(&query_lock);
+		while (!query_stop && next_item < unit_count && next_item >= emitted + window) {
+			pthread_cond_wait(&query_cond, &query_lock);
+		}
+		if (query_stop || next_item >= unit_count) {
+			pthread_mutex_unlock(&query_lock);
+			break;
+		}
+		size_t k = next_item++;
+		pthread_mutex_unlock(&query_lock);
+
+		if (scan_block(w, &units[k]) != 0) {
+			w->corrupt++;
+		}
+
+		pthread_mutex_lock(&query_lock);
+		units[k].done = 1;
+		pthread_cond_broadcast(&query_cond);
+		pthread_mutex_unlock(&query_lock);
+	}
+	return NULL;
+}
+
+// List the blocks whose zone maps may hold matches
+static int build_units(void) {
+	size_t capacity = 0;
+	for (int s = 0; s < segment_count; s++) {
+		if (segments[s].usable) {
+			capacity += segments[s].seg.blocks;
+		}
+	}
+	units = calloc(capacity ? capacity : 1, sizeof(*units));
+	if (!units) {
+		return -1;
+	}
+
+	for (int s = 0; s < segment_count; s++) {
+		struct query_segment* segment = &segments[s];
+		if (!segment->usable) {
+			continue;
+		}
+		for (uint32_t b = 0; b < segment->seg.blocks; b++) {
+			const struct store_index_entry* e = &segment->seg.index[b];
+			if (e->max_ts < cfg_from || e->min_ts >= cfg_to ||
+			    (cfg_has_pid && (cfg_pid < e->min_pid || cfg_pid > e->max_pid)) ||
+			    (cfg_categories && !(e->categories & cfg_categories))) {
+				pruned_blocks++;
+				pruned_events += e->events;
+				continue;
+			}
+			units[unit_count].segment = segment;
+			units[unit_count].block = b;
+			unit_count++;
+		}
+	}
+	return 0;
+}
+
+// Write the formatted blocks in order; stops the workers at the limit
+static int write_results(uint64_t* matched_out) {
+	uint64_t matched = 0;
+	int result = 0;
+
+	for (size_t k = 0; k < unit_count; k++) {
+		struct query_unit* u = &units[k];
+		pthread_mutex_lock(&query_lock);
+		while (!u->done) {
+			pthread_cond_wait(&query_cond, &query_lock);
+		}
+		pthread_mutex_unlock(&query_lock);
+
+		uint64_t take = u->matches;
+		if (cfg_limit && matched + take > cfg_limit) {
+			take = cfg_limit - matched;
+		}
+		size_t len = u->len;
+		if (!cfg_count && take < u->matches) {
+			// Cut the block output after @take lines
+			const char* p = u->out;
+			for (uint64_t line = 0; line < take; line++) {
+				p = (const char*)memchr(p, '\n', u->len - (size_t)(p - u->out)) + 1;
+			}
+			len = (size_t)(p - u->out);
+		}
+		if (len && fwrite(u->out, 1, len, stdout) != len) {
+			LOG_ERROR_MODULE("QUERY", "Failed to write results: %s", strerror(errno));
+			result = -1;
+		}
+		matched += take;
+		free(u->out);
+		u->out = NULL;
+		limit_reached = cfg_limit && matched >= cfg_limit;
+
+		pthread_mutex_lock(&query_lock);
+		emitted++;
+		query_stop = result != 0 || limit_reached;
+		pthread_cond_broadcast(&query_cond);
+		pthread_mutex_unlock(&query_lock);
+		if (query_stop) {
+			break;
+		}
+	}
+	if (fflush(stdout) != 0) {
+		result = -1;
+	}
+	*matched_out = matched;
+	return result;
+}
+
+// Print the scan report to stderr
+static void print_report(const struct query_worker* workers, double elapsed_s,
+			 uint64_t matched) {
+	uint64_t blocks = 0, bytes = 0, events = 0, corrupt = 0;
+	for (int i = 0; i < cfg_workers; i++) {
+		blocks += workers[i].blocks;
+		bytes += workers[i].bytes;
+		events += workers[i].events;
+		corrupt += workers[i].corrupt;
+	}
+
+	fprintf(stderr,
+		"\nScanned %lu block(s) of %d segment(s) in %.3f s on %d worker(s): %.1f MB, "
+		"%.2f GB/s, %.0f events/s\n",
+		(unsigned long)blocks, segment_count, elapsed_s, cfg_workers, bytes / 1e6,
+		bytes / 1e9 / elapsed_s, events / elapsed_s);
+	fprintf(stderr, "Pruned %lu segment(s) and %lu block(s) (%lu events) without reading\n",
+		(unsigned long)pruned_segments, (unsigned long)pruned_blocks,
+		(unsigned long)pruned_events);
+	fprintf(stderr, "Matched %lu of %lu scanned events%s\n", (unsigned long)matched,
+		(unsigned long)events, limit_reached ? " (limit reached)" : "");
+	if (corrupt) {
+		fprintf(stderr, "Skipped %lu corrupt block(s)\n", (unsigned long)corrupt);
+	}
+}
+
+// Print query usage
+static void query_usage(void) {
+	printf("Usage: ravn query [OPTIONS] DIR|SEGMENT...\n");
+	printf("\nOptions:\n");
+	printf("  -f, --from TIME      Events at or after TIME\n");
+	printf("  -t, --to TIME        Events before TIME\n");
+	printf("  -p, --pid PID        Events of one process\n");
+	printf("  -u, --uid UID        Events carrying this user ID (process, security)\n");
+	printf("  -c, --category LIST  Categories, e.g. process,file\n");
+	printf("  -e, --event LIST     Event types, e.g. exec,setuid or process_exec\n");
+	printf("  -n, --comm PATTERN   Process name, exact or shell pattern (nc*, ?sh)\n");
+	printf("  -P, --path PATTERN   Path, exact or shell pattern (/tmp/*)\n");
+	printf("  -H, --host PATTERN   Forwarding host, exact or shell pattern (web-*), in a\n");
+	printf("                       store written by 'ravn collector'\n");
+	printf("  -o, --format FMT     Output format: jsonl (default) or csv\n");
+	printf("  -l, --limit N        Stop after N matches\n");
+	printf("  -C, --count          Print the number of matches only\n");
+	printf("  -j, --jobs N         Scan threads (default: online CPUs)\n");
+	printf("\nTIME is local: \"YYYY-mm-dd HH:MM[:SS]\", \"HH:MM[:SS]\" (today) or @SECONDS.\n");
+	printf("Matches are written to stdout in segment order, the scan report to stderr.\n");
+}
+
+// Release segments, units and match sets
+static void cleanup_query(void) {
+	for (size_t k = 0; k < unit_count; k++) {
+		free(units[k].out);
+	}
+	free(units);
+	units = NULL;
+	unit_count = 0;
+
+	for (int s = 0; s < segment_count; s++) {
+		if (segments[s].usable) {
+			store_segment_close(&segments[s].seg);
+		}
+		free(segments[s].comm.bitmap);
+		free(segments[s].file.bitmap);
+		free(segments[s].host.bitmap);
+		free(segments[s].path);
+	}
+	free(segments);
+	segments = NULL;
+	segment_count = 0;
+}
+
+// Start the workers on a phase and wait for them
+static int run_phase(struct query_worker* workers, void* (*func)(void*)) {
+	int started = 0;
+	int result = 0;
+	next_item = 0;
+	for (; started < cfg_workers; started++) {
+		if (pthread_create(&workers[started].thread, NULL, func, &workers[started]) != 0) {
+			LOG_ERROR_MODULE("QUERY", "Failed to start worker %d", started);
+			result = -1;
+			break;
+		}
+	}
+	if (result != 0) {
+		pthread_mutex_lock(&query_lock);
+		query_stop = 1;
+		pthread_cond_broadcast(&query_cond);
+		pthread_mutex_unlock(&query_lock);
+	}
+	for (int i = 0; i < started; i++) {
+		pthread_join(workers[i].thread, NULL);
+	}
+	return result;
+}
+
+// Search stored event segments
+int query_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"from", required_argument, 0, 'f'},
+					       {"to", required_argument, 0, 't'},
+					       {"pid", required_argument, 0, 'p'},
+					       {"uid", required_argument, 0, 'u'},
+					       {"category", required_argument, 0, 'c'},
+					       {"event", required_argument, 0, 'e'},
+					       {"comm", required_argument, 0, 'n'},
+					       {"path", required_argument, 0, 'P'},
+					       {"host", required_argument, 0, 'H'},
+					       {"format", required_argument, 0, 'o'},
+					       {"limit", required_argument, 0, 'l'},
+					       {"count", no_argument, 0, 'C'},
+					       {"jobs", required_argument, 0, 'j'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	char* categories = NULL;
+	int opt;
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "f:t:p:u:c:e:n:P:H:o:l:Cj:h", long_options, NULL)) !=
+	       -1) {
+		switch (opt) {
+		case 'f':
+		case 't':
+			if (parse_time(optarg, opt == 'f' ? &cfg_from : &cfg_to) != 0) {
+				fprintf(stderr, "Invalid time '%s'\n", optarg);
+				return 1;
+			}
+			break;
+		case 'p':
+			cfg_has_pid = 1;
+			cfg_pid = (uint32_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'u':
+			cfg_has_uid = 1;
+			cfg_uid = (uint32_t)strtoul(optarg, NULL, 10);
+			break;
+		case 'c':
+			categories = optarg;
+			break;
+		case 'e':
+			cfg_events = optarg;
+			break;
+		case 'n':
+			cfg_comm = optarg;
+			break;
+		case 'P':
+			cfg_path = optarg;
+			break;
+		case 'H':
+			cfg_host = optarg;
+			break;
+		case 'o':
+			if (strcmp(optarg, "jsonl") == 0) {
+				cfg_format = QUERY_FORMAT_JSONL;
+			} else if (strcmp(optarg, "csv") == 0) {
+				cfg_format = QUERY_FORMAT_CSV;
+			} else {
+				query_usage();
+				return 1;
+			}
+			break;
+		case 'l':
+			cfg_limit = strtoull(optarg, NULL, 10);
+			break;
+		case 'C':
+			cfg_count = 1;
+			break;
+		case 'j':
+			cfg_workers = atoi(optarg);
+			break;
+		case 'h':
+			query_usage();
+			return 0;
+		default:
+			query_usage();
+			return 1;
+		}
+	}
+
+	if (cfg_workers == 0) {
+		cfg_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+	}
+	if (optind >= argc || cfg_workers <= 0 || cfg_workers > QUERY_MAX_WORKERS ||
+	    cfg_from >= cfg_to) {
+		query_usage();
+		return 1;
+	}
+	if (categories && parse_categories(categories, &cfg_categories) != 0) {
+		return 1;
+	}
+	if (cfg_events) {
+		char* events = strdup(cfg_events);
+		int failed = !events || resolve_events(events) != 0;
+		free(events);
+		if (failed) {
+			return 1;
+		}
+	}
+
+	int result = 0;
+	char** paths = NULL;
+	int path_count = 0;
+	for (int i = optind; result == 0 && i < argc; i++) {
+		if (store_list_segments(argv[i], &paths, &path_count) != 0) {
+			fprintf(stderr, "%s: %s\n", argv[i], strerror(errno));
+			result = 1;
+		}
+	}
+	if (result == 0 && path_count > QUERY_MAX_SEGMENTS) {
+		fprintf(stderr, "Too many segments (limit %d)\n", QUERY_MAX_SEGMENTS);
+		result = 1;
+	}
+	if (result == 0) {
+		segments = calloc(path_count ? (size_t)path_count : 1, sizeof(*segments));
+		result = segments ? 0 : 1;
+	}
+	if (result != 0) {
+		for (int i = 0; i < path_count; i++) {
+			free(paths[i]);
+		}
+		free(paths);
+		return 1;
+	}
+	qsort(paths, (size_t)path_count, sizeof(*paths), compare_paths);
+	for (int i = 0; i < path_count; i++) {
+		segments[i].path = paths[i];
+	}
+	segment_count = path_count;
+	free(paths);
+
+	struct query_worker* workers = calloc((size_t)cfg_workers, sizeof(*workers));
+	if (!workers) {
+		cleanup_query();
+		return 1;
+	}
+	for (int i = 0; i < cfg_workers; i++) {
+		workers[i].index = i;
+	}
+	setvbuf(stdout, NULL, _IOFBF, 1 << 20);
+	if (cfg_format == QUERY_FORMAT_CSV && !cfg_count) {
+		printf("ts,time,category,type,pid,uid,comm,path,host\n");
+	}
+
+	uint64_t start = ravn_prof_now_ns();
+	uint64_t matched = 0;
+	window = (size_t)cfg_workers * QUERY_WINDOW_PER_WORKER;
+	query_stop = 0;
+
+	if (run_phase(workers, open_thread_func) != 0 || build_units() != 0) {
+		result = 1;
+	} else {
+		// The workers scan while this thread writes finished blocks in order
+		next_item = 0;
+		emitted = 0;
+		int started = 0;
+		for (; started < cfg_workers; started++) {
+			if (pthread_create(&workers[started].thread, NULL, scan_thread_func,
+					   &workers[started]) != 0) {
+				LOG_ERROR_MODULE("QUERY", "Failed to start worker %d", started);
+				break;
+			}
+		}
+		if (started < cfg_workers || write_results(&matched) != 0) {
+			result = 1;
+		}
+
+		pthread_mutex_lock(&query_lock);
+		query_stop = 1;
+		pthread_cond_broadcast(&query_cond);
+		pthread_mutex_unlock(&query_lock);
+		for (int i = 0; i < started; i++) {
+			pthread_join(workers[i].thread, NULL);
+		}
+	}
+	double elapsed_s = (ravn_prof_now_ns() - start) / 1e9;
+
+	if (result == 0) {
+		if (cfg_count) {
+			printf("%lu\n", (unsigned long)matched);
+			fflush(stdout);
+		}
+		print_report(workers, elapsed_s > 0 ? elapsed_s : 1e-9, matched);
+	}
+
+	free(workers);
+	cleanup_query();
+	return result;
+}
@@ -0,0 +1,63 @@
+/*
+ * RAVN Event Queries - Header File
+ *
+ * This header defines the ad-hoc query engine of the RAVN security platform,
+ * which searches the columnar event store during incident response, spread
+ * across all cores.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The query engine implements:
+ * - Predicates on time range, PID, user ID, category, event type, process
+ *   name, path and forwarding host (shell patterns), combined with AND
+ * - Pruning of whole segments by their time partition, and of blocks by the
+ *   index zone maps (time range, PID range, category mask)
+ * - Pruning by dictionary: name, path and host patterns are matched once
+ *   against each segment's string dictionary, so a segment where nothing
+ *   matches is skipped and the block scan compares integer IDs only
+ * - Column-at-a-time predicate evaluation over a selection mask, four lanes
+ *   per instruction with GCC vector extensions (SSE2 on x86-64, NEON on ARM)
+ * - Archived (packed) blocks are decoded a column at a time, only for the
+ *   columns a predicate reads and, once a block has a match, for the output
+ * - JSONL or CSV output, streamed in segment and block order
+ * - A scan throughput report (GB/s) on stderr
+ *
+ * Architecture:
+ * - Segments are mapped read-only; worker threads open them and match their
+ *   dictionaries in parallel
+ * - Surviving blocks are handed to the workers one at a time through a shared
+ *   counter, so uneven blocks balance themselves
+ * - Each worker formats its block into its own buffer; the calling thread
+ *   writes the buffers in block order, at most QUERY_WINDOW_PER_WORKER
+ *   blocks per worker ahead of the output
+ */
+
+#ifndef RAVN_QUERY_H
+#define RAVN_QUERY_H
+
+/*
+ * Event Query Configuration Parameters
+ */
+#define QUERY_MAX_WORKERS	256   /* Worker thread limit */
+#define QUERY_MAX_SEGMENTS	65536 /* Segment files per query */
+#define QUERY_MAX_VALUES	16    /* IDs compared in the vector loop, else bitmap */
+#define QUERY_MAX_TYPES		64    /* Category/type pairs of --event */
+#define QUERY_TYPE_SCAN		1024  /* Type values searched for --event names */
+#define QUERY_WINDOW_PER_WORKER 4     /* Formatted blocks buffered per worker */
+
+/**
+ * query_main - Search stored event segments
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the query options, scans every segment file named on the command
+ * line (or found in a named directory), writes the matching events to stdout
+ * and the scan report to stderr.
+ *
+ * Return: 0 on success, 1 on invalid arguments or failure
+ */
+int query_main(int argc, char* argv[]);
+
+#endif // RAVN_QUERY_H
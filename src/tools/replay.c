@@ -0,0 +1,302 @@
+// RAVN Trace Replay Implementation
+// Drives recorded ring records through the live decode, sink and AI paths
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "replay.h"
+
+#include "../daemon/ai_engine.h"
+#include "../daemon/ebpf_handler.h"
+#include "../daemon/forward.h"
+#include "../daemon/redis_client.h"
+#include "../daemon/trace.h"
+#include "../utils/logger.h"
+#include "../utils/profiler.h"
+
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// External Redis connection (read by the event handlers)
+extern void* global_redis_conn_ptr;
+
+// Replay options
+static double cfg_speed = 0.0; /* 0 = as fast as possible */
+static int cfg_loops = 1;
+static int cfg_redis = 1;
+static int cfg_ai = 1;
+static int cfg_verbose = 0;
+static const char* cfg_model = REPLAY_DEFAULT_MODEL;
+static const char* cfg_forward = NULL;
+static const char* cfg_host = NULL;
+
+static volatile sig_atomic_t replay_stop = 0;
+
+// AI scoring results collected through the event tap
+struct replay_scores {
+	ai_engine_t* engine;
+	uint64_t scored;
+	uint64_t high;
+	float max_score;
+	uint64_t analyze_ns;
+};
+
+// Stop replay on SIGINT/SIGTERM
+static void replay_signal_handler(int sig) {
+	(void)sig;
+	replay_stop = 1;
+}
+
+// Score each decoded event inline
+static void replay_event_tap(const struct ravn_event* event, void* ctx) {
+	struct replay_scores* scores = (struct replay_scores*)ctx;
+
+	uint64_t t0 = ravn_prof_now_ns();
+	float score = ai_engine_analyze_event(scores->engine, event);
+	scores->analyze_ns += ravn_prof_now_ns() - t0;
+
+	scores->scored++;
+	if (score > REPLAY_HIGH_SCORE) {
+		scores->high++;
+	}
+	if (score > scores->max_score) {
+		scores->max_score = score;
+	}
+}
+
+// Sleep until an absolute CLOCK_MONOTONIC deadline
+static void sleep_until_ns(uint64_t deadline_ns) {
+	struct timespec ts = {.tv_sec = (time_t)(deadline_ns / 1000000000ULL),
+			      .tv_nsec = (long)(deadline_ns % 1000000000ULL)};
+	while (!replay_stop && clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0) {
+	}
+}
+
+// Replay one pass over the trace
+static int replay_pass(const char* path, uint64_t* counts, uint64_t* bytes) {
+	struct trace_reader reader;
+	if (trace_reader_open(&reader, path) != 0) {
+		return -1;
+	}
+
+	const struct trace_record_header* hdr;
+	void* data;
+	uint64_t first_ktime = 0;
+	uint64_t start = ravn_prof_now_ns();
+	uint64_t records = 0;
+	int result = 0;
+
+	while (!replay_stop && (result = trace_reader_next(&reader, &hdr, &data)) == 1) {
+		if (cfg_speed > 0) {
+			if (records == 0) {
+				first_ktime = hdr->ktime_ns;
+			}
+			uint64_t offset = hdr->ktime_ns > first_ktime ? hdr->ktime_ns - first_ktime : 0;
+			sleep_until_ns(start + (uint64_t)(offset / cfg_speed));
+		}
+
+		if (ebpf_handler_dispatch_record(hdr->category, data, hdr->length) < 0) {
+			counts[0]++; // Unknown category
+		} else {
+			counts[hdr->category]++;
+		}
+		*bytes += hdr->length;
+		records++;
+	}
+
+	trace_reader_close(&reader);
+	return replay_stop || result >= 0 ? 0 : -1;
+}
+
+// Print replay usage
+static void replay_usage(void) {
+	printf("Usage: ravn replay [OPTIONS] TRACE\n");
+	printf("\nOptions:\n");
+	printf("  -s, --speed X        Replay at X times the recorded pacing, 0 = as fast as\n");
+	printf("                       possible (default 0)\n");
+	printf("  -l, --loops N        Replay the trace N times (default 1)\n");
+	printf("  -m, --model PATH     AI model (default %s)\n", REPLAY_DEFAULT_MODEL);
+	printf("  -R, --no-redis       Do not send decoded events to Redis\n");
+	printf("  -A, --no-ai          Do not score decoded events\n");
+	printf("  -F, --forward ADDR   Also forward the records to a collector at HOST[:PORT],\n");
+	printf("                       as an agent would (default port %d)\n", FORWARD_DEFAULT_PORT);
+	printf("  -N, --host-name NAME Host name to forward as (default: this host's name)\n");
+	printf("  -V, --verbose        Keep the per-event log lines\n");
+	printf("\nTRACE is the first segment written by 'ravn daemon --record'; rotated\n");
+	printf("segments (TRACE.1, TRACE.2, ...) are followed automatically. No root or\n");
+	printf("BPF support is needed.\n");
+}
+
+// Print the throughput and detection report
+static void print_report(double elapsed_s, const uint64_t* counts, uint64_t bytes,
+			 const struct replay_scores* scores) {
+	struct ebpf_monitor_stats stats[EVENT_CATEGORY_MAX + 1];
+	ebpf_handler_get_monitor_stats(stats);
+
+	uint64_t total = counts[0];
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		total += counts[cat];
+	}
+
+	printf("\nReplayed %lu records (%.1f MB) in %.3f s: %.0f records/s, %.1f MB/s\n",
+	       (unsigned long)total, bytes / 1e6, elapsed_s, total / elapsed_s,
+	       bytes / 1e6 / elapsed_s);
+
+	printf("\n%-12s %12s %12s %14s\n", "CATEGORY", "RECORDS", "RECORDS/S", "HANDLER NS/EV");
+	for (int cat = 1; cat <= EVENT_CATEGORY_MAX; cat++) {
+		const struct ebpf_monitor_stats* st = &stats[cat];
+		if (counts[cat] == 0) {
+			continue;
+		}
+		printf("%-12s %12lu %12.0f %14.0f\n", st->name, (unsigned long)counts[cat],
+		       counts[cat] / elapsed_s,
+		       st->events ? (double)st->handler_ns / st->events : 0.0);
+	}
+	if (counts[0]) {
+		printf("%-12s %12lu\n", "unknown", (unsigned long)counts[0]);
+	}
+
+	if (scores->engine) {
+		printf("\nAI: %lu events scored, %.0f ns/event, max score %.3f, %lu above %.2f\n",
+		       (unsigned long)scores->scored,
+		       scores->scored ? (double)scores->analyze_ns / scores->scored : 0.0,
+		       scores->max_score, (unsigned long)scores->high, REPLAY_HIGH_SCORE);
+	}
+
+	if (cfg_forward) {
+		struct forward_stats fwd;
+		forward_get_stats(&fwd);
+		printf("\nForwarded: %lu records, %lu batches acknowledged (%.1f MB raw, %.1f MB "
+		       "sent), %lu dropped\n",
+		       (unsigned long)fwd.records, (unsigned long)fwd.batches, fwd.raw_bytes / 1e6,
+		       fwd.sent_bytes / 1e6, (unsigned long)fwd.dropped);
+	}
+}
+
+// Replay a recorded trace
+int replay_main(int argc, char* argv[]) {
+	static struct option long_options[] = {{"speed", required_argument, 0, 's'},
+					       {"loops", required_argument, 0, 'l'},
+					       {"model", required_argument, 0, 'm'},
+					       {"no-redis", no_argument, 0, 'R'},
+					       {"no-ai", no_argument, 0, 'A'},
+					       {"forward", required_argument, 0, 'F'},
+					       {"host-name", required_argument, 0, 'N'},
+					       {"verbose", no_argument, 0, 'V'},
+					       {"help", no_argument, 0, 'h'},
+					       {0, 0, 0, 0}};
+	int opt;
+
+	optind = 1;
+	while ((opt = getopt_long(argc, argv, "s:l:m:RAF:N:Vh", long_options, NULL)) != -1) {
+		switch (opt) {
+		case 's':
+			cfg_speed = atof(optarg);
+			break;
+		case 'l':
+			cfg_loops = atoi(optarg);
+			break;
+		case 'm':
+			cfg_model = optarg;
+			break;
+		case 'R':
+			cfg_redis = 0;
+			break;
+		case 'A':
+			cfg_ai = 0;
+			break;
+		case 'F':
+			cfg_forward = optarg;
+			break;
+		case 'N':
+			cfg_host = optarg;
+			break;
+		case 'V':
+			cfg_verbose = 1;
+			break;
+		case 'h':
+			replay_usage();
+			return 0;
+		default:
+			replay_usage();
+			return 1;
+		}
+	}
+
+	if (optind != argc - 1 || cfg_speed < 0 || cfg_loops <= 0) {
+		replay_usage();
+		return 1;
+	}
+	const char* path = argv[optind];
+
+	// Handlers log every event at INFO; that would dominate the measurement
+	if (!cfg_verbose) {
+		logger_set_level(LOG_LEVEL_WARN);
+	}
+
+	// Stand in for an agent: every dispatched record is forwarded as well
+	if (cfg_forward && forward_open(cfg_forward, cfg_host) != 0) {
+		logger_set_level(LOG_LEVEL_INFO);
+		return 1;
+	}
+
+	redis_connection_t* conn = NULL;
+	if (cfg_redis) {
+		conn = redis_connect("127.0.0.1", 6379);
+		if (!conn) {
+			LOG_WARN_MODULE("REPLAY", "Redis unavailable, replaying without the sink");
+		}
+		global_redis_conn_ptr = conn;
+	}
+
+	struct replay_scores scores = {0};
+	if (cfg_ai) {
+		scores.engine = ai_engine_init(cfg_model);
+		if (scores.engine) {
+			ebpf_handler_set_event_tap(replay_event_tap, &scores);
+		} else {
+			LOG_WARN_MODULE("REPLAY", "AI engine unavailable, replaying without scoring");
+		}
+	}
+
+	signal(SIGINT, replay_signal_handler);
+	signal(SIGTERM, replay_signal_handler);
+
+	uint64_t counts[EVENT_CATEGORY_MAX + 1] = {0};
+	uint64_t bytes = 0;
+	int result = 0;
+	uint64_t start = ravn_prof_now_ns();
+	for (int loop = 0; loop < cfg_loops && !replay_stop; loop++) {
+		if (replay_pass(path, counts, &bytes) != 0) {
+			result = 1;
+			break;
+		}
+	}
+	double elapsed_s = (ravn_prof_now_ns() - start) / 1e9;
+
+	// The collector gets the final verdict and whatever is still queued
+	if (cfg_forward) {
+		forward_send_summary(scores.engine);
+		forward_close();
+	}
+
+	if (result == 0) {
+		print_report(elapsed_s > 0 ? elapsed_s : 1e-9, counts, bytes, &scores);
+	}
+
+	ebpf_handler_set_event_tap(NULL, NULL);
+	if (scores.engine) {
+		ai_engine_cleanup(scores.engine);
+	}
+	global_redis_conn_ptr = NULL;
+	if (conn) {
+		redis_disconnect(conn);
+	}
+	if (!cfg_verbose) {
+		logger_set_level(LOG_LEVEL_INFO);
+	}
+	return result;
+}
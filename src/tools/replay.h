@@ -0,0 +1,49 @@
+/*
+ * RAVN Trace Replay - Header File
+ *
+ * This header defines the trace replay mode for the RAVN security platform,
+ * feeding recorded raw ring buffer records back through the live decode,
+ * Redis sink and AI scoring paths without root privileges or BPF.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The trace replay implements:
+ * - Sequential reading of all rotated trace segments
+ * - As-fast-as-possible replay or original pacing scaled by a speedup
+ * - The same per-category handlers and accounting as live delivery
+ * - Optional Redis sink and inline AI scoring of every decoded event
+ * - Optional forwarding to a collector, so one machine can stand in for a
+ *   fleet of agents without BPF
+ * - Records/sec, handler cost and detection summary report
+ *
+ * Architecture:
+ * - Records are dispatched from the calling thread, standing in for the
+ *   ring buffer polling thread
+ * - Pacing uses the recorded consume timestamps (CLOCK_MONOTONIC)
+ * - The AI engine is driven through the decoded event tap
+ */
+
+#ifndef RAVN_REPLAY_H
+#define RAVN_REPLAY_H
+
+/*
+ * Trace Replay Configuration Parameters
+ */
+#define REPLAY_DEFAULT_MODEL "models/ravn_model.bin" /* AI model path */
+#define REPLAY_HIGH_SCORE    0.7f		     /* Score counted as a detection */
+
+/**
+ * replay_main - Replay a recorded trace
+ * @argc: Argument count (argv[0] is the mode name)
+ * @argv: Arguments following the global options
+ *
+ * Parses the replay options, feeds every record of the trace through the
+ * event handlers and prints the throughput report to stdout.
+ *
+ * Return: 0 on success, 1 on invalid arguments or an unreadable trace
+ */
+int replay_main(int argc, char* argv[]);
+
+#endif // RAVN_REPLAY_H
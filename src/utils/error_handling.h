@@ -15,6 +15,7 @@
  * - Error propagation with context preservation
  * - Consistent error return patterns
  * - Automatic error message formatting
+ * - Scoped timer sites backed by the profiler
  *
  * Architecture:
  * - Macro-based error handling for performance
@@ -27,8 +28,10 @@
 #define RAVN_ERROR_HANDLING_H
 
 #include "logger.h"
+#include "profiler.h"
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -260,20 +263,29 @@
 
 /**
  * Performance measurement macros
+ *
+ * Each RAVN_TIME_START() expands to a static timer site that is registered
+ * with the profiler when the matching RAVN_TIME_END() first runs. Samples
+ * are only recorded while runtime profiling is enabled, and the macros
+ * compile away entirely unless the build defines RAVN_PROFILING.
  */
-#define RAVN_TIME_START(var)                    \
-	struct timespec var##_start, var##_end; \
-	clock_gettime(CLOCK_MONOTONIC, &var##_start)
+#ifdef RAVN_PROFILING
+#define RAVN_TIME_START(var)                \
+	static ravn_prof_site_t var##_site; \
+	uint64_t var##_start = ravn_prof_begin()
 
-#define RAVN_TIME_END(var, module, operation)                                           \
-	do {                                                                            \
-		clock_gettime(CLOCK_MONOTONIC, &var##_end);                             \
-		long var##_ns = (var##_end.tv_sec - var##_start.tv_sec) * 1000000000L + \
-				(var##_end.tv_nsec - var##_start.tv_nsec);              \
-		LOG_DEBUG_MODULE(module, "Timing: %s took %ld.%03ld ms", operation,     \
-				 var##_ns / 1000000, (var##_ns % 1000000) / 1000);      \
+#define RAVN_TIME_END(var, module, operation) \
+	ravn_prof_end(&var##_site, var##_start, module, operation)
+#else
+#define RAVN_TIME_START(var) \
+	do {                 \
 	} while (0)
 
+#define RAVN_TIME_END(var, module, operation) \
+	do {                                  \
+	} while (0)
+#endif
+
 /**
  * Assertion macros for debugging
  */
@@ -0,0 +1,246 @@
+// RAVN Hot Memory Implementation
+// Huge-page backed, locked regions for the hot daemon structures
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "hotmem.h"
+
+#include "logger.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Process-wide policy
+static enum hotmem_policy hotmem_policy = HOTMEM_POLICY_HEAP;
+static int hotmem_lock = 0;
+static int lock_warned = 0;
+
+// Registry of mapped regions
+static struct hotmem_region regions[HOTMEM_MAX_REGIONS];
+static int region_count = 0;
+static pthread_mutex_t hotmem_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static const char* const policy_names[HOTMEM_POLICY_MAX] = {"heap", "thp", "hugetlb"};
+static const char* const backing_names[] = {"heap", "pages", "thp", "hugetlb"};
+
+// Set the process-wide allocation policy
+void hotmem_configure(enum hotmem_policy policy, int lock) {
+	hotmem_policy = (unsigned)policy < HOTMEM_POLICY_MAX ? policy : HOTMEM_POLICY_HEAP;
+	hotmem_lock = lock;
+}
+
+// Parse a policy name
+int hotmem_parse_policy(const char* name, enum hotmem_policy* policy) {
+	for (int p = 0; p < HOTMEM_POLICY_MAX; p++) {
+		if (strcmp(name, policy_names[p]) == 0) {
+			*policy = (enum hotmem_policy)p;
+			return 0;
+		}
+	}
+	return -1;
+}
+
+// Name of a policy
+const char* hotmem_policy_name(enum hotmem_policy policy) {
+	return (unsigned)policy < HOTMEM_POLICY_MAX ? policy_names[policy] : "unknown";
+}
+
+// Name of a backing
+const char* hotmem_backing_name(enum hotmem_backing backing) {
+	return (unsigned)backing <= HOTMEM_BACKING_HUGETLB ? backing_names[backing] : "unknown";
+}
+
+// Round up to a multiple of a power of two
+static size_t round_up(size_t size, size_t align) {
+	return (size + align - 1) & ~(align - 1);
+}
+
+// Map a 2 MB-aligned region advised for transparent huge pages
+static void* map_thp(size_t mapped, enum hotmem_backing* backing) {
+	// Over-map by one huge page and trim to an aligned start
+	size_t span = mapped + HOTMEM_HUGE_PAGE;
+	uint8_t* raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (raw == MAP_FAILED) {
+		return NULL;
+	}
+	uint8_t* start = (uint8_t*)round_up((uintptr_t)raw, HOTMEM_HUGE_PAGE);
+	if (start > raw) {
+		munmap(raw, (size_t)(start - raw));
+	}
+	size_t tail = (size_t)(raw + span - (start + mapped));
+	if (tail) {
+		munmap(start + mapped, tail);
+	}
+
+	*backing = madvise(start, mapped, MADV_HUGEPAGE) == 0 ? HOTMEM_BACKING_THP
+							      : HOTMEM_BACKING_PAGES;
+	return start;
+}
+
+// Allocate a zeroed hot region
+void* hotmem_alloc(size_t size, const char* name) {
+	if (size == 0) {
+		size = 1;
+	}
+	if (hotmem_policy == HOTMEM_POLICY_HEAP && !hotmem_lock) {
+		return calloc(1, size);
+	}
+
+	size_t page = (size_t)sysconf(_SC_PAGESIZE);
+	int huge = hotmem_policy != HOTMEM_POLICY_HEAP && size >= HOTMEM_HUGE_MIN;
+	size_t mapped = round_up(size, huge ? HOTMEM_HUGE_PAGE : page);
+	enum hotmem_backing backing = HOTMEM_BACKING_PAGES;
+	void* addr = NULL;
+
+	if (huge && hotmem_policy == HOTMEM_POLICY_HUGETLB) {
+		addr = mmap(NULL, mapped, PROT_READ | PROT_WRITE,
+			    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (addr == MAP_FAILED) {
+			addr = NULL; // No reserved pages: fall back to THP
+		} else {
+			backing = HOTMEM_BACKING_HUGETLB;
+		}
+	}
+	if (!addr && huge) {
+		addr = map_thp(mapped, &backing);
+	}
+	if (!addr) {
+		addr = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+			    0);
+		if (addr == MAP_FAILED) {
+			return NULL;
+		}
+		backing = HOTMEM_BACKING_PAGES;
+	}
+
+	// Fault the region in now, so huge pages are taken at startup and the
+	// event path never faults; mlock() populates it as well
+	int locked = 0;
+	if (hotmem_lock) {
+		if (mlock(addr, mapped) == 0) {
+			locked = 1;
+		} else if (!__atomic_exchange_n(&lock_warned, 1, __ATOMIC_RELAXED)) {
+			LOG_WARN_MODULE("HOTMEM",
+					"Cannot lock %s in memory: %s (raise RLIMIT_MEMLOCK or grant "
+					"CAP_IPC_LOCK); continuing unlocked",
+					name, strerror(errno));
+		}
+	}
+	if (!locked) {
+		for (size_t off = 0; off < mapped; off += page) {
+			((volatile uint8_t*)addr)[off] = 0;
+		}
+	}
+
+	pthread_mutex_lock(&hotmem_mutex);
+	if (region_count == HOTMEM_MAX_REGIONS) {
+		pthread_mutex_unlock(&hotmem_mutex);
+		LOG_WARN_MODULE("HOTMEM", "Region table full, %s stays on the heap", name);
+		munmap(addr, mapped);
+		return calloc(1, size);
+	}
+	struct hotmem_region* r = &regions[region_count++];
+	r->name = name;
+	r->addr = addr;
+	r->size = size;
+	r->mapped = mapped;
+	r->backing = backing;
+	r->locked = locked;
+	pthread_mutex_unlock(&hotmem_mutex);
+	return addr;
+}
+
+// Release a region from hotmem_alloc()
+void hotmem_free(void* ptr) {
+	if (!ptr) {
+		return;
+	}
+
+	pthread_mutex_lock(&hotmem_mutex);
+	for (int i = 0; i < region_count; i++) {
+		if (regions[i].addr == ptr) {
+			size_t mapped = regions[i].mapped;
+			regions[i] = regions[--region_count];
+			pthread_mutex_unlock(&hotmem_mutex);
+			munmap(ptr, mapped); // Also unlocks
+			return;
+		}
+	}
+	pthread_mutex_unlock(&hotmem_mutex);
+	free(ptr);
+}
+
+// Look up the region holding an address
+enum hotmem_backing hotmem_find(const void* ptr, struct hotmem_region* region) {
+	enum hotmem_backing backing = HOTMEM_BACKING_HEAP;
+	const uint8_t* p = ptr;
+
+	pthread_mutex_lock(&hotmem_mutex);
+	for (int i = 0; i < region_count; i++) {
+		const uint8_t* start = regions[i].addr;
+		if (p >= start && p < start + regions[i].mapped) {
+			backing = regions[i].backing;
+			if (region) {
+				*region = regions[i];
+			}
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hotmem_mutex);
+	return backing;
+}
+
+// Bytes of a region mapped with huge pages
+size_t hotmem_huge_bytes(const void* ptr) {
+	FILE* f = fopen("/proc/self/smaps", "r");
+	if (!f) {
+		return 0;
+	}
+
+	char line[256];
+	int inside = 0;
+	size_t bytes = 0;
+	unsigned long kb;
+	while (fgets(line, sizeof(line), f)) {
+		unsigned long start, end;
+		if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+			if (inside) {
+				break; // Past the region's mapping
+			}
+			inside = (uintptr_t)ptr >= start && (uintptr_t)ptr < end;
+		} else if (inside && (sscanf(line, "AnonHugePages: %lu kB", &kb) == 1 ||
+				      sscanf(line, "Private_Hugetlb: %lu kB", &kb) == 1)) {
+			bytes += (size_t)kb << 10;
+		}
+	}
+	fclose(f);
+
+	// Adjacent regions may share one mapping; never report more than one region
+	struct hotmem_region region;
+	if (hotmem_find(ptr, &region) != HOTMEM_BACKING_HEAP && bytes > region.mapped) {
+		bytes = region.mapped;
+	}
+	return bytes;
+}
+
+// Log every mapped region with its backing
+void hotmem_log(void) {
+	struct hotmem_region copy[HOTMEM_MAX_REGIONS];
+	pthread_mutex_lock(&hotmem_mutex);
+	int count = region_count;
+	memcpy(copy, regions, (size_t)count * sizeof(copy[0]));
+	pthread_mutex_unlock(&hotmem_mutex);
+
+	for (int i = 0; i < count; i++) {
+		LOG_INFO_MODULE("HOTMEM", "%s: %zu kB on %s (%zu kB huge), %s", copy[i].name,
+				copy[i].mapped >> 10, hotmem_backing_name(copy[i].backing),
+				hotmem_huge_bytes(copy[i].addr) >> 10,
+				copy[i].locked ? "locked" : "not locked");
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ * RAVN Hot Memory - Header File
+ *
+ * This header defines the allocator for the hot structures of the RAVN
+ * security platform (AI engine sliding window and model weights, event
+ * store staging blocks), backing them with huge pages locked in RAM so
+ * the event path sees neither TLB misses across them nor swap-ins.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The hot memory allocator implements:
+ * - 2 MB pages from the hugetlbfs pool (MAP_HUGETLB) when pages are reserved
+ *   (vm.nr_hugepages)
+ * - Transparent huge pages otherwise: 2 MB-aligned anonymous mappings
+ *   advised with MADV_HUGEPAGE and faulted in at allocation
+ * - mlock() of every region, so it is never swapped or reclaimed
+ * - Graceful fallback at each step: no reserved pages falls back to
+ *   transparent huge pages, THP disabled to small pages, and a refused
+ *   mlock() (RLIMIT_MEMLOCK, no CAP_IPC_LOCK) to unlocked memory, logged once
+ * - A registry of the regions with the backing each one got, and the huge
+ *   page bytes the kernel actually mapped (from /proc/self/smaps)
+ *
+ * Architecture:
+ * - The policy is process-wide: the daemon sets it from its options, the
+ *   AI benchmark per run; everything else keeps plain heap memory
+ * - Regions are allocated at startup or engine creation, never in the
+ *   event path, and are returned zeroed
+ * - Regions below HOTMEM_HUGE_MIN stay on small pages (still locked) so
+ *   they do not waste most of a huge page
+ */
+
+#ifndef RAVN_HOTMEM_H
+#define RAVN_HOTMEM_H
+
+#include <stddef.h>
+
+/*
+ * Hot Memory Configuration Parameters
+ */
+#define HOTMEM_HUGE_PAGE   (2UL << 20)	/* Huge page size */
+#define HOTMEM_HUGE_MIN	   (512UL << 10) /* Smallest region put on huge pages */
+#define HOTMEM_MAX_REGIONS 256		/* Live mapped regions */
+
+/**
+ * enum hotmem_policy - Where hot regions come from
+ */
+enum hotmem_policy {
+	HOTMEM_POLICY_HEAP = 0,	   /* Plain heap allocations */
+	HOTMEM_POLICY_THP = 1,	   /* Transparent huge pages */
+	HOTMEM_POLICY_HUGETLB = 2, /* Reserved huge pages, else THP */
+	HOTMEM_POLICY_MAX = 3
+};
+
+/**
+ * enum hotmem_backing - What a region ended up on
+ */
+enum hotmem_backing {
+	HOTMEM_BACKING_HEAP = 0,    /* Heap */
+	HOTMEM_BACKING_PAGES = 1,   /* Anonymous mapping, small pages */
+	HOTMEM_BACKING_THP = 2,	    /* Anonymous mapping advised for THP */
+	HOTMEM_BACKING_HUGETLB = 3  /* Reserved huge pages */
+};
+
+/**
+ * struct hotmem_region - One mapped hot region
+ * @name: Name given at allocation
+ * @addr: Start of the region
+ * @size: Requested size
+ * @mapped: Mapped size (rounded to the page size of the backing)
+ * @backing: What the region is backed by
+ * @locked: 1 if the region is locked in RAM
+ */
+struct hotmem_region {
+	const char* name;	     /* Region name */
+	void* addr;		     /* Start address */
+	size_t size;		     /* Requested bytes */
+	size_t mapped;		     /* Mapped bytes */
+	enum hotmem_backing backing; /* Backing */
+	int locked;		     /* Locked in RAM */
+};
+
+/**
+ * hotmem_configure - Set the process-wide allocation policy
+ * @policy: Backing of later allocations
+ * @lock: 1 to mlock() later allocations
+ *
+ * Existing regions keep their backing.
+ */
+void hotmem_configure(enum hotmem_policy policy, int lock);
+
+/**
+ * hotmem_parse_policy - Parse a policy name
+ * @name: "heap", "thp" or "hugetlb"
+ * @policy: Output policy
+ *
+ * Return: 0 on success, -1 if @name is unknown
+ */
+int hotmem_parse_policy(const char* name, enum hotmem_policy* policy);
+
+/**
+ * hotmem_policy_name - Name of a policy
+ * @policy: Policy
+ *
+ * Return: Static string
+ */
+const char* hotmem_policy_name(enum hotmem_policy policy);
+
+/**
+ * hotmem_backing_name - Name of a backing
+ * @backing: Backing
+ *
+ * Return: Static string
+ */
+const char* hotmem_backing_name(enum hotmem_backing backing);
+
+/**
+ * hotmem_alloc - Allocate a zeroed hot region
+ * @size: Bytes
+ * @name: Region name for reports (static string)
+ *
+ * Return: The region, NULL on allocation failure
+ */
+void* hotmem_alloc(size_t size, const char* name);
+
+/**
+ * hotmem_free - Release a region from hotmem_alloc()
+ * @ptr: Region (NULL is ignored)
+ */
+void hotmem_free(void* ptr);
+
+/**
+ * hotmem_find - Look up the region holding an address
+ * @ptr: Address
+ * @region: Output region (may be NULL)
+ *
+ * Return: Backing of @ptr, HOTMEM_BACKING_HEAP if it is not a mapped region
+ */
+enum hotmem_backing hotmem_find(const void* ptr, struct hotmem_region* region);
+
+/**
+ * hotmem_huge_bytes - Bytes of a region mapped with huge pages
+ * @ptr: Region start
+ *
+ * Reads /proc/self/smaps, so call it for reports only.
+ *
+ * Return: Bytes on huge pages, 0 if none or unknown
+ */
+size_t hotmem_huge_bytes(const void* ptr);
+
+/**
+ * hotmem_log - Log every mapped region with its backing
+ */
+void hotmem_log(void);
+
+#endif // RAVN_HOTMEM_H
@@ -0,0 +1,294 @@
+// RAVN Profiler Implementation
+// Scoped timer sites with lock-free per-thread accumulation
+
+#define _POSIX_C_SOURCE 200809L
+#include "profiler.h"
+
+#include "logger.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Per-thread statistics block, linked into a global list on first use and
+// handed to a later thread once its owner exits, keeping its samples
+struct prof_thread {
+	struct ravn_prof_stats sites[RAVN_PROF_MAX_SITES];
+	struct prof_thread* next;
+	int in_use; /* Owned by a live thread, under prof_lock */
+};
+
+// Global profiler state
+static int prof_enabled = 0;
+static int prof_site_count = 0;
+static ravn_prof_site_t* prof_sites[RAVN_PROF_MAX_SITES];
+static struct prof_thread* prof_threads = NULL;
+static pthread_mutex_t prof_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t prof_key;
+static pthread_once_t prof_key_once = PTHREAD_ONCE_INIT;
+
+// Statistics block of the calling thread
+static __thread struct prof_thread* tls_prof = NULL;
+
+// Initialize profiler from the environment
+void ravn_prof_init(void) {
+	const char* env = getenv("RAVN_PROFILE");
+	if (env && atoi(env) != 0) {
+		ravn_prof_set_enabled(1);
+	}
+}
+
+// Enable/disable runtime profiling
+void ravn_prof_set_enabled(int enable) {
+	__atomic_store_n(&prof_enabled, enable ? 1 : 0, __ATOMIC_RELAXED);
+	LOG_INFO_MODULE("PROFILER", "Runtime profiling %s", enable ? "enabled" : "disabled");
+}
+
+// Check whether runtime profiling is active
+int ravn_prof_enabled(void) {
+	return __atomic_load_n(&prof_enabled, __ATOMIC_RELAXED);
+}
+
+// Read the monotonic clock in nanoseconds
+uint64_t ravn_prof_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Start a timed scope
+uint64_t ravn_prof_begin(void) {
+	if (!__atomic_load_n(&prof_enabled, __ATOMIC_RELAXED)) {
+		return 0;
+	}
+	return ravn_prof_now_ns();
+}
+
+// Assign a registry slot to a site (slow path, taken once per site)
+static int prof_register_site(ravn_prof_site_t* site, const char* module, const char* name) {
+	pthread_mutex_lock(&prof_lock);
+	if (site->id == 0 && prof_site_count < RAVN_PROF_MAX_SITES) {
+		site->module = module;
+		site->name = name;
+		prof_sites[prof_site_count++] = site;
+		__atomic_store_n(&site->id, prof_site_count, __ATOMIC_RELEASE);
+	}
+	pthread_mutex_unlock(&prof_lock);
+	return site->id;
+}
+
+// Release the block of an exiting thread for the next thread to start
+static void prof_thread_exit(void* arg) {
+	struct prof_thread* block = arg;
+
+	pthread_mutex_lock(&prof_lock);
+	block->in_use = 0;
+	pthread_mutex_unlock(&prof_lock);
+}
+
+// Create the key whose destructor releases a thread's block
+static void prof_key_create(void) {
+	pthread_key_create(&prof_key, prof_thread_exit);
+}
+
+// Claim a statistics block for the calling thread: a released one, else a new one
+static struct prof_thread* prof_thread_block(void) {
+	if (tls_prof) {
+		return tls_prof;
+	}
+	pthread_once(&prof_key_once, prof_key_create);
+
+	pthread_mutex_lock(&prof_lock);
+	struct prof_thread* block = prof_threads;
+	while (block && block->in_use) {
+		block = block->next;
+	}
+	if (!block) {
+		block = calloc(1, sizeof(*block));
+		if (!block) {
+			pthread_mutex_unlock(&prof_lock);
+			return NULL;
+		}
+		block->next = prof_threads;
+		prof_threads = block;
+	}
+	block->in_use = 1;
+	pthread_mutex_unlock(&prof_lock);
+
+	pthread_setspecific(prof_key, block);
+	tls_prof = block;
+	return block;
+}
+
+// Map a duration to its log2 histogram bucket
+static int prof_bucket(uint64_t ns) {
+	int bucket = 63 - __builtin_clzll(ns | 1);
+	return bucket < RAVN_PROF_HIST_BUCKETS ? bucket : RAVN_PROF_HIST_BUCKETS - 1;
+}
+
+// Complete a timed scope
+void ravn_prof_end(ravn_prof_site_t* site, uint64_t start_ns, const char* module,
+		   const char* name) {
+	if (start_ns == 0 || !site) {
+		return;
+	}
+
+	uint64_t elapsed = ravn_prof_now_ns() - start_ns;
+
+	int id = __atomic_load_n(&site->id, __ATOMIC_ACQUIRE);
+	if (id == 0) {
+		id = prof_register_site(site, module, name);
+		if (id == 0) {
+			return; // Site table full
+		}
+	}
+
+	struct prof_thread* block = prof_thread_block();
+	if (!block) {
+		return;
+	}
+
+	// Only this thread writes its block; readers tolerate stale values
+	struct ravn_prof_stats* stats = &block->sites[id - 1];
+	if (stats->count == 0 || elapsed < stats->min_ns) {
+		stats->min_ns = elapsed;
+	}
+	if (elapsed > stats->max_ns) {
+		stats->max_ns = elapsed;
+	}
+	stats->count++;
+	stats->total_ns += elapsed;
+	stats->hist[prof_bucket(elapsed)]++;
+}
+
+// Clear all accumulated statistics
+void ravn_prof_reset(void) {
+	pthread_mutex_lock(&prof_lock);
+	for (struct prof_thread* t = prof_threads; t; t = t->next) {
+		memset(t->sites, 0, sizeof(t->sites));
+	}
+	pthread_mutex_unlock(&prof_lock);
+}
+
+// Aggregate statistics across all threads
+int ravn_prof_snapshot(struct ravn_prof_stats* out, int max) {
+	if (!out || max <= 0) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&prof_lock);
+	int count = prof_site_count < max ? prof_site_count : max;
+	for (int i = 0; i < count; i++) {
+		struct ravn_prof_stats* agg = &out[i];
+		memset(agg, 0, sizeof(*agg));
+		agg->module = prof_sites[i]->module;
+		agg->name = prof_sites[i]->name;
+
+		for (struct prof_thread* t = prof_threads; t; t = t->next) {
+			const struct ravn_prof_stats* s = &t->sites[i];
+			if (s->count == 0) {
+				continue;
+			}
+			if (agg->count == 0 || s->min_ns < agg->min_ns) {
+				agg->min_ns = s->min_ns;
+			}
+			if (s->max_ns > agg->max_ns) {
+				agg->max_ns = s->max_ns;
+			}
+			agg->threads++;
+			agg->count += s->count;
+			agg->total_ns += s->total_ns;
+			for (int b = 0; b < RAVN_PROF_HIST_BUCKETS; b++) {
+				agg->hist[b] += s->hist[b];
+			}
+		}
+	}
+	pthread_mutex_unlock(&prof_lock);
+
+	return count;
+}
+
+// Estimate a latency percentile from the histogram
+uint64_t ravn_prof_percentile_ns(const struct ravn_prof_stats* stats, double pct) {
+	if (!stats || stats->count == 0) {
+		return 0;
+	}
+
+	uint64_t target = (uint64_t)(stats->count * pct / 100.0);
+	if (target == 0) {
+		target = 1;
+	}
+
+	uint64_t seen = 0;
+	for (int b = 0; b < RAVN_PROF_HIST_BUCKETS; b++) {
+		seen += stats->hist[b];
+		if (seen >= target) {
+			uint64_t upper = 2ULL << b;
+			return upper < stats->max_ns ? upper : stats->max_ns;
+		}
+	}
+	return stats->max_ns;
+}
+
+// Render the profiling report as text
+size_t ravn_prof_format(char* buf, size_t size) {
+	static struct ravn_prof_stats stats[RAVN_PROF_MAX_SITES];
+	static pthread_mutex_t format_lock = PTHREAD_MUTEX_INITIALIZER;
+
+	if (!buf || size == 0) {
+		return 0;
+	}
+
+	pthread_mutex_lock(&format_lock);
+	int count = ravn_prof_snapshot(stats, RAVN_PROF_MAX_SITES);
+
+	size_t pos = 0;
+	int n = snprintf(buf, size, "%-14s %-30s %3s %10s %11s %9s %9s %9s %9s %9s\n", "MODULE",
+			 "SITE", "THR", "COUNT", "TOTAL_MS", "AVG_US", "MIN_US", "P50_US",
+			 "P99_US", "MAX_US");
+	if (n > 0) {
+		pos = (size_t)n < size ? (size_t)n : size - 1;
+	}
+
+	for (int i = 0; i < count && pos < size - 1; i++) {
+		const struct ravn_prof_stats* s = &stats[i];
+		if (s->count == 0) {
+			continue;
+		}
+
+		n = snprintf(buf + pos, size - pos,
+			     "%-14s %-30s %3u %10lu %11.3f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+			     s->module, s->name, s->threads, (unsigned long)s->count,
+			     s->total_ns / 1e6, (double)s->total_ns / s->count / 1e3,
+			     s->min_ns / 1e3, ravn_prof_percentile_ns(s, 50.0) / 1e3,
+			     ravn_prof_percentile_ns(s, 99.0) / 1e3, s->max_ns / 1e3);
+		if (n < 0) {
+			break;
+		}
+		pos += (size_t)n < size - pos ? (size_t)n : size - pos - 1;
+	}
+	pthread_mutex_unlock(&format_lock);
+
+	return pos;
+}
+
+// Write the profiling report to the log
+void ravn_prof_dump(void) {
+	static char report[16384];
+
+	if (!ravn_prof_enabled()) {
+		LOG_INFO_MODULE("PROFILER", "Profiling disabled (start with --profile or "
+					    "RAVN_PROFILE=1)");
+		return;
+	}
+
+	ravn_prof_format(report, sizeof(report));
+
+	LOG_INFO_MODULE("PROFILER", "Timer site report:");
+	char* save = NULL;
+	for (char* line = strtok_r(report, "\n", &save); line; line = strtok_r(NULL, "\n", &save)) {
+		LOG_INFO_MODULE("PROFILER", "%s", line);
+	}
+}
@@ -0,0 +1,348 @@
+// RAVN Terminal Renderer Implementation
+// Off-screen cell buffer with diffed, single-write frame output
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "tui.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+// Marks front cells that must be repainted
+#define TUI_CELL_INVALID 0xFFFFFFFFu
+
+// Worst case output per cell: cursor move, SGR and a 4-byte character
+#define TUI_CELL_OUT_MAX 32
+
+static volatile sig_atomic_t tui_resized = 1;
+
+// Note terminal resizes for the next frame
+static void tui_winch_handler(int sig) {
+	(void)sig;
+	tui_resized = 1;
+}
+
+// Write a whole buffer, retrying on short writes
+static int tui_write_all(int fd, const char* buf, size_t len) {
+	while (len > 0) {
+		ssize_t n = write(fd, buf, len);
+		if (n < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		buf += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+// Append raw bytes to the frame output
+static void tui_out(struct tui* tui, const char* data, size_t len) {
+	if (tui->out_len + len <= tui->out_cap) {
+		memcpy(tui->out + tui->out_len, data, len);
+		tui->out_len += len;
+	}
+}
+
+// Append formatted bytes to the frame output
+static void tui_outf(struct tui* tui, const char* fmt, ...) {
+	char buf[32];
+	va_list args;
+	va_start(args, fmt);
+	int n = vsnprintf(buf, sizeof(buf), fmt, args);
+	va_end(args);
+	if (n > 0) {
+		tui_out(tui, buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+	}
+}
+
+// Append a code point as UTF-8
+static void tui_out_utf8(struct tui* tui, uint32_t ch) {
+	char buf[4];
+	size_t len;
+
+	if (ch < 0x80) {
+		buf[0] = (char)ch;
+		len = 1;
+	} else if (ch < 0x800) {
+		buf[0] = (char)(0xC0 | (ch >> 6));
+		buf[1] = (char)(0x80 | (ch & 0x3F));
+		len = 2;
+	} else if (ch < 0x10000) {
+		buf[0] = (char)(0xE0 | (ch >> 12));
+		buf[1] = (char)(0x80 | ((ch >> 6) & 0x3F));
+		buf[2] = (char)(0x80 | (ch & 0x3F));
+		len = 3;
+	} else {
+		buf[0] = (char)(0xF0 | (ch >> 18));
+		buf[1] = (char)(0x80 | ((ch >> 12) & 0x3F));
+		buf[2] = (char)(0x80 | ((ch >> 6) & 0x3F));
+		buf[3] = (char)(0x80 | (ch & 0x3F));
+		len = 4;
+	}
+	tui_out(tui, buf, len);
+}
+
+// Decode one UTF-8 sequence, advancing the cursor; '?' for malformed input
+static uint32_t tui_decode_utf8(const unsigned char** s) {
+	const unsigned char* p = *s;
+	uint32_t ch;
+	int extra;
+
+	if (p[0] < 0x80) {
+		*s = p + 1;
+		return p[0];
+	} else if ((p[0] & 0xE0) == 0xC0) {
+		ch = p[0] & 0x1F;
+		extra = 1;
+	} else if ((p[0] & 0xF0) == 0xE0) {
+		ch = p[0] & 0x0F;
+		extra = 2;
+	} else if ((p[0] & 0xF8) == 0xF0) {
+		ch = p[0] & 0x07;
+		extra = 3;
+	} else {
+		*s = p + 1;
+		return '?';
+	}
+
+	for (int i = 1; i <= extra; i++) {
+		if ((p[i] & 0xC0) != 0x80) {
+			*s = p + i;
+			return '?';
+		}
+		ch = (ch << 6) | (p[i] & 0x3F);
+	}
+	*s = p + extra + 1;
+	return ch;
+}
+
+// Query the terminal size and (re)allocate the frame buffers
+static int tui_resize(struct tui* tui) {
+	struct winsize ws;
+	int rows = TUI_DEFAULT_ROWS;
+	int cols = TUI_DEFAULT_COLS;
+
+	if (ioctl(tui->fd, TIOCGWINSZ, &ws) == 0 && ws.ws_row > 0 && ws.ws_col > 0) {
+		rows = ws.ws_row;
+		cols = ws.ws_col;
+	}
+
+	if (rows != tui->rows || cols != tui->cols || !tui->back) {
+		size_t cells = (size_t)rows * (size_t)cols;
+		struct tui_cell* back = calloc(cells, sizeof(*back));
+		struct tui_cell* front = calloc(cells, sizeof(*front));
+		char* out = malloc(cells * TUI_CELL_OUT_MAX + 64);
+		if (!back || !front || !out) {
+			free(back);
+			free(front);
+			free(out);
+			return -1;
+		}
+
+		free(tui->back);
+		free(tui->front);
+		free(tui->out);
+		tui->back = back;
+		tui->front = front;
+		tui->out = out;
+		tui->out_cap = cells * TUI_CELL_OUT_MAX + 64;
+		tui->rows = rows;
+		tui->cols = cols;
+	}
+
+	tui->full_redraw = 1;
+	return 0;
+}
+
+// Take over the terminal
+int tui_init(struct tui* tui, int fd) {
+	if (!tui) {
+		return -1;
+	}
+
+	memset(tui, 0, sizeof(*tui));
+	tui->fd = fd;
+
+	struct sigaction sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = tui_winch_handler;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGWINCH, &sa, NULL);
+
+	tui_resized = 0;
+	if (tui_resize(tui) != 0) {
+		return -1;
+	}
+
+	// Alternate screen, hidden cursor, cleared once
+	static const char enter[] = "\033[?1049h\033[?25l\033[0m\033[2J";
+	return tui_write_all(fd, enter, sizeof(enter) - 1);
+}
+
+// Restore the terminal
+void tui_cleanup(struct tui* tui) {
+	if (!tui) {
+		return;
+	}
+
+	static const char leave[] = "\033[0m\033[?25h\033[?1049l";
+	tui_write_all(tui->fd, leave, sizeof(leave) - 1);
+
+	signal(SIGWINCH, SIG_DFL);
+	free(tui->back);
+	free(tui->front);
+	free(tui->out);
+	tui->back = NULL;
+	tui->front = NULL;
+	tui->out = NULL;
+}
+
+// Start a new frame
+int tui_begin(struct tui* tui) {
+	if (tui_resized) {
+		tui_resized = 0;
+		if (tui_resize(tui) != 0) {
+			return -1;
+		}
+	}
+
+	size_t cells = (size_t)tui->rows * (size_t)tui->cols;
+	for (size_t i = 0; i < cells; i++) {
+		tui->back[i].ch = ' ';
+		tui->back[i].style = TUI_DEFAULT;
+	}
+	return 0;
+}
+
+// Force a full repaint on the next flush
+void tui_invalidate(struct tui* tui) {
+	tui->full_redraw = 1;
+}
+
+// Draw formatted UTF-8 text
+int tui_print(struct tui* tui, int row, int col, uint8_t style, const char* fmt, ...) {
+	char text[TUI_MAX_TEXT];
+	va_list args;
+
+	va_start(args, fmt);
+	vsnprintf(text, sizeof(text), fmt, args);
+	va_end(args);
+
+	const unsigned char* s = (const unsigned char*)text;
+	while (*s) {
+		uint32_t ch = tui_decode_utf8(&s);
+		if (row >= 0 && row < tui->rows && col >= 0 && col < tui->cols) {
+			struct tui_cell* cell = &tui->back[row * tui->cols + col];
+			cell->ch = ch;
+			cell->style = style;
+		}
+		col++;
+	}
+	return col;
+}
+
+// Repeat one code point
+int tui_fill(struct tui* tui, int row, int col, int count, uint32_t ch, uint8_t style) {
+	for (int i = 0; i < count; i++, col++) {
+		if (row >= 0 && row < tui->rows && col >= 0 && col < tui->cols) {
+			struct tui_cell* cell = &tui->back[row * tui->cols + col];
+			cell->ch = ch;
+			cell->style = style;
+		}
+	}
+	return col;
+}
+
+// Draw a box with a title in its top border
+void tui_box(struct tui* tui, int row, int col, int height, int width, uint8_t style,
+	     const char* title) {
+	if (height < 2 || width < 2) {
+		return;
+	}
+
+	int right = col + width - 1;
+	int bottom = row + height - 1;
+
+	tui_fill(tui, row, col, 1, 0x250C, style); // ┌
+	tui_fill(tui, row, col + 1, width - 2, 0x2500, style);
+	tui_fill(tui, row, right, 1, 0x2510, style); // ┐
+	for (int r = row + 1; r < bottom; r++) {
+		tui_fill(tui, r, col, 1, 0x2502, style); // │
+		tui_fill(tui, r, right, 1, 0x2502, style);
+	}
+	tui_fill(tui, bottom, col, 1, 0x2514, style); // └
+	tui_fill(tui, bottom, col + 1, width - 2, 0x2500, style);
+	tui_fill(tui, bottom, right, 1, 0x2518, style); // ┘
+
+	if (title) {
+		tui_print(tui, row, col + 2, style, " %s ", title);
+	}
+}
+
+// Send the changes of the frame to the terminal
+long tui_flush(struct tui* tui) {
+	size_t cells = (size_t)tui->rows * (size_t)tui->cols;
+	int cur_row = -1, cur_col = -1;
+	int cur_style = -1;
+
+	if (tui->full_redraw) {
+		for (size_t i = 0; i < cells; i++) {
+			tui->front[i].ch = TUI_CELL_INVALID;
+		}
+		tui->full_redraw = 0;
+	}
+
+	tui->out_len = 0;
+	for (int r = 0; r < tui->rows; r++) {
+		for (int c = 0; c < tui->cols; c++) {
+			const struct tui_cell* want = &tui->back[r * tui->cols + c];
+			const struct tui_cell* have = &tui->front[r * tui->cols + c];
+			if (want->ch == have->ch && want->style == have->style) {
+				continue;
+			}
+
+			// Relative moves are shorter within a row
+			if (r != cur_row || c < cur_col) {
+				tui_outf(tui, "\033[%d;%dH", r + 1, c + 1);
+			} else if (c > cur_col) {
+				tui_outf(tui, "\033[%dC", c - cur_col);
+			}
+
+			if (want->style != cur_style) {
+				int color = want->style & 0x0F;
+				tui_outf(tui, (want->style & TUI_BOLD) ? "\033[0;1;3%dm" : "\033[0;3%dm",
+					 color > 9 ? 9 : color);
+				cur_style = want->style;
+			}
+
+			tui_out_utf8(tui, want->ch);
+			cur_row = r;
+			cur_col = c + 1;
+
+			// The cursor stays on the last column; force an absolute move next
+			if (cur_col >= tui->cols) {
+				cur_row = -1;
+			}
+		}
+	}
+
+	memcpy(tui->front, tui->back, cells * sizeof(*tui->front));
+	if (tui->out_len == 0) {
+		return 0;
+	}
+
+	if (tui_write_all(tui->fd, tui->out, tui->out_len) != 0) {
+		return -1;
+	}
+	tui->bytes_written += tui->out_len;
+	return (long)tui->out_len;
+}
@@ -0,0 +1,176 @@
+/*
+ * RAVN Terminal Renderer - Header File
+ *
+ * This header defines the terminal rendering layer of the RAVN security
+ * platform, used by the CLI dashboard to draw frames without flicker and
+ * with as little output as possible.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * The terminal renderer implements:
+ * - An off-screen cell buffer (one code point and one style per cell)
+ * - UTF-8 text and box drawing into the buffer with clipping
+ * - Frame diffing against the cells already on screen
+ * - Output of only the changed cells, with cursor moves and SGR changes
+ *   kept to the minimum, in a single write() per frame
+ * - Alternate screen, hidden cursor and resize handling
+ *
+ * Architecture:
+ * - Drawing never touches the terminal; tui_flush() is the only output
+ * - The previous frame is kept, so an unchanged frame costs no output
+ * - A resize or tui_invalidate() forces one full redraw
+ * - Every cell is one column wide (box drawing, blocks and symbols)
+ */
+
+#ifndef RAVN_TUI_H
+#define RAVN_TUI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Terminal Renderer Configuration Parameters
+ */
+#define TUI_DEFAULT_ROWS 24  /* Size used when the terminal size is unknown */
+#define TUI_DEFAULT_COLS 80  /* Size used when the terminal size is unknown */
+#define TUI_MAX_TEXT	 1024 /* Longest formatted string per call */
+
+/*
+ * Cell styles: a foreground color, optionally combined with TUI_BOLD
+ */
+#define TUI_BLACK   0
+#define TUI_RED	    1
+#define TUI_GREEN   2
+#define TUI_YELLOW  3
+#define TUI_BLUE    4
+#define TUI_MAGENTA 5
+#define TUI_CYAN    6
+#define TUI_WHITE   7
+#define TUI_DEFAULT 9	 /* Terminal default color */
+#define TUI_BOLD    0x10 /* Bold/bright attribute */
+
+/**
+ * struct tui_cell - One character cell
+ * @ch: Unicode code point
+ * @style: Foreground color with optional TUI_BOLD
+ */
+struct tui_cell {
+	uint32_t ch;   /* Code point */
+	uint8_t style; /* Color and attributes */
+};
+
+/**
+ * struct tui - Terminal renderer state
+ * @fd: Output file descriptor
+ * @rows: Terminal rows
+ * @cols: Terminal columns
+ * @back: Frame being drawn
+ * @front: Frame currently on screen
+ * @out: Output buffer for one frame
+ * @out_len: Bytes used in @out
+ * @out_cap: Capacity of @out
+ * @full_redraw: Next flush repaints every cell
+ * @bytes_written: Bytes written to the terminal (cumulative)
+ */
+struct tui {
+	int fd;			/* Output descriptor */
+	int rows;		/* Terminal rows */
+	int cols;		/* Terminal columns */
+	struct tui_cell* back;	/* Frame being drawn */
+	struct tui_cell* front; /* Frame on screen */
+	char* out;		/* Frame output */
+	size_t out_len;		/* Output used */
+	size_t out_cap;		/* Output capacity */
+	int full_redraw;	/* Repaint everything */
+	uint64_t bytes_written; /* Output volume */
+};
+
+/**
+ * tui_init - Take over the terminal
+ * @tui: Renderer to initialize
+ * @fd: Terminal file descriptor (usually STDOUT_FILENO)
+ *
+ * Switches to the alternate screen, hides the cursor and installs a
+ * SIGWINCH handler so resizes are picked up by the next tui_begin().
+ *
+ * Return: 0 on success, -1 on failure
+ */
+int tui_init(struct tui* tui, int fd);
+
+/**
+ * tui_cleanup - Restore the terminal
+ * @tui: Renderer to release
+ */
+void tui_cleanup(struct tui* tui);
+
+/**
+ * tui_begin - Start a new frame
+ * @tui: Renderer
+ *
+ * Applies a pending resize and clears the off-screen buffer.
+ *
+ * Return: 0 on success, -1 if the buffers could not be resized
+ */
+int tui_begin(struct tui* tui);
+
+/**
+ * tui_invalidate - Force a full repaint on the next flush
+ * @tui: Renderer
+ */
+void tui_invalidate(struct tui* tui);
+
+/**
+ * tui_print - Draw formatted UTF-8 text
+ * @tui: Renderer
+ * @row: Row (0-based)
+ * @col: Column (0-based)
+ * @style: Cell style
+ * @fmt: printf-style format
+ *
+ * Text outside the terminal is clipped; newlines are not interpreted.
+ *
+ * Return: Column after the last cell drawn
+ */
+int tui_print(struct tui* tui, int row, int col, uint8_t style, const char* fmt, ...)
+	__attribute__((format(printf, 5, 6)));
+
+/**
+ * tui_fill - Repeat one code point
+ * @tui: Renderer
+ * @row: Row (0-based)
+ * @col: First column (0-based)
+ * @count: Number of cells
+ * @ch: Code point to repeat
+ * @style: Cell style
+ *
+ * Return: Column after the last cell drawn
+ */
+int tui_fill(struct tui* tui, int row, int col, int count, uint32_t ch, uint8_t style);
+
+/**
+ * tui_box - Draw a box with a title in its top border
+ * @tui: Renderer
+ * @row: Top row
+ * @col: Left column
+ * @height: Rows including both borders
+ * @width: Columns including both borders
+ * @style: Border style
+ * @title: Title text, or NULL
+ */
+void tui_box(struct tui* tui, int row, int col, int height, int width, uint8_t style,
+	     const char* title);
+
+/**
+ * tui_flush - Send the changes of the frame to the terminal
+ * @tui: Renderer
+ *
+ * Emits only the cells that differ from the frame on screen, in a single
+ * write().
+ *
+ * Return: Bytes written, -1 on failure
+ */
+long tui_flush(struct tui* tui);
+
+#endif // RAVN_TUI_H
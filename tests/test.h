@@ -0,0 +1,46 @@
+/*
+ * RAVN Unit Tests - Header File
+ *
+ * Minimal assertion helpers shared by the unit tests in tests/, which
+ * "make test" builds against the daemon sources and runs one by one.
+ *
+ * Copyright (C) 2024 RAVN Security Platform
+ * Author: RAVN Development Team
+ * License: GPL v2
+ *
+ * Architecture:
+ * - Each test is a standalone program linking only the sources it covers,
+ *   so it builds without libbpf, hiredis or a running daemon
+ * - A failed check prints its location and is counted; TEST_RESULT() turns
+ *   the count into the exit status
+ */
+
+#ifndef RAVN_TEST_H
+#define RAVN_TEST_H
+
+#include <stdio.h>
+
+static int test_failures = 0;
+
+/* Check a condition, reporting the failure and continuing */
+#define TEST_CHECK(cond)                                                                       \
+	do {                                                                                   \
+		if (!(cond)) {                                                                 \
+			fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__,       \
+				#cond);                                                        \
+			test_failures++;                                                       \
+		}                                                                              \
+	} while (0)
+
+/* Run one test function and report it */
+#define TEST_RUN(fn)                                                                           \
+	do {                                                                                   \
+		int before = test_failures;                                                    \
+		fn();                                                                          \
+		printf("  %-40s %s\n", #fn, test_failures == before ? "ok" : "FAILED");        \
+	} while (0)
+
+/* Exit status of a test program */
+#define TEST_RESULT() (test_failures ? 1 : 0)
+
+#endif // RAVN_TEST_H
@@ -0,0 +1,252 @@
+// RAVN Column Codec Tests
+// Round trips and malformed input for the delta, bit-packing and LZ codecs
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "../src/daemon/codec.h"
+
+#include "test.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_VALUES 5000
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+// Deterministic xorshift64 generator
+static uint64_t rng(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state;
+}
+
+// Encode and decode timestamps, checking the bound and the exact size
+static int delta_round_trip(const uint64_t* in, uint32_t n) {
+	static uint8_t encoded[8 + (TEST_VALUES - 1) * 10];
+	static uint64_t decoded[TEST_VALUES];
+
+	size_t size = codec_delta_encode(in, n, encoded);
+	if (size > codec_delta_bound(n)) {
+		return -1;
+	}
+	if (codec_delta_decode(encoded, size, n, decoded) != 0) {
+		return -1;
+	}
+	if (memcmp(in, decoded, n * sizeof(uint64_t)) != 0) {
+		return -1;
+	}
+
+	// Missing bytes and trailing garbage are both malformed
+	if (n > 1 && codec_delta_decode(encoded, size - 1, n, decoded) == 0) {
+		return -1;
+	}
+	encoded[size] = 0;
+	if (codec_delta_decode(encoded, size + 1, n, decoded) == 0) {
+		return -1;
+	}
+	return 0;
+}
+
+// Nanosecond clocks, backward steps and the extremes of the 64-bit range
+static void test_delta(void) {
+	static uint64_t values[TEST_VALUES];
+	static uint8_t encoded[8 + (TEST_VALUES - 1) * 10];
+
+	uint64_t ts = 1700000000000000000ULL;
+	for (uint32_t i = 0; i < TEST_VALUES; i++) {
+		ts += rng() % 2000;
+		values[i] = (i % 17 == 0) ? ts - rng() % 2000 : ts; // Other CPUs lag behind
+	}
+	TEST_CHECK(delta_round_trip(values, TEST_VALUES) == 0);
+	TEST_CHECK(delta_round_trip(values, 1) == 0);
+
+	// Mostly small steps: one or two bytes per value
+	size_t size = codec_delta_encode(values, TEST_VALUES, encoded);
+	TEST_CHECK(size < 8 + (size_t)TEST_VALUES * 2);
+
+	for (uint32_t i = 0; i < TEST_VALUES; i++) {
+		values[i] = i % 2 ? UINT64_MAX : 0;
+	}
+	TEST_CHECK(delta_round_trip(values, TEST_VALUES) == 0);
+
+	for (uint32_t i = 0; i < TEST_VALUES; i++) {
+		values[i] = rng();
+	}
+	TEST_CHECK(delta_round_trip(values, TEST_VALUES) == 0);
+
+	// Nothing to decode for zero values, too little for the first one
+	uint8_t short_input[4] = {0};
+	TEST_CHECK(codec_delta_decode(short_input, 0, 0, values) == 0);
+	TEST_CHECK(codec_delta_decode(short_input, sizeof(short_input), 1, values) == -1);
+
+	// A varint longer than 64 bits
+	uint8_t overlong[8 + 11];
+	memset(overlong, 0, 8);
+	memset(overlong + 8, 0xFF, 10);
+	overlong[18] = 0x01;
+	TEST_CHECK(codec_delta_decode(overlong, sizeof(overlong), 2, values) == -1);
+}
+
+// Pack and unpack values, checking the bound, alignment and truncation
+static int pack_round_trip(const uint32_t* in, uint32_t n) {
+	static uint32_t packed[(TEST_VALUES / CODEC_GROUP + 1) * (CODEC_GROUP + 2)];
+	static uint32_t unpacked[CODEC_PADDED(TEST_VALUES)];
+
+	size_t size = codec_pack(in, n, (uint8_t*)packed);
+	if (size > codec_pack_bound(n) || size % 4 != 0) {
+		return -1;
+	}
+	if (codec_unpack((const uint8_t*)packed, size, n, unpacked) != 0) {
+		return -1;
+	}
+	if (memcmp(in, unpacked, n * sizeof(uint32_t)) != 0) {
+		return -1;
+	}
+
+	// Missing lanes must not be read past the end
+	size_t header = codec_pack_bound(n) - (size_t)CODEC_PADDED(n) * sizeof(uint32_t);
+	if (size - header >= 16 &&
+	    codec_unpack((const uint8_t*)packed, size - 16, n, unpacked) == 0) {
+		return -1;
+	}
+	return 0;
+}
+
+// Group boundaries, constant groups and the full 32-bit range
+static void test_pack(void) {
+	static uint32_t values[TEST_VALUES];
+	const uint32_t counts[] = {1, 3, CODEC_GROUP - 1, CODEC_GROUP, CODEC_GROUP + 1, 1000,
+				   TEST_VALUES};
+
+	for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		uint32_t n = counts[c];
+
+		for (uint32_t i = 0; i < n; i++) {
+			values[i] = 4000 + (uint32_t)(rng() % 64); // PIDs of a few processes
+		}
+		TEST_CHECK(pack_round_trip(values, n) == 0);
+
+		for (uint32_t i = 0; i < n; i++) {
+			values[i] = 42;
+		}
+		TEST_CHECK(pack_round_trip(values, n) == 0);
+
+		for (uint32_t i = 0; i < n; i++) {
+			values[i] = i % 2 ? UINT32_MAX : 0;
+		}
+		TEST_CHECK(pack_round_trip(values, n) == 0);
+
+		for (uint32_t i = 0; i < n; i++) {
+			values[i] = (uint32_t)rng();
+		}
+		TEST_CHECK(pack_round_trip(values, n) == 0);
+	}
+
+	// Constant groups store no lanes at all
+	for (uint32_t i = 0; i < CODEC_GROUP; i++) {
+		values[i] = 7;
+	}
+	uint32_t packed[CODEC_GROUP + 2];
+	TEST_CHECK(codec_pack(values, CODEC_GROUP, (uint8_t*)packed) == 8);
+
+	// A header claiming more lanes than the input holds
+	uint32_t forged[2] = {0, 32};
+	uint32_t out[CODEC_GROUP];
+	TEST_CHECK(codec_unpack((const uint8_t*)forged, sizeof(forged), CODEC_GROUP, out) == -1);
+	TEST_CHECK(codec_unpack((const uint8_t*)forged, 2, CODEC_GROUP, out) == -1);
+}
+
+// Compress and decompress bytes, checking the bound and the recorded size
+static int lz_round_trip(const uint8_t* in, size_t n, size_t* compressed) {
+	uint8_t* encoded = malloc(codec_lz_bound(n));
+	uint8_t* decoded = malloc(n + 1);
+	int ret = -1;
+
+	if (!encoded || !decoded) {
+		goto out;
+	}
+	size_t size = codec_lz_encode(in, n, encoded);
+	if (size > codec_lz_bound(n)) {
+		goto out;
+	}
+	if (codec_lz_decode(encoded, size, decoded, n) != 0 || memcmp(in, decoded, n) != 0) {
+		goto out;
+	}
+
+	// A different recorded size, or a cut stream, is malformed
+	if (codec_lz_decode(encoded, size, decoded, n + 1) == 0) {
+		goto out;
+	}
+	if (n > 0 && codec_lz_decode(encoded, size, decoded, n - 1) == 0) {
+		goto out;
+	}
+	if (n > 0 && codec_lz_decode(encoded, size / 2, decoded, n) == 0) {
+		goto out;
+	}
+	if (compressed) {
+		*compressed = size;
+	}
+	ret = 0;
+out:
+	free(encoded);
+	free(decoded);
+	return ret;
+}
+
+// Empty and tiny inputs, long runs, far matches and incompressible bytes
+static void test_lz(void) {
+	const size_t big = 3 * CODEC_LZ_WINDOW;
+	uint8_t* buf = malloc(big);
+	size_t size = 0;
+
+	TEST_CHECK(buf != NULL);
+	if (!buf) {
+		return;
+	}
+
+	TEST_CHECK(lz_round_trip(buf, 0, NULL) == 0);
+	memcpy(buf, "abc", 3);
+	TEST_CHECK(lz_round_trip(buf, 3, NULL) == 0);
+
+	// Zero padding of fixed-size records: one long overlapping match
+	memset(buf, 0, big);
+	TEST_CHECK(lz_round_trip(buf, big, &size) == 0);
+	TEST_CHECK(size < big / 200);
+
+	// Records repeating names and paths
+	for (size_t i = 0; i < big; i++) {
+		buf[i] = "/usr/bin/bash\0sshd\0/etc/passwd\0"[i % 31];
+	}
+	TEST_CHECK(lz_round_trip(buf, big, &size) == 0);
+	TEST_CHECK(size < big / 20);
+
+	// A repeat just beyond the window cannot be referenced
+	for (size_t i = 0; i < CODEC_LZ_WINDOW + 64; i++) {
+		buf[i] = (uint8_t)rng();
+	}
+	memcpy(buf + CODEC_LZ_WINDOW + 64, buf, 64);
+	TEST_CHECK(lz_round_trip(buf, CODEC_LZ_WINDOW + 128, NULL) == 0);
+
+	for (size_t i = 0; i < big; i++) {
+		buf[i] = (uint8_t)rng();
+	}
+	TEST_CHECK(lz_round_trip(buf, big, &size) == 0);
+	TEST_CHECK(size <= codec_lz_bound(big));
+
+	// A match reaching before the start of the output
+	const uint8_t forged[] = {0x10, 'a', 0x05, 0x00};
+	TEST_CHECK(codec_lz_decode(forged, sizeof(forged), buf, 5) == -1);
+
+	free(buf);
+}
+
+int main(void) {
+	printf("codec:\n");
+	TEST_RUN(test_delta);
+	TEST_RUN(test_pack);
+	TEST_RUN(test_lz);
+	return TEST_RESULT();
+}
@@ -0,0 +1,164 @@
+// RAVN Feature Batch Tests
+// The libravnfeatures.so contract the training scripts rely on
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "../src/daemon/features.h"
+
+#include "test.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_EVENTS (2 * MAX_EVENTS_PER_WINDOW)
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t events[TEST_EVENTS];
+static uint64_t timestamps[TEST_EVENTS];
+
+// Deterministic xorshift64 generator
+static uint64_t rng(void) {
+	rng_state ^= rng_state << 13;
+	rng_state ^= rng_state >> 7;
+	rng_state ^= rng_state << 17;
+	return rng_state;
+}
+
+// Syscalls, file and network events, seconds apart or in bursts
+static void fill_events(void) {
+	uint64_t ts = 1700000000000000000ULL;
+
+	for (uint32_t i = 0; i < TEST_EVENTS; i++) {
+		ts += rng() % 3000000000ULL;
+		events[i] = (uint32_t)(rng() % 400);
+		timestamps[i] = ts;
+	}
+}
+
+// Features of events[first, first + count) through the daemon's own extractor
+static int expected_row(uint64_t first, uint32_t count, uint32_t pid, float* row) {
+	struct event_sequence* seq = calloc(1, sizeof(*seq));
+
+	if (!seq) {
+		return -1;
+	}
+	seq->pid = pid;
+	seq->event_count = count;
+	memcpy(seq->events, &events[first], count * sizeof(uint32_t));
+	memcpy(seq->timestamps, &timestamps[first], count * sizeof(uint64_t));
+	int ret = extract_features_from_events(seq, row);
+	free(seq);
+	return ret;
+}
+
+// Every value of a row lies in [0,1]
+static int row_normalized(const float* row) {
+	for (int f = 0; f < TOTAL_FEATURES; f++) {
+		if (!(row[f] >= 0.0f && row[f] <= 1.0f)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// Whether a row is all zeros
+static int row_zero(const float* row) {
+	for (int f = 0; f < TOTAL_FEATURES; f++) {
+		if (row[f] != 0.0f) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// The version and the row length the scripts check before loading
+static void test_abi(void) {
+	TEST_CHECK(ravn_features_abi() == RAVN_FEATURES_ABI);
+	TEST_CHECK(ravn_features_dim() == TOTAL_FEATURES);
+}
+
+// Row i holds the features of [offsets[i], offsets[i + 1]), empty rows are zero
+static void test_rows(void) {
+	const uint64_t offsets[] = {0, 1, 40, 40, 340, 900};
+	const uint32_t pids[] = {100, 200, 300, 400, 500};
+	const uint32_t count = sizeof(pids) / sizeof(pids[0]);
+	static float features[5 * TOTAL_FEATURES];
+	float expected[TOTAL_FEATURES];
+
+	fill_events();
+	memset(features, 0xFF, sizeof(features)); // NaN until written
+	TEST_CHECK(ravn_features_batch(events, timestamps, offsets, pids, count, features) == 0);
+
+	for (uint32_t i = 0; i < count; i++) {
+		const float* row = &features[i * TOTAL_FEATURES];
+		uint32_t length = (uint32_t)(offsets[i + 1] - offsets[i]);
+
+		TEST_CHECK(row_normalized(row));
+		if (length == 0) {
+			TEST_CHECK(row_zero(row));
+			continue;
+		}
+		TEST_CHECK(expected_row(offsets[i], length, pids[i], expected) == 0);
+		TEST_CHECK(memcmp(row, expected, sizeof(expected)) == 0);
+		TEST_CHECK(!row_zero(row));
+	}
+
+	// Without PIDs the rows are the same
+	static float no_pids[5 * TOTAL_FEATURES];
+	TEST_CHECK(ravn_features_batch(events, timestamps, offsets, NULL, count, no_pids) == 0);
+	TEST_CHECK(memcmp(features, no_pids, sizeof(no_pids)) == 0);
+
+	// Nothing to do for an empty batch
+	TEST_CHECK(ravn_features_batch(events, timestamps, offsets, pids, 0, features) == 0);
+}
+
+// Long sequences keep their first MAX_EVENTS_PER_WINDOW events
+static void test_truncation(void) {
+	const uint64_t offsets[] = {0, TEST_EVENTS};
+	float row[TOTAL_FEATURES], expected[TOTAL_FEATURES];
+
+	fill_events();
+	for (uint32_t i = MAX_EVENTS_PER_WINDOW; i < TEST_EVENTS; i++) {
+		events[i] = FILE_EVENT_CREATE; // Would skew the row if it were read
+		timestamps[i] = timestamps[MAX_EVENTS_PER_WINDOW - 1];
+	}
+
+	TEST_CHECK(ravn_features_batch(events, timestamps, offsets, NULL, 1, row) == 0);
+	TEST_CHECK(expected_row(0, MAX_EVENTS_PER_WINDOW, 0, expected) == 0);
+	TEST_CHECK(memcmp(row, expected, sizeof(expected)) == 0);
+	TEST_CHECK(row_normalized(row));
+}
+
+// Missing arrays and decreasing offsets are rejected
+static void test_invalid(void) {
+	const uint64_t offsets[] = {0, 50, 20, 80};
+	static float features[3 * TOTAL_FEATURES];
+	float expected[TOTAL_FEATURES];
+
+	fill_events();
+	TEST_CHECK(ravn_features_batch(NULL, timestamps, offsets, NULL, 1, features) == -1);
+	TEST_CHECK(ravn_features_batch(events, NULL, offsets, NULL, 1, features) == -1);
+	TEST_CHECK(ravn_features_batch(events, timestamps, NULL, NULL, 1, features) == -1);
+	TEST_CHECK(ravn_features_batch(events, timestamps, offsets, NULL, 1, NULL) == -1);
+
+	// The bad row is zero, the others are still extracted
+	memset(features, 0xFF, sizeof(features));
+	TEST_CHECK(ravn_features_batch(events, timestamps, offsets, NULL, 3, features) == -1);
+	TEST_CHECK(row_zero(&features[TOTAL_FEATURES]));
+
+	TEST_CHECK(expected_row(0, 50, 0, expected) == 0);
+	TEST_CHECK(memcmp(&features[0], expected, sizeof(expected)) == 0);
+	TEST_CHECK(expected_row(20, 60, 0, expected) == 0);
+	TEST_CHECK(memcmp(&features[2 * TOTAL_FEATURES], expected, sizeof(expected)) == 0);
+}
+
+int main(void) {
+	printf("features:\n");
+	TEST_RUN(test_abi);
+	TEST_RUN(test_rows);
+	TEST_RUN(test_truncation);
+	TEST_RUN(test_invalid);
+	return TEST_RESULT();
+}
@@ -0,0 +1,82 @@
+// RAVN Profiler Tests
+// Timer site accounting and the reuse of exited threads' blocks
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "../src/utils/profiler.h"
+
+#include "../src/utils/logger.h"
+#include "test.h"
+
+#include <pthread.h>
+#include <string.h>
+
+#define TEST_RESTARTS 50
+
+static ravn_prof_site_t test_site;
+
+// Record one sample at the test site
+static void* sample_thread(void* arg) {
+	(void)arg;
+	ravn_prof_end(&test_site, ravn_prof_begin(), "TEST", "sample");
+	return NULL;
+}
+
+// Statistics of the test site
+static int site_stats(struct ravn_prof_stats* out) {
+	static struct ravn_prof_stats stats[RAVN_PROF_MAX_SITES];
+	int count = ravn_prof_snapshot(stats, RAVN_PROF_MAX_SITES);
+
+	for (int i = 0; i < count; i++) {
+		if (strcmp(stats[i].module, "TEST") == 0) {
+			*out = stats[i];
+			return 0;
+		}
+	}
+	return -1;
+}
+
+// Threads restarted one after the other share one block and keep their samples
+static void test_thread_restarts(void) {
+	struct ravn_prof_stats stats;
+	pthread_t thread;
+
+	for (int i = 0; i < TEST_RESTARTS; i++) {
+		TEST_CHECK(pthread_create(&thread, NULL, sample_thread, NULL) == 0);
+		pthread_join(thread, NULL);
+	}
+	TEST_CHECK(site_stats(&stats) == 0);
+	TEST_CHECK(stats.count == TEST_RESTARTS);
+	TEST_CHECK(stats.threads == 1);
+	TEST_CHECK(stats.min_ns <= stats.max_ns);
+}
+
+// Concurrent threads each get their own block
+static void test_concurrent_threads(void) {
+	struct ravn_prof_stats stats;
+	pthread_t threads[2];
+
+	ravn_prof_reset();
+	sample_thread(NULL); // The main thread holds a block while the others run
+	for (int i = 0; i < 2; i++) {
+		TEST_CHECK(pthread_create(&threads[i], NULL, sample_thread, NULL) == 0);
+	}
+	for (int i = 0; i < 2; i++) {
+		pthread_join(threads[i], NULL);
+	}
+	TEST_CHECK(site_stats(&stats) == 0);
+	TEST_CHECK(stats.count == 3);
+	TEST_CHECK(stats.threads >= 2 && stats.threads <= 3);
+}
+
+int main(void) {
+	logger_init(LOG_LEVEL_WARN, NULL);
+	ravn_prof_set_enabled(1);
+
+	printf("profiler:\n");
+	TEST_RUN(test_thread_restarts);
+	TEST_RUN(test_concurrent_threads);
+
+	logger_cleanup();
+	return TEST_RESULT();
+}
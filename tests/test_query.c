@@ -0,0 +1,157 @@
+// RAVN Event Query Tests
+// Run the query tool over a written store and check what it prints
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "../src/tools/query.h"
+
+#include "../src/daemon/store.h"
+#include "../src/utils/logger.h"
+#include "../src/utils/profiler.h"
+#include "test.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Several blocks, so a limit cuts inside one of them */
+#define TEST_EVENTS (2 * STORE_BLOCK_EVENTS + 500)
+#define TEST_PIDS 10
+
+static char test_dir[] = "/tmp/ravn-test-query-XXXXXX";
+static char out_path[sizeof(test_dir) + 16];
+
+// Append the test events, TEST_PIDS processes taking turns
+static void write_events(void) {
+	uint64_t start = ravn_prof_now_ns();
+
+	for (uint32_t i = 0; i < TEST_EVENTS; i++) {
+		store_append(start + (uint64_t)i * 1000, 2000 + i % TEST_PIDS, 0, i % 11,
+			     1 + i % 8, "bash", "/tmp/file", NULL);
+	}
+}
+
+// Run a query with its stdout in out_path and stderr discarded
+static int run_query(int argc, char* argv[]) {
+	int out = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	int null = open("/dev/null", O_WRONLY);
+	int saved_out = dup(STDOUT_FILENO);
+	int saved_err = dup(STDERR_FILENO);
+	int result = -1;
+
+	if (out >= 0 && null >= 0 && saved_out >= 0 && saved_err >= 0) {
+		fflush(stdout);
+		dup2(out, STDOUT_FILENO);
+		dup2(null, STDERR_FILENO);
+		result = query_main(argc, argv);
+		fflush(stdout);
+		dup2(saved_out, STDOUT_FILENO);
+		dup2(saved_err, STDERR_FILENO);
+	}
+	if (out >= 0) {
+		close(out);
+	}
+	if (null >= 0) {
+		close(null);
+	}
+	if (saved_out >= 0) {
+		close(saved_out);
+	}
+	if (saved_err >= 0) {
+		close(saved_err);
+	}
+	return result;
+}
+
+// Lines of the last query's output, and the number on the first one
+static uint64_t output_lines(uint64_t* first) {
+	FILE* f = fopen(out_path, "r");
+	char line[4096];
+	uint64_t lines = 0;
+
+	*first = 0;
+	if (!f) {
+		return 0;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		if (lines++ == 0) {
+			*first = strtoull(line, NULL, 10);
+		}
+	}
+	fclose(f);
+	return lines;
+}
+
+// Events printed up to --limit, cut inside a block
+static void test_limit(void) {
+	char* argv[] = {"query", "--limit", "10", "--jobs", "2", test_dir};
+	uint64_t first;
+
+	TEST_CHECK(run_query(6, argv) == 0);
+	TEST_CHECK(output_lines(&first) == 10);
+}
+
+// --count prints only the number of matches, bounded by --limit
+static void test_count(void) {
+	// Options stay set across query_main() calls: 0 lifts the earlier limit
+	char* all[] = {"query", "--count", "--limit", "0", "--jobs", "2", test_dir};
+	char* below[] = {"query", "--count", "--limit", "100", "--jobs", "2", test_dir};
+	char* above[] = {"query", "--count", "--limit", "999999", "--jobs", "2", test_dir};
+	char* pid[] = {"query", "--count", "--pid", "2003", "--limit", "7", "--jobs", "2",
+		       test_dir};
+	uint64_t count;
+
+	TEST_CHECK(run_query(7, all) == 0);
+	TEST_CHECK(output_lines(&count) == 1 && count == TEST_EVENTS);
+
+	// A limit below the matches of the first block
+	TEST_CHECK(run_query(7, below) == 0);
+	TEST_CHECK(output_lines(&count) == 1 && count == 100);
+
+	TEST_CHECK(run_query(7, above) == 0);
+	TEST_CHECK(output_lines(&count) == 1 && count == TEST_EVENTS);
+
+	TEST_CHECK(run_query(9, pid) == 0);
+	TEST_CHECK(output_lines(&count) == 1 && count == 7);
+}
+
+// Remove the test directory
+static void remove_dir(void) {
+	char** paths = NULL;
+	int count = 0;
+
+	if (store_list_segments(test_dir, &paths, &count) == 0) {
+		for (int s = 0; s < count; s++) {
+			unlink(paths[s]);
+			free(paths[s]);
+		}
+		free(paths);
+	}
+	unlink(out_path);
+	rmdir(test_dir);
+}
+
+int main(void) {
+	logger_init(LOG_LEVEL_WARN, NULL);
+	if (!mkdtemp(test_dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+	snprintf(out_path, sizeof(out_path), "%s/out.txt", test_dir);
+
+	printf("query:\n");
+	if (store_open(test_dir, 0) != 0) {
+		TEST_CHECK(0);
+	} else {
+		write_events();
+		store_close();
+		TEST_RUN(test_limit);
+		TEST_RUN(test_count); // After test_limit: --count cannot be unset
+	}
+
+	remove_dir();
+	logger_cleanup();
+	return TEST_RESULT();
+}
@@ -0,0 +1,187 @@
+// RAVN Activity Sketch Tests
+// Error bounds of the Space-Saving, Count-Min and HyperLogLog sketches
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "../src/daemon/sketch.h"
+
+#include "test.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TEST_KEYS 5000 /* Distinct keys of the skewed stream */
+
+static uint64_t true_count[TEST_KEYS];
+static uint64_t stream_total = 0;
+
+// Key of index i
+static const char* key_name(uint32_t i, char* buf, size_t size) {
+	snprintf(buf, size, "/var/lib/app/file-%u", i);
+	return buf;
+}
+
+// Feed a Zipf-like stream: key i occurs about 20000 / (i + 1) times
+static void feed_stream(void) {
+	char key[64];
+
+	sketch_reset();
+	stream_total = 0;
+	for (uint32_t i = 0; i < TEST_KEYS; i++) {
+		true_count[i] = 20000 / (i + 1) + 1;
+	}
+
+	// Interleave the keys so the heavy hitters are not all seen first
+	for (uint64_t round = 0; round < true_count[0]; round++) {
+		for (uint32_t i = 0; i < TEST_KEYS && round < true_count[i]; i++) {
+			sketch_observe(SKETCH_FILE, key_name(i, key, sizeof(key)));
+			stream_total++;
+		}
+	}
+}
+
+// Count-Min never underestimates and stays within e/width of the stream
+static void test_count_min(void) {
+	char key[64];
+	double epsilon = M_E / SKETCH_CM_WIDTH;
+	uint32_t under = 0, over_bound = 0;
+
+	feed_stream();
+	TEST_CHECK(sketch_total(SKETCH_FILE) == stream_total);
+	for (uint32_t i = 0; i < TEST_KEYS; i++) {
+		uint64_t est = sketch_estimate(SKETCH_FILE, key_name(i, key, sizeof(key)));
+		under += est < true_count[i];
+		over_bound += est > true_count[i] + epsilon * stream_total;
+	}
+	TEST_CHECK(under == 0);
+
+	// Each key exceeds the bound with probability below e^-depth
+	TEST_CHECK(over_bound <= TEST_KEYS * exp(-SKETCH_CM_DEPTH));
+	TEST_CHECK(sketch_estimate(SKETCH_FILE, "never-seen") <= epsilon * stream_total);
+}
+
+// Space-Saving keeps the heavy hitters with honest error bounds
+static void test_top_k(void) {
+	struct sketch_item items[SKETCH_TOP_K];
+	char key[64];
+
+	feed_stream();
+	int n = sketch_get_top(SKETCH_FILE, items, SKETCH_TOP_K);
+	TEST_CHECK(n == SKETCH_TOP_K);
+
+	for (int k = 0; k < n; k++) {
+		uint32_t i;
+		TEST_CHECK(sscanf(items[k].key, "/var/lib/app/file-%u", &i) == 1 && i < TEST_KEYS);
+		if (i >= TEST_KEYS) {
+			continue;
+		}
+		TEST_CHECK(items[k].count >= true_count[i]);
+		TEST_CHECK(items[k].count - items[k].error <= true_count[i]);
+		TEST_CHECK(k == 0 || items[k].count <= items[k - 1].count);
+	}
+
+	// Every key above total / K is guaranteed a counter
+	for (uint32_t i = 0; i < TEST_KEYS && true_count[i] > stream_total / SKETCH_TOP_K; i++) {
+		key_name(i, key, sizeof(key));
+		int found = 0;
+		for (int k = 0; k < n; k++) {
+			found |= strcmp(items[k].key, key) == 0;
+		}
+		TEST_CHECK(found);
+	}
+
+	// A smaller output array gets the highest counts
+	struct sketch_item first[3];
+	TEST_CHECK(sketch_get_top(SKETCH_FILE, first, 3) == 3);
+	TEST_CHECK(strcmp(first[0].key, items[0].key) == 0);
+}
+
+// HyperLogLog distinct counts within a few standard errors
+static void test_distinct(void) {
+	double std_error = 1.04 / sqrt((double)(1u << SKETCH_HLL_BITS));
+	double estimate;
+
+	feed_stream();
+	estimate = (double)sketch_distinct(SKETCH_FILE);
+	TEST_CHECK(fabs(estimate - TEST_KEYS) <= 4 * std_error * TEST_KEYS);
+
+	// Small cardinalities are exact enough to count a handful of ports
+	sketch_reset();
+	for (int round = 0; round < 100; round++) {
+		sketch_observe(SKETCH_PORT, "22");
+		sketch_observe(SKETCH_PORT, "443");
+		sketch_observe(SKETCH_PORT, "8080");
+	}
+	TEST_CHECK(sketch_distinct(SKETCH_PORT) == 3);
+	TEST_CHECK(sketch_distinct(SKETCH_USER) == 0);
+}
+
+// Per-process distinct files, shared slots and ignored input
+static void test_process_files(void) {
+	char path[64];
+
+	sketch_reset();
+	for (uint32_t i = 0; i < 200; i++) {
+		snprintf(path, sizeof(path), "/home/user/doc-%u.txt", i);
+		sketch_observe_process_file(4242, path);
+		sketch_observe_process_file(4242, path); // Repeats do not count
+	}
+	sketch_observe_process_file(4343, "/etc/passwd");
+
+	// 64 registers: about 13% standard error
+	double estimate = sketch_process_distinct_files(4242);
+	TEST_CHECK(fabs(estimate - 200) <= 0.4 * 200);
+	TEST_CHECK(sketch_process_distinct_files(4343) == 1);
+	TEST_CHECK(sketch_process_distinct_files(0) == 0);
+	TEST_CHECK(sketch_process_distinct_files(99999) == 0);
+	TEST_CHECK(sketch_total(SKETCH_FILE) == 401);
+
+	// Empty keys and paths are ignored, invalid dimensions are rejected
+	sketch_observe(SKETCH_PROCESS, "");
+	sketch_observe_process_file(4242, "");
+	TEST_CHECK(sketch_total(SKETCH_PROCESS) == 0);
+	TEST_CHECK(sketch_total(SKETCH_FILE) == 401);
+	TEST_CHECK(sketch_total(SKETCH_DIMENSION_MAX) == 0);
+
+	sketch_reset();
+	TEST_CHECK(sketch_process_distinct_files(4242) == 0);
+	TEST_CHECK(sketch_total(SKETCH_FILE) == 0);
+}
+
+// Keys longer than SKETCH_KEY_LEN are tracked by their prefix
+static void test_long_keys(void) {
+	char key[SKETCH_KEY_LEN * 2];
+	struct sketch_item item;
+
+	sketch_reset();
+	memset(key, 'x', sizeof(key) - 1);
+	key[sizeof(key) - 1] = '\0';
+	sketch_observe(SKETCH_PROCESS, key);
+
+	TEST_CHECK(sketch_get_top(SKETCH_PROCESS, &item, 1) == 1);
+	TEST_CHECK(strlen(item.key) == SKETCH_KEY_LEN - 1);
+	TEST_CHECK(strncmp(item.key, key, SKETCH_KEY_LEN - 1) == 0);
+	TEST_CHECK(item.count == 1);
+}
+
+// Dimension names round trip
+static void test_names(void) {
+	for (int dim = 0; dim < SKETCH_DIMENSION_MAX; dim++) {
+		const char* name = sketch_dimension_name((enum sketch_dimension)dim);
+		TEST_CHECK(sketch_dimension_from_name(name) == dim);
+	}
+	TEST_CHECK(strcmp(sketch_dimension_name(SKETCH_DIMENSION_MAX), "unknown") == 0);
+	TEST_CHECK(sketch_dimension_from_name("bogus") == -1);
+}
+
+int main(void) {
+	printf("sketch:\n");
+	TEST_RUN(test_count_min);
+	TEST_RUN(test_top_k);
+	TEST_RUN(test_distinct);
+	TEST_RUN(test_process_files);
+	TEST_RUN(test_long_keys);
+	TEST_RUN(test_names);
+	return TEST_RESULT();
+}
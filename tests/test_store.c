@@ -0,0 +1,387 @@
+// RAVN Event Store Tests
+// Write events through the store thread and read them back from the segments
+
+#define _POSIX_C_SOURCE 200809L
+#define _DEFAULT_SOURCE
+#include "../src/daemon/store.h"
+
+#include "../src/utils/logger.h"
+#include "../src/utils/profiler.h"
+#include "test.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Three full blocks and a partial one: fits the staging blocks without drops */
+#define TEST_EVENTS (3 * STORE_BLOCK_EVENTS + 1000)
+#define TEST_STEP_NS 1000
+#define TEST_LONG_PATH 1234 /* Event carrying a path longer than STORE_MAX_STRING */
+
+static char test_dir[] = "/tmp/ravn-test-store-XXXXXX";
+
+// One event as appended
+struct test_event {
+	uint32_t pid;
+	uint32_t uid;
+	uint32_t type;
+	uint32_t category;
+	const char* comm;
+	char path[STORE_MAX_STRING + 64];
+	char host[32];
+};
+
+// Event number i: repeated names, missing paths and hosts, absent user IDs
+static void expected_event(uint32_t i, struct test_event* ev) {
+	static const char* comms[] = {"bash", "sshd", "nginx", "sixteen-char-cmd"};
+
+	ev->pid = 1000 + i % 50;
+	ev->uid = i % 7 == 0 ? STORE_UID_NONE : i % 3;
+	ev->type = i % 11;
+	ev->category = 1 + i % 8;
+	ev->comm = comms[i % 4];
+	ev->path[0] = '\0';
+	if (i == TEST_LONG_PATH) {
+		memset(ev->path, 'a', sizeof(ev->path) - 1);
+		ev->path[0] = '/';
+		ev->path[sizeof(ev->path) - 1] = '\0';
+	} else if (i % 5 > 1) {
+		snprintf(ev->path, sizeof(ev->path), "/tmp/file-%u", i % 100);
+	}
+	ev->host[0] = '\0';
+	if (i % 2 == 0) {
+		snprintf(ev->host, sizeof(ev->host), "web-%u", i % 3);
+	}
+}
+
+// Append the test events on consecutive timestamps
+static void write_events(void) {
+	struct test_event ev;
+	uint64_t start = ravn_prof_now_ns();
+
+	for (uint32_t i = 0; i < TEST_EVENTS; i++) {
+		expected_event(i, &ev);
+		store_append(start + (uint64_t)i * TEST_STEP_NS, ev.pid, ev.uid, ev.type,
+			     ev.category, ev.comm, i % 5 == 0 ? NULL : ev.path,
+			     ev.host[0] ? ev.host : NULL);
+	}
+}
+
+// Check every event of one segment against its expected values
+static void check_segment(const struct store_segment* seg, uint64_t first_ts, uint8_t* seen) {
+	static uint64_t ts[STORE_BLOCK_EVENTS];
+	static uint32_t cols[STORE_COLUMNS][STORE_BLOCK_EVENTS];
+	struct test_event ev;
+	char buf[STORE_MAX_STRING + 1];
+
+	for (uint32_t b = 0; b < seg->blocks; b++) {
+		struct store_block_view view;
+		TEST_CHECK(store_segment_block(seg, b, &view) == 0);
+		TEST_CHECK(store_block_column(&view, STORE_COLUMN_TS, ts) == 0);
+		for (int c = STORE_COLUMN_PID; c < STORE_COLUMNS; c++) {
+			TEST_CHECK(store_block_column(&view, (enum store_column)c, cols[c]) == 0);
+		}
+
+		for (uint32_t k = 0; k < view.header->events; k++) {
+			uint64_t i = (ts[k] - first_ts) / TEST_STEP_NS;
+			TEST_CHECK((ts[k] - first_ts) % TEST_STEP_NS == 0 && i < TEST_EVENTS);
+			if (i >= TEST_EVENTS) {
+				continue;
+			}
+			TEST_CHECK(!seen[i]);
+			seen[i] = 1;
+
+			expected_event((uint32_t)i, &ev);
+			TEST_CHECK(ts[k] >= view.header->min_ts && ts[k] <= view.header->max_ts);
+			TEST_CHECK(cols[STORE_COLUMN_PID][k] == ev.pid);
+			TEST_CHECK(cols[STORE_COLUMN_UID][k] == ev.uid);
+			TEST_CHECK(cols[STORE_COLUMN_TYPE][k] == ev.type);
+			TEST_CHECK(cols[STORE_COLUMN_CATEGORY][k] == ev.category);
+			TEST_CHECK(view.header->categories & (1u << ev.category));
+			TEST_CHECK(strcmp(store_segment_string(seg, cols[STORE_COLUMN_COMM][k], buf,
+							       sizeof(buf)),
+					  ev.comm) == 0);
+			TEST_CHECK(strcmp(store_segment_string(seg, cols[STORE_COLUMN_HOST][k], buf,
+							       sizeof(buf)),
+					  ev.host) == 0);
+
+			// Paths are cut at STORE_MAX_STRING; no path reads as ""
+			store_segment_string(seg, cols[STORE_COLUMN_PATH][k], buf, sizeof(buf));
+			TEST_CHECK(strncmp(buf, ev.path, STORE_MAX_STRING) == 0);
+			TEST_CHECK(strlen(buf) <= STORE_MAX_STRING);
+		}
+	}
+}
+
+// Read back all segments of the test directory
+static int read_back(char** paths, int count) {
+	uint8_t* seen = calloc(TEST_EVENTS, 1);
+	uint64_t first_ts = UINT64_MAX, events = 0;
+	int complete = 1;
+
+	// Partitions may split the events: find the earliest one first
+	for (int s = 0; s < count; s++) {
+		struct store_segment seg;
+		TEST_CHECK(store_segment_open(&seg, paths[s]) == 0);
+		for (uint32_t b = 0; b < seg.blocks; b++) {
+			first_ts = seg.index[b].min_ts < first_ts ? seg.index[b].min_ts : first_ts;
+		}
+		events += seg.events;
+		complete &= seg.complete;
+		store_segment_close(&seg);
+	}
+	TEST_CHECK(events == TEST_EVENTS);
+	TEST_CHECK(complete);
+
+	for (int s = 0; s < count; s++) {
+		struct store_segment seg;
+		if (store_segment_open(&seg, paths[s]) == 0) {
+			check_segment(&seg, first_ts, seen);
+			store_segment_close(&seg);
+		}
+	}
+
+	uint32_t missing = 0;
+	for (uint32_t i = 0; i < TEST_EVENTS; i++) {
+		missing += !seen[i];
+	}
+	TEST_CHECK(missing == 0);
+	free(seen);
+	return 0;
+}
+
+// Copy the first bytes of a file
+static int copy_prefix(const char* src, const char* dst, size_t size) {
+	int in = open(src, O_RDONLY);
+	int out = open(dst, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	char* buf = malloc(size ? size : 1);
+	int ret = -1;
+
+	if (in >= 0 && out >= 0 && buf && pread(in, buf, size, 0) == (ssize_t)size &&
+	    write(out, buf, size) == (ssize_t)size) {
+		ret = 0;
+	}
+	free(buf);
+	if (in >= 0) {
+		close(in);
+	}
+	if (out >= 0) {
+		close(out);
+	}
+	return ret;
+}
+
+// Write, close and read back a store, including all string edge cases
+static void test_round_trip(void) {
+	struct store_stats stats;
+	char** paths = NULL;
+	int count = 0;
+
+	TEST_CHECK(store_open(test_dir, 0) == 0);
+	TEST_CHECK(store_open(test_dir, 0) == -1); // Already open
+	write_events();
+	store_get_stats(&stats);
+	store_close();
+
+	TEST_CHECK(stats.events == TEST_EVENTS);
+	TEST_CHECK(stats.dropped == 0);
+
+	// Appending to a closed store does nothing
+	store_append(ravn_prof_now_ns(), 1, 0, 0, 1, "late", NULL, NULL);
+
+	TEST_CHECK(store_list_segments(test_dir, &paths, &count) == 0);
+	TEST_CHECK(count >= 1);
+	read_back(paths, count);
+
+	for (int s = 0; s < count; s++) {
+		free(paths[s]);
+	}
+	free(paths);
+}
+
+// A segment cut short by a crash reads up to its last complete block
+static void test_truncated(void) {
+	char** paths = NULL;
+	int count = 0;
+	char cut[sizeof(test_dir) + 32];
+	struct store_segment seg, part;
+
+	TEST_CHECK(store_list_segments(test_dir, &paths, &count) == 0 && count >= 1);
+	if (count < 1 || store_segment_open(&seg, paths[0]) != 0) {
+		TEST_CHECK(0);
+		return;
+	}
+	snprintf(cut, sizeof(cut), "%s/cut.tmp", test_dir);
+
+	// Halfway into the last block: that block is lost, the rest is intact
+	if (seg.blocks >= 2) {
+		const struct store_index_entry* last = &seg.index[seg.blocks - 1];
+		TEST_CHECK(copy_prefix(paths[0], cut, last->offset + 100) == 0);
+		TEST_CHECK(store_segment_open(&part, cut) == 0);
+		TEST_CHECK(!part.complete);
+		TEST_CHECK(part.blocks == seg.blocks - 1);
+		TEST_CHECK(part.events == seg.events - last->events);
+		store_segment_close(&part);
+	}
+
+	// Not even a whole file header
+	TEST_CHECK(copy_prefix(paths[0], cut, 10) == 0);
+	TEST_CHECK(store_segment_open(&part, cut) == -1);
+	TEST_CHECK(store_segment_open(&part, "/nonexistent.rseg") == -1);
+
+	unlink(cut);
+	store_segment_close(&seg);
+	for (int s = 0; s < count; s++) {
+		free(paths[s]);
+	}
+	free(paths);
+}
+
+// The zone maps that queries prune blocks by bound every event of the block
+static void test_zone_maps(void) {
+	static uint64_t ts[STORE_BLOCK_EVENTS];
+	static uint32_t pid[STORE_BLOCK_EVENTS], category[STORE_BLOCK_EVENTS];
+	char** paths = NULL;
+	int count = 0;
+
+	TEST_CHECK(store_list_segments(test_dir, &paths, &count) == 0 && count >= 1);
+	for (int s = 0; s < count; s++) {
+		struct store_segment seg;
+		if (store_segment_open(&seg, paths[s]) != 0) {
+			TEST_CHECK(0);
+			continue;
+		}
+
+		for (uint32_t b = 0; b < seg.blocks; b++) {
+			const struct store_index_entry* e = &seg.index[b];
+			struct store_block_view view;
+			if (store_segment_block(&seg, b, &view) != 0 ||
+			    store_block_column(&view, STORE_COLUMN_TS, ts) != 0 ||
+			    store_block_column(&view, STORE_COLUMN_PID, pid) != 0 ||
+			    store_block_column(&view, STORE_COLUMN_CATEGORY, category) != 0) {
+				TEST_CHECK(0);
+				continue;
+			}
+
+			// Tight bounds: each limit is reached by some event
+			uint64_t min_ts = UINT64_MAX, max_ts = 0;
+			uint32_t min_pid = UINT32_MAX, max_pid = 0, categories = 0;
+			for (uint32_t k = 0; k < e->events; k++) {
+				min_ts = ts[k] < min_ts ? ts[k] : min_ts;
+				max_ts = ts[k] > max_ts ? ts[k] : max_ts;
+				min_pid = pid[k] < min_pid ? pid[k] : min_pid;
+				max_pid = pid[k] > max_pid ? pid[k] : max_pid;
+				categories |= 1u << category[k];
+			}
+			TEST_CHECK(e->events == view.header->events);
+			TEST_CHECK(e->min_ts == min_ts && e->max_ts == max_ts);
+			TEST_CHECK(e->min_pid == min_pid && e->max_pid == max_pid);
+			TEST_CHECK(e->categories == categories);
+			TEST_CHECK(view.header->min_ts == min_ts && view.header->max_ts == max_ts);
+		}
+		store_segment_close(&seg);
+	}
+
+	for (int s = 0; s < count; s++) {
+		free(paths[s]);
+	}
+	free(paths);
+}
+
+// Packed segments decode to the same columns and dictionary as the original
+static void test_packed(void) {
+	static uint64_t ts[2][STORE_BLOCK_EVENTS];
+	static uint32_t col[2][STORE_BLOCK_EVENTS];
+	char** paths = NULL;
+	int count = 0;
+	char packed[sizeof(test_dir) + 32];
+	struct store_pack_stats stats;
+	struct store_segment seg, out;
+
+	TEST_CHECK(store_list_segments(test_dir, &paths, &count) == 0 && count >= 1);
+	if (count < 1) {
+		return;
+	}
+	snprintf(packed, sizeof(packed), "%s/packed.tmp", test_dir);
+
+	TEST_CHECK(store_segment_pack(paths[0], packed, &stats) == 0);
+	TEST_CHECK(stats.bytes_out < stats.bytes_in);
+	TEST_CHECK(store_segment_pack(packed, packed, NULL) == 1); // Already packed
+
+	if (store_segment_open(&seg, paths[0]) != 0 || store_segment_open(&out, packed) != 0) {
+		TEST_CHECK(0);
+		unlink(packed);
+		return;
+	}
+	TEST_CHECK(out.complete);
+	TEST_CHECK(out.blocks == seg.blocks && out.events == seg.events);
+	TEST_CHECK(stats.events == seg.events && stats.blocks == seg.blocks);
+	TEST_CHECK(out.dict_entries == seg.dict_entries);
+	for (uint32_t id = 1; id < seg.dict_entries && id < out.dict_entries; id++) {
+		TEST_CHECK(out.dict_len[id] == seg.dict_len[id] &&
+			   memcmp(out.dict[id], seg.dict[id], seg.dict_len[id]) == 0);
+	}
+
+	for (uint32_t b = 0; b < seg.blocks && b < out.blocks; b++) {
+		struct store_block_view plain, view;
+		if (store_segment_block(&seg, b, &plain) != 0 ||
+		    store_segment_block(&out, b, &view) != 0) {
+			TEST_CHECK(0);
+			continue;
+		}
+		uint32_t n = plain.header->events;
+		TEST_CHECK(view.header->magic == STORE_PACKED_MAGIC && !view.ts && !view.pid);
+		TEST_CHECK(view.header->events == n);
+		TEST_CHECK(store_block_column(&plain, STORE_COLUMN_TS, ts[0]) == 0);
+		TEST_CHECK(store_block_column(&view, STORE_COLUMN_TS, ts[1]) == 0);
+		TEST_CHECK(memcmp(ts[0], ts[1], n * sizeof(uint64_t)) == 0);
+		for (int c = STORE_COLUMN_PID; c < STORE_COLUMNS; c++) {
+			TEST_CHECK(store_block_column(&plain, (enum store_column)c, col[0]) == 0);
+			TEST_CHECK(store_block_column(&view, (enum store_column)c, col[1]) == 0);
+			TEST_CHECK(memcmp(col[0], col[1], n * sizeof(uint32_t)) == 0);
+		}
+	}
+
+	store_segment_close(&out);
+	store_segment_close(&seg);
+	unlink(packed);
+	for (int s = 0; s < count; s++) {
+		free(paths[s]);
+	}
+	free(paths);
+}
+
+// Remove the test segments
+static void remove_dir(void) {
+	char** paths = NULL;
+	int count = 0;
+
+	if (store_list_segments(test_dir, &paths, &count) == 0) {
+		for (int s = 0; s < count; s++) {
+			unlink(paths[s]);
+			free(paths[s]);
+		}
+		free(paths);
+	}
+	rmdir(test_dir);
+}
+
+int main(void) {
+	logger_init(LOG_LEVEL_WARN, NULL);
+	if (!mkdtemp(test_dir)) {
+		perror("mkdtemp");
+		return 1;
+	}
+
+	printf("store:\n");
+	TEST_RUN(test_round_trip);
+	TEST_RUN(test_truncated);
+	TEST_RUN(test_zone_maps);
+	TEST_RUN(test_packed);
+
+	remove_dir();
+	logger_cleanup();
+	return TEST_RESULT();
+}